@@ -0,0 +1,369 @@
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/connect.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/read_until.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <fmt/format.h>
+
+#include "clueapi/clueapi.hxx"
+#include "clueapi/http/ctx/ctx.hxx"
+#include "clueapi/http/types/method/method.hxx"
+#include "clueapi/http/types/response/response.hxx"
+#include "clueapi/http/types/status/status.hxx"
+#include "clueapi/shared/metrics/metrics.hxx"
+
+// Every allocation of the process is counted, the server's and the clients' alike
+namespace {
+    std::atomic<std::uint64_t> g_allocations{};
+
+    void* allocate(std::size_t size) {
+        g_allocations.fetch_add(1u, std::memory_order_relaxed);
+
+        if (auto* ptr = std::malloc(size == 0u ? 1u : size))
+            return ptr;
+
+        throw std::bad_alloc{};
+    }
+} // namespace
+
+void* operator new(std::size_t size) {
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size) {
+    return allocate(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return allocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return allocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace {
+    namespace asio = boost::asio;
+
+    using tcp = asio::ip::tcp;
+
+    using clueapi::shared::histogram_t;
+
+    constexpr std::string_view k_host{"127.0.0.1"};
+
+    constexpr std::string_view k_port{"18080"};
+
+    constexpr std::string_view k_request{
+        "GET /hello HTTP/1.1\r\nHost: 127.0.0.1\r\nConnection: keep-alive\r\n\r\n"};
+
+    // The server of all scenarios, started on first use and stopped at exit
+    struct server_t {
+        server_t() {
+            clueapi::cfg_t cfg{};
+
+            cfg.m_host = k_host;
+            cfg.m_port = k_port;
+
+            cfg.m_workers = 2;
+
+            cfg.m_server.m_acceptor.m_reuse_port = true;
+            cfg.m_server.m_acceptor.m_reuse_address = true;
+
+            cfg.m_http.m_keep_alive_enabled = true;
+
+            cfg.m_socket.m_timeout = std::chrono::seconds{30};
+
+#ifdef CLUEAPI_USE_LOGGING_MODULE
+            cfg.m_logging_cfg.m_default_level = clueapi::modules::logging::e_log_level::off;
+#endif // CLUEAPI_USE_LOGGING_MODULE
+
+            m_api.add_method(
+                clueapi::http::types::method_t::get,
+                "/hello",
+                [](clueapi::http::ctx_t) -> clueapi::http::types::response_t {
+                    return {"Hello, World!", clueapi::http::types::status_t::ok};
+                });
+
+            m_api.add_method(
+                clueapi::http::types::method_t::post,
+                "/upload",
+                [](clueapi::http::ctx_t ctx) -> clueapi::http::types::response_t {
+                    return {
+                        std::to_string(ctx.request().body().size()),
+                        clueapi::http::types::status_t::ok};
+                });
+
+            try {
+                m_api.start(std::move(cfg));
+
+                for (std::size_t i{}; i < 100u && !m_api.is_running(); i++)
+                    std::this_thread::sleep_for(std::chrono::milliseconds{10});
+            } catch (...) {
+                // ...
+            }
+        }
+
+        ~server_t() noexcept {
+            try {
+                m_api.stop();
+
+                for (std::size_t i{}; i < 100u && !m_api.is_stopped(); i++)
+                    std::this_thread::sleep_for(std::chrono::milliseconds{10});
+            } catch (...) {
+                // ...
+            }
+        }
+
+        static bool is_running() {
+            static server_t server{};
+
+            return server.m_api.is_running();
+        }
+
+        clueapi::c_clueapi m_api{};
+    };
+
+    // A blocking HTTP/1.1 client over one keep-alive connection
+    struct client_t {
+        client_t() {
+            tcp::resolver resolver{m_io_ctx};
+
+            asio::connect(m_socket, resolver.resolve(k_host, k_port));
+
+            m_socket.set_option(tcp::no_delay{true});
+        }
+
+        void send(std::string_view data) {
+            asio::write(m_socket, asio::buffer(data));
+        }
+
+        // Reads a response, the bytes of the pipelined ones after it stay buffered
+        bool read_response() {
+            const auto header_size =
+                asio::read_until(m_socket, asio::dynamic_buffer(m_buffer), "\r\n\r\n");
+
+            const std::string_view header{m_buffer.data(), header_size};
+
+            if (!header.starts_with("HTTP/1.1 200"))
+                return false;
+
+            std::size_t body_size{};
+
+            if (const auto pos = header.find("Content-Length: "); pos != std::string_view::npos) {
+                const auto* begin = header.data() + pos + 16u;
+
+                std::from_chars(begin, header.data() + header.size(), body_size);
+            }
+
+            if (m_buffer.size() < header_size + body_size)
+                asio::read(
+                    m_socket,
+                    asio::dynamic_buffer(m_buffer),
+                    asio::transfer_exactly(header_size + body_size - m_buffer.size()));
+
+            m_buffer.erase(0u, header_size + body_size);
+
+            return true;
+        }
+
+        asio::io_context m_io_ctx{};
+
+        tcp::socket m_socket{m_io_ctx};
+
+        std::string m_buffer{};
+    };
+
+    // Reports the latencies and the allocations per request of the measured requests
+    struct recorder_t {
+        explicit recorder_t(benchmark::State& state) : m_state{state} {
+            m_allocations = g_allocations.load(std::memory_order_relaxed);
+        }
+
+        void record(std::chrono::steady_clock::duration latency) noexcept {
+            const auto value =
+                std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+
+            m_counts[histogram_t::bucket_of(static_cast<std::uint64_t>(value))]++;
+        }
+
+        void report(std::size_t requests_per_iteration) {
+            const auto requests = m_state.iterations() * requests_per_iteration;
+
+            m_state.SetItemsProcessed(static_cast<std::int64_t>(requests));
+
+            // The percentiles of the threads are averaged, not merged
+            m_state.counters["p50_us"] = benchmark::Counter(
+                static_cast<double>(histogram_t::value_at(m_counts, 0.5)),
+                benchmark::Counter::kAvgThreads);
+
+            m_state.counters["p99_us"] = benchmark::Counter(
+                static_cast<double>(histogram_t::value_at(m_counts, 0.99)),
+                benchmark::Counter::kAvgThreads);
+
+            // The threads run the loop together, the first one sees the allocations of all
+            if (m_state.thread_index() != 0 || requests == 0u)
+                return;
+
+            const auto allocations = g_allocations.load(std::memory_order_relaxed) - m_allocations;
+
+            m_state.counters["allocs_per_req"] = static_cast<double>(allocations) /
+                                                 static_cast<double>(requests * m_state.threads());
+        }
+
+        benchmark::State& m_state;
+
+        std::uint64_t m_allocations{};
+
+        histogram_t::counts_t m_counts{};
+    };
+
+    void BM_keep_alive(benchmark::State& state) {
+        if (!server_t::is_running()) {
+            state.SkipWithError("Failed to start the server");
+
+            return;
+        }
+
+        client_t client{};
+
+        recorder_t recorder{state};
+
+        for (auto _ : state) {
+            const auto start = std::chrono::steady_clock::now();
+
+            client.send(k_request);
+
+            if (!client.read_response()) {
+                state.SkipWithError("Unexpected response");
+
+                break;
+            }
+
+            recorder.record(std::chrono::steady_clock::now() - start);
+        }
+
+        recorder.report(1u);
+    }
+
+    void BM_pipelined(benchmark::State& state) {
+        if (!server_t::is_running()) {
+            state.SkipWithError("Failed to start the server");
+
+            return;
+        }
+
+        const auto depth = static_cast<std::size_t>(state.range(0));
+
+        std::string batch{};
+
+        for (std::size_t i{}; i < depth; i++)
+            batch.append(k_request);
+
+        client_t client{};
+
+        recorder_t recorder{state};
+
+        for (auto _ : state) {
+            const auto start = std::chrono::steady_clock::now();
+
+            client.send(batch);
+
+            // The latency of a request is counted from the write of its batch
+            for (std::size_t i{}; i < depth; i++) {
+                if (!client.read_response()) {
+                    state.SkipWithError("Unexpected response");
+
+                    break;
+                }
+
+                recorder.record(std::chrono::steady_clock::now() - start);
+            }
+        }
+
+        recorder.report(depth);
+    }
+
+    void BM_upload(benchmark::State& state) {
+        if (!server_t::is_running()) {
+            state.SkipWithError("Failed to start the server");
+
+            return;
+        }
+
+        const auto size = static_cast<std::size_t>(state.range(0));
+
+        auto request = fmt::format(
+            "POST /upload HTTP/1.1\r\nHost: 127.0.0.1\r\nConnection: keep-alive\r\n"
+            "Content-Type: application/octet-stream\r\nContent-Length: {}\r\n\r\n",
+            size);
+
+        request.append(size, 'x');
+
+        client_t client{};
+
+        recorder_t recorder{state};
+
+        for (auto _ : state) {
+            const auto start = std::chrono::steady_clock::now();
+
+            client.send(request);
+
+            if (!client.read_response()) {
+                state.SkipWithError("Unexpected response");
+
+                break;
+            }
+
+            recorder.record(std::chrono::steady_clock::now() - start);
+        }
+
+        recorder.report(1u);
+
+        state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * size));
+    }
+} // namespace
+
+BENCHMARK(BM_keep_alive)->UseRealTime()->Threads(1)->Threads(4);
+BENCHMARK(BM_pipelined)->UseRealTime()->ArgName("depth")->Arg(4)->Arg(16)->Arg(64);
+BENCHMARK(BM_upload)->UseRealTime()->ArgName("size")->Arg(1024)->Arg(65536)->Arg(1048576);
@@ -0,0 +1,112 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/address_v4.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/use_awaitable.hpp>
+
+#include "clueapi/http/chunks/chunks.hxx"
+
+namespace {
+    using namespace clueapi::http::chunks;
+
+    using tcp = boost::asio::ip::tcp;
+
+    // The number of chunks written per iteration
+    constexpr std::size_t k_chunks{64u};
+
+    // A connected loopback pair, the peer side drained for as long as it is open
+    struct connection_t {
+        connection_t() : m_acceptor{m_io_ctx, {boost::asio::ip::address_v4::loopback(), 0}} {
+            m_socket.connect(m_acceptor.local_endpoint());
+
+            m_acceptor.accept(m_peer);
+
+            boost::asio::co_spawn(m_io_ctx, drain(), boost::asio::detached);
+        }
+
+        boost::asio::awaitable<void> drain() {
+            std::array<char, 65536> buffer{};
+
+            try {
+                for (;;)
+                    co_await m_peer.async_read_some(
+                        boost::asio::buffer(buffer), boost::asio::use_awaitable);
+            } catch (...) {
+                // ...
+            }
+        }
+
+        // Runs a writer until it is done, the drain keeps the context from running out of work
+        template <typename _fn_t>
+        void run(_fn_t&& fn) {
+            bool done{};
+
+            boost::asio::co_spawn(
+                m_io_ctx,
+                [&, fn = std::forward<_fn_t>(fn)]() -> boost::asio::awaitable<void> {
+                    co_await fn();
+
+                    done = true;
+                },
+                boost::asio::detached);
+
+            while (!done)
+                m_io_ctx.run_one();
+        }
+
+        boost::asio::io_context m_io_ctx{};
+
+        tcp::acceptor m_acceptor;
+
+        tcp::socket m_socket{m_io_ctx};
+
+        tcp::socket m_peer{m_io_ctx};
+    };
+
+    template <bool _coalesce>
+    void BM_chunk_writer(benchmark::State& state) {
+        const std::string chunk(static_cast<std::size_t>(state.range(0)), 'x');
+
+        connection_t connection{};
+
+        for (auto _ : state) {
+            connection.run([&]() -> boost::asio::awaitable<void> {
+                auto writer = _coalesce ? chunk_writer_t{connection.m_socket, coalesce_t{}}
+                                        : chunk_writer_t{connection.m_socket};
+
+                for (std::size_t i{}; i < k_chunks; i++) {
+                    auto result = co_await writer.write_chunk(chunk);
+
+                    if (!result.has_value()) {
+                        state.SkipWithError("Failed to write a chunk");
+
+                        co_return;
+                    }
+                }
+
+                auto result = co_await writer.write_final_chunk();
+
+                if (!result.has_value())
+                    state.SkipWithError("Failed to write the final chunk");
+            });
+        }
+
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * k_chunks));
+
+        state.SetBytesProcessed(
+            static_cast<std::int64_t>(state.iterations() * k_chunks * chunk.size()));
+    }
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_chunk_writer, false)->ArgName("chunk_size")->Arg(64)->Arg(1024)->Arg(16384);
+BENCHMARK_TEMPLATE(BM_chunk_writer, true)->ArgName("chunk_size")->Arg(64)->Arg(1024)->Arg(16384);
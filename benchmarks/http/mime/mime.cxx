@@ -0,0 +1,57 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+#include <boost/filesystem/path.hpp>
+
+#include "clueapi/http/mime/mime.hxx"
+
+namespace {
+    using clueapi::http::mime::mime_t;
+
+    // The files a static mount serves the most, with the odd unknown and upper-case extension
+    constexpr std::array<std::string_view, 10> k_paths{
+        "/assets/index.html",
+        "/assets/app.3f2a91.js",
+        "/assets/style.css",
+        "/assets/logo.svg",
+        "/assets/photo.JPG",
+        "/assets/font.woff2",
+        "/assets/data.json",
+        "/assets/archive.tar.gz",
+        "/assets/readme",
+        "/assets/blob.unknownext"};
+
+    void BM_mime_type(benchmark::State& state) {
+        std::array<boost::filesystem::path, k_paths.size()> paths{};
+
+        for (std::size_t i{}; i < k_paths.size(); i++)
+            paths[i] = boost::filesystem::path{std::string{k_paths[i]}};
+
+        std::size_t i{};
+
+        for (auto _ : state) {
+            auto mime_type = mime_t::mime_type(paths[i++ % paths.size()]);
+
+            benchmark::DoNotOptimize(mime_type);
+        }
+    }
+
+    void BM_from_extension(benchmark::State& state) {
+        constexpr std::array<std::string_view, 5> k_extensions{
+            ".html", ".js", ".PNG", ".woff2", ".unknownext"};
+
+        std::size_t i{};
+
+        for (auto _ : state) {
+            auto mime_type = mime_t::from_extension(k_extensions[i++ % k_extensions.size()]);
+
+            benchmark::DoNotOptimize(mime_type);
+        }
+    }
+} // namespace
+
+BENCHMARK(BM_mime_type);
+BENCHMARK(BM_from_extension);
@@ -0,0 +1,122 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include <fmt/format.h>
+
+#include "clueapi/http/multipart/multipart.hxx"
+
+namespace {
+    using namespace clueapi::http::multipart;
+
+    constexpr std::string_view k_boundary{"----WebKitFormBoundary7MA4YWxkTrZu0gW"};
+
+    // A form as a browser sends it: a few fields and one file of the benchmarked size
+    std::string make_body(std::size_t file_size) {
+        std::string body{};
+
+        for (int i = 0; i < 4; i++)
+            body.append(fmt::format(
+                "--{}\r\nContent-Disposition: form-data; name=\"field{}\"\r\n\r\nvalue{}\r\n",
+                k_boundary,
+                i,
+                i));
+
+        body.append(fmt::format(
+            "--{}\r\nContent-Disposition: form-data; name=\"file\"; filename=\"upload.bin\"\r\n"
+            "Content-Type: application/octet-stream\r\n\r\n",
+            k_boundary));
+
+        for (std::size_t i{}; i < file_size; i++)
+            body.push_back(static_cast<char>('a' + i % 26));
+
+        body.append(fmt::format("\r\n--{}--\r\n", k_boundary));
+
+        return body;
+    }
+
+    parser_t::cfg_t make_cfg() {
+        // Large enough to keep every benchmarked file in memory
+        return parser_t::cfg_t{
+            .m_boundary = k_boundary,
+            .m_max_file_size_in_memory = 1048576u * 4u,
+            .m_max_files_size_in_memory = 1048576u * 4u};
+    }
+
+    template <typename _fn_t>
+    void run(boost::asio::io_context& io_ctx, _fn_t&& fn) {
+        boost::asio::co_spawn(io_ctx, std::forward<_fn_t>(fn), boost::asio::detached);
+
+        io_ctx.run();
+
+        io_ctx.restart();
+    }
+
+    void BM_string_parser(benchmark::State& state) {
+        const auto body = make_body(static_cast<std::size_t>(state.range(0)));
+
+        boost::asio::io_context io_ctx{};
+
+        for (auto _ : state) {
+            run(io_ctx, [&]() -> boost::asio::awaitable<void> {
+                parser_t parser{make_cfg()};
+
+                auto parts = co_await parser.parse(body);
+
+                if (!parts.has_value())
+                    state.SkipWithError("Failed to parse the body");
+
+                benchmark::DoNotOptimize(parts);
+            });
+        }
+
+        state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * body.size()));
+    }
+
+    void BM_file_parser(benchmark::State& state) {
+        const auto body = make_body(static_cast<std::size_t>(state.range(0)));
+
+        const auto path =
+            boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+
+        {
+            std::ofstream file{path.string(), std::ios::binary};
+
+            file << body;
+        }
+
+        boost::asio::io_context io_ctx{};
+
+        for (auto _ : state) {
+            run(io_ctx, [&]() -> boost::asio::awaitable<void> {
+                parser_t parser{make_cfg()};
+
+                auto parts = co_await parser.parse_file(path);
+
+                if (!parts.has_value())
+                    state.SkipWithError("Failed to parse the body");
+
+                benchmark::DoNotOptimize(parts);
+            });
+        }
+
+        state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * body.size()));
+
+        boost::system::error_code ec{};
+
+        boost::filesystem::remove(path, ec);
+    }
+} // namespace
+
+BENCHMARK(BM_string_parser)->ArgName("file_size")->Arg(1024)->Arg(65536)->Arg(1048576);
+BENCHMARK(BM_file_parser)->ArgName("file_size")->Arg(1024)->Arg(65536)->Arg(1048576);
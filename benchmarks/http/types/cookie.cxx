@@ -0,0 +1,68 @@
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <string>
+
+#include "clueapi/http/types/cookie/cookie.hxx"
+#include "clueapi/http/types/request/request.hxx"
+
+namespace {
+    using namespace clueapi::http::types;
+
+    // What a browser sends once a few analytics and session cookies are set
+    constexpr std::string_view k_cookie_header{
+        "_ga=GA1.2.1234567890.1700000000; _gid=GA1.2.987654321.1700000000; "
+        "session_id=8f14e45fceea167a5a36dedd4bea2543; csrf_token=c4ca4238a0b923820dcc509a6f75849b; "
+        "theme=dark; lang=en-US; consent=analytics%2Cmarketing; tracking=off"};
+
+    void BM_cookie_serialize(benchmark::State& state) {
+        cookie_t cookie{"session_id", "8f14e45fceea167a5a36dedd4bea2543"};
+
+        cookie.domain() = "example.com";
+        cookie.path() = "/";
+        cookie.max_age() = std::chrono::seconds{3600};
+        cookie.secure() = true;
+        cookie.http_only() = true;
+        cookie.same_site() = "Strict";
+
+        for (auto _ : state) {
+            auto serialized = cookie_t::serialize(cookie);
+
+            benchmark::DoNotOptimize(serialized);
+        }
+    }
+
+    // The first lookup parses the header
+    void BM_request_cookie_first(benchmark::State& state) {
+        request_t request{};
+
+        for (auto _ : state) {
+            request.headers()["Cookie"] = k_cookie_header;
+
+            auto cookie = request.cookie("tracking");
+
+            benchmark::DoNotOptimize(cookie);
+
+            request.reset();
+        }
+    }
+
+    // The next ones find the parsed cookies
+    void BM_request_cookie_cached(benchmark::State& state) {
+        request_t request{};
+
+        request.headers()["Cookie"] = k_cookie_header;
+
+        benchmark::DoNotOptimize(request.cookie("theme"));
+
+        for (auto _ : state) {
+            auto cookie = request.cookie("tracking");
+
+            benchmark::DoNotOptimize(cookie);
+        }
+    }
+} // namespace
+
+BENCHMARK(BM_cookie_serialize);
+BENCHMARK(BM_request_cookie_first);
+BENCHMARK(BM_request_cookie_cached);
@@ -0,0 +1,109 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "clueapi/http/ctx/ctx.hxx"
+#include "clueapi/http/types/method/method.hxx"
+#include "clueapi/http/types/response/response.hxx"
+#include "clueapi/route/detail/detail.hxx"
+
+namespace {
+    using namespace clueapi;
+    using namespace clueapi::http;
+    using namespace clueapi::route::detail;
+
+    using handler_t = std::function<types::response_t(ctx_t)>;
+
+    // Roughly the shape of a real API: mostly static routes, a few with parameters
+    constexpr std::size_t k_static_routes{350};
+    constexpr std::size_t k_dynamic_routes{50};
+
+    radix_tree_t<handler_t> make_tree(bool frozen) {
+        radix_tree_t<handler_t> tree{};
+
+        const auto handler = [](ctx_t) { return types::text_response_t("ok"); };
+
+        for (std::size_t i{}; i < k_static_routes; i++)
+            tree.insert(
+                types::method_t::get, fmt::format("/api/v1/resource{}/list", i), handler);
+
+        for (std::size_t i{}; i < k_dynamic_routes; i++)
+            tree.insert(types::method_t::get, fmt::format("/api/v1/items{}/{{id}}", i), handler);
+
+        if (frozen)
+            tree.freeze();
+
+        return tree;
+    }
+
+    std::vector<std::string> make_paths(bool dynamic) {
+        std::vector<std::string> paths{};
+
+        if (dynamic) {
+            for (std::size_t i{}; i < k_dynamic_routes; i++)
+                paths.push_back(fmt::format("/api/v1/items{}/{}", i, i * 7919));
+        } else {
+            for (std::size_t i{}; i < k_static_routes; i += 7)
+                paths.push_back(fmt::format("/api/v1/resource{}/list", i));
+        }
+
+        return paths;
+    }
+
+    void lookup(benchmark::State& state, bool frozen, bool dynamic) {
+        const auto tree = make_tree(frozen);
+
+        const auto paths = make_paths(dynamic);
+
+        std::size_t i{};
+
+        for (auto _ : state) {
+            types::params_t params{};
+
+            const auto* handler =
+                tree.find(types::method_t::get, paths[i++ % paths.size()], params);
+
+            benchmark::DoNotOptimize(handler);
+            benchmark::DoNotOptimize(params);
+        }
+    }
+
+    void BM_insert(benchmark::State& state) {
+        for (auto _ : state) {
+            auto tree = make_tree(state.range(0) != 0);
+
+            benchmark::DoNotOptimize(tree);
+        }
+
+        state.SetItemsProcessed(
+            static_cast<std::int64_t>(state.iterations() * (k_static_routes + k_dynamic_routes)));
+    }
+
+    void BM_tree_static(benchmark::State& state) {
+        lookup(state, false, false);
+    }
+
+    void BM_hybrid_static(benchmark::State& state) {
+        lookup(state, true, false);
+    }
+
+    void BM_tree_dynamic(benchmark::State& state) {
+        lookup(state, false, true);
+    }
+
+    void BM_hybrid_dynamic(benchmark::State& state) {
+        lookup(state, true, true);
+    }
+} // namespace
+
+BENCHMARK(BM_insert)->ArgName("frozen")->Arg(0)->Arg(1);
+BENCHMARK(BM_tree_static);
+BENCHMARK(BM_hybrid_static);
+BENCHMARK(BM_tree_dynamic);
+BENCHMARK(BM_hybrid_dynamic);
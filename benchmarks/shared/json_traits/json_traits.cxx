@@ -0,0 +1,130 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "clueapi/shared/json_traits/json_traits.hxx"
+#include "clueapi/shared/json_writer/json_writer.hxx"
+
+namespace {
+    using clueapi::shared::json_field;
+    using clueapi::shared::json_fields;
+    using clueapi::shared::json_traits_t;
+    using clueapi::shared::json_writer_t;
+
+    struct user_t {
+        std::uint64_t m_id{};
+
+        std::string m_name;
+
+        std::string m_email;
+
+        double m_score{};
+
+        bool m_active{};
+
+        static constexpr auto k_json_fields = json_fields(
+            json_field("id", &user_t::m_id),
+            json_field("name", &user_t::m_name),
+            json_field("email", &user_t::m_email),
+            json_field("score", &user_t::m_score),
+            json_field("active", &user_t::m_active));
+    };
+
+    struct list_t {
+        std::uint64_t m_total{};
+
+        std::optional<std::string> m_next;
+
+        std::vector<user_t> m_items;
+
+        static constexpr auto k_json_fields = json_fields(
+            json_field("total", &list_t::m_total),
+            json_field("next", &list_t::m_next),
+            json_field("items", &list_t::m_items));
+    };
+
+    // A list response of the given number of items, each a small flat object
+    json_traits_t::json_obj_t make_obj(std::size_t items) {
+        json_traits_t::json_obj_t obj{};
+
+        obj["total"] = items;
+
+        obj["next"] = nullptr;
+
+        auto& list = obj["items"] = json_traits_t::json_obj_t::array();
+
+        for (std::size_t i{}; i < items; i++)
+            list.push_back(
+                {{"id", i},
+                 {"name", fmt::format("user {}", i)},
+                 {"email", fmt::format("user{}@example.com", i)},
+                 {"score", static_cast<double>(i) * 1.5},
+                 {"active", i % 2 == 0}});
+
+        return obj;
+    }
+
+    void BM_json_traits_serialize(benchmark::State& state) {
+        const auto obj = make_obj(static_cast<std::size_t>(state.range(0)));
+
+        std::size_t bytes{};
+
+        for (auto _ : state) {
+            auto json = json_traits_t::serialize(obj);
+
+            bytes += json.size();
+
+            benchmark::DoNotOptimize(json);
+        }
+
+        state.SetBytesProcessed(static_cast<std::int64_t>(bytes));
+    }
+
+    void BM_json_traits_deserialize(benchmark::State& state) {
+        const auto json =
+            json_traits_t::serialize(make_obj(static_cast<std::size_t>(state.range(0))));
+
+        for (auto _ : state) {
+            auto obj = json_traits_t::deserialize(json);
+
+            benchmark::DoNotOptimize(obj);
+        }
+
+        state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * json.size()));
+    }
+
+    // The same response as a described structure through `json_writer_t`, for comparison
+    void BM_json_writer(benchmark::State& state) {
+        list_t obj{.m_total = static_cast<std::uint64_t>(state.range(0))};
+
+        for (std::uint64_t i{}; i < obj.m_total; i++)
+            obj.m_items.push_back(
+                {.m_id = i,
+                 .m_name = fmt::format("user {}", i),
+                 .m_email = fmt::format("user{}@example.com", i),
+                 .m_score = static_cast<double>(i) * 1.5,
+                 .m_active = i % 2 == 0});
+
+        std::size_t bytes{};
+
+        for (auto _ : state) {
+            auto json = json_writer_t::to_string(obj);
+
+            bytes += json.size();
+
+            benchmark::DoNotOptimize(json);
+        }
+
+        state.SetBytesProcessed(static_cast<std::int64_t>(bytes));
+    }
+} // namespace
+
+BENCHMARK(BM_json_traits_serialize)->ArgName("items")->Arg(1)->Arg(100)->Arg(10000);
+BENCHMARK(BM_json_traits_deserialize)->ArgName("items")->Arg(1)->Arg(100)->Arg(10000);
+BENCHMARK(BM_json_writer)->ArgName("items")->Arg(1)->Arg(100)->Arg(10000);
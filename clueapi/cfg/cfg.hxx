@@ -10,13 +10,23 @@
 #define CLUEAPI_CFG_HXX
 
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "clueapi/http/types/response_class/response_class.hxx"
 
 #include "clueapi/http/multipart/detail/types/cfg/cfg.hxx"
 
+#include "clueapi/shared/buffer_pool/detail/cfg/cfg.hxx"
+#include "clueapi/shared/io_ctx_pool/detail/cfg/cfg.hxx"
+#include "clueapi/shared/thread_pool/detail/cfg/cfg.hxx"
+
+#include "clueapi/shared/tracing/tracing.hxx"
+
 #ifdef CLUEAPI_USE_LOGGING_MODULE
 #include "logging/logging.hxx"
 #endif // CLUEAPI_USE_LOGGING_MODULE
@@ -51,6 +61,54 @@ namespace clueapi::cfg {
          */
         std::int32_t m_workers{2};
 
+        /**
+         * @struct prefork_t
+         *
+         * @brief Configuration for the prefork mode, where the server runs in worker processes.
+         */
+        struct prefork_t {
+            /**
+             * @brief If true, `c_clueapi::start` turns the calling process into a supervisor
+             * that forks `m_processes` workers. Each worker binds its own SO_REUSEPORT listener
+             * and serves with its own pool of `m_workers` threads, sharing nothing with the
+             * others.
+             *
+             * @note POSIX only. The supervisor restarts the workers that exit and replaces them
+             * one by one on `SIGHUP` or `c_clueapi::reload`.
+             */
+            bool m_enabled{false};
+
+            /**
+             * @brief The number of worker processes.
+             *
+             * @note A value of 0 uses the number of CPUs (`std::thread::hardware_concurrency()`).
+             */
+            std::size_t m_processes{0u};
+
+            /**
+             * @brief Called in each worker process right after the fork, before the server
+             * starts, with the index of the worker. The clients that can't be shared across a
+             * fork (e.g., Redis connections or database pools) are created here.
+             */
+            std::function<void(std::size_t)> m_on_worker_start{};
+
+            /**
+             * @brief The time a worker has to start serving before it is considered failed.
+             */
+            std::chrono::milliseconds m_ready_timeout{5000};
+
+            /**
+             * @brief The delay before a worker that exited unexpectedly is restarted.
+             */
+            std::chrono::milliseconds m_restart_delay{1000};
+
+            /**
+             * @brief The time a stopped or replaced worker has to finish its requests before it
+             * is killed.
+             */
+            std::chrono::milliseconds m_drain_timeout{10000};
+        } m_prefork{};
+
         /**
          * @struct server_t
          *
@@ -70,6 +128,32 @@ namespace clueapi::cfg {
              */
             std::chrono::seconds m_deadline_for_destroying_clients{5};
 
+            /**
+             * @brief Configuration for the I/O context pool (worker selection policy, loop lag
+             * probe).
+             */
+            shared::detail::io_ctx_pool_cfg_t m_io_ctx_pool{};
+
+            /**
+             * @brief Configuration for the pool running the synchronous handlers of the
+             * `route::e_executor::cpu` routes.
+             */
+            shared::detail::thread_pool_cfg_t m_cpu_pool{};
+
+            /**
+             * @brief Configuration for the pool running the synchronous handlers of the
+             * `route::e_executor::blocking` routes.
+             *
+             * @note Sized past the number of CPUs, its threads mostly wait.
+             */
+            shared::detail::thread_pool_cfg_t m_blocking_pool{.m_threads = 32u};
+
+            /**
+             * @brief The tick of the per-worker timer wheel that backs the keep-alive and socket
+             * timeouts. Zero uses a `steady_timer` per connection instead.
+             */
+            std::chrono::milliseconds m_timer_wheel_tick{100};
+
             /**
              * @struct client_t
              *
@@ -80,6 +164,36 @@ namespace clueapi::cfg {
                  * @brief Default buffer capacity for the client in bytes.
                  */
                 std::size_t m_buffer_capacity{64ull * 1024u};
+
+                /**
+                 * @brief The settings of the per-worker pools the client buffers are borrowed
+                 * from while a request is read and processed.
+                 */
+                shared::detail::buffer_pool_cfg_t m_buffer_pool{};
+
+                /**
+                 * @brief If true, the client pool grows on demand instead of preallocating
+                 * `acceptor_t::m_max_connections` clients, and shrinks back when clients stay idle.
+                 */
+                bool m_elastic_pool{false};
+
+                /**
+                 * @brief The number of clients created at startup and always kept in an elastic
+                 * pool.
+                 */
+                std::size_t m_warm_clients{64};
+
+                /**
+                 * @brief The hard maximum number of clients in an elastic pool.
+                 *
+                 * @note A value of 0 uses `acceptor_t::m_max_connections`.
+                 */
+                std::size_t m_max_clients{0};
+
+                /**
+                 * @brief The time after which a free client above the warm minimum is destroyed.
+                 */
+                std::chrono::seconds m_idle_timeout{60};
             } m_client{};
 
             /**
@@ -93,6 +207,13 @@ namespace clueapi::cfg {
                  */
                 std::size_t m_max_connections{2048};
 
+                /**
+                 * @brief The backlog passed to `listen()`.
+                 *
+                 * @note A value of 0 uses `m_max_connections`.
+                 */
+                std::size_t m_backlog{0};
+
                 /**
                  * @brief If true, the acceptor socket will be non-blocking. Recommended for high
                  * performance.
@@ -116,7 +237,75 @@ namespace clueapi::cfg {
                  * Requires OS support.
                  */
                 bool m_tcp_fast_open{true};
+
+                /**
+                 * @brief If true, every worker `io_context` owns its own SO_REUSEPORT acceptor
+                 * bound to the same endpoint, so a connection is accepted and served on the same
+                 * worker.
+                 *
+                 * @note Requires `m_reuse_port`. Otherwise a single shared acceptor is used.
+                 */
+                bool m_shard_per_core{false};
+
+                /**
+                 * @brief If true, attaches a SO_ATTACH_REUSEPORT_CBPF program to the sharded
+                 * acceptors that steers each connection to the acceptor of the receiving CPU.
+                 *
+                 * @note Linux only. Has no effect unless `m_shard_per_core` is enabled and the
+                 * placement of the I/O context pool pins every worker to a CPU of its own. Ignored
+                 * in the prefork mode, where the reuseport group spans the processes.
+                 */
+                bool m_reuse_port_cbpf{false};
             } m_acceptor{};
+
+            /**
+             * @struct admission_t
+             *
+             * @brief Admission control and accept backpressure settings used under overload.
+             */
+            struct admission_t {
+                /**
+                 * @brief If true, enables admission control.
+                 */
+                bool m_enabled{false};
+
+                /**
+                 * @brief The share of the client pool capacity at which the accept loops pause.
+                 */
+                float m_pause_ratio{1.0f};
+
+                /**
+                 * @brief The share of the client pool capacity at which paused accept loops
+                 * resume.
+                 *
+                 * @note Must be lower than `m_pause_ratio` to provide hysteresis.
+                 */
+                float m_resume_ratio{0.9f};
+
+                /**
+                 * @brief If true, a rejected connection receives a pre-serialized
+                 * `503 Service Unavailable` response before it is closed.
+                 */
+                bool m_reject_with_503{true};
+
+                /**
+                 * @brief The value of the Retry-After header sent with the 503 response.
+                 */
+                std::chrono::seconds m_retry_after{1};
+
+                /**
+                 * @brief The maximum number of connections waiting for a free client.
+                 *
+                 * @note A value of 0 disables the wait queue, so connections are rejected as soon
+                 * as the pool is exhausted.
+                 */
+                std::size_t m_wait_queue_size{0};
+
+                /**
+                 * @brief The maximum time a connection waits in the queue for a free client.
+                 */
+                std::chrono::milliseconds m_wait_deadline{250};
+            } m_admission{};
         } m_server{};
 
         /**
@@ -163,6 +352,11 @@ namespace clueapi::cfg {
              * @brief The size of the buffer chunk used when reading/parsing a request.
              */
             std::size_t m_chunk_size{131072};
+
+            /**
+             * @brief The value of the `Server` header of every response, empty to leave it out.
+             */
+            std::string m_server_name{};
         } m_http{};
 
         /**
@@ -198,6 +392,344 @@ namespace clueapi::cfg {
             std::chrono::milliseconds m_timeout{std::chrono::seconds{15}};
         } m_socket{};
 
+        /**
+         * @struct tls_t
+         *
+         * @brief Configuration for the TLS termination of the connections.
+         */
+        struct tls_t {
+            /**
+             * @enum e_version
+             *
+             * @brief A version of the TLS protocol.
+             */
+            enum struct e_version : std::uint8_t { tls12, tls13 };
+
+            /**
+             * @brief If true, every accepted connection starts with a TLS handshake.
+             *
+             * @details Only the handshake runs in OpenSSL. The keys of the session are then
+             * handed to the kernel (kTLS), which encrypts and decrypts the records, so the
+             * connection is served through the plain socket like any other, `sendfile(2)`
+             * included.
+             *
+             * @note Needs OpenSSL 3.0 built with kTLS and the `tls` module of Linux. A session
+             * the kernel can't take in both directions is encrypted by OpenSSL in user space, see
+             * `m_require_ktls`.
+             */
+            bool m_enabled{false};
+
+            /**
+             * @brief If true, the sessions are only served when the kernel takes them.
+             *
+             * @details The server fails to start when OpenSSL or the kernel can't offload
+             * sessions or a configured cipher can't be offloaded, and a connection whose session
+             * the kernel doesn't take in both directions is closed after its handshake.
+             * Otherwise such a session is served by OpenSSL in user space, relayed to the
+             * connection through a socket pair, at the cost of a copy each way.
+             */
+            bool m_require_ktls{false};
+
+            /**
+             * @brief The path of the PEM certificate chain, the leaf first.
+             */
+            std::string m_cert_file{};
+
+            /**
+             * @brief The path of the PEM private key of the certificate.
+             */
+            std::string m_key_file{};
+
+            /**
+             * @brief The oldest version of the protocol accepted.
+             */
+            e_version m_min_version{e_version::tls12};
+
+            /**
+             * @brief The newest version of the protocol accepted.
+             *
+             * @note Some OpenSSL builds only offload the receiving side of TLS 1.2 sessions, use
+             * `e_version::tls12` with those.
+             */
+            e_version m_max_version{e_version::tls13};
+
+            /**
+             * @brief The cipher list of TLS 1.2, in OpenSSL format. The default only holds
+             * AEAD ciphers the kernel can offload.
+             */
+            std::string m_ciphers{
+                "ECDHE-ECDSA-AES128-GCM-SHA256:ECDHE-RSA-AES128-GCM-SHA256:"
+                "ECDHE-ECDSA-AES256-GCM-SHA384:ECDHE-RSA-AES256-GCM-SHA384:"
+                "ECDHE-ECDSA-CHACHA20-POLY1305:ECDHE-RSA-CHACHA20-POLY1305"};
+
+            /**
+             * @brief The cipher suites of TLS 1.3, in OpenSSL format.
+             */
+            std::string m_ciphersuites{
+                "TLS_AES_128_GCM_SHA256:TLS_AES_256_GCM_SHA384:TLS_CHACHA20_POLY1305_SHA256"};
+
+            /**
+             * @brief The protocols offered through ALPN, by order of preference.
+             *
+             * @note Empty offers `h2`, when HTTP/2 is built and enabled, then `http/1.1`.
+             */
+            std::vector<std::string> m_alpn{};
+
+            /**
+             * @brief If true, sessions are resumed from the tickets the server issues.
+             */
+            bool m_session_tickets{true};
+
+            /**
+             * @brief The secret the keys of the session tickets are derived from.
+             *
+             * @details The key of a period of `m_ticket_rotation` is derived from the secret and
+             * the wall clock, so every worker, process and server given the same secret issues
+             * and accepts the same tickets without sharing any state. A ticket stays valid for
+             * the period after the one it was issued in.
+             *
+             * @note Empty uses a random secret, shared by the worker processes of the prefork
+             * mode.
+             */
+            std::string m_ticket_secret{};
+
+            /**
+             * @brief The period after which the ticket key is replaced.
+             */
+            std::chrono::seconds m_ticket_rotation{std::chrono::hours{1}};
+
+            /**
+             * @brief The time a client has to complete its handshake.
+             */
+            std::chrono::milliseconds m_handshake_timeout{std::chrono::seconds{10}};
+        } m_tls{};
+
+        /**
+         * @struct websocket_t
+         *
+         * @brief Configuration for the connections upgraded to WebSocket.
+         */
+        struct websocket_t {
+            /**
+             * @brief The maximum size of a received message in bytes, after decompression.
+             */
+            std::size_t m_max_message_size{1048576u};
+
+            /**
+             * @brief The maximum number of bytes queued for sending to a connection.
+             *
+             * @details A connection that doesn't read fast enough to stay below the limit is
+             * dropped instead of buffering without bound.
+             */
+            std::size_t m_max_queued_bytes{4194304u};
+
+            /**
+             * @brief If true, accepts the permessage-deflate extension when a client offers it.
+             */
+            bool m_permessage_deflate{true};
+
+            /**
+             * @brief The minimum size of a message for it to be compressed.
+             */
+            std::size_t m_compress_threshold{512u};
+
+            /**
+             * @brief The compression level of the messages, from 1 (fastest) to 9 (smallest).
+             */
+            std::int32_t m_compression_level{6};
+
+            /**
+             * @brief How long a closing connection may take to send its queued messages.
+             */
+            std::chrono::milliseconds m_close_timeout{std::chrono::seconds{5}};
+
+            /**
+             * @brief The origins allowed to upgrade a connection (e.g., "https://example.com"),
+             * compared case-insensitively. Empty allows every origin.
+             *
+             * @details A browser sends the `Origin` of the page with every upgrade request, even
+             * one made from another site, along with the cookies of the server. An upgrade request
+             * from another origin gets `403 Forbidden`. A request without an `Origin`, which
+             * doesn't come from a browser, is allowed.
+             */
+            std::vector<std::string> m_allowed_origins{};
+        } m_websocket{};
+
+        /**
+         * @struct http2_t
+         *
+         * @brief Configuration for HTTP/2 connections, used when built with `CLUEAPI_USE_HTTP2`.
+         */
+        struct http2_t {
+            /**
+             * @brief If true, connections that start with the HTTP/2 preface (h2c with prior
+             * knowledge) are served over HTTP/2.
+             */
+            bool m_enabled{true};
+
+            /**
+             * @brief The maximum number of streams a client may open at once
+             * (`SETTINGS_MAX_CONCURRENT_STREAMS`).
+             */
+            std::uint32_t m_max_concurrent_streams{128u};
+
+            /**
+             * @brief The flow control window of each stream for request bodies, in bytes
+             * (`SETTINGS_INITIAL_WINDOW_SIZE`).
+             */
+            std::uint32_t m_initial_window_size{1048576u};
+
+            /**
+             * @brief The flow control window of the connection for request bodies, in bytes.
+             */
+            std::uint32_t m_connection_window_size{16777216u};
+
+            /**
+             * @brief The maximum size of the decoded headers of a request
+             * (`SETTINGS_MAX_HEADER_LIST_SIZE`).
+             */
+            std::uint32_t m_max_header_list_size{65536u};
+
+            /**
+             * @brief The maximum number of bytes of a streamed response buffered for a stream
+             * before its writer waits for the client to take them.
+             */
+            std::size_t m_max_buffered_bytes{262144u};
+        } m_http2{};
+
+        /**
+         * @struct access_log_t
+         *
+         * @brief Configuration for the access log, one record per HTTP/1 request.
+         */
+        struct access_log_t {
+            /**
+             * @enum e_format
+             *
+             * @brief The format of the access log file.
+             */
+            enum struct e_format : std::uint8_t {
+                /**
+                 * @brief One line per request: time, method, target, status, bytes and latency.
+                 */
+                text,
+
+                /**
+                 * @brief One JSON object per line.
+                 */
+                json,
+
+                /**
+                 * @brief The fixed-size records as they are, in native byte order.
+                 */
+                binary
+            };
+
+            /**
+             * @brief If true, the requests are written to the access log.
+             */
+            bool m_enabled{false};
+
+            /**
+             * @brief The path of the access log file, opened in append mode.
+             */
+            std::string m_path{"access.log"};
+
+            e_format m_format{e_format::text};
+
+            /**
+             * @brief The fraction of the requests answered with a status below 400 that are
+             * logged, from 0 to 1.
+             */
+            double m_sample_rate{1.0};
+
+            /**
+             * @brief The fraction of the requests answered with a 4xx status that are logged.
+             *
+             * @note Requests answered with a 5xx status are always logged.
+             */
+            double m_client_error_sample_rate{1.0};
+
+            /**
+             * @brief The number of records each worker buffers between two flushes. Records
+             * past it are dropped and counted.
+             */
+            std::size_t m_buffer_size{16384u};
+
+            /**
+             * @brief The interval at which the buffered records are written. A worker whose
+             * buffer is half full wakes the writer earlier.
+             */
+            std::chrono::milliseconds m_flush_interval{200};
+        } m_access_log{};
+
+        /**
+         * @struct metrics_t
+         *
+         * @brief Configuration for the metrics of the server, see `shared::metrics_t`.
+         */
+        struct metrics_t {
+            /**
+             * @brief If true, the latencies of the routes and the responses are recorded.
+             *
+             * @note The `GET /metrics` route of `enable_default_handlers()` is served either way,
+             * with the connection and pool counters only.
+             */
+            bool m_enabled{false};
+        } m_metrics{};
+
+        /**
+         * @struct tracing_t
+         *
+         * @brief Configuration for the tracing of the HTTP/1 requests, see `shared::trace_t`.
+         */
+        struct tracing_t {
+            /**
+             * @brief If true, the phases of every request are timed and the sampled traces are
+             * exported to `m_sink`.
+             */
+            bool m_enabled{false};
+
+            /**
+             * @brief The sink the traces are exported to, required when tracing is enabled.
+             */
+            std::shared_ptr<shared::trace_sink_t> m_sink;
+
+            /**
+             * @brief The fraction of the requests that are exported whatever their duration,
+             * from 0 to 1. Their context is marked sampled for the handlers' own calls.
+             */
+            double m_sample_rate{0.0};
+
+            /**
+             * @brief The duration from which a request is always exported. A value of 0 exports
+             * none for being slow.
+             */
+            std::chrono::microseconds m_slow_threshold{std::chrono::milliseconds{250}};
+
+            /**
+             * @brief If true, the requests whose `traceparent` is sampled are exported.
+             */
+            bool m_follow_parent{true};
+
+            /**
+             * @brief The maximum number of traces handed to the sink at once.
+             */
+            std::size_t m_batch_size{512u};
+
+            /**
+             * @brief The maximum number of traces waiting for the sink. Traces past it are
+             * dropped and counted.
+             */
+            std::size_t m_max_queued{8192u};
+
+            /**
+             * @brief The interval at which the waiting traces are exported. A full batch wakes
+             * the exporter earlier.
+             */
+            std::chrono::milliseconds m_flush_interval{1000};
+        } m_tracing{};
+
 #ifdef CLUEAPI_USE_LOGGING_MODULE
         /**
          * @brief Configuration for the logging module. See logging_cfg_t for details.
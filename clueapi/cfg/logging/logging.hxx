@@ -73,6 +73,15 @@ namespace clueapi::cfg {
          * before sleeping. Only applicable if `m_async_mode` is `true`.
          */
         std::size_t m_batch_size{512};
+
+        /**
+         * @brief Defers the formatting of the log messages to the worker thread.
+         *
+         * @note The calling thread then only copies the format string and the arguments, as long
+         * as they are numbers, enums, durations or short strings. Only applicable if
+         * `m_async_mode` is `true`.
+         */
+        bool m_deferred_format{false};
     };
 #endif // CLUEAPI_USE_LOGGING_MODULE
 } // namespace clueapi::cfg
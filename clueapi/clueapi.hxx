@@ -12,15 +12,25 @@
 #define CLUEAPI_HXX
 
 #include <memory>
+#include <string_view>
+#include <type_traits>
 #include <variant>
 #include <functional>
 
 #include "clueapi/cfg/cfg.hxx"
 
+#include "clueapi/middleware/response_cache/response_cache.hxx"
+#include "clueapi/middleware/static_files/static_files.hxx"
+
 #include "clueapi/route/route.hxx"
+#include "clueapi/route/route_template/route_template.hxx"
 
 #include "clueapi/shared/macros.hxx"
 
+#include "clueapi/sse/sse.hxx"
+
+#include "clueapi/websocket/websocket.hxx"
+
 // Forward declarations
 namespace clueapi {
     namespace middleware {
@@ -31,6 +41,8 @@ namespace clueapi {
 
     namespace shared {
         struct io_ctx_pool_t;
+
+        struct thread_pool_t;
     } // namespace shared
 } // namespace clueapi
 
@@ -65,6 +77,11 @@ namespace clueapi {
          * @brief Starts the server with the specified configuration.
          *
          * @param cfg The configuration settings for the server.
+         *
+         * @details With `cfg_t::prefork_t::m_enabled`, the calling process becomes the supervisor
+         * of the worker processes that run the server, and the function returns once they are
+         * serving. The workers are forked with the routes and middlewares added so far, so
+         * everything is added before the call. The calling thread should only `wait()` then.
          */
         void start(cfg_t cfg);
 
@@ -80,6 +97,14 @@ namespace clueapi {
          */
         void stop();
 
+        /**
+         * @brief Replaces the worker processes of the prefork mode one by one, each stopped once
+         * its replacement serves. Same as sending `SIGHUP` to the supervisor.
+         *
+         * @note Does nothing outside of the prefork mode.
+         */
+        void reload();
+
        private:
         /**
          * @brief A variant representing either a synchronous or an asynchronous route handler.
@@ -95,9 +120,97 @@ namespace clueapi {
          * @param method The HTTP method (e.g., GET, POST).
          * @param path The URL path for the route.
          * @param handler The function (sync or async) that will handle requests to this route.
+         * @param body_mode How the body of the requests is delivered to the handler. With
+         * `route::e_body_mode::streamed`, the handler reads it through `ctx_t::body_stream()`.
+         * @param executor Where a synchronous handler runs. Off `route::e_executor::io`, it runs
+         * on a thread pool and its request gets `503 Service Unavailable` while the queue of the
+         * pool is full.
+         */
+        void add_method(
+            http::types::method_t::e_method method,
+            http::types::path_t path,
+            route_t&& handler,
+            route::e_body_mode body_mode = route::e_body_mode::buffered,
+            route::e_executor executor = route::e_executor::io);
+
+        /**
+         * @brief Adds a new route whose parameters are typed by a compile-time template.
+         *
+         * @tparam _path The route template, e.g. `"/users/{id:u64}/posts/{slug}"`.
+         * @tparam _fn_t The type of the handler.
+         *
+         * @param method The HTTP method (e.g., GET, POST).
+         * @param handler The function (sync or async) called as `handler(ctx, params...)`, with
+         * the parameters in the order of the template and converted to their types.
+         * @param body_mode How the body of the requests is delivered to the handler.
+         * @param executor Where a synchronous handler runs.
+         *
+         * @details A malformed template or a handler that doesn't match it fails the compilation.
+         * A request whose parameters don't convert (e.g., a non-digit `u64`) gets a
+         * `404 Not Found` without reaching the handler.
          */
+        template <route::fixed_string_t _path, typename _fn_t>
         void add_method(
-            http::types::method_t::e_method method, http::types::path_t path, route_t&& handler);
+            http::types::method_t::e_method method,
+            _fn_t&& handler,
+            route::e_body_mode body_mode = route::e_body_mode::buffered,
+            route::e_executor executor = route::e_executor::io) {
+            using template_t = route::route_template_t<_path>;
+
+            using handler_t = std::decay_t<_fn_t>;
+
+            static_assert(
+                template_t::template k_is_invocable<handler_t>,
+                "The handler must take (http::ctx_t, parameters...) in the order and the types of "
+                "the route template");
+
+            static_assert(
+                !template_t::template k_is_invocable<handler_t> ||
+                    template_t::template k_returns_response<handler_t>,
+                "The handler must return a response or an awaitable response");
+
+            if constexpr (template_t::template k_returns_response<handler_t>) {
+
+                add_route(
+                    method,
+
+                    http::types::path_t{template_t::k_path},
+
+                    std::make_shared<route::typed_route_t<template_t, handler_t>>(
+                        std::forward<_fn_t>(handler), body_mode, executor));
+            }
+        }
+
+        /**
+         * @brief Adds a prebuilt route for a specific HTTP method and path.
+         *
+         * @param method The HTTP method (e.g., GET, POST).
+         * @param path The URL path for the route.
+         * @param route The route.
+         */
+        void add_route(
+            http::types::method_t::e_method method,
+            http::types::path_t path,
+            std::shared_ptr<route::base_route_t> route);
+
+        /**
+         * @brief Adds a WebSocket route.
+         *
+         * @param path The URL path for the route, with dynamic segments like `add_method()`.
+         * @param handler The coroutine that runs the upgraded connection.
+         *
+         * @details A `GET` request to the path with `Upgrade: websocket` is answered with
+         * `101 Switching Protocols`, accepting permessage-deflate if enabled in
+         * `cfg_t::m_websocket`, and the handler then runs on the connection until it returns.
+         * An upgrade request to a path without a WebSocket route gets `404 Not Found`.
+         *
+         * @note The upgrade request passes through the middlewares before it is answered, so
+         * one that refuses it (e.g., authentication) answers the request with its own
+         * response, and the headers and cookies they add to the response of the route are sent
+         * with the `101`. An `Origin` missing from `cfg_t::websocket_t::m_allowed_origins` is
+         * refused with `403 Forbidden`.
+         */
+        void add_websocket(http::types::path_t path, websocket::handler_t handler);
 
         /**
          * @brief Adds a new middleware to the middleware chain.
@@ -106,6 +219,22 @@ namespace clueapi {
          */
         void add_middleware(middleware::middleware_t middleware);
 
+        /**
+         * @brief Serves the files of a directory under a URL prefix.
+         *
+         * @param prefix The URL prefix of the mount (e.g., "/assets").
+         * @param root The directory served.
+         * @param cfg The settings of the mount.
+         *
+         * @details Adds a `middleware::c_static_files` to the middleware chain, so the mount sees
+         * the requests in the order it was added among the middlewares. Requests it doesn't serve
+         * continue to the routes.
+         */
+        void mount_static(
+            http::types::path_t prefix,
+            boost::filesystem::path root,
+            middleware::static_files_cfg_t cfg = {});
+
         /**
          * @brief Enables the default handlers for the server.
          *
@@ -113,6 +242,8 @@ namespace clueapi {
          *  - `GET /favicon.ico` => `204 No Content`
          *  - `GET /robots.txt` => `200 OK`
          *  - `GET /.well-known/appspecific/com.chrome.devtools.json` => `200 OK`
+         *  - `GET /metrics` => `200 OK`, the metrics in the Prometheus text format. The routes
+         *    and responses are only recorded with `cfg_t::m_metrics` enabled.
          */
         void enable_default_handlers();
 
@@ -130,6 +261,25 @@ namespace clueapi {
          */
         [[nodiscard]] shared::io_ctx_pool_t& io_ctx_pool() const noexcept;
 
+        /**
+         * @brief Gets the pool of the `route::e_executor::cpu` routes.
+         *
+         * @return A reference to the pool, running once started if a route runs on it or
+         * `cfg_t::server_t::m_cpu_pool` is enabled.
+         */
+        [[nodiscard]] shared::thread_pool_t& cpu_pool() const noexcept;
+
+        /**
+         * @brief Gets the pool of the `route::e_executor::blocking` routes.
+         *
+         * @return A reference to the pool, running once started if a route runs on it or
+         * `cfg_t::server_t::m_blocking_pool` is enabled.
+         *
+         * @details A coroutine handler offloads a blocking call with
+         * `co_await app.blocking_pool().run(fn)`, resuming on its own `io_context`.
+         */
+        [[nodiscard]] shared::thread_pool_t& blocking_pool() const noexcept;
+
         /**
          * @brief Checks if the clueapi is currently running.
          *
@@ -144,6 +294,44 @@ namespace clueapi {
          */
         [[nodiscard]] bool is_stopped() const noexcept;
 
+        /**
+         * @brief Gets how the body of a request is delivered to the handler of its route.
+         *
+         * @param method The HTTP method of the request.
+         * @param path The URL path of the request.
+         *
+         * @return The body mode of the matching route, `route::e_body_mode::buffered` if none.
+         *
+         * @details Used by the server to decide how to read a body before the request is routed.
+         * Does not walk the routing tree unless a streamed route was registered.
+         */
+        [[nodiscard]] route::e_body_mode body_mode(
+            http::types::method_t::e_method method, std::string_view path) const;
+
+        /**
+         * @brief Finds the WebSocket route of a path.
+         *
+         * @param path The URL path of the upgrade request.
+         * @param params The parameters of the dynamic segments, filled on a match.
+         *
+         * @return The handler of the route, `nullptr` if none. Valid as long as the instance.
+         *
+         * @details Used by the server when a request asks for an upgrade.
+         */
+        [[nodiscard]] const websocket::handler_t* websocket_handler(
+            std::string_view path, http::types::params_t& params) const;
+
+        /**
+         * @brief Gets the middleware chain of the WebSocket upgrade requests.
+         *
+         * @return The chain, ending with `101 Switching Protocols` for a request to a WebSocket
+         * route and `404 Not Found` otherwise. Valid as long as the instance.
+         *
+         * @details Used by the server to pass an upgrade request through the middlewares before
+         * it is accepted.
+         */
+        [[nodiscard]] const middleware::middleware_chain_t& upgrade_chain() const noexcept;
+
        private:
         /**
          * @class c_impl
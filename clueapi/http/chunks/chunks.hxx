@@ -7,8 +7,13 @@
 #ifndef CLUEAPI_HTTP_CHUNKS_HXX
 #define CLUEAPI_HTTP_CHUNKS_HXX
 
+#include <array>
+#include <chrono>
 #include <cstddef>
+#include <memory>
+#include <optional>
 #include <ranges>
+#include <string>
 #include <string_view>
 
 #include <boost/asio/ip/tcp.hpp>
@@ -30,6 +35,86 @@ namespace clueapi::http::chunks {
      */
     inline constexpr std::size_t k_def_buffer_size = 1024;
 
+    /**
+     * @struct coalesce_t
+     *
+     * @brief The settings of a chunk writer that gathers small chunks into fewer writes.
+     */
+    struct coalesce_t {
+        /**
+         * @brief The number of buffered bytes at which the chunks are written.
+         */
+        std::size_t m_threshold{16u * 1024u};
+
+        /**
+         * @brief The maximum age of a buffered chunk, checked whenever a chunk is written.
+         */
+        std::chrono::milliseconds m_deadline{10};
+    };
+
+    /**
+     * @struct encoder_t
+     *
+     * @brief Transforms the body of a chunked response as it is written, e.g. to compress it.
+     */
+    struct encoder_t {
+        CLUEAPI_INLINE virtual ~encoder_t() noexcept = default;
+
+       public:
+        /**
+         * @brief Encodes a part of the body.
+         *
+         * @param data The part of the body.
+         * @param out The string the encoded bytes are appended to, possibly none yet.
+         *
+         * @return An empty expected on success, or an unexpected containing an error message.
+         */
+        virtual exceptions::expected_t<> encode(std::string_view data, std::string& out) = 0;
+
+        /**
+         * @brief Ends the encoded body.
+         *
+         * @param out The string the remaining encoded bytes are appended to.
+         *
+         * @return An empty expected on success, or an unexpected containing an error message.
+         */
+        virtual exceptions::expected_t<> finish(std::string& out) = 0;
+    };
+
+    /**
+     * @struct sink_t
+     *
+     * @brief Receives the body of a streamed response where the protocol frames it itself, e.g.
+     * an HTTP/2 stream.
+     */
+    struct sink_t {
+        CLUEAPI_INLINE virtual ~sink_t() noexcept = default;
+
+       public:
+        /**
+         * @brief Writes a part of the body.
+         *
+         * @param data The part of the body, possibly encoded.
+         *
+         * @return An empty expected on success, or an unexpected containing an error message.
+         */
+        virtual exceptions::expected_awaitable_t<> write(std::string_view data) = 0;
+
+        /**
+         * @brief Ends the body.
+         *
+         * @return An empty expected on success, or an unexpected containing an error message.
+         */
+        virtual exceptions::expected_awaitable_t<> finish() = 0;
+
+        /**
+         * @brief Checks if the peer is gone.
+         *
+         * @return `true` if nothing written reaches the peer anymore, `false` otherwise.
+         */
+        [[nodiscard]] virtual bool is_closed() const noexcept = 0;
+    };
+
     /**
      * @struct chunk_writer_t
      *
@@ -39,6 +124,14 @@ namespace clueapi::http::chunks {
      * @details This class formats data into the required chunked structure (size, CRLF, data, CRLF)
      * and writes it asynchronously to a TCP socket. It is essential for streaming responses where
      * the total content length is not known in advance.
+     *
+     * The framing and the payload are written as one buffer sequence, so the payload is never
+     * copied. With coalescing enabled, chunks are buffered until `m_threshold` bytes are pending
+     * or the oldest of them is older than `m_deadline`, and go out in a single `writev`. A chunk
+     * that does not fit is written together with the pending ones, still without being copied.
+     *
+     * Constructed over a `sink_t`, the writer skips the chunked framing and coalescing, and hands
+     * the (encoded) parts of the body to the sink as they are.
      */
     struct chunk_writer_t {
         /**
@@ -48,7 +141,27 @@ namespace clueapi::http::chunks {
          * The socket must remain valid for the lifetime of the writer.
          */
         CLUEAPI_INLINE chunk_writer_t(boost::asio::ip::tcp::socket& socket) noexcept
-            : m_socket{socket} {
+            : m_socket{&socket} {
+        }
+
+        /**
+         * @brief Constructs a chunk writer that coalesces small chunks.
+         *
+         * @param socket The TCP socket to write the chunked data to.
+         * @param coalesce The coalescing settings.
+         */
+        CLUEAPI_INLINE chunk_writer_t(
+            boost::asio::ip::tcp::socket& socket, coalesce_t coalesce) noexcept
+            : m_socket{&socket}, m_coalesce{coalesce} {
+        }
+
+        /**
+         * @brief Constructs a chunk writer over a sink.
+         *
+         * @param sink The sink the body is written to.
+         * The sink must remain valid for the lifetime of the writer.
+         */
+        CLUEAPI_INLINE explicit chunk_writer_t(sink_t& sink) noexcept : m_sink{&sink} {
         }
 
         CLUEAPI_INLINE ~chunk_writer_t() noexcept = default;
@@ -78,14 +191,54 @@ namespace clueapi::http::chunks {
          */
         exceptions::expected_awaitable_t<> write_final_chunk() noexcept;
 
+        /**
+         * @brief Asynchronously writes the chunks buffered by coalescing.
+         *
+         * @return An `exceptions::expected_awaitable_t<>` that resolves to an empty expected on
+         * success, or an unexpected containing an error message on failure.
+         *
+         * @note Call it before waiting for the next event of a stream, the deadline is only
+         * checked when a chunk is written.
+         */
+        exceptions::expected_awaitable_t<> flush() noexcept;
+
        public:
+        /**
+         * @brief Enables or changes coalescing, e.g. from a stream function.
+         *
+         * @param coalesce The coalescing settings.
+         */
+        CLUEAPI_INLINE void coalesce(coalesce_t coalesce) noexcept {
+            m_coalesce = coalesce;
+        }
+
+        /**
+         * @brief Gets the number of bytes buffered by coalescing.
+         *
+         * @return The number of bytes not yet written.
+         */
+        [[nodiscard]] CLUEAPI_INLINE std::size_t pending_bytes() const noexcept {
+            return m_buffer.size();
+        }
+
+        /**
+         * @brief Sets the encoder the chunks pass through before they are framed.
+         *
+         * @param encoder The encoder, `nullptr` to write the chunks as they are.
+         *
+         * @note Set it before the first chunk, the encoder sees the whole body.
+         */
+        CLUEAPI_INLINE void encoder(std::shared_ptr<encoder_t> encoder) noexcept {
+            m_encoder = std::move(encoder);
+        }
+
         /**
          * @brief Checks if the underlying socket is closed.
          *
          * @return `true` if the socket is no longer open, `false` otherwise.
          */
         [[nodiscard]] CLUEAPI_INLINE bool writer_closed() const noexcept {
-            return !m_socket.is_open();
+            return m_sink ? m_sink->is_closed() : !m_socket->is_open();
         }
 
         /**
@@ -97,6 +250,14 @@ namespace clueapi::http::chunks {
             return m_final_chunk_written;
         }
 
+       private:
+        /**
+         * @brief Frames and writes a single chunk, or buffers it when coalescing.
+         *
+         * @param data The data of the chunk.
+         */
+        exceptions::expected_awaitable_t<> write_framed(std::string_view data) noexcept;
+
        private:
         /**
          * @brief Flag indicating if the final chunk has been written.
@@ -104,12 +265,42 @@ namespace clueapi::http::chunks {
         bool m_final_chunk_written{false};
 
         /**
-         * @brief The socket to write to.
+         * @brief The socket to write to, `nullptr` with a sink.
+         */
+        boost::asio::ip::tcp::socket* m_socket{};
+
+        /**
+         * @brief The sink to write to, `nullptr` with a socket.
+         */
+        sink_t* m_sink{};
+
+        /**
+         * @brief The encoder of the body, if any.
+         */
+        std::shared_ptr<encoder_t> m_encoder{};
+
+        /**
+         * @brief The output of the encoder for the chunk being written.
+         */
+        std::string m_encoded{};
+
+        /**
+         * @brief The coalescing settings, empty to write every chunk right away.
+         */
+        std::optional<coalesce_t> m_coalesce{};
+
+        /**
+         * @brief The time the oldest buffered chunk was written.
+         */
+        std::chrono::steady_clock::time_point m_pending_since{};
+
+        /**
+         * @brief The size line of the chunk being written.
          */
-        boost::asio::ip::tcp::socket& m_socket;
+        std::array<char, 18> m_size_line{};
 
         /**
-         * @brief The buffer for storing chunked data.
+         * @brief The buffer for the chunks held back by coalescing.
          *
          * @details This is a basic_memory_buffer with a default capacity of `k_def_buffer_size`
          * bytes.
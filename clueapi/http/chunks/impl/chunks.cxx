@@ -6,6 +6,8 @@
 
 #include "clueapi/http/chunks/chunks.hxx"
 
+#include <algorithm>
+
 #include <boost/asio/write.hpp>
 #include <boost/asio/buffer.hpp>
 #include <boost/asio/use_awaitable.hpp>
@@ -14,39 +16,127 @@
 
 namespace clueapi::http::chunks {
     exceptions::expected_awaitable_t<> chunk_writer_t::write_chunk(std::string_view data) noexcept {
-        m_buffer.clear();
+        if (!m_encoder)
+            co_return co_await write_framed(data);
+
+        m_encoded.clear();
+
+        if (auto encoded = m_encoder->encode(data, m_encoded); !encoded.has_value())
+            co_return encoded;
+
+        // The encoder may keep small inputs until it has a block worth sending
+        if (m_encoded.empty())
+            co_return exceptions::expected_t<>{};
+
+        co_return co_await write_framed(m_encoded);
+    }
+
+    exceptions::expected_awaitable_t<> chunk_writer_t::write_framed(
+        std::string_view data) noexcept {
+        if (m_sink)
+            co_return co_await m_sink->write(data);
+
+        auto end = fmt::format_to(m_size_line.data(), FMT_COMPILE("{:X}"), data.size());
+
+        end = std::copy(k_crlf, k_crlf + k_crlf_size, end);
 
-        fmt::format_to(std::back_inserter(m_buffer), FMT_COMPILE("{:X}"), data.size());
+        const std::string_view size_line{
+            m_size_line.data(), static_cast<std::size_t>(end - m_size_line.data())};
 
-        m_buffer.append(k_crlf, k_crlf + k_crlf_size);
+        if (m_coalesce.has_value()) {
+            const auto framed_size = size_line.size() + data.size() + k_crlf_size;
+
+            if (m_buffer.size() + framed_size < m_coalesce->m_threshold) {
+                if (m_buffer.size() == 0)
+                    m_pending_since = std::chrono::steady_clock::now();
+
+                m_buffer.append(size_line);
 
 #ifndef _WIN32
-        m_buffer.append(data.begin(), data.end());
+                m_buffer.append(data.begin(), data.end());
 #else
-        m_buffer.append(data);
+                m_buffer.append(data);
 #endif // _WIN32
 
-        m_buffer.append(k_crlf, k_crlf + k_crlf_size);
+                m_buffer.append(k_crlf, k_crlf + k_crlf_size);
 
-        co_return co_await exceptions::wrap_awaitable(
-            boost::asio::async_write(
-                m_socket,
-                boost::asio::buffer(m_buffer.data(), m_buffer.size()),
-                boost::asio::use_awaitable),
+                if (std::chrono::steady_clock::now() - m_pending_since < m_coalesce->m_deadline)
+                    co_return exceptions::expected_t<>{};
+
+                co_return co_await flush();
+            }
+        }
+
+        // The chunks held back so far go out first, in the same write
+        const std::array<boost::asio::const_buffer, 4> buffers{
+            boost::asio::buffer(m_buffer.data(), m_buffer.size()),
+            boost::asio::buffer(size_line),
+            boost::asio::buffer(data),
+            boost::asio::buffer(k_crlf)};
+
+        auto written = co_await exceptions::wrap_awaitable(
+            boost::asio::async_write(*m_socket, buffers, boost::asio::use_awaitable),
 
             exceptions::io_error_t::make("Failed to write chunk"));
+
+        m_buffer.clear();
+
+        co_return written;
     }
 
     exceptions::expected_awaitable_t<> chunk_writer_t::write_final_chunk() noexcept {
         if (m_final_chunk_written)
             co_return exceptions::expected_t<>{};
 
+        if (m_encoder) {
+            m_encoded.clear();
+
+            auto finished = m_encoder->finish(m_encoded);
+
+            m_encoder.reset();
+
+            if (!finished.has_value())
+                co_return finished;
+
+            if (!m_encoded.empty()) {
+                if (auto written = co_await write_framed(m_encoded); !written.has_value())
+                    co_return written;
+            }
+        }
+
         m_final_chunk_written = true;
 
-        co_return co_await exceptions::wrap_awaitable(
-            boost::asio::async_write(
-                m_socket, boost::asio::buffer(k_final_chunk), boost::asio::use_awaitable),
+        if (m_sink)
+            co_return co_await m_sink->finish();
+
+        const std::array<boost::asio::const_buffer, 2> buffers{
+            boost::asio::buffer(m_buffer.data(), m_buffer.size()),
+            boost::asio::buffer(k_final_chunk)};
+
+        auto written = co_await exceptions::wrap_awaitable(
+            boost::asio::async_write(*m_socket, buffers, boost::asio::use_awaitable),
 
             exceptions::io_error_t::make("Failed to write final chunk"));
+
+        m_buffer.clear();
+
+        co_return written;
+    }
+
+    exceptions::expected_awaitable_t<> chunk_writer_t::flush() noexcept {
+        if (m_buffer.size() == 0)
+            co_return exceptions::expected_t<>{};
+
+        auto written = co_await exceptions::wrap_awaitable(
+            boost::asio::async_write(
+                *m_socket,
+                boost::asio::buffer(m_buffer.data(), m_buffer.size()),
+                boost::asio::use_awaitable),
+
+            exceptions::io_error_t::make("Failed to flush chunks"));
+
+        m_buffer.clear();
+
+        co_return written;
     }
-} // namespace clueapi::http::chunks
\ No newline at end of file
+} // namespace clueapi::http::chunks
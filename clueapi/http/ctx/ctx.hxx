@@ -7,6 +7,7 @@
 #ifndef CLUEAPI_HTTP_CTX_HXX
 #define CLUEAPI_HTTP_CTX_HXX
 
+#include <memory>
 #include <utility>
 #include <string_view>
 
@@ -16,6 +17,7 @@
 #include "clueapi/exceptions/exceptions.hxx"
 
 #include "clueapi/http/multipart/multipart.hxx"
+#include "clueapi/http/types/body_stream/body_stream.hxx"
 #include "clueapi/http/types/field/field.hxx"
 #include "clueapi/http/types/file/file.hxx"
 #include "clueapi/http/types/request/request.hxx"
@@ -23,6 +25,7 @@
 #include "clueapi/shared/macros.hxx"
 #include "clueapi/shared/non_copy/extract_from/extract_from.hxx"
 #include "clueapi/shared/shared.hxx"
+#include "clueapi/shared/tracing/tracing.hxx"
 
 #include "clueapi/modules/macros.hxx"
 
@@ -37,15 +40,31 @@ namespace clueapi::http {
      * fields and files. It is constructed by the framework and passed to the user-defined handler.
      */
     struct ctx_t {
-        CLUEAPI_INLINE ctx_t() noexcept = default;
+        CLUEAPI_INLINE ctx_t() : m_request(std::make_shared<types::request_t>()) {
+        }
 
         /**
          * @brief Constructs a context with a request and URL parameters.
          *
          * @param request The HTTP request object.
-         * @param params The map of URL parameters extracted by the router.
+         * @param params The URL parameters extracted by the router.
+         *
+         * @note The request is moved, so `params` must not view into it. Share the request to
+         * match its URI in place.
          */
-        CLUEAPI_INLINE ctx_t(types::request_t request, types::params_t params) noexcept
+        CLUEAPI_INLINE ctx_t(types::request_t request, types::params_t params)
+            : m_params(std::move(params)),
+              m_request(std::make_shared<types::request_t>(std::move(request))) {
+        }
+
+        /**
+         * @brief Constructs a context sharing a request owned elsewhere.
+         *
+         * @param request The HTTP request object, must not be `nullptr`.
+         * @param params The URL parameters extracted by the router, may view into the request.
+         */
+        CLUEAPI_INLINE ctx_t(
+            std::shared_ptr<types::request_t> request, types::params_t params) noexcept
             : m_params(std::move(params)), m_request(std::move(request)) {
         }
 
@@ -85,11 +104,34 @@ namespace clueapi::http {
             co_return ctx;
         }
 
+        /**
+         * @brief Asynchronously creates and fully parses a context sharing a request.
+         *
+         * @param request The raw HTTP request object, must not be `nullptr`.
+         * @param params URL parameters matched by the router.
+         * @param cfg Configuration for the multipart parser.
+         *
+         * @return An awaitable that resolves to a fully initialized `ctx_t`.
+         *
+         * @details Used by the framework so that the request, and notably its body, is handed to
+         * the handler without being copied.
+         */
+        CLUEAPI_NOINLINE static shared::awaitable_t<ctx_t> make_awaitable(
+            std::shared_ptr<types::request_t> request,
+            types::params_t params,
+            multipart::parser_t::cfg_t cfg) {
+            ctx_t ctx{std::move(request), std::move(params)};
+
+            co_await ctx.parse(cfg);
+
+            co_return ctx;
+        }
+
        public:
         /**
          * @brief Gets the URL parameters.
          *
-         * @return A reference to the map of URL parameters.
+         * @return A reference to the URL parameters, views valid as long as the context.
          */
         CLUEAPI_INLINE auto& params() noexcept {
             return m_params;
@@ -98,7 +140,7 @@ namespace clueapi::http {
         /**
          * @brief Gets the URL parameters.
          *
-         * @return A const reference to the map of URL parameters.
+         * @return A const reference to the URL parameters, views valid as long as the context.
          */
         CLUEAPI_INLINE const auto& params() const noexcept {
             return m_params;
@@ -144,9 +186,12 @@ namespace clueapi::http {
          * @brief Gets the underlying HTTP request object.
          *
          * @return A reference to the request object.
+         *
+         * @note The handler may move from the request, e.g. to keep its body, the connection no
+         * longer reads it once the handler is called.
          */
         CLUEAPI_INLINE auto& request() noexcept {
-            return m_request;
+            return *m_request;
         }
 
         /**
@@ -155,7 +200,29 @@ namespace clueapi::http {
          * @return A const reference to the request object.
          */
         CLUEAPI_INLINE const auto& request() const noexcept {
-            return m_request;
+            return *m_request;
+        }
+
+        /**
+         * @brief Gets the stream of the request body, for routes registered as streamed.
+         *
+         * @return The body stream, `nullptr` if the body was buffered into `request().body()`.
+         */
+        CLUEAPI_INLINE types::body_stream_t* body_stream() const noexcept {
+            return m_request->body_stream().get();
+        }
+
+        /**
+         * @brief Gets the trace of the request, while tracing is enabled.
+         *
+         * @return The trace, `nullptr` while tracing is disabled. Valid until the response is
+         * sent.
+         *
+         * @details `trace()->context().traceparent()` is the `traceparent` to send on the calls
+         * the handler makes, so they join the trace of the request.
+         */
+        CLUEAPI_INLINE shared::trace_t* trace() const noexcept {
+            return m_request->trace();
         }
 
        private:
@@ -167,12 +234,12 @@ namespace clueapi::http {
          * @return An awaitable that resolves to void.
          */
         CLUEAPI_NOINLINE shared::awaitable_t<void> parse(multipart::parser_t::cfg_t cfg) {
-            const auto content_type_it = m_request.headers().find("content-type");
+            const auto content_type_header = m_request->header(types::e_header::content_type);
 
-            if (content_type_it == m_request.headers().end())
+            if (!content_type_header.has_value())
                 co_return;
 
-            const auto content_type = content_type_it->second;
+            const auto content_type = content_type_header.value();
 
             const auto boundary = shared::non_copy::extract_str(content_type, "boundary");
 
@@ -181,10 +248,14 @@ namespace clueapi::http {
 
             cfg.m_boundary = boundary;
 
-            if (!m_request.parse_path().empty()) {
-                co_await parse_file_multipart(cfg, m_request.parse_path());
+            const shared::trace_t::scope_t scope{trace(), shared::trace_phase_t::parse};
+
+            if (auto* stream = body_stream()) {
+                co_await parse_stream_multipart(cfg, *stream, content_type);
+            } else if (!m_request->parse_path().empty()) {
+                co_await parse_file_multipart(cfg, m_request->parse_path());
             } else
-                co_await parse_body_multipart(cfg, m_request.body(), content_type);
+                co_await parse_body_multipart(cfg, m_request->body(), content_type);
 
             co_return;
         }
@@ -227,6 +298,41 @@ namespace clueapi::http {
             co_return;
         }
 
+        /**
+         * @brief Parses a multipart body while it is read from the connection.
+         *
+         * @param cfg The multipart parser configuration.
+         * @param stream The stream of the request body.
+         * @param content_type The content type of the body.
+         *
+         * @return An awaitable that resolves to void.
+         */
+        CLUEAPI_NOINLINE shared::awaitable_t<void> parse_stream_multipart(
+            multipart::parser_t::cfg_t cfg,
+            types::body_stream_t& stream,
+            std::string_view content_type) {
+            if (!boost::ifind_first(content_type, "multipart/form-data"))
+                co_return;
+
+            auto parser = multipart::parser_t{cfg};
+
+            auto result = co_await parser.parse_stream(stream);
+
+            if (!result.has_value()) {
+                CLUEAPI_LOG_WARNING(exceptions::exception_t::make(
+                    "Failed to parse multipart body: {}", result.error()));
+
+                co_return;
+            }
+
+            auto&& parsed_parts = std::move(result.value());
+
+            m_fields = std::move(parsed_parts.m_fields);
+            m_files = std::move(parsed_parts.m_files);
+
+            co_return;
+        }
+
         /**
          * @brief Parses a body part using the multipart parser.
          *
@@ -277,9 +383,9 @@ namespace clueapi::http {
         types::fields_t m_fields;
 
         /**
-         * @brief The raw HTTP request.
+         * @brief The raw HTTP request, shared with the connection that received it.
          */
-        types::request_t m_request;
+        std::shared_ptr<types::request_t> m_request;
     };
 } // namespace clueapi::http
 
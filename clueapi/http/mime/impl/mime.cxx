@@ -6,8 +6,8 @@
 
 #include "clueapi/http/mime/mime.hxx"
 
-#include <boost/algorithm/string/case_conv.hpp>
-#include <boost/algorithm/string/predicate.hpp>
+#include <algorithm>
+#include <array>
 
 #include <boost/filesystem/path.hpp>
 
@@ -35,17 +35,36 @@ namespace clueapi::http::mime {
         if (path.empty())
             return detail::k_def_mime_type;
 
-        const auto ext = path.extension();
+        // A reference to the path's own string on POSIX, nothing is allocated
+        const auto& str = path.string();
 
-        if (ext.empty())
+        auto name = std::string_view{str};
+
+        if (const auto slash = name.find_last_of("/\\"); slash != std::string_view::npos)
+            name.remove_prefix(slash + 1u);
+
+        const auto dot = name.find_last_of('.');
+
+        if (dot == std::string_view::npos || name == "." || name == "..")
             return detail::k_def_mime_type;
 
-        const auto lower_ext = boost::algorithm::to_lower_copy(ext.string());
+        return from_extension(name.substr(dot));
+    }
+
+    types::mime_type_t mime_t::from_extension(std::string_view ext) noexcept {
+        std::array<char, k_max_extension_size> lower{};
+
+        if (ext.empty() || ext.size() > lower.size())
+            return detail::k_def_mime_type;
+
+        std::transform(ext.begin(), ext.end(), lower.begin(), [](char c) {
+            return static_cast<char>(c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c);
+        });
+
+        const auto& map = mime_map();
 
-        for (const auto& [e, m] : detail::k_mime_entries)
-            if (boost::algorithm::iequals(lower_ext, e))
-                return m;
+        const auto it = map.find(std::string_view{lower.data(), ext.size()});
 
-        return detail::k_def_mime_type;
+        return it == map.end() ? detail::k_def_mime_type : it->second;
     }
-} // namespace clueapi::http::mime
\ No newline at end of file
+} // namespace clueapi::http::mime
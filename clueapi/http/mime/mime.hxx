@@ -7,6 +7,9 @@
 #ifndef CLUEAPI_HTTP_MIME_HXX
 #define CLUEAPI_HTTP_MIME_HXX
 
+#include <cstddef>
+#include <string_view>
+
 #include <boost/filesystem/path.hpp>
 
 #include "clueapi/http/types/mime/mime.hxx"
@@ -44,6 +47,22 @@ namespace clueapi::http::mime {
          * found or the path is invalid, it returns the default "application/octet-stream".
          */
         static types::mime_type_t mime_type(const boost::filesystem::path& path) noexcept;
+
+        /**
+         * @brief Determines the MIME type for a file extension.
+         *
+         * @param ext The extension with its leading dot, in any case (e.g., ".HTML").
+         *
+         * @return The corresponding MIME type, "application/octet-stream" if it is unknown.
+         *
+         * @details A single lookup in `mime_map()`, the extension is lowercased on the stack.
+         */
+        static types::mime_type_t from_extension(std::string_view ext) noexcept;
+
+        /**
+         * @brief The longest extension that is looked up, with its dot.
+         */
+        static constexpr std::size_t k_max_extension_size{16};
     };
 } // namespace clueapi::http::mime
 
@@ -0,0 +1,95 @@
+/**
+ * @file body_stream_parser.hxx
+ *
+ * @brief A file for defining the multipart parser of a streamed request body.
+ */
+
+#ifndef CLUEAPI_HTTP_MULTIPART_DETAIL_BODY_STREAM_PARSER_HXX
+#define CLUEAPI_HTTP_MULTIPART_DETAIL_BODY_STREAM_PARSER_HXX
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+
+#include "clueapi/http/multipart/detail/stream_parser/stream_parser.hxx"
+#include "clueapi/http/types/body_stream/body_stream.hxx"
+
+#include "clueapi/exceptions/exceptions.hxx"
+
+/**
+ * @namespace clueapi::http::multipart::detail
+ *
+ * @brief Defines the details of the multipart body stream parser.
+ */
+namespace clueapi::http::multipart::detail {
+    /**
+     * @struct body_stream_parser_t
+     *
+     * @brief Parses a multipart message while it is read from the connection.
+     *
+     * @details The body is never spooled: every chunk read from the socket is parsed right away,
+     * and file parts that exceed the in-memory limits are written once, to their temporary file.
+     */
+    struct body_stream_parser_t : public stream_parser_t {
+        /**
+         * @brief Constructs a body stream parser.
+         *
+         * @param stream The stream of the request body.
+         * @param cfg The configuration for the multipart parser.
+         * @param dash_boundary The searcher of the dash boundary.
+         * @param crlf_dash_boundary The searcher of the CRLF dash boundary.
+         */
+        CLUEAPI_INLINE body_stream_parser_t(
+            types::body_stream_t& stream,
+            cfg_t cfg,
+            const boundary_searcher_t& dash_boundary,
+            const boundary_searcher_t& crlf_dash_boundary) noexcept
+            : stream_parser_t{cfg, dash_boundary, crlf_dash_boundary}, m_stream{stream} {
+        }
+
+       protected:
+        /**
+         * @brief Reads the next bytes of the body from the stream.
+         *
+         * @param data The buffer to read into.
+         * @param size The size of the buffer.
+         *
+         * @return The number of bytes read, `0` at the end of the body.
+         */
+        CLUEAPI_NOINLINE exceptions::expected_awaitable_t<std::size_t> read_some(
+            char* data, std::size_t size) override {
+            if (m_pending.empty()) {
+                auto chunk = co_await m_stream.read_chunk();
+
+                if (!chunk) {
+                    co_return exceptions::make_unexpected(
+                        exceptions::io_error_t::make("Failed to read body: {}", chunk.error()));
+                }
+
+                m_pending = chunk.value();
+            }
+
+            const auto to_copy = std::min(size, m_pending.size());
+
+            std::memcpy(data, m_pending.data(), to_copy);
+
+            m_pending.remove_prefix(to_copy);
+
+            co_return exceptions::expected_t<std::size_t>{to_copy};
+        }
+
+       private:
+        /**
+         * @brief The stream of the request body.
+         */
+        types::body_stream_t& m_stream;
+
+        /**
+         * @brief The part of the last chunk that has not been handed to the parser yet.
+         */
+        std::string_view m_pending;
+    };
+} // namespace clueapi::http::multipart::detail
+
+#endif // CLUEAPI_HTTP_MULTIPART_DETAIL_BODY_STREAM_PARSER_HXX
@@ -0,0 +1,293 @@
+/**
+ * @file boundary_searcher.hxx
+ *
+ * @brief A file for defining the boundary searcher of the multipart parsers.
+ */
+
+#ifndef CLUEAPI_HTTP_MULTIPART_DETAIL_BOUNDARY_SEARCHER_HXX
+#define CLUEAPI_HTTP_MULTIPART_DETAIL_BOUNDARY_SEARCHER_HXX
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#include "clueapi/shared/macros.hxx"
+
+namespace clueapi::http::multipart::detail {
+    namespace impl {
+        /**
+         * @brief Checks the candidates of a block whose first and last bytes matched.
+         *
+         * @return The position of the first full match, `npos` if none.
+         */
+        [[nodiscard]] CLUEAPI_INLINE std::size_t check_candidates(
+            std::uint64_t mask,
+            std::size_t block,
+            const char* haystack,
+            std::string_view needle,
+            std::uint32_t bits_per_lane = 1) noexcept {
+            while (mask) {
+                const auto lane = static_cast<std::size_t>(std::countr_zero(mask)) / bits_per_lane;
+
+                const auto pos = block + lane;
+
+                // The first and the last bytes already matched
+                if (std::memcmp(haystack + pos + 1, needle.data() + 1, needle.size() - 2) == 0)
+                    return pos;
+
+                // Clears every bit of the lane
+                mask &= ~(((std::uint64_t{1} << bits_per_lane) - 1) << (lane * bits_per_lane));
+            }
+
+            return std::string_view::npos;
+        }
+    } // namespace impl
+
+    /**
+     * @struct boundary_searcher_t
+     *
+     * @brief Finds a multipart boundary in a body, with tables precomputed once per request.
+     *
+     * @details Candidates are filtered by comparing the first and the last byte of the boundary
+     * against a whole vector of positions at once (SSE2/AVX2 on x86-64, NEON on AArch64), and only
+     * the positions where both match are compared in full. Boundaries are long random strings, so
+     * almost no position survives the filter. The remainder, and targets without SIMD, use a
+     * Horspool search whose bad-character table is built in the constructor.
+     *
+     * A search can resume from an offset: after a failed search, `resume_from()` tells a parser
+     * that appends more data where a boundary split across the two reads could start.
+     */
+    struct boundary_searcher_t {
+        /**
+         * @brief Constructs a searcher.
+         *
+         * @param needle The boundary to search for.
+         */
+        CLUEAPI_INLINE explicit boundary_searcher_t(std::string_view needle) : m_needle{needle} {
+            const auto size = m_needle.size();
+
+            m_skip.fill(static_cast<std::uint8_t>(std::min<std::size_t>(size, 255u)));
+
+            if (size == 0)
+                return;
+
+            for (std::size_t i{}; i + 1 < size; i++) {
+                const auto shift = std::min<std::size_t>(size - 1 - i, 255u);
+
+                m_skip[static_cast<unsigned char>(m_needle[i])] = static_cast<std::uint8_t>(shift);
+            }
+        }
+
+        // Copy constructor
+        CLUEAPI_INLINE boundary_searcher_t(const boundary_searcher_t&) = default;
+
+        // Copy assignment operator
+        CLUEAPI_INLINE boundary_searcher_t& operator=(const boundary_searcher_t&) = default;
+
+        // Move constructor
+        CLUEAPI_INLINE boundary_searcher_t(boundary_searcher_t&&) noexcept = default;
+
+        // Move assignment operator
+        CLUEAPI_INLINE boundary_searcher_t& operator=(boundary_searcher_t&&) noexcept = default;
+
+       public:
+        /**
+         * @brief Finds the first occurrence of the boundary.
+         *
+         * @param haystack The data to search.
+         * @param from The position to start searching from.
+         *
+         * @return The position of the boundary, `std::string_view::npos` if not found.
+         */
+        [[nodiscard]] CLUEAPI_INLINE std::size_t find(
+            std::string_view haystack, std::size_t from = 0) const noexcept {
+            const auto n = m_needle.size();
+
+            if (n == 0)
+                return from <= haystack.size() ? from : std::string_view::npos;
+
+            if (from >= haystack.size() || haystack.size() - from < n)
+                return std::string_view::npos;
+
+            if (n == 1) {
+                const auto* ptr = static_cast<const char*>(
+                    std::memchr(haystack.data() + from, m_needle[0], haystack.size() - from));
+
+                if (!ptr)
+                    return std::string_view::npos;
+
+                return static_cast<std::size_t>(ptr - haystack.data());
+            }
+
+            [[maybe_unused]] const auto* data = haystack.data();
+
+            [[maybe_unused]] const auto last = haystack.size() - n;
+
+            auto pos = from;
+
+#if defined(__AVX2__)
+            {
+                const auto first_byte = _mm256_set1_epi8(m_needle.front());
+                const auto last_byte = _mm256_set1_epi8(m_needle.back());
+
+                for (; pos + 32 <= last + 1; pos += 32) {
+                    const auto block_first =
+                        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+                    const auto block_last =
+                        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos + n - 1));
+
+                    const auto eq = _mm256_and_si256(
+                        _mm256_cmpeq_epi8(first_byte, block_first),
+                        _mm256_cmpeq_epi8(last_byte, block_last));
+
+                    const auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(eq));
+
+                    if (mask == 0)
+                        continue;
+
+                    if (const auto found = impl::check_candidates(mask, pos, data, m_needle);
+                        found != std::string_view::npos)
+                        return found;
+                }
+            }
+#elif defined(__SSE2__)
+            {
+                const auto first_byte = _mm_set1_epi8(m_needle.front());
+                const auto last_byte = _mm_set1_epi8(m_needle.back());
+
+                for (; pos + 16 <= last + 1; pos += 16) {
+                    const auto block_first =
+                        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+                    const auto block_last =
+                        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos + n - 1));
+
+                    const auto eq = _mm_and_si128(
+                        _mm_cmpeq_epi8(first_byte, block_first),
+                        _mm_cmpeq_epi8(last_byte, block_last));
+
+                    const auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(eq));
+
+                    if (mask == 0)
+                        continue;
+
+                    if (const auto found = impl::check_candidates(mask, pos, data, m_needle);
+                        found != std::string_view::npos)
+                        return found;
+                }
+            }
+#elif defined(__ARM_NEON)
+            {
+                const auto first_byte = vdupq_n_u8(static_cast<std::uint8_t>(m_needle.front()));
+                const auto last_byte = vdupq_n_u8(static_cast<std::uint8_t>(m_needle.back()));
+
+                for (; pos + 16 <= last + 1; pos += 16) {
+                    const auto block_first =
+                        vld1q_u8(reinterpret_cast<const std::uint8_t*>(data + pos));
+                    const auto block_last =
+                        vld1q_u8(reinterpret_cast<const std::uint8_t*>(data + pos + n - 1));
+
+                    const auto eq = vandq_u8(
+                        vceqq_u8(first_byte, block_first), vceqq_u8(last_byte, block_last));
+
+                    // Narrows every lane to 4 bits of a 64-bit mask
+                    const auto mask = vget_lane_u64(
+                        vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+
+                    if (mask == 0)
+                        continue;
+
+                    if (const auto found = impl::check_candidates(mask, pos, data, m_needle, 4);
+                        found != std::string_view::npos)
+                        return found;
+                }
+            }
+#endif
+
+            return find_horspool(haystack, pos);
+        }
+
+        /**
+         * @brief Gets the position from which a search must resume once data is appended.
+         *
+         * @param haystack_size The size of the data a search failed on.
+         *
+         * @return The first position at which a partial boundary could start.
+         */
+        [[nodiscard]] CLUEAPI_INLINE std::size_t resume_from(
+            std::size_t haystack_size) const noexcept {
+            return haystack_size >= m_needle.size() ? haystack_size - m_needle.size() + 1 : 0;
+        }
+
+        /**
+         * @brief Gets the boundary.
+         *
+         * @return A view of the boundary, valid as long as the searcher is.
+         */
+        [[nodiscard]] CLUEAPI_INLINE std::string_view needle() const noexcept {
+            return m_needle;
+        }
+
+        /**
+         * @brief Gets the length of the boundary.
+         *
+         * @return The length of the boundary.
+         */
+        [[nodiscard]] CLUEAPI_INLINE std::size_t length() const noexcept {
+            return m_needle.size();
+        }
+
+       private:
+        /**
+         * @brief Searches with the Horspool algorithm.
+         */
+        [[nodiscard]] CLUEAPI_INLINE std::size_t find_horspool(
+            std::string_view haystack, std::size_t from) const noexcept {
+            const auto n = m_needle.size();
+
+            if (haystack.size() < n || from > haystack.size() - n)
+                return std::string_view::npos;
+
+            const auto* data = haystack.data();
+
+            const auto last_byte = m_needle.back();
+
+            const auto last = haystack.size() - n;
+
+            for (auto pos = from; pos <= last;) {
+                const auto tail = data[pos + n - 1];
+
+                if (tail == last_byte && data[pos] == m_needle.front() &&
+                    std::memcmp(data + pos + 1, m_needle.data() + 1, n - 2) == 0)
+                    return pos;
+
+                pos += m_skip[static_cast<unsigned char>(tail)];
+            }
+
+            return std::string_view::npos;
+        }
+
+       private:
+        /**
+         * @brief The boundary.
+         */
+        std::string m_needle;
+
+        /**
+         * @brief The Horspool shift of every byte, capped at 255.
+         */
+        std::array<std::uint8_t, 256> m_skip{};
+    };
+} // namespace clueapi::http::multipart::detail
+
+#endif // CLUEAPI_HTTP_MULTIPART_DETAIL_BOUNDARY_SEARCHER_HXX
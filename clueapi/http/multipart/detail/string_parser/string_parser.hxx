@@ -16,6 +16,7 @@
 #include <boost/filesystem/path.hpp>
 
 #include "clueapi/http/multipart/detail/base_parser/base_parser.hxx"
+#include "clueapi/http/multipart/detail/boundary_searcher/boundary_searcher.hxx"
 #include "clueapi/http/multipart/detail/headers_parser/headers_parser.hxx"
 #include "clueapi/http/multipart/detail/types/types.hxx"
 
@@ -38,14 +39,14 @@ namespace clueapi::http::multipart::detail {
          *
          * @param str The string to parse.
          * @param cfg The configuration for the multipart parser.
-         * @param dash_boundary A string_view containing the dash boundary string.
-         * @param crlf_dash_boundary A string_view containing the CRLF dash boundary string.
+         * @param dash_boundary The searcher of the dash boundary.
+         * @param crlf_dash_boundary The searcher of the CRLF dash boundary.
          */
         CLUEAPI_INLINE string_parser_t(
             std::string_view str,
             cfg_t cfg,
-            std::string_view dash_boundary,
-            std::string_view crlf_dash_boundary) noexcept
+            const boundary_searcher_t& dash_boundary,
+            const boundary_searcher_t& crlf_dash_boundary) noexcept
             : m_cfg(cfg),
               m_str(str),
               m_dash_boundary(dash_boundary),
@@ -63,7 +64,7 @@ namespace clueapi::http::multipart::detail {
          * `parts_t` object containing the parsed parts.
          */
         CLUEAPI_NOINLINE exceptions::expected_awaitable_t<parts_t> parse() override {
-            if (!m_str.starts_with(m_dash_boundary)) {
+            if (!m_str.starts_with(m_dash_boundary.needle())) {
                 co_return exceptions::make_unexpected(
                     exceptions::runtime_error_t::make("Body does not start with boundary"));
             }
@@ -105,7 +106,7 @@ namespace clueapi::http::multipart::detail {
 
                 m_str.remove_prefix(headers_end_pos + 4);
 
-                auto content_end_pos = m_str.find(m_crlf_dash_boundary);
+                auto content_end_pos = m_crlf_dash_boundary.find(m_str);
 
                 if (content_end_pos == std::string_view::npos) {
                     co_return exceptions::make_unexpected(
@@ -204,14 +205,14 @@ namespace clueapi::http::multipart::detail {
         std::size_t m_total_in_memory_size{0};
 
         /**
-         * @brief The dash boundary string.
+         * @brief The searcher of the dash boundary.
          */
-        std::string_view m_dash_boundary;
+        const boundary_searcher_t& m_dash_boundary;
 
         /**
-         * @brief The CRLF dash boundary string.
+         * @brief The searcher of the CRLF dash boundary.
          */
-        std::string_view m_crlf_dash_boundary;
+        const boundary_searcher_t& m_crlf_dash_boundary;
     };
 } // namespace clueapi::http::multipart::detail
 
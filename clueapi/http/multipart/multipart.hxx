@@ -19,6 +19,7 @@
 
 #include "clueapi/shared/macros.hxx"
 
+#include "detail/body_stream_parser/body_stream_parser.hxx"
 #include "detail/file_parser/file_parser.hxx"
 #include "detail/string_parser/string_parser.hxx"
 
@@ -50,10 +51,10 @@ namespace clueapi::http::multipart {
          *
          * @param cfg The configuration struct.
          */
-        CLUEAPI_INLINE parser_t(cfg_t cfg) noexcept : m_cfg(cfg) {
-            m_dash_boundary = fmt::format(FMT_COMPILE("--{}"), m_cfg.m_boundary);
-
-            m_crlf_dash_boundary = fmt::format(FMT_COMPILE("\r\n{}"), m_dash_boundary);
+        CLUEAPI_INLINE parser_t(cfg_t cfg) noexcept
+            : m_cfg(cfg),
+              m_dash_boundary{fmt::format(FMT_COMPILE("--{}"), m_cfg.m_boundary)},
+              m_crlf_dash_boundary{fmt::format(FMT_COMPILE("\r\n--{}"), m_cfg.m_boundary)} {
         }
 
        public:
@@ -88,6 +89,21 @@ namespace clueapi::http::multipart {
             co_return exceptions::expected_t<parts_t>{std::move(result)};
         }
 
+        /**
+         * @brief Asynchronously parses a multipart body while it is read from the connection.
+         *
+         * @param stream The stream of the request body.
+         */
+        CLUEAPI_NOINLINE exceptions::expected_awaitable_t<parts_t> parse_stream(
+            types::body_stream_t& stream) {
+            auto parser =
+                detail::body_stream_parser_t{stream, m_cfg, m_dash_boundary, m_crlf_dash_boundary};
+
+            auto result = co_await parser.parse();
+
+            co_return exceptions::expected_t<parts_t>{std::move(result)};
+        }
+
        private:
         /**
          * @brief The configuration for the multipart parser.
@@ -95,14 +111,14 @@ namespace clueapi::http::multipart {
         cfg_t m_cfg;
 
         /**
-         * @brief The dash boundary string.
+         * @brief The searcher of the dash boundary, built once per request.
          */
-        std::string m_dash_boundary;
+        detail::boundary_searcher_t m_dash_boundary;
 
         /**
-         * @brief The CRLF dash boundary string.
+         * @brief The searcher of the CRLF dash boundary, built once per request.
          */
-        std::string m_crlf_dash_boundary;
+        detail::boundary_searcher_t m_crlf_dash_boundary;
     };
 } // namespace clueapi::http::multipart
 
@@ -0,0 +1,240 @@
+/**
+ * @file range.cxx
+ *
+ * @brief Implements the parsing of byte ranges and entity tag preconditions.
+ */
+
+#include "clueapi/http/range/range.hxx"
+
+#include "clueapi/http/types/request/request.hxx"
+
+#include <algorithm>
+#include <charconv>
+#include <limits>
+#include <system_error>
+
+namespace clueapi::http::range {
+    namespace {
+        /**
+         * @brief Removes the optional whitespace around a value.
+         */
+        std::string_view trim(std::string_view value) noexcept {
+            while (!value.empty() && (value.front() == ' ' || value.front() == '\t'))
+                value.remove_prefix(1);
+
+            while (!value.empty() && (value.back() == ' ' || value.back() == '\t'))
+                value.remove_suffix(1);
+
+            return value;
+        }
+
+        /**
+         * @brief Parses a non-empty decimal position.
+         *
+         * @return `false` if the value isn't a decimal number that fits.
+         */
+        bool parse_position(std::string_view value, std::uint64_t& ret) noexcept {
+            if (value.empty())
+                return false;
+
+            const auto* end = value.data() + value.size();
+
+            const auto [ptr, ec] = std::from_chars(value.data(), end, ret);
+
+            return ec == std::errc{} && ptr == end;
+        }
+
+        /**
+         * @brief Removes the weakness indicator of an entity tag.
+         */
+        std::string_view opaque_tag(std::string_view etag) noexcept {
+            if (etag.starts_with("W/"))
+                etag.remove_prefix(2);
+
+            return etag;
+        }
+    } // namespace
+
+    std::pair<e_range_status, byte_range_t> range_t::parse(
+        std::string_view header, std::uint64_t size) noexcept {
+        constexpr std::pair<e_range_status, byte_range_t> k_none{e_range_status::none, {}};
+
+        header = trim(header);
+
+        if (!header.starts_with("bytes="))
+            return k_none;
+
+        header = trim(header.substr(6));
+
+        // Serving several parts would need a multipart/byteranges body
+        if (header.find(',') != std::string_view::npos)
+            return k_none;
+
+        const auto dash = header.find('-');
+
+        if (dash == std::string_view::npos)
+            return k_none;
+
+        const auto first_str = trim(header.substr(0, dash));
+        const auto last_str = trim(header.substr(dash + 1));
+
+        byte_range_t ret{};
+
+        if (first_str.empty()) {
+            std::uint64_t suffix{};
+
+            if (!parse_position(last_str, suffix))
+                return k_none;
+
+            if (suffix == 0 || size == 0)
+                return {e_range_status::unsatisfiable, {}};
+
+            ret.m_first = suffix >= size ? 0 : size - suffix;
+            ret.m_last = size - 1;
+
+            return {e_range_status::satisfiable, ret};
+        }
+
+        if (!parse_position(first_str, ret.m_first))
+            return k_none;
+
+        ret.m_last = std::numeric_limits<std::uint64_t>::max();
+
+        if (!last_str.empty() && !parse_position(last_str, ret.m_last))
+            return k_none;
+
+        if (ret.m_last < ret.m_first)
+            return k_none;
+
+        if (ret.m_first >= size)
+            return {e_range_status::unsatisfiable, {}};
+
+        ret.m_last = std::min(ret.m_last, size - 1);
+
+        return {e_range_status::satisfiable, ret};
+    }
+
+    bool range_t::none_match(std::string_view header, std::string_view etag) noexcept {
+        header = trim(header);
+
+        if (header == "*")
+            return true;
+
+        if (etag.empty())
+            return false;
+
+        const auto opaque = opaque_tag(etag);
+
+        while (!header.empty()) {
+            const auto comma = header.find(',');
+
+            const auto tag = trim(header.substr(0, comma));
+
+            if (!tag.empty() && opaque_tag(tag) == opaque)
+                return true;
+
+            if (comma == std::string_view::npos)
+                break;
+
+            header.remove_prefix(comma + 1);
+        }
+
+        return false;
+    }
+
+    bool range_t::if_range(std::string_view header, std::string_view etag) noexcept {
+        header = trim(header);
+
+        if (etag.empty() || etag.starts_with("W/") || !header.starts_with('"'))
+            return false;
+
+        return header == etag;
+    }
+
+    void preconditions_t::assign(const types::request_t& request) {
+        const auto assign_header = [&request](std::optional<std::string>& to, auto header) {
+            const auto value = request.header(header);
+
+            if (!value) {
+                to.reset();
+
+                return;
+            }
+
+            if (to)
+                to->assign(*value);
+            else
+                to.emplace(*value);
+        };
+
+        m_method = request.method();
+
+        assign_header(m_if_none_match, types::e_header::if_none_match);
+        assign_header(m_range, types::e_header::range);
+        assign_header(m_if_range, types::e_header::if_range);
+    }
+
+    selection_t range_t::select(
+        const types::request_t& request, std::string_view etag, std::uint64_t size) noexcept {
+        selection_t ret{.m_range = {0, size > 0 ? size - 1 : 0}, .m_length = size};
+
+        preconditions_t preconditions{};
+
+        try {
+            preconditions.assign(request);
+        } catch (...) {
+            return ret;
+        }
+
+        return select(preconditions, etag, size);
+    }
+
+    selection_t range_t::select(
+        const preconditions_t& preconditions,
+
+        std::string_view etag,
+
+        std::uint64_t size) noexcept {
+        selection_t ret{.m_range = {0, size > 0 ? size - 1 : 0}, .m_length = size};
+
+        const auto method = preconditions.m_method;
+
+        const auto is_safe =
+            method == types::method_t::get || method == types::method_t::head;
+
+        const auto& if_none_match = preconditions.m_if_none_match;
+
+        if (is_safe && if_none_match && none_match(*if_none_match, etag)) {
+            ret.m_status = 304u;
+
+            ret.m_length = 0;
+
+            return ret;
+        }
+
+        const auto& range_header = preconditions.m_range;
+
+        if (method != types::method_t::get || !range_header)
+            return ret;
+
+        if (const auto& if_range_header = preconditions.m_if_range;
+            if_range_header && !if_range(*if_range_header, etag))
+            return ret;
+
+        const auto [status, parsed] = parse(*range_header, size);
+
+        if (status == e_range_status::satisfiable) {
+            ret.m_status = 206u;
+
+            ret.m_range = parsed;
+
+            ret.m_length = parsed.length();
+        } else if (status == e_range_status::unsatisfiable) {
+            ret.m_status = 416u;
+
+            ret.m_length = 0;
+        }
+
+        return ret;
+    }
+} // namespace clueapi::http::range
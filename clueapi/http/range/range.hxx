@@ -0,0 +1,214 @@
+/**
+ * @file range.hxx
+ *
+ * @brief Provides the parsing of byte ranges and entity tag preconditions of requests.
+ */
+
+#ifndef CLUEAPI_HTTP_RANGE_HXX
+#define CLUEAPI_HTTP_RANGE_HXX
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "clueapi/http/types/method/method.hxx"
+
+#include "clueapi/shared/macros.hxx"
+
+// Forward declarations
+namespace clueapi::http::types {
+    struct request_t;
+} // namespace clueapi::http::types
+
+/**
+ * @namespace clueapi::http::range
+ *
+ * @brief The main namespace for the clueapi HTTP range requests.
+ */
+namespace clueapi::http::range {
+    /**
+     * @enum e_range_status
+     *
+     * @brief The outcome of parsing a `Range` header against a representation.
+     */
+    enum struct e_range_status : std::uint8_t {
+        /**
+         * @brief No usable range, the whole representation is sent (`200 OK`).
+         */
+        none,
+
+        /**
+         * @brief A single satisfiable range (`206 Partial Content`).
+         */
+        satisfiable,
+
+        /**
+         * @brief A valid range outside the representation (`416 Range Not Satisfiable`).
+         */
+        unsatisfiable
+    };
+
+    /**
+     * @struct byte_range_t
+     *
+     * @brief An inclusive range of bytes.
+     */
+    struct byte_range_t {
+        /**
+         * @brief Gets the number of bytes of the range.
+         *
+         * @return The number of bytes.
+         */
+        [[nodiscard]] CLUEAPI_INLINE constexpr std::uint64_t length() const noexcept {
+            return m_last - m_first + 1;
+        }
+
+       public:
+        /**
+         * @brief The position of the first byte.
+         */
+        std::uint64_t m_first{};
+
+        /**
+         * @brief The position of the last byte.
+         */
+        std::uint64_t m_last{};
+    };
+
+    /**
+     * @struct selection_t
+     *
+     * @brief What is sent of a file, once the preconditions and the range of a request applied.
+     */
+    struct selection_t {
+        /**
+         * @brief The status of the response: 200, 206, 304 or 416.
+         */
+        std::uint32_t m_status{200u};
+
+        /**
+         * @brief The range of the file that is sent.
+         */
+        byte_range_t m_range{};
+
+        /**
+         * @brief The number of bytes of the body.
+         */
+        std::uint64_t m_length{};
+    };
+
+    /**
+     * @struct preconditions_t
+     *
+     * @brief The parts of a request a file response depends on, owned apart from the request.
+     *
+     * @details Taken before the handler runs, which may move from its request. The strings keep
+     * their capacity when the preconditions are taken again for the next request.
+     */
+    struct preconditions_t {
+        /**
+         * @brief Takes the preconditions of a request.
+         *
+         * @param request The request.
+         */
+        void assign(const types::request_t& request);
+
+       public:
+        /**
+         * @brief The method of the request.
+         */
+        types::method_t::e_method m_method{types::method_t::unknown};
+
+        /**
+         * @brief The `If-None-Match` header, if any.
+         */
+        std::optional<std::string> m_if_none_match;
+
+        /**
+         * @brief The `Range` header, if any.
+         */
+        std::optional<std::string> m_range;
+
+        /**
+         * @brief The `If-Range` header, if any.
+         */
+        std::optional<std::string> m_if_range;
+    };
+
+    /**
+     * @struct range_t
+     *
+     * @brief A static utility class for range requests and entity tag preconditions.
+     */
+    struct range_t {
+        /**
+         * @brief Parses a `Range` header.
+         *
+         * @param header The value of the header.
+         * @param size The size of the representation.
+         *
+         * @return The outcome and, when satisfiable, the range clamped to the representation.
+         *
+         * @details Only a single `bytes` range is honored (`first-last`, `first-` or `-suffix`).
+         * Multiple ranges and malformed headers are ignored, as RFC 9110 allows.
+         */
+        [[nodiscard]] static std::pair<e_range_status, byte_range_t> parse(
+            std::string_view header, std::uint64_t size) noexcept;
+
+        /**
+         * @brief Checks an `If-None-Match` header against an entity tag, with weak comparison.
+         *
+         * @param header The value of the header, a list of entity tags or `*`.
+         * @param etag The entity tag of the representation.
+         *
+         * @return `true` if one of the tags matches, `false` otherwise.
+         */
+        [[nodiscard]] static bool none_match(
+            std::string_view header, std::string_view etag) noexcept;
+
+        /**
+         * @brief Checks an `If-Range` header against an entity tag, with strong comparison.
+         *
+         * @param header The value of the header.
+         * @param etag The entity tag of the representation.
+         *
+         * @return `true` if the range may be applied, `false` to send the whole representation.
+         *
+         * @note A date or a weak tag never matches.
+         */
+        [[nodiscard]] static bool if_range(
+            std::string_view header, std::string_view etag) noexcept;
+
+        /**
+         * @brief Applies `If-None-Match`, `Range` and `If-Range` to a file sent with `200 OK`.
+         *
+         * @param request The request.
+         * @param etag The entity tag of the file, empty if it has none.
+         * @param size The size of the file.
+         *
+         * @return The status of the response and the range of the file it carries.
+         */
+        [[nodiscard]] static selection_t select(
+            const types::request_t& request, std::string_view etag, std::uint64_t size) noexcept;
+
+        /**
+         * @brief Applies `If-None-Match`, `Range` and `If-Range` to a file sent with `200 OK`.
+         *
+         * @param preconditions The preconditions taken from the request.
+         * @param etag The entity tag of the file, empty if it has none.
+         * @param size The size of the file.
+         *
+         * @return The status of the response and the range of the file it carries.
+         */
+        [[nodiscard]] static selection_t select(
+            const preconditions_t& preconditions,
+
+            std::string_view etag,
+
+            std::uint64_t size) noexcept;
+    };
+} // namespace clueapi::http::range
+
+#endif // CLUEAPI_HTTP_RANGE_HXX
@@ -8,6 +8,7 @@
 #define CLUEAPI_HTTP_TYPES_BASIC_HXX
 
 #include "clueapi/http/detail/comparators/comparators.hxx"
+#include "clueapi/http/types/params/params.hxx"
 
 #include "clueapi/shared/json_traits/json_traits.hxx"
 
@@ -49,11 +50,6 @@ namespace clueapi::http::types {
      * @brief Type alias for a map of HTTP headers, with case-insensitive keys.
      */
     using headers_t = std::map<std::string, std::string, http::detail::ci_less_t>;
-
-    /**
-     * @brief Type alias for a map of URL parameters, with case-insensitive keys.
-     */
-    using params_t = std::map<std::string, std::string, http::detail::ci_less_t>;
 } // namespace clueapi::http::types
 
 #endif // CLUEAPI_HTTP_TYPES_BASIC_HXX
\ No newline at end of file
@@ -0,0 +1,59 @@
+/**
+ * @file body_stream.hxx
+ *
+ * @brief Defines the interface of a request body that is read while the handler runs.
+ */
+
+#ifndef CLUEAPI_HTTP_TYPES_BODY_STREAM_HXX
+#define CLUEAPI_HTTP_TYPES_BODY_STREAM_HXX
+
+#include <cstddef>
+#include <string_view>
+
+#include "clueapi/exceptions/wrap/wrap.hxx"
+
+#include "clueapi/shared/macros.hxx"
+
+namespace clueapi::http::types {
+    /**
+     * @struct body_stream_t
+     *
+     * @brief A request body that is pulled from the connection chunk by chunk.
+     *
+     * @details Given to the handlers of routes registered with `route::e_body_mode::streamed`
+     * instead of a buffered body. Nothing is read from the socket until the handler asks for the
+     * next chunk, so the memory held by a request is bounded by the chunk size rather than by the
+     * size of the body, and the handler can start working before the upload finishes.
+     *
+     * @note Any part of the body left unread by the handler is drained before the response
+     * is sent.
+     */
+    struct body_stream_t {
+        virtual ~body_stream_t() noexcept = default;
+
+       public:
+        /**
+         * @brief Reads the next chunk of the body.
+         *
+         * @return A view of the chunk, valid until the next call. Empty once the body is complete.
+         * An error if the body is malformed, too large, timed out, or the connection closed.
+         */
+        [[nodiscard]] virtual exceptions::expected_awaitable_t<std::string_view> read_chunk() = 0;
+
+        /**
+         * @brief Checks if the whole body has been read.
+         *
+         * @return `true` if the body is complete, `false` otherwise.
+         */
+        [[nodiscard]] virtual bool is_done() const noexcept = 0;
+
+        /**
+         * @brief Gets the number of bytes of the body read so far.
+         *
+         * @return The number of bytes read.
+         */
+        [[nodiscard]] virtual std::size_t bytes_read() const noexcept = 0;
+    };
+} // namespace clueapi::http::types
+
+#endif // CLUEAPI_HTTP_TYPES_BODY_STREAM_HXX
@@ -0,0 +1,291 @@
+/**
+ * @file flat_headers.hxx
+ *
+ * @brief Defines the flat, arena-backed storage of the headers of an incoming request.
+ */
+
+#ifndef CLUEAPI_HTTP_TYPES_FLAT_HEADERS_HXX
+#define CLUEAPI_HTTP_TYPES_FLAT_HEADERS_HXX
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <boost/algorithm/string/predicate.hpp>
+
+#include "clueapi/shared/macros.hxx"
+
+namespace clueapi::http::types {
+    /**
+     * @enum e_header
+     *
+     * @brief Well-known request headers that are indexed for O(1) lookups.
+     */
+    enum struct e_header : std::uint8_t {
+        content_type,
+        content_length,
+        cookie,
+        connection,
+        host,
+        transfer_encoding,
+        accept,
+        accept_encoding,
+        authorization,
+        user_agent,
+        upgrade,
+        range,
+        if_range,
+        if_none_match,
+        if_modified_since,
+        unknown
+    };
+
+    /**
+     * @brief The number of well-known request headers.
+     */
+    inline constexpr std::size_t k_known_headers{static_cast<std::size_t>(e_header::unknown)};
+
+    /**
+     * @brief The canonical names of the well-known request headers, indexed by `e_header`.
+     */
+    inline constexpr std::array<std::string_view, k_known_headers> k_known_header_names{
+        "Content-Type",
+        "Content-Length",
+        "Cookie",
+        "Connection",
+        "Host",
+        "Transfer-Encoding",
+        "Accept",
+        "Accept-Encoding",
+        "Authorization",
+        "User-Agent",
+        "Upgrade",
+        "Range",
+        "If-Range",
+        "If-None-Match",
+        "If-Modified-Since"};
+
+    /**
+     * @struct flat_headers_t
+     *
+     * @brief Stores the headers of a request in one arena with a flat field index.
+     *
+     * @details Names and values are appended to a single string and fields refer to them by
+     * offset, so both buffers keep their capacity across keep-alive requests and a request parses
+     * without allocating once they are warm. Fields are looked up by a linear scan, which is faster
+     * than a tree walk for typical header counts, and well-known fields are indexed directly.
+     *
+     * @note Duplicate fields are kept in order; lookups return the first one.
+     */
+    struct flat_headers_t {
+        /**
+         * @struct field_t
+         *
+         * @brief A single field, referring to the arena by offset.
+         */
+        struct field_t {
+            /**
+             * @brief The offset of the name in the arena.
+             */
+            std::uint32_t m_name_offset{};
+
+            /**
+             * @brief The size of the name.
+             */
+            std::uint32_t m_name_size{};
+
+            /**
+             * @brief The offset of the value in the arena.
+             */
+            std::uint32_t m_value_offset{};
+
+            /**
+             * @brief The size of the value.
+             */
+            std::uint32_t m_value_size{};
+        };
+
+       public:
+        /**
+         * @brief Finds the well-known header matching a name.
+         *
+         * @param name The name of the header (case-insensitive).
+         *
+         * @return The well-known header, `e_header::unknown` if the name is not one.
+         */
+        [[nodiscard]] static CLUEAPI_INLINE e_header known_from_name(
+            std::string_view name) noexcept {
+            for (std::size_t i{}; i < k_known_headers; i++) {
+                const auto known = k_known_header_names[i];
+
+                if (known.size() == name.size() && boost::algorithm::iequals(known, name))
+                    return static_cast<e_header>(i);
+            }
+
+            return e_header::unknown;
+        }
+
+       public:
+        /**
+         * @brief Appends a field.
+         *
+         * @param name The name of the field.
+         * @param value The value of the field.
+         * @param known The well-known header the field is, if the caller already knows it.
+         */
+        CLUEAPI_INLINE void add(
+            std::string_view name, std::string_view value, e_header known = e_header::unknown) {
+            field_t field{
+                .m_name_offset = static_cast<std::uint32_t>(m_arena.size()),
+                .m_name_size = static_cast<std::uint32_t>(name.size()),
+                .m_value_offset = static_cast<std::uint32_t>(m_arena.size() + name.size()),
+                .m_value_size = static_cast<std::uint32_t>(value.size())};
+
+            m_arena.append(name);
+
+            m_arena.append(value);
+
+            m_fields.emplace_back(field);
+
+            if (known == e_header::unknown)
+                known = known_from_name(name);
+
+            if (known == e_header::unknown)
+                return;
+
+            auto& slot = m_known[static_cast<std::size_t>(known)];
+
+            if (slot == 0)
+                slot = static_cast<std::uint16_t>(m_fields.size());
+        }
+
+        /**
+         * @brief Finds a well-known field in O(1).
+         *
+         * @param header The well-known header.
+         *
+         * @return The value of the field if present, otherwise `std::nullopt`.
+         */
+        [[nodiscard]] CLUEAPI_INLINE std::optional<std::string_view> find(
+            e_header header) const noexcept {
+            if (header == e_header::unknown)
+                return std::nullopt;
+
+            const auto slot = m_known[static_cast<std::size_t>(header)];
+
+            if (slot == 0)
+                return std::nullopt;
+
+            return value(slot - 1u);
+        }
+
+        /**
+         * @brief Finds a field by name.
+         *
+         * @param name The name of the field (case-insensitive).
+         *
+         * @return The value of the field if present, otherwise `std::nullopt`.
+         */
+        [[nodiscard]] CLUEAPI_INLINE std::optional<std::string_view> find(
+            std::string_view name) const noexcept {
+            for (std::size_t i{}; i < m_fields.size(); i++) {
+                if (m_fields[i].m_name_size != name.size())
+                    continue;
+
+                if (boost::algorithm::iequals(this->name(i), name))
+                    return value(i);
+            }
+
+            return std::nullopt;
+        }
+
+        /**
+         * @brief Invokes a function for every field, in order.
+         *
+         * @param fn The function, called with the name and the value of each field.
+         */
+        template <typename _fn_t>
+        CLUEAPI_INLINE void for_each(_fn_t&& fn) const {
+            for (std::size_t i{}; i < m_fields.size(); i++)
+                fn(name(i), value(i));
+        }
+
+        /**
+         * @brief Clears the fields, keeping the capacity of the buffers.
+         */
+        CLUEAPI_INLINE void clear() noexcept {
+            m_arena.clear();
+
+            m_fields.clear();
+
+            m_known.fill(0);
+        }
+
+       public:
+        /**
+         * @brief Gets the name of the field at the given index.
+         *
+         * @param idx The index of the field.
+         *
+         * @return A view of the name, valid until the headers are modified.
+         */
+        [[nodiscard]] CLUEAPI_INLINE std::string_view name(std::size_t idx) const noexcept {
+            const auto& field = m_fields[idx];
+
+            return {m_arena.data() + field.m_name_offset, field.m_name_size};
+        }
+
+        /**
+         * @brief Gets the value of the field at the given index.
+         *
+         * @param idx The index of the field.
+         *
+         * @return A view of the value, valid until the headers are modified.
+         */
+        [[nodiscard]] CLUEAPI_INLINE std::string_view value(std::size_t idx) const noexcept {
+            const auto& field = m_fields[idx];
+
+            return {m_arena.data() + field.m_value_offset, field.m_value_size};
+        }
+
+        /**
+         * @brief Gets the number of fields.
+         *
+         * @return The number of fields.
+         */
+        [[nodiscard]] CLUEAPI_INLINE std::size_t size() const noexcept {
+            return m_fields.size();
+        }
+
+        /**
+         * @brief Checks if there are no fields.
+         *
+         * @return `true` if there are no fields, `false` otherwise.
+         */
+        [[nodiscard]] CLUEAPI_INLINE bool empty() const noexcept {
+            return m_fields.empty();
+        }
+
+       private:
+        /**
+         * @brief The names and values of all fields, back to back.
+         */
+        std::string m_arena;
+
+        /**
+         * @brief The fields, in order.
+         */
+        std::vector<field_t> m_fields;
+
+        /**
+         * @brief The 1-based index of the first field of every well-known header, 0 if absent.
+         */
+        std::array<std::uint16_t, k_known_headers> m_known{};
+    };
+} // namespace clueapi::http::types
+
+#endif // CLUEAPI_HTTP_TYPES_FLAT_HEADERS_HXX
@@ -0,0 +1,104 @@
+/**
+ * @file json_stream.hxx
+ *
+ * @brief Defines a response that streams a large JSON array with chunked encoding.
+ */
+
+#ifndef CLUEAPI_HTTP_TYPES_JSON_STREAM_HXX
+#define CLUEAPI_HTTP_TYPES_JSON_STREAM_HXX
+
+#include <cstddef>
+#include <memory>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "clueapi/exceptions/wrap/wrap.hxx"
+
+#include "clueapi/http/chunks/chunks.hxx"
+#include "clueapi/http/types/response/response.hxx"
+
+#include "clueapi/shared/json_writer/json_writer.hxx"
+#include "clueapi/shared/macros.hxx"
+
+namespace clueapi::http::types {
+    /**
+     * @struct json_stream_response_t
+     *
+     * @brief A response that writes the items of a range as a JSON array, chunk by chunk.
+     *
+     * @details The items are serialized with `shared::json_writer_t` into a buffer that is sent
+     * every `flush_size` bytes, so neither the array nor a DOM of it is ever held in memory. The
+     * range is owned by the response, a lazy view (e.g., over a database cursor) works too.
+     */
+    struct json_stream_response_t : public base_response_t {
+        /**
+         * @brief The size of the buffer sent as a chunk by default.
+         */
+        static constexpr std::size_t k_def_flush_size{16ull * 1024u};
+
+        CLUEAPI_INLINE json_stream_response_t() noexcept = default;
+
+        /**
+         * @brief Constructs the response.
+         *
+         * @param items The items of the array.
+         * @param flush_size The number of bytes buffered before a chunk is sent.
+         * @param status The HTTP status code.
+         * @param headers The headers of the response.
+         */
+        template <std::ranges::input_range _range_t>
+        json_stream_response_t(
+            _range_t items,
+            std::size_t flush_size = k_def_flush_size,
+            status_t::e_status status = status_t::ok,
+            headers_t headers = {}) {
+            merge_headers(std::move(headers));
+
+            m_headers.try_emplace("Content-Type", "application/json");
+
+            m_status = status;
+
+            m_is_stream = true;
+
+            m_stream_fn =
+                [items = std::make_shared<_range_t>(std::move(items)), flush_size](
+                    chunks::chunk_writer_t& writer) -> exceptions::expected_awaitable_t<void> {
+                std::string buffer{};
+
+                buffer.reserve(flush_size + flush_size / 4u);
+
+                buffer.push_back('[');
+
+                bool first{true};
+
+                for (const auto& item : *items) {
+                    if (!first)
+                        buffer.push_back(',');
+
+                    first = false;
+
+                    shared::json_writer_t::write(buffer, item);
+
+                    if (buffer.size() < flush_size)
+                        continue;
+
+                    if (auto result = co_await writer.write_chunk(buffer); !result.has_value())
+                        co_return result;
+
+                    buffer.clear();
+
+                    if (writer.writer_closed())
+                        co_return exceptions::expected_t<void>{};
+                }
+
+                buffer.push_back(']');
+
+                co_return co_await writer.write_chunk(buffer);
+            };
+        }
+    };
+} // namespace clueapi::http::types
+
+#endif // CLUEAPI_HTTP_TYPES_JSON_STREAM_HXX
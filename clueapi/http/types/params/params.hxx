@@ -0,0 +1,217 @@
+/**
+ * @file params.hxx
+ *
+ * @brief Defines the path parameters of a request as views into its URI.
+ */
+
+#ifndef CLUEAPI_HTTP_TYPES_PARAMS_HXX
+#define CLUEAPI_HTTP_TYPES_PARAMS_HXX
+
+#include <array>
+#include <cstddef>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <boost/algorithm/string/predicate.hpp>
+
+#include "clueapi/exceptions/exceptions.hxx"
+
+#include "clueapi/http/detail/comparators/comparators.hxx"
+
+#include "clueapi/shared/macros.hxx"
+
+namespace clueapi::http::types {
+    /**
+     * @struct params_t
+     *
+     * @brief The parameters of the dynamic segments of a path.
+     *
+     * @details A fixed-capacity array of (name, value) views, filled by the router without
+     * allocating. Names point to the routing table, which lives as long as the application, and
+     * values point into the URI of the request, which the request context owns. Lookups by name
+     * are case-insensitive linear scans, faster than a tree walk for a handful of parameters.
+     *
+     * @note Use `to_owned()` to keep the parameters beyond the lifetime of the request.
+     */
+    struct params_t {
+        /**
+         * @brief The maximum number of parameters of a route.
+         */
+        static constexpr std::size_t k_capacity{8};
+
+        /**
+         * @brief Type alias for an owning copy of the parameters.
+         */
+        using owned_t = std::map<std::string, std::string, http::detail::ci_less_t>;
+
+        /**
+         * @struct param_t
+         *
+         * @brief A single parameter.
+         */
+        struct param_t {
+            /**
+             * @brief The name of the parameter.
+             */
+            std::string_view m_name;
+
+            /**
+             * @brief The value of the parameter.
+             */
+            std::string_view m_value;
+        };
+
+        /**
+         * @brief Type alias for an iterator over the parameters.
+         */
+        using const_iterator = const param_t*;
+
+       public:
+        /**
+         * @brief Appends a parameter.
+         *
+         * @param name The name of the parameter.
+         * @param value The value of the parameter.
+         *
+         * @return `false` if the capacity is exhausted, `true` otherwise.
+         */
+        CLUEAPI_INLINE bool emplace(std::string_view name, std::string_view value) noexcept {
+            if (m_size == k_capacity)
+                return false;
+
+            m_params[m_size++] = param_t{name, value};
+
+            return true;
+        }
+
+        /**
+         * @brief Finds the value of a parameter.
+         *
+         * @param name The name of the parameter (case-insensitive).
+         *
+         * @return The value of the parameter, `std::nullopt` if not found.
+         */
+        [[nodiscard]] CLUEAPI_INLINE std::optional<std::string_view> get(
+            std::string_view name) const noexcept {
+            for (const auto& param : *this) {
+                if (param.m_name.size() == name.size() &&
+                    boost::algorithm::iequals(param.m_name, name))
+                    return param.m_value;
+            }
+
+            return std::nullopt;
+        }
+
+        /**
+         * @brief Gets the value of a parameter.
+         *
+         * @param name The name of the parameter (case-insensitive).
+         *
+         * @return The value of the parameter.
+         *
+         * @throws exceptions::exception_t If the parameter is not found.
+         */
+        [[nodiscard]] CLUEAPI_INLINE std::string_view at(std::string_view name) const {
+            if (auto value = get(name); value.has_value())
+                return *value;
+
+            throw exceptions::exception_t("Path parameter '{}' not found", name);
+        }
+
+        /**
+         * @brief Gets the value of a parameter.
+         *
+         * @param name The name of the parameter (case-insensitive).
+         *
+         * @return The value of the parameter, empty if not found.
+         */
+        [[nodiscard]] CLUEAPI_INLINE std::string_view operator[](
+            std::string_view name) const noexcept {
+            return get(name).value_or(std::string_view{});
+        }
+
+        /**
+         * @brief Checks if a parameter exists.
+         *
+         * @param name The name of the parameter (case-insensitive).
+         *
+         * @return `true` if the parameter exists, `false` otherwise.
+         */
+        [[nodiscard]] CLUEAPI_INLINE bool contains(std::string_view name) const noexcept {
+            return get(name).has_value();
+        }
+
+        /**
+         * @brief Copies the parameters into an owning map.
+         *
+         * @return The owning map.
+         */
+        [[nodiscard]] CLUEAPI_INLINE owned_t to_owned() const {
+            owned_t ret{};
+
+            for (const auto& [name, value] : *this)
+                ret.emplace(name, value);
+
+            return ret;
+        }
+
+        /**
+         * @brief Removes all the parameters.
+         */
+        CLUEAPI_INLINE void clear() noexcept {
+            m_size = 0;
+        }
+
+       public:
+        /**
+         * @brief Gets the number of parameters.
+         *
+         * @return The number of parameters.
+         */
+        [[nodiscard]] CLUEAPI_INLINE std::size_t size() const noexcept {
+            return m_size;
+        }
+
+        /**
+         * @brief Checks if there are no parameters.
+         *
+         * @return `true` if there are no parameters, `false` otherwise.
+         */
+        [[nodiscard]] CLUEAPI_INLINE bool empty() const noexcept {
+            return m_size == 0;
+        }
+
+        /**
+         * @brief Gets an iterator to the first parameter.
+         *
+         * @return The iterator.
+         */
+        [[nodiscard]] CLUEAPI_INLINE const_iterator begin() const noexcept {
+            return m_params.data();
+        }
+
+        /**
+         * @brief Gets an iterator past the last parameter.
+         *
+         * @return The iterator.
+         */
+        [[nodiscard]] CLUEAPI_INLINE const_iterator end() const noexcept {
+            return m_params.data() + m_size;
+        }
+
+       private:
+        /**
+         * @brief The parameters, the first `m_size` of which are set.
+         */
+        std::array<param_t, k_capacity> m_params{};
+
+        /**
+         * @brief The number of parameters.
+         */
+        std::size_t m_size{};
+    };
+} // namespace clueapi::http::types
+
+#endif // CLUEAPI_HTTP_TYPES_PARAMS_HXX
@@ -15,12 +15,12 @@ namespace clueapi::http::types {
 
         m_cookies_parsed = true;
 
-        auto cookie_header = m_headers.find("cookie");
+        auto cookie_header = header(e_header::cookie);
 
-        if (cookie_header == m_headers.end())
+        if (!cookie_header.has_value())
             return;
 
-        std::string_view cookie_value = cookie_header->second;
+        std::string_view cookie_value = cookie_header.value();
 
         if (m_cookies.empty()) {
             m_cookies_buffer = std::string{cookie_value};
@@ -7,6 +7,7 @@
 #ifndef CLUEAPI_HTTP_TYPES_REQUEST_HXX
 #define CLUEAPI_HTTP_TYPES_REQUEST_HXX
 
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -15,10 +16,13 @@
 #include <boost/filesystem/path.hpp>
 
 #include "clueapi/http/types/basic/basic.hxx"
+#include "clueapi/http/types/body_stream/body_stream.hxx"
 #include "clueapi/http/types/cookie/cookie.hxx"
+#include "clueapi/http/types/flat_headers/flat_headers.hxx"
 #include "clueapi/http/types/method/method.hxx"
 
 #include "clueapi/shared/macros.hxx"
+#include "clueapi/shared/tracing/tracing.hxx"
 
 namespace clueapi::http::types {
     /**
@@ -29,8 +33,15 @@ namespace clueapi::http::types {
      * @details This class provides a high-level abstraction over a raw HTTP request. It offers
      * convenient access to properties like the method, URI, headers, body, and parsed cookies.
      * It also handles lazy parsing of cookies to optimize performance.
+     *
+     * Incoming headers are kept in a `flat_headers_t` and looked up in place. The owning
+     * `headers_t` map is only built when `headers()` is called, and is authoritative from then on.
+     *
+     * The server owns each request through a `std::shared_ptr`, so that the middleware chain and
+     * the handler's `ctx_t` can share it without copying the body. The server takes what it
+     * needs of the request before calling the handler, which may move from it.
      */
-    struct request_t {
+    struct request_t : std::enable_shared_from_this<request_t> {
         CLUEAPI_INLINE request_t() noexcept = default;
 
         CLUEAPI_INLINE ~request_t() noexcept = default;
@@ -40,8 +51,12 @@ namespace clueapi::http::types {
             : m_method(other.m_method),
               m_uri(other.m_uri),
               m_body(other.m_body),
+              m_flat_headers(other.m_flat_headers),
               m_headers(other.m_headers),
+              m_headers_owned(other.m_headers_owned),
               m_parse_path(other.m_parse_path),
+              m_body_stream(other.m_body_stream),
+              m_trace(other.m_trace),
               m_cookies_parsed(other.m_cookies_parsed) {
             if (other.m_cookies_parsed) {
                 try {
@@ -76,8 +91,12 @@ namespace clueapi::http::types {
                 m_method = other.m_method;
                 m_uri = other.m_uri;
                 m_body = other.m_body;
+                m_flat_headers = other.m_flat_headers;
                 m_headers = other.m_headers;
+                m_headers_owned = other.m_headers_owned;
                 m_parse_path = other.m_parse_path;
+                m_body_stream = other.m_body_stream;
+                m_trace = other.m_trace;
                 m_cookies_parsed = other.m_cookies_parsed;
 
                 m_cookies.clear();
@@ -149,6 +168,9 @@ namespace clueapi::http::types {
          */
         CLUEAPI_INLINE std::optional<std::string_view> header(
             const std::string_view& name) const noexcept {
+            if (!m_headers_owned)
+                return m_flat_headers.find(name);
+
             auto value = m_headers.find(name);
 
             if (value == m_headers.end())
@@ -157,13 +179,54 @@ namespace clueapi::http::types {
             return value->second;
         }
 
+        /**
+         * @brief Retrieves the value of a well-known header from the request in O(1).
+         *
+         * @param header The well-known header to retrieve.
+         *
+         * @return An `std::optional<std::string_view>` containing the header's value if found,
+         * otherwise`std::nullopt`.
+         */
+        CLUEAPI_INLINE std::optional<std::string_view> header(e_header header) const noexcept {
+            if (!m_headers_owned)
+                return m_flat_headers.find(header);
+
+            if (header == e_header::unknown)
+                return std::nullopt;
+
+            auto value = m_headers.find(k_known_header_names[static_cast<std::size_t>(header)]);
+
+            if (value == m_headers.end())
+                return std::nullopt;
+
+            return value->second;
+        }
+
+        /**
+         * @brief Appends a received header without building the owning headers map.
+         *
+         * @param name The name of the header.
+         * @param value The value of the header.
+         * @param known The well-known header, if the caller already knows it.
+         */
+        CLUEAPI_INLINE void add_header(
+            std::string_view name, std::string_view value, e_header known = e_header::unknown) {
+            if (m_headers_owned) {
+                m_headers.emplace(name, value);
+
+                return;
+            }
+
+            m_flat_headers.add(name, value, known);
+        }
+
         /**
          * @brief Checks if the client requested a persistent connection.
          *
          * @return `true` if the `Connection` header is "keep-alive" or absent, `false` otherwise.
          */
         CLUEAPI_INLINE bool keep_alive() const noexcept {
-            auto keep_alive = header("connection");
+            auto keep_alive = header(e_header::connection);
 
             if (!keep_alive.has_value())
                 return true;
@@ -181,10 +244,18 @@ namespace clueapi::http::types {
 
             m_body.clear();
 
+            m_flat_headers.clear();
+
             m_headers.clear();
 
+            m_headers_owned = false;
+
             m_parse_path.clear();
 
+            m_body_stream.reset();
+
+            m_trace = nullptr;
+
             m_cookies_parsed = false;
 
             m_cookies.clear();
@@ -251,8 +322,13 @@ namespace clueapi::http::types {
          * @brief Gets a mutable reference to the request headers.
          *
          * @return A reference to the headers map.
+         *
+         * @note Builds owned copies of the received headers on the first call. Prefer `header()`
+         * or `flat_headers()` on hot paths.
          */
         CLUEAPI_INLINE auto& headers() noexcept {
+            own_headers();
+
             return m_headers;
         }
 
@@ -260,11 +336,27 @@ namespace clueapi::http::types {
          * @brief Gets a const reference to the request headers.
          *
          * @return A const reference to the headers map.
+         *
+         * @note Builds owned copies of the received headers on the first call. Prefer `header()`
+         * or `flat_headers()` on hot paths.
          */
         CLUEAPI_INLINE const auto& headers() const noexcept {
+            own_headers();
+
             return m_headers;
         }
 
+        /**
+         * @brief Gets a const reference to the received headers, without copying them.
+         *
+         * @return A const reference to the flat headers.
+         *
+         * @note Does not reflect changes made through `headers()`.
+         */
+        CLUEAPI_INLINE const auto& flat_headers() const noexcept {
+            return m_flat_headers;
+        }
+
         /**
          * @brief Gets a mutable reference to the path where a large multipart body was saved.
          *
@@ -283,6 +375,43 @@ namespace clueapi::http::types {
             return m_parse_path;
         }
 
+        /**
+         * @brief Gets a mutable reference to the stream of a body that is read by the handler.
+         *
+         * @return A reference to the stream, `nullptr` if the body was buffered.
+         */
+        CLUEAPI_INLINE auto& body_stream() noexcept {
+            return m_body_stream;
+        }
+
+        /**
+         * @brief Gets a const reference to the stream of a body that is read by the handler.
+         *
+         * @return A const reference to the stream, `nullptr` if the body was buffered.
+         */
+        CLUEAPI_INLINE const auto& body_stream() const noexcept {
+            return m_body_stream;
+        }
+
+        /**
+         * @brief Gets a mutable reference to the trace of the request.
+         *
+         * @return A reference to the trace, `nullptr` while tracing is disabled.
+         */
+        CLUEAPI_INLINE auto& trace() noexcept {
+            return m_trace;
+        }
+
+        /**
+         * @brief Gets the trace of the request.
+         *
+         * @return The trace, `nullptr` while tracing is disabled. Owned by the connection, valid
+         * until the response is sent.
+         */
+        CLUEAPI_INLINE shared::trace_t* trace() const noexcept {
+            return m_trace;
+        }
+
         /**
          * @brief Gets a const reference to the parsed cookies.
          *
@@ -298,6 +427,24 @@ namespace clueapi::http::types {
         }
 
        private:
+        /**
+         * @brief Builds the owning headers map from the received headers, once.
+         */
+        CLUEAPI_INLINE void own_headers() const noexcept {
+            if (m_headers_owned)
+                return;
+
+            m_headers_owned = true;
+
+            try {
+                m_flat_headers.for_each([this](std::string_view name, std::string_view value) {
+                    m_headers.emplace(name, value);
+                });
+            } catch (...) {
+                // ...
+            }
+        }
+
         /**
          * @brief Lazily parses the `Cookie` header from the request.
          *
@@ -322,15 +469,35 @@ namespace clueapi::http::types {
         body_t m_body;
 
         /**
-         * @brief The HTTP headers of the request.
+         * @brief The received HTTP headers of the request.
+         */
+        flat_headers_t m_flat_headers;
+
+        /**
+         * @brief The owning HTTP headers of the request, built on demand.
          */
-        headers_t m_headers;
+        mutable headers_t m_headers;
+
+        /**
+         * @brief Whether `m_headers` has been built and is authoritative.
+         */
+        mutable bool m_headers_owned{};
 
         /**
          * @brief The path where a large multipart body was saved.
          */
         boost::filesystem::path m_parse_path;
 
+        /**
+         * @brief The stream of the body, set instead of `m_body` for streamed routes.
+         */
+        std::shared_ptr<body_stream_t> m_body_stream;
+
+        /**
+         * @brief The trace of the request, owned by the connection.
+         */
+        shared::trace_t* m_trace{};
+
        private:
         /**
          * @brief The parsed cookies from the request.
@@ -17,92 +17,145 @@
 #include <boost/lexical_cast.hpp>
 #include <boost/filesystem/operations.hpp>
 
+#include <ctime>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/stat.h>
+#endif
+
 namespace clueapi::http::types {
     inline constexpr std::size_t k_def_buffer_size = 8192;
 
+    namespace {
+        /**
+         * @brief The metadata of a regular file.
+         */
+        struct file_stat_t {
+            std::uint64_t m_size{};
+
+            std::time_t m_mtime{};
+        };
+
+        std::optional<file_stat_t> stat_file(const boost::filesystem::path& path) noexcept {
+#if defined(__unix__) || defined(__APPLE__)
+            struct stat st{};
+
+            if (::stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode))
+                return std::nullopt;
+
+            return file_stat_t{static_cast<std::uint64_t>(st.st_size), st.st_mtime};
+#else
+            boost::system::error_code ec{};
+
+            if (!boost::filesystem::is_regular_file(path, ec))
+                return std::nullopt;
+
+            const auto size = boost::filesystem::file_size(path, ec);
+
+            if (ec)
+                return std::nullopt;
+
+            const auto mtime = boost::filesystem::last_write_time(path, ec);
+
+            if (ec)
+                return std::nullopt;
+
+            return file_stat_t{size, mtime};
+#endif
+        }
+    } // namespace
+
     file_response_t::file_response_t(
         boost::filesystem::path path, status_t::e_status status, headers_t headers) {
         try {
-            if (!boost::filesystem::exists(path) || !boost::filesystem::is_regular_file(path)) {
+            // One stat for the type, the size and the modification time
+            const auto stat = stat_file(path);
+
+            if (!stat.has_value()) {
                 m_status = status_t::not_found;
 
                 return;
             }
 
-            m_is_stream = true;
-
             merge_headers(std::move(headers));
 
-            const auto file_size = boost::filesystem::file_size(path);
+            {
+                m_headers.try_emplace("Content-Type", mime::mime_t::mime_type(path));
 
-            auto content_type = std::string{mime::mime_t::mime_type(path)};
+                m_headers.emplace("ETag", fmt::format("\"{}-{}\"", stat->m_mtime, stat->m_size));
+            }
 
-            {
-                m_headers.try_emplace("Content-Type", std::move(content_type));
+            m_status = status;
+
+            init(file_body_t{std::move(path), stat->m_size});
+        } catch (const std::exception& e) {
+            throw exceptions::exception_t{"Failed to initialize file response: {}", e.what()};
+        } catch (...) {
+            throw exceptions::exception_t{"Failed to initialize file response: unknown"};
+        }
+    }
 
-                m_headers.try_emplace(
-                    "Content-Length", boost::lexical_cast<std::string>(file_size));
+    file_response_t::file_response_t(
+        file_body_t file, status_t::e_status status, headers_t headers) {
+        merge_headers(std::move(headers));
 
-                {
-                    auto last_write = boost::filesystem::last_write_time(path);
-                    auto etag_value = fmt::format("\"{}-{}\"", last_write, file_size);
+        m_status = status;
 
-                    m_headers.emplace("ETag", std::move(etag_value));
-                }
-            }
+        init(std::move(file));
+    }
 
-            m_status = status;
+    void file_response_t::init(file_body_t file) {
+        m_is_stream = true;
 
-            m_stream_fn =
-                [file_size, path = std::move(path)](
-                    chunks::chunk_writer_t& writer) -> exceptions::expected_awaitable_t<> {
-                auto executor = co_await boost::asio::this_coro::executor;
+        m_headers.try_emplace("Content-Length", boost::lexical_cast<std::string>(file.m_size));
 
-                boost::asio::stream_file file(
-                    executor, path.string(), boost::asio::stream_file::read_only);
+        m_file = file;
 
-                if (!file.is_open()) {
-                    co_return exceptions::make_unexpected(
-                        exceptions::io_error_t::make("Can't open file: {}", path.string()));
-                }
+        m_stream_fn =
+            [file_size = file.m_size, path = std::move(file.m_path)](
+                chunks::chunk_writer_t& writer) -> exceptions::expected_awaitable_t<> {
+            auto executor = co_await boost::asio::this_coro::executor;
+
+            boost::asio::stream_file file(
+                executor, path.string(), boost::asio::stream_file::read_only);
 
-                std::array<char, k_def_buffer_size> buffer{};
+            if (!file.is_open()) {
+                co_return exceptions::make_unexpected(
+                    exceptions::io_error_t::make("Can't open file: {}", path.string()));
+            }
 
-                std::size_t total_sent{};
+            std::array<char, k_def_buffer_size> buffer{};
 
-                while (total_sent < file_size && !writer.writer_closed()) {
-                    const auto to_read =
-                        std::min<std::size_t>(k_def_buffer_size, file_size - total_sent);
+            std::size_t total_sent{};
 
-                    const auto read_size = co_await file.async_read_some(
-                        boost::asio::buffer(buffer.data(), to_read), boost::asio::use_awaitable);
+            while (total_sent < file_size && !writer.writer_closed()) {
+                const auto to_read =
+                    std::min<std::size_t>(k_def_buffer_size, file_size - total_sent);
 
-                    if (read_size <= 0)
-                        break;
+                const auto read_size = co_await file.async_read_some(
+                    boost::asio::buffer(buffer.data(), to_read), boost::asio::use_awaitable);
 
-                    total_sent += read_size;
+                if (read_size <= 0)
+                    break;
 
-                    auto result = co_await exceptions::wrap_awaitable(
-                        writer.write_chunk(std::string_view{buffer.data(), read_size}),
+                total_sent += read_size;
 
-                        exceptions::io_error_t::make("Failed to write chunk"));
+                auto result = co_await exceptions::wrap_awaitable(
+                    writer.write_chunk(std::string_view{buffer.data(), read_size}),
 
-                    if (!result.has_value()) {
-                        if (file.is_open())
-                            file.close();
+                    exceptions::io_error_t::make("Failed to write chunk"));
 
-                        co_return exceptions::make_unexpected(result.error());
-                    }
+                if (!result.has_value()) {
+                    if (file.is_open())
+                        file.close();
+
+                    co_return exceptions::make_unexpected(result.error());
                 }
+            }
 
-                file.close();
+            file.close();
 
-                co_return exceptions::expected_t<>{};
-            };
-        } catch (const std::exception& e) {
-            throw exceptions::exception_t{"Failed to initialize file response: {}", e.what()};
-        } catch (...) {
-            throw exceptions::exception_t{"Failed to initialize file response: unknown"};
-        }
+            co_return exceptions::expected_t<>{};
+        };
     }
 } // namespace clueapi::http::types
\ No newline at end of file
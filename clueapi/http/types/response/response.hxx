@@ -7,8 +7,13 @@
 #ifndef CLUEAPI_HTTP_TYPES_RESPONSE_HXX
 #define CLUEAPI_HTTP_TYPES_RESPONSE_HXX
 
+#include <cstdint>
 #include <functional>
+#include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <utility>
 
 #include <boost/filesystem/path.hpp>
@@ -19,6 +24,7 @@
 #include "clueapi/http/types/cookie/cookie.hxx"
 #include "clueapi/http/types/status/status.hxx"
 
+#include "clueapi/shared/json_writer/json_writer.hxx"
 #include "clueapi/shared/macros.hxx"
 
 // Forward declarations
@@ -27,6 +33,52 @@ namespace clueapi::http::chunks {
 }
 
 namespace clueapi::http::types {
+    /**
+     * @struct file_body_t
+     *
+     * @brief A file sent as the body of a response, its length known before it is read.
+     */
+    struct file_body_t {
+        /**
+         * @brief The path of the file.
+         */
+        boost::filesystem::path m_path;
+
+        /**
+         * @brief The size of the file.
+         */
+        std::uint64_t m_size{};
+    };
+
+    /**
+     * @struct shared_body_t
+     *
+     * @brief A body kept in memory by its owner and shared by the responses that send it.
+     *
+     * @details Used instead of `body()` to send the same bytes (e.g., a cached static file) to
+     * many clients without copying them per response.
+     */
+    struct shared_body_t {
+        /**
+         * @brief Checks if the body is set.
+         *
+         * @return `true` if the body is set, `false` otherwise.
+         */
+        [[nodiscard]] CLUEAPI_INLINE explicit operator bool() const noexcept {
+            return static_cast<bool>(m_owner);
+        }
+
+        /**
+         * @brief The bytes of the body.
+         */
+        std::string_view m_data{};
+
+        /**
+         * @brief Keeps the bytes alive until the response is written.
+         */
+        std::shared_ptr<const void> m_owner{};
+    };
+
     /**
      * @struct base_response_t
      *
@@ -107,6 +159,10 @@ namespace clueapi::http::types {
 
             m_stream_fn = nullptr;
 
+            m_file.reset();
+
+            m_shared_body = {};
+
             m_is_stream = false;
         }
 
@@ -229,6 +285,46 @@ namespace clueapi::http::types {
             return m_is_stream;
         }
 
+        /**
+         * @brief Gets a mutable reference to the file sent as the body.
+         *
+         * @return A reference to the file, e.g. to send a precompressed variant instead.
+         */
+        CLUEAPI_INLINE auto& file() noexcept {
+            return m_file;
+        }
+
+        /**
+         * @brief Gets the file sent as the body, if any.
+         *
+         * @return A const reference to the file, `std::nullopt` for other responses.
+         *
+         * @details The server sends it with a fixed length straight from the file, honoring
+         * `Range`, `If-Range` and `If-None-Match`. `stream_fn()` is the fallback where that isn't
+         * available.
+         */
+        [[nodiscard]] CLUEAPI_INLINE const auto& file() const noexcept {
+            return m_file;
+        }
+
+        /**
+         * @brief Gets a mutable reference to the shared body.
+         *
+         * @return A reference to the shared body.
+         */
+        CLUEAPI_INLINE auto& shared_body() noexcept {
+            return m_shared_body;
+        }
+
+        /**
+         * @brief Gets the shared body, sent instead of `body()` when it is set.
+         *
+         * @return A const reference to the shared body.
+         */
+        [[nodiscard]] CLUEAPI_INLINE const auto& shared_body() const noexcept {
+            return m_shared_body;
+        }
+
        public:
         /**
          * @brief Moves the body out of the response object.
@@ -283,6 +379,16 @@ namespace clueapi::http::types {
          */
         stream_fn_t m_stream_fn{};
 
+        /**
+         * @brief The file sent as the body, if any.
+         */
+        std::optional<file_body_t> m_file{};
+
+        /**
+         * @brief The shared body, if any.
+         */
+        shared_body_t m_shared_body{};
+
         /**
          * @brief Whether the response is a streaming response.
          */
@@ -392,12 +498,41 @@ namespace clueapi::http::types {
 
             m_status = status;
         }
+
+        /**
+         * @brief Constructs the response from any value `shared::json_writer_t` writes.
+         *
+         * @param body The value, e.g. a structure described with `k_json_fields`.
+         * @param status The HTTP status code.
+         * @param headers The headers of the response.
+         *
+         * @details The value is serialized straight into the body, without a JSON object in
+         * between. The server sends the body as is.
+         */
+        template <typename _type_t>
+            requires(!std::is_same_v<std::remove_cvref_t<_type_t>, json_t::json_obj_t>)
+        CLUEAPI_INLINE json_response_t(
+            const _type_t& body, status_t::e_status status = status_t::ok, headers_t headers = {}) {
+            shared::json_writer_t::write(m_body, body);
+
+            {
+                merge_headers(std::move(headers));
+
+                m_headers.try_emplace("Content-Type", "application/json");
+            }
+
+            m_status = status;
+        }
     };
 
     /**
      * @struct file_response_t
      *
-     * @brief A response class for streaming a file from disk.
+     * @brief A response class for sending a file from disk.
+     *
+     * @details On Linux the server sends the file with `sendfile(2)` and a `Content-Length`,
+     * answering `Range` with `206 Partial Content` and a matching `If-None-Match` with
+     * `304 Not Modified`. Elsewhere the file is streamed with chunked encoding.
      */
     struct file_response_t : public base_response_t {
         CLUEAPI_INLINE file_response_t() noexcept = default;
@@ -406,6 +541,26 @@ namespace clueapi::http::types {
             boost::filesystem::path path,
             status_t::e_status status = status_t::ok,
             headers_t headers = {});
+
+        /**
+         * @brief Constructs a response for a file whose metadata is already known.
+         *
+         * @param file The path and the size of the file.
+         * @param status The HTTP status code.
+         * @param headers The headers, with the `Content-Type` and the `ETag` of the file.
+         *
+         * @details Doesn't touch the filesystem, the file is opened when it is sent. Used by
+         * callers that cache the metadata, e.g. `middleware::c_static_files`.
+         */
+        file_response_t(file_body_t file, status_t::e_status status, headers_t headers);
+
+       private:
+        /**
+         * @brief Sets the length, the file and the fallback stream of the response.
+         *
+         * @param file The path and the size of the file.
+         */
+        void init(file_body_t file);
     };
 
     /**
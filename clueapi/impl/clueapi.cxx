@@ -6,10 +6,16 @@
 
 #include "clueapi/clueapi.hxx"
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstdlib>
+#include <functional>
+#include <iterator>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <string_view>
 #include <system_error>
 #include <thread>
@@ -18,6 +24,8 @@
 #include <boost/asio/error.hpp>
 #include <boost/asio/signal_set.hpp>
 
+#include <fmt/format.h>
+
 #include "clueapi/exceptions/exceptions.hxx"
 
 #include "clueapi/http/ctx/ctx.hxx"
@@ -32,9 +40,28 @@
 
 #include "clueapi/server/server.hxx"
 
+#ifndef _WIN32
+#include "clueapi/server/detail/supervisor/supervisor.hxx"
+#endif // _WIN32
+
 #include "clueapi/shared/io_ctx_pool/io_ctx_pool.hxx"
+#include "clueapi/shared/metrics/metrics.hxx"
+#include "clueapi/shared/thread_pool/thread_pool.hxx"
+#include "clueapi/shared/tracing/tracing.hxx"
 
 namespace clueapi {
+    namespace {
+        /**
+         * @brief The JSON body of an error response.
+         */
+        struct error_body_t {
+            std::string_view m_error;
+
+            static constexpr auto k_json_fields =
+                shared::json_fields(shared::json_field("error", &error_body_t::m_error));
+        };
+    } // namespace
+
 #ifdef CLUEAPI_USE_LOGGING_MODULE
     const std::unique_ptr<modules::logging::c_logging> g_logging =
         std::make_unique<modules::logging::c_logging>();
@@ -167,86 +194,13 @@ namespace clueapi {
 
             m_cfg = std::move(cfg);
 
-            try {
-                init_modules();
-
-                m_state.update(state_t::starting);
-
-                {
-                    m_io_ctx_pool.start(m_cfg.m_workers);
-
-                    if (!m_io_ctx_pool.is_running())
-                        throw exceptions::exception_t{"I/O context pool failed to start"};
-                }
-
-                auto* io_ctx = m_io_ctx_pool.def_io_ctx();
-
-                if (!io_ctx)
-                    throw exceptions::exception_t{"No I/O context available for signals"};
-
-                {
-                    CLUEAPI_LOG_TRACE(
-                        "Setting up signal handlers for SIGINT, SIGTERM, SIGQUIT, SIGSEGV");
-
-                    m_signals = std::make_unique<boost::asio::signal_set>(*io_ctx);
-
-                    {
-                        m_signals->add(SIGINT);
-
-                        m_signals->add(SIGTERM);
-
-#ifndef _WIN32
-                        m_signals->add(SIGQUIT);
-#endif // _WIN32
-
-                        m_signals->add(SIGSEGV);
-                    }
+            if (m_cfg.m_prefork.m_enabled) {
+                start_supervisor();
 
-                    m_signals->async_wait([this](const boost::system::error_code& ec, int signo) {
-                        if (ec == boost::asio::error::operation_aborted)
-                            return;
-
-                        CLUEAPI_LOG_DEBUG(
-                            "Received signal {}, initiating graceful shutdown", signo);
-
-                        if (m_shutdown_requested.exchange(true, std::memory_order_acq_rel))
-                            return;
-
-                        stop_async();
-                    });
-                }
-
-                sanitize_cfg();
-
-                create_tmp_dir();
-
-                init_middleware_chain();
-
-                {
-                    m_server = std::make_unique<server::c_server>(
-                        *m_self, m_io_ctx_pool, m_middleware_chain, m_cfg);
-
-                    if (!m_server)
-                        throw exceptions::exception_t{"Failed to initialize server"};
-
-                    m_server->start();
-
-                    if (!m_server->is_running())
-                        throw exceptions::exception_t{"Server failed to start"};
-                }
-
-                m_state.update(state_t::running);
-            } catch (const std::exception& e) {
-                CLUEAPI_LOG_CRITICAL("Error during clueapi startup: {}", e.what());
-
-                cleanup_on_error();
-
-                m_state.update(state_t::stopped);
-
-                throw;
+                return;
             }
 
-            m_start_cv.notify_all();
+            start_server();
         }
 
         void wait() {
@@ -285,6 +239,18 @@ namespace clueapi {
             stop_sync();
         }
 
+        void reload() {
+#ifndef _WIN32
+            if (m_supervisor) {
+                m_supervisor->reload();
+
+                return;
+            }
+#endif // _WIN32
+
+            CLUEAPI_LOG_WARNING("Reload requested outside of the prefork mode, ignoring it");
+        }
+
         const cfg_t& cfg() const noexcept {
             return m_cfg;
         }
@@ -293,6 +259,14 @@ namespace clueapi {
             return m_io_ctx_pool;
         }
 
+        shared::thread_pool_t& cpu_pool() noexcept {
+            return m_cpu_pool;
+        }
+
+        shared::thread_pool_t& blocking_pool() noexcept {
+            return m_blocking_pool;
+        }
+
         [[nodiscard]] bool is_running() const noexcept {
             return m_state.current() == state_t::running;
         }
@@ -301,45 +275,191 @@ namespace clueapi {
             return m_state.current() == state_t::stopped;
         }
 
+        [[nodiscard]] std::string metrics() const {
+            std::string ret{};
+
+            shared::metrics_t::write_prometheus(ret, shared::metrics_t::snapshot());
+
+            const auto append = std::back_inserter(ret);
+
+            if (m_server) {
+                fmt::format_to(
+                    append,
+                    "# HELP clueapi_connections Connections being served.\n"
+                    "# TYPE clueapi_connections gauge\n"
+                    "clueapi_connections {}\n"
+                    "# HELP clueapi_connections_total Connections accepted.\n"
+                    "# TYPE clueapi_connections_total counter\n"
+                    "clueapi_connections_total {}\n",
+
+                    m_server->get_active_connections(),
+                    m_server->get_total_connections());
+
+                const auto stats = m_server->client_pool_stats();
+
+                ret.append(
+                    "# HELP clueapi_client_pool_clients Clients of a pool shard, by state.\n"
+                    "# TYPE clueapi_client_pool_clients gauge\n");
+
+                for (std::size_t i{}; i < stats.size(); i++)
+                    fmt::format_to(
+                        append,
+                        "clueapi_client_pool_clients{{shard=\"{}\",state=\"busy\"}} {}\n"
+                        "clueapi_client_pool_clients{{shard=\"{}\",state=\"free\"}} {}\n",
+
+                        i,
+                        stats[i].m_capacity - std::min(stats[i].m_available, stats[i].m_capacity),
+                        i,
+                        stats[i].m_available);
+
+                ret.append(
+                    "# HELP clueapi_client_pool_misses_total Acquisitions that found no free "
+                    "client.\n"
+                    "# TYPE clueapi_client_pool_misses_total counter\n");
+
+                for (std::size_t i{}; i < stats.size(); i++)
+                    fmt::format_to(
+                        append,
+                        "clueapi_client_pool_misses_total{{shard=\"{}\"}} {}\n",
+                        i,
+                        stats[i].m_misses);
+            }
+
+#ifdef CLUEAPI_USE_LOGGING_MODULE
+            fmt::format_to(
+                append,
+                "# HELP clueapi_log_dropped_total Log messages lost to a full buffer.\n"
+                "# TYPE clueapi_log_dropped_total counter\n"
+                "clueapi_log_dropped_total {}\n",
+
+                g_logging->dropped());
+#endif // CLUEAPI_USE_LOGGING_MODULE
+
+            const std::pair<std::string_view, shared::thread_pool_t::stats_t> pools[]{
+                {"cpu", m_cpu_pool.stats()}, {"blocking", m_blocking_pool.stats()}};
+
+            ret.append(
+                "# HELP clueapi_thread_pool_threads Threads of a handler pool.\n"
+                "# TYPE clueapi_thread_pool_threads gauge\n");
+
+            for (const auto& [name, stats] : pools)
+                fmt::format_to(
+                    append,
+                    "clueapi_thread_pool_threads{{pool=\"{}\"}} {}\n",
+                    name,
+                    stats.m_threads);
+
+            ret.append(
+                "# HELP clueapi_thread_pool_tasks Tasks of a handler pool, by state.\n"
+                "# TYPE clueapi_thread_pool_tasks gauge\n");
+
+            for (const auto& [name, stats] : pools)
+                fmt::format_to(
+                    append,
+                    "clueapi_thread_pool_tasks{{pool=\"{}\",state=\"queued\"}} {}\n"
+                    "clueapi_thread_pool_tasks{{pool=\"{}\",state=\"active\"}} {}\n",
+
+                    name,
+                    stats.m_queued,
+                    name,
+                    stats.m_active);
+
+            ret.append(
+                "# HELP clueapi_thread_pool_completed_total Tasks a handler pool ran.\n"
+                "# TYPE clueapi_thread_pool_completed_total counter\n");
+
+            for (const auto& [name, stats] : pools)
+                fmt::format_to(
+                    append,
+                    "clueapi_thread_pool_completed_total{{pool=\"{}\"}} {}\n",
+                    name,
+                    stats.m_completed);
+
+            ret.append(
+                "# HELP clueapi_thread_pool_rejected_total Tasks a handler pool rejected, "
+                "answered 503.\n"
+                "# TYPE clueapi_thread_pool_rejected_total counter\n");
+
+            for (const auto& [name, stats] : pools)
+                fmt::format_to(
+                    append,
+                    "clueapi_thread_pool_rejected_total{{pool=\"{}\"}} {}\n",
+                    name,
+                    stats.m_rejected);
+
+            return ret;
+        }
+
        public:
         void add_route(
             http::types::method_t::e_method method,
             http::types::path_t path,
 
             std::function<shared::awaitable_t<http::types::response_t>(http::ctx_t)>
-                async_handler) {
+                async_handler,
+
+            route::e_body_mode body_mode,
+            route::e_executor executor) {
             using route_handler_t = route::route_t<
                 std::function<shared::awaitable_t<http::types::response_t>(http::ctx_t)>>;
 
-            auto route = std::make_shared<route_handler_t>(method, path, std::move(async_handler));
+            add_route(
+                method,
 
-            try {
-                m_routes.insert(method, path, std::move(route));
-            } catch (const std::exception& e) {
-                CLUEAPI_LOG_ERROR(
-                    "Failed to insert async route: {} {}: {}",
+                path,
 
-                    http::types::method_t::to_str(method),
-                    path,
-                    e.what());
-            }
+                std::make_shared<route_handler_t>(
+                    method, path, std::move(async_handler), body_mode, executor));
         }
 
         void add_route(
             http::types::method_t::e_method method,
             http::types::path_t path,
 
-            std::function<http::types::response_t(http::ctx_t)> sync_handler) {
+            std::function<http::types::response_t(http::ctx_t)> sync_handler,
+
+            route::e_body_mode body_mode,
+            route::e_executor executor) {
             using route_handler_t =
                 route::route_t<std::function<http::types::response_t(http::ctx_t)>>;
 
-            auto route = std::make_shared<route_handler_t>(method, path, std::move(sync_handler));
+            add_route(
+                method,
+
+                path,
+
+                std::make_shared<route_handler_t>(
+                    method, path, std::move(sync_handler), body_mode, executor));
+        }
+
+        void add_route(
+            http::types::method_t::e_method method,
+            const http::types::path_t& path,
+            std::shared_ptr<route::base_route_t> route) {
+            const auto body_mode = route->body_mode();
+
+            // A coroutine handler runs on its connection's context whatever its executor
+            const auto executor =
+                route->is_awaitable() ? route::e_executor::io : route->executor();
 
             try {
+                auto& metrics_id = route->m_metrics_id;
+
                 m_routes.insert(method, path, std::move(route));
+
+                metrics_id =
+                    shared::metrics_t::add_route(http::types::method_t::to_str(method), path);
+
+                if (body_mode == route::e_body_mode::streamed)
+                    m_has_streamed_routes = true;
+
+                if (executor == route::e_executor::cpu)
+                    m_has_cpu_routes = true;
+                else if (executor == route::e_executor::blocking)
+                    m_has_blocking_routes = true;
             } catch (const std::exception& e) {
                 CLUEAPI_LOG_ERROR(
-                    "Failed to insert sync route: {} {}: {}",
+                    "Failed to insert route: {} {}: {}",
 
                     http::types::method_t::to_str(method),
                     path,
@@ -347,60 +467,163 @@ namespace clueapi {
             }
         }
 
+        void add_websocket(http::types::path_t path, websocket::handler_t handler) {
+            try {
+                m_websocket_routes.insert(http::types::method_t::get, path, std::move(handler));
+
+                m_has_websocket_routes = true;
+            } catch (const std::exception& e) {
+                CLUEAPI_LOG_ERROR("Failed to insert WebSocket route: {}: {}", path, e.what());
+            }
+        }
+
         void add_middleware(middleware::middleware_t middleware) {
             m_middlewares.push_back(std::move(middleware));
         }
 
+        [[nodiscard]] route::e_body_mode body_mode(
+            http::types::method_t::e_method method, std::string_view path) {
+            if (!m_has_streamed_routes)
+                return route::e_body_mode::buffered;
+
+            http::types::params_t params{};
+
+            const auto* route = m_routes.find(method, path, params);
+
+            if (!route || !*route)
+                return route::e_body_mode::buffered;
+
+            return (*route)->body_mode();
+        }
+
+        [[nodiscard]] CLUEAPI_INLINE const middleware::middleware_chain_t& upgrade_chain()
+            const noexcept {
+            return m_upgrade_chain;
+        }
+
+        [[nodiscard]] const websocket::handler_t* websocket_handler(
+            std::string_view path, http::types::params_t& params) const {
+            if (!m_has_websocket_routes)
+                return nullptr;
+
+            const auto* handler = m_websocket_routes.find(http::types::method_t::get, path, params);
+
+            if (!handler || !*handler)
+                return nullptr;
+
+            return handler;
+        }
+
        private:
         void init_middleware_chain() {
-            std::function<shared::awaitable_t<http::types::response_t>(
-                const http::types::request_t&)>
-                core = [this](const http::types::request_t& req)
+            middleware::handler_t core = [this](const http::types::request_t& req)
                 -> shared::awaitable_t<http::types::response_t> {
-                auto opt_pair = m_routes.find(req.method(), req.uri());
+                // The connection owns the request through a shared pointer, so the context shares
+                // it. A request rebuilt by a middleware is not owned by one and is copied instead.
+                // The handler may move from it, the connection took what it reads afterwards.
+                auto request = std::const_pointer_cast<http::types::request_t>(
+                    req.weak_from_this().lock());
+
+                if (!request)
+                    request = std::make_shared<http::types::request_t>(req);
+
+                http::types::params_t params{};
 
-                if (!opt_pair.has_value()) {
+                // The routes are frozen before the server starts, the reference stays valid. The
+                // params are views into the URI of the request the context keeps alive.
+                const auto* found = m_routes.find(request->method(), request->uri(), params);
+
+                // A typed route rejects the parameters that don't convert before anything is parsed
+                if (!found || !*found || !(*found)->accepts(params)) {
                     const auto status = http::types::status_t::not_found;
 
                     co_return make_error_response(status, http::types::status_t::to_str(status));
                 }
 
-                auto [route, params] = opt_pair.value();
+                const auto& route = *found;
 
-                if (!route) {
-                    const auto status = http::types::status_t::not_found;
+                // The handler of a streamed route reads the body itself, there is nothing to parse
+                auto ctx = route->body_mode() == clueapi::route::e_body_mode::streamed
+                               ? http::ctx_t{std::move(request), std::move(params)}
+                               : co_await http::ctx_t::make_awaitable(
+                                     std::move(request),
+                                     std::move(params),
 
-                    co_return make_error_response(status, http::types::status_t::to_str(status));
+                                     m_cfg.m_http.m_multipart_parser_cfg);
+
+                const shared::trace_t::scope_t scope{
+                    ctx.request().trace(), shared::trace_phase_t::handler};
+
+                if (!m_cfg.m_metrics.m_enabled) {
+                    if (route->is_awaitable())
+                        co_return co_await route->handle_awaitable(std::move(ctx));
+
+                    if (route->executor() == route::e_executor::io)
+                        co_return route->handle(std::move(ctx));
+
+                    co_return co_await offload(*route, std::move(ctx));
                 }
 
-                auto ctx = co_await http::ctx_t::make_awaitable(
-                    req,
-                    params,
+                const auto started = std::chrono::steady_clock::now();
 
-                    m_cfg.m_http.m_multipart_parser_cfg);
+                http::types::response_t response{};
 
                 if (route->is_awaitable())
-                    co_return co_await route->handle_awaitable(std::move(ctx));
+                    response = co_await route->handle_awaitable(std::move(ctx));
+                else if (route->executor() == route::e_executor::io)
+                    response = route->handle(std::move(ctx));
+                else
+                    response = co_await offload(*route, std::move(ctx));
+
+                shared::metrics_t::record_latency(
+                    route->m_metrics_id, std::chrono::steady_clock::now() - started);
 
-                co_return route->handle(std::move(ctx));
+                co_return response;
             };
 
-            auto chain = std::move(core);
+            // The middlewares are walked by index, no function object is nested per layer
+            m_middleware_chain = middleware::pipeline_t{m_middlewares, std::move(core)};
+
+            // An upgrade request goes through the same middlewares, its route answers it
+            middleware::handler_t upgrade = [this](const http::types::request_t& req)
+                -> shared::awaitable_t<http::types::response_t> {
+                http::types::params_t params{};
 
-            for (auto& middleware : std::ranges::reverse_view(m_middlewares)) {
-                auto next_chain = std::move(chain);
+                if (!websocket_handler(req.uri(), params)) {
+                    const auto status = http::types::status_t::not_found;
 
-                chain = [&middleware,
-                         next_chain = std::move(next_chain)](const http::types::request_t& req)
-                    -> shared::awaitable_t<http::types::response_t> {
-                    co_return co_await middleware->handle(req, next_chain);
-                };
-            }
+                    co_return make_error_response(status, http::types::status_t::to_str(status));
+                }
+
+                http::types::response_t response{};
 
-            if (!chain)
-                throw exceptions::exception_t("Failed to initialize middleware chain");
+                response.status() = http::types::status_t::switching_protocols;
 
-            m_middleware_chain = std::move(chain);
+                co_return response;
+            };
+
+            m_upgrade_chain = middleware::pipeline_t{m_middlewares, std::move(upgrade)};
+        }
+
+        /**
+         * @brief Runs a synchronous handler on the pool of its executor, the coroutine resuming
+         * on the context of the connection.
+         */
+        shared::awaitable_t<http::types::response_t> offload(
+            route::base_route_t& route, http::ctx_t ctx) {
+            auto& pool =
+                route.executor() == route::e_executor::cpu ? m_cpu_pool : m_blocking_pool;
+
+            auto response =
+                co_await pool.run([&route, &ctx]() { return route.handle(std::move(ctx)); });
+
+            if (!response.has_value()) {
+                const auto status = http::types::status_t::service_unavailable;
+
+                co_return make_error_response(status, http::types::status_t::to_str(status));
+            }
+
+            co_return std::move(response).value();
         }
 
         http::types::response_t make_error_response(
@@ -408,7 +631,7 @@ namespace clueapi {
             switch (m_cfg.m_http.m_def_response_class) {
                 case http::types::e_response_class::json: {
                     return http::types::response_class_t<http::types::json_response_t>::make(
-                        http::types::json_t::json_obj_t{{"error", message}},
+                        error_body_t{message},
 
                         status);
 
@@ -435,12 +658,15 @@ namespace clueapi {
             }
         }
 
-        void init_modules() {
+        void init_modules([[maybe_unused]] bool is_supervisor = false) {
             CLUEAPI_LOG_TRACE("Initializing modules");
 
 #ifdef CLUEAPI_USE_LOGGING_MODULE
+            // The supervisor forks from its own thread, a worker would lose the logging thread
+            const auto async_mode = m_cfg.m_logging_cfg.m_async_mode && !is_supervisor;
+
             modules::logging::cfg_t logging_cfg{
-                .m_async_mode = m_cfg.m_logging_cfg.m_async_mode,
+                .m_async_mode = async_mode,
                 .m_sleep = m_cfg.m_logging_cfg.m_sleep,
                 .m_default_level = m_cfg.m_logging_cfg.m_default_level};
 
@@ -452,7 +678,8 @@ namespace clueapi {
                     .m_level = m_cfg.m_logging_cfg.m_default_level,
                     .m_capacity = m_cfg.m_logging_cfg.m_capacity,
                     .m_batch_size = m_cfg.m_logging_cfg.m_batch_size,
-                    .m_async_mode = m_cfg.m_logging_cfg.m_async_mode});
+                    .m_async_mode = async_mode,
+                    .m_deferred_format = m_cfg.m_logging_cfg.m_deferred_format});
 
             g_logging->add_logger(LOGGER_NAME("clueapi"), std::move(logger));
 #endif
@@ -509,6 +736,211 @@ namespace clueapi {
         }
 
        private:
+        void start_server() {
+            try {
+                init_modules();
+
+                m_state.update(state_t::starting);
+
+                {
+                    m_io_ctx_pool.start(m_cfg.m_workers, m_cfg.m_server.m_io_ctx_pool);
+
+                    if (!m_io_ctx_pool.is_running())
+                        throw exceptions::exception_t{"I/O context pool failed to start"};
+                }
+
+                start_thread_pools();
+
+                auto* io_ctx = m_io_ctx_pool.def_io_ctx();
+
+                if (!io_ctx)
+                    throw exceptions::exception_t{"No I/O context available for signals"};
+
+                {
+                    CLUEAPI_LOG_TRACE(
+                        "Setting up signal handlers for SIGINT, SIGTERM, SIGQUIT, SIGSEGV");
+
+                    m_signals = std::make_unique<boost::asio::signal_set>(*io_ctx);
+
+                    {
+                        m_signals->add(SIGINT);
+
+                        m_signals->add(SIGTERM);
+
+#ifndef _WIN32
+                        m_signals->add(SIGQUIT);
+#endif // _WIN32
+
+                        m_signals->add(SIGSEGV);
+                    }
+
+                    m_signals->async_wait([this](const boost::system::error_code& ec, int signo) {
+                        if (ec == boost::asio::error::operation_aborted)
+                            return;
+
+                        CLUEAPI_LOG_DEBUG(
+                            "Received signal {}, initiating graceful shutdown", signo);
+
+                        if (m_shutdown_requested.exchange(true, std::memory_order_acq_rel))
+                            return;
+
+                        stop_async();
+                    });
+                }
+
+                sanitize_cfg();
+
+                create_tmp_dir();
+
+                // Routes are looked up from a flat table, no route can be added from now on
+                m_routes.freeze();
+
+                m_websocket_routes.freeze();
+
+                init_middleware_chain();
+
+                {
+                    m_server = std::make_unique<server::c_server>(
+                        *m_self, m_io_ctx_pool, m_middleware_chain, m_cfg);
+
+                    if (!m_server)
+                        throw exceptions::exception_t{"Failed to initialize server"};
+
+                    m_server->start();
+
+                    if (!m_server->is_running())
+                        throw exceptions::exception_t{"Server failed to start"};
+                }
+
+                m_state.update(state_t::running);
+            } catch (const std::exception& e) {
+                CLUEAPI_LOG_CRITICAL("Error during clueapi startup: {}", e.what());
+
+                cleanup_on_error();
+
+                m_state.update(state_t::stopped);
+
+                throw;
+            }
+
+            m_start_cv.notify_all();
+        }
+
+        void start_supervisor() {
+#ifdef _WIN32
+            throw exceptions::exception_t{"Prefork mode is not supported on this platform"};
+#else
+            try {
+                init_modules(true);
+
+                m_state.update(state_t::starting);
+
+                sanitize_cfg();
+
+                // Every worker binds its own listener to the endpoint
+                m_cfg.m_server.m_acceptor.m_reuse_port = true;
+
+                // The program of a reuseport group is shared, each worker attaching its own would
+                // steer every connection to the sockets of the first one
+                m_cfg.m_server.m_acceptor.m_reuse_port_cbpf = false;
+
+                // Drawn before the fork, so that every worker resumes the sessions of the others
+                if (m_cfg.m_tls.m_enabled && m_cfg.m_tls.m_ticket_secret.empty())
+                    m_cfg.m_tls.m_ticket_secret = server::detail::c_tls::make_ticket_secret();
+
+                m_supervisor = std::make_unique<server::detail::c_supervisor>(
+                    m_cfg.m_prefork,
+
+                    [this](std::size_t index, const std::function<void()>& ready) {
+                        return run_worker(index, ready);
+                    },
+
+                    [this]() {
+                        m_state.update(state_t::stopped);
+
+                        std::lock_guard lock{m_wait_mutex};
+
+                        m_wait_cv.notify_all();
+                    });
+
+                m_supervisor->start();
+
+                m_state.update(state_t::running);
+            } catch (const std::exception& e) {
+                CLUEAPI_LOG_CRITICAL("Error during clueapi supervisor startup: {}", e.what());
+
+                m_supervisor.reset();
+
+                m_state.update(state_t::stopped);
+
+                throw;
+            }
+
+            m_start_cv.notify_all();
+#endif // _WIN32
+        }
+
+#ifndef _WIN32
+        /**
+         * @brief Runs the server in a forked worker process.
+         *
+         * @details Runs on the thread that forked the worker, the only one of the process, and
+         * never returns to the code that started the supervisor.
+         */
+        int run_worker(std::size_t index, const std::function<void()>& ready) {
+            // The supervisor and its thread belong to the parent process
+            static_cast<void>(m_supervisor.release());
+
+            m_state.update(state_t::stopped);
+
+#ifdef CLUEAPI_USE_LOGGING_MODULE
+            // The logger of the supervisor is synchronous, the worker creates its own
+            g_logging->remove_logger(LOGGER_NAME("clueapi"));
+#endif // CLUEAPI_USE_LOGGING_MODULE
+
+            // Removing the tmp directory on stop must not remove the uploads of the other workers
+            m_cfg.m_server.m_tmp_dir = fmt::format("{}/worker-{}", m_cfg.m_server.m_tmp_dir, index);
+
+            try {
+                if (m_cfg.m_prefork.m_on_worker_start)
+                    m_cfg.m_prefork.m_on_worker_start(index);
+
+                start_server();
+            } catch (const std::exception& e) {
+                CLUEAPI_LOG_CRITICAL("Worker {} failed to start: {}", index, e.what());
+
+                destroy_modules();
+
+                return EXIT_FAILURE;
+            }
+
+            ready();
+
+            wait();
+
+            stop_sync();
+
+            destroy_modules();
+
+            return EXIT_SUCCESS;
+        }
+
+        void stop_supervisor() noexcept {
+            if (m_state.current() == state_t::running)
+                m_state.update(state_t::stopping);
+
+            m_supervisor->stop();
+
+            m_supervisor.reset();
+
+            m_state.update(state_t::stopped);
+
+            std::lock_guard lock{m_wait_mutex};
+
+            m_wait_cv.notify_all();
+        }
+#endif // _WIN32
+
         void stop_async() {
             auto expected = state_t::running;
 
@@ -524,6 +956,8 @@ namespace clueapi {
 
                 remove_tmp_dir();
 
+                stop_thread_pools();
+
                 stop_io_ctx_pool();
 
                 m_state.update(state_t::stopped);
@@ -545,6 +979,14 @@ namespace clueapi {
         }
 
         void stop_sync() {
+#ifndef _WIN32
+            if (m_supervisor) {
+                stop_supervisor();
+
+                return;
+            }
+#endif // _WIN32
+
             auto current_state = m_state.current();
 
             if (current_state == state_t::stopped || current_state == state_t::stopping)
@@ -576,6 +1018,8 @@ namespace clueapi {
 
             remove_tmp_dir();
 
+            stop_thread_pools();
+
             stop_io_ctx_pool();
 
             m_state.update(state_t::stopped);
@@ -593,6 +1037,8 @@ namespace clueapi {
 
             remove_tmp_dir();
 
+            stop_thread_pools();
+
             stop_io_ctx_pool();
         }
 
@@ -632,6 +1078,20 @@ namespace clueapi {
             CLUEAPI_LOG_TRACE("Server destroyed");
         }
 
+        void start_thread_pools() {
+            if (m_has_cpu_routes || m_cfg.m_server.m_cpu_pool.m_enabled)
+                m_cpu_pool.start("cpu_worker", m_cfg.m_server.m_cpu_pool);
+
+            if (m_has_blocking_routes || m_cfg.m_server.m_blocking_pool.m_enabled)
+                m_blocking_pool.start("blk_worker", m_cfg.m_server.m_blocking_pool);
+        }
+
+        void stop_thread_pools() noexcept {
+            m_cpu_pool.stop();
+
+            m_blocking_pool.stop();
+        }
+
         void stop_io_ctx_pool() {
             try {
                 m_io_ctx_pool.stop();
@@ -693,15 +1153,42 @@ namespace clueapi {
 
         shared::io_ctx_pool_t m_io_ctx_pool;
 
+        /**
+         * @brief The pools running the synchronous handlers that are not run inline.
+         */
+        shared::thread_pool_t m_cpu_pool;
+
+        shared::thread_pool_t m_blocking_pool;
+
         std::unique_ptr<boost::asio::signal_set> m_signals;
 
         std::unique_ptr<server::c_server> m_server;
 
         route::detail::radix_tree_t<std::shared_ptr<route::base_route_t>> m_routes;
 
+        bool m_has_streamed_routes{};
+
+        bool m_has_cpu_routes{};
+
+        bool m_has_blocking_routes{};
+
+        route::detail::radix_tree_t<websocket::handler_t> m_websocket_routes;
+
+        bool m_has_websocket_routes{};
+
         std::vector<middleware::middleware_t> m_middlewares;
 
         middleware::middleware_chain_t m_middleware_chain;
+
+        /**
+         * @brief The middlewares followed by the WebSocket routes, for the upgrade requests.
+         */
+        middleware::middleware_chain_t m_upgrade_chain;
+
+#ifndef _WIN32
+        // Declared last, the supervisor thread is joined before the other members go away
+        std::unique_ptr<server::detail::c_supervisor> m_supervisor;
+#endif // _WIN32
     };
 
     c_clueapi::c_clueapi() : m_impl{std::make_unique<c_impl>(this)} {
@@ -721,6 +1208,10 @@ namespace clueapi {
         m_impl->stop();
     }
 
+    void c_clueapi::reload() {
+        m_impl->reload();
+    }
+
     const cfg_t& c_clueapi::cfg() const noexcept {
         return m_impl->cfg();
     }
@@ -729,6 +1220,14 @@ namespace clueapi {
         return m_impl->io_ctx_pool();
     }
 
+    shared::thread_pool_t& c_clueapi::cpu_pool() const noexcept {
+        return m_impl->cpu_pool();
+    }
+
+    shared::thread_pool_t& c_clueapi::blocking_pool() const noexcept {
+        return m_impl->blocking_pool();
+    }
+
     bool c_clueapi::is_running() const noexcept {
         return m_impl->is_running();
     }
@@ -737,8 +1236,17 @@ namespace clueapi {
         return m_impl->is_stopped();
     }
 
+    route::e_body_mode c_clueapi::body_mode(
+        http::types::method_t::e_method method, std::string_view path) const {
+        return m_impl->body_mode(method, path);
+    }
+
     void c_clueapi::add_method(
-        http::types::method_t::e_method method, http::types::path_t path, route_t&& handler) {
+        http::types::method_t::e_method method,
+        http::types::path_t path,
+        route_t&& handler,
+        route::e_body_mode body_mode,
+        route::e_executor executor) {
         std::visit(
             [&](auto&& curr_handler) {
                 m_impl->add_route(
@@ -746,16 +1254,47 @@ namespace clueapi {
 
                     path,
 
-                    std::forward<decltype(curr_handler)>(curr_handler));
+                    std::forward<decltype(curr_handler)>(curr_handler),
+
+                    body_mode,
+                    executor);
             },
 
             std::move(handler));
     }
 
+    void c_clueapi::add_route(
+        http::types::method_t::e_method method,
+        http::types::path_t path,
+        std::shared_ptr<route::base_route_t> route) {
+        m_impl->add_route(method, path, std::move(route));
+    }
+
+    const websocket::handler_t* c_clueapi::websocket_handler(
+        std::string_view path, http::types::params_t& params) const {
+        return m_impl->websocket_handler(path, params);
+    }
+
+    const middleware::middleware_chain_t& c_clueapi::upgrade_chain() const noexcept {
+        return m_impl->upgrade_chain();
+    }
+
+    void c_clueapi::add_websocket(http::types::path_t path, websocket::handler_t handler) {
+        m_impl->add_websocket(std::move(path), std::move(handler));
+    }
+
     void c_clueapi::add_middleware(middleware::middleware_t middleware) {
         m_impl->add_middleware(std::move(middleware));
     }
 
+    void c_clueapi::mount_static(
+        http::types::path_t prefix,
+        boost::filesystem::path root,
+        middleware::static_files_cfg_t cfg) {
+        add_middleware(std::make_shared<middleware::c_static_files>(
+            std::move(prefix), std::move(root), std::move(cfg)));
+    }
+
     void c_clueapi::enable_default_handlers() {
         CLUEAPI_LOG_DEBUG("Enabling default handlers");
 
@@ -786,5 +1325,17 @@ namespace clueapi {
                 co_return http::types::json_response_t{
                     http::types::json_t::json_obj_t{}, http::types::status_t::ok};
             });
+
+        add_method(
+            http::types::method_t::get,
+
+            "/metrics",
+
+            [this](http::ctx_t ctx) -> shared::awaitable_t<http::types::response_t> {
+                co_return http::types::response_t{
+                    m_impl->metrics(),
+                    http::types::status_t::ok,
+                    {{"Content-Type", "text/plain; version=0.0.4"}}};
+            });
     }
 } // namespace clueapi
\ No newline at end of file
@@ -0,0 +1,130 @@
+/**
+ * @file composed.hxx
+ *
+ * @brief Defines a middleware composed at compile time from a list of middleware types.
+ */
+
+#ifndef CLUEAPI_MIDDLEWARE_COMPOSED_HXX
+#define CLUEAPI_MIDDLEWARE_COMPOSED_HXX
+
+#include <cstddef>
+#include <tuple>
+#include <utility>
+
+#include "clueapi/http/types/request/request.hxx"
+#include "clueapi/http/types/response/response.hxx"
+
+#include "clueapi/middleware/middleware.hxx"
+
+#include "clueapi/shared/macros.hxx"
+#include "clueapi/shared/shared.hxx"
+
+namespace clueapi::middleware {
+    /**
+     * @class c_composed_middleware
+     *
+     * @brief A stack of middlewares known at build time, run as a single middleware.
+     *
+     * @details The middlewares are plain types, not derived from `c_base_middleware`, each with a
+     * member function template:
+     *
+     * @code
+     * template <typename _next_t>
+     * shared::awaitable_t<http::types::response_t> handle(
+     *     const http::types::request_t& request, _next_t next);
+     * @endcode
+     *
+     * `next` is a distinct type for every position, so the calls from one middleware to the next
+     * are direct and can be inlined. There is a single virtual call for the whole stack, and the
+     * last middleware continues with the rest of the pipeline.
+     *
+     * @tparam _middlewares_t The middlewares, in the order they see the request.
+     */
+    template <typename... _middlewares_t>
+    class c_composed_middleware final : public c_base_middleware {
+       public:
+        /**
+         * @brief Constructs a composed middleware.
+         *
+         * @param middlewares The middlewares.
+         */
+        CLUEAPI_INLINE explicit c_composed_middleware(_middlewares_t... middlewares)
+            : m_middlewares{std::move(middlewares)...} {
+        }
+
+       public:
+        /**
+         * @brief Runs the stack, then the rest of the pipeline.
+         *
+         * @param request The incoming HTTP request.
+         * @param next The continuation of the pipeline after the stack.
+         *
+         * @return An awaitable that resolves to an `http::types::response_t`.
+         */
+        CLUEAPI_INLINE shared::awaitable_t<http::types::response_t> handle(
+            const http::types::request_t& request,
+
+            next_t next) override {
+            return run<0>(request, next);
+        }
+
+        /**
+         * @brief Gets a middleware of the stack.
+         *
+         * @tparam _index The position of the middleware.
+         *
+         * @return A reference to the middleware.
+         */
+        template <std::size_t _index>
+        [[nodiscard]] CLUEAPI_INLINE auto& get() noexcept {
+            return std::get<_index>(m_middlewares);
+        }
+
+       private:
+        /**
+         * @struct static_next_t
+         *
+         * @brief The continuation of the middleware before `_index`.
+         *
+         * @tparam _index The position of the next middleware.
+         */
+        template <std::size_t _index>
+        struct static_next_t {
+            CLUEAPI_INLINE shared::awaitable_t<http::types::response_t> operator()(
+                const http::types::request_t& request) const {
+                return m_self->template run<_index>(request, m_next);
+            }
+
+            /**
+             * @brief The composed middleware.
+             */
+            c_composed_middleware* m_self;
+
+            /**
+             * @brief The continuation of the pipeline after the stack.
+             */
+            next_t m_next;
+        };
+
+        /**
+         * @brief Passes a request to the stack from a position.
+         */
+        template <std::size_t _index>
+        CLUEAPI_INLINE shared::awaitable_t<http::types::response_t> run(
+            const http::types::request_t& request, next_t next) {
+            if constexpr (_index == sizeof...(_middlewares_t))
+                return next(request);
+            else
+                return std::get<_index>(m_middlewares)
+                    .handle(request, static_next_t<_index + 1>{this, next});
+        }
+
+       private:
+        /**
+         * @brief The middlewares, in the order they see the request.
+         */
+        std::tuple<_middlewares_t...> m_middlewares;
+    };
+} // namespace clueapi::middleware
+
+#endif // CLUEAPI_MIDDLEWARE_COMPOSED_HXX
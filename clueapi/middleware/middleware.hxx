@@ -7,14 +7,18 @@
 #ifndef CLUEAPI_MIDDLEWARE_HXX
 #define CLUEAPI_MIDDLEWARE_HXX
 
+#include <cstddef>
 #include <functional>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "clueapi/http/types/request/request.hxx"
 #include "clueapi/http/types/response/response.hxx"
 
 #include "clueapi/shared/macros.hxx"
 #include "clueapi/shared/shared.hxx"
+#include "clueapi/shared/tracing/tracing.hxx"
 
 /**
  * @namespace clueapi::middleware
@@ -22,31 +26,63 @@
  * @brief The main namespace for the clueapi middleware system.
  */
 namespace clueapi::middleware {
+    // Forward declarations
+    struct pipeline_t;
+
     /**
-     * @brief A function type representing the next middleware or the final route handler in the
+     * @struct next_t
+     *
+     * @brief A continuation representing the next middleware or the final route handler in the
      * chain.
      *
-     * @details A middleware's `handle` method receives this function as a parameter. To pass
-     * control to the next component in the chain, the middleware must invoke this function. It can
-     * choose to do so before or after its own logic, or even not at all (to terminate the request
-     * early).
+     * @details A middleware's `handle` method receives this object as a parameter. To pass
+     * control to the next component in the chain, the middleware must invoke it. It can choose to
+     * do so before or after its own logic, or even not at all (to terminate the request early).
+     *
+     * It is only a reference to the pipeline and a position in it, so it is copied for free and
+     * calling it doesn't allocate beyond the coroutine frame of the next middleware.
      *
-     * @return An awaitable that resolves to the final `http::types::response_t`.
+     * @note Non-owning: valid as long as the pipeline, which outlives every request.
      */
-    using next_t =
-        std::function<shared::awaitable_t<http::types::response_t>(const http::types::request_t&)>;
+    struct next_t {
+        /**
+         * @brief Constructs a continuation.
+         *
+         * @param pipeline The pipeline.
+         * @param index The position of the next middleware in the pipeline.
+         */
+        CLUEAPI_INLINE constexpr next_t(const pipeline_t& pipeline, std::size_t index) noexcept
+            : m_pipeline{&pipeline}, m_index{index} {
+        }
+
+       public:
+        /**
+         * @brief Passes the request to the next component of the chain.
+         *
+         * @param request The request.
+         *
+         * @return An awaitable that resolves to the final `http::types::response_t`.
+         */
+        shared::awaitable_t<http::types::response_t> operator()(
+            const http::types::request_t& request) const;
+
+       private:
+        /**
+         * @brief The pipeline.
+         */
+        const pipeline_t* m_pipeline;
+
+        /**
+         * @brief The position of the next middleware in the pipeline.
+         */
+        std::size_t m_index;
+    };
 
     /**
-     * @brief A function type representing the middleware chain.
-     *
-     * @details A middleware's `handle` method receives this function as a parameter. To pass
-     * control to the next component in the chain, the middleware must invoke this function. It can
-     * choose to do so before or after its own logic, or even not at all (to terminate the request
-     * early). This function type is used to represent the middleware chain.
-     *
-     * @return An awaitable that resolves to the final `http::types::response_t`.
+     * @brief A function type representing the final route handler of a pipeline.
      */
-    using middleware_chain_t = next_t;
+    using handler_t =
+        std::function<shared::awaitable_t<http::types::response_t>(const http::types::request_t&)>;
 
     /**
      * @class c_base_middleware
@@ -65,7 +101,7 @@ namespace clueapi::middleware {
          * @param request The incoming HTTP request.
          * Middleware can modify the request before passing it to the next handler.
          *
-         * @param next A function that passes control to the next middleware in the chain.
+         * @param next A continuation that passes control to the next middleware in the chain.
          *
          * @return An awaitable that resolves to an `http::types::response_t`.
          *
@@ -90,6 +126,133 @@ namespace clueapi::middleware {
      * the lifetime of middleware instances in the processing chain.
      */
     using middleware_t = std::shared_ptr<c_base_middleware>;
+
+    /**
+     * @struct pipeline_t
+     *
+     * @brief The middleware chain, a flat array of middlewares followed by the route handler.
+     *
+     * @details Instead of nesting one `std::function` per middleware, the chain is walked by
+     * index: each middleware receives a `next_t` pointing to the following position. No function
+     * object is copied and no wrapping coroutine is created per layer on a request, except for
+     * the traced ones whose middlewares are timed.
+     */
+    struct pipeline_t {
+        CLUEAPI_INLINE pipeline_t() noexcept = default;
+
+        /**
+         * @brief Constructs a pipeline.
+         *
+         * @param middlewares The middlewares, in the order they see the request.
+         * @param handler The final route handler.
+         */
+        CLUEAPI_INLINE pipeline_t(std::vector<middleware_t> middlewares, handler_t handler)
+            : m_middlewares{std::move(middlewares)}, m_handler{std::move(handler)} {
+        }
+
+        // Copy constructor, the continuations of a pipeline point to it
+        CLUEAPI_INLINE pipeline_t(const pipeline_t&) = delete;
+
+        // Copy assignment operator
+        CLUEAPI_INLINE pipeline_t& operator=(const pipeline_t&) = delete;
+
+        // Move constructor
+        CLUEAPI_INLINE pipeline_t(pipeline_t&&) noexcept = default;
+
+        // Move assignment operator
+        CLUEAPI_INLINE pipeline_t& operator=(pipeline_t&&) noexcept = default;
+
+       public:
+        /**
+         * @brief Passes a request through the whole chain.
+         *
+         * @param request The request.
+         *
+         * @return An awaitable that resolves to the final `http::types::response_t`.
+         */
+        CLUEAPI_INLINE shared::awaitable_t<http::types::response_t> operator()(
+            const http::types::request_t& request) const {
+            return run(0, request);
+        }
+
+        /**
+         * @brief Passes a request to the chain from a position.
+         *
+         * @param index The position of the middleware, the size of the array for the handler.
+         * @param request The request.
+         *
+         * @return An awaitable that resolves to the final `http::types::response_t`.
+         */
+        CLUEAPI_INLINE shared::awaitable_t<http::types::response_t> run(
+            std::size_t index, const http::types::request_t& request) const {
+            if (index < m_middlewares.size()) {
+                if (auto* trace = request.trace())
+                    return run_traced(*trace, index, request);
+
+                return m_middlewares[index]->handle(request, next_t{*this, index + 1});
+            }
+
+            return m_handler(request);
+        }
+
+        /**
+         * @brief Checks if the pipeline has a handler.
+         *
+         * @return `true` if a request can be passed through it, `false` otherwise.
+         */
+        [[nodiscard]] CLUEAPI_INLINE explicit operator bool() const noexcept {
+            return static_cast<bool>(m_handler);
+        }
+
+        /**
+         * @brief Gets the number of middlewares.
+         *
+         * @return The number of middlewares.
+         */
+        [[nodiscard]] CLUEAPI_INLINE std::size_t size() const noexcept {
+            return m_middlewares.size();
+        }
+
+       private:
+        /**
+         * @brief Passes a traced request to a middleware, timing it.
+         *
+         * @param trace The trace of the request.
+         * @param index The position of the middleware.
+         * @param request The request.
+         *
+         * @return An awaitable that resolves to the final `http::types::response_t`.
+         */
+        shared::awaitable_t<http::types::response_t> run_traced(
+            shared::trace_t& trace,
+            std::size_t index,
+            const http::types::request_t& request) const {
+            const shared::trace_t::scope_t scope{&trace, shared::trace_phase_t::middleware, index};
+
+            co_return co_await m_middlewares[index]->handle(request, next_t{*this, index + 1});
+        }
+
+       private:
+        /**
+         * @brief The middlewares, in the order they see the request.
+         */
+        std::vector<middleware_t> m_middlewares;
+
+        /**
+         * @brief The final route handler.
+         */
+        handler_t m_handler;
+    };
+
+    /**
+     * @brief A type alias for the middleware chain.
+     */
+    using middleware_chain_t = pipeline_t;
+
+    CLUEAPI_INLINE shared::awaitable_t<http::types::response_t> next_t::operator()(
+        const http::types::request_t& request) const {
+        return m_pipeline->run(m_index, request);
+    }
 } // namespace clueapi::middleware
 
 #endif // CLUEAPI_MIDDLEWARE_HXX
\ No newline at end of file
@@ -0,0 +1,715 @@
+/**
+ * @file response_cache.cxx
+ *
+ * @brief Implements the response cache.
+ */
+
+#include "clueapi/middleware/response_cache/response_cache.hxx"
+
+#include "clueapi/http/detail/sv_hash/sv_hash.hxx"
+#include "clueapi/http/range/range.hxx"
+
+#include "clueapi/modules/macros.hxx"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+#include <boost/algorithm/string/case_conv.hpp>
+#include <boost/algorithm/string/find.hpp>
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/algorithm/string/trim.hpp>
+#include <boost/asio/async_result.hpp>
+#include <boost/asio/associated_executor.hpp>
+#include <boost/asio/execution/outstanding_work.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/prefer.hpp>
+#include <boost/asio/use_awaitable.hpp>
+
+#include <fmt/format.h>
+
+namespace clueapi::middleware {
+    namespace {
+        /**
+         * @brief A cached response.
+         */
+        struct entry_t {
+            http::types::status_t::e_status m_status{};
+
+            /**
+             * @brief The headers of the response, its `ETag` included.
+             */
+            http::types::headers_t m_headers{};
+
+            std::string m_etag{};
+
+            http::types::shared_body_t m_body{};
+
+            /**
+             * @brief The size accounted for the entry: its key, headers and body.
+             */
+            std::size_t m_size{};
+
+            std::chrono::steady_clock::time_point m_expires{};
+        };
+
+        using entry_ptr_t = std::shared_ptr<const entry_t>;
+
+        /**
+         * @brief The handler run for a key, and the requests waiting for its response.
+         */
+        struct flight_t {
+            std::mutex m_mutex{};
+
+            bool m_is_done{};
+
+            /**
+             * @brief The cached response, `nullptr` if the response was not cached.
+             */
+            entry_ptr_t m_entry{};
+
+            std::vector<std::function<void()>> m_waiters{};
+        };
+
+        using flight_ptr_t = std::shared_ptr<flight_t>;
+
+        /**
+         * @brief A part of the cache, locked independently of the others.
+         */
+        struct alignas(64) shard_t {
+            struct node_t {
+                std::string m_key;
+
+                entry_ptr_t m_entry;
+            };
+
+            using lru_t = std::list<node_t>;
+
+            std::mutex m_mutex{};
+
+            /**
+             * @brief The entries, the most recently used first.
+             */
+            lru_t m_lru{};
+
+            /**
+             * @brief The entries by key, viewing the keys of the nodes.
+             */
+            shared::unordered_map_t<
+                std::string_view,
+                lru_t::iterator,
+                http::detail::sv_hash_t,
+                http::detail::sv_eq_t>
+                m_index{};
+
+            /**
+             * @brief The handlers running, by key.
+             */
+            shared::unordered_map_t<
+                std::string,
+                flight_ptr_t,
+                http::detail::sv_hash_t,
+                http::detail::sv_eq_t>
+                m_flights{};
+
+            std::size_t m_bytes{};
+        };
+
+        /**
+         * @brief Checks if a comma-separated header value lists a token, case-insensitively.
+         */
+        [[nodiscard]] bool has_token(std::string_view value, std::string_view token) noexcept {
+            while (!value.empty()) {
+                const auto comma = value.find(',');
+
+                auto item = value.substr(0u, comma);
+
+                // `max-age=60` lists `max-age`
+                item = item.substr(0u, item.find('='));
+
+                if (boost::algorithm::iequals(boost::algorithm::trim_copy(item), token))
+                    return true;
+
+                if (comma == std::string_view::npos)
+                    break;
+
+                value.remove_prefix(comma + 1u);
+            }
+
+            return false;
+        }
+
+        /**
+         * @brief Gets the seconds of a `Cache-Control` directive, e.g. `max-age=60`.
+         *
+         * @return The seconds, `std::nullopt` if the directive isn't listed or isn't a number.
+         */
+        [[nodiscard]] std::optional<std::int64_t> directive_seconds(
+            std::string_view value, std::string_view directive) noexcept {
+            while (!value.empty()) {
+                const auto comma = value.find(',');
+
+                const auto item = boost::algorithm::trim_copy(value.substr(0u, comma));
+
+                const auto equals = item.find('=');
+
+                if (equals != std::string_view::npos &&
+                    boost::algorithm::iequals(
+                        boost::algorithm::trim_copy(item.substr(0u, equals)), directive)) {
+                    auto number = boost::algorithm::trim_copy(item.substr(equals + 1u));
+
+                    // The quoted form is invalid, but seen often enough to be accepted
+                    if (number.size() >= 2u && number.front() == '"' && number.back() == '"')
+                        number = number.substr(1u, number.size() - 2u);
+
+                    std::int64_t seconds{};
+
+                    const auto [ptr, ec] =
+                        std::from_chars(number.data(), number.data() + number.size(), seconds);
+
+                    if (ec != std::errc{} || ptr != number.data() + number.size() || seconds < 0)
+                        return std::nullopt;
+
+                    return seconds;
+                }
+
+                if (comma == std::string_view::npos)
+                    break;
+
+                value.remove_prefix(comma + 1u);
+            }
+
+            return std::nullopt;
+        }
+    } // namespace
+
+    class c_response_cache::c_impl {
+       public:
+        CLUEAPI_INLINE explicit c_impl(response_cache_cfg_t cfg) : m_cfg{std::move(cfg)} {
+            m_cfg.m_shards = std::max<std::size_t>(m_cfg.m_shards, 1u);
+
+            m_shards = std::make_unique<shard_t[]>(m_cfg.m_shards);
+
+            m_max_shard_entries = std::max<std::size_t>(m_cfg.m_max_entries / m_cfg.m_shards, 1u);
+
+            m_max_shard_bytes = std::max<std::size_t>(m_cfg.m_max_bytes / m_cfg.m_shards, 1u);
+
+            for (auto& header : m_cfg.m_vary)
+                boost::algorithm::to_lower(header);
+        }
+
+       public:
+        shared::awaitable_t<http::types::response_t> handle(
+            const http::types::request_t& request, next_t next) {
+            const auto method = request.method();
+
+            if (method != http::types::method_t::get && method != http::types::method_t::head)
+                co_return co_await next(request);
+
+            if (!is_cached_path(request.uri()))
+                co_return co_await next(request);
+
+            // A shared cache would serve the response of a user to the others
+            if (!m_cfg.m_cache_credentials && has_credentials(request))
+                co_return co_await next(request);
+
+            auto key = make_key(request);
+
+            auto& shard = m_shards[http::detail::sv_hash_t{}(key) % m_cfg.m_shards];
+
+            entry_ptr_t entry{};
+
+            flight_ptr_t flight{};
+
+            bool is_leader{};
+
+            {
+                std::lock_guard lock{shard.m_mutex};
+
+                entry = find(shard, key);
+
+                // A `HEAD` response has no body to cache, only `GET` requests fill the cache
+                if (!entry && m_cfg.m_collapse && method == http::types::method_t::get) {
+                    auto [it, inserted] = shard.m_flights.try_emplace(key);
+
+                    if (inserted)
+                        it->second = std::make_shared<flight_t>();
+
+                    flight = it->second;
+
+                    is_leader = inserted;
+                }
+            }
+
+            if (entry) {
+                m_hits.fetch_add(1u, std::memory_order_relaxed);
+
+                co_return respond(request, *entry);
+            }
+
+            if (flight && !is_leader) {
+                m_collapsed.fetch_add(1u, std::memory_order_relaxed);
+
+                co_await wait(*flight);
+
+                if (flight->m_entry) {
+                    m_hits.fetch_add(1u, std::memory_order_relaxed);
+
+                    co_return respond(request, *flight->m_entry);
+                }
+            }
+
+            m_misses.fetch_add(1u, std::memory_order_relaxed);
+
+            if (method != http::types::method_t::get)
+                co_return co_await next(request);
+
+            // Releases the waiters even if the handler throws or the request is destroyed
+            landing_t landing{*this, shard, key, is_leader ? std::move(flight) : nullptr};
+
+            auto response = co_await next(request);
+
+            entry = make_entry(key, response);
+
+            if (!entry)
+                co_return response;
+
+            insert(shard, key, entry);
+
+            landing.release(entry);
+
+            co_return respond(request, *entry);
+        }
+
+        void clear() noexcept {
+            for (std::size_t i{}; i < m_cfg.m_shards; i++) {
+                auto& shard = m_shards[i];
+
+                std::lock_guard lock{shard.m_mutex};
+
+                m_entries.fetch_sub(shard.m_index.size(), std::memory_order_relaxed);
+
+                m_bytes.fetch_sub(shard.m_bytes, std::memory_order_relaxed);
+
+                shard.m_index.clear();
+
+                shard.m_lru.clear();
+
+                shard.m_bytes = 0u;
+            }
+        }
+
+        [[nodiscard]] CLUEAPI_INLINE std::size_t cached_entries() const noexcept {
+            return m_entries.load(std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] CLUEAPI_INLINE std::size_t cached_bytes() const noexcept {
+            return m_bytes.load(std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] CLUEAPI_INLINE std::uint64_t hits() const noexcept {
+            return m_hits.load(std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] CLUEAPI_INLINE std::uint64_t misses() const noexcept {
+            return m_misses.load(std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] CLUEAPI_INLINE std::uint64_t collapsed() const noexcept {
+            return m_collapsed.load(std::memory_order_relaxed);
+        }
+
+       private:
+        /**
+         * @brief Ends the flight of a leader, waking the requests waiting for it.
+         */
+        struct landing_t {
+            CLUEAPI_INLINE landing_t(
+                c_impl& self, shard_t& shard, std::string_view key, flight_ptr_t flight) noexcept
+                : m_self{self}, m_shard{shard}, m_key{key}, m_flight{std::move(flight)} {
+            }
+
+            CLUEAPI_INLINE ~landing_t() noexcept {
+                release(nullptr);
+            }
+
+            // Copy constructor
+            CLUEAPI_INLINE landing_t(const landing_t&) = delete;
+
+            // Copy assignment operator
+            CLUEAPI_INLINE landing_t& operator=(const landing_t&) = delete;
+
+            /**
+             * @brief Hands the cached response, if any, to the waiters.
+             */
+            CLUEAPI_INLINE void release(entry_ptr_t entry) noexcept {
+                if (!m_flight)
+                    return;
+
+                m_self.land(m_shard, m_key, *m_flight, std::move(entry));
+
+                m_flight.reset();
+            }
+
+            c_impl& m_self;
+
+            shard_t& m_shard;
+
+            std::string_view m_key;
+
+            flight_ptr_t m_flight;
+        };
+
+        [[nodiscard]] bool is_cached_path(std::string_view uri) const noexcept {
+            if (m_cfg.m_prefixes.empty())
+                return true;
+
+            return std::any_of(
+                m_cfg.m_prefixes.begin(), m_cfg.m_prefixes.end(), [uri](const auto& prefix) {
+                    return uri.starts_with(prefix);
+                });
+        }
+
+        [[nodiscard]] static bool has_credentials(const http::types::request_t& request) noexcept {
+            return request.header(http::types::e_header::authorization).has_value() ||
+                   request.header(http::types::e_header::cookie).has_value();
+        }
+
+        [[nodiscard]] std::string make_key(const http::types::request_t& request) const {
+            std::string ret{request.uri()};
+
+            for (const auto& header : m_cfg.m_vary) {
+                ret.push_back('\n');
+
+                if (const auto value = request.header(header); value.has_value())
+                    ret.append(*value);
+            }
+
+            return ret;
+        }
+
+        /**
+         * @brief Gets the current time of the configured clock.
+         */
+        [[nodiscard]] std::chrono::steady_clock::time_point now() const {
+            return m_cfg.m_clock ? m_cfg.m_clock() : std::chrono::steady_clock::now();
+        }
+
+        /**
+         * @brief Looks a key up with the lock of its shard held, dropping it if it expired.
+         */
+        entry_ptr_t find(shard_t& shard, std::string_view key) noexcept {
+            const auto it = shard.m_index.find(key);
+
+            if (it == shard.m_index.end())
+                return nullptr;
+
+            const auto node = it->second;
+
+            if (node->m_entry->m_expires <= now()) {
+                erase(shard, it);
+
+                return nullptr;
+            }
+
+            shard.m_lru.splice(shard.m_lru.begin(), shard.m_lru, node);
+
+            return node->m_entry;
+        }
+
+        void erase(shard_t& shard, decltype(shard_t::m_index)::iterator it) noexcept {
+            const auto node = it->second;
+
+            shard.m_bytes -= node->m_entry->m_size;
+
+            m_bytes.fetch_sub(node->m_entry->m_size, std::memory_order_relaxed);
+
+            m_entries.fetch_sub(1u, std::memory_order_relaxed);
+
+            shard.m_index.erase(it);
+
+            shard.m_lru.erase(node);
+        }
+
+        void insert(shard_t& shard, const std::string& key, const entry_ptr_t& entry) {
+            if (entry->m_size > m_max_shard_bytes)
+                return;
+
+            std::lock_guard lock{shard.m_mutex};
+
+            if (const auto it = shard.m_index.find(key); it != shard.m_index.end())
+                erase(shard, it);
+
+            while (!shard.m_lru.empty() && (shard.m_index.size() >= m_max_shard_entries ||
+                                            shard.m_bytes + entry->m_size > m_max_shard_bytes))
+                erase(shard, shard.m_index.find(shard.m_lru.back().m_key));
+
+            shard.m_lru.push_front(shard_t::node_t{key, entry});
+
+            shard.m_index.emplace(shard.m_lru.front().m_key, shard.m_lru.begin());
+
+            shard.m_bytes += entry->m_size;
+
+            m_bytes.fetch_add(entry->m_size, std::memory_order_relaxed);
+
+            m_entries.fetch_add(1u, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Makes the entry of a response if it may be cached, its body moved to a shared
+         * body.
+         */
+        [[nodiscard]] entry_ptr_t make_entry(
+            std::string_view key, http::types::response_t& response) const {
+            if (response.status() != http::types::status_t::ok || response.is_stream() ||
+                response.file().has_value() || !response.cookies().empty())
+                return nullptr;
+
+            const auto& headers = response.headers();
+
+            if (headers.contains("Set-Cookie"))
+                return nullptr;
+
+            auto ttl = m_cfg.m_ttl;
+
+            if (const auto it = headers.find("Cache-Control"); it != headers.end()) {
+                // `no-cache` allows storing, but every use would have to be revalidated
+                if (has_token(it->second, "no-store") || has_token(it->second, "private") ||
+                    has_token(it->second, "no-cache"))
+                    return nullptr;
+
+                auto max_age = directive_seconds(it->second, "s-maxage");
+
+                if (!max_age)
+                    max_age = directive_seconds(it->second, "max-age");
+
+                if (max_age) {
+                    if (*max_age == 0)
+                        return nullptr;
+
+                    // Compared in seconds, so that a large one can't overflow
+                    const auto ttl_seconds =
+                        std::chrono::duration_cast<std::chrono::seconds>(ttl).count();
+
+                    if (*max_age <= ttl_seconds)
+                        ttl = std::chrono::duration_cast<std::chrono::milliseconds>(
+                            std::chrono::seconds{*max_age});
+                }
+            }
+
+            if (const auto it = headers.find("Vary"); it != headers.end() && !is_varied(it->second))
+                return nullptr;
+
+            auto& shared_body = response.shared_body();
+
+            if (!shared_body) {
+                if (response.body().size() > m_cfg.m_max_body_size)
+                    return nullptr;
+
+                auto body = std::make_shared<std::string>(std::move(response.body()));
+
+                response.body().clear();
+
+                shared_body = http::types::shared_body_t{*body, std::move(body)};
+            } else if (shared_body.m_data.size() > m_cfg.m_max_body_size)
+                return nullptr;
+
+            auto entry = std::make_shared<entry_t>();
+
+            entry->m_status = response.status();
+
+            entry->m_headers = std::move(response.headers());
+
+            entry->m_body = shared_body;
+
+            if (const auto it = entry->m_headers.find("ETag"); it != entry->m_headers.end())
+                entry->m_etag = it->second;
+            else {
+                entry->m_etag = fmt::format(
+                    "\"{:016x}\"", ankerl::unordered_dense::hash<std::string_view>{}(
+                                       entry->m_body.m_data));
+
+                entry->m_headers.emplace("ETag", entry->m_etag);
+            }
+
+            entry->m_size = key.size() + entry->m_body.m_data.size();
+
+            for (const auto& [name, value] : entry->m_headers)
+                entry->m_size += name.size() + value.size();
+
+            entry->m_expires = now() + ttl;
+
+            return entry;
+        }
+
+        /**
+         * @brief Checks if every header a `Vary` names keys the entries.
+         */
+        [[nodiscard]] bool is_varied(std::string_view vary) const {
+            while (!vary.empty()) {
+                const auto comma = vary.find(',');
+
+                auto name = boost::algorithm::to_lower_copy(
+                    boost::algorithm::trim_copy(std::string{vary.substr(0u, comma)}));
+
+                if (!name.empty() &&
+                    std::find(m_cfg.m_vary.begin(), m_cfg.m_vary.end(), name) ==
+                        m_cfg.m_vary.end())
+                    return false;
+
+                if (comma == std::string_view::npos)
+                    break;
+
+                vary.remove_prefix(comma + 1u);
+            }
+
+            return true;
+        }
+
+        /**
+         * @brief Builds the response of a request from an entry.
+         */
+        [[nodiscard]] static http::types::response_t respond(
+            const http::types::request_t& request, const entry_t& entry) {
+            if (const auto if_none_match = request.header(http::types::e_header::if_none_match);
+                if_none_match && http::range::range_t::none_match(*if_none_match, entry.m_etag)) {
+                http::types::response_t response{};
+
+                response.status() = http::types::status_t::not_modified;
+
+                for (const auto* name : {"ETag", "Cache-Control", "Vary"}) {
+                    if (const auto it = entry.m_headers.find(name); it != entry.m_headers.end())
+                        response.headers().insert_or_assign(it->first, it->second);
+                }
+
+                return response;
+            }
+
+            http::types::response_t response{"", entry.m_status, entry.m_headers};
+
+            response.shared_body() = entry.m_body;
+
+            return response;
+        }
+
+        /**
+         * @brief Suspends a request until the leader of its flight lands.
+         */
+        static shared::awaitable_t<void> wait(flight_t& flight) {
+            co_await boost::asio::async_initiate<const boost::asio::use_awaitable_t<>&, void()>(
+                [&flight](auto handler) {
+                    auto executor = boost::asio::prefer(
+                        boost::asio::get_associated_executor(handler),
+                        boost::asio::execution::outstanding_work.tracked);
+
+                    auto resume = [executor,
+                                   handler = std::make_shared<decltype(handler)>(
+                                       std::move(handler))]() {
+                        boost::asio::post(executor, [handler]() { std::move (*handler)(); });
+                    };
+
+                    {
+                        std::lock_guard lock{flight.m_mutex};
+
+                        if (!flight.m_is_done) {
+                            flight.m_waiters.emplace_back(std::move(resume));
+
+                            return;
+                        }
+                    }
+
+                    resume();
+                },
+
+                boost::asio::use_awaitable);
+        }
+
+        /**
+         * @brief Ends a flight, its later misses starting a new one.
+         */
+        void land(
+            shard_t& shard, std::string_view key, flight_t& flight, entry_ptr_t entry) noexcept {
+            {
+                std::lock_guard lock{shard.m_mutex};
+
+                if (const auto it = shard.m_flights.find(key); it != shard.m_flights.end())
+                    shard.m_flights.erase(it);
+            }
+
+            std::vector<std::function<void()>> waiters{};
+
+            {
+                std::lock_guard lock{flight.m_mutex};
+
+                flight.m_is_done = true;
+
+                flight.m_entry = std::move(entry);
+
+                waiters.swap(flight.m_waiters);
+            }
+
+            for (auto& waiter : waiters)
+                waiter();
+        }
+
+       private:
+        response_cache_cfg_t m_cfg;
+
+        std::unique_ptr<shard_t[]> m_shards;
+
+        std::size_t m_max_shard_entries{};
+
+        std::size_t m_max_shard_bytes{};
+
+        std::atomic<std::size_t> m_entries{};
+
+        std::atomic<std::size_t> m_bytes{};
+
+        std::atomic<std::uint64_t> m_hits{};
+
+        std::atomic<std::uint64_t> m_misses{};
+
+        std::atomic<std::uint64_t> m_collapsed{};
+    };
+
+    c_response_cache::c_response_cache(response_cache_cfg_t cfg)
+        : m_impl{std::make_unique<c_impl>(std::move(cfg))} {
+    }
+
+    c_response_cache::~c_response_cache() noexcept = default;
+
+    shared::awaitable_t<http::types::response_t> c_response_cache::handle(
+        const http::types::request_t& request, next_t next) {
+        return m_impl->handle(request, next);
+    }
+
+    void c_response_cache::clear() noexcept {
+        m_impl->clear();
+    }
+
+    std::size_t c_response_cache::cached_entries() const noexcept {
+        return m_impl->cached_entries();
+    }
+
+    std::size_t c_response_cache::cached_bytes() const noexcept {
+        return m_impl->cached_bytes();
+    }
+
+    std::uint64_t c_response_cache::hits() const noexcept {
+        return m_impl->hits();
+    }
+
+    std::uint64_t c_response_cache::misses() const noexcept {
+        return m_impl->misses();
+    }
+
+    std::uint64_t c_response_cache::collapsed() const noexcept {
+        return m_impl->collapsed();
+    }
+} // namespace clueapi::middleware
@@ -0,0 +1,208 @@
+/**
+ * @file response_cache.hxx
+ *
+ * @brief Defines a middleware that keeps the responses of `GET` requests in memory for a while.
+ */
+
+#ifndef CLUEAPI_MIDDLEWARE_RESPONSE_CACHE_HXX
+#define CLUEAPI_MIDDLEWARE_RESPONSE_CACHE_HXX
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "clueapi/http/types/request/request.hxx"
+#include "clueapi/http/types/response/response.hxx"
+
+#include "clueapi/middleware/middleware.hxx"
+
+#include "clueapi/shared/macros.hxx"
+#include "clueapi/shared/shared.hxx"
+
+namespace clueapi::middleware {
+    /**
+     * @struct response_cache_cfg_t
+     *
+     * @brief The settings of a response cache.
+     */
+    struct response_cache_cfg_t {
+        /**
+         * @brief The URL prefixes of the cached requests (e.g., "/api/catalog/"), empty to cache
+         * every path.
+         */
+        std::vector<std::string> m_prefixes{};
+
+        /**
+         * @brief The request headers whose values key the responses besides the request target
+         * (e.g., "Accept-Encoding", "Accept-Language").
+         *
+         * @note A response whose `Vary` names another header, or `*`, is not cached.
+         */
+        std::vector<std::string> m_vary{};
+
+        /**
+         * @brief If true, the requests with an `Authorization` or a `Cookie` header are cached
+         * too, instead of passed on.
+         *
+         * @note Such responses are usually made for their user. Name the headers in `m_vary`
+         * unless the handler answers every user alike.
+         */
+        bool m_cache_credentials{false};
+
+        /**
+         * @brief How long a response is served from the cache.
+         *
+         * @note A response's `Cache-Control: s-maxage`, or else `max-age`, shortens it.
+         */
+        std::chrono::milliseconds m_ttl{1000};
+
+        /**
+         * @brief The number of responses kept, the least recently used are evicted past it.
+         */
+        std::size_t m_max_entries{4096u};
+
+        /**
+         * @brief The total size of the responses kept, the least recently used are evicted past
+         * it.
+         */
+        std::size_t m_max_bytes{64ull * 1024u * 1024u};
+
+        /**
+         * @brief The largest body cached.
+         */
+        std::size_t m_max_body_size{1024ull * 1024u};
+
+        /**
+         * @brief The number of independently locked parts of the cache.
+         */
+        std::size_t m_shards{16u};
+
+        /**
+         * @brief Whether the requests missing the same key wait for the first one instead of
+         * each running the handler.
+         */
+        bool m_collapse{true};
+
+        /**
+         * @brief The clock the expiry of the responses is measured with,
+         * `std::chrono::steady_clock::now` if empty.
+         *
+         * @note Meant for tests, which advance the time instead of waiting for it.
+         */
+        std::function<std::chrono::steady_clock::time_point()> m_clock{};
+    };
+
+    /**
+     * @class c_response_cache
+     *
+     * @brief Serves the responses of `GET` requests from memory until they expire.
+     *
+     * @details A response is keyed by the request target, query included, and the values of
+     * `response_cache_cfg_t::m_vary`. It is kept with its headers, an `ETag` computed from the
+     * body if the handler set none, and its body shared by the responses that send it, so a hit
+     * copies no byte of the body. `If-None-Match` is answered with `304 Not Modified` from the
+     * entry. `HEAD` requests are served from the entries of `GET` ones.
+     *
+     * The entries are spread over shards, each a lock-protected LRU list bounded by its part of
+     * `m_max_entries` and `m_max_bytes`. With `m_collapse`, the requests that miss a key while
+     * its handler runs wait for its response rather than running the handler too. If the
+     * response is not cached, they run the handler themselves once it is done.
+     *
+     * Only `200 OK` responses with an in-memory body are cached, without cookies and without
+     * `Cache-Control: no-store`, `no-cache` or `private`. The requests with credentials,
+     * `Authorization` or `Cookie`, are passed on unless `m_cache_credentials` is set (RFC 9111,
+     * section 3.5).
+     *
+     * @note Placed after the middlewares that authenticate or rewrite the request, it only sees
+     * the requests they let through.
+     */
+    class c_response_cache final : public c_base_middleware {
+       public:
+        /**
+         * @brief Constructs a response cache.
+         *
+         * @param cfg The settings of the cache.
+         */
+        explicit c_response_cache(response_cache_cfg_t cfg = {});
+
+        ~c_response_cache() noexcept override;
+
+       public:
+        /**
+         * @brief Serves the request from the cache, or passes it on and caches the response.
+         *
+         * @param request The incoming HTTP request.
+         * @param next The continuation of the pipeline.
+         *
+         * @return An awaitable that resolves to the response.
+         */
+        shared::awaitable_t<http::types::response_t> handle(
+            const http::types::request_t& request,
+
+            next_t next) override;
+
+        /**
+         * @brief Drops every cached response.
+         */
+        void clear() noexcept;
+
+       public:
+        /**
+         * @brief Gets the number of cached responses.
+         *
+         * @return The number of entries.
+         */
+        [[nodiscard]] std::size_t cached_entries() const noexcept;
+
+        /**
+         * @brief Gets the total size of the cached responses.
+         *
+         * @return The size in bytes.
+         */
+        [[nodiscard]] std::size_t cached_bytes() const noexcept;
+
+        /**
+         * @brief Gets the number of requests served from the cache.
+         *
+         * @return The number of hits, collapsed requests included.
+         */
+        [[nodiscard]] std::uint64_t hits() const noexcept;
+
+        /**
+         * @brief Gets the number of requests that ran the handler.
+         *
+         * @return The number of misses.
+         */
+        [[nodiscard]] std::uint64_t misses() const noexcept;
+
+        /**
+         * @brief Gets the number of requests that waited for a handler another request ran.
+         *
+         * @return The number of collapsed requests.
+         */
+        [[nodiscard]] std::uint64_t collapsed() const noexcept;
+
+       private:
+        /**
+         * @class c_impl
+         *
+         * @brief The internal implementation of the `c_response_cache` class.
+         *
+         * @internal
+         */
+        class c_impl;
+
+        /**
+         * @brief The internal implementation of the `c_response_cache` class.
+         *
+         * @internal
+         */
+        std::unique_ptr<c_impl> m_impl;
+    };
+} // namespace clueapi::middleware
+
+#endif // CLUEAPI_MIDDLEWARE_RESPONSE_CACHE_HXX
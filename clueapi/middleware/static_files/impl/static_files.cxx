@@ -0,0 +1,812 @@
+/**
+ * @file static_files.cxx
+ *
+ * @brief Implements the static directory mount.
+ */
+
+#include "clueapi/middleware/static_files/static_files.hxx"
+
+#include "clueapi/exceptions/exceptions.hxx"
+
+#include "clueapi/http/detail/sv_hash/sv_hash.hxx"
+#include "clueapi/http/mime/mime.hxx"
+#include "clueapi/http/range/range.hxx"
+
+#include "clueapi/modules/macros.hxx"
+
+#include "clueapi/shared/date_cache/date_cache.hxx"
+
+#include <array>
+#include <atomic>
+#include <ctime>
+#include <fstream>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <boost/filesystem/operations.hpp>
+
+#include <fmt/format.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#endif
+
+namespace clueapi::middleware {
+    namespace {
+        /**
+         * @brief The metadata and the prebuilt response parts of a path of the mount.
+         */
+        struct entry_t {
+            boost::filesystem::path m_path{};
+
+            std::uint64_t m_size{};
+
+            std::time_t m_mtime{};
+
+            std::string m_etag{};
+
+            http::types::headers_t m_headers{};
+
+            http::types::shared_body_t m_body{};
+
+            /**
+             * @brief The last time the entry was checked, for mounts that aren't watched.
+             */
+            mutable std::atomic<std::chrono::steady_clock::rep> m_checked{};
+
+            bool m_found{};
+
+            bool m_watched{};
+        };
+
+        using entry_ptr_t = std::shared_ptr<const entry_t>;
+
+        /**
+         * @brief A cached path and its entry.
+         */
+        struct node_t {
+            std::string m_key;
+
+            entry_ptr_t m_entry;
+        };
+
+        using lru_t = std::list<node_t>;
+
+        using index_t = shared::unordered_map_t<
+            std::string_view,
+            lru_t::iterator,
+            http::detail::sv_hash_t,
+            http::detail::sv_eq_t>;
+
+        /**
+         * @brief The metadata of a file or a directory.
+         */
+        struct file_stat_t {
+            std::uint64_t m_size{};
+
+            std::time_t m_mtime{};
+
+            bool m_is_dir{};
+        };
+
+        std::optional<file_stat_t> stat_path(const boost::filesystem::path& path) noexcept {
+#if defined(__unix__) || defined(__APPLE__)
+            struct stat st{};
+
+            if (::stat(path.c_str(), &st) != 0)
+                return std::nullopt;
+
+            if (!S_ISREG(st.st_mode) && !S_ISDIR(st.st_mode))
+                return std::nullopt;
+
+            return file_stat_t{
+                static_cast<std::uint64_t>(st.st_size), st.st_mtime, S_ISDIR(st.st_mode)};
+#else
+            boost::system::error_code ec{};
+
+            const auto status = boost::filesystem::status(path, ec);
+
+            if (ec)
+                return std::nullopt;
+
+            if (boost::filesystem::is_directory(status))
+                return file_stat_t{0u, 0, true};
+
+            if (!boost::filesystem::is_regular_file(status))
+                return std::nullopt;
+
+            const auto size = boost::filesystem::file_size(path, ec);
+
+            if (ec)
+                return std::nullopt;
+
+            const auto mtime = boost::filesystem::last_write_time(path, ec);
+
+            if (ec)
+                return std::nullopt;
+
+            return file_stat_t{size, mtime, false};
+#endif
+        }
+
+        /**
+         * @brief Reads a file into memory.
+         */
+        http::types::shared_body_t read_body(
+            const boost::filesystem::path& path, std::size_t size) {
+            auto body = std::make_shared<std::string>(size, '\0');
+
+            std::ifstream file{path.string(), std::ios::binary};
+
+            if (!file.read(body->data(), static_cast<std::streamsize>(size)))
+                return {};
+
+            return http::types::shared_body_t{*body, std::move(body)};
+        }
+
+#if defined(__unix__) || defined(__APPLE__)
+        /**
+         * @brief Maps a file into memory.
+         */
+        http::types::shared_body_t map_body(
+            const boost::filesystem::path& path, std::size_t size) {
+            if (size == 0u)
+                return read_body(path, size);
+
+            const auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+            if (fd < 0)
+                return {};
+
+            auto* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+            ::close(fd);
+
+            if (data == MAP_FAILED)
+                return {};
+
+            std::shared_ptr<const void> owner{data, [size](const void* p) {
+                                                  ::munmap(const_cast<void*>(p), size);
+                                              }};
+
+            return http::types::shared_body_t{
+                std::string_view{static_cast<const char*>(data), size}, std::move(owner)};
+        }
+#endif
+
+        CLUEAPI_INLINE int hex_value(char c) noexcept {
+            if (c >= '0' && c <= '9')
+                return c - '0';
+
+            if (c >= 'a' && c <= 'f')
+                return c - 'a' + 10;
+
+            if (c >= 'A' && c <= 'F')
+                return c - 'A' + 10;
+
+            return -1;
+        }
+
+        /**
+         * @brief Maps the path of a request to a path relative to the mount.
+         *
+         * @return The relative path without leading or trailing slashes, `std::nullopt` if the
+         * request is outside of the mount or names something that is never served.
+         *
+         * @details `%xx` escapes are decoded (`+` is a plain character in a path). Segments that
+         * are empty, `..` or hidden (starting with a dot) are refused.
+         */
+        std::optional<std::string> resolve(std::string_view prefix, std::string_view uri) {
+            uri = uri.substr(0, uri.find_first_of("?#"));
+
+            if (!uri.starts_with(prefix))
+                return std::nullopt;
+
+            uri.remove_prefix(prefix.size());
+
+            if (!uri.empty() && uri.front() != '/')
+                return std::nullopt;
+
+            std::string rel{};
+
+            rel.reserve(uri.size());
+
+            for (std::size_t i{}; i < uri.size(); ++i) {
+                auto c = uri[i];
+
+                if (c == '%') {
+                    if (i + 2u >= uri.size())
+                        return std::nullopt;
+
+                    const auto hi = hex_value(uri[i + 1u]);
+                    const auto lo = hex_value(uri[i + 2u]);
+
+                    if (hi < 0 || lo < 0)
+                        return std::nullopt;
+
+                    c = static_cast<char>((hi << 4) | lo);
+
+                    i += 2u;
+                }
+
+                if (c == '\0' || c == '\\')
+                    return std::nullopt;
+
+                rel.push_back(c);
+            }
+
+            while (!rel.empty() && rel.front() == '/')
+                rel.erase(rel.begin());
+
+            while (!rel.empty() && rel.back() == '/')
+                rel.pop_back();
+
+            for (std::size_t begin{}; begin < rel.size();) {
+                auto end = rel.find('/', begin);
+
+                if (end == std::string::npos)
+                    end = rel.size();
+
+                const auto segment = std::string_view{rel}.substr(begin, end - begin);
+
+                if (segment.empty() || segment.front() == '.')
+                    return std::nullopt;
+
+                begin = end + 1u;
+            }
+
+            return rel;
+        }
+
+        CLUEAPI_INLINE std::string_view parent_of(std::string_view rel) noexcept {
+            const auto slash = rel.rfind('/');
+
+            return slash == std::string_view::npos ? std::string_view{} : rel.substr(0, slash);
+        }
+
+        CLUEAPI_INLINE std::chrono::steady_clock::rep steady_now() noexcept {
+            return std::chrono::steady_clock::now().time_since_epoch().count();
+        }
+    } // namespace
+
+    class c_static_files::c_impl {
+       public:
+        CLUEAPI_INLINE c_impl(
+            http::types::path_t prefix, boost::filesystem::path root, static_files_cfg_t cfg)
+            : m_prefix{std::move(prefix)}, m_root{std::move(root)}, m_cfg{std::move(cfg)} {
+            while (!m_prefix.empty() && m_prefix.back() == '/')
+                m_prefix.pop_back();
+
+            if (m_cfg.m_max_entries == 0u)
+                m_cfg.m_max_entries = 1u;
+
+#if defined(__linux__)
+            if (m_cfg.m_watch) {
+                m_inotify_fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+                if (m_inotify_fd < 0)
+                    CLUEAPI_LOG_WARNING(
+                        "Can't watch {}, the files are revalidated instead", m_root.string());
+            }
+#endif
+
+            CLUEAPI_LOG_DEBUG("Mounted {} at {}/", m_root.string(), m_prefix);
+        }
+
+        CLUEAPI_INLINE ~c_impl() noexcept {
+#if defined(__linux__)
+            if (m_inotify_fd >= 0)
+                ::close(m_inotify_fd);
+#endif
+        }
+
+       public:
+        shared::awaitable_t<http::types::response_t> handle(
+            const http::types::request_t& request, next_t next) {
+            const auto method = request.method();
+
+            if (method != http::types::method_t::get && method != http::types::method_t::head)
+                co_return co_await next(request);
+
+            const auto rel = resolve(m_prefix, request.uri());
+
+            if (!rel.has_value())
+                co_return co_await next(request);
+
+            const auto entry = lookup(*rel);
+
+            if (!entry->m_found)
+                co_return co_await next(request);
+
+            // Responses from files on disk are answered with 304 and ranges by the server
+            if (!entry->m_body)
+                co_return http::types::file_response_t{
+                    http::types::file_body_t{entry->m_path, entry->m_size},
+                    http::types::status_t::ok,
+                    entry->m_headers};
+
+            if (const auto if_none_match = request.header(http::types::e_header::if_none_match);
+                if_none_match && http::range::range_t::none_match(*if_none_match, entry->m_etag)) {
+                http::types::response_t response{};
+
+                response.status() = http::types::status_t::not_modified;
+
+                response.headers().insert_or_assign("ETag", entry->m_etag);
+
+                if (!m_cfg.m_cache_control.empty())
+                    response.headers().insert_or_assign("Cache-Control", m_cfg.m_cache_control);
+
+                co_return response;
+            }
+
+            if (request.header(http::types::e_header::range).has_value())
+                co_return http::types::file_response_t{
+                    http::types::file_body_t{entry->m_path, entry->m_size},
+                    http::types::status_t::ok,
+                    entry->m_headers};
+
+            http::types::response_t response{"", http::types::status_t::ok, entry->m_headers};
+
+            response.shared_body() = entry->m_body;
+
+            co_return response;
+        }
+
+        [[nodiscard]] CLUEAPI_INLINE std::size_t cached_entries() const noexcept {
+            std::shared_lock lock{m_mutex};
+
+            return m_index.size();
+        }
+
+        [[nodiscard]] CLUEAPI_INLINE std::size_t cached_bytes() const noexcept {
+            return m_bytes.load(std::memory_order_relaxed);
+        }
+
+       private:
+        entry_ptr_t lookup(const std::string& rel) {
+            poll_watch();
+
+            entry_ptr_t cached{};
+
+            {
+                std::shared_lock lock{m_mutex};
+
+                if (const auto it = m_index.find(rel); it != m_index.end()) {
+                    cached = it->second->m_entry;
+
+                    // The readers only move the node, the list is changed by the writers alone
+                    std::lock_guard lru_lock{m_lru_mutex};
+
+                    m_lru.splice(m_lru.begin(), m_lru, it->second);
+                }
+            }
+
+            if (cached && is_fresh(*cached))
+                return cached;
+
+            auto entry = load(rel, cached);
+
+            if (entry == cached)
+                return entry;
+
+            std::unique_lock lock{m_mutex};
+
+            invalidate(rel, false);
+
+            // A missing path isn't kept, requests for made-up paths would push the files out
+            if (!entry->m_found)
+                return entry;
+
+            while (!m_lru.empty() && m_index.size() >= m_cfg.m_max_entries)
+                erase(m_index.find(m_lru.back().m_key));
+
+            m_lru.push_front(node_t{rel, entry});
+
+            m_index.emplace(m_lru.front().m_key, m_lru.begin());
+
+            return entry;
+        }
+
+        /**
+         * @brief Checks if a cached entry may be used without looking at the file.
+         */
+        bool is_fresh(const entry_t& entry) const noexcept {
+            if (entry.m_watched)
+                return true;
+
+            const auto revalidate =
+                std::chrono::duration_cast<std::chrono::steady_clock::duration>(m_cfg.m_revalidate)
+                    .count();
+
+            return steady_now() - entry.m_checked.load(std::memory_order_relaxed) < revalidate;
+        }
+
+        /**
+         * @brief Builds the entry of a path, or revalidates the cached one.
+         *
+         * @return The cached entry if the file didn't change, a new entry otherwise.
+         */
+        entry_ptr_t load(const std::string& rel, const entry_ptr_t& cached) {
+            auto path = rel.empty() ? m_root : m_root / rel;
+
+            auto stat = stat_path(path);
+
+            const auto is_index = stat.has_value() && stat->m_is_dir;
+
+            if (is_index) {
+                if (m_cfg.m_index.empty())
+                    stat.reset();
+                else {
+                    path /= m_cfg.m_index;
+
+                    stat = stat_path(path);
+
+                    if (stat.has_value() && stat->m_is_dir)
+                        stat.reset();
+                }
+            }
+
+            if (cached && cached->m_found == stat.has_value() &&
+                (!stat.has_value() ||
+                 (cached->m_size == stat->m_size && cached->m_mtime == stat->m_mtime))) {
+                cached->m_checked.store(steady_now(), std::memory_order_relaxed);
+
+                return cached;
+            }
+
+            auto entry = std::make_shared<entry_t>();
+
+            entry->m_checked.store(steady_now(), std::memory_order_relaxed);
+
+            // A directory entry also depends on its own index file
+            entry->m_watched = watch(parent_of(rel)) && (!is_index || watch(rel));
+
+            if (!stat.has_value())
+                return entry;
+
+            entry->m_found = true;
+
+            entry->m_path = std::move(path);
+
+            entry->m_size = stat->m_size;
+
+            entry->m_mtime = stat->m_mtime;
+
+            entry->m_etag = fmt::format("\"{}-{}\"", stat->m_mtime, stat->m_size);
+
+            {
+                auto& headers = entry->m_headers;
+
+                headers.emplace("Content-Type", http::mime::mime_t::mime_type(entry->m_path));
+
+                headers.emplace("ETag", entry->m_etag);
+
+                shared::date_cache_t::buffer_t buffer{};
+
+                headers.emplace(
+                    "Last-Modified", shared::date_cache_t::format(stat->m_mtime, buffer));
+
+                if (!m_cfg.m_cache_control.empty())
+                    headers.emplace("Cache-Control", m_cfg.m_cache_control);
+            }
+
+            if (stat->m_size <= m_cfg.m_max_memory_file_size && reserve(stat->m_size)) {
+#if defined(__unix__) || defined(__APPLE__)
+                entry->m_body = m_cfg.m_use_mmap ? map_body(entry->m_path, stat->m_size)
+                                                 : read_body(entry->m_path, stat->m_size);
+#else
+                entry->m_body = read_body(entry->m_path, stat->m_size);
+#endif
+
+                // The file changed while it was read, it is served from disk until it settles
+                if (!entry->m_body || entry->m_body.m_data.size() != stat->m_size) {
+                    entry->m_body = {};
+
+                    m_bytes.fetch_sub(stat->m_size, std::memory_order_relaxed);
+                }
+            }
+
+            return entry;
+        }
+
+        /**
+         * @brief Takes room in the memory budget.
+         */
+        bool reserve(std::size_t size) noexcept {
+            const auto total = m_bytes.fetch_add(size, std::memory_order_relaxed) + size;
+
+            if (total <= m_cfg.m_memory_budget)
+                return true;
+
+            m_bytes.fetch_sub(size, std::memory_order_relaxed);
+
+            return false;
+        }
+
+        /**
+         * @brief Gives back the room an entry took in the memory budget.
+         */
+        CLUEAPI_INLINE void release(const entry_t& entry) noexcept {
+            if (entry.m_body)
+                m_bytes.fetch_sub(entry.m_body.m_data.size(), std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Drops an entry, with the lock held.
+         */
+        void erase(index_t::iterator it) noexcept {
+            const auto node = it->second;
+
+            release(*node->m_entry);
+
+            m_index.erase(it);
+
+            m_lru.erase(node);
+        }
+
+        /**
+         * @brief Drops every entry, with the lock held.
+         */
+        void clear() noexcept {
+            for (const auto& node : m_lru)
+                release(*node.m_entry);
+
+            m_index.clear();
+
+            m_lru.clear();
+        }
+
+        /**
+         * @brief Drops an entry and the entries below it, with the lock held.
+         */
+        void invalidate(std::string_view rel, bool recursive) {
+            if (const auto it = m_index.find(rel); it != m_index.end())
+                erase(it);
+
+            if (!recursive)
+                return;
+
+            std::vector<std::string> below{};
+
+            for (const auto& [key, _] : m_index) {
+                if (rel.empty() || (key.size() > rel.size() && key.starts_with(rel) &&
+                                    key[rel.size()] == '/'))
+                    below.emplace_back(key);
+            }
+
+            for (const auto& key : below)
+                invalidate(key, false);
+        }
+
+        /**
+         * @brief Watches a directory of the mount.
+         *
+         * @return `true` if the directory is watched, `false` if its entries are revalidated.
+         */
+        bool watch(std::string_view dir) {
+#if defined(__linux__)
+            if (m_inotify_fd < 0)
+                return false;
+
+            {
+                std::shared_lock lock{m_mutex};
+
+                if (m_watched_dirs.contains(dir))
+                    return true;
+            }
+
+            const auto path = dir.empty() ? m_root : m_root / std::string{dir};
+
+            constexpr std::uint32_t k_mask = IN_CLOSE_WRITE | IN_MODIFY | IN_ATTRIB | IN_CREATE |
+                                             IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+                                             IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+
+            const auto wd = ::inotify_add_watch(m_inotify_fd, path.c_str(), k_mask);
+
+            if (wd < 0)
+                return false;
+
+            std::unique_lock lock{m_mutex};
+
+            m_watched_dirs.insert_or_assign(std::string{dir}, wd);
+
+            m_watches.insert_or_assign(wd, std::string{dir});
+
+            return true;
+#else
+            static_cast<void>(dir);
+
+            return false;
+#endif
+        }
+
+        /**
+         * @brief Reads the pending changes of the watched directories, at most once per
+         * `m_revalidate`.
+         */
+        void poll_watch() {
+#if defined(__linux__)
+            if (m_inotify_fd < 0)
+                return;
+
+            const auto now = steady_now();
+
+            auto next_poll = m_next_poll.load(std::memory_order_relaxed);
+
+            if (now < next_poll)
+                return;
+
+            const auto interval =
+                std::chrono::duration_cast<std::chrono::steady_clock::duration>(m_cfg.m_revalidate)
+                    .count();
+
+            // A single worker reads the changes, the others keep serving the cached entries
+            if (!m_next_poll.compare_exchange_strong(
+                    next_poll, now + interval, std::memory_order_relaxed))
+                return;
+
+            alignas(inotify_event) std::array<char, 4096> buffer{};
+
+            for (;;) {
+                const auto read = ::read(m_inotify_fd, buffer.data(), buffer.size());
+
+                if (read <= 0)
+                    break;
+
+                std::unique_lock lock{m_mutex};
+
+                for (std::size_t offset{}; offset < static_cast<std::size_t>(read);) {
+                    const auto* event =
+                        reinterpret_cast<const inotify_event*>(buffer.data() + offset);
+
+                    offset += sizeof(inotify_event) + event->len;
+
+                    on_event(*event);
+                }
+            }
+#endif
+        }
+
+#if defined(__linux__)
+        /**
+         * @brief Drops the entries a change makes stale, with the lock held.
+         */
+        void on_event(const inotify_event& event) {
+            if (event.mask & IN_Q_OVERFLOW) {
+                clear();
+
+                return;
+            }
+
+            const auto it = m_watches.find(event.wd);
+
+            if (it == m_watches.end())
+                return;
+
+            const auto dir = it->second;
+
+            if (event.mask & (IN_IGNORED | IN_DELETE_SELF | IN_MOVE_SELF)) {
+                if (event.mask & IN_IGNORED) {
+                    m_watched_dirs.erase(dir);
+
+                    m_watches.erase(event.wd);
+                }
+
+                invalidate(dir, true);
+
+                return;
+            }
+
+            // The entry of the directory itself may be its index file
+            invalidate(dir, false);
+
+            if (event.len == 0u)
+                return;
+
+            const auto name = std::string_view{event.name};
+
+            const auto rel = dir.empty() ? std::string{name} : fmt::format("{}/{}", dir, name);
+
+            invalidate(rel, (event.mask & IN_ISDIR) != 0u);
+        }
+#endif
+
+       private:
+        /**
+         * @brief The URL prefix of the mount, without a trailing slash.
+         */
+        http::types::path_t m_prefix;
+
+        /**
+         * @brief The directory served.
+         */
+        boost::filesystem::path m_root;
+
+        /**
+         * @brief The settings of the mount.
+         */
+        static_files_cfg_t m_cfg;
+
+        /**
+         * @brief Guards the entries and the watches.
+         */
+        mutable std::shared_mutex m_mutex{};
+
+        /**
+         * @brief The entries, the most recently used first.
+         */
+        lru_t m_lru{};
+
+        /**
+         * @brief Guards the order of `m_lru` for the readers, which only hold `m_mutex` shared.
+         */
+        std::mutex m_lru_mutex{};
+
+        /**
+         * @brief The entries by their path relative to the mount, viewing the keys of the nodes.
+         */
+        index_t m_index{};
+
+        /**
+         * @brief The total size of the bodies of the entries.
+         */
+        std::atomic<std::size_t> m_bytes{};
+
+        /**
+         * @brief The inotify instance, `-1` if the mount isn't watched.
+         */
+        int m_inotify_fd{-1};
+
+        /**
+         * @brief The watched directories, relative to the mount, and their watch descriptors.
+         */
+        shared::unordered_map_t<
+            std::string,
+            int,
+            http::detail::sv_hash_t,
+            http::detail::sv_eq_t>
+            m_watched_dirs{};
+
+        /**
+         * @brief The watched directories by watch descriptor.
+         */
+        shared::unordered_map_t<int, std::string> m_watches{};
+
+        /**
+         * @brief The steady time after which the watch is read again.
+         */
+        std::atomic<std::chrono::steady_clock::rep> m_next_poll{};
+    };
+
+    c_static_files::c_static_files(
+        http::types::path_t prefix, boost::filesystem::path root, static_files_cfg_t cfg)
+        : m_impl{std::make_unique<c_impl>(std::move(prefix), std::move(root), std::move(cfg))} {
+    }
+
+    c_static_files::~c_static_files() noexcept = default;
+
+    shared::awaitable_t<http::types::response_t> c_static_files::handle(
+        const http::types::request_t& request, next_t next) {
+        return m_impl->handle(request, next);
+    }
+
+    std::size_t c_static_files::cached_entries() const noexcept {
+        return m_impl->cached_entries();
+    }
+
+    std::size_t c_static_files::cached_bytes() const noexcept {
+        return m_impl->cached_bytes();
+    }
+} // namespace clueapi::middleware
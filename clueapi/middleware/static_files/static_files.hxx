@@ -0,0 +1,158 @@
+/**
+ * @file static_files.hxx
+ *
+ * @brief Defines a middleware that serves a directory of static files under a URL prefix.
+ */
+
+#ifndef CLUEAPI_MIDDLEWARE_STATIC_FILES_HXX
+#define CLUEAPI_MIDDLEWARE_STATIC_FILES_HXX
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include <boost/filesystem/path.hpp>
+
+#include "clueapi/http/types/basic/basic.hxx"
+#include "clueapi/http/types/request/request.hxx"
+#include "clueapi/http/types/response/response.hxx"
+
+#include "clueapi/middleware/middleware.hxx"
+
+#include "clueapi/shared/macros.hxx"
+#include "clueapi/shared/shared.hxx"
+
+namespace clueapi::middleware {
+    /**
+     * @struct static_files_cfg_t
+     *
+     * @brief The settings of a static directory mount.
+     */
+    struct static_files_cfg_t {
+        /**
+         * @brief The file served for a path naming a directory, empty to serve none.
+         */
+        std::string m_index{"index.html"};
+
+        /**
+         * @brief The `Cache-Control` of the files, empty to send none.
+         */
+        std::string m_cache_control{"public, max-age=3600"};
+
+        /**
+         * @brief The largest file kept in memory, larger ones are sent with `sendfile(2)`.
+         */
+        std::size_t m_max_memory_file_size{256ull * 1024u};
+
+        /**
+         * @brief The total size of the files kept in memory.
+         */
+        std::size_t m_memory_budget{64ull * 1024u * 1024u};
+
+        /**
+         * @brief The number of paths whose metadata is cached, the least recently used one is
+         * dropped when full. Missing paths aren't cached.
+         */
+        std::size_t m_max_entries{16384};
+
+        /**
+         * @brief Whether the files kept in memory are mapped rather than read.
+         *
+         * @note A mapped file that is truncated while mapped faults the process on access. Only
+         * enable it for directories that are replaced rather than rewritten in place.
+         */
+        bool m_use_mmap{false};
+
+        /**
+         * @brief Whether the directories are watched with inotify (Linux) to drop stale entries.
+         *
+         * @details Without a watch an entry is trusted for `m_revalidate` and then checked with
+         * a `stat(2)`. With one it is trusted until its file changes, and the changes are read at
+         * most once per `m_revalidate`.
+         */
+        bool m_watch{true};
+
+        /**
+         * @brief How long the metadata of a file is trusted, or how often the watch is read.
+         */
+        std::chrono::milliseconds m_revalidate{1000};
+    };
+
+    /**
+     * @class c_static_files
+     *
+     * @brief Serves the files of a directory under a URL prefix.
+     *
+     * @details The metadata of every path is looked up once and cached with the prebuilt headers
+     * of the file (`Content-Type`, `ETag`, `Cache-Control`), so a hit costs no syscall. Small
+     * files are kept in memory and shared by the responses that send them, larger ones are sent
+     * by the server with `sendfile(2)`. `If-None-Match` is answered with `304 Not Modified`;
+     * requests with a `Range` get the file response, which the server answers with a range.
+     *
+     * Only `GET` and `HEAD` requests are served. Paths outside of the mount, paths escaping the
+     * directory and missing files continue down the pipeline.
+     */
+    class c_static_files final : public c_base_middleware {
+       public:
+        /**
+         * @brief Constructs a static directory mount.
+         *
+         * @param prefix The URL prefix of the mount (e.g., "/assets").
+         * @param root The directory served.
+         * @param cfg The settings of the mount.
+         */
+        c_static_files(
+            http::types::path_t prefix, boost::filesystem::path root, static_files_cfg_t cfg = {});
+
+        ~c_static_files() noexcept override;
+
+       public:
+        /**
+         * @brief Serves the request from the directory, or passes it on.
+         *
+         * @param request The incoming HTTP request.
+         * @param next The continuation of the pipeline.
+         *
+         * @return An awaitable that resolves to the response.
+         */
+        shared::awaitable_t<http::types::response_t> handle(
+            const http::types::request_t& request,
+
+            next_t next) override;
+
+       public:
+        /**
+         * @brief Gets the number of paths whose metadata is cached.
+         *
+         * @return The number of cached paths.
+         */
+        [[nodiscard]] std::size_t cached_entries() const noexcept;
+
+        /**
+         * @brief Gets the total size of the files kept in memory.
+         *
+         * @return The size in bytes.
+         */
+        [[nodiscard]] std::size_t cached_bytes() const noexcept;
+
+       private:
+        /**
+         * @class c_impl
+         *
+         * @brief The internal implementation of the `c_static_files` class.
+         *
+         * @internal
+         */
+        class c_impl;
+
+        /**
+         * @brief The internal implementation of the `c_static_files` class.
+         *
+         * @internal
+         */
+        std::unique_ptr<c_impl> m_impl;
+    };
+} // namespace clueapi::middleware
+
+#endif // CLUEAPI_MIDDLEWARE_STATIC_FILES_HXX
@@ -0,0 +1,168 @@
+/**
+ * @file compression.hxx
+ *
+ * @brief The main public header for the clueapi compression module.
+ *
+ * @details This file provides the `c_compression_middleware` class, which negotiates
+ * `Accept-Encoding` and compresses the responses of the application.
+ */
+
+#ifndef CLUEAPI_MODULES_COMPRESSION_HXX
+#define CLUEAPI_MODULES_COMPRESSION_HXX
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <boost/filesystem/path.hpp>
+
+#include "clueapi/http/types/request/request.hxx"
+#include "clueapi/http/types/response/response.hxx"
+
+#include "clueapi/middleware/middleware.hxx"
+
+#include "clueapi/modules/compression/detail/detail.hxx"
+
+#include "clueapi/shared/macros.hxx"
+#include "clueapi/shared/shared.hxx"
+
+namespace clueapi::modules::compression {
+    using cfg_t = detail::cfg_t;
+
+    using e_encoding = detail::e_encoding;
+
+    using codec_t = detail::codec_t;
+
+    namespace detail {
+        /**
+         * @brief The compression of a file, and the requests waiting for it.
+         */
+        struct file_flight_t;
+    } // namespace detail
+
+    /**
+     * @class c_compression_middleware
+     *
+     * @brief Compresses the responses whose media type is allowed, with the best coding the
+     * client accepts.
+     *
+     * @details
+     * - Bodies of at least `m_min_size` bytes are compressed at once.
+     * - Streams are compressed chunk by chunk through the `chunk_writer_t`.
+     * - Files are answered with a precompressed sibling (`app.js.br`) when present, still sent
+     *   with `sendfile(2)` and ranges. Otherwise they are compressed once on `cfg_t::m_pool`,
+     *   kept in a cache keyed by their ETag and coding, and served from memory. The misses for
+     *   the same variant wait for the one compression.
+     *
+     * Responses that already have a `Content-Encoding`, partial content and error statuses are
+     * left alone. Compressible responses get `Vary: Accept-Encoding` either way.
+     */
+    class c_compression_middleware final : public middleware::c_base_middleware {
+       public:
+        /**
+         * @brief Constructs a compression middleware.
+         *
+         * @param cfg The settings of the middleware.
+         */
+        explicit c_compression_middleware(cfg_t cfg = {});
+
+       public:
+        /**
+         * @brief Runs the rest of the pipeline and compresses its response.
+         *
+         * @param request The incoming HTTP request.
+         * @param next The continuation of the pipeline.
+         *
+         * @return An awaitable that resolves to the response, compressed if possible.
+         */
+        shared::awaitable_t<http::types::response_t> handle(
+            const http::types::request_t& request,
+
+            middleware::next_t next) override;
+
+       public:
+        /**
+         * @brief Gets the settings of the middleware.
+         *
+         * @return A const reference to the settings.
+         */
+        [[nodiscard]] CLUEAPI_INLINE const cfg_t& cfg() const noexcept {
+            return m_cfg;
+        }
+
+        /**
+         * @brief Gets the cache of the compressed files.
+         *
+         * @return A reference to the cache.
+         */
+        [[nodiscard]] CLUEAPI_INLINE detail::cache_t& cache() noexcept {
+            return m_cache;
+        }
+
+       private:
+        /**
+         * @brief Gets the level configured for a coding.
+         */
+        [[nodiscard]] int level(e_encoding encoding) const noexcept;
+
+        /**
+         * @brief Checks if a media type is in the allowlist, ignoring its parameters.
+         */
+        [[nodiscard]] bool is_allowed_type(std::string_view content_type) const noexcept;
+
+        /**
+         * @brief Compresses a body in place.
+         */
+        void compress_body(http::types::response_t& response, e_encoding encoding) const;
+
+        /**
+         * @brief Makes a stream compress its chunks.
+         */
+        void compress_stream(http::types::response_t& response, e_encoding encoding) const;
+
+        /**
+         * @brief Swaps a file for its precompressed sibling or its cached compressed variant.
+         */
+        shared::awaitable_t<void> compress_file(
+            http::types::response_t& response, e_encoding encoding);
+
+        /**
+         * @brief Compresses a file on the pool and caches it, or waits for the compression of
+         * the same variant already running.
+         *
+         * @return The compressed file, `nullptr` if it couldn't be compressed.
+         */
+        shared::awaitable_t<detail::cache_t::value_t> compress_variant(
+            std::string key, boost::filesystem::path path, e_encoding encoding);
+
+        /**
+         * @brief Ends a compression, waking the requests waiting for it.
+         */
+        void land(
+            const std::string& key, detail::file_flight_t& flight, detail::cache_t::value_t value);
+
+       private:
+        /**
+         * @brief The settings of the middleware.
+         */
+        cfg_t m_cfg;
+
+        /**
+         * @brief The cache of the compressed files.
+         */
+        detail::cache_t m_cache;
+
+        /**
+         * @brief Guards `m_flights`.
+         */
+        std::mutex m_flights_mutex;
+
+        /**
+         * @brief The compressions running, by cache key.
+         */
+        std::unordered_map<std::string, std::shared_ptr<detail::file_flight_t>> m_flights;
+    };
+} // namespace clueapi::modules::compression
+
+#endif // CLUEAPI_MODULES_COMPRESSION_HXX
@@ -0,0 +1,122 @@
+/**
+ * @file cache.hxx
+ *
+ * @brief Defines the cache of the compressed variants of files.
+ */
+
+#ifndef CLUEAPI_MODULES_COMPRESSION_DETAIL_CACHE_HXX
+#define CLUEAPI_MODULES_COMPRESSION_DETAIL_CACHE_HXX
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <ankerl/unordered_dense.h>
+
+#include "clueapi/http/detail/sv_hash/sv_hash.hxx"
+
+#include "clueapi/shared/macros.hxx"
+
+namespace clueapi::modules::compression::detail {
+    /**
+     * @struct cache_t
+     *
+     * @brief A least recently used cache of compressed bodies, bounded by their total size.
+     *
+     * @details Keys are made of the entity tag of a file and the coding, so a file that changes
+     * gets a new tag and its old variants simply age out. The cache is shared by the workers and
+     * locked around every access; the lock is never held while compressing.
+     */
+    struct cache_t {
+        /**
+         * @brief Type alias for a cached body.
+         */
+        using value_t = std::shared_ptr<const std::string>;
+
+       public:
+        /**
+         * @brief Constructs a cache.
+         *
+         * @param capacity The total size of the bodies kept, in bytes.
+         */
+        CLUEAPI_INLINE explicit cache_t(std::size_t capacity) noexcept : m_capacity{capacity} {
+        }
+
+       public:
+        /**
+         * @brief Looks up a body and marks it as the most recently used.
+         *
+         * @param key The key of the body.
+         *
+         * @return The body, or `nullptr` if it is not cached.
+         */
+        [[nodiscard]] value_t get(std::string_view key);
+
+        /**
+         * @brief Adds a body, evicting the least recently used ones to make room.
+         *
+         * @param key The key of the body.
+         * @param value The body.
+         *
+         * @note A body larger than the whole cache is not kept.
+         */
+        void put(std::string key, value_t value);
+
+       public:
+        /**
+         * @brief Gets the number of cached bodies.
+         *
+         * @return The number of bodies.
+         */
+        [[nodiscard]] std::size_t size() const;
+
+        /**
+         * @brief Gets the total size of the cached bodies.
+         *
+         * @return The number of bytes.
+         */
+        [[nodiscard]] std::size_t bytes() const;
+
+       private:
+        /**
+         * @brief Type alias for an entry, the key and the body.
+         */
+        using entry_t = std::pair<std::string, value_t>;
+
+        /**
+         * @brief The lock of the cache.
+         */
+        mutable std::mutex m_mutex;
+
+        /**
+         * @brief The entries, from the most to the least recently used.
+         */
+        std::list<entry_t> m_entries;
+
+        /**
+         * @brief The entries by key, viewing the keys stored in `m_entries`.
+         */
+        ankerl::unordered_dense::map<
+            std::string_view,
+            std::list<entry_t>::iterator,
+            http::detail::sv_hash_t,
+            http::detail::sv_eq_t>
+            m_index;
+
+        /**
+         * @brief The total size of the bodies.
+         */
+        std::size_t m_bytes{};
+
+        /**
+         * @brief The maximum total size of the bodies.
+         */
+        std::size_t m_capacity;
+    };
+} // namespace clueapi::modules::compression::detail
+
+#endif // CLUEAPI_MODULES_COMPRESSION_DETAIL_CACHE_HXX
@@ -0,0 +1,61 @@
+/**
+ * @file cache.cxx
+ *
+ * @brief Implements the cache of the compressed variants of files.
+ */
+
+#include "clueapi/modules/compression/detail/cache/cache.hxx"
+
+namespace clueapi::modules::compression::detail {
+    cache_t::value_t cache_t::get(std::string_view key) {
+        std::lock_guard lock{m_mutex};
+
+        const auto it = m_index.find(key);
+
+        if (it == m_index.end())
+            return nullptr;
+
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+
+        return it->second->second;
+    }
+
+    void cache_t::put(std::string key, value_t value) {
+        if (!value || value->size() > m_capacity)
+            return;
+
+        std::lock_guard lock{m_mutex};
+
+        // Another worker compressed the same variant in the meantime
+        if (m_index.contains(key))
+            return;
+
+        m_bytes += value->size();
+
+        m_entries.emplace_front(std::move(key), std::move(value));
+
+        m_index.emplace(m_entries.front().first, m_entries.begin());
+
+        while (m_bytes > m_capacity) {
+            auto& oldest = m_entries.back();
+
+            m_bytes -= oldest.second->size();
+
+            m_index.erase(oldest.first);
+
+            m_entries.pop_back();
+        }
+    }
+
+    std::size_t cache_t::size() const {
+        std::lock_guard lock{m_mutex};
+
+        return m_entries.size();
+    }
+
+    std::size_t cache_t::bytes() const {
+        std::lock_guard lock{m_mutex};
+
+        return m_bytes;
+    }
+} // namespace clueapi::modules::compression::detail
@@ -0,0 +1,99 @@
+/**
+ * @file cfg.hxx
+ *
+ * @brief Defines the configuration structure for the compression module.
+ */
+
+#ifndef CLUEAPI_MODULES_COMPRESSION_DETAIL_CFG_HXX
+#define CLUEAPI_MODULES_COMPRESSION_DETAIL_CFG_HXX
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "clueapi/modules/compression/detail/codec/codec.hxx"
+
+#include "clueapi/shared/thread_pool/thread_pool.hxx"
+
+namespace clueapi::modules::compression::detail {
+    /**
+     * @struct cfg_t
+     *
+     * @brief The settings of the compression middleware.
+     */
+    struct cfg_t {
+        /**
+         * @brief The codings offered, in order of preference when the client rates them equally.
+         *
+         * @note Codings the module is built without are skipped.
+         */
+        std::vector<e_encoding> m_encodings{e_encoding::br, e_encoding::zstd, e_encoding::gzip};
+
+        /**
+         * @brief The level of `gzip`, from 1 (fastest) to 9 (smallest).
+         */
+        int m_gzip_level{6};
+
+        /**
+         * @brief The quality of `br`, from 0 (fastest) to 11 (smallest).
+         */
+        int m_brotli_level{5};
+
+        /**
+         * @brief The level of `zstd`, from 1 (fastest) to 19 (smallest).
+         */
+        int m_zstd_level{3};
+
+        /**
+         * @brief The smallest body that is compressed, in bytes.
+         *
+         * @note Streamed bodies have no known size and are always compressed.
+         */
+        std::size_t m_min_size{1024u};
+
+        /**
+         * @brief The media types that are compressed, matched against the `Content-Type` of the
+         * response, or against `mime::mime_t` for files.
+         */
+        std::vector<std::string> m_mime_types{
+            "text/html",
+            "text/css",
+            "text/plain",
+            "text/xml",
+            "text/csv",
+            "text/javascript",
+            "application/javascript",
+            "application/json",
+            "application/xml",
+            "image/svg+xml"};
+
+        /**
+         * @brief If true, a file is answered with its `.br`, `.zst` or `.gz` sibling when there is
+         * one for the negotiated coding.
+         */
+        bool m_precompressed{true};
+
+        /**
+         * @brief The largest file compressed on the fly when it has no sibling, in bytes.
+         *
+         * @note Larger files are sent as they are.
+         */
+        std::size_t m_max_file_size{4u * 1024u * 1024u};
+
+        /**
+         * @brief The pool the files are read and compressed on, usually the blocking pool of the
+         * application (`&app.blocking_pool()`, enabled with `server_t::m_blocking_pool`).
+         *
+         * @note Without a running pool, or when it is full, a file without a cached variant is
+         * sent as it is. The I/O contexts never read or compress a file.
+         */
+        shared::thread_pool_t* m_pool{nullptr};
+
+        /**
+         * @brief The total size of the compressed files kept in memory, in bytes.
+         */
+        std::size_t m_cache_size{64u * 1024u * 1024u};
+    };
+} // namespace clueapi::modules::compression::detail
+
+#endif // CLUEAPI_MODULES_COMPRESSION_DETAIL_CFG_HXX
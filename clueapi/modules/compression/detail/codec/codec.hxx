@@ -0,0 +1,123 @@
+/**
+ * @file codec.hxx
+ *
+ * @brief Defines the content codings of the compression module and their negotiation.
+ */
+
+#ifndef CLUEAPI_MODULES_COMPRESSION_DETAIL_CODEC_HXX
+#define CLUEAPI_MODULES_COMPRESSION_DETAIL_CODEC_HXX
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "clueapi/exceptions/wrap/wrap.hxx"
+
+#include "clueapi/http/chunks/chunks.hxx"
+
+#include "clueapi/shared/macros.hxx"
+
+namespace clueapi::modules::compression::detail {
+    /**
+     * @enum e_encoding
+     *
+     * @brief The content codings of the module.
+     */
+    enum struct e_encoding : std::uint8_t {
+        /**
+         * @brief No coding, the body is sent as it is.
+         */
+        identity,
+
+        /**
+         * @brief `gzip`, always available.
+         */
+        gzip,
+
+        /**
+         * @brief `br`, available when the module is built with brotli.
+         */
+        br,
+
+        /**
+         * @brief `zstd`, available when the module is built with zstd.
+         */
+        zstd
+    };
+
+    /**
+     * @struct codec_t
+     *
+     * @brief A static utility class that negotiates and creates the encoders of the codings.
+     */
+    struct codec_t {
+        /**
+         * @brief Checks if the module is built with a coding.
+         *
+         * @param encoding The coding.
+         *
+         * @return `true` if it can be used, `false` otherwise.
+         */
+        [[nodiscard]] static bool is_available(e_encoding encoding) noexcept;
+
+        /**
+         * @brief Gets the token of a coding, as sent in `Content-Encoding`.
+         *
+         * @param encoding The coding.
+         *
+         * @return The token, e.g. `gzip`.
+         */
+        [[nodiscard]] static std::string_view name(e_encoding encoding) noexcept;
+
+        /**
+         * @brief Gets the file extension of the precompressed variants of a coding.
+         *
+         * @param encoding The coding.
+         *
+         * @return The extension, e.g. `.gz`.
+         */
+        [[nodiscard]] static std::string_view extension(e_encoding encoding) noexcept;
+
+        /**
+         * @brief Picks the coding of a response from an `Accept-Encoding` header.
+         *
+         * @param header The value of the header.
+         * @param encodings The codings to choose from, in order of preference.
+         *
+         * @return The coding with the highest quality value, ties going to the earlier one in
+         * `encodings`. `e_encoding::identity` if none of them is acceptable.
+         */
+        [[nodiscard]] static e_encoding negotiate(
+            std::string_view header, std::span<const e_encoding> encodings) noexcept;
+
+        /**
+         * @brief Creates an incremental encoder.
+         *
+         * @param encoding The coding.
+         * @param level The compression level of the coding.
+         *
+         * @return The encoder, or `nullptr` if the coding is unavailable or fails to initialize.
+         *
+         * @details Every `encode()` flushes the encoder, so each chunk of a stream can be decoded
+         * as soon as it arrives.
+         */
+        [[nodiscard]] static std::shared_ptr<http::chunks::encoder_t> make_encoder(
+            e_encoding encoding, int level);
+
+        /**
+         * @brief Compresses a whole body at once.
+         *
+         * @param encoding The coding.
+         * @param level The compression level of the coding.
+         * @param data The body.
+         *
+         * @return The compressed body, or an unexpected containing an error message.
+         */
+        [[nodiscard]] static exceptions::expected_t<std::string> compress(
+            e_encoding encoding, int level, std::string_view data);
+    };
+} // namespace clueapi::modules::compression::detail
+
+#endif // CLUEAPI_MODULES_COMPRESSION_DETAIL_CODEC_HXX
@@ -0,0 +1,482 @@
+/**
+ * @file codec.cxx
+ *
+ * @brief Implements the content codings of the compression module.
+ */
+
+#include "clueapi/modules/compression/detail/codec/codec.hxx"
+
+#include <array>
+#include <cstddef>
+
+#include <zlib.h>
+
+#ifdef CLUEAPI_HAS_BROTLI
+#include <brotli/encode.h>
+#endif // CLUEAPI_HAS_BROTLI
+
+#ifdef CLUEAPI_HAS_ZSTD
+#include <zstd.h>
+#endif // CLUEAPI_HAS_ZSTD
+
+#include "clueapi/shared/non_copy/shared/shared.hxx"
+
+namespace clueapi::modules::compression::detail {
+    namespace {
+        /**
+         * @brief The number of bytes the output grows by while an encoder runs.
+         */
+        constexpr std::size_t k_block_size{16u * 1024u};
+
+        /**
+         * @brief The number of codings, `identity` included.
+         */
+        constexpr std::size_t k_encodings{4};
+
+        /**
+         * @enum e_op
+         *
+         * @brief What an encoder does with its input.
+         */
+        enum struct e_op : std::uint8_t {
+            /**
+             * @brief Encodes the input and flushes it, the stream goes on.
+             */
+            flush,
+
+            /**
+             * @brief Encodes the input and ends the stream.
+             */
+            finish
+        };
+
+        /**
+         * @struct stream_encoder_t
+         *
+         * @brief The common part of the encoders.
+         */
+        struct stream_encoder_t : http::chunks::encoder_t {
+            exceptions::expected_t<> encode(std::string_view data, std::string& out) override {
+                return process(data, out, e_op::flush);
+            }
+
+            exceptions::expected_t<> finish(std::string& out) override {
+                return process({}, out, e_op::finish);
+            }
+
+           public:
+            /**
+             * @brief Checks if the encoder initialized.
+             */
+            [[nodiscard]] virtual bool is_valid() const noexcept = 0;
+
+            /**
+             * @brief Runs the encoder.
+             *
+             * @param data The input.
+             * @param out The string the output is appended to.
+             * @param op What to do with the input.
+             */
+            virtual exceptions::expected_t<> process(
+                std::string_view data, std::string& out, e_op op) = 0;
+        };
+
+        /**
+         * @struct gzip_encoder_t
+         *
+         * @brief The `gzip` encoder, built on zlib's deflate.
+         */
+        struct gzip_encoder_t final : stream_encoder_t {
+            CLUEAPI_INLINE explicit gzip_encoder_t(int level) noexcept {
+                // 16 added to the window bits asks zlib for a gzip wrapper
+                m_valid =
+                    deflateInit2(&m_stream, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) ==
+                    Z_OK;
+            }
+
+            CLUEAPI_INLINE ~gzip_encoder_t() noexcept override {
+                if (m_valid)
+                    deflateEnd(&m_stream);
+            }
+
+           public:
+            [[nodiscard]] bool is_valid() const noexcept override {
+                return m_valid;
+            }
+
+            exceptions::expected_t<> process(
+                std::string_view data, std::string& out, e_op op) override {
+                m_stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+                m_stream.avail_in = static_cast<uInt>(data.size());
+
+                const auto flush = op == e_op::finish ? Z_FINISH : Z_SYNC_FLUSH;
+
+                while (true) {
+                    const auto offset = out.size();
+
+                    out.resize(offset + k_block_size);
+
+                    m_stream.next_out = reinterpret_cast<Bytef*>(out.data() + offset);
+                    m_stream.avail_out = static_cast<uInt>(k_block_size);
+
+                    const auto ret = deflate(&m_stream, flush);
+
+                    out.resize(offset + k_block_size - m_stream.avail_out);
+
+                    if (ret == Z_STREAM_ERROR)
+                        return exceptions::make_unexpected("Failed to deflate");
+
+                    // Either the stream ended or there was room left, so nothing is pending
+                    if (ret == Z_STREAM_END || m_stream.avail_out != 0)
+                        break;
+                }
+
+                return exceptions::expected_t<>{};
+            }
+
+           private:
+            /**
+             * @brief The state of zlib.
+             */
+            z_stream m_stream{};
+
+            /**
+             * @brief Whether the state initialized.
+             */
+            bool m_valid{};
+        };
+
+#ifdef CLUEAPI_HAS_BROTLI
+        /**
+         * @struct brotli_encoder_t
+         *
+         * @brief The `br` encoder.
+         */
+        struct brotli_encoder_t final : stream_encoder_t {
+            CLUEAPI_INLINE explicit brotli_encoder_t(int level) noexcept
+                : m_state{BrotliEncoderCreateInstance(nullptr, nullptr, nullptr)} {
+                if (m_state)
+                    BrotliEncoderSetParameter(
+                        m_state, BROTLI_PARAM_QUALITY, static_cast<std::uint32_t>(level));
+            }
+
+            CLUEAPI_INLINE ~brotli_encoder_t() noexcept override {
+                if (m_state)
+                    BrotliEncoderDestroyInstance(m_state);
+            }
+
+           public:
+            [[nodiscard]] bool is_valid() const noexcept override {
+                return m_state != nullptr;
+            }
+
+            exceptions::expected_t<> process(
+                std::string_view data, std::string& out, e_op op) override {
+                const auto operation =
+                    op == e_op::finish ? BROTLI_OPERATION_FINISH : BROTLI_OPERATION_FLUSH;
+
+                auto available_in = data.size();
+
+                auto next_in = reinterpret_cast<const std::uint8_t*>(data.data());
+
+                while (true) {
+                    std::size_t available_out{};
+
+                    // The output is taken from the encoder's own buffer instead
+                    if (!BrotliEncoderCompressStream(
+                            m_state,
+                            operation,
+                            &available_in,
+                            &next_in,
+                            &available_out,
+                            nullptr,
+                            nullptr))
+                        return exceptions::make_unexpected("Failed to encode brotli stream");
+
+                    std::size_t size{};
+
+                    const auto output = BrotliEncoderTakeOutput(m_state, &size);
+
+                    out.append(reinterpret_cast<const char*>(output), size);
+
+                    const auto done =
+                        op == e_op::finish
+                            ? BrotliEncoderIsFinished(m_state) != 0
+                            : available_in == 0 && !BrotliEncoderHasMoreOutput(m_state);
+
+                    if (done)
+                        break;
+                }
+
+                return exceptions::expected_t<>{};
+            }
+
+           private:
+            /**
+             * @brief The state of brotli.
+             */
+            BrotliEncoderState* m_state{};
+        };
+#endif // CLUEAPI_HAS_BROTLI
+
+#ifdef CLUEAPI_HAS_ZSTD
+        /**
+         * @struct zstd_encoder_t
+         *
+         * @brief The `zstd` encoder.
+         */
+        struct zstd_encoder_t final : stream_encoder_t {
+            CLUEAPI_INLINE explicit zstd_encoder_t(int level) noexcept
+                : m_ctx{ZSTD_createCCtx()} {
+                if (m_ctx)
+                    ZSTD_CCtx_setParameter(m_ctx, ZSTD_c_compressionLevel, level);
+            }
+
+            CLUEAPI_INLINE ~zstd_encoder_t() noexcept override {
+                if (m_ctx)
+                    ZSTD_freeCCtx(m_ctx);
+            }
+
+           public:
+            [[nodiscard]] bool is_valid() const noexcept override {
+                return m_ctx != nullptr;
+            }
+
+            exceptions::expected_t<> process(
+                std::string_view data, std::string& out, e_op op) override {
+                const auto directive = op == e_op::finish ? ZSTD_e_end : ZSTD_e_flush;
+
+                ZSTD_inBuffer input{data.data(), data.size(), 0};
+
+                while (true) {
+                    const auto offset = out.size();
+
+                    out.resize(offset + k_block_size);
+
+                    ZSTD_outBuffer output{out.data() + offset, k_block_size, 0};
+
+                    const auto remaining = ZSTD_compressStream2(m_ctx, &output, &input, directive);
+
+                    out.resize(offset + output.pos);
+
+                    if (ZSTD_isError(remaining))
+                        return exceptions::make_unexpected(ZSTD_getErrorName(remaining));
+
+                    if (remaining == 0)
+                        break;
+                }
+
+                return exceptions::expected_t<>{};
+            }
+
+           private:
+            /**
+             * @brief The context of zstd.
+             */
+            ZSTD_CCtx* m_ctx{};
+        };
+#endif // CLUEAPI_HAS_ZSTD
+
+        /**
+         * @brief Creates the encoder of a coding.
+         */
+        std::unique_ptr<stream_encoder_t> make_stream_encoder(e_encoding encoding, int level) {
+            std::unique_ptr<stream_encoder_t> encoder{};
+
+            switch (encoding) {
+                case e_encoding::gzip:
+                    encoder = std::make_unique<gzip_encoder_t>(level);
+
+                    break;
+#ifdef CLUEAPI_HAS_BROTLI
+                case e_encoding::br:
+                    encoder = std::make_unique<brotli_encoder_t>(level);
+
+                    break;
+#endif // CLUEAPI_HAS_BROTLI
+#ifdef CLUEAPI_HAS_ZSTD
+                case e_encoding::zstd:
+                    encoder = std::make_unique<zstd_encoder_t>(level);
+
+                    break;
+#endif // CLUEAPI_HAS_ZSTD
+                default:
+                    break;
+            }
+
+            if (encoder && !encoder->is_valid())
+                encoder.reset();
+
+            return encoder;
+        }
+
+        /**
+         * @brief Parses the quality value of an `Accept-Encoding` member, in thousandths.
+         *
+         * @param params The parameters after the coding, e.g. `;q=0.5`.
+         *
+         * @return The quality value, `1000` when there is none.
+         */
+        std::uint32_t parse_quality(std::string_view params) noexcept {
+            const auto pos = params.find("q=");
+
+            if (pos == std::string_view::npos)
+                return 1000u;
+
+            const auto value = shared::non_copy::trim(params.substr(pos + 2));
+
+            if (value.empty() || value.front() == '1')
+                return 1000u;
+
+            if (value.front() != '0')
+                return 0u;
+
+            std::uint32_t quality{};
+
+            std::uint32_t scale{100u};
+
+            for (std::size_t i = 2; i < value.size() && i < 5 && value[1] == '.'; i++) {
+                if (value[i] < '0' || value[i] > '9')
+                    break;
+
+                quality += static_cast<std::uint32_t>(value[i] - '0') * scale;
+
+                scale /= 10u;
+            }
+
+            return quality;
+        }
+    } // namespace
+
+    bool codec_t::is_available(e_encoding encoding) noexcept {
+        switch (encoding) {
+            case e_encoding::identity:
+            case e_encoding::gzip:
+                return true;
+            case e_encoding::br:
+#ifdef CLUEAPI_HAS_BROTLI
+                return true;
+#else
+                return false;
+#endif // CLUEAPI_HAS_BROTLI
+            case e_encoding::zstd:
+#ifdef CLUEAPI_HAS_ZSTD
+                return true;
+#else
+                return false;
+#endif // CLUEAPI_HAS_ZSTD
+        }
+
+        return false;
+    }
+
+    std::string_view codec_t::name(e_encoding encoding) noexcept {
+        switch (encoding) {
+            case e_encoding::gzip:
+                return "gzip";
+            case e_encoding::br:
+                return "br";
+            case e_encoding::zstd:
+                return "zstd";
+            default:
+                return "identity";
+        }
+    }
+
+    std::string_view codec_t::extension(e_encoding encoding) noexcept {
+        switch (encoding) {
+            case e_encoding::gzip:
+                return ".gz";
+            case e_encoding::br:
+                return ".br";
+            case e_encoding::zstd:
+                return ".zst";
+            default:
+                return "";
+        }
+    }
+
+    e_encoding codec_t::negotiate(
+        std::string_view header, std::span<const e_encoding> encodings) noexcept {
+        // The quality of every coding, `k_encodings` standing for `*`, unset if not listed
+        std::array<std::int32_t, k_encodings + 1> qualities{};
+
+        qualities.fill(-1);
+
+        while (!header.empty()) {
+            const auto comma = header.find(',');
+
+            auto member = header.substr(0, comma);
+
+            header =
+                comma == std::string_view::npos ? std::string_view{} : header.substr(comma + 1);
+
+            const auto semicolon = member.find(';');
+
+            const auto token = shared::non_copy::trim(member.substr(0, semicolon));
+
+            const auto quality = static_cast<std::int32_t>(parse_quality(
+                semicolon == std::string_view::npos ? std::string_view{}
+                                                    : member.substr(semicolon + 1)));
+
+            std::size_t index{k_encodings};
+
+            if (shared::non_copy::iequals_ascii(token, "gzip") ||
+                shared::non_copy::iequals_ascii(token, "x-gzip"))
+                index = static_cast<std::size_t>(e_encoding::gzip);
+            else if (shared::non_copy::iequals_ascii(token, "br"))
+                index = static_cast<std::size_t>(e_encoding::br);
+            else if (shared::non_copy::iequals_ascii(token, "zstd"))
+                index = static_cast<std::size_t>(e_encoding::zstd);
+            else if (token != "*")
+                continue;
+
+            qualities[index] = quality;
+        }
+
+        auto best = e_encoding::identity;
+
+        std::int32_t best_quality{};
+
+        for (const auto encoding : encodings) {
+            if (encoding == e_encoding::identity || !is_available(encoding))
+                continue;
+
+            auto quality = qualities[static_cast<std::size_t>(encoding)];
+
+            if (quality < 0)
+                quality = qualities[k_encodings];
+
+            if (quality > best_quality) {
+                best = encoding;
+
+                best_quality = quality;
+            }
+        }
+
+        return best;
+    }
+
+    std::shared_ptr<http::chunks::encoder_t> codec_t::make_encoder(
+        e_encoding encoding, int level) {
+        return make_stream_encoder(encoding, level);
+    }
+
+    exceptions::expected_t<std::string> codec_t::compress(
+        e_encoding encoding, int level, std::string_view data) {
+        auto encoder = make_stream_encoder(encoding, level);
+
+        if (!encoder)
+            return exceptions::make_unexpected(
+                fmt::format("Encoding is not available: {}", name(encoding)));
+
+        std::string ret{};
+
+        ret.reserve(data.size() / 2u + 64u);
+
+        if (auto processed = encoder->process(data, ret, e_op::finish); !processed.has_value())
+            return exceptions::make_unexpected(processed.error());
+
+        return ret;
+    }
+} // namespace clueapi::modules::compression::detail
@@ -0,0 +1,20 @@
+/**
+ * @file detail.hxx
+ *
+ * @brief Includes the internal parts of the compression module.
+ */
+
+#ifndef CLUEAPI_MODULES_COMPRESSION_DETAIL_HXX
+#define CLUEAPI_MODULES_COMPRESSION_DETAIL_HXX
+
+#include "clueapi/modules/compression/detail/cache/cache.hxx"
+
+#include "clueapi/modules/compression/detail/cfg/cfg.hxx"
+
+#include "clueapi/modules/compression/detail/codec/codec.hxx"
+
+namespace clueapi::modules::compression::detail {
+    // ...
+}
+
+#endif // CLUEAPI_MODULES_COMPRESSION_DETAIL_HXX
@@ -0,0 +1,412 @@
+/**
+ * @file compression.cxx
+ *
+ * @brief Implements the compression middleware.
+ */
+
+#include "clueapi/modules/compression/compression.hxx"
+
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <vector>
+
+#include <boost/asio/async_result.hpp>
+#include <boost/asio/associated_executor.hpp>
+#include <boost/asio/execution/outstanding_work.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/prefer.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include "clueapi/http/mime/mime.hxx"
+
+#include "clueapi/modules/macros.hxx"
+
+#include "clueapi/shared/non_copy/shared/shared.hxx"
+
+namespace clueapi::modules::compression {
+    namespace detail {
+        struct file_flight_t {
+            std::mutex m_mutex{};
+
+            bool m_is_done{};
+
+            /**
+             * @brief The compressed file, `nullptr` if it couldn't be compressed.
+             */
+            cache_t::value_t m_value{};
+
+            std::vector<std::function<void()>> m_waiters{};
+        };
+    } // namespace detail
+
+    namespace {
+        /**
+         * @brief Checks if a response may be compressed at all.
+         */
+        bool is_transformable(const http::types::response_t& response) noexcept {
+            const auto status = static_cast<std::uint32_t>(response.status());
+
+            // Ranges refer to the bytes of the uncompressed representation
+            if (status < 200u || status >= 300u || status == 204u || status == 206u)
+                return false;
+
+            return !response.headers().contains("Content-Encoding");
+        }
+
+        /**
+         * @brief Adds `Accept-Encoding` to the `Vary` header of a response.
+         */
+        void add_vary(http::types::response_t& response) {
+            auto [it, inserted] = response.headers().try_emplace("Vary", "Accept-Encoding");
+
+            if (!inserted && it->second != "*" &&
+                it->second.find("Accept-Encoding") == std::string::npos)
+                it->second.append(", Accept-Encoding");
+        }
+
+        /**
+         * @brief Sets the `Content-Encoding` of a response.
+         */
+        void set_encoding(http::types::response_t& response, detail::e_encoding encoding) {
+            response.headers().insert_or_assign(
+                "Content-Encoding", std::string{codec_t::name(encoding)});
+        }
+
+        /**
+         * @brief Gives the ETag of a variant, so caches never mix it up with the original.
+         */
+        void tag_variant(http::types::response_t& response, detail::e_encoding encoding) {
+            const auto it = response.headers().find("ETag");
+
+            if (it == response.headers().end() || !it->second.ends_with('"'))
+                return;
+
+            it->second.insert(it->second.size() - 1, fmt::format("-{}", codec_t::name(encoding)));
+        }
+
+        /**
+         * @brief Reads a whole file.
+         */
+        exceptions::expected_t<std::string> read_file(const boost::filesystem::path& path) {
+            std::ifstream file{path.string(), std::ios::binary};
+
+            if (!file)
+                return exceptions::make_unexpected(
+                    fmt::format("Can't open file: {}", path.string()));
+
+            return std::string{
+                std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+        }
+
+        /**
+         * @brief Suspends a request until the compression it waits for lands.
+         */
+        shared::awaitable_t<void> wait(detail::file_flight_t& flight) {
+            co_await boost::asio::async_initiate<const boost::asio::use_awaitable_t<>&, void()>(
+                [&flight](auto handler) {
+                    auto executor = boost::asio::prefer(
+                        boost::asio::get_associated_executor(handler),
+                        boost::asio::execution::outstanding_work.tracked);
+
+                    auto resume = [executor,
+                                   handler = std::make_shared<decltype(handler)>(
+                                       std::move(handler))]() {
+                        boost::asio::post(executor, [handler]() { std::move (*handler)(); });
+                    };
+
+                    {
+                        std::lock_guard lock{flight.m_mutex};
+
+                        if (!flight.m_is_done) {
+                            flight.m_waiters.emplace_back(std::move(resume));
+
+                            return;
+                        }
+                    }
+
+                    resume();
+                },
+
+                boost::asio::use_awaitable);
+        }
+    } // namespace
+
+    c_compression_middleware::c_compression_middleware(cfg_t cfg)
+        : m_cfg{std::move(cfg)}, m_cache{m_cfg.m_cache_size} {
+    }
+
+    shared::awaitable_t<http::types::response_t> c_compression_middleware::handle(
+        const http::types::request_t& request,
+
+        middleware::next_t next) {
+        auto response = co_await next(request);
+
+        if (!is_transformable(response))
+            co_return response;
+
+        const auto& file = response.file();
+
+        {
+            const auto content_type_it = response.headers().find("Content-Type");
+
+            const auto content_type = file.has_value()
+                                          ? http::mime::mime_t::mime_type(file->m_path)
+                                          : content_type_it != response.headers().end()
+                                                ? std::string_view{content_type_it->second}
+                                                : std::string_view{};
+
+            if (!is_allowed_type(content_type))
+                co_return response;
+        }
+
+        add_vary(response);
+
+        const auto accept_encoding = request.header(http::types::e_header::accept_encoding);
+
+        if (!accept_encoding.has_value())
+            co_return response;
+
+        const auto encoding = codec_t::negotiate(*accept_encoding, m_cfg.m_encodings);
+
+        if (encoding == e_encoding::identity)
+            co_return response;
+
+        try {
+            if (file.has_value())
+                co_await compress_file(response, encoding);
+            else if (response.is_stream())
+                compress_stream(response, encoding);
+            else
+                compress_body(response, encoding);
+        } catch (const std::exception& e) {
+            CLUEAPI_LOG_ERROR("Failed to compress response: {}", e.what());
+        }
+
+        co_return response;
+    }
+
+    int c_compression_middleware::level(e_encoding encoding) const noexcept {
+        switch (encoding) {
+            case e_encoding::br:
+                return m_cfg.m_brotli_level;
+            case e_encoding::zstd:
+                return m_cfg.m_zstd_level;
+            default:
+                return m_cfg.m_gzip_level;
+        }
+    }
+
+    bool c_compression_middleware::is_allowed_type(std::string_view content_type) const noexcept {
+        content_type = shared::non_copy::trim(content_type.substr(0, content_type.find(';')));
+
+        if (content_type.empty())
+            return false;
+
+        for (const auto& allowed : m_cfg.m_mime_types) {
+            if (shared::non_copy::iequals_ascii(content_type, allowed))
+                return true;
+        }
+
+        return false;
+    }
+
+    void c_compression_middleware::compress_body(
+        http::types::response_t& response, e_encoding encoding) const {
+        if (response.body().size() < m_cfg.m_min_size)
+            return;
+
+        auto compressed = codec_t::compress(encoding, level(encoding), response.body());
+
+        if (!compressed.has_value()) {
+            CLUEAPI_LOG_ERROR("Failed to compress response body: {}", compressed.error());
+
+            return;
+        }
+
+        // Not worth the client's decoding
+        if (compressed->size() >= response.body().size())
+            return;
+
+        response.body() = std::move(*compressed);
+
+        set_encoding(response, encoding);
+
+        tag_variant(response, encoding);
+    }
+
+    void c_compression_middleware::compress_stream(
+        http::types::response_t& response, e_encoding encoding) const {
+        auto encoder = codec_t::make_encoder(encoding, level(encoding));
+
+        if (!encoder)
+            return;
+
+        auto stream_fn = std::move(response.stream_fn());
+
+        response.stream_fn() =
+            [encoder = std::move(encoder), stream_fn = std::move(stream_fn)](
+                http::chunks::chunk_writer_t& writer) -> exceptions::expected_awaitable_t<void> {
+            writer.encoder(encoder);
+
+            co_return co_await stream_fn(writer);
+        };
+
+        set_encoding(response, encoding);
+
+        tag_variant(response, encoding);
+    }
+
+    shared::awaitable_t<void> c_compression_middleware::compress_file(
+        http::types::response_t& response, e_encoding encoding) {
+        const auto file = *response.file();
+
+        if (m_cfg.m_precompressed) {
+            auto sibling = file.m_path;
+
+            sibling += std::string{codec_t::extension(encoding)};
+
+            boost::system::error_code ec{};
+
+            if (boost::filesystem::is_regular_file(sibling, ec)) {
+                http::types::file_response_t variant{std::move(sibling)};
+
+                if (variant.status() == http::types::status_t::ok) {
+                    response.file() = variant.file();
+
+                    response.stream_fn() = std::move(variant.stream_fn());
+
+                    // The sibling has its own length and tag, the type stays the original's
+                    for (const auto* name : {"Content-Length", "ETag"})
+                        response.headers().insert_or_assign(name, variant.headers().at(name));
+
+                    set_encoding(response, encoding);
+
+                    co_return;
+                }
+            }
+        }
+
+        if (file.m_size < m_cfg.m_min_size || file.m_size > m_cfg.m_max_file_size)
+            co_return;
+
+        const auto etag_it = response.headers().find("ETag");
+
+        if (etag_it == response.headers().end())
+            co_return;
+
+        auto key = fmt::format("{}:{}", etag_it->second, codec_t::name(encoding));
+
+        auto compressed = m_cache.get(key);
+
+        if (!compressed)
+            compressed = co_await compress_variant(std::move(key), file.m_path, encoding);
+
+        // Sent as it is, the next request may find the variant
+        if (!compressed)
+            co_return;
+
+        response.file().reset();
+
+        response.stream_fn() = nullptr;
+
+        response.is_stream() = false;
+
+        // Shared with the cache, the variant isn't copied per response
+        response.shared_body() = http::types::shared_body_t{*compressed, compressed};
+
+        response.headers().erase("Content-Length");
+
+        set_encoding(response, encoding);
+
+        tag_variant(response, encoding);
+    }
+
+    shared::awaitable_t<detail::cache_t::value_t> c_compression_middleware::compress_variant(
+        std::string key, boost::filesystem::path path, e_encoding encoding) {
+        if (!m_cfg.m_pool || !m_cfg.m_pool->is_running())
+            co_return nullptr;
+
+        std::shared_ptr<detail::file_flight_t> flight{};
+
+        bool is_leader{};
+
+        {
+            std::lock_guard lock{m_flights_mutex};
+
+            auto [it, inserted] = m_flights.try_emplace(key);
+
+            if (inserted)
+                it->second = std::make_shared<detail::file_flight_t>();
+
+            flight = it->second;
+
+            is_leader = inserted;
+        }
+
+        if (!is_leader) {
+            co_await wait(*flight);
+
+            co_return flight->m_value;
+        }
+
+        detail::cache_t::value_t value{};
+
+        try {
+            using result_t = exceptions::expected_t<std::string>;
+
+            auto encoded = co_await m_cfg.m_pool->run(
+                [&path, encoding, level = level(encoding)]() -> result_t {
+                    auto content = read_file(path);
+
+                    if (!content.has_value())
+                        return content;
+
+                    return codec_t::compress(encoding, level, *content);
+                });
+
+            if (!encoded.has_value())
+                CLUEAPI_LOG_WARNING("File not compressed, the pool is full: {}", path.string());
+            else if (!encoded->has_value())
+                CLUEAPI_LOG_ERROR("Failed to compress file: {}", encoded->error());
+            else {
+                value = std::make_shared<const std::string>(std::move(encoded->value()));
+
+                m_cache.put(key, value);
+            }
+        } catch (...) {
+            land(key, *flight, nullptr);
+
+            throw;
+        }
+
+        land(key, *flight, value);
+
+        co_return value;
+    }
+
+    void c_compression_middleware::land(
+        const std::string& key, detail::file_flight_t& flight, detail::cache_t::value_t value) {
+        {
+            std::lock_guard lock{m_flights_mutex};
+
+            m_flights.erase(key);
+        }
+
+        std::vector<std::function<void()>> waiters{};
+
+        {
+            std::lock_guard lock{flight.m_mutex};
+
+            flight.m_is_done = true;
+
+            flight.m_value = std::move(value);
+
+            waiters.swap(flight.m_waiters);
+        }
+
+        for (auto& waiter : waiters)
+            waiter();
+    }
+} // namespace clueapi::modules::compression
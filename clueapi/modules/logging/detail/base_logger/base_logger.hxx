@@ -8,10 +8,13 @@
 #define CLUEAPI_MODULES_LOGGING_DETAIL_BASE_LOGGER_HXX
 
 #ifdef CLUEAPI_USE_LOGGING_MODULE
+#include <atomic>
 #include <condition_variable>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <thread>
 #include <utility>
 
 #include "clueapi/modules/logging/detail/buffer/buffer.hxx"
@@ -55,6 +58,23 @@ namespace clueapi::modules::logging {
              * @brief Enables or disables asynchronous logging.
              */
             bool m_async_mode{false};
+
+            /**
+             * @brief What to do with a message once the buffer is full, in async mode.
+             *
+             * @note `e_overflow_policy::block` relies on the logging thread draining the buffer.
+             */
+            e_overflow_policy m_overflow_policy{e_overflow_policy::drop_oldest};
+
+            /**
+             * @brief Defers the formatting to the logging thread, in async mode.
+             *
+             * @details The caller only copies the format string and the arguments into the
+             * buffered record. It applies to messages logged with a string literal as format
+             * string, whose arguments are numbers, enums, durations or strings that fit
+             * `detail::k_deferred_args_size` bytes. Other messages are formatted right away.
+             */
+            bool m_deferred_format{false};
         };
 
         /**
@@ -137,6 +157,8 @@ namespace clueapi::modules::logging {
              * @param capacity The new capacity.
              */
             CLUEAPI_INLINE void set_capacity(std::size_t capacity) noexcept {
+                m_params.m_capacity = capacity;
+
                 m_buffer.set_capacity(capacity);
             }
 
@@ -149,6 +171,15 @@ namespace clueapi::modules::logging {
                 m_params.m_batch_size = batch_size;
             }
 
+            /**
+             * @brief Sets the overflow policy.
+             *
+             * @param overflow_policy The new overflow policy.
+             */
+            CLUEAPI_INLINE void set_overflow_policy(e_overflow_policy overflow_policy) noexcept {
+                m_params.m_overflow_policy = overflow_policy;
+            }
+
             /**
              * @brief Sets the asynchronous mode.
              *
@@ -228,6 +259,64 @@ namespace clueapi::modules::logging {
                 return m_params.m_level;
             }
 
+            /**
+             * @brief Gets the number of messages lost to a full buffer.
+             * @return The number of dropped messages.
+             */
+            CLUEAPI_INLINE std::uint64_t dropped() const noexcept {
+                return m_dropped.load(std::memory_order_relaxed);
+            }
+
+           protected:
+            /**
+             * @brief Pushes a message that didn't fit the buffer, following the overflow policy,
+             * and wakes the logging thread.
+             *
+             * @param msg The message.
+             */
+            CLUEAPI_INLINE void push_overflowed(log_msg_t msg) {
+                switch (m_params.m_overflow_policy) {
+                    case e_overflow_policy::drop_newest:
+                        m_dropped.fetch_add(1u, std::memory_order_relaxed);
+
+                        break;
+
+                    case e_overflow_policy::drop_oldest:
+                        // Either the oldest message or this one is lost
+                        m_buffer.push_evicting(std::move(msg));
+
+                        m_dropped.fetch_add(1u, std::memory_order_relaxed);
+
+                        break;
+
+                    case e_overflow_policy::block:
+                        while (true) {
+                            if (!m_params.m_async_mode || m_buffer.capacity() == 0u) {
+                                m_dropped.fetch_add(1u, std::memory_order_relaxed);
+
+                                break;
+                            }
+
+                            auto push_pair = m_buffer.push(std::move(msg));
+
+                            if (push_pair.first)
+                                break;
+
+                            msg = std::move(push_pair.second);
+
+                            if (m_prv_params.m_condition)
+                                m_prv_params.m_condition->notify_one();
+
+                            std::this_thread::yield();
+                        }
+
+                        break;
+                }
+
+                if (m_prv_params.m_condition)
+                    m_prv_params.m_condition->notify_one();
+            }
+
            private:
             /**
              * @brief Sets the private parameters for the logger.
@@ -260,6 +349,11 @@ namespace clueapi::modules::logging {
              * @brief A flag indicating if the logger is enabled.
              */
             bool m_enabled{};
+
+            /**
+             * @brief The number of messages lost to a full buffer.
+             */
+            std::atomic<std::uint64_t> m_dropped{};
         };
     } // namespace detail
 } // namespace clueapi::modules::logging
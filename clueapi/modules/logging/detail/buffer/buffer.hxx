@@ -1,15 +1,17 @@
 /**
  * @file buffer.hxx
  *
- * @brief Defines a thread-safe buffer for log messages.
+ * @brief Defines a lock-free buffer for log messages.
  */
 
 #ifndef CLUEAPI_MODULES_LOGGING_DETAIL_BUFFER_HXX
 #define CLUEAPI_MODULES_LOGGING_DETAIL_BUFFER_HXX
 
 #ifdef CLUEAPI_USE_LOGGING_MODULE
-#include <mutex>
-#include <shared_mutex>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -17,20 +19,52 @@
 #include "clueapi/shared/macros.hxx"
 
 namespace clueapi::modules::logging::detail {
+    /**
+     * @enum e_overflow_policy
+     *
+     * @brief What a logger does with a message once its buffer is full.
+     */
+    enum struct e_overflow_policy : std::uint8_t {
+        /**
+         * @brief The new message is dropped.
+         */
+        drop_newest,
+
+        /**
+         * @brief The oldest buffered message is dropped to make room for the new one.
+         */
+        drop_oldest,
+
+        /**
+         * @brief The caller waits until the consumer makes room.
+         */
+        block
+    };
+
     /**
      * @struct msg_buffer_t
      *
-     * @brief A thread-safe buffer for storing and batching log messages.
+     * @brief A bounded lock-free buffer for storing and batching log messages.
+     *
+     * @details The messages live in a ring of cells, each with a sequence number telling whether
+     * it is free for the producer or ready for the consumer of a position. Producers and
+     * consumers claim their position with a single compare-and-swap, so nothing is ever moved
+     * around and a batch costs one pop per message. Any thread may pop, which lets a producer
+     * drop the oldest message on overflow.
+     *
+     * The ring is rounded up to a power of two, while the capacity stays exact.
+     *
+     * @note `push()`, `pop()`, `get_batch()`, `clear()`, `size()` and `empty()` are thread-safe.
+     * Moving, `destroy()` and `set_capacity()` to a larger capacity are not.
      *
      * @internal
      */
     struct msg_buffer_t {
-        CLUEAPI_INLINE msg_buffer_t() noexcept : m_capacity{512} {
-            m_buf.reserve(m_capacity);
+        CLUEAPI_INLINE msg_buffer_t() noexcept : msg_buffer_t{512} {
         }
 
-        CLUEAPI_INLINE msg_buffer_t(std::size_t capacity) noexcept : m_capacity{capacity} {
-            m_buf.reserve(m_capacity);
+        CLUEAPI_INLINE msg_buffer_t(std::size_t capacity) noexcept {
+            allocate(capacity);
         }
 
         CLUEAPI_INLINE ~msg_buffer_t() noexcept = default;
@@ -40,21 +74,26 @@ namespace clueapi::modules::logging::detail {
         CLUEAPI_INLINE msg_buffer_t& operator=(const msg_buffer_t&) noexcept = delete;
 
         CLUEAPI_INLINE msg_buffer_t(msg_buffer_t&& other) noexcept {
-            std::unique_lock lock_other{other.m_mutex};
-
-            m_buf = std::move(other.m_buf);
-
-            m_capacity = other.m_capacity;
+            *this = std::move(other);
         }
 
         CLUEAPI_INLINE msg_buffer_t& operator=(msg_buffer_t&& other) noexcept {
             if (this != &other) {
-                std::unique_lock lock{m_mutex};
-                std::unique_lock lock_other{other.m_mutex};
+                m_cells = std::move(other.m_cells);
 
-                m_buf = std::move(other.m_buf);
+                m_mask = std::exchange(other.m_mask, 0u);
 
-                m_capacity = other.m_capacity;
+                m_capacity.store(
+                    other.m_capacity.exchange(0u, std::memory_order_relaxed),
+                    std::memory_order_relaxed);
+
+                m_push_pos.m_value.store(
+                    other.m_push_pos.m_value.exchange(0u, std::memory_order_relaxed),
+                    std::memory_order_relaxed);
+
+                m_pop_pos.m_value.store(
+                    other.m_pop_pos.m_value.exchange(0u, std::memory_order_relaxed),
+                    std::memory_order_relaxed);
             }
 
             return *this;
@@ -80,6 +119,15 @@ namespace clueapi::modules::logging::detail {
          */
         std::pair<bool, log_msg_t> push(log_msg_t msg);
 
+        /**
+         * @brief Pushes a message, dropping the oldest ones until it fits.
+         *
+         * @param msg The message to push.
+         *
+         * @return `true` if the message was pushed, `false` if the buffer can't hold any.
+         */
+        bool push_evicting(log_msg_t msg);
+
         /**
          * @brief Retrieves a batch of messages from the buffer.
          *
@@ -94,35 +142,43 @@ namespace clueapi::modules::logging::detail {
          * @brief Destroys the buffer's contents, releasing memory.
          */
         CLUEAPI_INLINE void destroy() noexcept {
-            std::unique_lock lock{m_mutex};
+            m_cells.reset();
+
+            m_mask = 0u;
 
-            std::vector<log_msg_t>().swap(m_buf);
+            m_push_pos.m_value.store(0u, std::memory_order_relaxed);
+
+            m_pop_pos.m_value.store(0u, std::memory_order_relaxed);
         }
 
         /**
          * @brief Clears the buffer.
          */
         CLUEAPI_INLINE void clear() noexcept {
-            m_buf.clear();
+            log_msg_t msg{};
+
+            while (pop(msg)) {
+            }
         }
 
        public:
         /**
          * @brief Sets the capacity of the buffer.
          *
+         * @details A capacity that fits the ring only moves the bound, a larger one reallocates
+         * it and keeps the buffered messages.
+         *
          * @param capacity The new capacity.
          */
-        CLUEAPI_INLINE void set_capacity(std::size_t capacity) noexcept {
-            m_capacity = capacity;
-        }
+        void set_capacity(std::size_t capacity);
 
         /**
          * @brief Gets the capacity of the buffer.
          *
          * @return The capacity.
          */
-        CLUEAPI_INLINE const auto& capacity() const noexcept {
-            return m_capacity;
+        CLUEAPI_INLINE std::size_t capacity() const noexcept {
+            return m_capacity.load(std::memory_order_relaxed);
         }
 
         /**
@@ -130,10 +186,13 @@ namespace clueapi::modules::logging::detail {
          *
          * @return The number of messages in the buffer.
          */
-        CLUEAPI_INLINE auto size() const noexcept {
-            std::shared_lock<std::shared_mutex> lock{m_mutex};
+        CLUEAPI_INLINE std::size_t size() const noexcept {
+            // The consumer position is read first, so the difference never goes below zero
+            const auto pop_pos = m_pop_pos.m_value.load(std::memory_order_acquire);
+
+            const auto push_pos = m_push_pos.m_value.load(std::memory_order_acquire);
 
-            return m_buf.size();
+            return push_pos - pop_pos;
         }
 
         /**
@@ -141,29 +200,69 @@ namespace clueapi::modules::logging::detail {
          *
          * @return `true` if the buffer is empty, `false` otherwise.
          */
-        CLUEAPI_INLINE auto empty() const noexcept {
-            std::shared_lock<std::shared_mutex> lock{m_mutex};
-
-            return m_buf.empty();
+        CLUEAPI_INLINE bool empty() const noexcept {
+            return size() == 0u;
         }
 
        private:
+        /**
+         * @brief Allocates the ring for a capacity, dropping the buffered messages.
+         *
+         * @param capacity The capacity.
+         */
+        void allocate(std::size_t capacity);
+
+       private:
+        /**
+         * @struct cell_t
+         *
+         * @brief A slot of the ring.
+         */
+        struct cell_t {
+            /**
+             * @brief The position the cell is ready for: equal to a push position when free,
+             * one past it once written.
+             */
+            std::atomic<std::size_t> m_sequence{};
+
+            log_msg_t m_msg;
+        };
+
+        /**
+         * @struct position_t
+         *
+         * @brief A position of the ring, on its own cache line.
+         */
+        struct alignas(64) position_t {
+            std::atomic<std::size_t> m_value{};
+        };
+
+        /**
+         * @brief The ring of cells.
+         */
+        std::unique_ptr<cell_t[]> m_cells;
+
+        /**
+         * @brief The size of the ring minus one.
+         */
+        std::size_t m_mask{};
+
         /**
          * @brief The maximum capacity of the buffer.
          */
-        std::size_t m_capacity{};
+        std::atomic<std::size_t> m_capacity{};
 
         /**
-         * @brief The internal buffer.
+         * @brief The position of the next push.
          */
-        std::vector<log_msg_t> m_buf;
+        position_t m_push_pos;
 
         /**
-         * @brief A mutex for thread-safe access to the buffer.
+         * @brief The position of the next pop.
          */
-        mutable std::shared_mutex m_mutex;
+        position_t m_pop_pos;
     };
 } // namespace clueapi::modules::logging::detail
 #endif // CLUEAPI_USE_LOGGING_MODULE
 
-#endif // CLUEAPI_MODULES_LOGGING_DETAIL_BUFFER_HXX
\ No newline at end of file
+#endif // CLUEAPI_MODULES_LOGGING_DETAIL_BUFFER_HXX
@@ -7,47 +7,157 @@
 #include "clueapi/modules/logging/detail/buffer/buffer.hxx"
 
 #ifdef CLUEAPI_USE_LOGGING_MODULE
+#include <algorithm>
+#include <bit>
+
 namespace clueapi::modules::logging::detail {
     bool msg_buffer_t::pop(log_msg_t& msg) {
-        std::unique_lock<std::shared_mutex> lock{m_mutex};
-
-        if (m_buf.empty())
+        if (!m_cells)
             return false;
 
-        msg = std::move(m_buf.front());
+        auto pos = m_pop_pos.m_value.load(std::memory_order_relaxed);
+
+        cell_t* cell{};
+
+        for (;;) {
+            cell = &m_cells[pos & m_mask];
+
+            const auto sequence = cell->m_sequence.load(std::memory_order_acquire);
+
+            const auto diff = static_cast<std::ptrdiff_t>(sequence - (pos + 1u));
 
-        m_buf.erase(m_buf.begin());
+            // Not written yet, either empty or a producer is still moving its message in
+            if (diff < 0)
+                return false;
+
+            if (diff == 0) {
+                if (m_pop_pos.m_value.compare_exchange_weak(
+                        pos, pos + 1u, std::memory_order_acq_rel, std::memory_order_relaxed))
+                    break;
+            } else
+                pos = m_pop_pos.m_value.load(std::memory_order_relaxed);
+        }
+
+        msg = std::move(cell->m_msg);
+
+        // Frees the cell for the push one lap later
+        cell->m_sequence.store(pos + m_mask + 1u, std::memory_order_release);
 
         return true;
     }
 
     std::pair<bool, log_msg_t> msg_buffer_t::push(log_msg_t msg) {
-        std::unique_lock<std::shared_mutex> lock{m_mutex};
-
-        if (m_buf.size() >= m_capacity)
+        if (!m_cells)
             return std::make_pair(false, std::move(msg));
 
-        m_buf.push_back(std::move(msg));
+        auto pos = m_push_pos.m_value.load(std::memory_order_relaxed);
+
+        cell_t* cell{};
+
+        for (;;) {
+            cell = &m_cells[pos & m_mask];
+
+            const auto sequence = cell->m_sequence.load(std::memory_order_acquire);
+
+            const auto diff = static_cast<std::ptrdiff_t>(sequence - pos);
+
+            // The cell of the last lap isn't popped yet
+            if (diff < 0)
+                return std::make_pair(false, std::move(msg));
+
+            if (diff == 0) {
+                // Checked against the claimed position, so the bound holds under contention
+                if (pos - m_pop_pos.m_value.load(std::memory_order_acquire) >= capacity())
+                    return std::make_pair(false, std::move(msg));
+
+                if (m_push_pos.m_value.compare_exchange_weak(
+                        pos, pos + 1u, std::memory_order_acq_rel, std::memory_order_relaxed))
+                    break;
+            } else
+                pos = m_push_pos.m_value.load(std::memory_order_relaxed);
+        }
+
+        cell->m_msg = std::move(msg);
+
+        cell->m_sequence.store(pos + 1u, std::memory_order_release);
 
         return std::make_pair(true, log_msg_t{});
     }
 
+    bool msg_buffer_t::push_evicting(log_msg_t msg) {
+        if (capacity() == 0u)
+            return false;
+
+        log_msg_t old_msg{};
+
+        for (;;) {
+            auto push_pair = push(std::move(msg));
+
+            if (push_pair.first)
+                return true;
+
+            msg = std::move(push_pair.second);
+
+            // Nothing to evict, the buffer was destroyed or a pushed message isn't written yet
+            if (!pop(old_msg) && !m_cells)
+                return false;
+        }
+    }
+
     std::vector<log_msg_t> msg_buffer_t::get_batch(std::size_t size) {
         std::vector<log_msg_t> ret{};
 
-        if (m_buf.empty())
-            return ret;
+        const auto available = std::min(this->size(), size);
 
-        std::unique_lock<std::shared_mutex> lock{m_mutex};
+        if (available == 0u)
+            return ret;
 
-        ret.reserve(std::min(m_buf.size(), size));
+        ret.reserve(available);
 
-        for (std::size_t i{}; i < ret.capacity(); i++)
-            ret.push_back(std::move(m_buf.at(i)));
+        log_msg_t msg{};
 
-        m_buf.erase(m_buf.begin(), m_buf.begin() + ret.size());
+        while (ret.size() < available && pop(msg))
+            ret.push_back(std::move(msg));
 
         return ret;
     }
+
+    void msg_buffer_t::set_capacity(std::size_t capacity) {
+        // A destroyed buffer stays unallocated until the async mode is enabled again
+        if (!m_cells || capacity <= m_mask + 1u) {
+            m_capacity.store(capacity, std::memory_order_relaxed);
+
+            return;
+        }
+
+        std::vector<log_msg_t> msgs{};
+
+        log_msg_t msg{};
+
+        while (pop(msg))
+            msgs.push_back(std::move(msg));
+
+        allocate(capacity);
+
+        for (auto& buffered : msgs)
+            push(std::move(buffered));
+    }
+
+    void msg_buffer_t::allocate(std::size_t capacity) {
+        const auto size = std::bit_ceil(std::max(capacity, std::size_t{1}));
+
+        m_cells = std::make_unique<cell_t[]>(size);
+
+        for (std::size_t i{}; i < size; i++)
+            m_cells[i].m_sequence.store(i, std::memory_order_relaxed);
+
+        m_mask = size - 1u;
+
+        m_capacity.store(capacity, std::memory_order_relaxed);
+
+        m_push_pos.m_value.store(0u, std::memory_order_relaxed);
+
+        m_pop_pos.m_value.store(0u, std::memory_order_relaxed);
+    }
 } // namespace clueapi::modules::logging::detail
-#endif // CLUEAPI_USE_LOGGING_MODULE
\ No newline at end of file
+#endif // CLUEAPI_USE_LOGGING_MODULE
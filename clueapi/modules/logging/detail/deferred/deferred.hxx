@@ -0,0 +1,242 @@
+/**
+ * @file deferred.hxx
+ *
+ * @brief Defines the deferred log records, formatted by the logging thread.
+ */
+
+#ifndef CLUEAPI_MODULES_LOGGING_DETAIL_DEFERRED_HXX
+#define CLUEAPI_MODULES_LOGGING_DETAIL_DEFERRED_HXX
+
+#ifdef CLUEAPI_USE_LOGGING_MODULE
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+#include <fmt/chrono.h>
+#include <fmt/format.h>
+
+#include "clueapi/shared/macros.hxx"
+
+namespace clueapi::modules::logging::detail {
+    /**
+     * @brief The number of bytes a deferred record holds its arguments in.
+     *
+     * @internal
+     */
+    inline constexpr std::size_t k_deferred_args_size = 96u;
+
+    /**
+     * @struct deferred_t
+     *
+     * @brief The format string and the encoded arguments of a message, formatted later.
+     *
+     * @internal
+     */
+    struct deferred_t {
+        /**
+         * @brief Type alias for the function that formats the arguments of a record.
+         */
+        using format_fn_t =
+            bool (*)(std::string_view str, const std::byte* args, fmt::memory_buffer& out);
+
+        /**
+         * @brief The function that formats the record, `nullptr` for an already formatted message.
+         */
+        format_fn_t m_format{};
+
+        /**
+         * @brief The format string, a string literal.
+         */
+        std::string_view m_str;
+
+        /**
+         * @brief The encoded arguments.
+         */
+        std::array<std::byte, k_deferred_args_size> m_args;
+    };
+
+    /**
+     * @brief Checks if an argument is copied as a string, its bytes prefixed by their size.
+     *
+     * @internal
+     */
+    template <typename _type_t>
+    inline constexpr bool is_deferred_string_v =
+        std::is_same_v<std::decay_t<_type_t>, std::string> ||
+        std::is_same_v<std::decay_t<_type_t>, std::string_view>;
+
+    /**
+     * @brief Checks if a type is a `std::chrono::duration`.
+     *
+     * @internal
+     */
+    template <typename _type_t>
+    inline constexpr bool is_duration_v = false;
+
+    template <typename _rep_t, typename _period_t>
+    inline constexpr bool is_duration_v<std::chrono::duration<_rep_t, _period_t>> = true;
+
+    /**
+     * @brief Checks if an argument is copied as it is. Only plain values qualify, anything that
+     * may point to memory of the caller isn't deferred.
+     *
+     * @internal
+     */
+    template <typename _type_t>
+    inline constexpr bool is_deferred_value_v =
+        std::is_arithmetic_v<std::decay_t<_type_t>> || std::is_enum_v<std::decay_t<_type_t>> ||
+        is_duration_v<std::decay_t<_type_t>>;
+
+    /**
+     * @brief Checks if an argument can be deferred.
+     *
+     * @internal
+     */
+    template <typename _type_t>
+    inline constexpr bool is_deferrable_v =
+        is_deferred_string_v<_type_t> || is_deferred_value_v<_type_t>;
+
+    /**
+     * @brief Type alias for the type an argument is decoded as.
+     *
+     * @internal
+     */
+    template <typename _type_t>
+    using deferred_arg_t =
+        std::conditional_t<is_deferred_string_v<_type_t>, std::string_view, std::decay_t<_type_t>>;
+
+    /**
+     * @brief Gets the number of bytes an argument is encoded in.
+     *
+     * @internal
+     */
+    template <typename _type_t>
+    [[nodiscard]] CLUEAPI_INLINE std::size_t deferred_size(const _type_t& arg) noexcept {
+        if constexpr (is_deferred_string_v<_type_t>)
+            return sizeof(std::uint32_t) + std::string_view{arg}.size();
+        else
+            return sizeof(std::decay_t<_type_t>);
+    }
+
+    /**
+     * @brief Encodes an argument.
+     *
+     * @return The position past the encoded argument.
+     *
+     * @internal
+     */
+    template <typename _type_t>
+    CLUEAPI_INLINE std::byte* encode_deferred(std::byte* out, const _type_t& arg) noexcept {
+        if constexpr (is_deferred_string_v<_type_t>) {
+            const std::string_view str{arg};
+
+            const auto size = static_cast<std::uint32_t>(str.size());
+
+            std::memcpy(out, &size, sizeof(size));
+
+            std::memcpy(out + sizeof(size), str.data(), size);
+
+            return out + sizeof(size) + size;
+        } else {
+            std::memcpy(out, &arg, sizeof(arg));
+
+            return out + sizeof(arg);
+        }
+    }
+
+    /**
+     * @brief Decodes an argument, advancing past it.
+     *
+     * @internal
+     */
+    template <typename _type_t>
+    [[nodiscard]] CLUEAPI_INLINE deferred_arg_t<_type_t> decode_deferred(
+        const std::byte*& in) noexcept {
+        deferred_arg_t<_type_t> ret{};
+
+        if constexpr (is_deferred_string_v<_type_t>) {
+            std::uint32_t size{};
+
+            std::memcpy(&size, in, sizeof(size));
+
+            ret = std::string_view{reinterpret_cast<const char*>(in + sizeof(size)), size};
+
+            in += sizeof(size) + size;
+        } else {
+            std::memcpy(&ret, in, sizeof(ret));
+
+            in += sizeof(ret);
+        }
+
+        return ret;
+    }
+
+    /**
+     * @brief Formats the arguments of a record, decoded as the types they were encoded from.
+     *
+     * @internal
+     */
+    template <typename... _args_t>
+    bool format_deferred(
+        std::string_view str, const std::byte* args, fmt::memory_buffer& out) noexcept {
+        try {
+            // A braced list is evaluated in order, as the arguments were encoded
+            std::tuple<deferred_arg_t<_args_t>...> values{decode_deferred<_args_t>(args)...};
+
+            std::apply(
+                [&](const auto&... value) {
+                    fmt::format_to(std::back_inserter(out), fmt::runtime(str), value...);
+                },
+
+                values);
+
+            return true;
+        } catch (...) {
+            // ...
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief Makes the deferred record of a message, if its arguments can be deferred and fit.
+     *
+     * @param record The record to fill.
+     * @param str The format string, a string literal.
+     * @param args The format arguments.
+     *
+     * @return `true` if the record was made, `false` to format the message right away.
+     *
+     * @internal
+     */
+    template <typename... _args_t>
+    CLUEAPI_INLINE bool make_deferred(
+        deferred_t& record, std::string_view str, const _args_t&... args) noexcept {
+        if constexpr (!(is_deferrable_v<_args_t> && ...))
+            return false;
+        else {
+            if ((std::size_t{} + ... + deferred_size(args)) > k_deferred_args_size)
+                return false;
+
+            auto out = record.m_args.data();
+
+            ((out = encode_deferred(out, args)), ...);
+
+            record.m_format = &format_deferred<_args_t...>;
+
+            record.m_str = str;
+
+            return true;
+        }
+    }
+} // namespace clueapi::modules::logging::detail
+#endif // CLUEAPI_USE_LOGGING_MODULE
+
+#endif // CLUEAPI_MODULES_LOGGING_DETAIL_DEFERRED_HXX
@@ -110,6 +110,23 @@ namespace clueapi::modules::logging::detail {
         buffer.clear();
     }
 
+    /**
+     * @brief Formats the text of a deferred log message.
+     *
+     * @param msg The log message.
+     * @param buffer The buffer to format into, left empty for an already formatted message.
+     *
+     * @return `true` on success, `false` otherwise.
+     *
+     * @internal
+     */
+    CLUEAPI_INLINE bool text(const log_msg_t& msg, fmt::memory_buffer& buffer) noexcept {
+        if (!msg.m_deferred.m_format)
+            return true;
+
+        return msg.m_deferred.m_format(msg.m_deferred.m_str, msg.m_deferred.m_args.data(), buffer);
+    }
+
     /**
      * @brief Formats a log message into a batch memory buffer.
      *
@@ -127,6 +144,11 @@ namespace clueapi::modules::logging::detail {
             if (!in_time_t)
                 in_time_t = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
 
+            fmt::memory_buffer deferred{};
+
+            if (!text(msg, deferred))
+                return false;
+
             fmt::format_to(
                 std::back_inserter(buffer),
 
@@ -137,7 +159,11 @@ namespace clueapi::modules::logging::detail {
 
                 fmt::styled(lvl_to_str(msg.m_level), fmt::emphasis::bold),
 
-                fmt::styled(msg.m_msg, fg(fmt::rgb(255, 255, 230))));
+                fmt::styled(
+                    msg.m_deferred.m_format ? std::string_view{deferred.data(), deferred.size()}
+                                            : std::string_view{msg.m_msg},
+
+                    fg(fmt::rgb(255, 255, 230))));
 
             return true;
         } catch (...) {
@@ -164,6 +190,11 @@ namespace clueapi::modules::logging::detail {
             if (!in_time_t)
                 in_time_t = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
 
+            fmt::memory_buffer deferred{};
+
+            if (!text(msg, deferred))
+                return false;
+
             fmt::format_to(
                 std::back_inserter(buffer),
 
@@ -174,7 +205,11 @@ namespace clueapi::modules::logging::detail {
 
                 fmt::styled(lvl_to_str(msg.m_level), fmt::emphasis::bold),
 
-                fmt::styled(msg.m_msg, fg(fmt::rgb(255, 255, 230))));
+                fmt::styled(
+                    msg.m_deferred.m_format ? std::string_view{deferred.data(), deferred.size()}
+                                            : std::string_view{msg.m_msg},
+
+                    fg(fmt::rgb(255, 255, 230))));
 
             return true;
         } catch (...) {
@@ -11,6 +11,7 @@
 #include <chrono>
 #include <string>
 
+#include "clueapi/modules/logging/detail/deferred/deferred.hxx"
 #include "clueapi/modules/logging/detail/level/level.hxx"
 
 namespace clueapi::modules::logging::detail {
@@ -19,6 +20,9 @@ namespace clueapi::modules::logging::detail {
      *
      * @brief Represents a single log message.
      *
+     * @details The message is either formatted by the caller into `m_msg`, or kept as a deferred
+     * record that the logging thread formats.
+     *
      * @internal
      */
     struct log_msg_t {
@@ -36,6 +40,11 @@ namespace clueapi::modules::logging::detail {
          * @brief The timestamp of the log message.
          */
         std::chrono::system_clock::time_point m_time;
+
+        /**
+         * @brief The deferred record, formatted by the logging thread instead of `m_msg`.
+         */
+        deferred_t m_deferred{};
     };
 } // namespace clueapi::modules::logging::detail
 #endif // CLUEAPI_USE_LOGGING_MODULE
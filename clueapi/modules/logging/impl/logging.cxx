@@ -81,6 +81,17 @@ namespace clueapi::modules::logging {
         return m_loggers.at(hash);
     }
 
+    std::uint64_t c_logging::dropped() {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+
+        std::uint64_t ret{};
+
+        for (const auto& [hash, logger] : m_loggers)
+            ret += logger->dropped();
+
+        return ret;
+    }
+
     void c_logging::process_async() {
         while (m_is_running.load(std::memory_order_relaxed)) {
             std::vector<std::shared_ptr<base_logger_t>> loggers;
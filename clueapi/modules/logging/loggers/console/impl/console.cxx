@@ -30,20 +30,7 @@ namespace clueapi::modules::logging {
     }
 
     void console_logger_t::handle_overflow(detail::log_msg_t msg) {
-        if (m_buffer.empty()) {
-            m_buffer.push(std::move(msg));
-
-            return;
-        }
-
-        detail::log_msg_t old_msg{};
-
-        if (!m_buffer.pop(old_msg))
-            return;
-
-        m_buffer.push(std::move(msg));
-
-        m_prv_params.m_condition->notify_one();
+        push_overflowed(std::move(msg));
     }
 
     void console_logger_t::log(detail::log_msg_t msg) {
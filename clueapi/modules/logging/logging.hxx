@@ -10,10 +10,15 @@
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
+#include <string>
 #include <string_view>
 #include <thread>
+#include <type_traits>
 #include <utility>
 
 #include "clueapi/shared/macros.hxx"
@@ -41,6 +46,11 @@ namespace clueapi::modules::logging {
      */
     using logger_params_t = detail::logger_params_t;
 
+    /**
+     * @brief A type alias for the overflow policy enumeration.
+     */
+    using e_overflow_policy = detail::e_overflow_policy;
+
     /**
      * @brief A type alias for the base logger class.
      */
@@ -119,6 +129,13 @@ namespace clueapi::modules::logging {
          */
         std::shared_ptr<base_logger_t> get_logger(detail::hash_t hash);
 
+        /**
+         * @brief Gets the number of messages all loggers lost to a full buffer.
+         *
+         * @return The number of dropped messages.
+         */
+        std::uint64_t dropped();
+
        public:
         /**
          * @brief Checks if the logging system is running.
@@ -188,11 +205,80 @@ namespace clueapi::modules::logging {
         shared::unordered_map_t<detail::hash_t, std::shared_ptr<base_logger_t>> m_loggers;
     };
 
+    namespace detail {
+        /**
+         * @struct literal_t
+         *
+         * @brief A format string that is known to be a string literal.
+         *
+         * @details Only a constant character array with static storage binds to it, so the string
+         * outlives a message whose formatting is deferred to the logging thread.
+         *
+         * @internal
+         */
+        struct literal_t {
+            /**
+             * @brief Constructs the format string from a string literal.
+             *
+             * @tparam _size The size of the literal, including the null terminator.
+             *
+             * @param str The string literal.
+             */
+            template <std::size_t _size>
+            consteval literal_t(const char (&str)[_size]) noexcept
+                : m_str{str, std::char_traits<char>::length(str)} {
+            }
+
+            /**
+             * @brief The view of the literal, without the null terminator.
+             */
+            std::string_view m_str;
+        };
+
+        /**
+         * @brief Gets the logger a message goes to, if it takes messages of its level.
+         *
+         * @internal
+         */
+        template <typename _logging_t>
+        CLUEAPI_INLINE std::shared_ptr<base_logger_t> logger_of(
+            _logging_t&& logging, hash_t hash, e_log_level level) {
+            std::shared_ptr<base_logger_t> ret{};
+
+            if constexpr (std::is_pointer_v<std::remove_reference_t<_logging_t>>)
+                ret = logging->get_logger(hash);
+            else
+                ret = logging.get_logger(hash);
+
+            if (!ret || level < ret->level())
+                return nullptr;
+
+            return ret;
+        }
+
+        /**
+         * @brief Formats a log message.
+         *
+         * @internal
+         */
+        template <typename... _args_t>
+        CLUEAPI_INLINE log_msg_t make_msg(
+            e_log_level level, std::string_view str, _args_t&&... args) {
+            return log_msg_t{
+                .m_msg = fmt::format(fmt::runtime(str), std::forward<_args_t>(args)...),
+
+                .m_level = level,
+
+                .m_time = std::chrono::system_clock::now()};
+        }
+    } // namespace detail
+
     /**
      * @brief A dispatch function for logging messages.
      *
      * @tparam _args_t The types of the format arguments.
      * @tparam _logging_t The type of the logging system instance.
+     * @tparam _str_t The type of the format string, anything but a character array.
      *
      * @param logging The logging system instance.
      * @param hash The hash of the logger's name.
@@ -200,7 +286,9 @@ namespace clueapi::modules::logging {
      * @param str The format string.
      * @param args The format arguments.
      */
-    template <typename... _args_t, typename _logging_t>
+    template <typename... _args_t, typename _logging_t, typename _str_t>
+        requires(
+            !std::is_array_v<_str_t> && std::is_convertible_v<const _str_t&, std::string_view>)
     CLUEAPI_INLINE void log_dispatch(
         _logging_t&& logging,
 
@@ -208,31 +296,63 @@ namespace clueapi::modules::logging {
 
         e_log_level level,
 
-        std::string_view str,
+        const _str_t& str,
 
         _args_t&&... args) {
-        log_msg_t msg{
-            .m_msg = fmt::format(fmt::runtime(str), std::forward<_args_t>(args)...),
+        auto logger = detail::logger_of(std::forward<_logging_t>(logging), hash, level);
 
-            .m_level = level,
+        if (!logger)
+            return;
 
-            .m_time = std::chrono::system_clock::now()};
+        logger->log(
+            detail::make_msg(level, std::string_view{str}, std::forward<_args_t>(args)...));
+    }
 
-        if constexpr (std::is_pointer_v<std::remove_reference_t<_logging_t>>) {
-            auto logger = logging->get_logger(hash);
+    /**
+     * @brief A dispatch function for logging messages with a string literal as format string.
+     *
+     * @details The message is deferred to the logging thread if the logger has
+     * `logger_params_t::m_deferred_format` set and its arguments can be deferred, and is
+     * formatted right away otherwise.
+     *
+     * @tparam _args_t The types of the format arguments.
+     * @tparam _logging_t The type of the logging system instance.
+     *
+     * @param logging The logging system instance.
+     * @param hash The hash of the logger's name.
+     * @param level The log level.
+     * @param str The format string.
+     * @param args The format arguments.
+     *
+     * @note Only string literals bind here; pass any other character array as a
+     * `std::string_view`, which is always formatted right away.
+     */
+    template <typename... _args_t, typename _logging_t>
+    CLUEAPI_INLINE void log_dispatch(
+        _logging_t&& logging,
 
-            if (!logger)
-                return;
+        detail::hash_t hash,
 
-            return logger->log(std::move(msg));
-        } else {
-            auto logger = logging.get_logger(hash);
+        e_log_level level,
 
-            if (!logger)
-                return;
+        detail::literal_t str,
 
-            logger->log(std::move(msg));
+        _args_t&&... args) {
+        auto logger = detail::logger_of(std::forward<_logging_t>(logging), hash, level);
+
+        if (!logger)
+            return;
+
+        const std::string_view str_view = str.m_str;
+
+        if (logger->async_mode() && logger->params().m_deferred_format) {
+            log_msg_t msg{.m_level = level, .m_time = std::chrono::system_clock::now()};
+
+            if (detail::make_deferred(msg.m_deferred, str_view, args...))
+                return logger->log(std::move(msg));
         }
+
+        logger->log(detail::make_msg(level, str_view, std::forward<_args_t>(args)...));
     }
 } // namespace clueapi::modules::logging
 
@@ -19,6 +19,10 @@
 #include "redis/redis.hxx"
 #endif // CLUEAPI_USE_REDIS_MODULE
 
+#ifdef CLUEAPI_USE_COMPRESSION_MODULE
+#include "compression/compression.hxx"
+#endif // CLUEAPI_USE_COMPRESSION_MODULE
+
 /**
  * @namespace clueapi::modules
  *
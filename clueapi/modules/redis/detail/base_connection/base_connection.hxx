@@ -16,6 +16,7 @@
 
 #include <atomic>
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -195,6 +196,24 @@ namespace clueapi::modules::redis::detail {
              * @brief Whether to use SSL/TLS for the connection.
              */
             bool m_use_ssl{false};
+
+            /**
+             * @brief Whether the single-key calls issued within one tick of the I/O context are
+             * coalesced into one pipelined request.
+             */
+            bool m_auto_pipeline{false};
+
+            /**
+             * @brief The maximum number of entries of the near-cache of the `GET` and `HGETALL`
+             * reads, zero to disable it.
+             */
+            std::size_t m_near_cache_size{0u};
+
+            /**
+             * @brief The time a value is kept in the near-cache, if no invalidation drops it
+             * first.
+             */
+            std::chrono::seconds m_near_cache_ttl{60};
         };
 
        public:
@@ -1,6 +1,10 @@
 #include "clueapi/modules/redis/detail/base_connection/base_connection.hxx"
 
+#include <string>
 #include <utility>
+#include <vector>
+
+#include <boost/version.hpp>
 
 #include <fmt/core.h>
 #include <fmt/format.h>
@@ -52,6 +56,35 @@ namespace clueapi::modules::redis::detail {
             cfg.use_ssl = m_cfg.m_use_ssl;
         }
 
+#if BOOST_VERSION >= 108500
+        // Boost.Redis reconnects on its own, the tracking of the near-cache is turned on again
+        // with each handshake rather than at the next check
+        if (m_cfg.m_near_cache_size != 0u) {
+            std::vector<std::string> hello{"3"};
+
+            if (!m_cfg.m_password.empty())
+                hello.insert(
+                    hello.end(),
+                    {"AUTH",
+                     m_cfg.m_username.empty() ? std::string{"default"} : m_cfg.m_username,
+                     m_cfg.m_password});
+
+            if (!m_cfg.m_client_name.empty())
+                hello.insert(hello.end(), {"SETNAME", m_cfg.m_client_name});
+
+            cfg.use_setup = true;
+
+            cfg.setup.clear();
+
+            cfg.setup.push_range("HELLO", hello);
+
+            if (m_cfg.m_db >= 0)
+                cfg.setup.push("SELECT", m_cfg.m_db);
+
+            cfg.setup.push("CLIENT", "TRACKING", "ON");
+        }
+#endif
+
         m_raw_cfg = std::move(cfg);
     }
 
@@ -0,0 +1,250 @@
+/**
+ * @file batch.hxx
+ *
+ * @brief Defines a typed batch of Redis commands, sent as one request.
+ *
+ * @internal
+ */
+
+#ifndef CLUEAPI_MODULES_REDIS_DETAIL_BATCH_HXX
+#define CLUEAPI_MODULES_REDIS_DETAIL_BATCH_HXX
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <boost/redis/request.hpp>
+#include <boost/redis/response.hpp>
+
+#include "clueapi/shared/macros.hxx"
+
+namespace clueapi::modules::redis::detail {
+    /**
+     * @struct batch_t
+     *
+     * @brief A batch of Redis commands, pipelined in one request and awaited once.
+     *
+     * @details Each command appends its reply type to the batch type, so the results come back
+     * as a typed tuple, in the order of the commands:
+     *
+     * @code
+     * auto batch = connection_t::batch()
+     *                  .get<std::string>("user:1:name")
+     *                  .hget("user:1", "mail")
+     *                  .incr("visits");
+     *
+     * // std::optional<std::tuple<std::optional<std::string>, std::optional<std::string>,
+     * // std::int64_t>>
+     * auto results = co_await connection->async_exec(batch);
+     * @endcode
+     *
+     * @tparam _types_t The reply types of the commands.
+     *
+     * @internal
+     */
+    template <typename... _types_t>
+    struct batch_t {
+        /**
+         * @brief The response filled by the batch.
+         */
+        using response_t = boost::redis::response<_types_t...>;
+
+        /**
+         * @brief The results of the batch.
+         */
+        using results_t = std::tuple<_types_t...>;
+
+       public:
+        CLUEAPI_INLINE batch_t() = default;
+
+        /**
+         * @brief Constructs a batch from the request of the previous one.
+         *
+         * @param req The request.
+         */
+        CLUEAPI_INLINE explicit batch_t(boost::redis::request req) : m_req{std::move(req)} {
+        }
+
+       public:
+        /**
+         * @brief Appends any command.
+         *
+         * @tparam _type_t The reply type of the command.
+         *
+         * @param cmd The command.
+         * @param args The arguments of the command.
+         *
+         * @return The batch with the command.
+         */
+        template <typename _type_t, typename... _args_t>
+        CLUEAPI_INLINE batch_t<_types_t..., _type_t> push(
+            std::string_view cmd, const _args_t&... args) && {
+            m_req.push(cmd, args...);
+
+            return batch_t<_types_t..., _type_t>{std::move(m_req)};
+        }
+
+        /**
+         * @brief Appends a `GET`.
+         */
+        template <typename _type_t>
+        CLUEAPI_INLINE auto get(std::string_view key) && {
+            return std::move(*this).template push<std::optional<_type_t>>("GET", key);
+        }
+
+        /**
+         * @brief Appends a `MGET`, replying the values in the order of the keys.
+         */
+        template <typename _type_t>
+        CLUEAPI_INLINE auto mget(const std::vector<std::string_view>& keys) && {
+            m_req.push_range("MGET", keys);
+
+            return batch_t<_types_t..., std::vector<std::optional<_type_t>>>{std::move(m_req)};
+        }
+
+        /**
+         * @brief Appends a `SET`, with a TTL if it isn't zero.
+         */
+        CLUEAPI_INLINE auto set(
+            std::string_view key,
+            std::string_view value,
+
+            std::chrono::seconds ttl = std::chrono::seconds{0}) && {
+            if (ttl.count() > 0)
+                return std::move(*this).template push<std::string>(
+                    "SET", key, value, "EX", std::to_string(ttl.count()));
+
+            return std::move(*this).template push<std::string>("SET", key, value);
+        }
+
+        /**
+         * @brief Appends a `MSET`.
+         */
+        CLUEAPI_INLINE auto mset(
+            const std::unordered_map<std::string_view, std::string_view>& mapping) && {
+            m_req.push_range("MSET", mapping);
+
+            return batch_t<_types_t..., std::string>{std::move(m_req)};
+        }
+
+        /**
+         * @brief Appends a `DEL`, replying the number of keys removed.
+         */
+        CLUEAPI_INLINE auto del(std::string_view key) && {
+            return std::move(*this).template push<std::int64_t>("DEL", key);
+        }
+
+        /**
+         * @brief Appends an `EXISTS`.
+         */
+        CLUEAPI_INLINE auto exists(std::string_view key) && {
+            return std::move(*this).template push<std::int64_t>("EXISTS", key);
+        }
+
+        /**
+         * @brief Appends an `EXPIRE`.
+         */
+        CLUEAPI_INLINE auto expire(std::string_view key, std::chrono::seconds ttl) && {
+            return std::move(*this).template push<std::int64_t>(
+                "EXPIRE", key, std::to_string(ttl.count()));
+        }
+
+        /**
+         * @brief Appends a `TTL`.
+         */
+        CLUEAPI_INLINE auto ttl(std::string_view key) && {
+            return std::move(*this).template push<std::int64_t>("TTL", key);
+        }
+
+        /**
+         * @brief Appends an `INCR`.
+         */
+        CLUEAPI_INLINE auto incr(std::string_view key) && {
+            return std::move(*this).template push<std::int64_t>("INCR", key);
+        }
+
+        /**
+         * @brief Appends a `DECR`.
+         */
+        CLUEAPI_INLINE auto decr(std::string_view key) && {
+            return std::move(*this).template push<std::int64_t>("DECR", key);
+        }
+
+        /**
+         * @brief Appends a `LPUSH`.
+         */
+        CLUEAPI_INLINE auto lpush(std::string_view key, std::string_view value) && {
+            return std::move(*this).template push<std::int64_t>("LPUSH", key, value);
+        }
+
+        /**
+         * @brief Appends a `LRANGE`.
+         */
+        CLUEAPI_INLINE auto lrange(std::string_view key, std::int32_t start, std::int32_t end) && {
+            return std::move(*this).template push<std::vector<std::string>>(
+                "LRANGE", key, std::to_string(start), std::to_string(end));
+        }
+
+        /**
+         * @brief Appends a `HGET`.
+         */
+        CLUEAPI_INLINE auto hget(std::string_view key, std::string_view field) && {
+            return std::move(*this).template push<std::optional<std::string>>("HGET", key, field);
+        }
+
+        /**
+         * @brief Appends a `HSET` of a single field.
+         */
+        CLUEAPI_INLINE auto hset(
+            std::string_view key, std::string_view field, std::string_view value) && {
+            return std::move(*this).template push<std::int64_t>("HSET", key, field, value);
+        }
+
+        /**
+         * @brief Appends a `HINCRBY`.
+         */
+        CLUEAPI_INLINE auto hincrby(
+            std::string_view key, std::string_view field, std::int32_t increment) && {
+            return std::move(*this).template push<std::int64_t>(
+                "HINCRBY", key, field, std::to_string(increment));
+        }
+
+        /**
+         * @brief Appends a `HGETALL`.
+         */
+        CLUEAPI_INLINE auto hgetall(std::string_view key) && {
+            return std::move(*this).template push<std::unordered_map<std::string, std::string>>(
+                "HGETALL", key);
+        }
+
+       public:
+        /**
+         * @brief Gets the request of the batch.
+         *
+         * @return The request.
+         */
+        [[nodiscard]] CLUEAPI_INLINE const auto& request() const noexcept {
+            return m_req;
+        }
+
+        /**
+         * @brief Gets the number of commands of the batch.
+         *
+         * @return The number of commands.
+         */
+        [[nodiscard]] static constexpr std::size_t size() noexcept {
+            return sizeof...(_types_t);
+        }
+
+       private:
+        boost::redis::request m_req;
+    };
+} // namespace clueapi::modules::redis::detail
+
+#endif // CLUEAPI_MODULES_REDIS_DETAIL_BATCH_HXX
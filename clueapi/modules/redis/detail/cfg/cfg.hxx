@@ -11,6 +11,7 @@
 #define CLUEAPI_MODULES_REDIS_DETAIL_CFG_HXX
 
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <string>
 
@@ -77,6 +78,23 @@ namespace clueapi::modules::redis::detail {
          * @brief The logging level for Redis operations.
          */
         boost::redis::logger::level m_log_level{boost::redis::logger::level::info};
+
+        /**
+         * @brief Whether the single-key calls issued within one tick of the I/O context are
+         * coalesced into one pipelined request.
+         */
+        bool m_auto_pipeline{false};
+
+        /**
+         * @brief The maximum number of entries of the near-cache of the `GET` and `HGETALL`
+         * reads, zero to disable it.
+         */
+        std::size_t m_near_cache_size{0u};
+
+        /**
+         * @brief The time a value is kept in the near-cache, if no invalidation drops it first.
+         */
+        std::chrono::seconds m_near_cache_ttl{60};
     };
 } // namespace clueapi::modules::redis::detail
 
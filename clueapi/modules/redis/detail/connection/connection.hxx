@@ -13,11 +13,15 @@
 #ifndef CLUEAPI_MODULES_REDIS_DETAIL_CONNECTION_HXX
 #define CLUEAPI_MODULES_REDIS_DETAIL_CONNECTION_HXX
 
+#include <atomic>
 #include <chrono>
 #include <cstdint>
+#include <memory>
 #include <optional>
 #include <string>
+#include <tuple>
 #include <string_view>
+#include <type_traits>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -32,6 +36,10 @@
 #include <boost/system/system_error.hpp>
 
 #include "clueapi/modules/redis/detail/base_connection/base_connection.hxx"
+#include "clueapi/modules/redis/detail/batch/batch.hxx"
+#include "clueapi/modules/redis/detail/cursor/cursor.hxx"
+#include "clueapi/modules/redis/detail/near_cache/near_cache.hxx"
+#include "clueapi/modules/redis/detail/pipeline/pipeline.hxx"
 
 #include "clueapi/shared/macros.hxx"
 #include "clueapi/shared/shared.hxx"
@@ -59,6 +67,12 @@ namespace clueapi::modules::redis::detail {
          */
         CLUEAPI_INLINE connection_t(cfg_t cfg, boost::asio::io_context& io_ctx)
             : base_t{std::move(cfg), io_ctx} {
+            if (m_cfg.m_auto_pipeline)
+                m_pipeline = std::make_shared<pipeline_t>(m_connection, io_ctx);
+
+            if (m_cfg.m_near_cache_size != 0u)
+                m_near_cache =
+                    std::make_shared<near_cache_t>(m_cfg.m_near_cache_size, m_cfg.m_near_cache_ttl);
         }
 
        public:
@@ -114,6 +128,17 @@ namespace clueapi::modules::redis::detail {
             co_return ec;
         }
 
+        /**
+         * @brief Executes a Redis request asynchronously, into the nodes of its replies.
+         *
+         * @param req The Redis request to execute.
+         * @param resp The generic response to populate.
+         *
+         * @return An awaitable that resolves to the error code of the operation.
+         */
+        shared::awaitable_t<boost::system::error_code> async_exec(
+            const boost::redis::request& req, boost::redis::generic_response& resp);
+
         /**
          * @brief Executes a Redis request synchronously.
          *
@@ -140,6 +165,169 @@ namespace clueapi::modules::redis::detail {
             return ec;
         }
 
+       public:
+        /**
+         * @brief Starts an empty batch of commands.
+         *
+         * @return The batch, to chain the commands onto.
+         */
+        [[nodiscard]] static CLUEAPI_INLINE batch_t<> batch() noexcept {
+            return batch_t<>{};
+        }
+
+        /**
+         * @brief Executes a batch of commands asynchronously, in one request.
+         *
+         * @tparam _types_t The reply types of the commands.
+         *
+         * @param batch The batch.
+         *
+         * @return An awaitable that resolves to the replies in the order of the commands, or
+         * `std::nullopt` if the request failed.
+         */
+        template <typename... _types_t>
+        CLUEAPI_NOINLINE shared::awaitable_t<std::optional<std::tuple<_types_t...>>> async_exec(
+            const batch_t<_types_t...>& batch) {
+            typename batch_t<_types_t...>::response_t resp{};
+
+            auto ec = co_await async_exec(batch.request(), resp);
+
+            if (ec)
+                co_return std::nullopt;
+
+            co_return std::apply(
+                [](auto&... results) {
+                    return std::tuple<_types_t...>{std::move(results.value())...};
+                },
+                resp);
+        }
+
+        /**
+         * @brief Executes a batch of commands synchronously, in one request.
+         *
+         * @tparam _types_t The reply types of the commands.
+         *
+         * @param batch The batch.
+         *
+         * @return The replies in the order of the commands, or `std::nullopt` if the request
+         * failed.
+         */
+        template <typename... _types_t>
+        CLUEAPI_NOINLINE std::optional<std::tuple<_types_t...>> exec(
+            const batch_t<_types_t...>& batch) {
+            typename batch_t<_types_t...>::response_t resp{};
+
+            auto ec = exec(batch.request(), resp);
+
+            if (ec)
+                return std::nullopt;
+
+            return std::apply(
+                [](auto&... results) {
+                    return std::tuple<_types_t...>{std::move(results.value())...};
+                },
+                resp);
+        }
+
+       public:
+        /**
+         * @brief Gets the values of several keys in one `MGET`.
+         *
+         * @tparam _type_t The expected type of the values.
+         *
+         * @param keys The keys to retrieve.
+         *
+         * @return An awaitable that resolves to the values in the order of the keys, empty if the
+         * request failed.
+         */
+        template <typename _type_t>
+        CLUEAPI_NOINLINE shared::awaitable_t<std::vector<std::optional<_type_t>>> async_mget(
+            const std::vector<std::string_view>& keys) {
+            if (keys.empty())
+                co_return std::vector<std::optional<_type_t>>{};
+
+            auto results = co_await async_exec(batch().mget<_type_t>(keys));
+
+            if (!results.has_value())
+                co_return std::vector<std::optional<_type_t>>{};
+
+            co_return std::move(std::get<0>(*results));
+        }
+
+        /**
+         * @brief Sets several key-value pairs in one `MSET`.
+         *
+         * @param mapping The key-value pairs to set.
+         *
+         * @return An awaitable that resolves to `true` if successful, `false` otherwise.
+         */
+        shared::awaitable_t<bool> async_mset(
+            const std::unordered_map<std::string_view, std::string_view>& mapping);
+
+       public:
+        /**
+         * @brief Starts a `SCAN` over the keys of the database.
+         *
+         * @param cfg The cursor configuration.
+         *
+         * @return The cursor, that sends nothing until its first page is fetched.
+         */
+        [[nodiscard]] CLUEAPI_INLINE cursor_t scan(cursor_t::cfg_t cfg = {}) {
+            return cursor_t{*this, cursor_t::scan, std::string{}, std::move(cfg)};
+        }
+
+        /**
+         * @brief Starts a `HSCAN` over the fields and values of a hash.
+         *
+         * @param key The hash key.
+         * @param cfg The cursor configuration.
+         *
+         * @return The cursor, that sends nothing until its first page is fetched.
+         */
+        [[nodiscard]] CLUEAPI_INLINE cursor_t hscan(
+            std::string_view key, cursor_t::cfg_t cfg = {}) {
+            return cursor_t{*this, cursor_t::hscan, std::string{key}, std::move(cfg)};
+        }
+
+        /**
+         * @brief Starts a `SSCAN` over the members of a set.
+         *
+         * @param key The set key.
+         * @param cfg The cursor configuration.
+         *
+         * @return The cursor, that sends nothing until its first page is fetched.
+         */
+        [[nodiscard]] CLUEAPI_INLINE cursor_t sscan(
+            std::string_view key, cursor_t::cfg_t cfg = {}) {
+            return cursor_t{*this, cursor_t::sscan, std::string{key}, std::move(cfg)};
+        }
+
+        /**
+         * @brief Starts a `ZSCAN` over the members and scores of a sorted set.
+         *
+         * @param key The sorted set key.
+         * @param cfg The cursor configuration.
+         *
+         * @return The cursor, that sends nothing until its first page is fetched.
+         */
+        [[nodiscard]] CLUEAPI_INLINE cursor_t zscan(
+            std::string_view key, cursor_t::cfg_t cfg = {}) {
+            return cursor_t{*this, cursor_t::zscan, std::string{key}, std::move(cfg)};
+        }
+
+        /**
+         * @brief Starts iterating over a list in `LRANGE` pages.
+         *
+         * @param key The list key.
+         * @param count The number of elements of a page.
+         *
+         * @return The cursor, that sends nothing until its first page is fetched.
+         */
+        [[nodiscard]] CLUEAPI_INLINE cursor_t lrange_pages(
+            std::string_view key, std::size_t count = 100u) {
+            return cursor_t{*this, cursor_t::lrange, std::string{key}, {.m_count = count}};
+        }
+
        public:
         /**
          * @brief Gets a value from Redis by key.
@@ -153,6 +341,20 @@ namespace clueapi::modules::redis::detail {
         template <typename _type_t>
         CLUEAPI_NOINLINE shared::awaitable_t<std::optional<_type_t>> async_get(
             const std::string_view& key) {
+            if constexpr (std::is_same_v<_type_t, std::string>) {
+                if (is_caching())
+                    co_return co_await async_get_cached(key);
+
+                if (is_pipelining()) {
+                    auto reply = co_await m_pipeline->async_exec("GET", key);
+
+                    if (!reply.has_value() || reply->m_is_null)
+                        co_return std::nullopt;
+
+                    co_return std::move(reply->m_value);
+                }
+            }
+
             boost::redis::request req{};
 
             req.push("GET", key);
@@ -566,6 +768,94 @@ namespace clueapi::modules::redis::detail {
          * otherwise.
          */
         std::optional<std::int32_t> sync_decr(const std::string_view& key);
+
+       public:
+        /**
+         * @brief Gets the counters of the near-cache.
+         *
+         * @return The counters, or `std::nullopt` if the near-cache is disabled.
+         */
+        [[nodiscard]] CLUEAPI_INLINE std::optional<near_cache_t::stats_t> near_cache_stats()
+            const noexcept {
+            if (!m_near_cache)
+                return std::nullopt;
+
+            return m_near_cache->stats();
+        }
+
+       protected:
+        /**
+         * @brief Checks if the reads of the caller go through the near-cache.
+         *
+         * @return `true` if the near-cache is enabled and tracked, and the caller runs on the I/O
+         * context of the connection.
+         */
+        [[nodiscard]] CLUEAPI_INLINE bool is_caching() const noexcept {
+            return m_near_cache && m_near_cache->is_enabled() &&
+                   m_io_ctx->get_executor().running_in_this_thread();
+        }
+
+        /**
+         * @brief Drops a key from the near-cache before it is written.
+         *
+         * @param key The key.
+         */
+        CLUEAPI_INLINE void forget(std::string_view key) {
+            if (is_caching())
+                m_near_cache->invalidate(key);
+        }
+
+        /**
+         * @brief Gets a string value through the near-cache.
+         */
+        shared::awaitable_t<std::optional<std::string>> async_get_cached(std::string_view key);
+
+        /**
+         * @brief Enables the tracking of the keys read, and drops the near-cache if the server
+         * reconnected in between.
+         */
+        shared::awaitable_t<bool> async_track();
+
+        /**
+         * @brief Applies the invalidations pushed by the server, until the connection is closed.
+         */
+        static shared::awaitable_t<void> receive(
+            std::shared_ptr<raw_connection_t> connection,
+            std::shared_ptr<near_cache_t> near_cache,
+            std::shared_ptr<std::atomic<bool>> is_receiving);
+
+       protected:
+        /**
+         * @brief Checks if the calls of the caller are pipelined.
+         *
+         * @return `true` if automatic pipelining is enabled, and the caller runs on the I/O
+         * context of the connection.
+         */
+        [[nodiscard]] CLUEAPI_INLINE bool is_pipelining() const noexcept {
+            return m_pipeline && m_pipeline->is_local();
+        }
+
+       protected:
+        /**
+         * @brief The automatic pipelining of the single-key calls, if enabled.
+         */
+        std::shared_ptr<pipeline_t> m_pipeline;
+
+        /**
+         * @brief The near-cache of the reads, if enabled.
+         */
+        std::shared_ptr<near_cache_t> m_near_cache;
+
+        /**
+         * @brief The `CLIENT ID` the tracking was enabled on, that changes on a reconnection.
+         */
+        std::int64_t m_client_id{-1};
+
+        /**
+         * @brief Whether the invalidations are received, shared with the receiving coroutine.
+         */
+        std::shared_ptr<std::atomic<bool>> m_is_receiving{
+            std::make_shared<std::atomic<bool>>(false)};
     };
 } // namespace clueapi::modules::redis::detail
 
@@ -7,6 +7,9 @@
 #include <unordered_map>
 #include <vector>
 
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/redirect_error.hpp>
 #include <boost/asio/steady_timer.hpp>
 #include <boost/asio/use_awaitable.hpp>
 #include <boost/redis/request.hpp>
@@ -58,6 +61,9 @@ namespace clueapi::modules::redis::detail {
             if (!ec && std::get<0>(resp).value() == "PONG") {
                 m_state.set(state_t::connected);
 
+                if (m_near_cache)
+                    co_await async_track();
+
                 co_return true;
             }
 
@@ -106,6 +112,9 @@ namespace clueapi::modules::redis::detail {
         if (!ec && std::get<0>(resp).value() == "PONG") {
             m_state.set(state_t::connected);
 
+            if (m_near_cache)
+                co_await async_track();
+
             co_return true;
         }
 
@@ -209,8 +218,32 @@ namespace clueapi::modules::redis::detail {
         return false;
     }
 
+    shared::awaitable_t<boost::system::error_code> connection_t::async_exec(
+        const boost::redis::request& req, boost::redis::generic_response& resp) {
+        boost::system::error_code ec{};
+
+        co_await m_connection->async_exec(
+            req, resp, boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+
+        co_return ec;
+    }
+
     shared::awaitable_t<bool> connection_t::async_set(
         const std::string_view& key, const std::string_view& value, std::chrono::seconds ttl) {
+        forget(key);
+
+        if (is_pipelining()) {
+            std::optional<pipeline_t::reply_t> reply{};
+
+            if (ttl.count() > 0)
+                reply = co_await m_pipeline->async_exec(
+                    "SET", key, value, "EX", std::to_string(ttl.count()));
+            else
+                reply = co_await m_pipeline->async_exec("SET", key, value);
+
+            co_return reply.has_value() && reply->m_value == "OK";
+        }
+
         boost::redis::request req{};
 
         if (ttl.count() > 0) {
@@ -229,6 +262,14 @@ namespace clueapi::modules::redis::detail {
     }
 
     shared::awaitable_t<bool> connection_t::async_del(const std::string_view& key) {
+        forget(key);
+
+        if (is_pipelining()) {
+            auto reply = co_await m_pipeline->async_exec("DEL", key);
+
+            co_return reply.has_value() && reply->to_int().value_or(0) > 0;
+        }
+
         boost::redis::request req{};
 
         req.push("DEL", key);
@@ -244,6 +285,12 @@ namespace clueapi::modules::redis::detail {
     }
 
     shared::awaitable_t<bool> connection_t::async_exists(const std::string_view& key) {
+        if (is_pipelining()) {
+            auto reply = co_await m_pipeline->async_exec("EXISTS", key);
+
+            co_return reply.has_value() && reply->to_int().value_or(0) > 0;
+        }
+
         boost::redis::request req{};
 
         req.push("EXISTS", key);
@@ -260,6 +307,15 @@ namespace clueapi::modules::redis::detail {
 
     shared::awaitable_t<bool> connection_t::async_expire(
         const std::string_view& key, std::chrono::seconds ttl) {
+        forget(key);
+
+        if (is_pipelining()) {
+            auto reply =
+                co_await m_pipeline->async_exec("EXPIRE", key, std::to_string(ttl.count()));
+
+            co_return reply.has_value() && reply->to_int() == 1;
+        }
+
         boost::redis::request req{};
 
         req.push("EXPIRE", key, std::to_string(ttl.count()));
@@ -275,6 +331,15 @@ namespace clueapi::modules::redis::detail {
     }
 
     shared::awaitable_t<std::int32_t> connection_t::async_ttl(const std::string_view& key) {
+        if (is_pipelining()) {
+            auto reply = co_await m_pipeline->async_exec("TTL", key);
+
+            if (!reply.has_value())
+                co_return 0;
+
+            co_return static_cast<std::int32_t>(reply->to_int().value_or(0));
+        }
+
         boost::redis::request req{};
 
         req.push("TTL", key);
@@ -291,6 +356,8 @@ namespace clueapi::modules::redis::detail {
 
     shared::awaitable_t<std::int32_t> connection_t::async_lpush(
         const std::string_view& key, const std::string_view& value) {
+        forget(key);
+
         boost::redis::request req{};
 
         req.push("LPUSH", key, value);
@@ -307,6 +374,8 @@ namespace clueapi::modules::redis::detail {
 
     shared::awaitable_t<bool> connection_t::async_ltrim(
         const std::string_view& key, std::int32_t start, std::int32_t end) {
+        forget(key);
+
         boost::redis::request req{};
 
         req.push("LTRIM", key, std::to_string(start), std::to_string(end));
@@ -340,6 +409,8 @@ namespace clueapi::modules::redis::detail {
     shared::awaitable_t<std::int32_t> connection_t::async_hset(
         const std::string_view& key,
         const std::unordered_map<std::string_view, std::string_view>& mapping) {
+        forget(key);
+
         boost::redis::request req{};
 
         req.push_range("HSET", key, mapping);
@@ -356,6 +427,8 @@ namespace clueapi::modules::redis::detail {
 
     shared::awaitable_t<std::int32_t> connection_t::async_hdel(
         const std::string_view& key, const std::vector<std::string_view>& fields) {
+        forget(key);
+
         boost::redis::request req{};
 
         req.push_range("HDEL", key, fields);
@@ -372,6 +445,8 @@ namespace clueapi::modules::redis::detail {
 
     shared::awaitable_t<std::int32_t> connection_t::async_hsetfield(
         const std::string_view& key, const std::string_view& field, const std::string_view& value) {
+        forget(key);
+
         boost::redis::request req{};
 
         req.push("HSET", key, field, value);
@@ -388,6 +463,15 @@ namespace clueapi::modules::redis::detail {
 
     shared::awaitable_t<std::unordered_map<std::string, std::string>> connection_t::async_hgetall(
         const std::string_view& key) {
+        const auto is_cached = is_caching();
+
+        if (is_cached) {
+            if (const auto* value = m_near_cache->find<near_cache_t::hash_t>(key))
+                co_return *value;
+        }
+
+        const auto generation = is_cached ? m_near_cache->generation() : 0u;
+
         boost::redis::request req{};
 
         req.push("HGETALL", key);
@@ -399,11 +483,16 @@ namespace clueapi::modules::redis::detail {
         if (ec)
             co_return std::unordered_map<std::string, std::string>{};
 
+        if (is_cached)
+            m_near_cache->insert(key, std::get<0>(resp).value(), generation);
+
         co_return std::get<0>(resp).value();
     }
 
     shared::awaitable_t<std::int32_t> connection_t::async_hincrby(
         const std::string_view& key, const std::string_view& field, std::int32_t increment) {
+        forget(key);
+
         boost::redis::request req{};
 
         req.push("HINCRBY", key, field, std::to_string(increment));
@@ -420,6 +509,15 @@ namespace clueapi::modules::redis::detail {
 
     shared::awaitable_t<std::optional<std::string>> connection_t::async_hget(
         const std::string_view& key, const std::string_view& field) {
+        if (is_pipelining()) {
+            auto reply = co_await m_pipeline->async_exec("HGET", key, field);
+
+            if (!reply.has_value() || reply->m_is_null)
+                co_return std::nullopt;
+
+            co_return std::move(reply->m_value);
+        }
+
         boost::redis::request req{};
 
         req.push("HGET", key, field);
@@ -436,6 +534,12 @@ namespace clueapi::modules::redis::detail {
 
     shared::awaitable_t<bool> connection_t::async_hexists(
         const std::string_view& key, const std::string_view& field) {
+        if (is_pipelining()) {
+            auto reply = co_await m_pipeline->async_exec("HEXISTS", key, field);
+
+            co_return reply.has_value() && reply->to_int() == 1;
+        }
+
         boost::redis::request req{};
 
         req.push("HEXISTS", key, field);
@@ -452,6 +556,22 @@ namespace clueapi::modules::redis::detail {
 
     shared::awaitable_t<std::optional<std::int32_t>> connection_t::async_incr(
         const std::string_view& key) {
+        forget(key);
+
+        if (is_pipelining()) {
+            auto reply = co_await m_pipeline->async_exec("INCR", key);
+
+            if (!reply.has_value())
+                co_return std::nullopt;
+
+            const auto value = reply->to_int();
+
+            if (!value.has_value())
+                co_return std::nullopt;
+
+            co_return static_cast<std::int32_t>(*value);
+        }
+
         boost::redis::request req{};
 
         req.push("INCR", key);
@@ -468,6 +588,22 @@ namespace clueapi::modules::redis::detail {
 
     shared::awaitable_t<std::optional<std::int32_t>> connection_t::async_decr(
         const std::string_view& key) {
+        forget(key);
+
+        if (is_pipelining()) {
+            auto reply = co_await m_pipeline->async_exec("DECR", key);
+
+            if (!reply.has_value())
+                co_return std::nullopt;
+
+            const auto value = reply->to_int();
+
+            if (!value.has_value())
+                co_return std::nullopt;
+
+            co_return static_cast<std::int32_t>(*value);
+        }
+
         boost::redis::request req{};
 
         req.push("DECR", key);
@@ -482,6 +618,116 @@ namespace clueapi::modules::redis::detail {
         co_return std::get<0>(resp).value();
     }
 
+    shared::awaitable_t<bool> connection_t::async_mset(
+        const std::unordered_map<std::string_view, std::string_view>& mapping) {
+        if (mapping.empty())
+            co_return true;
+
+        auto results = co_await async_exec(batch().mset(mapping));
+
+        co_return results.has_value() && std::get<0>(*results) == "OK";
+    }
+
+    shared::awaitable_t<std::optional<std::string>> connection_t::async_get_cached(
+        std::string_view key) {
+        // A hit completes without suspending, so without any network or executor hop
+        if (const auto* value = m_near_cache->find<near_cache_t::string_t>(key))
+            co_return *value;
+
+        const auto generation = m_near_cache->generation();
+
+        if (is_pipelining()) {
+            auto reply = co_await m_pipeline->async_exec("GET", key);
+
+            if (!reply.has_value())
+                co_return std::nullopt;
+
+            auto value = reply->m_is_null ? std::nullopt : std::make_optional(reply->m_value);
+
+            m_near_cache->insert(key, value, generation);
+
+            co_return value;
+        }
+
+        boost::redis::request req{};
+
+        req.push("GET", key);
+
+        boost::redis::response<std::optional<std::string>> resp{};
+
+        auto ec = co_await async_exec(req, resp);
+
+        if (ec)
+            co_return std::nullopt;
+
+        m_near_cache->insert(key, std::get<0>(resp).value(), generation);
+
+        co_return std::get<0>(resp).value();
+    }
+
+    shared::awaitable_t<bool> connection_t::async_track() {
+        if (!m_is_receiving->exchange(true, std::memory_order_acq_rel))
+            boost::asio::co_spawn(
+                *m_io_ctx,
+                receive(m_connection, m_near_cache, m_is_receiving),
+                boost::asio::detached);
+
+        boost::redis::request req{};
+
+        req.push("CLIENT", "TRACKING", "ON");
+
+        req.push("CLIENT", "ID");
+
+        boost::redis::response<std::string, std::int64_t> resp{};
+
+        auto ec = co_await async_exec(req, resp);
+
+        if (ec || std::get<0>(resp).value() != "OK") {
+            m_near_cache->set_enabled(false);
+
+            co_return false;
+        }
+
+        // The tracking is lost with the connection, so are the invalidations sent in between
+        if (std::get<1>(resp).value() != m_client_id) {
+            m_near_cache->set_enabled(false);
+
+            m_client_id = std::get<1>(resp).value();
+        }
+
+        m_near_cache->set_enabled(true);
+
+        co_return true;
+    }
+
+    shared::awaitable_t<void> connection_t::receive(
+        std::shared_ptr<raw_connection_t> connection,
+        std::shared_ptr<near_cache_t> near_cache,
+        std::shared_ptr<std::atomic<bool>> is_receiving) {
+        for (;;) {
+            boost::redis::generic_response resp{};
+
+            boost::system::error_code ec{};
+
+            co_await connection->async_receive(
+                resp, boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+
+            if (ec)
+                break;
+
+            if (resp.has_value())
+                near_cache->on_push(resp.value());
+            else
+                near_cache->clear();
+        }
+
+        // The receive fails once the connection is lost, and the invalidations sent until it is
+        // back with it. The cache stays off until the tracking is checked again.
+        near_cache->set_enabled(false);
+
+        is_receiving->store(false, std::memory_order_release);
+    }
+
     // ...
 
     bool connection_t::sync_del(const std::string_view& key) {
@@ -0,0 +1,184 @@
+/**
+ * @file cursor.hxx
+ *
+ * @brief Defines a cursor that iterates over the keys of a database, or the elements of a
+ * collection, one page at a time.
+ *
+ * @internal
+ */
+
+#ifndef CLUEAPI_MODULES_REDIS_DETAIL_CURSOR_HXX
+#define CLUEAPI_MODULES_REDIS_DETAIL_CURSOR_HXX
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "clueapi/shared/macros.hxx"
+#include "clueapi/shared/shared.hxx"
+
+namespace clueapi::modules::redis::detail {
+    // Forward declaration
+    struct connection_t;
+
+    /**
+     * @struct cursor_t
+     *
+     * @brief Iterates with `SCAN`, `HSCAN`, `SSCAN`, `ZSCAN`, or `LRANGE` pages.
+     *
+     * @details Each call to `async_next()` sends one command and yields one page of about
+     * `cfg_t::m_count` elements, so a big collection is never decoded at once:
+     *
+     * @code
+     * auto cursor = connection->hscan("big-hash", {.m_count = 500u});
+     *
+     * while (!cursor.is_done()) {
+     *     co_await cursor.async_next([](std::string_view element) {
+     *         // ...
+     *     });
+     * }
+     * @endcode
+     *
+     * `HSCAN` pages alternate fields and values, `ZSCAN` pages members and scores. As for the
+     * commands themselves, a `*SCAN` may yield an element more than once, or an empty page.
+     *
+     * @note The connection must outlive the cursor.
+     *
+     * @internal
+     */
+    struct cursor_t {
+        /**
+         * @enum e_kind
+         *
+         * @brief Defines the command of a cursor.
+         *
+         * @internal
+         */
+        enum e_kind : std::uint8_t {
+            scan,
+            hscan,
+            sscan,
+            zscan,
+
+            /**
+             * @brief Consecutive `LRANGE` pages of a list.
+             */
+            lrange
+        };
+
+        /**
+         * @struct cfg_t
+         *
+         * @brief Configuration parameters for a cursor.
+         *
+         * @internal
+         */
+        struct cfg_t {
+            /**
+             * @brief The `MATCH` pattern of the elements, empty for all of them.
+             */
+            std::string m_match{};
+
+            /**
+             * @brief The `COUNT` hint of a `*SCAN`, or the size of a `LRANGE` page.
+             */
+            std::size_t m_count{100u};
+
+            /**
+             * @brief The `TYPE` of the keys of a `SCAN`, empty for all of them.
+             */
+            std::string m_type{};
+        };
+
+        /**
+         * @brief Type alias for the function an element of a page is handed to, viewing into
+         * the decoded reply.
+         */
+        using visitor_t = std::function<void(std::string_view)>;
+
+       public:
+        CLUEAPI_INLINE cursor_t() = delete;
+
+        /**
+         * @brief Constructs a cursor at the start.
+         *
+         * @param connection The connection.
+         * @param kind The command.
+         * @param key The key of the collection, ignored by `SCAN`.
+         * @param cfg The cursor configuration.
+         */
+        CLUEAPI_INLINE cursor_t(connection_t& connection, e_kind kind, std::string key, cfg_t cfg)
+            : m_connection{&connection},
+              m_kind{kind},
+              m_key{std::move(key)},
+              m_cfg{std::move(cfg)} {
+        }
+
+       public:
+        /**
+         * @brief Fetches the next page, handing each element to a visitor.
+         *
+         * @param visitor The visitor, whose views are only valid during the call.
+         *
+         * @return An awaitable that resolves to `true` if a page was fetched, `false` if the
+         * cursor already was done or the command failed, which also ends it.
+         */
+        shared::awaitable_t<bool> async_next(const visitor_t& visitor);
+
+        /**
+         * @brief Fetches the next page.
+         *
+         * @return An awaitable that resolves to the elements of the page, or `std::nullopt` if the
+         * cursor already was done or the command failed.
+         */
+        shared::awaitable_t<std::optional<std::vector<std::string>>> async_next();
+
+       public:
+        /**
+         * @brief Checks if the iteration is over.
+         *
+         * @return `true` once the last page was fetched.
+         */
+        [[nodiscard]] CLUEAPI_INLINE bool is_done() const noexcept {
+            return m_is_done;
+        }
+
+        /**
+         * @brief Checks if the iteration ended on a failed command.
+         *
+         * @return `true` if a command failed.
+         */
+        [[nodiscard]] CLUEAPI_INLINE bool has_failed() const noexcept {
+            return m_has_failed;
+        }
+
+       private:
+        connection_t* m_connection;
+
+        e_kind m_kind;
+
+        std::string m_key;
+
+        cfg_t m_cfg;
+
+        /**
+         * @brief The cursor returned by the last `*SCAN`.
+         */
+        std::string m_cursor{"0"};
+
+        /**
+         * @brief The index of the next `LRANGE` page.
+         */
+        std::int64_t m_position{};
+
+        bool m_is_done{};
+
+        bool m_has_failed{};
+    };
+} // namespace clueapi::modules::redis::detail
+
+#endif // CLUEAPI_MODULES_REDIS_DETAIL_CURSOR_HXX
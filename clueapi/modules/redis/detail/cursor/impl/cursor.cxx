@@ -0,0 +1,113 @@
+/**
+ * @file cursor.cxx
+ *
+ * @brief Implements the cursor over the keys of a database, or the elements of a collection.
+ */
+
+#include "clueapi/modules/redis/detail/cursor/cursor.hxx"
+
+#include <algorithm>
+#include <utility>
+
+#include <boost/redis/request.hpp>
+#include <boost/redis/response.hpp>
+
+#include "clueapi/modules/redis/detail/connection/connection.hxx"
+
+namespace clueapi::modules::redis::detail {
+    shared::awaitable_t<bool> cursor_t::async_next(const visitor_t& visitor) {
+        if (m_is_done)
+            co_return false;
+
+        const auto count = std::max<std::size_t>(m_cfg.m_count, 1u);
+
+        boost::redis::request req{};
+
+        if (m_kind == e_kind::lrange)
+            req.push(
+                "LRANGE",
+                m_key,
+                std::to_string(m_position),
+                std::to_string(m_position + static_cast<std::int64_t>(count) - 1));
+        else {
+            constexpr std::string_view k_commands[]{"SCAN", "HSCAN", "SSCAN", "ZSCAN"};
+
+            std::vector<std::string> args{};
+
+            if (m_kind != e_kind::scan)
+                args.push_back(m_key);
+
+            args.push_back(m_cursor);
+
+            if (!m_cfg.m_match.empty()) {
+                args.emplace_back("MATCH");
+
+                args.push_back(m_cfg.m_match);
+            }
+
+            args.emplace_back("COUNT");
+
+            args.push_back(std::to_string(count));
+
+            if (m_kind == e_kind::scan && !m_cfg.m_type.empty()) {
+                args.emplace_back("TYPE");
+
+                args.push_back(m_cfg.m_type);
+            }
+
+            req.push_range(k_commands[m_kind], args);
+        }
+
+        boost::redis::generic_response resp{};
+
+        auto ec = co_await m_connection->async_exec(req, resp);
+
+        if (ec || !resp.has_value()) {
+            m_is_done = true;
+
+            m_has_failed = true;
+
+            co_return false;
+        }
+
+        // A `*SCAN` replies [cursor, [elements...]], a `LRANGE` [elements...]
+        const std::size_t depth = m_kind == e_kind::lrange ? 1u : 2u;
+
+        std::size_t elements{};
+
+        bool has_cursor{};
+
+        for (const auto& node : resp.value()) {
+            if (node.depth == depth) {
+                visitor(node.value);
+
+                elements++;
+            } else if (depth == 2u && node.depth == 1u && !has_cursor) {
+                m_cursor = node.value;
+
+                has_cursor = true;
+            }
+        }
+
+        if (m_kind == e_kind::lrange) {
+            m_position += static_cast<std::int64_t>(elements);
+
+            m_is_done = elements < count;
+        } else
+            m_is_done = !has_cursor || m_cursor == "0";
+
+        co_return true;
+    }
+
+    shared::awaitable_t<std::optional<std::vector<std::string>>> cursor_t::async_next() {
+        std::vector<std::string> ret{};
+
+        const auto is_fetched = co_await async_next(
+            [&ret](std::string_view element) { ret.emplace_back(element); });
+
+        if (!is_fetched)
+            co_return std::nullopt;
+
+        co_return ret;
+    }
+} // namespace clueapi::modules::redis::detail
@@ -3,10 +3,22 @@
 
 #include "clueapi/modules/redis/detail/base_connection/base_connection.hxx"
 
+#include "clueapi/modules/redis/detail/batch/batch.hxx"
+
 #include "clueapi/modules/redis/detail/cfg/cfg.hxx"
 
 #include "clueapi/modules/redis/detail/connection/connection.hxx"
 
+#include "clueapi/modules/redis/detail/cursor/cursor.hxx"
+
+#include "clueapi/modules/redis/detail/near_cache/near_cache.hxx"
+
+#include "clueapi/modules/redis/detail/pipeline/pipeline.hxx"
+
+#include "clueapi/modules/redis/detail/pool/pool.hxx"
+
+#include "clueapi/modules/redis/detail/shard_map/shard_map.hxx"
+
 namespace clueapi::modules::redis::detail {
     // ...
 }
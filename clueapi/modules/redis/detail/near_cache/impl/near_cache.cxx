@@ -0,0 +1,141 @@
+/**
+ * @file near_cache.cxx
+ *
+ * @brief Implements the in-process cache of the Redis reads of a connection.
+ */
+
+#include "clueapi/modules/redis/detail/near_cache/near_cache.hxx"
+
+#include <utility>
+
+#include <boost/redis/resp3/type.hpp>
+
+namespace clueapi::modules::redis::detail {
+    void near_cache_t::insert(
+        std::string_view key, std::variant<string_t, hash_t> value, std::uint64_t generation) {
+        if (!m_is_enabled || m_max_entries == 0u || generation != m_generation)
+            return;
+
+        const auto expires_at = std::chrono::steady_clock::now() + m_ttl;
+
+        if (auto it = m_index.find(key); it != m_index.end()) {
+            it->second->m_value = std::move(value);
+
+            it->second->m_expires_at = expires_at;
+
+            m_entries.splice(m_entries.begin(), m_entries, it->second);
+
+            return;
+        }
+
+        if (m_entries.size() >= m_max_entries) {
+            erase(std::prev(m_entries.end()));
+
+            m_evictions.fetch_add(1u, std::memory_order_relaxed);
+        }
+
+        m_entries.push_front(entry_t{
+            .m_key = std::string{key}, .m_value = std::move(value), .m_expires_at = expires_at});
+
+        m_index.emplace(m_entries.front().m_key, m_entries.begin());
+
+        m_size.store(m_entries.size(), std::memory_order_relaxed);
+    }
+
+    void near_cache_t::invalidate(std::string_view key) {
+        m_generation++;
+
+        auto it = m_index.find(key);
+
+        if (it == m_index.end())
+            return;
+
+        erase(it->second);
+
+        m_invalidations.fetch_add(1u, std::memory_order_relaxed);
+    }
+
+    void near_cache_t::clear() {
+        m_generation++;
+
+        m_invalidations.fetch_add(m_entries.size(), std::memory_order_relaxed);
+
+        m_index.clear();
+
+        m_entries.clear();
+
+        m_size.store(0u, std::memory_order_relaxed);
+    }
+
+    void near_cache_t::set_enabled(bool is_enabled) {
+        if (!is_enabled)
+            clear();
+
+        m_is_enabled = is_enabled;
+    }
+
+    bool near_cache_t::on_push(const std::vector<boost::redis::resp3::node>& nodes) {
+        bool ret{};
+
+        // A response may hold several messages, each starting at the top level
+        for (std::size_t i{}; i < nodes.size();) {
+            std::size_t end{i + 1u};
+
+            while (end < nodes.size() && nodes[end].depth != 0u)
+                end++;
+
+            if (end - i >= 3u && nodes[i + 1u].value == "invalidate") {
+                ret = true;
+
+                // A null list of keys is sent on `FLUSHALL` and `FLUSHDB`
+                if (nodes[i + 2u].data_type == boost::redis::resp3::type::null)
+                    clear();
+                else
+                    for (auto key = i + 3u; key < end; key++)
+                        invalidate(nodes[key].value);
+            }
+
+            i = end;
+        }
+
+        return ret;
+    }
+
+    near_cache_t::stats_t near_cache_t::stats() const noexcept {
+        return stats_t{
+            .m_hits = m_hits.load(std::memory_order_relaxed),
+            .m_misses = m_misses.load(std::memory_order_relaxed),
+            .m_invalidations = m_invalidations.load(std::memory_order_relaxed),
+            .m_evictions = m_evictions.load(std::memory_order_relaxed),
+            .m_size = m_size.load(std::memory_order_relaxed)};
+    }
+
+    const std::variant<near_cache_t::string_t, near_cache_t::hash_t>* near_cache_t::find(
+        std::string_view key) {
+        if (!m_is_enabled)
+            return nullptr;
+
+        auto it = m_index.find(key);
+
+        if (it == m_index.end())
+            return nullptr;
+
+        if (it->second->m_expires_at <= std::chrono::steady_clock::now()) {
+            erase(it->second);
+
+            return nullptr;
+        }
+
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+
+        return &m_entries.front().m_value;
+    }
+
+    void near_cache_t::erase(std::list<entry_t>::iterator it) {
+        m_index.erase(std::string_view{it->m_key});
+
+        m_entries.erase(it);
+
+        m_size.store(m_entries.size(), std::memory_order_relaxed);
+    }
+} // namespace clueapi::modules::redis::detail
@@ -0,0 +1,250 @@
+/**
+ * @file near_cache.hxx
+ *
+ * @brief Defines the in-process cache of the Redis reads of a connection.
+ *
+ * @internal
+ */
+
+#ifndef CLUEAPI_MODULES_REDIS_DETAIL_NEAR_CACHE_HXX
+#define CLUEAPI_MODULES_REDIS_DETAIL_NEAR_CACHE_HXX
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+#include <boost/redis/resp3/node.hpp>
+
+#include "clueapi/http/detail/sv_hash/sv_hash.hxx"
+
+#include "clueapi/shared/macros.hxx"
+#include "clueapi/shared/shared.hxx"
+
+namespace clueapi::modules::redis::detail {
+    /**
+     * @struct near_cache_t
+     *
+     * @brief A bounded LRU of the values read through a connection.
+     *
+     * @details The connection enables `CLIENT TRACKING`, so the server sends an `invalidate` push
+     * message once a key it read changes, and the entry is dropped. Entries also expire after a
+     * TTL, which bounds how stale a value gets if an invalidation is lost.
+     *
+     * The cache is dropped and turned off when the connection is lost, since the invalidations
+     * sent meanwhile are lost with it, and is turned on again once the tracking is checked.
+     *
+     * A read started before an invalidation doesn't fill the cache, since its reply may predate
+     * the change.
+     *
+     * @note Only touched on the I/O context of its connection, except for the counters.
+     *
+     * @internal
+     */
+    struct near_cache_t {
+        /**
+         * @brief Type alias for a cached `GET`, `std::nullopt` for a missing key.
+         */
+        using string_t = std::optional<std::string>;
+
+        /**
+         * @brief Type alias for a cached `HGETALL`.
+         */
+        using hash_t = std::unordered_map<std::string, std::string>;
+
+        /**
+         * @struct stats_t
+         *
+         * @brief The counters of a cache.
+         *
+         * @internal
+         */
+        struct stats_t {
+            std::size_t m_hits{};
+
+            std::size_t m_misses{};
+
+            /**
+             * @brief The entries dropped by an invalidation.
+             */
+            std::size_t m_invalidations{};
+
+            /**
+             * @brief The entries dropped to stay within the size.
+             */
+            std::size_t m_evictions{};
+
+            std::size_t m_size{};
+        };
+
+       public:
+        /**
+         * @brief Constructs a cache.
+         *
+         * @param max_entries The maximum number of entries.
+         * @param ttl The time an entry is kept for.
+         */
+        CLUEAPI_INLINE near_cache_t(std::size_t max_entries, std::chrono::seconds ttl)
+            : m_max_entries{max_entries}, m_ttl{ttl} {
+        }
+
+       public:
+        /**
+         * @brief Finds a value, and marks it as the most recently used.
+         *
+         * @tparam _value_t The type of the value, `string_t` or `hash_t`.
+         *
+         * @param key The key.
+         *
+         * @return The value, or `nullptr` if it isn't cached, expired, or of another type.
+         */
+        template <typename _value_t>
+        [[nodiscard]] CLUEAPI_INLINE const _value_t* find(std::string_view key) {
+            const auto* value = find(key);
+
+            const auto* ret = value ? std::get_if<_value_t>(value) : nullptr;
+
+            (ret ? m_hits : m_misses).fetch_add(1u, std::memory_order_relaxed);
+
+            return ret;
+        }
+
+        /**
+         * @brief Caches the value of a read, unless an invalidation came in since it started.
+         *
+         * @param key The key.
+         * @param value The value.
+         * @param generation The generation when the read started.
+         */
+        void insert(
+            std::string_view key, std::variant<string_t, hash_t> value, std::uint64_t generation);
+
+        /**
+         * @brief Drops a key.
+         *
+         * @param key The key.
+         */
+        void invalidate(std::string_view key);
+
+        /**
+         * @brief Drops every entry.
+         */
+        void clear();
+
+        /**
+         * @brief Enables or disables the cache, e.g. while tracking is off. Disabling it drops
+         * every entry.
+         *
+         * @param is_enabled If the cache is enabled.
+         */
+        void set_enabled(bool is_enabled);
+
+        /**
+         * @brief Applies a push message, if it is an `invalidate` one.
+         *
+         * @param nodes The nodes of the message.
+         *
+         * @return `true` if it was an `invalidate` message.
+         */
+        bool on_push(const std::vector<boost::redis::resp3::node>& nodes);
+
+       public:
+        /**
+         * @brief Checks if the cache is enabled.
+         *
+         * @return `true` if the cache is enabled.
+         */
+        [[nodiscard]] CLUEAPI_INLINE bool is_enabled() const noexcept {
+            return m_is_enabled;
+        }
+
+        /**
+         * @brief Gets the generation, bumped by every invalidation.
+         *
+         * @return The generation.
+         */
+        [[nodiscard]] CLUEAPI_INLINE std::uint64_t generation() const noexcept {
+            return m_generation;
+        }
+
+        /**
+         * @brief Gets the counters of the cache.
+         *
+         * @return The counters.
+         */
+        [[nodiscard]] stats_t stats() const noexcept;
+
+       private:
+        /**
+         * @struct entry_t
+         *
+         * @brief A cached value.
+         *
+         * @internal
+         */
+        struct entry_t {
+            std::string m_key;
+
+            std::variant<string_t, hash_t> m_value;
+
+            std::chrono::steady_clock::time_point m_expires_at;
+        };
+
+       private:
+        /**
+         * @brief Finds an unexpired entry, and moves it to the front.
+         */
+        [[nodiscard]] const std::variant<string_t, hash_t>* find(std::string_view key);
+
+        /**
+         * @brief Drops an entry.
+         */
+        void erase(std::list<entry_t>::iterator it);
+
+       private:
+        std::size_t m_max_entries;
+
+        std::chrono::seconds m_ttl;
+
+        /**
+         * @brief The entries, from the most to the least recently used.
+         */
+        std::list<entry_t> m_entries;
+
+        /**
+         * @brief The entries by key, the keys viewing into the entries.
+         */
+        shared::unordered_map_t<
+            std::string_view,
+            std::list<entry_t>::iterator,
+            http::detail::sv_hash_t,
+            http::detail::sv_eq_t>
+            m_index;
+
+        std::uint64_t m_generation{};
+
+        /**
+         * @brief If the server tracks the keys read, so the entries get invalidated.
+         */
+        bool m_is_enabled{};
+
+        std::atomic<std::size_t> m_hits{};
+
+        std::atomic<std::size_t> m_misses{};
+
+        std::atomic<std::size_t> m_invalidations{};
+
+        std::atomic<std::size_t> m_evictions{};
+
+        std::atomic<std::size_t> m_size{};
+    };
+} // namespace clueapi::modules::redis::detail
+
+#endif // CLUEAPI_MODULES_REDIS_DETAIL_NEAR_CACHE_HXX
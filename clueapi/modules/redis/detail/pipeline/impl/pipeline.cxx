@@ -0,0 +1,107 @@
+/**
+ * @file pipeline.cxx
+ *
+ * @brief Implements the automatic pipelining of the single-key calls of a Redis connection.
+ */
+
+#include "clueapi/modules/redis/detail/pipeline/pipeline.hxx"
+
+#include <charconv>
+#include <utility>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/redirect_error.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/redis/resp3/type.hpp>
+
+namespace clueapi::modules::redis::detail {
+    std::optional<std::int64_t> pipeline_t::reply_t::to_int() const noexcept {
+        if (m_is_null)
+            return std::nullopt;
+
+        std::int64_t ret{};
+
+        const auto* end = m_value.data() + m_value.size();
+
+        const auto [ptr, ec] = std::from_chars(m_value.data(), end, ret);
+
+        if (ec != std::errc{} || ptr != end)
+            return std::nullopt;
+
+        return ret;
+    }
+
+    std::shared_ptr<pipeline_t::pending_t> pipeline_t::current() {
+        if (m_pending)
+            return m_pending;
+
+        m_pending = std::make_shared<pending_t>(*m_io_ctx);
+
+        // Runs once the callers of this tick appended their commands
+        boost::asio::post(*m_io_ctx, [self = shared_from_this()]() {
+            auto pending = std::move(self->m_pending);
+
+            self->m_pending.reset();
+
+            boost::asio::co_spawn(
+                *self->m_io_ctx,
+                flush(self->m_connection, std::move(pending)),
+                boost::asio::detached);
+        });
+
+        return m_pending;
+    }
+
+    shared::awaitable_t<std::optional<pipeline_t::reply_t>> pipeline_t::async_reply(
+        std::shared_ptr<pending_t> pending, std::size_t index) {
+        if (!pending->m_is_done) {
+            boost::system::error_code ec{};
+
+            co_await pending->m_signal.async_wait(
+                boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+        }
+
+        if (pending->m_ec || index >= pending->m_replies.size())
+            co_return std::nullopt;
+
+        const auto& node = pending->m_resp[pending->m_replies[index]];
+
+        // Only the caller whose command failed sees its error
+        if (node.data_type == boost::redis::resp3::type::simple_error ||
+            node.data_type == boost::redis::resp3::type::blob_error)
+            co_return std::nullopt;
+
+        co_return reply_t{
+            .m_is_null = node.data_type == boost::redis::resp3::type::null,
+            .m_value = node.value};
+    }
+
+    shared::awaitable_t<void> pipeline_t::flush(
+        std::shared_ptr<raw_connection_t> connection, std::shared_ptr<pending_t> pending) {
+        boost::system::error_code ec{};
+
+        co_await connection->async_exec(
+            pending->m_req,
+            pending->m_resp,
+            boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+
+        pending->m_ec = ec;
+
+        // Each reply starts with a node at the top level
+        if (!ec) {
+            const auto& nodes = pending->m_resp;
+
+            pending->m_replies.reserve(pending->m_commands);
+
+            for (std::size_t i{}; i < nodes.size(); i++)
+                if (nodes[i].depth == 0u)
+                    pending->m_replies.push_back(i);
+        }
+
+        pending->m_is_done = true;
+
+        pending->m_signal.cancel();
+    }
+} // namespace clueapi::modules::redis::detail
@@ -0,0 +1,183 @@
+/**
+ * @file pipeline.hxx
+ *
+ * @brief Defines the automatic pipelining of the single-key calls of a Redis connection.
+ *
+ * @internal
+ */
+
+#ifndef CLUEAPI_MODULES_REDIS_DETAIL_PIPELINE_HXX
+#define CLUEAPI_MODULES_REDIS_DETAIL_PIPELINE_HXX
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/redis/request.hpp>
+#include <boost/redis/resp3/node.hpp>
+#include <boost/system/error_code.hpp>
+
+#include "clueapi/modules/redis/detail/base_connection/base_connection.hxx"
+
+#include "clueapi/shared/macros.hxx"
+#include "clueapi/shared/shared.hxx"
+
+namespace clueapi::modules::redis::detail {
+    /**
+     * @struct pipeline_t
+     *
+     * @brief Coalesces the commands issued on an I/O context within one tick into one request.
+     *
+     * @details The first command of a tick opens a request and posts its flush, the commands
+     * that follow before the flush runs are appended to it. The flush sends the request with one
+     * `async_exec`, and wakes every caller with its own reply.
+     *
+     * @note Only commands with a scalar reply can be pipelined, and they must be issued on the
+     * I/O context of the connection. An error reply only fails its own command, losing the
+     * connection fails every command of the request.
+     *
+     * @internal
+     */
+    struct pipeline_t : public std::enable_shared_from_this<pipeline_t> {
+       public:
+        /**
+         * @struct reply_t
+         *
+         * @brief The scalar reply of a pipelined command.
+         *
+         * @internal
+         */
+        struct reply_t {
+            /**
+             * @brief Gets the reply as an integer.
+             *
+             * @return The integer, or `std::nullopt` if the reply isn't one.
+             */
+            [[nodiscard]] std::optional<std::int64_t> to_int() const noexcept;
+
+            /**
+             * @brief If the reply is null, e.g. a `GET` of a missing key.
+             */
+            bool m_is_null{};
+
+            std::string m_value;
+        };
+
+       public:
+        /**
+         * @brief Constructs the pipeline of a connection.
+         *
+         * @param connection The raw connection.
+         * @param io_ctx The I/O context of the connection.
+         */
+        CLUEAPI_INLINE pipeline_t(
+            std::shared_ptr<raw_connection_t> connection, boost::asio::io_context& io_ctx)
+            : m_connection{std::move(connection)}, m_io_ctx{&io_ctx} {
+        }
+
+       public:
+        /**
+         * @brief Appends a command to the request of the current tick.
+         *
+         * @param cmd The command.
+         * @param args The arguments of the command.
+         *
+         * @return An awaitable that resolves to the reply once the request completes, or
+         * `std::nullopt` if the command got an error reply or the request failed.
+         */
+        template <typename... _args_t>
+        CLUEAPI_INLINE shared::awaitable_t<std::optional<reply_t>> async_exec(
+            std::string_view cmd, const _args_t&... args) {
+            auto pending = current();
+
+            pending->m_req.push(cmd, args...);
+
+            const auto index = pending->m_commands++;
+
+            co_return co_await async_reply(std::move(pending), index);
+        }
+
+        /**
+         * @brief Checks if the caller runs on the I/O context of the connection.
+         *
+         * @return `true` if its commands can be pipelined.
+         */
+        [[nodiscard]] CLUEAPI_INLINE bool is_local() const noexcept {
+            return m_io_ctx->get_executor().running_in_this_thread();
+        }
+
+       private:
+        /**
+         * @struct pending_t
+         *
+         * @brief The request of a tick, and the replies once it completed.
+         *
+         * @internal
+         */
+        struct pending_t {
+            CLUEAPI_INLINE explicit pending_t(boost::asio::io_context& io_ctx) : m_signal{io_ctx} {
+                m_signal.expires_at(boost::asio::steady_timer::time_point::max());
+            }
+
+            boost::redis::request m_req;
+
+            /**
+             * @brief The nodes of the replies, kept as they are so that an error reply doesn't
+             * discard the replies of the other commands, as a `generic_response` would.
+             */
+            std::vector<boost::redis::resp3::node> m_resp;
+
+            /**
+             * @brief The position of the first node of each reply.
+             */
+            std::vector<std::size_t> m_replies;
+
+            std::size_t m_commands{};
+
+            boost::system::error_code m_ec;
+
+            bool m_is_done{};
+
+            /**
+             * @brief Cancelled once the request completed, waking its callers.
+             */
+            boost::asio::steady_timer m_signal;
+        };
+
+       private:
+        /**
+         * @brief Gets the request of the current tick, opening it on the first command.
+         */
+        std::shared_ptr<pending_t> current();
+
+        /**
+         * @brief Waits for the request of a command, then extracts its reply.
+         */
+        static shared::awaitable_t<std::optional<reply_t>> async_reply(
+            std::shared_ptr<pending_t> pending, std::size_t index);
+
+        /**
+         * @brief Sends a request, and wakes its callers.
+         */
+        static shared::awaitable_t<void> flush(
+            std::shared_ptr<raw_connection_t> connection, std::shared_ptr<pending_t> pending);
+
+       private:
+        std::shared_ptr<raw_connection_t> m_connection;
+
+        boost::asio::io_context* m_io_ctx;
+
+        /**
+         * @brief The request of the current tick, reset by its flush.
+         */
+        std::shared_ptr<pending_t> m_pending;
+    };
+} // namespace clueapi::modules::redis::detail
+
+#endif // CLUEAPI_MODULES_REDIS_DETAIL_PIPELINE_HXX
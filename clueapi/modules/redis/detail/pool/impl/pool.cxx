@@ -0,0 +1,230 @@
+/**
+ * @file pool.cxx
+ *
+ * @brief Implements the pool of Redis connections.
+ */
+
+#include "clueapi/modules/redis/detail/pool/pool.hxx"
+
+#include <string>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/redirect_error.hpp>
+#include <boost/asio/use_awaitable.hpp>
+
+#include <fmt/format.h>
+
+namespace clueapi::modules::redis::detail {
+    pool_t::pool_t(cfg_t cfg, std::vector<boost::asio::io_context*> io_ctxs)
+        : m_cfg{std::move(cfg)}, m_io_ctxs{std::move(io_ctxs)} {
+        std::erase(m_io_ctxs, nullptr);
+
+        if (m_cfg.m_nodes.empty() || m_io_ctxs.empty())
+            return;
+
+        if (m_cfg.m_sharding == e_sharding::slots) {
+            auto shard_map = shard_map_t::make_slots(
+                m_cfg.m_slots.empty() ? shard_map_t::split_slots(m_cfg.m_nodes.size())
+                                      : m_cfg.m_slots);
+
+            if (!shard_map.has_value() || shard_map->nodes() != m_cfg.m_nodes.size())
+                return;
+
+            m_shard_map = std::move(*shard_map);
+        } else {
+            std::vector<std::string> names{};
+
+            names.reserve(m_cfg.m_nodes.size());
+
+            for (const auto& node : m_cfg.m_nodes)
+                names.emplace_back(fmt::format("{}:{}/{}", node.m_host, node.m_port, node.m_db));
+
+            m_shard_map = shard_map_t::make_ring(names, m_cfg.m_virtual_nodes);
+        }
+
+        const auto per_node = m_cfg.m_connections_per_node != 0u ? m_cfg.m_connections_per_node
+                                                                 : m_io_ctxs.size();
+
+        m_nodes.resize(m_cfg.m_nodes.size());
+
+        for (std::size_t node{}; node < m_nodes.size(); node++) {
+            m_nodes[node].reserve(per_node);
+
+            for (std::size_t i{}; i < per_node; i++)
+                m_nodes[node].emplace_back(std::make_shared<slot_t>(
+                    m_cfg.m_nodes[node], *m_io_ctxs[i % m_io_ctxs.size()]));
+        }
+    }
+
+    shared::awaitable_t<bool> pool_t::async_connect() {
+        if (!is_valid())
+            co_return false;
+
+        bool ret{true};
+
+        for (const auto& slots : m_nodes) {
+            bool is_connected{};
+
+            for (const auto& slot : slots) {
+                auto connection = slot->m_connection.load();
+
+                // Connected on its own I/O context, that runs its `async_run`
+                const auto is_alive = co_await boost::asio::co_spawn(
+                    *slot->m_io_ctx,
+
+                    [connection]() -> shared::awaitable_t<bool> {
+                        co_return co_await connection->async_connect();
+                    },
+
+                    boost::asio::use_awaitable);
+
+                slot->m_is_healthy.store(is_alive, std::memory_order_release);
+
+                is_connected |= is_alive;
+            }
+
+            ret &= is_connected;
+        }
+
+        if (m_cfg.m_health_check_interval.count() > 0 &&
+            !m_is_checking.exchange(true, std::memory_order_acq_rel)) {
+            for (const auto& slots : m_nodes)
+                for (const auto& slot : slots)
+                    boost::asio::co_spawn(
+                        *slot->m_io_ctx,
+                        check(slot, m_cfg.m_health_check_interval),
+                        boost::asio::detached);
+        }
+
+        co_return ret;
+    }
+
+    void pool_t::shutdown() {
+        for (const auto& slots : m_nodes) {
+            for (const auto& slot : slots) {
+                if (slot->m_is_stopped.exchange(true, std::memory_order_acq_rel))
+                    continue;
+
+                slot->m_is_healthy.store(false, std::memory_order_release);
+
+                boost::asio::post(*slot->m_io_ctx, [slot]() {
+                    slot->m_timer.cancel();
+
+                    slot->m_connection.load()->disconnect();
+                });
+            }
+        }
+    }
+
+    std::shared_ptr<connection_t> pool_t::connection(std::string_view key) const {
+        const auto node =
+            m_shard_map.node_of(key, [this](std::size_t node) { return is_usable(node); });
+
+        if (!node.has_value())
+            return nullptr;
+
+        return connection_of(*node);
+    }
+
+    std::shared_ptr<connection_t> pool_t::connection_of(std::size_t node) const {
+        if (node >= m_nodes.size())
+            return nullptr;
+
+        const auto& slots = m_nodes[node];
+
+        const auto io_ctx = current_io_ctx();
+
+        // The connections of the calling I/O context are `io_ctx`, `io_ctx + size`, ...
+        if (io_ctx.has_value() && *io_ctx < slots.size()) {
+            const auto local = (slots.size() - *io_ctx + m_io_ctxs.size() - 1u) / m_io_ctxs.size();
+
+            const auto start = local > 1u ? m_next.fetch_add(1u, std::memory_order_relaxed) : 0u;
+
+            for (std::size_t i{}; i < local; i++) {
+                const auto& slot = slots[*io_ctx + m_io_ctxs.size() * ((start + i) % local)];
+
+                if (slot->m_is_healthy.load(std::memory_order_acquire))
+                    return slot->m_connection.load();
+            }
+        }
+
+        // None is healthy on the calling I/O context, the call hops to another one
+        const auto start = m_next.fetch_add(1u, std::memory_order_relaxed);
+
+        for (std::size_t i{}; i < slots.size(); i++) {
+            const auto& slot = slots[(start + i) % slots.size()];
+
+            if (slot->m_is_healthy.load(std::memory_order_acquire))
+                return slot->m_connection.load();
+        }
+
+        return nullptr;
+    }
+
+    std::size_t pool_t::healthy() const noexcept {
+        std::size_t ret{};
+
+        for (const auto& slots : m_nodes)
+            for (const auto& slot : slots)
+                ret += slot->m_is_healthy.load(std::memory_order_acquire) ? 1u : 0u;
+
+        return ret;
+    }
+
+    std::optional<std::size_t> pool_t::current_io_ctx() const noexcept {
+        for (std::size_t i{}; i < m_io_ctxs.size(); i++)
+            if (m_io_ctxs[i]->get_executor().running_in_this_thread())
+                return i;
+
+        return std::nullopt;
+    }
+
+    bool pool_t::is_usable(std::size_t node) const noexcept {
+        for (const auto& slot : m_nodes[node])
+            if (slot->m_is_healthy.load(std::memory_order_acquire))
+                return true;
+
+        return false;
+    }
+
+    shared::awaitable_t<void> pool_t::check(
+        std::shared_ptr<slot_t> slot, std::chrono::seconds interval) {
+        while (!slot->m_is_stopped.load(std::memory_order_acquire)) {
+            boost::system::error_code ec{};
+
+            slot->m_timer.expires_after(interval);
+
+            co_await slot->m_timer.async_wait(
+                boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+
+            if (slot->m_is_stopped.load(std::memory_order_acquire))
+                break;
+
+            if (co_await slot->m_connection.load()->async_check_alive()) {
+                slot->m_is_healthy.store(true, std::memory_order_release);
+
+                continue;
+            }
+
+            slot->m_is_healthy.store(false, std::memory_order_release);
+
+            // A failed connection stays in error, so a new one takes its place
+            auto connection = std::make_shared<connection_t>(slot->m_cfg, *slot->m_io_ctx);
+
+            if (!co_await connection->async_connect())
+                continue;
+
+            if (slot->m_is_stopped.load(std::memory_order_acquire)) {
+                connection->disconnect();
+
+                break;
+            }
+
+            slot->m_connection.store(std::move(connection));
+
+            slot->m_is_healthy.store(true, std::memory_order_release);
+        }
+    }
+} // namespace clueapi::modules::redis::detail
@@ -0,0 +1,288 @@
+/**
+ * @file pool.hxx
+ *
+ * @brief Defines a pool of Redis connections, sharded across nodes and bound to I/O contexts.
+ *
+ * @internal
+ */
+
+#ifndef CLUEAPI_MODULES_REDIS_DETAIL_POOL_HXX
+#define CLUEAPI_MODULES_REDIS_DETAIL_POOL_HXX
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include "clueapi/modules/redis/detail/connection/connection.hxx"
+#include "clueapi/modules/redis/detail/shard_map/shard_map.hxx"
+
+#include "clueapi/shared/macros.hxx"
+#include "clueapi/shared/shared.hxx"
+
+namespace clueapi::modules::redis::detail {
+    /**
+     * @struct pool_t
+     *
+     * @brief A pool of connections to one or more Redis nodes.
+     *
+     * @details Each node gets `cfg_t::m_connections_per_node` connections, spread over the I/O
+     * contexts of the pool, one per I/O context by default. A call made on one of them is served
+     * by a connection of that same I/O context, so commands are written and completed on the
+     * thread that issued them.
+     *
+     * Keys are routed to a node by a `shard_map_t`, either a consistent hash ring or the Redis
+     * Cluster hash slots. Each connection is checked every `cfg_t::m_health_check_interval` with
+     * `connection_t::async_check_alive()`, and replaced by a new one when it fails. While a node
+     * has no healthy connection, the ring hands its keys to the next node.
+     *
+     * @note The I/O contexts must outlive the pool.
+     *
+     * @internal
+     */
+    struct pool_t {
+        /**
+         * @enum e_sharding
+         *
+         * @brief Defines how keys are routed to nodes.
+         *
+         * @internal
+         */
+        enum e_sharding : std::uint8_t {
+            /**
+             * @brief A consistent hash ring of independent nodes.
+             */
+            consistent_hash,
+
+            /**
+             * @brief The hash slots of a Redis Cluster, owned by the nodes as set in
+             * `cfg_t::m_slots`.
+             */
+            slots
+        };
+
+        /**
+         * @struct cfg_t
+         *
+         * @brief Configuration parameters for a pool.
+         *
+         * @internal
+         */
+        struct cfg_t {
+            /**
+             * @brief The configuration of the connections to each node.
+             */
+            std::vector<connection_t::cfg_t> m_nodes{};
+
+            /**
+             * @brief The number of connections to each node, zero for one per I/O context.
+             */
+            std::size_t m_connections_per_node{0u};
+
+            /**
+             * @brief How keys are routed to nodes.
+             */
+            e_sharding m_sharding{e_sharding::consistent_hash};
+
+            /**
+             * @brief The number of points of each node on the ring.
+             */
+            std::uint32_t m_virtual_nodes{shard_map_t::k_virtual_nodes};
+
+            /**
+             * @brief The slot ranges owned by each node, split evenly if empty.
+             */
+            std::vector<std::vector<shard_map_t::slot_range_t>> m_slots{};
+
+            /**
+             * @brief The interval of the health checks, zero to disable them.
+             */
+            std::chrono::seconds m_health_check_interval{5};
+        };
+
+        /**
+         * @struct slot_t
+         *
+         * @brief A connection of the pool and the I/O context it is bound to.
+         *
+         * @internal
+         */
+        struct slot_t {
+            CLUEAPI_INLINE slot_t(connection_t::cfg_t cfg, boost::asio::io_context& io_ctx)
+                : m_cfg{std::move(cfg)},
+                  m_io_ctx{&io_ctx},
+                  m_connection{std::make_shared<connection_t>(m_cfg, io_ctx)},
+                  m_timer{io_ctx} {
+            }
+
+            connection_t::cfg_t m_cfg;
+
+            boost::asio::io_context* m_io_ctx;
+
+            /**
+             * @brief The connection, swapped for a new one by the health check.
+             */
+            std::atomic<std::shared_ptr<connection_t>> m_connection;
+
+            std::atomic_bool m_is_healthy{false};
+
+            std::atomic_bool m_is_stopped{false};
+
+            /**
+             * @brief The timer of the health check, only touched on the I/O context.
+             */
+            boost::asio::steady_timer m_timer;
+        };
+
+       public:
+        CLUEAPI_INLINE pool_t() = delete;
+
+        /**
+         * @brief Constructs a pool, without connecting it.
+         *
+         * @param cfg The pool configuration.
+         * @param io_ctxs The I/O contexts the connections are spread over.
+         */
+        pool_t(cfg_t cfg, std::vector<boost::asio::io_context*> io_ctxs);
+
+        /**
+         * @brief Destructs the pool, stopping the health checks.
+         */
+        CLUEAPI_INLINE ~pool_t() {
+            shutdown();
+        }
+
+        // Copy constructor
+        CLUEAPI_INLINE pool_t(const pool_t&) = delete;
+
+        // Copy assignment operator
+        CLUEAPI_INLINE pool_t& operator=(const pool_t&) = delete;
+
+       public:
+        /**
+         * @brief Connects every connection of the pool, then starts the health checks.
+         *
+         * @return An awaitable that resolves to `true` if every node has a connection, `false`
+         * otherwise.
+         */
+        shared::awaitable_t<bool> async_connect();
+
+        /**
+         * @brief Stops the health checks, and disconnects every connection on its I/O context.
+         */
+        void shutdown();
+
+       public:
+        /**
+         * @brief Gets the connection serving a key.
+         *
+         * @param key The key.
+         *
+         * @return A healthy connection to the node of the key, bound to the calling I/O context
+         * when it has one, or `nullptr` if the key has no healthy node.
+         */
+        [[nodiscard]] std::shared_ptr<connection_t> connection(std::string_view key) const;
+
+        /**
+         * @brief Gets a connection to a node, e.g. for commands without a key.
+         *
+         * @param node The index of the node, as in `cfg_t::m_nodes`.
+         *
+         * @return A healthy connection to the node, bound to the calling I/O context when it has
+         * one, or `nullptr` if the node has no healthy connection.
+         */
+        [[nodiscard]] std::shared_ptr<connection_t> connection_of(std::size_t node) const;
+
+       public:
+        /**
+         * @brief Checks if the configuration of the pool is valid.
+         *
+         * @return `false` if the pool has no node or I/O context, or a slot has no owner.
+         */
+        [[nodiscard]] CLUEAPI_INLINE bool is_valid() const noexcept {
+            return !m_nodes.empty();
+        }
+
+        /**
+         * @brief Gets the number of nodes.
+         *
+         * @return The number of nodes.
+         */
+        [[nodiscard]] CLUEAPI_INLINE std::size_t nodes() const noexcept {
+            return m_nodes.size();
+        }
+
+        /**
+         * @brief Gets the number of healthy connections, across all nodes.
+         *
+         * @return The number of healthy connections.
+         */
+        [[nodiscard]] std::size_t healthy() const noexcept;
+
+        /**
+         * @brief Gets the map from keys to nodes.
+         *
+         * @return The map.
+         */
+        [[nodiscard]] CLUEAPI_INLINE const auto& shard_map() const noexcept {
+            return m_shard_map;
+        }
+
+        /**
+         * @brief Gets the pool configuration.
+         *
+         * @return The pool configuration.
+         */
+        [[nodiscard]] CLUEAPI_INLINE const auto& cfg() const noexcept {
+            return m_cfg;
+        }
+
+       private:
+        /**
+         * @brief Gets the I/O context of the pool the caller runs on.
+         *
+         * @return Its index, or `std::nullopt` if the caller runs on none of them.
+         */
+        [[nodiscard]] std::optional<std::size_t> current_io_ctx() const noexcept;
+
+        /**
+         * @brief Checks if a node has a healthy connection.
+         */
+        [[nodiscard]] bool is_usable(std::size_t node) const noexcept;
+
+        /**
+         * @brief Checks a connection every interval, replacing it when the check fails.
+         */
+        static shared::awaitable_t<void> check(
+            std::shared_ptr<slot_t> slot, std::chrono::seconds interval);
+
+       private:
+        cfg_t m_cfg;
+
+        std::vector<boost::asio::io_context*> m_io_ctxs;
+
+        shard_map_t m_shard_map;
+
+        /**
+         * @brief The connections of each node, the i-th one bound to `m_io_ctxs[i % size]`.
+         */
+        std::vector<std::vector<std::shared_ptr<slot_t>>> m_nodes;
+
+        /**
+         * @brief Spreads the calls between the connections a node has on an I/O context.
+         */
+        mutable std::atomic<std::size_t> m_next{};
+
+        std::atomic_bool m_is_checking{false};
+    };
+} // namespace clueapi::modules::redis::detail
+
+#endif // CLUEAPI_MODULES_REDIS_DETAIL_POOL_HXX
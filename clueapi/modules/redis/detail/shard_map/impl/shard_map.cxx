@@ -0,0 +1,184 @@
+/**
+ * @file shard_map.cxx
+ *
+ * @brief Implements the map from keys to the Redis nodes of a pool.
+ */
+
+#include "clueapi/modules/redis/detail/shard_map/shard_map.hxx"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+
+#include <fmt/format.h>
+
+namespace clueapi::modules::redis::detail {
+    namespace {
+        /**
+         * @brief The table of the CRC16 used by Redis Cluster (XMODEM, polynomial 0x1021).
+         */
+        constexpr auto k_crc16_table = []() {
+            std::array<std::uint16_t, 256u> table{};
+
+            for (std::uint32_t i{}; i < table.size(); i++) {
+                auto crc = static_cast<std::uint16_t>(i << 8u);
+
+                for (std::uint32_t bit{}; bit < 8u; bit++)
+                    crc = (crc & 0x8000u) != 0u ? static_cast<std::uint16_t>((crc << 1u) ^ 0x1021u)
+                                                : static_cast<std::uint16_t>(crc << 1u);
+
+                table[i] = crc;
+            }
+
+            return table;
+        }();
+    } // namespace
+
+    shard_map_t shard_map_t::make_ring(
+        const std::vector<std::string>& names, std::uint32_t virtual_nodes) {
+        shard_map_t ret{};
+
+        ret.m_nodes = names.size();
+
+        virtual_nodes = std::max(virtual_nodes, 1u);
+
+        ret.m_points.reserve(names.size() * virtual_nodes);
+
+        for (std::uint32_t node{}; node < names.size(); node++)
+            for (std::uint32_t point{}; point < virtual_nodes; point++)
+                ret.m_points.emplace_back(hash(fmt::format("{}-{}", names[node], point)), node);
+
+        std::sort(ret.m_points.begin(), ret.m_points.end());
+
+        return ret;
+    }
+
+    std::optional<shard_map_t> shard_map_t::make_slots(
+        const std::vector<std::vector<slot_range_t>>& ranges) {
+        if (ranges.empty() || ranges.size() > std::numeric_limits<std::uint16_t>::max())
+            return std::nullopt;
+
+        constexpr auto k_unowned = std::numeric_limits<std::uint16_t>::max();
+
+        shard_map_t ret{};
+
+        ret.m_nodes = ranges.size();
+
+        ret.m_slots.assign(k_slots, k_unowned);
+
+        for (std::size_t node{}; node < ranges.size(); node++) {
+            for (const auto& [first, last] : ranges[node]) {
+                if (first > last || last >= k_slots)
+                    return std::nullopt;
+
+                std::fill(
+                    ret.m_slots.begin() + first,
+                    ret.m_slots.begin() + last + 1,
+                    static_cast<std::uint16_t>(node));
+            }
+        }
+
+        if (std::find(ret.m_slots.begin(), ret.m_slots.end(), k_unowned) != ret.m_slots.end())
+            return std::nullopt;
+
+        return ret;
+    }
+
+    std::vector<std::vector<shard_map_t::slot_range_t>> shard_map_t::split_slots(
+        std::size_t nodes) {
+        std::vector<std::vector<slot_range_t>> ret{};
+
+        if (nodes == 0u)
+            return ret;
+
+        ret.resize(nodes);
+
+        for (std::size_t node{}; node < nodes; node++) {
+            const auto first = node * k_slots / nodes;
+
+            const auto last = (node + 1u) * k_slots / nodes - 1u;
+
+            if (first <= last)
+                ret[node].emplace_back(
+                    static_cast<std::uint16_t>(first), static_cast<std::uint16_t>(last));
+        }
+
+        return ret;
+    }
+
+    std::optional<std::size_t> shard_map_t::node_of(
+        std::string_view key, const is_usable_t& is_usable) const {
+        if (is_slotted()) {
+            const std::size_t node = m_slots[slot_of(key)];
+
+            if (is_usable && !is_usable(node))
+                return std::nullopt;
+
+            return node;
+        }
+
+        if (m_points.empty())
+            return std::nullopt;
+
+        auto it = std::lower_bound(
+            m_points.begin(),
+            m_points.end(),
+            hash(hash_tag(key)),
+
+            [](const auto& point, std::uint64_t position) { return point.first < position; });
+
+        // Walks clockwise, skipping the nodes that can't take the key
+        for (std::size_t i{}; i < m_points.size(); i++, it++) {
+            if (it == m_points.end())
+                it = m_points.begin();
+
+            if (!is_usable || is_usable(it->second))
+                return it->second;
+        }
+
+        return std::nullopt;
+    }
+
+    std::string_view shard_map_t::hash_tag(std::string_view key) noexcept {
+        const auto open = key.find('{');
+
+        if (open == std::string_view::npos)
+            return key;
+
+        const auto close = key.find('}', open + 1u);
+
+        if (close == std::string_view::npos || close == open + 1u)
+            return key;
+
+        return key.substr(open + 1u, close - open - 1u);
+    }
+
+    std::uint16_t shard_map_t::slot_of(std::string_view key) noexcept {
+        std::uint16_t crc{};
+
+        for (const auto c : hash_tag(key))
+            crc = static_cast<std::uint16_t>(
+                (crc << 8u) ^ k_crc16_table[((crc >> 8u) ^ static_cast<std::uint8_t>(c)) & 0xffu]);
+
+        return static_cast<std::uint16_t>(crc & (k_slots - 1u));
+    }
+
+    std::uint64_t shard_map_t::hash(std::string_view key) noexcept {
+        // FNV-1a, then the murmur3 finalizer to spread the points of close names
+        std::uint64_t ret{0xcbf29ce484222325ull};
+
+        for (const auto c : key) {
+            ret ^= static_cast<std::uint8_t>(c);
+
+            ret *= 0x100000001b3ull;
+        }
+
+        ret ^= ret >> 33u;
+        ret *= 0xff51afd7ed558ccdull;
+        ret ^= ret >> 33u;
+        ret *= 0xc4ceb9fe1a85ec53ull;
+        ret ^= ret >> 33u;
+
+        return ret;
+    }
+} // namespace clueapi::modules::redis::detail
@@ -0,0 +1,169 @@
+/**
+ * @file shard_map.hxx
+ *
+ * @brief Defines the map from keys to the Redis nodes of a pool.
+ *
+ * @details Keys are either placed on a consistent hash ring, so adding or removing a node only
+ * moves the keys of its neighbours, or routed by their Redis Cluster hash slot to the node that
+ * owns it.
+ *
+ * @internal
+ */
+
+#ifndef CLUEAPI_MODULES_REDIS_DETAIL_SHARD_MAP_HXX
+#define CLUEAPI_MODULES_REDIS_DETAIL_SHARD_MAP_HXX
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "clueapi/shared/macros.hxx"
+
+namespace clueapi::modules::redis::detail {
+    /**
+     * @struct shard_map_t
+     *
+     * @brief Maps keys to the nodes of a pool.
+     *
+     * @details Both modes honour Redis hash tags: only the part of a key between the first `{`
+     * and the next `}` is hashed when it isn't empty, so `{user:1}:name` and `{user:1}:mail`
+     * always land on the same node and can be used in one transaction.
+     *
+     * @internal
+     */
+    struct shard_map_t {
+        /**
+         * @brief The range of hash slots owned by a node, both ends included.
+         */
+        using slot_range_t = std::pair<std::uint16_t, std::uint16_t>;
+
+        /**
+         * @brief Type alias for the predicate telling if a node can take a key.
+         */
+        using is_usable_t = std::function<bool(std::size_t)>;
+
+        /**
+         * @brief The number of hash slots of a Redis Cluster.
+         */
+        static constexpr std::uint16_t k_slots{16384u};
+
+        /**
+         * @brief The default number of points of a node on the ring.
+         */
+        static constexpr std::uint32_t k_virtual_nodes{160u};
+
+       public:
+        CLUEAPI_INLINE shard_map_t() = default;
+
+       public:
+        /**
+         * @brief Makes a consistent hash ring.
+         *
+         * @param names The names of the nodes, e.g. `host:port`, hashed to place them.
+         * @param virtual_nodes The number of points of each node on the ring.
+         *
+         * @return The map.
+         */
+        static shard_map_t make_ring(
+            const std::vector<std::string>& names, std::uint32_t virtual_nodes = k_virtual_nodes);
+
+        /**
+         * @brief Makes a map routing by hash slot.
+         *
+         * @param ranges The slot ranges owned by each node, e.g. as listed by `CLUSTER SHARDS`.
+         *
+         * @return The map, or `std::nullopt` if a slot is out of range or not owned by any node.
+         */
+        static std::optional<shard_map_t> make_slots(
+            const std::vector<std::vector<slot_range_t>>& ranges);
+
+        /**
+         * @brief Splits the hash slots evenly between nodes, the way `redis-cli --cluster create`
+         * does.
+         *
+         * @param nodes The number of nodes.
+         *
+         * @return The slot ranges of each node.
+         */
+        static std::vector<std::vector<slot_range_t>> split_slots(std::size_t nodes);
+
+       public:
+        /**
+         * @brief Gets the node of a key.
+         *
+         * @param key The key.
+         * @param is_usable Tells if a node can take the key. On the ring, an unusable node hands
+         * its keys to the next usable one. A slot is only ever served by its owner.
+         *
+         * @return The index of the node, or `std::nullopt` if no node can take the key.
+         */
+        [[nodiscard]] std::optional<std::size_t> node_of(
+            std::string_view key, const is_usable_t& is_usable = {}) const;
+
+        /**
+         * @brief Gets the number of nodes.
+         *
+         * @return The number of nodes.
+         */
+        [[nodiscard]] CLUEAPI_INLINE std::size_t nodes() const noexcept {
+            return m_nodes;
+        }
+
+        /**
+         * @brief Checks if the map routes by hash slot.
+         *
+         * @return `true` if it routes by hash slot, `false` for a ring.
+         */
+        [[nodiscard]] CLUEAPI_INLINE bool is_slotted() const noexcept {
+            return !m_slots.empty();
+        }
+
+       public:
+        /**
+         * @brief Gets the part of a key that is hashed.
+         *
+         * @param key The key.
+         *
+         * @return The hash tag of the key if it has a non-empty one, the whole key otherwise.
+         */
+        [[nodiscard]] static std::string_view hash_tag(std::string_view key) noexcept;
+
+        /**
+         * @brief Gets the Redis Cluster hash slot of a key, `CRC16(tag) mod 16384`.
+         *
+         * @param key The key.
+         *
+         * @return The slot.
+         */
+        [[nodiscard]] static std::uint16_t slot_of(std::string_view key) noexcept;
+
+        /**
+         * @brief Hashes a key onto the ring, stable across processes and builds.
+         *
+         * @param key The key.
+         *
+         * @return The position of the key.
+         */
+        [[nodiscard]] static std::uint64_t hash(std::string_view key) noexcept;
+
+       private:
+        /**
+         * @brief The points of the ring, sorted by position.
+         */
+        std::vector<std::pair<std::uint64_t, std::uint32_t>> m_points;
+
+        /**
+         * @brief The owner of each hash slot, empty for a ring.
+         */
+        std::vector<std::uint16_t> m_slots;
+
+        std::size_t m_nodes{};
+    };
+} // namespace clueapi::modules::redis::detail
+
+#endif // CLUEAPI_MODULES_REDIS_DETAIL_SHARD_MAP_HXX
@@ -29,44 +29,76 @@ namespace clueapi::modules::redis {
         if (!m_running || (!io_ctx && !m_io_ctx))
             return nullptr;
 
+        auto final_cfg = cfg.has_value() ? std::move(*cfg) : make_connection_cfg();
+
+        auto* final_io_ctx = io_ctx ? io_ctx : m_io_ctx;
+
+        return std::make_shared<connection_t>(std::move(final_cfg), *final_io_ctx);
+    }
+
+    std::shared_ptr<pool_t> c_redis::create_pool(
+        std::optional<pool_t::cfg_t> cfg, std::vector<boost::asio::io_context*> io_ctxs) {
+        if (!m_running)
+            return nullptr;
+
+        if (io_ctxs.empty() && m_io_ctx)
+            io_ctxs.push_back(m_io_ctx);
+
+        auto final_cfg = pool_t::cfg_t{};
+
+        if (!cfg.has_value())
+            final_cfg.m_nodes.push_back(make_connection_cfg());
+        else
+            final_cfg = std::move(*cfg);
+
+        auto pool = std::make_shared<pool_t>(std::move(final_cfg), std::move(io_ctxs));
+
+        if (!pool->is_valid())
+            return nullptr;
+
+        return pool;
+    }
+
+    connection_t::cfg_t c_redis::make_connection_cfg() const {
         auto final_cfg = connection_t::cfg_t{};
 
-        if (!cfg.has_value()) {
-            final_cfg.m_host = m_cfg.m_host;
-            final_cfg.m_port = m_cfg.m_port;
+        final_cfg.m_host = m_cfg.m_host;
+        final_cfg.m_port = m_cfg.m_port;
 
-            final_cfg.m_use_ssl = m_cfg.m_use_ssl;
+        final_cfg.m_use_ssl = m_cfg.m_use_ssl;
 
-            if (!m_cfg.m_password.empty())
-                final_cfg.m_password = m_cfg.m_password;
+        if (!m_cfg.m_password.empty())
+            final_cfg.m_password = m_cfg.m_password;
 
-            if (!m_cfg.m_username.empty())
-                final_cfg.m_username = m_cfg.m_username;
+        if (!m_cfg.m_username.empty())
+            final_cfg.m_username = m_cfg.m_username;
 
-            {
-                final_cfg.m_client_name = "clueapi-redis-client";
+        {
+            final_cfg.m_client_name = "clueapi-redis-client";
 
-                auto uuid = boost::uuids::to_string(boost::uuids::random_generator()());
+            auto uuid = boost::uuids::to_string(boost::uuids::random_generator()());
 
-                final_cfg.m_uuid = std::move(uuid);
-            }
+            final_cfg.m_uuid = std::move(uuid);
+        }
 
-            {
-                final_cfg.m_connect_timeout = m_cfg.m_connect_timeout;
+        {
+            final_cfg.m_connect_timeout = m_cfg.m_connect_timeout;
 
-                final_cfg.m_health_check_interval = m_cfg.m_health_check_interval;
+            final_cfg.m_health_check_interval = m_cfg.m_health_check_interval;
 
-                final_cfg.m_reconnect_wait_interval = m_cfg.m_reconnect_wait_interval;
-            }
+            final_cfg.m_reconnect_wait_interval = m_cfg.m_reconnect_wait_interval;
+        }
 
-            final_cfg.m_db = m_cfg.m_db;
+        final_cfg.m_db = m_cfg.m_db;
 
-            final_cfg.m_log_level = m_cfg.m_log_level;
-        } else
-            final_cfg = std::move(*cfg);
+        final_cfg.m_log_level = m_cfg.m_log_level;
 
-        auto* final_io_ctx = io_ctx ? io_ctx : m_io_ctx;
+        final_cfg.m_auto_pipeline = m_cfg.m_auto_pipeline;
 
-        return std::make_shared<connection_t>(std::move(final_cfg), *final_io_ctx);
+        final_cfg.m_near_cache_size = m_cfg.m_near_cache_size;
+
+        final_cfg.m_near_cache_ttl = m_cfg.m_near_cache_ttl;
+
+        return final_cfg;
     }
 } // namespace clueapi::modules::redis
\ No newline at end of file
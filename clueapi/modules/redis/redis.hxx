@@ -3,6 +3,7 @@
 
 #include <memory>
 #include <optional>
+#include <vector>
 
 #include <boost/asio/io_context.hpp>
 
@@ -15,6 +16,14 @@ namespace clueapi::modules::redis {
 
     using connection_t = detail::connection_t;
 
+    using cursor_t = detail::cursor_t;
+
+    using near_cache_t = detail::near_cache_t;
+
+    using pool_t = detail::pool_t;
+
+    using shard_map_t = detail::shard_map_t;
+
     class c_redis {
        public:
         CLUEAPI_INLINE c_redis() = default;
@@ -33,6 +42,25 @@ namespace clueapi::modules::redis {
             std::optional<connection_t::cfg_t> cfg = std::nullopt,
             boost::asio::io_context* io_ctx = nullptr);
 
+        /**
+         * @brief Creates a pool of connections, spread over I/O contexts.
+         *
+         * @param cfg The pool configuration, a single node from the module configuration if not
+         * set.
+         * @param io_ctxs The I/O contexts, e.g. one per worker thread, the module one if empty.
+         *
+         * @return The pool, not yet connected, or `nullptr` if its configuration is invalid.
+         */
+        std::shared_ptr<pool_t> create_pool(
+            std::optional<pool_t::cfg_t> cfg = std::nullopt,
+            std::vector<boost::asio::io_context*> io_ctxs = {});
+
+       private:
+        /**
+         * @brief Builds the configuration of a connection from the module configuration.
+         */
+        [[nodiscard]] connection_t::cfg_t make_connection_cfg() const;
+
        public:
         [[nodiscard]] bool is_running() const noexcept {
             return m_running;
@@ -7,7 +7,9 @@
 #ifndef CLUEAPI_ROUTE_DETAIL_HXX
 #define CLUEAPI_ROUTE_DETAIL_HXX
 
+#include <array>
 #include <concepts>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <optional>
@@ -114,7 +116,48 @@ namespace clueapi::route::detail {
         std::optional<std::pair<_type_t, http::types::params_t>> find(
             http::types::method_t::e_method method,
 
-            std::string_view path);
+            std::string_view path) const;
+
+        /**
+         * @brief Finds a handler in the radix tree without copying it.
+         *
+         * @param method The HTTP method.
+         * @param path The path.
+         * @param params The parameters of the dynamic segments, filled on a match. The values are
+         * views into `path` and the names views into the tree, valid until the next `insert()`.
+         *
+         * @return A pointer to the handler, `nullptr` if not found. Valid as long as the tree.
+         */
+        const _type_t* find(
+            http::types::method_t::e_method method,
+
+            std::string_view path,
+
+            http::types::params_t& params) const;
+
+        /**
+         * @brief Converts the tree into its flat, immutable layout.
+         *
+         * @details Nodes are stored by index in a single array, in depth-first order, with the
+         * first bytes of their children in a small sorted array and one handler slot per method.
+         * A lookup then walks contiguous memory instead of chasing `shared_ptr`s and hashing.
+         *
+         * The routes without dynamic segments are also put in an open-addressing table keyed by
+         * the method and the normalized path, which is checked before walking the tree. Calling it
+         * again has no effect.
+         *
+         * @note Called before the server starts. `insert()` throws once the tree is frozen.
+         */
+        void freeze();
+
+        /**
+         * @brief Checks if the tree is frozen.
+         *
+         * @return `true` if the tree is frozen, `false` otherwise.
+         */
+        [[nodiscard]] CLUEAPI_INLINE bool is_frozen() const noexcept {
+            return !m_frozen.m_nodes.empty();
+        }
 
        public:
         /**
@@ -126,6 +169,24 @@ namespace clueapi::route::detail {
          */
         static http::types::path_t norm_path(const http::types::path_t& path) noexcept;
 
+        /**
+         * @brief Normalizes a path without copying it, the same way as `norm_path()`.
+         *
+         * @param path The path to normalize.
+         *
+         * @return A view of the normalized path, `"/"` if `path` is empty.
+         */
+        [[nodiscard]] static CLUEAPI_INLINE std::string_view norm_view(
+            std::string_view path) noexcept {
+            if (path.empty())
+                return "/";
+
+            if (path.size() > 1 && path.back() == '/')
+                path.remove_suffix(1);
+
+            return path;
+        }
+
         /**
          * @brief Splits a path into segments.
          *
@@ -162,8 +223,195 @@ namespace clueapi::route::detail {
          */
         static bool is_broken_segment(std::string_view segment) noexcept;
 
+       private:
+        /**
+         * @brief The index of a missing node, slot or handler.
+         */
+        static constexpr std::uint32_t k_npos{~std::uint32_t{}};
+
+        /**
+         * @struct frozen_node_t
+         *
+         * @brief A node of the frozen tree.
+         */
+        struct frozen_node_t {
+            /**
+             * @brief The offset of the prefix in the string pool.
+             */
+            std::uint32_t m_prefix_offset{};
+
+            /**
+             * @brief The length of the prefix.
+             */
+            std::uint32_t m_prefix_length{};
+
+            /**
+             * @brief The offset of the parameter name in the string pool.
+             */
+            std::uint32_t m_param_offset{};
+
+            /**
+             * @brief The length of the parameter name.
+             */
+            std::uint32_t m_param_length{};
+
+            /**
+             * @brief The offset of the children in the child arrays.
+             */
+            std::uint32_t m_children_offset{};
+
+            /**
+             * @brief The number of children.
+             */
+            std::uint32_t m_children_count{};
+
+            /**
+             * @brief The index of the dynamic child.
+             */
+            std::uint32_t m_dynamic_child{k_npos};
+
+            /**
+             * @brief The index of the handler slots of the node.
+             */
+            std::uint32_t m_slots{k_npos};
+        };
+
+        /**
+         * @struct static_route_t
+         *
+         * @brief A slot of the table of the routes without dynamic segments.
+         */
+        struct static_route_t {
+            /**
+             * @brief The hash of the method and the path.
+             */
+            std::uint64_t m_hash{};
+
+            /**
+             * @brief The offset of the path in the string pool.
+             */
+            std::uint32_t m_path_offset{};
+
+            /**
+             * @brief The length of the path.
+             */
+            std::uint32_t m_path_length{};
+
+            /**
+             * @brief The method of the route.
+             */
+            http::types::method_t::e_method m_method{};
+
+            /**
+             * @brief The index of the handler, `k_npos` for an empty slot.
+             */
+            std::uint32_t m_handler{k_npos};
+        };
+
+        /**
+         * @struct frozen_t
+         *
+         * @brief The flat layout of the tree.
+         */
+        struct frozen_t {
+            /**
+             * @brief The nodes, the root first.
+             */
+            std::vector<frozen_node_t> m_nodes;
+
+            /**
+             * @brief The prefixes and parameter names of the nodes.
+             */
+            std::string m_strings;
+
+            /**
+             * @brief The first bytes of the children of every node, sorted per node.
+             *
+             * @note Padded at the end so that a whole vector can be loaded from any offset.
+             */
+            std::string m_child_keys;
+
+            /**
+             * @brief The indices of the children, parallel to `m_child_keys`.
+             */
+            std::vector<std::uint32_t> m_child_nodes;
+
+            /**
+             * @brief The handler index of every method, for the nodes with handlers.
+             */
+            std::vector<std::array<std::uint32_t, http::types::method_t::count>> m_slots;
+
+            /**
+             * @brief The handlers.
+             */
+            std::vector<_type_t> m_handlers;
+
+            /**
+             * @brief The routes without dynamic segments, a power-of-two number of slots.
+             */
+            std::vector<static_route_t> m_static_routes;
+        };
+
+        /**
+         * @brief Hashes the key of a route without dynamic segments.
+         */
+        [[nodiscard]] static std::uint64_t hash_static_route(
+            http::types::method_t::e_method method, std::string_view path) noexcept;
+
+        /**
+         * @brief Finds a handler in the table of the routes without dynamic segments.
+         */
+        const _type_t* find_static(
+            http::types::method_t::e_method method, std::string_view path) const noexcept;
+
+        /**
+         * @brief Finds a handler in the tree that has not been frozen yet.
+         */
+        const _type_t* find_in_tree(
+            http::types::method_t::e_method method,
+
+            std::string_view path,
+
+            http::types::params_t& params) const;
+
+        /**
+         * @brief Finds a handler in the frozen tree.
+         */
+        const _type_t* find_in_frozen(
+            http::types::method_t::e_method method,
+
+            std::string_view path,
+
+            http::types::params_t& params) const;
+
+        /**
+         * @brief Appends a node and its subtree to the frozen tree.
+         *
+         * @param node The node.
+         * @param path The path of the parent, restored on return.
+         * @param is_static Whether no dynamic segment leads to the node.
+         * @param static_routes The routes without dynamic segments, collected for the table.
+         *
+         * @return The index of the node.
+         */
+        std::uint32_t freeze_node(
+            radix_node_t<_type_t>& node,
+
+            std::string& path,
+
+            bool is_static,
+
+            std::vector<static_route_t>& static_routes);
+
+        /**
+         * @brief Builds the table of the routes without dynamic segments.
+         */
+        void build_static_routes(const std::vector<static_route_t>& static_routes);
+
        private:
         std::shared_ptr<radix_node_t<_type_t>> m_root{};
+
+        frozen_t m_frozen{};
     };
 
     /**
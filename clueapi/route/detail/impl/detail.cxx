@@ -6,10 +6,21 @@
 
 #include "clueapi/route/detail/detail.hxx"
 
+#include <algorithm>
+#include <bit>
+
+#include <ankerl/unordered_dense.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include "clueapi/exceptions/exceptions.hxx"
 
 #include "clueapi/route/route.hxx"
 
+#include "clueapi/websocket/session/session.hxx"
+
 namespace clueapi::route::detail {
     /**
      * @brief Computes the longest common prefix of two strings.
@@ -31,6 +42,37 @@ namespace clueapi::route::detail {
         return i;
     }
 
+    /**
+     * @brief Finds the position of a byte in a small sorted array of child keys.
+     *
+     * @param keys The keys of the children, readable for 16 bytes.
+     * @param count The number of children.
+     * @param key The byte to find.
+     *
+     * @return The position of the byte, `count` if not found.
+     */
+    CLUEAPI_INLINE std::uint32_t find_child_key(
+        const char* keys, std::uint32_t count, char key) noexcept {
+#if defined(__SSE2__)
+        if (count <= 16) {
+            const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys));
+
+            const auto eq = _mm_cmpeq_epi8(block, _mm_set1_epi8(key));
+
+            const auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(eq)) &
+                              ((std::uint32_t{1} << count) - 1);
+
+            return mask ? static_cast<std::uint32_t>(std::countr_zero(mask)) : count;
+        }
+#endif
+
+        const auto* end = keys + count;
+
+        const auto* it = std::lower_bound(keys, end, key);
+
+        return it != end && *it == key ? static_cast<std::uint32_t>(it - keys) : count;
+    }
+
     template <typename _type_t>
     void radix_tree_t<_type_t>::insert(
         http::types::method_t::e_method method,
@@ -38,8 +80,22 @@ namespace clueapi::route::detail {
         http::types::path_t path,
 
         _type_t handler) {
+        if (is_frozen())
+            throw exceptions::exception_t(
+                "Can't add the route '{}' to a frozen routing table",
+
+                path);
+
         path = norm_path(path);
 
+        if (std::ranges::count(path, '{') > http::types::params_t::k_capacity) {
+            throw exceptions::exception_t(
+                "Too many dynamic segments in path '{}', the maximum is {}",
+
+                path,
+                http::types::params_t::k_capacity);
+        }
+
         auto current_node = m_root;
 
         std::string_view path_view{path};
@@ -171,21 +227,323 @@ namespace clueapi::route::detail {
     std::optional<std::pair<_type_t, http::types::params_t>> radix_tree_t<_type_t>::find(
         http::types::method_t::e_method method,
 
-        std::string_view path) {
-        if (path.length() > 1 && path.back() == '/')
-            path.remove_suffix(1);
+        std::string_view path) const {
+        http::types::params_t params{};
+
+        const auto* handler = find(method, path, params);
+
+        if (!handler)
+            return std::nullopt;
+
+        return std::make_pair(*handler, std::move(params));
+    }
+
+    template <typename _type_t>
+    const _type_t* radix_tree_t<_type_t>::find(
+        http::types::method_t::e_method method,
+
+        std::string_view path,
 
-        auto current_node = m_root;
+        http::types::params_t& params) const {
+        path = norm_view(path);
 
-        http::types::params_t params{};
+        if (is_frozen()) {
+            if (const auto* handler = find_static(method, path))
+                return handler;
+
+            return find_in_frozen(method, path, params);
+        }
+
+        return find_in_tree(method, path, params);
+    }
+
+    template <typename _type_t>
+    void radix_tree_t<_type_t>::freeze() {
+        if (is_frozen())
+            return;
+
+        std::string path{"/"};
+
+        std::vector<static_route_t> static_routes{};
+
+        freeze_node(*m_root, path, true, static_routes);
+
+        build_static_routes(static_routes);
+
+        // The child keys of the last node can be loaded as a whole vector
+        m_frozen.m_child_keys.append(16, '\0');
+
+        m_frozen.m_nodes.shrink_to_fit();
+        m_frozen.m_strings.shrink_to_fit();
+        m_frozen.m_child_keys.shrink_to_fit();
+        m_frozen.m_child_nodes.shrink_to_fit();
+        m_frozen.m_slots.shrink_to_fit();
+        m_frozen.m_handlers.shrink_to_fit();
+        m_frozen.m_static_routes.shrink_to_fit();
+
+        // The handlers were moved out, the tree is not used anymore
+        m_root.reset();
+    }
+
+    template <typename _type_t>
+    std::uint32_t radix_tree_t<_type_t>::freeze_node(
+        radix_node_t<_type_t>& node,
+
+        std::string& path,
+
+        bool is_static,
+
+        std::vector<static_route_t>& static_routes) {
+        const auto index = static_cast<std::uint32_t>(m_frozen.m_nodes.size());
+
+        const auto parent_length = path.size();
+
+        path.append(node.m_prefix);
+
+        m_frozen.m_nodes.emplace_back();
+
+        frozen_node_t frozen{};
+
+        {
+            frozen.m_prefix_offset = static_cast<std::uint32_t>(m_frozen.m_strings.size());
+            frozen.m_prefix_length = static_cast<std::uint32_t>(node.m_prefix.size());
+
+            m_frozen.m_strings.append(node.m_prefix);
+
+            frozen.m_param_offset = static_cast<std::uint32_t>(m_frozen.m_strings.size());
+            frozen.m_param_length = static_cast<std::uint32_t>(node.m_param_name.size());
+
+            m_frozen.m_strings.append(node.m_param_name);
+        }
+
+        if (!node.m_values.empty()) {
+            auto& slots = m_frozen.m_slots.emplace_back();
+
+            slots.fill(k_npos);
+
+            std::uint32_t path_offset{};
+
+            if (is_static) {
+                path_offset = static_cast<std::uint32_t>(m_frozen.m_strings.size());
+
+                m_frozen.m_strings.append(path);
+            }
+
+            for (auto& [method, handler] : node.m_values) {
+                slots[method] = static_cast<std::uint32_t>(m_frozen.m_handlers.size());
+
+                if (is_static) {
+                    static_routes.push_back(static_route_t{
+                        .m_hash = hash_static_route(method, path),
+                        .m_path_offset = path_offset,
+                        .m_path_length = static_cast<std::uint32_t>(path.size()),
+                        .m_method = method,
+                        .m_handler = slots[method]});
+                }
+
+                m_frozen.m_handlers.emplace_back(std::move(handler));
+            }
+
+            frozen.m_slots = static_cast<std::uint32_t>(m_frozen.m_slots.size() - 1);
+        }
+
+        std::vector<std::pair<char, radix_node_t<_type_t>*>> children{};
+
+        children.reserve(node.m_children.size());
+
+        for (auto& [key, child] : node.m_children)
+            children.emplace_back(key, child.get());
+
+        std::ranges::sort(children, {}, &std::pair<char, radix_node_t<_type_t>*>::first);
+
+        // The keys of a node stay contiguous, its subtrees are appended after them
+        frozen.m_children_offset = static_cast<std::uint32_t>(m_frozen.m_child_keys.size());
+        frozen.m_children_count = static_cast<std::uint32_t>(children.size());
+
+        for (const auto& [key, child] : children) {
+            m_frozen.m_child_keys.push_back(key);
+
+            m_frozen.m_child_nodes.push_back(k_npos);
+        }
+
+        for (std::uint32_t i{}; i < frozen.m_children_count; i++) {
+            const auto child = freeze_node(*children[i].second, path, is_static, static_routes);
+
+            m_frozen.m_child_nodes[frozen.m_children_offset + i] = child;
+        }
+
+        if (node.m_dynamic_child)
+            frozen.m_dynamic_child = freeze_node(*node.m_dynamic_child, path, false, static_routes);
+
+        m_frozen.m_nodes[index] = frozen;
+
+        path.resize(parent_length);
+
+        return index;
+    }
+
+    template <typename _type_t>
+    void radix_tree_t<_type_t>::build_static_routes(
+        const std::vector<static_route_t>& static_routes) {
+        if (static_routes.empty())
+            return;
+
+        // At most half full, so that a miss stops after a few probes
+        const auto capacity = std::bit_ceil(static_routes.size() * 2);
+
+        m_frozen.m_static_routes.assign(capacity, static_route_t{});
+
+        const auto mask = capacity - 1;
+
+        for (const auto& route : static_routes) {
+            auto slot = static_cast<std::size_t>(route.m_hash) & mask;
+
+            while (m_frozen.m_static_routes[slot].m_handler != k_npos)
+                slot = (slot + 1) & mask;
+
+            m_frozen.m_static_routes[slot] = route;
+        }
+    }
+
+    template <typename _type_t>
+    std::uint64_t radix_tree_t<_type_t>::hash_static_route(
+        http::types::method_t::e_method method, std::string_view path) noexcept {
+        const auto hash = ankerl::unordered_dense::hash<std::string_view>{}(path);
+
+        return hash ^ ((static_cast<std::uint64_t>(method) + 1) * 0x9e3779b97f4a7c15ull);
+    }
+
+    template <typename _type_t>
+    const _type_t* radix_tree_t<_type_t>::find_static(
+        http::types::method_t::e_method method, std::string_view path) const noexcept {
+        const auto& routes = m_frozen.m_static_routes;
+
+        if (routes.empty())
+            return nullptr;
+
+        const auto hash = hash_static_route(method, path);
+
+        const auto mask = routes.size() - 1;
+
+        for (auto slot = static_cast<std::size_t>(hash) & mask;; slot = (slot + 1) & mask) {
+            const auto& route = routes[slot];
+
+            if (route.m_handler == k_npos)
+                return nullptr;
+
+            if (route.m_hash != hash || route.m_method != method)
+                continue;
+
+            const std::string_view route_path{
+                m_frozen.m_strings.data() + route.m_path_offset, route.m_path_length};
+
+            if (route_path == path)
+                return &m_frozen.m_handlers[route.m_handler];
+        }
+    }
+
+    template <typename _type_t>
+    const _type_t* radix_tree_t<_type_t>::find_in_frozen(
+        http::types::method_t::e_method method,
+
+        std::string_view path,
+
+        http::types::params_t& params) const {
+        if (method >= http::types::method_t::count)
+            return nullptr;
+
+        const auto handler_of = [this, method](const frozen_node_t& node) -> const _type_t* {
+            if (node.m_slots == k_npos)
+                return nullptr;
+
+            const auto handler = m_frozen.m_slots[node.m_slots][method];
+
+            return handler == k_npos ? nullptr : &m_frozen.m_handlers[handler];
+        };
+
+        const auto* nodes = m_frozen.m_nodes.data();
+
+        const auto* strings = m_frozen.m_strings.data();
+
+        if (path == "/")
+            return handler_of(nodes[0]);
+
+        if (path.starts_with('/'))
+            path.remove_prefix(1);
+
+        std::uint32_t current{};
+
+        while (true) {
+            const auto& node = nodes[current];
+
+            if (path.empty())
+                return handler_of(node);
+
+            const auto pos = find_child_key(
+                m_frozen.m_child_keys.data() + node.m_children_offset,
+                node.m_children_count,
+                path.front());
+
+            if (pos != node.m_children_count) {
+                const auto child = m_frozen.m_child_nodes[node.m_children_offset + pos];
+
+                const std::string_view prefix{
+                    strings + nodes[child].m_prefix_offset, nodes[child].m_prefix_length};
+
+                if (path.starts_with(prefix)) {
+                    path.remove_prefix(prefix.length());
+
+                    if (path.starts_with('/'))
+                        path.remove_prefix(1);
+
+                    current = child;
+
+                    continue;
+                }
+            }
+
+            if (node.m_dynamic_child != k_npos) {
+                const auto next_slash = path.find('/');
+
+                auto param_value =
+                    next_slash == std::string_view::npos ? path : path.substr(0, next_slash);
+
+                if (!param_value.empty()) {
+                    params.emplace(
+                        std::string_view{strings + node.m_param_offset, node.m_param_length},
+                        param_value);
+
+                    path.remove_prefix(param_value.length());
+
+                    if (path.starts_with('/'))
+                        path.remove_prefix(1);
+
+                    current = node.m_dynamic_child;
+
+                    continue;
+                }
+            }
+
+            return nullptr;
+        }
+    }
+
+    template <typename _type_t>
+    const _type_t* radix_tree_t<_type_t>::find_in_tree(
+        http::types::method_t::e_method method,
+
+        std::string_view path,
+
+        http::types::params_t& params) const {
+        const auto* current_node = m_root.get();
 
         if (path == "/") {
             auto it = current_node->m_values.find(method);
 
             if (it != current_node->m_values.end())
-                return std::make_pair(it->second, params);
+                return &it->second;
 
-            return std::nullopt;
+            return nullptr;
         }
 
         if (path.starts_with('/'))
@@ -196,15 +554,15 @@ namespace clueapi::route::detail {
                 auto it = current_node->m_values.find(method);
 
                 if (it != current_node->m_values.end())
-                    return std::make_pair(it->second, params);
+                    return &it->second;
 
-                return std::nullopt;
+                return nullptr;
             }
 
             auto it = current_node->m_children.find(path.front());
 
             if (it != current_node->m_children.end()) {
-                auto child = it->second;
+                const auto* child = it->second.get();
 
                 if (path.starts_with(child->m_prefix)) {
                     path.remove_prefix(child->m_prefix.length());
@@ -225,34 +583,26 @@ namespace clueapi::route::detail {
                     next_slash == std::string_view::npos ? path : path.substr(0, next_slash);
 
                 if (!param_value.empty()) {
-                    params.emplace(current_node->m_param_name, std::string{param_value});
+                    params.emplace(current_node->m_param_name, param_value);
 
                     path.remove_prefix(param_value.length());
 
                     if (path.starts_with('/'))
                         path.remove_prefix(1);
 
-                    current_node = current_node->m_dynamic_child;
+                    current_node = current_node->m_dynamic_child.get();
 
                     continue;
                 }
             }
 
-            return std::nullopt;
+            return nullptr;
         }
-
-        return std::nullopt;
     }
 
     template <typename _type_t>
     http::types::path_t radix_tree_t<_type_t>::norm_path(const http::types::path_t& path) noexcept {
-        if (path.empty())
-            return "/";
-
-        if (path.size() > 1 && path.back() == '/')
-            return path.substr(0, path.size() - 1);
-
-        return path;
+        return http::types::path_t{norm_view(path)};
     }
 
     template <typename _type_t>
@@ -303,4 +653,6 @@ namespace clueapi::route::detail {
     template struct radix_tree_t<std::shared_ptr<base_route_t>>;
 
     template struct radix_tree_t<std::function<http::types::response_t(http::ctx_t)>>;
+
+    template struct radix_tree_t<websocket::handler_t>;
 } // namespace clueapi::route::detail
\ No newline at end of file
@@ -7,6 +7,7 @@
 #ifndef CLUEAPI_ROUTE_HXX
 #define CLUEAPI_ROUTE_HXX
 
+#include <cstdint>
 #include <utility>
 
 #include "clueapi/exceptions/exceptions.hxx"
@@ -16,6 +17,7 @@
 #include "clueapi/http/types/response/response.hxx"
 
 #include "clueapi/shared/macros.hxx"
+#include "clueapi/shared/metrics/metrics.hxx"
 #include "clueapi/shared/shared.hxx"
 
 #include "detail/detail.hxx"
@@ -26,6 +28,50 @@
  * @brief The main namespace for the clueapi route handlers.
  */
 namespace clueapi::route {
+    /**
+     * @enum e_body_mode
+     *
+     * @brief How the body of the requests to a route is delivered to its handler.
+     */
+    enum struct e_body_mode : std::uint8_t {
+        /**
+         * @brief The body is read in full before the handler runs (`request().body()`).
+         */
+        buffered,
+
+        /**
+         * @brief The handler reads the body from the connection (`ctx_t::body_stream()`).
+         */
+        streamed
+    };
+
+    /**
+     * @enum e_executor
+     *
+     * @brief Where the synchronous handler of a route runs.
+     *
+     * @note A coroutine handler always runs on the `io_context` of its connection, it offloads
+     * its own blocking calls (e.g., with `c_clueapi::blocking_pool()`).
+     */
+    enum struct e_executor : std::uint8_t {
+        /**
+         * @brief On the `io_context` of the connection, stalling its other connections while it
+         * runs.
+         */
+        io,
+
+        /**
+         * @brief On the CPU pool (`cfg_t::server_t::m_cpu_pool`), for CPU-heavy handlers.
+         */
+        cpu,
+
+        /**
+         * @brief On the blocking pool (`cfg_t::server_t::m_blocking_pool`), for handlers that
+         * wait on blocking I/O (files, synchronous drivers).
+         */
+        blocking
+    };
+
     /**
      * @brief A base class for routes.
      *
@@ -71,6 +117,37 @@ namespace clueapi::route {
          * @return `true` if the route is awaitable, `false` otherwise.
          */
         [[nodiscard]] virtual bool is_awaitable() const noexcept = 0;
+
+        /**
+         * @brief Gets how the body of the requests is delivered to the handler.
+         *
+         * @return The body mode of the route.
+         */
+        [[nodiscard]] virtual e_body_mode body_mode() const noexcept = 0;
+
+        /**
+         * @brief Gets where the synchronous handler runs.
+         *
+         * @return The executor of the route, ignored for a coroutine handler.
+         */
+        [[nodiscard]] virtual CLUEAPI_INLINE e_executor executor() const noexcept {
+            return e_executor::io;
+        }
+
+        /**
+         * @brief Checks if the parameters matched by the router are valid for the route.
+         *
+         * @return `true` if the handler may be called, `false` to answer `404 Not Found`.
+         */
+        [[nodiscard]] virtual CLUEAPI_INLINE bool accepts(
+            const http::types::params_t&) const noexcept {
+            return true;
+        }
+
+        /**
+         * @brief The id of the latency histogram of the route, see `shared::metrics_t`.
+         */
+        std::uint32_t m_metrics_id{shared::metrics_t::k_untracked};
     };
 
     /**
@@ -88,13 +165,22 @@ namespace clueapi::route {
          * @param method The HTTP method.
          * @param path The path.
          * @param handler The handler.
+         * @param body_mode How the body of the requests is delivered to the handler.
+         * @param executor Where the handler runs if it is synchronous.
          */
         CLUEAPI_INLINE route_t(
             const http::types::method_t::e_method& method,
             http::types::path_t path,
 
-            _handler_t&& handler) noexcept
-            : m_handler(std::move(handler)), m_path(std::move(path)), m_method(method) {
+            _handler_t&& handler,
+
+            e_body_mode body_mode = e_body_mode::buffered,
+            e_executor executor = e_executor::io) noexcept
+            : m_handler(std::move(handler)),
+              m_path(std::move(path)),
+              m_method(method),
+              m_body_mode(body_mode),
+              m_executor(executor) {
         }
 
        public:
@@ -149,6 +235,24 @@ namespace clueapi::route {
             return detail::handler_awaitable_c<_handler_t>;
         }
 
+        /**
+         * @brief Gets how the body of the requests is delivered to the handler.
+         *
+         * @return The body mode of the route.
+         */
+        [[nodiscard]] CLUEAPI_INLINE e_body_mode body_mode() const noexcept override {
+            return m_body_mode;
+        }
+
+        /**
+         * @brief Gets where the synchronous handler runs.
+         *
+         * @return The executor of the route.
+         */
+        [[nodiscard]] CLUEAPI_INLINE e_executor executor() const noexcept override {
+            return m_executor;
+        }
+
        public:
         /**
          * @brief Checks if the route is awaitable at compile time.
@@ -170,6 +274,16 @@ namespace clueapi::route {
          * @brief The HTTP method.
          */
         http::types::method_t::e_method m_method{};
+
+        /**
+         * @brief How the body of the requests is delivered to the handler.
+         */
+        e_body_mode m_body_mode{e_body_mode::buffered};
+
+        /**
+         * @brief Where the handler runs if it is synchronous.
+         */
+        e_executor m_executor{e_executor::io};
     };
 } // namespace clueapi::route
 
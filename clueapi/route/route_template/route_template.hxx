@@ -0,0 +1,569 @@
+/**
+ * @file route_template.hxx
+ *
+ * @brief Defines the route templates parsed at compile time and the routes with typed parameters.
+ */
+
+#ifndef CLUEAPI_ROUTE_ROUTE_TEMPLATE_HXX
+#define CLUEAPI_ROUTE_ROUTE_TEMPLATE_HXX
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "clueapi/exceptions/exceptions.hxx"
+
+#include "clueapi/http/ctx/ctx.hxx"
+#include "clueapi/http/types/params/params.hxx"
+#include "clueapi/http/types/response/response.hxx"
+
+#include "clueapi/route/route.hxx"
+
+#include "clueapi/shared/macros.hxx"
+#include "clueapi/shared/shared.hxx"
+
+namespace clueapi::route {
+    /**
+     * @struct fixed_string_t
+     *
+     * @brief A string literal usable as a template argument.
+     *
+     * @tparam _size The size of the literal, including the null terminator.
+     */
+    template <std::size_t _size>
+    struct fixed_string_t {
+        /**
+         * @brief Constructs a fixed string from a string literal.
+         *
+         * @param str The string literal.
+         */
+        consteval fixed_string_t(const char (&str)[_size]) noexcept {
+            std::copy_n(str, _size, m_data);
+        }
+
+        /**
+         * @brief Gets a view of the string, without the null terminator.
+         *
+         * @return The view.
+         */
+        [[nodiscard]] constexpr std::string_view view() const noexcept {
+            return {m_data, _size - 1};
+        }
+
+        /**
+         * @brief The characters of the string, including the null terminator.
+         */
+        char m_data[_size]{};
+    };
+
+    /**
+     * @enum e_param_type
+     *
+     * @brief The type of a parameter of a route template, written after a colon (`{id:u64}`).
+     */
+    enum struct e_param_type : std::uint8_t {
+        /**
+         * @brief Any non-empty segment, as a `std::string_view` (the default).
+         */
+        str,
+
+        /**
+         * @brief A signed decimal integer, as a `std::int64_t`.
+         */
+        i64,
+
+        /**
+         * @brief An unsigned decimal integer, as a `std::uint64_t`.
+         */
+        u64
+    };
+
+    namespace detail {
+        /**
+         * @brief Reports an invalid route template.
+         *
+         * @details Not `constexpr` on purpose: called while parsing a template at compile time, it
+         * makes the compilation fail with the reason in the diagnostic.
+         */
+        CLUEAPI_INLINE void invalid_route_template(const char*) noexcept {
+        }
+
+        /**
+         * @struct route_param_t
+         *
+         * @brief A parameter of a route template.
+         */
+        struct route_param_t {
+            /**
+             * @brief The name of the parameter.
+             */
+            std::string_view m_name;
+
+            /**
+             * @brief The type of the parameter.
+             */
+            e_param_type m_type{e_param_type::str};
+        };
+
+        /**
+         * @struct route_spec_t
+         *
+         * @brief A parsed route template.
+         *
+         * @tparam _size The maximum length of the path.
+         */
+        template <std::size_t _size>
+        struct route_spec_t {
+            /**
+             * @brief The path given to the router, with the types removed (`/users/{id}`).
+             */
+            std::array<char, _size> m_path{};
+
+            /**
+             * @brief The length of the path.
+             */
+            std::size_t m_path_length{};
+
+            /**
+             * @brief The parameters, in the order of the path.
+             */
+            std::array<route_param_t, http::types::params_t::k_capacity> m_params{};
+
+            /**
+             * @brief The number of parameters.
+             */
+            std::size_t m_param_count{};
+        };
+
+        /**
+         * @brief Checks if a character may appear in the name of a parameter.
+         */
+        [[nodiscard]] constexpr bool is_param_name_char(char c) noexcept {
+            return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+                   c == '_';
+        }
+
+        /**
+         * @brief Parses the type of a parameter.
+         */
+        [[nodiscard]] consteval e_param_type parse_param_type(std::string_view type) noexcept {
+            if (type.empty() || type == "str")
+                return e_param_type::str;
+
+            if (type == "i64")
+                return e_param_type::i64;
+
+            if (type == "u64")
+                return e_param_type::u64;
+
+            invalid_route_template("Unknown parameter type, expected str, i64 or u64");
+
+            return e_param_type::str;
+        }
+
+        /**
+         * @brief Parses a route template.
+         *
+         * @tparam _size The maximum length of the path.
+         *
+         * @param path The route template.
+         *
+         * @return The parsed template.
+         */
+        template <std::size_t _size>
+        [[nodiscard]] consteval route_spec_t<_size> parse_route_template(std::string_view path) {
+            route_spec_t<_size> ret{};
+
+            if (!path.starts_with('/'))
+                invalid_route_template("A route template must start with '/'");
+
+            const auto append = [&ret](std::string_view str) {
+                for (const auto c : str)
+                    ret.m_path[ret.m_path_length++] = c;
+            };
+
+            while (!path.empty()) {
+                // The leading slash of the segment
+                append(path.substr(0, 1));
+
+                path.remove_prefix(1);
+
+                const auto segment = path.substr(0, path.find('/'));
+
+                path.remove_prefix(segment.size());
+
+                if (!segment.starts_with('{')) {
+                    if (segment.find_first_of("{}") != std::string_view::npos)
+                        invalid_route_template("A parameter must span a whole segment");
+
+                    append(segment);
+
+                    continue;
+                }
+
+                if (!segment.ends_with('}') || segment.find_first_of("{}", 1) != segment.size() - 1)
+                    invalid_route_template("Unbalanced braces in a parameter");
+
+                const auto body = segment.substr(1, segment.size() - 2);
+
+                const auto colon = body.find(':');
+
+                const auto name = body.substr(0, colon);
+
+                if (name.empty())
+                    invalid_route_template("A parameter must have a name");
+
+                if (!std::ranges::all_of(name, is_param_name_char))
+                    invalid_route_template("A parameter name may only contain [A-Za-z0-9_]");
+
+                for (std::size_t i{}; i < ret.m_param_count; i++) {
+                    if (ret.m_params[i].m_name == name)
+                        invalid_route_template("Duplicate parameter name");
+                }
+
+                if (ret.m_param_count == http::types::params_t::k_capacity)
+                    invalid_route_template("Too many parameters in a route template");
+
+                const auto type = colon == std::string_view::npos ? std::string_view{}
+                                                                  : body.substr(colon + 1);
+
+                ret.m_params[ret.m_param_count++] = route_param_t{name, parse_param_type(type)};
+
+                append("{");
+                append(name);
+                append("}");
+            }
+
+            return ret;
+        }
+
+        /**
+         * @brief The traits of the types of parameters.
+         *
+         * @tparam The type of the parameter.
+         */
+        template <e_param_type>
+        struct param_traits_t;
+
+        /**
+         * @brief The traits of the string parameters.
+         */
+        template <>
+        struct param_traits_t<e_param_type::str> {
+            using value_type_t = std::string_view;
+
+            [[nodiscard]] static CLUEAPI_INLINE std::optional<value_type_t> parse(
+                std::string_view value) noexcept {
+                return value;
+            }
+        };
+
+        /**
+         * @brief The traits of the integer parameters.
+         *
+         * @tparam _type_t The type of the integer.
+         */
+        template <typename _type_t>
+        struct integer_param_traits_t {
+            using value_type_t = _type_t;
+
+            [[nodiscard]] static CLUEAPI_INLINE std::optional<value_type_t> parse(
+                std::string_view value) noexcept {
+                value_type_t ret{};
+
+                const auto* end = value.data() + value.size();
+
+                const auto [ptr, ec] = std::from_chars(value.data(), end, ret);
+
+                if (ec != std::errc{} || ptr != end)
+                    return std::nullopt;
+
+                return ret;
+            }
+        };
+
+        /**
+         * @brief The traits of the signed integer parameters.
+         */
+        template <>
+        struct param_traits_t<e_param_type::i64> : integer_param_traits_t<std::int64_t> {};
+
+        /**
+         * @brief The traits of the unsigned integer parameters.
+         */
+        template <>
+        struct param_traits_t<e_param_type::u64> : integer_param_traits_t<std::uint64_t> {};
+    } // namespace detail
+
+    /**
+     * @struct route_template_t
+     *
+     * @brief A route template, validated and parsed at compile time.
+     *
+     * @details Written like `"/users/{id:u64}/posts/{slug}"`. A parameter spans a whole segment
+     * and has an optional type (`str`, `i64` or `u64`). A malformed template, an unknown type or
+     * a duplicate name fails the compilation.
+     *
+     * @tparam _path The route template.
+     */
+    template <fixed_string_t _path>
+    struct route_template_t {
+        /**
+         * @brief The parsed template.
+         */
+        static constexpr auto k_spec =
+            detail::parse_route_template<sizeof(_path.m_data)>(_path.view());
+
+        /**
+         * @brief The path given to the router, with the types removed.
+         */
+        static constexpr std::string_view k_path{k_spec.m_path.data(), k_spec.m_path_length};
+
+        /**
+         * @brief The number of parameters.
+         */
+        static constexpr std::size_t k_param_count = k_spec.m_param_count;
+
+        /**
+         * @brief Type alias for the type of a parameter.
+         *
+         * @tparam _index The index of the parameter.
+         */
+        template <std::size_t _index>
+        using param_t =
+            typename detail::param_traits_t<k_spec.m_params[_index].m_type>::value_type_t;
+
+       private:
+        template <std::size_t... _indices>
+        static auto make_values(std::index_sequence<_indices...>)
+            -> std::tuple<param_t<_indices>...>;
+
+        template <typename _fn_t, std::size_t... _indices>
+        static auto make_result(std::index_sequence<_indices...>)
+            -> std::invoke_result_t<_fn_t&, http::ctx_t, param_t<_indices>...>;
+
+        template <typename _fn_t, std::size_t... _indices>
+        static constexpr bool is_invocable(std::index_sequence<_indices...>) noexcept {
+            return std::is_invocable_v<_fn_t&, http::ctx_t, param_t<_indices>...>;
+        }
+
+        template <typename _fn_t>
+        static constexpr bool returns_response() noexcept {
+            if constexpr (is_invocable<_fn_t>(std::make_index_sequence<k_param_count>{})) {
+                using result_t =
+                    decltype(make_result<_fn_t>(std::make_index_sequence<k_param_count>{}));
+
+                return std::is_convertible_v<result_t, http::types::response_t> ||
+                       std::is_same_v<result_t, shared::awaitable_t<http::types::response_t>>;
+            } else
+                return false;
+        }
+
+       public:
+        /**
+         * @brief Type alias for the converted parameters, in the order of the path.
+         */
+        using values_t = decltype(make_values(std::make_index_sequence<k_param_count>{}));
+
+        /**
+         * @brief Checks if a handler takes the context followed by the parameters.
+         *
+         * @tparam _fn_t The type of the handler.
+         */
+        template <typename _fn_t>
+        static constexpr bool k_is_invocable =
+            is_invocable<_fn_t>(std::make_index_sequence<k_param_count>{});
+
+        /**
+         * @brief Checks if a handler returns a response or an awaitable response.
+         *
+         * @tparam _fn_t The type of the handler.
+         */
+        template <typename _fn_t>
+        static constexpr bool k_returns_response = returns_response<_fn_t>();
+
+        /**
+         * @brief Type alias for the result of a handler.
+         *
+         * @tparam _fn_t The type of the handler.
+         */
+        template <typename _fn_t>
+        using result_t = decltype(make_result<_fn_t>(std::make_index_sequence<k_param_count>{}));
+
+       public:
+        /**
+         * @brief Converts the parameters matched by the router.
+         *
+         * @param params The parameters, in the order of the path as filled by the router.
+         *
+         * @return The converted parameters, `std::nullopt` if one doesn't match its type.
+         */
+        [[nodiscard]] static CLUEAPI_INLINE std::optional<values_t> parse(
+            const http::types::params_t& params) noexcept {
+            if (params.size() != k_param_count)
+                return std::nullopt;
+
+            return parse(params, std::make_index_sequence<k_param_count>{});
+        }
+
+       private:
+        template <std::size_t... _indices>
+        [[nodiscard]] static CLUEAPI_INLINE std::optional<values_t> parse(
+            const http::types::params_t& params, std::index_sequence<_indices...>) noexcept {
+            std::tuple<std::optional<param_t<_indices>>...> values{
+                detail::param_traits_t<k_spec.m_params[_indices].m_type>::parse(
+                    params.begin()[_indices].m_value)...};
+
+            if (!(std::get<_indices>(values).has_value() && ...))
+                return std::nullopt;
+
+            return values_t{*std::get<_indices>(values)...};
+        }
+    };
+
+    /**
+     * @brief A route whose handler receives the parameters of a template already converted.
+     *
+     * @details The handler is called as `handler(ctx, params...)`. A request whose parameters
+     * don't match their types (e.g., a non-digit `u64`) is rejected by `accepts()` before the
+     * context is built, so the handler never sees it.
+     *
+     * @tparam _template_t The route template.
+     * @tparam _fn_t The type of the handler.
+     */
+    template <typename _template_t, typename _fn_t>
+    struct typed_route_t : base_route_t {
+        /**
+         * @brief Checks if the handler is a coroutine.
+         */
+        static constexpr bool k_is_awaitable =
+            std::same_as<typename _template_t::template result_t<_fn_t>,
+                         shared::awaitable_t<http::types::response_t>>;
+
+        /**
+         * @brief Constructs a typed route.
+         *
+         * @param handler The handler.
+         * @param body_mode How the body of the requests is delivered to the handler.
+         * @param executor Where the handler runs if it is synchronous.
+         */
+        CLUEAPI_INLINE explicit typed_route_t(
+            _fn_t handler,
+            e_body_mode body_mode = e_body_mode::buffered,
+            e_executor executor = e_executor::io) noexcept
+            : m_handler(std::move(handler)), m_body_mode(body_mode), m_executor(executor) {
+        }
+
+       public:
+        /**
+         * @brief Handles a request.
+         *
+         * @param ctx The request context.
+         *
+         * @return The response.
+         */
+        CLUEAPI_INLINE http::types::response_t handle(http::ctx_t ctx) override {
+            if constexpr (!k_is_awaitable) {
+                auto values = _template_t::parse(ctx.params());
+
+                if (!values.has_value())
+                    throw exceptions::exception_t("Path parameters don't match the route template");
+
+                return std::apply(
+                    [&](auto&... args) -> http::types::response_t {
+                        return m_handler(std::move(ctx), args...);
+                    },
+
+                    *values);
+            } else
+                throw exceptions::exception_t("Asynchronous handler called synchronously");
+        }
+
+        /**
+         * @brief Handles a request asynchronously.
+         *
+         * @param ctx The request context.
+         *
+         * @return The response.
+         */
+        CLUEAPI_NOINLINE shared::awaitable_t<http::types::response_t> handle_awaitable(
+            http::ctx_t ctx) override {
+            if constexpr (k_is_awaitable) {
+                auto values = _template_t::parse(ctx.params());
+
+                if (!values.has_value())
+                    throw exceptions::exception_t("Path parameters don't match the route template");
+
+                co_return co_await std::apply(
+                    [&](auto&... args) { return m_handler(std::move(ctx), args...); }, *values);
+            } else
+                co_return handle(std::move(ctx));
+        }
+
+        /**
+         * @brief Checks if the route is awaitable.
+         *
+         * @return `true` if the route is awaitable, `false` otherwise.
+         */
+        [[nodiscard]] CLUEAPI_INLINE bool is_awaitable() const noexcept override {
+            return k_is_awaitable;
+        }
+
+        /**
+         * @brief Gets how the body of the requests is delivered to the handler.
+         *
+         * @return The body mode of the route.
+         */
+        [[nodiscard]] CLUEAPI_INLINE e_body_mode body_mode() const noexcept override {
+            return m_body_mode;
+        }
+
+        /**
+         * @brief Gets where the synchronous handler runs.
+         *
+         * @return The executor of the route.
+         */
+        [[nodiscard]] CLUEAPI_INLINE e_executor executor() const noexcept override {
+            return m_executor;
+        }
+
+        /**
+         * @brief Checks if the parameters match their types.
+         *
+         * @param params The parameters matched by the router.
+         *
+         * @return `true` if every parameter converts to its type, `false` otherwise.
+         */
+        [[nodiscard]] CLUEAPI_INLINE bool accepts(
+            const http::types::params_t& params) const noexcept override {
+            return _template_t::parse(params).has_value();
+        }
+
+       private:
+        /**
+         * @brief The handler function.
+         */
+        _fn_t m_handler;
+
+        /**
+         * @brief How the body of the requests is delivered to the handler.
+         */
+        e_body_mode m_body_mode{e_body_mode::buffered};
+
+        /**
+         * @brief Where the handler runs if it is synchronous.
+         */
+        e_executor m_executor{e_executor::io};
+    };
+} // namespace clueapi::route
+
+#endif // CLUEAPI_ROUTE_ROUTE_TEMPLATE_HXX
@@ -7,6 +7,7 @@
 #ifndef CLUEAPI_SERVER_CLIENT_HXX
 #define CLUEAPI_SERVER_CLIENT_HXX
 
+#include <chrono>
 #include <cstdint>
 
 #include <boost/asio/ip/tcp.hpp>
@@ -85,14 +86,17 @@ namespace clueapi {
              *
              * @return `true` if the client is idle, `false` otherwise.
              */
-            CLUEAPI_INLINE bool prepare_for_connection(boost::asio::ip::tcp::socket&& socket) {
+            CLUEAPI_INLINE bool prepare_for_connection(
+                boost::asio::ip::tcp::socket&& socket,
+                shared::timer_wheel_t* timer_wheel = nullptr,
+                std::shared_ptr<shared::buffer_pool_t> buffer_pool = nullptr) {
                 if (!m_data.is_idle()) {
                     CLUEAPI_LOG_WARNING("Cannot prepare non-idle client for connection");
 
                     return false;
                 }
 
-                return m_data.init(std::move(socket));
+                return m_data.init(std::move(socket), timer_wheel, std::move(buffer_pool));
             }
 
             /**
@@ -113,6 +117,13 @@ namespace clueapi {
                 m_data.reset_to_idle();
             }
 
+            /**
+             * @brief Releases the memory held by the client's buffers.
+             */
+            CLUEAPI_INLINE void release_buffers() {
+                m_data.release_buffer();
+            }
+
             /**
              * @brief Checks if the client is currently idle.
              */
@@ -120,6 +131,14 @@ namespace clueapi {
                 return m_data.is_idle();
             }
 
+           private:
+            /**
+             * @brief Records the current request in the metrics and the access log, if enabled.
+             *
+             * @param started The time the request was read.
+             */
+            void record_request(std::chrono::steady_clock::time_point started) noexcept;
+
            private:
             /**
              * @brief The server instance.
@@ -0,0 +1,134 @@
+/**
+ * @file body_stream.hxx
+ *
+ * @brief Contains the body stream that reads a request body from a client connection.
+ */
+
+#ifndef CLUEAPI_SERVER_CLIENT_DETAIL_BODY_STREAM_HXX
+#define CLUEAPI_SERVER_CLIENT_DETAIL_BODY_STREAM_HXX
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include <boost/beast/http/buffer_body.hpp>
+#include <boost/beast/http/empty_body.hpp>
+
+#include "clueapi/exceptions/wrap/wrap.hxx"
+
+#include "clueapi/http/types/body_stream/body_stream.hxx"
+
+#include "clueapi/shared/arena/arena.hxx"
+#include "clueapi/shared/macros.hxx"
+
+#include "clueapi/server/client/detail/types/types.hxx"
+
+// Forward declarations
+namespace clueapi {
+    namespace cfg {
+        struct cfg_t;
+    }
+
+    namespace server::client::detail {
+        struct data_t;
+    }
+} // namespace clueapi
+
+namespace clueapi::server::client::detail {
+    /**
+     * @struct socket_body_stream_t
+     *
+     * @brief Reads the body of a request from the client's buffer and socket on demand.
+     *
+     * @details Continues the header parser of the request with a `buffer_body`, so that each
+     * read parses at most one chunk into a buffer of `m_chunk_size` bytes. Content-Length and
+     * chunked bodies are both supported, and the `m_max_request_size` limit still applies.
+     *
+     * @note Closed by the connection when the request is reset. A handler that keeps reading
+     * after that, e.g. from a detached task, gets an error instead of touching the connection.
+     * The stream shares the arena its parser was allocated from, so the connection moves on to
+     * a new arena rather than rewinding it under the stream.
+     */
+    struct socket_body_stream_t final : http::types::body_stream_t {
+        /**
+         * @brief Constructs a new body stream.
+         *
+         * @param hdr_parser The parser that read the header of the request.
+         * @param cfg The configuration settings.
+         * @param data The data of the client.
+         */
+        socket_body_stream_t(
+            request_parser_t<boost::beast::http::empty_body>&& hdr_parser,
+            const cfg::cfg_t& cfg,
+            data_t& data);
+
+       public:
+        /**
+         * @brief Reads the next chunk of the body.
+         *
+         * @return A view of the chunk, valid until the next call. Empty once the body is complete.
+         */
+        [[nodiscard]] exceptions::expected_awaitable_t<std::string_view> read_chunk() override;
+
+        /**
+         * @brief Checks if the whole body has been read.
+         *
+         * @return `true` if the body is complete, `false` otherwise.
+         */
+        [[nodiscard]] CLUEAPI_INLINE bool is_done() const noexcept override {
+            return m_parser.is_done();
+        }
+
+        /**
+         * @brief Gets the number of bytes of the body read so far.
+         *
+         * @return The number of bytes read.
+         */
+        [[nodiscard]] CLUEAPI_INLINE std::size_t bytes_read() const noexcept override {
+            return m_bytes_read;
+        }
+
+       public:
+        /**
+         * @brief Detaches the stream from the connection.
+         */
+        CLUEAPI_INLINE void close() noexcept {
+            m_data = nullptr;
+        }
+
+       private:
+        /**
+         * @brief The arena of the parser, declared first to outlive it.
+         */
+        std::shared_ptr<shared::arena_t> m_arena;
+
+        /**
+         * @brief The parser of the request, continued from its header.
+         */
+        request_parser_t<boost::beast::http::buffer_body> m_parser;
+
+        /**
+         * @brief The buffer of the current chunk.
+         */
+        std::string m_chunk;
+
+        /**
+         * @brief The deadline of a read, `0` to keep the connection's current deadline.
+         */
+        std::chrono::milliseconds m_read_timeout{};
+
+        /**
+         * @brief The number of bytes of the body read so far.
+         */
+        std::size_t m_bytes_read{};
+
+        /**
+         * @brief The data of the client, `nullptr` once the stream is closed.
+         */
+        data_t* m_data{};
+    };
+} // namespace clueapi::server::client::detail
+
+#endif // CLUEAPI_SERVER_CLIENT_DETAIL_BODY_STREAM_HXX
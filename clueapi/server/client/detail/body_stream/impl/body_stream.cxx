@@ -0,0 +1,100 @@
+/**
+ * @file body_stream.cxx
+ *
+ * @brief Implements the body stream of a client connection.
+ */
+
+#include "clueapi/server/client/detail/body_stream/body_stream.hxx"
+
+#include "clueapi/cfg/cfg.hxx"
+
+#include "clueapi/server/client/detail/data/data.hxx"
+#include "clueapi/server/client/detail/detail.hxx"
+
+#include <algorithm>
+
+#include <boost/beast/http/read.hpp>
+
+namespace clueapi::server::client::detail {
+    socket_body_stream_t::socket_body_stream_t(
+        request_parser_t<boost::beast::http::empty_body>&& hdr_parser,
+        const cfg::cfg_t& cfg,
+        data_t& data)
+        : m_arena{data.m_arena},
+          m_parser{std::move(hdr_parser)},
+          m_chunk(std::max<std::size_t>(cfg.m_http.m_chunk_size, 1u), '\0'),
+          m_read_timeout{cfg.m_socket.m_timeout},
+          m_data{&data} {
+        m_parser.body_limit(cfg.m_http.m_max_request_size);
+    }
+
+    exceptions::expected_awaitable_t<std::string_view> socket_body_stream_t::read_chunk() {
+        while (!m_parser.is_done()) {
+            if (!m_data || !m_data->m_socket)
+                co_return exceptions::make_unexpected("Body stream is closed");
+
+            auto& socket = *m_data->m_socket;
+
+            auto& body = m_parser.get().body();
+
+            body.data = m_chunk.data();
+            body.size = m_chunk.size();
+            body.more = true;
+
+            boost::system::error_code ec{};
+
+            if (m_data->m_timeout) {
+                // Slow uploads stay alive as long as every chunk arrives in time
+                if (m_read_timeout.count() > 0)
+                    m_data->m_timeout.expires_after(m_read_timeout);
+
+                auto expected = co_await exec_with_timeout(
+                    boost::beast::http::async_read_some(
+                        socket,
+
+                        m_data->m_buffer,
+
+                        m_parser,
+
+                        boost::asio::redirect_error(boost::asio::use_awaitable, ec)),
+
+                    m_data->m_timeout);
+
+                if (!expected.has_value())
+                    co_return exceptions::make_unexpected("Operation timed out");
+            } else {
+                co_await boost::beast::http::async_read_some(
+                    socket,
+
+                    m_data->m_buffer,
+
+                    m_parser,
+
+                    boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+            }
+
+            // The chunk buffer is full, which is how every successful read ends
+            if (ec == boost::beast::http::error::need_buffer)
+                ec = {};
+
+            if (ec) {
+                if (ec == boost::beast::http::error::body_limit)
+                    co_return exceptions::make_unexpected("Payload too large");
+
+                co_return exceptions::make_unexpected(ec.message());
+            }
+
+            const auto read = m_chunk.size() - body.size;
+
+            // Only framing (e.g., a chunk header) was parsed
+            if (read == 0)
+                continue;
+
+            m_bytes_read += read;
+
+            co_return std::string_view{m_chunk.data(), read};
+        }
+
+        co_return std::string_view{};
+    }
+} // namespace clueapi::server::client::detail
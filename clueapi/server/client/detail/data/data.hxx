@@ -7,23 +7,33 @@
 #ifndef CLUEAPI_SERVER_CLIENT_DETAIL_DATA_HXX
 #define CLUEAPI_SERVER_CLIENT_DETAIL_DATA_HXX
 
+#include <algorithm>
 #include <cstdint>
+#include <memory>
 #include <optional>
+#include <string>
+#include <string_view>
 #include <utility>
+#include <vector>
 #include <exception>
 
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/steady_timer.hpp>
-#include <boost/beast/core/flat_buffer.hpp>
-#include <boost/beast/http/message.hpp>
-#include <boost/beast/http/string_body.hpp>
 #include <boost/system/error_code.hpp>
 
+#include "clueapi/http/range/range.hxx"
 #include "clueapi/http/types/request/request.hxx"
 #include "clueapi/http/types/response/response.hxx"
 
 #include "clueapi/modules/macros.hxx"
+#include "clueapi/shared/arena/arena.hxx"
+#include "clueapi/shared/buffer_pool/buffer_pool.hxx"
 #include "clueapi/shared/macros.hxx"
+#include "clueapi/shared/timer_wheel/timer_wheel.hxx"
+#include "clueapi/shared/tracing/tracing.hxx"
+
+#include "clueapi/server/client/detail/body_stream/body_stream.hxx"
+#include "clueapi/server/client/detail/timeout/timeout.hxx"
 
 namespace clueapi::server::client::detail {
     /**
@@ -32,6 +42,72 @@ namespace clueapi::server::client::detail {
      * @brief Contains the state of a client connection.
      */
     struct data_t {
+        /**
+         * @struct pending_write_t
+         *
+         * @brief A response waiting for the gathered write.
+         */
+        struct pending_write_t {
+            /**
+             * @brief The end of the response's header block in `m_output`.
+             */
+            std::size_t m_header_end{};
+
+            /**
+             * @brief The body of the response, sent as its own buffer.
+             */
+            http::types::body_t m_body{};
+
+            /**
+             * @brief The shared body of the response, sent instead of `m_body` when it is set.
+             */
+            http::types::shared_body_t m_shared_body{};
+
+            /**
+             * @brief Gets the bytes of the body.
+             *
+             * @return A view of the shared body if it is set, of `m_body` otherwise.
+             */
+            [[nodiscard]] CLUEAPI_INLINE std::string_view view() const noexcept {
+                return m_shared_body ? m_shared_body.m_data : std::string_view{m_body};
+            }
+        };
+
+        /**
+         * @struct request_info_t
+         *
+         * @brief What the connection reads of a request once its handler ran.
+         *
+         * @details The handler's context shares the request and may move from it, so these are
+         * taken before the handler is called.
+         */
+        struct request_info_t {
+            /**
+             * @brief The URI of the request.
+             */
+            std::string m_uri;
+
+            /**
+             * @brief The preconditions of a file response, with the method of the request.
+             */
+            http::range::preconditions_t m_preconditions;
+
+            /**
+             * @brief The size of the buffered body of the request.
+             */
+            std::size_t m_body_size{};
+
+            /**
+             * @brief The trace of the request, `nullptr` if it isn't traced.
+             */
+            shared::trace_t* m_trace{};
+
+            /**
+             * @brief If true, the client asked for a persistent connection.
+             */
+            bool m_is_keep_alive{true};
+        };
+
         /**
          * @enum e_state
          *
@@ -70,12 +146,18 @@ namespace clueapi::server::client::detail {
          * @brief Initializes the client with a new socket.
          *
          * @param socket The socket to use.
+         * @param timer_wheel The timer wheel of the socket's worker, `nullptr` to use a timer.
+         * @param buffer_pool The buffer pool of the socket's worker, `nullptr` for the buffer to
+         * keep its memory.
          *
          * @return True if the initialization was successful, false otherwise.
          *
          * @note This method should only be called once per client.
          */
-        CLUEAPI_INLINE bool init(boost::asio::ip::tcp::socket&& socket) {
+        CLUEAPI_INLINE bool init(
+            boost::asio::ip::tcp::socket&& socket,
+            shared::timer_wheel_t* timer_wheel = nullptr,
+            std::shared_ptr<shared::buffer_pool_t> buffer_pool = nullptr) {
             if (m_state != e_state::idle) {
                 CLUEAPI_LOG_WARNING("Attempting to initialize client in non-idle state");
 
@@ -85,13 +167,30 @@ namespace clueapi::server::client::detail {
             try {
                 m_state = e_state::active;
 
+                // The buffer is empty between connections, so switching its pool copies nothing
+                if (buffer_pool.get() != m_buffer_pool) {
+                    m_buffer_pool = buffer_pool.get();
+
+                    shared::buffer_allocator_t<char> allocator{std::move(buffer_pool)};
+
+                    m_buffer = shared::pooled_buffer_t{m_buffer.max_size(), std::move(allocator)};
+                }
+
                 m_socket.emplace(std::move(socket));
 
                 if (m_socket && m_socket->is_open()) {
                     const auto& executor = m_socket->get_executor();
 
-                    if (!m_timeout_timer)
-                        m_timeout_timer.emplace(executor);
+                    // Cancelling the socket completes the pending operation, which then
+                    // observes the expired deadline
+                    m_timeout.init(executor, timer_wheel, [this] {
+                        if (!m_socket)
+                            return;
+
+                        boost::system::error_code ec{};
+
+                        m_socket->cancel(ec);
+                    });
 
                     return true;
                 }
@@ -138,19 +237,32 @@ namespace clueapi::server::client::detail {
 
             m_socket.reset();
 
-            if (m_timeout_timer) {
-                m_timeout_timer->cancel();
-
-                m_timeout_timer.reset();
-            }
+            m_timeout.reset();
 
             m_buffer.consume(m_buffer.size());
 
-            m_request.reset();
+            if (m_buffer_pool)
+                m_buffer.shrink_to_fit();
+
+            reset_request();
 
             m_response_data.reset();
 
-            m_beast_request.clear();
+            m_version = 11;
+
+            m_pending_writes.clear();
+
+            m_output.clear();
+
+            reset_arena();
+
+            m_pending_bytes = 0;
+
+            m_write_behind.reset();
+
+            m_is_write_behind_armed = false;
+
+            m_is_writing_behind = false;
 
             m_should_close = false;
 
@@ -188,19 +300,29 @@ namespace clueapi::server::client::detail {
                     m_socket.reset();
                 }
 
-                if (m_timeout_timer) {
-                    m_timeout_timer->cancel();
-
-                    m_timeout_timer.reset();
-                }
+                m_timeout.reset();
 
                 m_buffer.clear();
 
-                m_request.reset();
+                reset_request();
 
                 m_response_data.reset();
 
-                m_beast_request.clear();
+                m_version = 11;
+
+                m_pending_writes.clear();
+
+                m_output.clear();
+
+                reset_arena();
+
+                m_pending_bytes = 0;
+
+                m_write_behind.reset();
+
+                m_is_write_behind_armed = false;
+
+                m_is_writing_behind = false;
 
                 m_should_close = false;
 
@@ -210,18 +332,144 @@ namespace clueapi::server::client::detail {
             }
         }
 
+        /**
+         * @brief Takes what the connection reads of the request once its handler ran.
+         *
+         * @details Called before the request is handed to the middleware chain. The strings keep
+         * their capacity from one request to the next.
+         */
+        CLUEAPI_INLINE void capture_request() {
+            const auto& request = *m_request;
+
+            m_request_info.m_uri.assign(request.uri());
+
+            m_request_info.m_preconditions.assign(request);
+
+            m_request_info.m_body_size = request.body().size();
+
+            m_request_info.m_trace = request.trace();
+
+            m_request_info.m_is_keep_alive = request.keep_alive();
+
+            m_is_request_captured = true;
+        }
+
+        /**
+         * @brief Gets what the connection reads of the request once its handler ran.
+         *
+         * @return The info, taken now if the request never reached a handler.
+         */
+        [[nodiscard]] CLUEAPI_INLINE const request_info_t& request_info() {
+            if (!m_is_request_captured)
+                capture_request();
+
+            return m_request_info;
+        }
+
+        /**
+         * @brief Resets the request for the next one on the connection.
+         *
+         * @details The request is recycled in place, keeping its buffers, unless a handler's
+         * context still refers to it (e.g., from a detached task), in which case a new one is
+         * allocated and the old one is left to its remaining owners. A body stream is detached
+         * from the connection either way, and the status and size of the last response are
+         * cleared, so a request that writes no response doesn't log those of the previous one.
+         */
+        CLUEAPI_INLINE void reset_request() {
+            if (m_body_stream) {
+                m_body_stream->close();
+
+                m_body_stream.reset();
+            }
+
+            // Before the early return, the recycled request is the common case
+            m_is_request_captured = false;
+
+            m_sent_status = 0u;
+
+            m_sent_bytes = 0u;
+
+            if (m_request && m_request.use_count() == 1) {
+                m_request->reset();
+
+                return;
+            }
+
+            // The trace is reused by the next request, the remaining owners lose it
+            if (m_request)
+                m_request->trace() = nullptr;
+
+            m_request = std::make_shared<http::types::request_t>();
+        }
+
+        /**
+         * @brief Resets the arena for the next request on the connection.
+         *
+         * @details The arena is rewound in place, keeping its blocks, unless a body stream kept
+         * by a handler still holds a parser in it, in which case a new arena is allocated and the
+         * old one is left to the stream.
+         *
+         * @note Must be called after `reset_request()`, once the handlers of the request are done.
+         */
+        CLUEAPI_INLINE void reset_arena() {
+            if (m_arena && m_arena.use_count() == 1) {
+                m_arena->reset();
+
+                return;
+            }
+
+            m_arena = std::make_shared<shared::arena_t>();
+        }
+
+        /**
+         * @brief Releases the memory of the buffer, keeping its size limit.
+         *
+         * @note Used by elastic pools so that parked clients hold no buffer memory. The buffer is
+         * faulted in again by the next read.
+         */
+        CLUEAPI_INLINE void release_buffer() {
+            m_buffer.consume(m_buffer.size());
+
+            m_buffer.shrink_to_fit();
+        }
+
+        /**
+         * @brief Borrows a chunk from the buffer pool for the buffer to read a request into.
+         *
+         * @note Does nothing without a pool, or if the buffer already holds memory.
+         */
+        CLUEAPI_INLINE void borrow_buffer() {
+            if (!m_buffer_pool || m_buffer.capacity() != 0u)
+                return;
+
+            m_buffer.reserve(std::min(m_buffer_pool->chunk_size(), m_buffer.max_size()));
+        }
+
+        /**
+         * @brief Gives the memory of the buffer back to the buffer pool between two requests.
+         *
+         * @note Does nothing without a pool, or if the buffer holds bytes of the next request.
+         */
+        CLUEAPI_INLINE void return_buffer() noexcept {
+            if (!m_buffer_pool || m_buffer.size() != 0u)
+                return;
+
+            m_buffer.shrink_to_fit();
+        }
+
         /**
          * @brief Cuts the buffer to the specified size.
          *
          * @param size The new size of the buffer.
          *
-         * @note This method is used to reduce the memory footprint of the buffer.
+         * @note This method is used to reduce the memory footprint of the buffer. Does nothing
+         * if the buffer holds bytes of the next request.
          */
         CLUEAPI_INLINE void cut_buffer(std::size_t size) {
-            if (m_buffer.capacity() < size * 2)
+            if (m_buffer.size() != 0u || m_buffer.capacity() < size * 2)
                 return;
 
-            boost::beast::flat_buffer tmp{};
+            shared::pooled_buffer_t tmp{m_buffer.get_allocator()};
 
             std::swap(m_buffer, tmp);
 
@@ -273,19 +521,48 @@ namespace clueapi::server::client::detail {
         std::optional<boost::asio::ip::tcp::socket> m_socket;
 
         /**
-         * @brief The timeout timer of the client.
+         * @brief The timeout of the client.
          */
-        std::optional<boost::asio::steady_timer> m_timeout_timer;
+        timeout_t m_timeout;
 
         /**
          * @brief The buffer of the client.
          */
-        boost::beast::flat_buffer m_buffer;
+        shared::pooled_buffer_t m_buffer;
+
+        /**
+         * @brief The pool the memory of the buffer is borrowed from, `nullptr` if the buffer
+         * keeps its memory.
+         */
+        shared::buffer_pool_t* m_buffer_pool{};
+
+        /**
+         * @brief The arena of the beast parsers and responses of the current request.
+         */
+        std::shared_ptr<shared::arena_t> m_arena{std::make_shared<shared::arena_t>()};
+
+        /**
+         * @brief The request of the client, shared with the handler's context without copying.
+         *
+         * @note The handler may move from it, read `request_info()` once the handler ran.
+         */
+        std::shared_ptr<http::types::request_t> m_request{
+            std::make_shared<http::types::request_t>()};
+
+        /**
+         * @brief What the connection reads of the request once its handler ran.
+         */
+        request_info_t m_request_info;
 
         /**
-         * @brief The request of the client.
+         * @brief If true, `m_request_info` was taken from the current request.
          */
-        http::types::request_t m_request;
+        bool m_is_request_captured{false};
+
+        /**
+         * @brief The stream of the request body, set for the routes that read it themselves.
+         */
+        std::shared_ptr<socket_body_stream_t> m_body_stream;
 
         /**
          * @brief The response data of the client.
@@ -293,9 +570,60 @@ namespace clueapi::server::client::detail {
         http::types::response_t m_response_data;
 
         /**
-         * @brief The BEAST request of the client.
+         * @brief The HTTP version of the current request, e.g. `11`.
+         */
+        std::uint32_t m_version{11};
+
+        /**
+         * @brief The responses waiting for a gathered write.
+         */
+        std::vector<pending_write_t> m_pending_writes;
+
+        /**
+         * @brief The header blocks of the pending responses, back to back.
+         *
+         * @note Cleared rather than released after a write, so its capacity serves the next
+         * responses of the connection.
+         */
+        std::string m_output;
+
+        /**
+         * @brief The total size of the pending responses in bytes.
+         */
+        std::size_t m_pending_bytes{};
+
+        /**
+         * @brief Writes the pending responses if the handler of the next pipelined request runs
+         * too long, then wakes the handler waiting for that write. Created on first use.
+         */
+        std::optional<boost::asio::steady_timer> m_write_behind;
+
+        /**
+         * @brief If true, `m_write_behind` is armed for the handler running.
+         */
+        bool m_is_write_behind_armed{};
+
+        /**
+         * @brief If true, the pending responses are being written behind the handler.
+         */
+        bool m_is_writing_behind{};
+
+        /**
+         * @brief The status of the response to the current request, for the access log.
+         */
+        std::uint16_t m_sent_status{};
+
+        /**
+         * @brief The number of body bytes of the response to the current request, for the access
+         * log.
+         */
+        std::uint64_t m_sent_bytes{};
+
+        /**
+         * @brief The trace of the current request, reused by the next ones while tracing is
+         * enabled.
          */
-        boost::beast::http::message<true, boost::beast::http::string_body> m_beast_request;
+        shared::trace_t m_trace{};
     };
 } // namespace clueapi::server::client::detail
 
@@ -20,8 +20,11 @@
 #include "clueapi/modules/macros.hxx"
 
 #include "clueapi/shared/macros.hxx"
+#include "clueapi/shared/metrics/metrics.hxx"
 #include "clueapi/shared/shared.hxx"
 
+#include "timeout/timeout.hxx"
+
 /**
  * @namespace clueapi::server::client::detail
  *
@@ -111,12 +114,50 @@ namespace clueapi::server::client::detail {
 
         auto result = co_await (std::move(op) || wait_for_timer(timer));
 
-        if (result.index() == 1)
+        if (result.index() == 1) {
+            shared::metrics_t::record_timeout();
+
             co_return exceptions::make_unexpected(
                 exceptions::io_error_t::make("Operation timed out"));
+        }
 
         co_return exceptions::expected_t<typename _op_t::value_type>{std::get<0>(result)};
     }
+
+    /**
+     * @brief Executes an operation with the deadline of a client request.
+     *
+     * @tparam _op_t The operation type.
+     *
+     * @param op The operation to execute.
+     * @param timeout The deadline of the request.
+     *
+     * @return The result of the operation.
+     *
+     * @note With a timer wheel nothing is armed per operation: the expired entry cancels the
+     * socket, and the completed operation observes the expiry.
+     */
+    template <typename _op_t>
+    static inline exceptions::expected_awaitable_t<typename _op_t::value_type> exec_with_timeout(
+        _op_t op, timeout_t& timeout) {
+        if (!timeout.uses_wheel())
+            co_return co_await exec_with_timeout(std::move(op), timeout.timer());
+
+        if (timeout.is_expired())
+            co_return exceptions::make_unexpected(
+                exceptions::io_error_t::make("Operation timed out"));
+
+        auto result = co_await std::move(op);
+
+        if (timeout.is_expired()) {
+            shared::metrics_t::record_timeout();
+
+            co_return exceptions::make_unexpected(
+                exceptions::io_error_t::make("Operation timed out"));
+        }
+
+        co_return exceptions::expected_t<typename _op_t::value_type>{std::move(result)};
+    }
 } // namespace clueapi::server::client::detail
 
 #include "data/data.hxx"
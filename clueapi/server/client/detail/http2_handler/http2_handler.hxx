@@ -0,0 +1,94 @@
+/**
+ * @file http2_handler.hxx
+ *
+ * @brief Contains the implementation of the client-related functionality.
+ */
+
+#ifndef CLUEAPI_SERVER_CLIENT_DETAIL_HTTP2_HANDLER_HXX
+#define CLUEAPI_SERVER_CLIENT_DETAIL_HTTP2_HANDLER_HXX
+
+#include <boost/asio/ip/tcp.hpp>
+
+#include "clueapi/exceptions/wrap/wrap.hxx"
+
+#include "clueapi/shared/macros.hxx"
+#include "clueapi/shared/shared.hxx"
+
+// Forward declarations
+namespace clueapi {
+    namespace cfg {
+        struct cfg_t;
+    }
+
+    namespace server {
+        class c_server;
+
+        namespace client::detail {
+            struct data_t;
+        }
+    } // namespace server
+} // namespace clueapi
+
+namespace clueapi::server::client::detail {
+    /**
+     * @struct http2_handler_t
+     *
+     * @brief Detects an HTTP/2 connection by its preface and serves it.
+     */
+    struct http2_handler_t {
+        /**
+         * @brief Constructs a new HTTP/2 handler.
+         *
+         * @param server The server instance.
+         * @param socket The socket of the client.
+         * @param cfg The configuration settings.
+         * @param data The data of the client.
+         */
+        CLUEAPI_INLINE http2_handler_t(
+            server::c_server& server,
+            boost::asio::ip::tcp::socket& socket,
+            const cfg::cfg_t& cfg,
+            data_t& data)
+            : m_server{server}, m_socket{socket}, m_cfg{cfg}, m_data{data} {
+        }
+
+       public:
+        /**
+         * @brief Reads the first bytes of the connection into the buffer of the client.
+         *
+         * @return `true` if the connection starts with the HTTP/2 preface, `false` if it is
+         * HTTP/1.x, or an unexpected if the connection failed.
+         *
+         * @note The bytes read stay in the buffer, for the request parser or the HTTP/2 session.
+         */
+        exceptions::expected_awaitable_t<bool> detect();
+
+        /**
+         * @brief Serves the connection over HTTP/2 until it is closed.
+         */
+        shared::awaitable_t<void> handle();
+
+       private:
+        /**
+         * @brief The server instance.
+         */
+        server::c_server& m_server;
+
+        /**
+         * @brief The socket of the client.
+         */
+        boost::asio::ip::tcp::socket& m_socket;
+
+        /**
+         * @brief The configuration settings.
+         */
+        const cfg::cfg_t& m_cfg;
+
+        /**
+         * @brief The data of the client.
+         */
+        data_t& m_data;
+    };
+} // namespace clueapi::server::client::detail
+
+#endif // CLUEAPI_SERVER_CLIENT_DETAIL_HTTP2_HANDLER_HXX
@@ -0,0 +1,91 @@
+/**
+ * @file http2_handler.cxx
+ *
+ * @brief Implements the HTTP/2 handler.
+ */
+
+#include "clueapi/server/client/detail/http2_handler/http2_handler.hxx"
+
+#include "clueapi/cfg/cfg.hxx"
+
+#include "clueapi/exceptions/exceptions.hxx"
+
+#include "clueapi/modules/macros.hxx"
+
+#include "clueapi/server/client/detail/detail.hxx"
+
+#include "clueapi/server/http2/http2.hxx"
+
+#include "clueapi/server/server.hxx"
+
+#include <string_view>
+
+namespace clueapi::server::client::detail {
+    exceptions::expected_awaitable_t<bool> http2_handler_t::detect() {
+        const auto native_handle = m_socket.native_handle();
+
+        m_data.borrow_buffer();
+
+        // A request line differs from the preface within its first bytes
+        while (m_data.m_buffer.size() < http2::k_preface.size()) {
+            const auto data = m_data.m_buffer.cdata();
+
+            if (!http2::c_connection::is_preface(
+                    {static_cast<const char*>(data.data()), data.size()}))
+                co_return exceptions::expected_t<bool>{false};
+
+            boost::system::error_code ec{};
+
+            std::size_t read{};
+
+            if (m_data.m_timeout) {
+                auto expected = co_await exec_with_timeout(
+                    m_socket.async_read_some(
+                        m_data.m_buffer.prepare(http2::k_preface.size()),
+
+                        boost::asio::redirect_error(boost::asio::use_awaitable, ec)),
+
+                    m_data.m_timeout);
+
+                if (!expected.has_value())
+                    co_return exceptions::make_unexpected("Operation timed out");
+
+                read = expected.value();
+            } else {
+                read = co_await m_socket.async_read_some(
+                    m_data.m_buffer.prepare(http2::k_preface.size()),
+
+                    boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+            }
+
+            m_data.m_buffer.commit(read);
+
+            if (close_connection(ec, native_handle))
+                co_return exceptions::make_unexpected("Connection closed");
+        }
+
+        const auto data = m_data.m_buffer.cdata();
+
+        co_return exceptions::expected_t<bool>{http2::c_connection::is_preface(
+            {static_cast<const char*>(data.data()), data.size()})};
+    }
+
+    shared::awaitable_t<void> http2_handler_t::handle() {
+        // The connection has its own idle timeout, the session sets no deadline
+        m_data.m_timeout.reset();
+
+        m_data.m_should_close = true;
+
+        CLUEAPI_LOG_DEBUG("HTTP/2 connection started (id: {})", m_socket.native_handle());
+
+        http2::c_connection connection{
+            m_socket,
+            m_data.m_buffer,
+            m_cfg,
+            [this](const http::types::request_t& request) {
+                return m_server.middleware_chain()(request);
+            }};
+
+        co_await connection.run();
+    }
+} // namespace clueapi::server::client::detail
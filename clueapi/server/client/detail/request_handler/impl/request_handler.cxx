@@ -8,6 +8,8 @@
 
 #include "clueapi/cfg/cfg.hxx"
 
+#include "clueapi/clueapi.hxx"
+
 #include "clueapi/exceptions/exceptions.hxx"
 
 #include "clueapi/http/types/method/method.hxx"
@@ -15,20 +17,91 @@
 
 #include "clueapi/server/client/detail/detail.hxx"
 
+#include "clueapi/server/server.hxx"
+
 #include "clueapi/shared/non_copy/extract_from/extract_from.hxx"
 
-#include <boost/filesystem.hpp>
+#include <charconv>
+#include <cstdint>
+#include <system_error>
 
 #include <boost/algorithm/string/predicate.hpp>
 
-#include <boost/asio/stream_file.hpp>
-
 #include <boost/beast/http/read.hpp>
 #include <boost/beast/websocket.hpp>
 
 namespace clueapi::server::client::detail {
+    namespace {
+        /**
+         * @brief Maps a field already recognized by the beast parser to a well-known header.
+         *
+         * @param name The beast field.
+         *
+         * @return The well-known header, `e_header::unknown` if the field is not one.
+         */
+        [[nodiscard]] http::types::e_header to_known_header(
+            boost::beast::http::field name) noexcept {
+            using boost::beast::http::field;
+            using http::types::e_header;
+
+            switch (name) {
+                case field::content_type:
+                    return e_header::content_type;
+                case field::content_length:
+                    return e_header::content_length;
+                case field::cookie:
+                    return e_header::cookie;
+                case field::connection:
+                    return e_header::connection;
+                case field::host:
+                    return e_header::host;
+                case field::transfer_encoding:
+                    return e_header::transfer_encoding;
+                case field::accept:
+                    return e_header::accept;
+                case field::accept_encoding:
+                    return e_header::accept_encoding;
+                case field::authorization:
+                    return e_header::authorization;
+                case field::user_agent:
+                    return e_header::user_agent;
+                case field::upgrade:
+                    return e_header::upgrade;
+                case field::range:
+                    return e_header::range;
+                case field::if_range:
+                    return e_header::if_range;
+                case field::if_none_match:
+                    return e_header::if_none_match;
+                case field::if_modified_since:
+                    return e_header::if_modified_since;
+                default:
+                    return e_header::unknown;
+            }
+        }
+
+        /**
+         * @brief Waits until a socket can be read from.
+         *
+         * @param socket The socket.
+         * @param ec The error code of the wait.
+         *
+         * @return An awaitable that resolves to `true` once the wait is over.
+         */
+        shared::awaitable_t<bool> wait_readable(
+            boost::asio::ip::tcp::socket& socket, boost::system::error_code& ec) {
+            co_await socket.async_wait(
+                boost::asio::ip::tcp::socket::wait_read,
+
+                boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+
+            co_return true;
+        }
+    } // namespace
+
     exceptions::expected_awaitable_t<e_error_code> req_handler_t::handle() {
-        boost::beast::http::request_parser<boost::beast::http::empty_body>&& hdr_parser{};
+        auto hdr_parser =
+            make_in_arena<request_parser_t<boost::beast::http::empty_body>>(*m_data.m_arena);
 
         {
             hdr_parser.body_limit(m_cfg.m_http.m_max_request_size);
@@ -38,190 +111,168 @@ namespace clueapi::server::client::detail {
 
         boost::system::error_code ec{};
 
-        if (m_data.m_timeout_timer) {
-            auto expected = co_await exec_with_timeout(
-                boost::beast::http::async_read_header(
-                    m_socket,
-
-                    m_data.m_buffer,
-
-                    hdr_parser,
-
-                    boost::asio::redirect_error(boost::asio::use_awaitable, ec)),
-
-                *m_data.m_timeout_timer);
-
-            if (!expected.has_value())
-                co_return exceptions::make_unexpected("Operation timed out");
-        } else {
-            co_await boost::beast::http::async_read_header(
-                m_socket,
-
-                m_data.m_buffer,
-
-                hdr_parser,
-
-                boost::asio::redirect_error(boost::asio::use_awaitable, ec));
-        }
-
         const auto& native_handle = m_socket.native_handle();
 
-        if (close_connection(ec, native_handle))
-            co_return exceptions::make_unexpected("Connection closed");
-
-        const auto& hdr_data = hdr_parser.get();
+        auto* tracer = m_server.tracer();
 
-        if (boost::beast::websocket::is_upgrade(hdr_data)) {
-            CLUEAPI_LOG_WARNING(
-                "WebSocket upgrade requested (id: {}): {}",
+        // An idle connection waits without a buffer, it borrows one once the request arrives. The
+        // trace starts with the first byte too, the keep-alive idle time is not a phase
+        if ((tracer || m_data.m_buffer_pool) && m_data.m_buffer.size() == 0u) {
+            if (m_data.m_timeout) {
+                auto expected =
+                    co_await exec_with_timeout(wait_readable(m_socket, ec), m_data.m_timeout);
 
-                native_handle,
-                hdr_data.target());
+                if (!expected.has_value())
+                    co_return exceptions::make_unexpected("Operation timed out");
+            } else
+                co_await wait_readable(m_socket, ec);
 
-            co_return exceptions::make_unexpected("WebSocket upgrade requested");
+            if (close_connection(ec, native_handle))
+                co_return exceptions::make_unexpected("Connection closed");
         }
 
-        {
-            m_data.m_request.uri() = hdr_data.target();
+        m_data.borrow_buffer();
 
-            m_data.m_request.method() = http::types::method_t::from_str(hdr_data.method_string());
+        if (tracer) {
+            m_data.m_trace.reset(shared::trace_clock_t::now());
 
-            for (const auto& field : hdr_data)
-                m_data.m_request.headers().emplace(field.name_string(), field.value());
+            m_data.m_request->trace() = &m_data.m_trace;
         }
 
-        CLUEAPI_LOG_DEBUG(
-            "Handle request (id: {}): uri: {}, method: {}",
-
-            native_handle,
-            m_data.m_request.uri(),
-            http::types::method_t::to_str(m_data.m_request.method()));
-
-        auto& hdrs = m_data.m_request.headers();
+        {
+            const shared::trace_t::scope_t scope{
+                m_data.m_request->trace(), shared::trace_phase_t::read_header};
 
-        if (auto content_type_it = hdrs.find("Content-Type"); content_type_it != hdrs.end()) {
-            auto content_type = content_type_it->second;
+            if (m_data.m_timeout) {
+                auto expected = co_await exec_with_timeout(
+                    boost::beast::http::async_read_header(
+                        m_socket,
 
-            if (boost::algorithm::istarts_with(content_type, "multipart/form-data")) {
-                auto boundary = shared::non_copy::extract_str(content_type, "boundary");
+                        m_data.m_buffer,
 
-                if (boundary.empty())
-                    co_return exceptions::expected_t<e_error_code>{e_error_code::bad_request};
+                        hdr_parser,
 
-                auto content_length_it = hdrs.find("Content-Length");
+                        boost::asio::redirect_error(boost::asio::use_awaitable, ec)),
 
-                if (content_length_it == hdrs.end())
-                    co_return exceptions::expected_t<e_error_code>{e_error_code::bad_request};
+                    m_data.m_timeout);
 
-                const auto content_length = std::stoull(content_length_it->second);
+                if (!expected.has_value())
+                    co_return exceptions::make_unexpected("Operation timed out");
+            } else {
+                co_await boost::beast::http::async_read_header(
+                    m_socket,
 
-                if (content_length > m_cfg.m_http.m_max_request_size)
-                    co_return exceptions::expected_t<e_error_code>{e_error_code::payload_too_large};
+                    m_data.m_buffer,
 
-                auto tmp_file =
-                    m_cfg.m_server.m_tmp_dir / boost::filesystem::unique_path("tmp-%%%%-%%%%");
+                    hdr_parser,
 
-                co_return co_await stream_handle(std::move(tmp_file), content_length);
+                    boost::asio::redirect_error(boost::asio::use_awaitable, ec));
             }
         }
 
-        co_return co_await raw_handle(std::move(hdr_parser));
-    }
-
-    exceptions::expected_awaitable_t<e_error_code> req_handler_t::stream_handle(
-        boost::filesystem::path path,
-        std::size_t content_length) {
-        const auto& executor = co_await boost::asio::this_coro::executor;
-
-        boost::asio::stream_file file(executor);
+        if (close_connection(ec, native_handle))
+            co_return exceptions::make_unexpected("Connection closed");
 
-        try {
-            boost::system::error_code ec{};
+        const auto& hdr_data = hdr_parser.get();
 
-            const auto flags =
-                boost::asio::stream_file::write_only | boost::asio::stream_file::create;
+        {
+            m_data.m_version = hdr_data.version();
 
-            file.open(path.string(), flags, ec);
+            m_data.m_request->uri() = hdr_data.target();
 
-            if (ec) {
-                CLUEAPI_LOG_ERROR("Failed to open file for streaming: {}", ec.message());
+            m_data.m_request->method() =
+                http::types::method_t::from_str(hdr_data.method_string());
 
-                co_return exceptions::expected_t<e_error_code>{e_error_code::internal_server_error};
+            // Only the flat storage is filled, the owning map is built if a handler asks for it
+            for (const auto& field : hdr_data) {
+                m_data.m_request->add_header(
+                    field.name_string(), field.value(), to_known_header(field.name()));
             }
+        }
 
-            auto remaining = content_length;
-
-            while (remaining > 0) {
-                if (m_data.m_buffer.size()) {
-                    auto sequence = m_data.m_buffer.data();
+        // The client handler answers it, and hands the connection to the WebSocket route
+        if (boost::beast::websocket::is_upgrade(hdr_data)) {
+            CLUEAPI_LOG_DEBUG(
+                "WebSocket upgrade requested (id: {}): {}",
 
-                    auto to_write = std::min(boost::asio::buffer_size(sequence), remaining);
+                native_handle,
+                hdr_data.target());
 
-                    auto written = co_await boost::asio::async_write(
-                        file, boost::asio::buffer(sequence, to_write), boost::asio::use_awaitable);
+            co_return exceptions::expected_t<e_error_code>{e_error_code::switching_protocols};
+        }
 
-                    if (written != to_write) {
-                        CLUEAPI_LOG_ERROR(
-                            "Failed to write to file for streaming (id: {}): {}",
+        CLUEAPI_LOG_DEBUG(
+            "Handle request (id: {}): uri: {}, method: {}",
 
-                            m_socket.native_handle(),
-                            ec.message());
+            native_handle,
+            m_data.m_request->uri(),
+            http::types::method_t::to_str(m_data.m_request->method()));
 
-                        co_return exceptions::expected_t<e_error_code>{
-                            e_error_code::internal_server_error};
-                    }
+        const auto& request = *m_data.m_request;
 
-                    m_data.m_buffer.consume(written);
+        if (tracer)
+            tracer->begin(m_data.m_trace, request.header("traceparent"));
 
-                    remaining -= written;
+        if (!hdr_parser.is_done() &&
+            m_server.clueapi().body_mode(request.method(), request.uri()) ==
+                route::e_body_mode::streamed)
+            co_return body_stream_handle(std::move(hdr_parser));
 
-                    continue;
-                }
+        if (auto content_type_header = request.header(http::types::e_header::content_type);
+            content_type_header.has_value()) {
+            auto content_type = content_type_header.value();
 
-                std::size_t read{};
+            if (boost::algorithm::istarts_with(content_type, "multipart/form-data")) {
+                auto boundary = shared::non_copy::extract_str(content_type, "boundary");
 
-                if (m_data.m_timeout_timer) {
-                    auto expected = co_await exec_with_timeout(
-                        m_socket.async_read_some(
-                            m_data.m_buffer.prepare(m_cfg.m_http.m_chunk_size),
+                if (boundary.empty())
+                    co_return exceptions::expected_t<e_error_code>{e_error_code::bad_request};
 
-                            boost::asio::redirect_error(boost::asio::use_awaitable, ec)),
+                if (auto content_length_header =
+                        request.header(http::types::e_header::content_length);
+                    content_length_header.has_value()) {
+                    const auto value = content_length_header.value();
 
-                        *m_data.m_timeout_timer);
+                    std::uint64_t content_length{};
 
-                    if (!expected.has_value())
-                        co_return exceptions::make_unexpected("Operation timed out");
+                    auto [ptr, ec] =
+                        std::from_chars(value.data(), value.data() + value.size(), content_length);
 
-                    read = expected.value();
-                } else {
-                    read = co_await m_socket.async_read_some(
-                        m_data.m_buffer.prepare(m_cfg.m_http.m_chunk_size),
+                    if (ec != std::errc{} || ptr != value.data() + value.size())
+                        co_return exceptions::expected_t<e_error_code>{e_error_code::bad_request};
 
-                        boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+                    if (content_length > m_cfg.m_http.m_max_request_size)
+                        co_return exceptions::expected_t<e_error_code>{
+                            e_error_code::payload_too_large};
                 }
 
-                if (read == 0)
-                    co_return exceptions::expected_t<e_error_code>{e_error_code::bad_request};
-
-                m_data.m_buffer.commit(read);
+                // Parsed by the handler's context while it is read, so it is never spooled
+                if (!hdr_parser.is_done())
+                    co_return body_stream_handle(std::move(hdr_parser));
             }
-        } catch (const std::exception& e) {
-            CLUEAPI_LOG_ERROR("Exception in stream handler: {}", e.what());
+        }
 
-            file.close();
+        co_return co_await raw_handle(std::move(hdr_parser));
+    }
 
-            co_return exceptions::expected_t<e_error_code>{e_error_code::internal_server_error};
-        }
+    e_error_code req_handler_t::body_stream_handle(
+        request_parser_t<boost::beast::http::empty_body>&& hdr_parser) {
+        try {
+            m_data.m_body_stream =
+                std::make_shared<socket_body_stream_t>(std::move(hdr_parser), m_cfg, m_data);
+        } catch (const std::exception& e) {
+            CLUEAPI_LOG_ERROR("Failed to create body stream: {}", e.what());
 
-        file.close();
+            return e_error_code::internal_server_error;
+        }
 
-        m_data.m_request.parse_path() = std::move(path);
+        m_data.m_request->body_stream() = m_data.m_body_stream;
 
-        co_return exceptions::expected_t<e_error_code>{e_error_code::success};
+        return e_error_code::success;
     }
 
     exceptions::expected_awaitable_t<e_error_code> req_handler_t::raw_handle(
-        boost::beast::http::request_parser<boost::beast::http::empty_body>&& hdr_parser) {
+        request_parser_t<boost::beast::http::empty_body>&& hdr_parser) {
         bool has_body{};
 
         std::size_t content_length{};
@@ -235,15 +286,22 @@ namespace clueapi::server::client::detail {
             has_body = content_length > 0;
         }
 
-        boost::beast::http::request_parser<boost::beast::http::string_body> parser{
-            std::move(hdr_parser)};
+        request_parser_t<boost::beast::http::string_body> parser{std::move(hdr_parser)};
 
         parser.body_limit(m_cfg.m_http.m_max_request_size);
 
         if (has_body) {
+            const shared::trace_t::scope_t scope{
+                m_data.m_request->trace(), shared::trace_phase_t::read_body};
+
+            // Reads into the buffer the recycled request kept from the previous one
+            parser.get().body() = std::move(m_data.m_request->body());
+
+            parser.get().body().clear();
+
             boost::system::error_code ec{};
 
-            if (m_data.m_timeout_timer) {
+            if (m_data.m_timeout) {
                 auto expected = co_await exec_with_timeout(
                     boost::beast::http::async_read(
                         m_socket,
@@ -252,7 +310,7 @@ namespace clueapi::server::client::detail {
                         parser,
                         boost::asio::redirect_error(boost::asio::use_awaitable, ec)),
 
-                    *m_data.m_timeout_timer);
+                    m_data.m_timeout);
 
                 if (!expected.has_value())
                     co_return exceptions::make_unexpected("Operation timed out");
@@ -277,14 +335,12 @@ namespace clueapi::server::client::detail {
                 co_return exceptions::expected_t<e_error_code>{e_error_code::bad_request};
             }
 
-            m_data.m_beast_request = parser.release();
-
-            const auto& body = m_data.m_beast_request.body();
+            auto& body = parser.get().body();
 
             if (content_length > 0 && body.size() != content_length)
                 co_return exceptions::expected_t<e_error_code>{e_error_code::bad_request};
 
-            m_data.m_request.body() = std::move(std::move(m_data.m_beast_request).body());
+            m_data.m_request->body() = std::move(body);
         }
 
         co_return exceptions::expected_t<e_error_code>{e_error_code::success};
@@ -11,22 +11,26 @@
 
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/beast/http/empty_body.hpp>
-#include <boost/beast/http/parser.hpp>
-#include <boost/filesystem/path.hpp>
 
 #include "clueapi/exceptions/wrap/wrap.hxx"
 
 #include "clueapi/shared/macros.hxx"
 
+#include "clueapi/server/client/detail/types/types.hxx"
+
 // Forward declarations
 namespace clueapi {
     namespace cfg {
         struct cfg_t;
     }
 
-    namespace server::client::detail {
-        struct data_t;
-    }
+    namespace server {
+        class c_server;
+
+        namespace client::detail {
+            struct data_t;
+        }
+    } // namespace server
 } // namespace clueapi
 
 namespace clueapi::server::client::detail {
@@ -36,8 +40,11 @@ namespace clueapi::server::client::detail {
      * @note These error codes are used to return the appropriate HTTP status code.
      */
     enum struct e_error_code : std::uint16_t {
+        switching_protocols = 101,
         success = 200,
         bad_request = 400,
+        forbidden = 403,
+        not_found = 404,
         timeout = 408,
         payload_too_large = 413,
         internal_server_error = 500
@@ -54,13 +61,17 @@ namespace clueapi::server::client::detail {
         /**
          * @brief Constructs a new request handler.
          *
+         * @param server The server instance.
          * @param socket The socket of the client.
          * @param cfg The configuration settings.
          * @param data The data of the client.
          */
         CLUEAPI_INLINE req_handler_t(
-            boost::asio::ip::tcp::socket& socket, const cfg::cfg_t& cfg, data_t& data)
-            : m_socket{socket}, m_cfg{cfg}, m_data{data} {
+            server::c_server& server,
+            boost::asio::ip::tcp::socket& socket,
+            const cfg::cfg_t& cfg,
+            data_t& data)
+            : m_server{server}, m_socket{socket}, m_cfg{cfg}, m_data{data} {
         }
 
        public:
@@ -78,17 +89,25 @@ namespace clueapi::server::client::detail {
          * @return The error code of the request.
          */
         exceptions::expected_awaitable_t<e_error_code> raw_handle(
-            boost::beast::http::request_parser<boost::beast::http::empty_body>&& hdr_parser);
+            request_parser_t<boost::beast::http::empty_body>&& hdr_parser);
 
         /**
-         * @brief Handles the stream request of the client.
+         * @brief Hands the body of the request to the handler as a stream, unread.
+         *
+         * @details Used for the routes that read their body themselves and for multipart bodies,
+         * which the handler's context parses as they are read.
          *
          * @return The error code of the request.
          */
-        exceptions::expected_awaitable_t<e_error_code> stream_handle(
-            boost::filesystem::path path, std::size_t content_length);
+        e_error_code body_stream_handle(
+            request_parser_t<boost::beast::http::empty_body>&& hdr_parser);
 
        private:
+        /**
+         * @brief The server instance.
+         */
+        server::c_server& m_server;
+
         /**
          * @brief The socket of the client.
          */
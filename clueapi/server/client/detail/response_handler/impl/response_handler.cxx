@@ -6,22 +6,172 @@
 
 #include "clueapi/server/client/detail/response_handler/response_handler.hxx"
 
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/sendfile.h>
+#include <unistd.h>
+#endif
+
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/beast/core/buffers_range.hpp>
 #include <boost/beast/http/serializer.hpp>
 #include <boost/beast/http/write.hpp>
 #include <boost/beast.hpp>
 
 #include "clueapi/http/chunks/chunks.hxx"
+#include "clueapi/http/range/range.hxx"
 #include "clueapi/http/types/response/response.hxx"
 #include "clueapi/http/types/status/status.hxx"
 
 #include "clueapi/modules/macros.hxx"
 
+#include "clueapi/shared/date_cache/date_cache.hxx"
+#include "clueapi/shared/json_writer/json_writer.hxx"
+
 #include "clueapi/server/server.hxx"
 
 #include "clueapi/server/client/detail/data/data.hxx"
 #include "clueapi/server/client/detail/detail.hxx"
 
 namespace clueapi::server::client::detail {
+    namespace {
+        /**
+         * @brief The JSON body of an error response.
+         */
+        struct error_body_t {
+            std::string_view m_error;
+
+            std::string_view m_detail;
+
+            static constexpr auto k_json_fields = shared::json_fields(
+                shared::json_field("error", &error_body_t::m_error),
+                shared::json_field("detail", &error_body_t::m_detail));
+        };
+
+        /**
+         * @brief Serializes the start line and the fields of a response.
+         *
+         * @tparam _body_t The body type of the response.
+         *
+         * @param response The response to serialize.
+         *
+         * @return The serialized header block.
+         */
+        template <typename _body_t>
+        std::string serialize_header(response_t<_body_t>& response) {
+            std::string ret{};
+
+            boost::beast::http::serializer<false, _body_t, fields_t> sr{response};
+
+            sr.split(true);
+
+            boost::system::error_code ec{};
+
+            while (!ec && !sr.is_header_done()) {
+                sr.next(ec, [&sr, &ret](boost::system::error_code&, const auto& buffers) {
+                    std::size_t size{};
+
+                    for (const auto buffer : boost::beast::buffers_range_ref(buffers)) {
+                        ret.append(static_cast<const char*>(buffer.data()), buffer.size());
+
+                        size += buffer.size();
+                    }
+
+                    sr.consume(size);
+                });
+            }
+
+            return ret;
+        }
+
+        /**
+         * @brief The line terminator of HTTP.
+         */
+        constexpr std::string_view k_crlf{"\r\n"};
+
+        /**
+         * @brief Checks if a header of a response is written by the server itself.
+         *
+         * @param name The name of the header.
+         *
+         * @return `true` for `Content-Length`, `Connection` and `Keep-Alive`.
+         */
+        bool is_reserved_field(std::string_view name) noexcept {
+            return boost::beast::iequals(name, "Content-Length") ||
+                   boost::beast::iequals(name, "Connection") ||
+                   boost::beast::iequals(name, "Keep-Alive");
+        }
+
+        /**
+         * @brief Checks if a status is sent without a body and its length (1xx, 204 and 304).
+         *
+         * @param status The status of the response.
+         *
+         * @return `true` if the response has no body, `false` otherwise.
+         */
+        constexpr bool is_bodiless(std::uint32_t status) noexcept {
+            return (status >= 100u && status < 200u) || status == 204u || status == 304u;
+        }
+
+#if defined(__linux__)
+        /**
+         * @struct file_descriptor_t
+         *
+         * @brief Closes a file descriptor when it goes out of scope.
+         */
+        struct file_descriptor_t {
+            CLUEAPI_INLINE explicit file_descriptor_t(int fd) noexcept : m_fd{fd} {
+            }
+
+            CLUEAPI_INLINE ~file_descriptor_t() noexcept {
+                if (m_fd >= 0)
+                    ::close(m_fd);
+            }
+
+            // Copy constructor
+            file_descriptor_t(const file_descriptor_t&) = delete;
+
+            // Copy assignment operator
+            file_descriptor_t& operator=(const file_descriptor_t&) = delete;
+
+            /**
+             * @brief The file descriptor, negative if the file could not be opened.
+             */
+            int m_fd;
+        };
+
+        /**
+         * @brief Waits until a socket can be written to.
+         *
+         * @param socket The socket.
+         * @param ec The error code of the wait.
+         *
+         * @return An awaitable that resolves to `true` once the wait is over.
+         */
+        shared::awaitable_t<bool> wait_writable(
+            boost::asio::ip::tcp::socket& socket, boost::system::error_code& ec) {
+            co_await socket.async_wait(
+                boost::asio::ip::tcp::socket::wait_write,
+
+                boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+
+            co_return true;
+        }
+#endif
+    } // namespace
+
     exceptions::expected_awaitable_t<void> response_handler_t::handle() {
         m_data.m_response_data.reset();
 
@@ -29,7 +179,7 @@ namespace clueapi::server::client::detail {
             m_data.m_response_data.status() = http::types::status_t::unknown;
 
             if (m_server.middleware_chain()) {
-                m_data.m_response_data = co_await m_server.middleware_chain()(m_data.m_request);
+                m_data.m_response_data = co_await run_handler();
             } else
                 CLUEAPI_LOG_ERROR("Middleware chain is not initialized");
 
@@ -42,61 +192,272 @@ namespace clueapi::server::client::detail {
             }
         }
 
+        co_return co_await send();
+    }
+
+    exceptions::expected_awaitable_t<void> response_handler_t::send() {
+        const shared::trace_t::scope_t scope{
+            m_data.request_info().m_trace, shared::trace_phase_t::write};
+
+        // The connection can only be reused once the unread part of a streamed body is consumed
+        if (m_data.m_body_stream && !m_data.m_body_stream->is_done())
+            co_await drain_body();
+
+#if defined(__linux__)
+        if (m_data.m_response_data.file().has_value())
+            co_return co_await file_handle();
+#endif
+
         if (m_data.m_response_data.is_stream())
             co_return co_await stream_handle();
 
         co_return co_await raw_handle();
     }
 
+    shared::awaitable_t<http::types::response_t> response_handler_t::run_handler() {
+        // The handler may move from the request, the connection keeps what it reads afterwards
+        m_data.capture_request();
+
+        if (m_data.m_pending_writes.empty())
+            co_return co_await m_server.middleware_chain()(*m_data.m_request);
+
+        // One timer per connection, armed only while responses are queued
+        if (!m_data.m_write_behind)
+            m_data.m_write_behind.emplace(m_socket.get_executor());
+
+        auto& timer = *m_data.m_write_behind;
+
+        timer.expires_after(k_max_pipelined_delay);
+
+        m_data.m_is_write_behind_armed = true;
+
+        // The wait may complete after this handler is gone, it only refers to the connection
+        timer.async_wait([&server = m_server, &socket = m_socket, &cfg = m_cfg, &data = m_data](
+                             const boost::system::error_code& ec) {
+            // The handler may be done while the wait completes
+            if (ec || !data.m_is_write_behind_armed)
+                return;
+
+            data.m_is_write_behind_armed = false;
+
+            // A body still read by the handler shares the deadline of the connection
+            if (data.m_body_stream && !data.m_body_stream->is_done())
+                return;
+
+            data.m_is_writing_behind = true;
+
+            boost::asio::co_spawn(
+                socket.get_executor(),
+
+                [&server, &socket, &cfg, &data]() -> shared::awaitable_t<void> {
+                    co_await response_handler_t{server, socket, cfg, data}.flush();
+
+                    data.m_is_writing_behind = false;
+
+                    if (data.m_write_behind)
+                        data.m_write_behind->cancel();
+                },
+
+                boost::asio::detached);
+        });
+
+        http::types::response_t response{};
+
+        std::exception_ptr error{};
+
+        try {
+            response = co_await m_server.middleware_chain()(*m_data.m_request);
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        m_data.m_is_write_behind_armed = false;
+
+        timer.cancel();
+
+        // The response is queued after the ones being written, not while they are
+        if (m_data.m_is_writing_behind) {
+            boost::system::error_code ec{};
+
+            timer.expires_at(boost::asio::steady_timer::time_point::max());
+
+            co_await timer.async_wait(boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+        }
+
+        if (error)
+            std::rethrow_exception(error);
+
+        co_return response;
+    }
+
     exceptions::expected_awaitable_t<void> response_handler_t::raw_handle() {
-        boost::beast::http::response<boost::beast::http::string_body> response{};
+        auto& output = m_data.m_output;
 
-        const auto version = m_data.m_beast_request.version();
+        const auto header_begin = output.size();
 
-        prepare_response(response, version);
+        data_t::pending_write_t pending{
+            0u,
+            std::move(m_data.m_response_data).move_body(),
+            std::move(m_data.m_response_data.shared_body())};
 
         {
-            response.body() = std::move(m_data.m_response_data).move_body();
+            const auto status = m_data.m_response_data.status();
 
-            response.result(m_data.m_response_data.status());
+            const auto version = m_data.m_version;
+
+            fmt::format_to(
+                std::back_inserter(output),
+
+                FMT_COMPILE("HTTP/{}.{} {} {}\r\n"),
+
+                version / 10u,
+                version % 10u,
+                static_cast<std::uint32_t>(status),
+                boost::beast::http::obsolete_reason(
+                    static_cast<boost::beast::http::status>(status)));
+
+            const auto& headers = m_data.m_response_data.headers();
+
+            for (const auto& [key, value] : headers) {
+                // Framing and connection management belong to the server
+                if (is_reserved_field(key))
+                    continue;
+
+                output.append(key).append(": ").append(value).append(k_crlf);
+            }
+
+            for (const auto& cookie : m_data.m_response_data.cookies())
+                output.append("Set-Cookie: ").append(cookie).append(k_crlf);
+
+            output.append(
+                update_keep_alive() ? m_server.keep_alive_block() : m_server.close_block());
+
+            if (!headers.contains("Date"))
+                output.append("Date: ").append(shared::date_cache_t::now()).append(k_crlf);
+
+            if (is_bodiless(status))
+                pending = {};
+            else
+                fmt::format_to(
+                    std::back_inserter(output),
+                    FMT_COMPILE("Content-Length: {}\r\n"),
+                    pending.view().size());
+
+            output.append(k_crlf);
+
+            if (m_data.request_info().m_preconditions.m_method == http::types::method_t::head)
+                pending = {};
         }
 
-        response.prepare_payload();
+        pending.m_header_end = output.size();
+
+        m_data.m_sent_status = static_cast<std::uint16_t>(m_data.m_response_data.status());
+
+        m_data.m_sent_bytes = pending.view().size();
+
+        m_data.m_pending_bytes += output.size() - header_begin + pending.view().size();
+
+        m_data.m_pending_writes.emplace_back(std::move(pending));
+
+        // Responses to pipelined requests are committed in order and gathered into one write
+        const auto can_defer = !m_data.m_should_close &&
+                               m_data.m_pending_writes.size() < k_max_pipelined_responses &&
+                               m_data.m_pending_bytes < k_max_pipelined_bytes &&
+                               has_pipelined_request();
+
+        if (can_defer)
+            co_return exceptions::expected_t<void>{};
+
+        co_return co_await flush();
+    }
+
+    exceptions::expected_awaitable_t<void> response_handler_t::flush() {
+        if (m_data.m_pending_writes.empty())
+            co_return exceptions::expected_t<void>{};
+
+        std::vector<boost::asio::const_buffer> buffers{};
+
+        buffers.reserve(m_data.m_pending_writes.size() * 2u);
+
+        {
+            std::size_t header_begin{};
+
+            for (const auto& pending : m_data.m_pending_writes) {
+                buffers.emplace_back(
+                    m_data.m_output.data() + header_begin, pending.m_header_end - header_begin);
+
+                if (const auto body = pending.view(); !body.empty())
+                    buffers.emplace_back(body.data(), body.size());
+
+                header_begin = pending.m_header_end;
+            }
+        }
 
         boost::system::error_code ec{};
 
-        if (m_data.m_timeout_timer) {
+        if (m_data.m_timeout) {
             auto expected = co_await exec_with_timeout(
-                boost::beast::http::async_write(
+                boost::asio::async_write(
                     m_socket,
 
-                    response,
+                    buffers,
 
                     boost::asio::redirect_error(boost::asio::use_awaitable, ec)),
 
-                *m_data.m_timeout_timer);
+                m_data.m_timeout);
+
+            if (!expected.has_value()) {
+                m_data.m_pending_writes.clear();
+
+                m_data.m_output.clear();
+
+                m_data.m_pending_bytes = 0;
 
-            if (!expected.has_value())
                 co_return exceptions::make_unexpected("Operation timed out");
+            }
         } else {
-            co_await boost::beast::http::async_write(
+            co_await boost::asio::async_write(
                 m_socket,
 
-                response,
+                buffers,
 
                 boost::asio::redirect_error(boost::asio::use_awaitable, ec));
         }
 
+        CLUEAPI_LOG_TRACE(
+            "Flushed {} response(s) in one write (id: {})",
+
+            m_data.m_pending_writes.size(),
+            m_socket.native_handle());
+
+        m_data.m_pending_writes.clear();
+
+        m_data.m_output.clear();
+
+        m_data.m_pending_bytes = 0;
+
         if (close_connection(ec, m_socket.native_handle()))
             co_return exceptions::make_unexpected("Connection closed");
 
         co_return exceptions::expected_t<void>{};
     }
 
+    bool response_handler_t::has_pipelined_request() const noexcept {
+        const auto buffered = m_data.m_buffer.data();
+
+        const std::string_view view{static_cast<const char*>(buffered.data()), buffered.size()};
+
+        return view.find("\r\n\r\n") != std::string_view::npos;
+    }
+
     exceptions::expected_awaitable_t<void> response_handler_t::stream_handle() {
-        boost::beast::http::response<boost::beast::http::empty_body> response{};
+        if (auto flushed = co_await flush(); !flushed.has_value())
+            co_return flushed;
+
+        auto response =
+            make_in_arena<response_t<boost::beast::http::empty_body>>(*m_data.m_arena);
 
-        const auto version = m_data.m_beast_request.version();
+        const auto version = m_data.m_version;
 
         prepare_response(response, version);
 
@@ -106,16 +467,20 @@ namespace clueapi::server::client::detail {
             response.result(m_data.m_response_data.status());
         }
 
-        boost::beast::http::serializer<false, boost::beast::http::empty_body> sr{response};
+        // The size of a streamed body isn't known up front
+        m_data.m_sent_status = static_cast<std::uint16_t>(m_data.m_response_data.status());
+
+        boost::beast::http::serializer<false, boost::beast::http::empty_body, fields_t> sr{
+            response};
 
         boost::system::error_code ec{};
 
-        if (m_data.m_timeout_timer) {
+        if (m_data.m_timeout) {
             auto expected = co_await exec_with_timeout(
                 boost::beast::http::async_write_header(
                     m_socket, sr, boost::asio::redirect_error(boost::asio::use_awaitable, ec)),
 
-                *m_data.m_timeout_timer);
+                m_data.m_timeout);
         } else {
             co_await boost::beast::http::async_write_header(
                 m_socket, sr, boost::asio::redirect_error(boost::asio::use_awaitable, ec));
@@ -159,9 +524,211 @@ namespace clueapi::server::client::detail {
         co_return exceptions::expected_t<void>{};
     }
 
+#if defined(__linux__)
+    exceptions::expected_awaitable_t<void> response_handler_t::file_handle() {
+        if (auto flushed = co_await flush(); !flushed.has_value())
+            co_return flushed;
+
+        const auto& file = *m_data.m_response_data.file();
+
+        auto response =
+            make_in_arena<response_t<boost::beast::http::empty_body>>(*m_data.m_arena);
+
+        const auto version = m_data.m_version;
+
+        prepare_response(response, version);
+
+        const auto& preconditions = m_data.request_info().m_preconditions;
+
+        const auto method = preconditions.m_method;
+
+        std::string_view etag{};
+
+        if (auto it = m_data.m_response_data.headers().find("ETag");
+            it != m_data.m_response_data.headers().end())
+            etag = it->second;
+
+        http::range::selection_t selection{
+            .m_range = {0, file.m_size > 0 ? file.m_size - 1 : 0}, .m_length = file.m_size};
+
+        response.set(boost::beast::http::field::accept_ranges, "bytes");
+
+        // Preconditions only apply to the representation itself, not to error responses
+        if (m_data.m_response_data.status() == http::types::status_t::ok) {
+            selection = http::range::range_t::select(preconditions, etag, file.m_size);
+
+            response.result(static_cast<boost::beast::http::status>(selection.m_status));
+        }
+
+        const auto& range = selection.m_range;
+
+        const auto length = selection.m_length;
+
+        if (selection.m_status == 304u)
+            response.erase(boost::beast::http::field::content_length);
+        else if (selection.m_status == 206u)
+            response.set(
+                boost::beast::http::field::content_range,
+
+                fmt::format("bytes {}-{}/{}", range.m_first, range.m_last, file.m_size));
+        else if (selection.m_status == 416u)
+            response.set(
+                boost::beast::http::field::content_range,
+
+                fmt::format("bytes */{}", file.m_size));
+
+        if (response.result() != boost::beast::http::status::not_modified)
+            response.content_length(length);
+
+        const auto header = serialize_header(response);
+
+        m_data.m_sent_status = static_cast<std::uint16_t>(response.result_int());
+
+        m_data.m_sent_bytes =
+            method == http::types::method_t::head || selection.m_status == 304u ? 0u : length;
+
+        boost::system::error_code ec{};
+
+        if (m_data.m_timeout) {
+            auto expected = co_await exec_with_timeout(
+                boost::asio::async_write(
+                    m_socket,
+
+                    boost::asio::buffer(header),
+
+                    boost::asio::redirect_error(boost::asio::use_awaitable, ec)),
+
+                m_data.m_timeout);
+
+            if (!expected.has_value())
+                co_return exceptions::make_unexpected("Operation timed out");
+        } else {
+            co_await boost::asio::async_write(
+                m_socket,
+
+                boost::asio::buffer(header),
+
+                boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+        }
+
+        if (close_connection(ec, m_socket.native_handle()))
+            co_return exceptions::make_unexpected("Connection closed");
+
+        if (ec) {
+            CLUEAPI_LOG_ERROR(
+                "Error writing response header (id: {}): {}",
+
+                m_socket.native_handle(),
+                ec.message());
+
+            co_return exceptions::make_unexpected("Failed to write response header");
+        }
+
+        if (method == http::types::method_t::head || length == 0)
+            co_return exceptions::expected_t<void>{};
+
+        co_return co_await send_file(file.m_path, range.m_first, length);
+    }
+
+    exceptions::expected_awaitable_t<void> response_handler_t::send_file(
+        const boost::filesystem::path& path, std::uint64_t offset, std::uint64_t length) {
+        const file_descriptor_t file{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+
+        const auto native_handle = m_socket.native_handle();
+
+        if (file.m_fd < 0) {
+            CLUEAPI_LOG_ERROR(
+                "Error opening file (id: {}): {}", native_handle, std::strerror(errno));
+
+            // The header is already written, the client can only tell from the connection
+            m_data.m_should_close = true;
+
+            co_return exceptions::make_unexpected("Failed to open file");
+        }
+
+        boost::system::error_code ec{};
+
+        m_socket.native_non_blocking(true, ec);
+
+        if (ec)
+            co_return exceptions::make_unexpected(ec.message());
+
+        auto file_offset = static_cast<off_t>(offset);
+
+        auto remaining = length;
+
+        while (remaining > 0) {
+            const auto count = static_cast<std::size_t>(
+                std::min<std::uint64_t>(remaining, k_max_sendfile_bytes));
+
+            const auto sent = ::sendfile(native_handle, file.m_fd, &file_offset, count);
+
+            if (sent > 0) {
+                remaining -= static_cast<std::uint64_t>(sent);
+
+                continue;
+            }
+
+            if (sent == 0) {
+                CLUEAPI_LOG_ERROR("File was truncated while sending (id: {})", native_handle);
+
+                m_data.m_should_close = true;
+
+                co_return exceptions::make_unexpected("File was truncated");
+            }
+
+            if (errno == EINTR)
+                continue;
+
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                CLUEAPI_LOG_TRACE(
+                    "Error sending file (id: {}): {}", native_handle, std::strerror(errno));
+
+                co_return exceptions::make_unexpected("Connection closed");
+            }
+
+            // The socket buffer is full, wait for the client to catch up
+            if (m_data.m_timeout) {
+                // Slow downloads stay alive as long as the client keeps reading
+                if (m_cfg.m_socket.m_timeout.count() > 0)
+                    m_data.m_timeout.expires_after(m_cfg.m_socket.m_timeout);
+
+                auto expected =
+                    co_await exec_with_timeout(wait_writable(m_socket, ec), m_data.m_timeout);
+
+                if (!expected.has_value())
+                    co_return exceptions::make_unexpected("Operation timed out");
+            } else
+                co_await wait_writable(m_socket, ec);
+
+            if (close_connection(ec, native_handle) || ec)
+                co_return exceptions::make_unexpected("Connection closed");
+        }
+
+        co_return exceptions::expected_t<void>{};
+    }
+#endif
+
+    shared::awaitable_t<void> response_handler_t::drain_body() {
+        auto& stream = *m_data.m_body_stream;
+
+        const auto limit = stream.bytes_read() + k_max_drained_bytes;
+
+        while (!stream.is_done() && stream.bytes_read() < limit) {
+            auto chunk = co_await stream.read_chunk();
+
+            if (!chunk.has_value() || chunk->empty())
+                break;
+        }
+
+        if (!stream.is_done())
+            CLUEAPI_LOG_TRACE(
+                "Unread request body left, closing connection (id: {})", m_socket.native_handle());
+    }
+
     template <typename _type_t>
     void response_handler_t::prepare_response(
-        boost::beast::http::response<_type_t>& response, std::uint32_t version) {
+        response_t<_type_t>& response, std::uint32_t version) {
         response.version(version);
 
         response.result(static_cast<boost::beast::http::status>(m_data.m_response_data.status()));
@@ -172,44 +739,61 @@ namespace clueapi::server::client::detail {
         for (const auto& cookie : m_data.m_response_data.cookies())
             response.insert("Set-Cookie", cookie);
 
-        const auto keep_alive = m_data.m_request.keep_alive();
+        if (!m_cfg.m_http.m_server_name.empty())
+            response.set(boost::beast::http::field::server, m_cfg.m_http.m_server_name);
 
-        if (keep_alive) {
+        if (response.find(boost::beast::http::field::date) == response.end())
+            response.set(boost::beast::http::field::date, shared::date_cache_t::now());
+
+        if (update_keep_alive()) {
             response.keep_alive(true);
 
             response.set(boost::beast::http::field::connection, "keep-alive");
             response.set(boost::beast::http::field::keep_alive, m_server.get_keep_alive_timeout());
-
-            m_data.m_should_close = false;
         } else {
             response.keep_alive(false);
             response.set(boost::beast::http::field::connection, "close");
-
-            m_data.m_should_close = true;
         }
     }
 
+    bool response_handler_t::update_keep_alive() noexcept {
+        const auto keep_alive = m_data.request_info().m_is_keep_alive &&
+                                (!m_data.m_body_stream || m_data.m_body_stream->is_done());
+
+        m_data.m_should_close = !keep_alive;
+
+        return keep_alive;
+    }
+
     shared::awaitable_t<void> response_handler_t::send_error_response(
         std::uint32_t status_code, std::string error_message) {
-        boost::beast::http::response<boost::beast::http::string_body> response{};
+        // Keeps the responses to previously pipelined requests in order
+        if (auto flushed = co_await flush(); !flushed.has_value())
+            co_return;
 
-        response.version(m_data.m_beast_request.version());
+        auto response =
+            make_in_arena<response_t<boost::beast::http::string_body>>(*m_data.m_arena);
+
+        response.version(m_data.m_version);
 
         response.result(static_cast<boost::beast::http::status>(status_code));
 
         if (m_cfg.m_http.m_def_response_class == http::types::e_response_class::plain) {
             response.body() = http::types::status_t::to_str(status_code);
         } else {
-            response.body() = http::types::json_t::serialize(http::types::json_t::json_obj_t{
-                {"error", http::types::status_t::to_str(status_code)},
-                {"detail", std::move(error_message)}});
+            response.body() = shared::json_writer_t::to_string(
+                error_body_t{http::types::status_t::to_str(status_code), error_message});
         }
 
         response.prepare_payload();
 
+        m_data.m_sent_status = static_cast<std::uint16_t>(status_code);
+
+        m_data.m_sent_bytes = response.body().size();
+
         boost::system::error_code ec{};
 
-        if (m_data.m_timeout_timer) {
+        if (m_data.m_timeout) {
             auto expected = co_await exec_with_timeout(
                 boost::beast::http::async_write(
                     m_socket,
@@ -218,7 +802,7 @@ namespace clueapi::server::client::detail {
 
                     boost::asio::redirect_error(boost::asio::use_awaitable, ec)),
 
-                *m_data.m_timeout_timer);
+                m_data.m_timeout);
         } else {
             co_await boost::beast::http::async_write(
                 m_socket,
@@ -7,17 +7,23 @@
 #ifndef CLUEAPI_SERVER_CLIENT_DETAIL_RESPONSE_HANDLER_HXX
 #define CLUEAPI_SERVER_CLIENT_DETAIL_RESPONSE_HANDLER_HXX
 
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <string>
 
 #include <boost/asio/ip/tcp.hpp>
-#include <boost/beast/http/message.hpp>
+#include <boost/filesystem/path.hpp>
 
 #include "clueapi/exceptions/wrap/wrap.hxx"
 
+#include "clueapi/http/types/response/response.hxx"
+
 #include "clueapi/shared/macros.hxx"
 #include "clueapi/shared/shared.hxx"
 
+#include "clueapi/server/client/detail/types/types.hxx"
+
 // Forward declarations
 namespace clueapi {
     namespace cfg {
@@ -67,6 +73,14 @@ namespace clueapi::server {
              */
             exceptions::expected_awaitable_t<void> handle();
 
+            /**
+             * @brief Sends the response already held in `data_t::m_response_data`, without
+             * running the handler.
+             *
+             * @return The expected result of the operation.
+             */
+            exceptions::expected_awaitable_t<void> send();
+
             /**
              * @brief Sends an error response to the client.
              *
@@ -76,11 +90,52 @@ namespace clueapi::server {
             shared::awaitable_t<void> send_error_response(
                 std::uint32_t status_code, std::string error_message);
 
+            /**
+             * @brief Writes all pending responses with a single gathered write.
+             *
+             * @return The expected result of the operation.
+             *
+             * @note Responses to pipelined requests are queued in `data_t::m_pending_writes`
+             * instead of being written one by one.
+             */
+            exceptions::expected_awaitable_t<void> flush();
+
+           public:
+            /**
+             * @brief The maximum number of responses queued before they are flushed.
+             */
+            static constexpr std::size_t k_max_pipelined_responses{16};
+
+            /**
+             * @brief The maximum number of bytes queued before the responses are flushed.
+             */
+            static constexpr std::size_t k_max_pipelined_bytes{256ull * 1024u};
+
+            /**
+             * @brief The longest the queued responses wait for the handler of the next pipelined
+             * request before they are written anyway.
+             */
+            static constexpr std::chrono::microseconds k_max_pipelined_delay{1000};
+
+            /**
+             * @brief The maximum number of unread body bytes drained to keep a connection alive.
+             */
+            static constexpr std::size_t k_max_drained_bytes{1024ull * 1024u};
+
+            /**
+             * @brief The maximum number of bytes handed to a single `sendfile(2)` call.
+             */
+            static constexpr std::size_t k_max_sendfile_bytes{1024ull * 1024u};
+
            private:
             /**
              * @brief Handles the body response of the client.
              *
              * @return The expected result of the operation.
+             *
+             * @details Writes the status line and the headers straight into the connection's
+             * output buffer, with the precomputed `Server`/`Connection` lines of the server and
+             * the cached `Date`. The body is queued as its own buffer and never copied.
              */
             exceptions::expected_awaitable_t<void> raw_handle();
 
@@ -91,7 +146,65 @@ namespace clueapi::server {
              */
             exceptions::expected_awaitable_t<void> stream_handle();
 
+            /**
+             * @brief Handles a file response with a fixed length, sent with `sendfile(2)`.
+             *
+             * @return The expected result of the operation.
+             *
+             * @details Answers `If-None-Match` with `304 Not Modified` and a single `Range` with
+             * `206 Partial Content` (or `416 Range Not Satisfiable`), unless `If-Range` names
+             * another version of the file.
+             */
+            exceptions::expected_awaitable_t<void> file_handle();
+
+            /**
+             * @brief Writes a range of a file to the socket without copying it to user space.
+             *
+             * @param path The path of the file.
+             * @param offset The position of the first byte.
+             * @param length The number of bytes.
+             *
+             * @return The expected result of the operation.
+             */
+            exceptions::expected_awaitable_t<void> send_file(
+                const boost::filesystem::path& path, std::uint64_t offset, std::uint64_t length);
+
            private:
+            /**
+             * @brief Runs the middleware chain and the handler of the request.
+             *
+             * @return The response of the handler.
+             *
+             * @details The responses queued for pipelined requests are written after
+             * `k_max_pipelined_delay` if the handler is still running, so that a slow handler
+             * doesn't hold up the responses of the requests before its own. The timer is the
+             * connection's `data_t::m_write_behind`, and nothing is written while the handler
+             * reads a streamed body, whose reads share the deadline of the writes.
+             */
+            shared::awaitable_t<http::types::response_t> run_handler();
+
+            /**
+             * @brief Reads and discards what the handler left unread of a streamed body.
+             *
+             * @note Gives up after `k_max_drained_bytes`, the connection is closed then.
+             */
+            shared::awaitable_t<void> drain_body();
+
+            /**
+             * @brief Checks if a complete request header is already buffered after the current
+             * request.
+             *
+             * @return `true` if the client pipelined another request, `false` otherwise.
+             */
+            [[nodiscard]] bool has_pipelined_request() const noexcept;
+
+            /**
+             * @brief Decides if the connection is kept alive after the current response.
+             *
+             * @return `true` if the connection is kept alive, `false` if it is closed.
+             */
+            bool update_keep_alive() noexcept;
+
             /**
              * @brief Prepares the response of the client.
              *
@@ -104,7 +217,7 @@ namespace clueapi::server {
              */
             template <typename _type_t>
             void prepare_response(
-                boost::beast::http::response<_type_t>& response, std::uint32_t version);
+                response_t<_type_t>& response, std::uint32_t version);
 
            private:
             /**
@@ -0,0 +1,147 @@
+/**
+ * @file timeout.hxx
+ *
+ * @brief Contains the timeout of a client connection.
+ */
+
+#ifndef CLUEAPI_SERVER_CLIENT_DETAIL_TIMEOUT_HXX
+#define CLUEAPI_SERVER_CLIENT_DETAIL_TIMEOUT_HXX
+
+#include <chrono>
+#include <optional>
+#include <utility>
+
+#include <boost/asio/any_io_executor.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include "clueapi/shared/macros.hxx"
+#include "clueapi/shared/timer_wheel/timer_wheel.hxx"
+
+namespace clueapi::server::client::detail {
+    /**
+     * @struct timeout_t
+     *
+     * @brief The deadline shared by all I/O operations of a client request.
+     *
+     * @details Backed by an entry of the worker's timer wheel when one is available, so that
+     * re-arming the deadline only relinks the entry. Falls back to a `steady_timer` per
+     * connection otherwise.
+     */
+    struct timeout_t {
+        /**
+         * @brief Initializes the timeout for a new connection.
+         *
+         * @param executor The executor of the connection's socket.
+         * @param timer_wheel The timer wheel of the connection's worker, may be `nullptr`.
+         * @param on_expire The callback invoked when the wheel entry expires.
+         */
+        CLUEAPI_INLINE void init(
+            const boost::asio::any_io_executor& executor,
+            shared::timer_wheel_t* timer_wheel,
+            shared::timer_wheel_t::on_expire_t on_expire) {
+            m_timer_wheel = timer_wheel;
+
+            if (m_timer_wheel)
+                m_entry.m_on_expire = std::move(on_expire);
+            else if (!m_timer)
+                m_timer.emplace(executor);
+
+            m_enabled = true;
+        }
+
+        /**
+         * @brief Sets the deadline relative to the current time.
+         *
+         * @param timeout The time after which pending operations time out.
+         */
+        template <typename _rep_t, typename _period_t>
+        CLUEAPI_INLINE void expires_after(std::chrono::duration<_rep_t, _period_t> timeout) {
+            if (!m_enabled)
+                return;
+
+            if (m_timer_wheel)
+                m_timer_wheel->arm_after(m_entry, timeout);
+            else if (m_timer)
+                m_timer->expires_after(timeout);
+        }
+
+        /**
+         * @brief Disables the timeout.
+         */
+        CLUEAPI_INLINE void reset() {
+            if (m_timer_wheel) {
+                m_timer_wheel->cancel(m_entry);
+
+                m_entry.m_on_expire = nullptr;
+
+                m_timer_wheel = nullptr;
+            }
+
+            if (m_timer) {
+                m_timer->cancel();
+
+                m_timer.reset();
+            }
+
+            m_enabled = false;
+        }
+
+       public:
+        /**
+         * @brief Checks if the timeout is backed by a timer wheel.
+         *
+         * @return `true` if the timeout uses a timer wheel, `false` otherwise.
+         */
+        [[nodiscard]] CLUEAPI_INLINE bool uses_wheel() const noexcept {
+            return m_timer_wheel != nullptr;
+        }
+
+        /**
+         * @brief Checks if the wheel entry expired since the deadline was last set.
+         *
+         * @return `true` if the deadline passed, `false` otherwise.
+         */
+        [[nodiscard]] CLUEAPI_INLINE bool is_expired() const noexcept {
+            return m_entry.is_expired();
+        }
+
+        /**
+         * @brief Gets the fallback timer.
+         *
+         * @return The fallback timer.
+         */
+        [[nodiscard]] CLUEAPI_INLINE boost::asio::steady_timer& timer() noexcept {
+            return *m_timer;
+        }
+
+        /**
+         * @brief Checks if the timeout is enabled.
+         */
+        [[nodiscard]] CLUEAPI_INLINE explicit operator bool() const noexcept {
+            return m_enabled;
+        }
+
+       private:
+        /**
+         * @brief The entry armed on the timer wheel.
+         */
+        shared::timer_wheel_t::entry_t m_entry;
+
+        /**
+         * @brief The timer wheel of the connection's worker.
+         */
+        shared::timer_wheel_t* m_timer_wheel{};
+
+        /**
+         * @brief The fallback timer, used when no timer wheel is available.
+         */
+        std::optional<boost::asio::steady_timer> m_timer;
+
+        /**
+         * @brief If true, the timeout is enabled.
+         */
+        bool m_enabled{false};
+    };
+} // namespace clueapi::server::client::detail
+
+#endif // CLUEAPI_SERVER_CLIENT_DETAIL_TIMEOUT_HXX
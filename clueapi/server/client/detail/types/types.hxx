@@ -0,0 +1,63 @@
+/**
+ * @file types.hxx
+ *
+ * @brief Contains the beast types of a client connection, allocated from its arena.
+ */
+
+#ifndef CLUEAPI_SERVER_CLIENT_DETAIL_TYPES_HXX
+#define CLUEAPI_SERVER_CLIENT_DETAIL_TYPES_HXX
+
+#include <tuple>
+#include <utility>
+
+#include <boost/beast/http/fields.hpp>
+#include <boost/beast/http/message.hpp>
+#include <boost/beast/http/parser.hpp>
+
+#include "clueapi/shared/arena/arena.hxx"
+#include "clueapi/shared/macros.hxx"
+
+namespace clueapi::server::client::detail {
+    /**
+     * @brief Type alias for the allocator of the per-request beast containers.
+     */
+    using allocator_t = shared::arena_t::allocator_t;
+
+    /**
+     * @brief Type alias for the header fields of a request or a response, placed in the arena.
+     */
+    using fields_t = boost::beast::http::basic_fields<allocator_t>;
+
+    /**
+     * @brief Type alias for a request parser whose fields are placed in the arena.
+     *
+     * @tparam _body_t The body type of the request.
+     */
+    template <typename _body_t>
+    using request_parser_t = boost::beast::http::request_parser<_body_t, allocator_t>;
+
+    /**
+     * @brief Type alias for a response whose fields are placed in the arena.
+     *
+     * @tparam _body_t The body type of the response.
+     */
+    template <typename _body_t>
+    using response_t = boost::beast::http::response<_body_t, fields_t>;
+
+    /**
+     * @brief Constructs a beast message or parser whose fields are placed in an arena.
+     *
+     * @tparam _type_t The type of the message or parser.
+     *
+     * @param arena The arena of the connection.
+     *
+     * @return The message or parser.
+     */
+    template <typename _type_t>
+    [[nodiscard]] CLUEAPI_INLINE _type_t make_in_arena(shared::arena_t& arena) {
+        return _type_t{
+            std::piecewise_construct, std::make_tuple(), std::make_tuple(arena.allocator())};
+    }
+} // namespace clueapi::server::client::detail
+
+#endif // CLUEAPI_SERVER_CLIENT_DETAIL_TYPES_HXX
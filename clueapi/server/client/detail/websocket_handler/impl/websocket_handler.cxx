@@ -0,0 +1,217 @@
+/**
+ * @file websocket_handler.cxx
+ *
+ * @brief Implements the WebSocket handler.
+ */
+
+#include "clueapi/server/client/detail/websocket_handler/websocket_handler.hxx"
+
+#include "clueapi/cfg/cfg.hxx"
+
+#include "clueapi/clueapi.hxx"
+
+#include "clueapi/exceptions/exceptions.hxx"
+
+#include "clueapi/http/ctx/ctx.hxx"
+#include "clueapi/modules/macros.hxx"
+
+#include "clueapi/server/client/detail/data/data.hxx"
+#include "clueapi/server/client/detail/detail.hxx"
+#include "clueapi/server/client/detail/response_handler/response_handler.hxx"
+
+#include "clueapi/server/server.hxx"
+
+#include "clueapi/websocket/websocket.hxx"
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <boost/asio/write.hpp>
+#include <boost/beast/core/string.hpp>
+#include <boost/beast/websocket/detail/hybi13.hpp>
+
+namespace clueapi::server::client::detail {
+    namespace {
+        /**
+         * @brief Checks if a header is one the server writes, or can't send, in a `101`.
+         *
+         * @param name The name of the header.
+         *
+         * @return `true` for the framing, connection and `Sec-WebSocket-*` headers.
+         */
+        bool is_handshake_field(std::string_view name) noexcept {
+            constexpr std::array<std::string_view, 6u> k_fields{
+                "Content-Type",
+                "Content-Length",
+                "Transfer-Encoding",
+                "Connection",
+                "Keep-Alive",
+                "Upgrade"};
+
+            constexpr std::string_view k_prefix{"Sec-WebSocket-"};
+
+            if (name.size() >= k_prefix.size() &&
+                boost::beast::iequals(name.substr(0, k_prefix.size()), k_prefix))
+                return true;
+
+            return std::ranges::any_of(k_fields, [name](std::string_view field) {
+                return boost::beast::iequals(name, field);
+            });
+        }
+    } // namespace
+
+    exceptions::expected_awaitable_t<e_error_code> websocket_handler_t::handle() {
+        auto request = m_data.m_request;
+
+        http::types::params_t params{};
+
+        const auto* handler = m_server.clueapi().websocket_handler(request->uri(), params);
+
+        if (!handler)
+            co_return exceptions::expected_t<e_error_code>{e_error_code::not_found};
+
+        const auto key = request->header("Sec-WebSocket-Key");
+
+        // The key is the base64 of 16 bytes
+        if (request->method() != http::types::method_t::get || !key.has_value() ||
+            key->size() != 24u || request->header("Sec-WebSocket-Version") != "13")
+            co_return exceptions::expected_t<e_error_code>{e_error_code::bad_request};
+
+        // A browser sends the page's origin, even from another site, with the server's cookies
+        if (const auto& allowed = m_cfg.m_websocket.m_allowed_origins; !allowed.empty()) {
+            if (auto origin = request->header("Origin"); origin.has_value()) {
+                const auto is_allowed = std::ranges::any_of(allowed, [&](const auto& entry) {
+                    return boost::beast::iequals(entry, origin.value());
+                });
+
+                if (!is_allowed) {
+                    CLUEAPI_LOG_DEBUG(
+                        "WebSocket upgrade refused (id: {}): origin: {}",
+
+                        m_socket.native_handle(),
+                        origin.value());
+
+                    co_return exceptions::expected_t<e_error_code>{e_error_code::forbidden};
+                }
+            }
+        }
+
+        // The middlewares may refuse the upgrade, which is answered with their response then
+        auto upgrade = co_await m_server.clueapi().upgrade_chain()(*request);
+
+        if (upgrade.status() != http::types::status_t::switching_protocols) {
+            m_data.m_response_data = std::move(upgrade);
+
+            if (auto sent = co_await response_handler_t{m_server, m_socket, m_cfg, m_data}.send();
+                !sent.has_value())
+                co_return exceptions::make_unexpected(std::move(sent.error()));
+
+            co_return exceptions::expected_t<e_error_code>{e_error_code::success};
+        }
+
+        bool uses_deflate{};
+
+        if (m_cfg.m_websocket.m_permessage_deflate) {
+            if (auto extensions = request->header("Sec-WebSocket-Extensions");
+                extensions.has_value())
+                uses_deflate = websocket::deflate::accepts(extensions.value());
+        }
+
+        boost::beast::websocket::detail::sec_ws_accept_type accept{};
+
+        boost::beast::websocket::detail::make_sec_ws_accept(accept, key.value());
+
+        std::string response{};
+
+        response.reserve(192u);
+
+        response.append(
+            "HTTP/1.1 101 Switching Protocols\r\n"
+            "Upgrade: websocket\r\n"
+            "Connection: Upgrade\r\n"
+            "Sec-WebSocket-Accept: ");
+
+        response.append(accept.data(), accept.size()).append("\r\n");
+
+        if (uses_deflate)
+            response.append("Sec-WebSocket-Extensions: ")
+                .append(websocket::deflate::k_response)
+                .append("\r\n");
+
+        // The headers and cookies the middlewares added, the handshake's own excepted
+        for (const auto& [name, value] : upgrade.headers()) {
+            if (is_handshake_field(name))
+                continue;
+
+            response.append(name).append(": ").append(value).append("\r\n");
+        }
+
+        for (const auto& cookie : upgrade.cookies())
+            response.append("Set-Cookie: ").append(cookie).append("\r\n");
+
+        response.append("\r\n");
+
+        const auto native_handle = m_socket.native_handle();
+
+        boost::system::error_code ec{};
+
+        if (m_data.m_timeout) {
+            auto expected = co_await exec_with_timeout(
+                boost::asio::async_write(
+                    m_socket,
+
+                    boost::asio::buffer(response),
+
+                    boost::asio::redirect_error(boost::asio::use_awaitable, ec)),
+
+                m_data.m_timeout);
+
+            if (!expected.has_value())
+                co_return exceptions::make_unexpected("Operation timed out");
+        } else {
+            co_await boost::asio::async_write(
+                m_socket,
+
+                boost::asio::buffer(response),
+
+                boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+        }
+
+        if (close_connection(ec, native_handle))
+            co_return exceptions::make_unexpected("Connection closed");
+
+        // The connection is long-lived from now on, the session sets no deadline
+        m_data.m_timeout.reset();
+
+        m_data.m_should_close = true;
+
+        CLUEAPI_LOG_DEBUG(
+            "WebSocket connection upgraded (id: {}): uri: {}, deflate: {}",
+
+            native_handle,
+            request->uri(),
+            uses_deflate);
+
+        auto session = std::make_shared<websocket::session_t>(
+            m_socket, m_data.m_buffer, m_cfg.m_websocket, uses_deflate);
+
+        try {
+            co_await (*handler)(http::ctx_t{std::move(request), std::move(params)}, session);
+        } catch (const std::exception& e) {
+            CLUEAPI_LOG_ERROR(
+                "Exception in WebSocket handler (id: {}): {}", native_handle, e.what());
+
+            session->close(websocket::close_code::k_internal_error);
+        }
+
+        co_await session->finish();
+
+        CLUEAPI_LOG_TRACE("WebSocket session completed (id: {})", native_handle);
+
+        co_return exceptions::expected_t<e_error_code>{e_error_code::success};
+    }
+} // namespace clueapi::server::client::detail
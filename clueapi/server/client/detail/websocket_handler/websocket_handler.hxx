@@ -0,0 +1,90 @@
+/**
+ * @file websocket_handler.hxx
+ *
+ * @brief Contains the implementation of the client-related functionality.
+ */
+
+#ifndef CLUEAPI_SERVER_CLIENT_DETAIL_WEBSOCKET_HANDLER_HXX
+#define CLUEAPI_SERVER_CLIENT_DETAIL_WEBSOCKET_HANDLER_HXX
+
+#include <boost/asio/ip/tcp.hpp>
+
+#include "clueapi/exceptions/wrap/wrap.hxx"
+
+#include "clueapi/shared/macros.hxx"
+
+#include "clueapi/server/client/detail/request_handler/request_handler.hxx"
+
+// Forward declarations
+namespace clueapi {
+    namespace cfg {
+        struct cfg_t;
+    }
+
+    namespace server {
+        class c_server;
+
+        namespace client::detail {
+            struct data_t;
+        }
+    } // namespace server
+} // namespace clueapi
+
+namespace clueapi::server::client::detail {
+    /**
+     * @struct websocket_handler_t
+     *
+     * @brief Upgrades a connection to WebSocket and runs the handler of its route.
+     */
+    struct websocket_handler_t {
+        /**
+         * @brief Constructs a new WebSocket handler.
+         *
+         * @param server The server instance.
+         * @param socket The socket of the client.
+         * @param cfg The configuration settings.
+         * @param data The data of the client, holding the upgrade request.
+         */
+        CLUEAPI_INLINE websocket_handler_t(
+            server::c_server& server,
+            boost::asio::ip::tcp::socket& socket,
+            const cfg::cfg_t& cfg,
+            data_t& data)
+            : m_server{server}, m_socket{socket}, m_cfg{cfg}, m_data{data} {
+        }
+
+       public:
+        /**
+         * @brief Answers the upgrade request and runs the session until its handler returns.
+         *
+         * @return `e_error_code::success` once the session ended, the status code to answer the
+         * request with if it can't be upgraded, or an unexpected if the connection failed.
+         *
+         * @note The connection is closed afterwards either way.
+         */
+        exceptions::expected_awaitable_t<e_error_code> handle();
+
+       private:
+        /**
+         * @brief The server instance.
+         */
+        server::c_server& m_server;
+
+        /**
+         * @brief The socket of the client.
+         */
+        boost::asio::ip::tcp::socket& m_socket;
+
+        /**
+         * @brief The configuration settings.
+         */
+        const cfg::cfg_t& m_cfg;
+
+        /**
+         * @brief The data of the client.
+         */
+        data_t& m_data;
+    };
+} // namespace clueapi::server::client::detail
+
+#endif // CLUEAPI_SERVER_CLIENT_DETAIL_WEBSOCKET_HANDLER_HXX
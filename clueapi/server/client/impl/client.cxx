@@ -14,6 +14,13 @@
 
 #include "clueapi/server/client/detail/request_handler/request_handler.hxx"
 #include "clueapi/server/client/detail/response_handler/response_handler.hxx"
+#include "clueapi/server/client/detail/websocket_handler/websocket_handler.hxx"
+
+#include "clueapi/shared/metrics/metrics.hxx"
+
+#ifdef CLUEAPI_USE_HTTP2
+#include "clueapi/server/client/detail/http2_handler/http2_handler.hxx"
+#endif // CLUEAPI_USE_HTTP2
 
 namespace clueapi::server::client {
     client_t::client_t(c_server& server, const cfg::cfg_t& cfg)
@@ -46,33 +53,83 @@ namespace clueapi::server::client {
         const auto has_keep_alive = m_cfg.m_http.m_keep_alive_enabled;
         const auto has_socket_timeout = m_cfg.m_socket.m_timeout.count() > 0;
 
-        if (m_data.m_timeout_timer) {
+        if (m_data.m_timeout) {
             if (has_keep_alive) {
-                m_data.m_timeout_timer->expires_after(m_cfg.m_http.m_keep_alive_timeout);
+                m_data.m_timeout.expires_after(m_cfg.m_http.m_keep_alive_timeout);
             } else if (has_socket_timeout)
-                m_data.m_timeout_timer->expires_after(m_cfg.m_socket.m_timeout);
+                m_data.m_timeout.expires_after(m_cfg.m_socket.m_timeout);
             else
-                m_data.m_timeout_timer.reset();
+                m_data.m_timeout.reset();
         }
 
         try {
+#ifdef CLUEAPI_USE_HTTP2
+            // An HTTP/2 connection with prior knowledge starts with its preface, not a request
+            if (m_cfg.m_http2.m_enabled) {
+                detail::http2_handler_t http2_handler{m_server, socket, m_cfg, m_data};
+
+                auto detected = co_await http2_handler.detect();
+
+                if (!detected.has_value())
+                    co_return;
+
+                if (detected.value()) {
+                    co_await http2_handler.handle();
+
+                    CLUEAPI_LOG_TRACE("Client session completed (id: {})", native_handle);
+
+                    co_return;
+                }
+            }
+#endif // CLUEAPI_USE_HTTP2
+
             while (m_server.is_running(std::memory_order_relaxed) && m_data.is_connected()) {
-                detail::req_handler_t req_handler{socket, m_cfg, m_data};
+                detail::req_handler_t req_handler{m_server, socket, m_cfg, m_data};
 
                 detail::response_handler_t response_handler{m_server, socket, m_cfg, m_data};
 
+                // The latency of a request counts from the moment it was read
+                std::chrono::steady_clock::time_point started{};
+
                 {
                     auto result = co_await req_handler.handle();
 
                     if (!result.has_value())
                         break;
 
+                    started = std::chrono::steady_clock::now();
+
+                    // The connection leaves the request loop once it's upgraded
+                    if (result.value() == detail::e_error_code::switching_protocols) {
+                        if (!m_data.m_pending_writes.empty() &&
+                            !(co_await response_handler.flush()).has_value())
+                            break;
+
+                        detail::websocket_handler_t websocket_handler{
+                            m_server, socket, m_cfg, m_data};
+
+                        auto upgraded = co_await websocket_handler.handle();
+
+                        if (upgraded.has_value() &&
+                            upgraded.value() != detail::e_error_code::success) {
+                            auto status =
+                                static_cast<http::types::status_t::e_status>(upgraded.value());
+
+                            co_await response_handler.send_error_response(
+                                status, http::types::status_t::to_str_copy(status));
+                        }
+
+                        break;
+                    }
+
                     if (result.value() != detail::e_error_code::success) {
                         auto status = static_cast<http::types::status_t::e_status>(result.value());
 
                         co_await response_handler.send_error_response(
                             status, http::types::status_t::to_str_copy(status));
 
+                        record_request(started);
+
                         break;
                     }
                 }
@@ -81,9 +138,21 @@ namespace clueapi::server::client {
                     auto result = co_await response_handler.handle();
 
                     {
-                        m_data.m_request.reset();
+                        record_request(started);
+
+                        m_data.reset_request();
+
+#ifndef NDEBUG
+                        CLUEAPI_LOG_TRACE(
+                            "Request used {} arena allocations ({} bytes, {} blocks) (id: {})",
 
-                        m_data.m_beast_request.clear();
+                            m_data.m_arena->allocations(),
+                            m_data.m_arena->bytes_used(),
+                            m_data.m_arena->upstream_allocations(),
+                            native_handle);
+#endif
+
+                        m_data.reset_arena();
                     }
 
                     if (!result.has_value())
@@ -97,10 +166,21 @@ namespace clueapi::server::client {
                 if (!has_keep_alive || m_data.m_should_close)
                     break;
 
-                m_data.cut_buffer(m_cfg.m_server.m_client.m_buffer_capacity);
+                // A pooled buffer goes back to the pool while the connection waits
+                if (m_data.m_buffer_pool)
+                    m_data.return_buffer();
+                else
+                    m_data.cut_buffer(m_cfg.m_server.m_client.m_buffer_capacity);
+
+                if (m_data.m_timeout && has_keep_alive)
+                    m_data.m_timeout.expires_after(m_cfg.m_http.m_keep_alive_timeout);
+            }
+
+            // Responses to pipelined requests may still be queued when the session ends early
+            if (!m_data.m_pending_writes.empty() && m_data.is_connected()) {
+                detail::response_handler_t response_handler{m_server, socket, m_cfg, m_data};
 
-                if (m_data.m_timeout_timer && has_keep_alive)
-                    m_data.m_timeout_timer->expires_after(m_cfg.m_http.m_keep_alive_timeout);
+                co_await response_handler.flush();
             }
 
             CLUEAPI_LOG_TRACE("Client session completed (id: {})", native_handle);
@@ -112,4 +192,34 @@ namespace clueapi::server::client {
 
         co_return;
     }
+
+    void client_t::record_request(std::chrono::steady_clock::time_point started) noexcept {
+        // The handler may have moved from the request
+        const auto& request = m_data.request_info();
+
+        const auto method = request.m_preconditions.m_method;
+
+        if (m_cfg.m_metrics.m_enabled)
+            shared::metrics_t::record_response(
+                m_data.m_sent_status, request.m_body_size, m_data.m_sent_bytes);
+
+        if (auto* tracer = m_server.tracer(); tracer && request.m_trace)
+            tracer->end(
+                m_data.m_trace,
+                http::types::method_t::to_str(method),
+                request.m_uri,
+                m_data.m_sent_status);
+
+        auto* access_log = m_server.access_log();
+
+        if (!access_log)
+            return;
+
+        access_log->log(
+            method,
+            request.m_uri,
+            m_data.m_sent_status,
+            m_data.m_sent_bytes,
+            std::chrono::steady_clock::now() - started);
+    }
 } // namespace clueapi::server::client
\ No newline at end of file
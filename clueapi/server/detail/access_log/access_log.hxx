@@ -0,0 +1,180 @@
+/**
+ * @file access_log.hxx
+ *
+ * @brief Defines the access log, written in batches by a background thread.
+ */
+
+#ifndef CLUEAPI_SERVER_DETAIL_ACCESS_LOG_HXX
+#define CLUEAPI_SERVER_DETAIL_ACCESS_LOG_HXX
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "clueapi/cfg/cfg.hxx"
+
+#include "clueapi/http/types/method/method.hxx"
+
+#include "clueapi/shared/macros.hxx"
+
+namespace clueapi::server::detail {
+    /**
+     * @struct access_record_t
+     *
+     * @brief The record of a request, also the layout of the binary format.
+     */
+    struct access_record_t {
+        /**
+         * @brief The maximum number of bytes of the request target kept, longer ones are cut.
+         */
+        static constexpr std::size_t k_max_target_size{104u};
+
+        /**
+         * @brief The time the response was sent, in nanoseconds since the Unix epoch.
+         */
+        std::int64_t m_time{};
+
+        /**
+         * @brief The number of body bytes sent.
+         */
+        std::uint64_t m_bytes{};
+
+        /**
+         * @brief The time from the request being read to the response being sent, in
+         * microseconds.
+         */
+        std::uint32_t m_latency{};
+
+        std::uint16_t m_status{};
+
+        http::types::method_t::e_method m_method{};
+
+        std::uint8_t m_target_size{};
+
+        std::array<char, k_max_target_size> m_target{};
+
+        /**
+         * @brief Gets the kept part of the request target.
+         */
+        [[nodiscard]] CLUEAPI_INLINE std::string_view target() const noexcept {
+            return {m_target.data(), m_target_size};
+        }
+    };
+
+    static_assert(sizeof(access_record_t) == 128u, "Access records are written as they are");
+
+    /**
+     * @class c_access_log
+     *
+     * @brief Samples the requests of the workers and writes them to a file.
+     *
+     * @details Each worker thread appends to its own preallocated buffer, under a lock that
+     * is only shared with the writer once per flush. The writer swaps the buffers of all workers
+     * with spare ones, formats the records into one contiguous block, and hands the blocks to a
+     * single `writev(2)` on a file opened with `O_APPEND`. In the binary format the records are
+     * written from the buffers as they are.
+     *
+     * Requests answered with a 5xx status are always logged, the others are sampled with
+     * `access_log_t::m_sample_rate` and `access_log_t::m_client_error_sample_rate`.
+     *
+     * @note `log()` is thread-safe and never blocks on I/O.
+     */
+    class c_access_log {
+       public:
+        /**
+         * @brief Constructs an access log, not writing until it is started.
+         *
+         * @param cfg The settings of the access log.
+         */
+        explicit c_access_log(cfg::cfg_t::access_log_t cfg);
+
+        ~c_access_log() noexcept;
+
+        // Copy constructor
+        CLUEAPI_INLINE c_access_log(const c_access_log&) = delete;
+
+        // Copy assignment operator
+        CLUEAPI_INLINE c_access_log& operator=(const c_access_log&) = delete;
+
+       public:
+        /**
+         * @brief Opens the file and starts the writer thread.
+         *
+         * @return `true` if the access log is running, `false` if the file can't be opened.
+         */
+        bool start();
+
+        /**
+         * @brief Writes the buffered records and stops the writer thread.
+         */
+        void stop();
+
+        /**
+         * @brief Logs a request, if it is sampled.
+         *
+         * @param method The method of the request.
+         * @param target The request target.
+         * @param status The status of the response.
+         * @param bytes The number of body bytes sent.
+         * @param latency The time from the request being read to the response being sent.
+         */
+        void log(
+            http::types::method_t::e_method method,
+            std::string_view target,
+            std::uint16_t status,
+            std::uint64_t bytes,
+            std::chrono::steady_clock::duration latency) noexcept;
+
+        /**
+         * @brief Writes the buffered records now.
+         */
+        void flush();
+
+       public:
+        /**
+         * @brief Gets the number of records written.
+         */
+        [[nodiscard]] std::uint64_t written() const noexcept;
+
+        /**
+         * @brief Gets the number of records dropped because a worker buffer was full.
+         */
+        [[nodiscard]] std::uint64_t dropped() const noexcept;
+
+       public:
+        /**
+         * @brief Appends a record in a text format.
+         *
+         * @param out The string appended to.
+         * @param record The record.
+         * @param format The format, `text` or `json`.
+         */
+        static void format(
+            std::string& out,
+            const access_record_t& record,
+            cfg::cfg_t::access_log_t::e_format format);
+
+       private:
+        /**
+         * @class c_impl
+         *
+         * @brief The internal implementation of the `c_access_log` class.
+         *
+         * @internal
+         */
+        class c_impl;
+
+        /**
+         * @brief The internal implementation of the `c_access_log` class.
+         *
+         * @internal
+         */
+        std::unique_ptr<c_impl> m_impl;
+    };
+} // namespace clueapi::server::detail
+
+#endif // CLUEAPI_SERVER_DETAIL_ACCESS_LOG_HXX
@@ -0,0 +1,559 @@
+/**
+ * @file access_log.cxx
+ *
+ * @brief Implements the access log.
+ */
+
+#include "clueapi/server/detail/access_log/access_log.hxx"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <condition_variable>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif // _WIN32
+
+#include <fmt/chrono.h>
+#include <fmt/compile.h>
+#include <fmt/format.h>
+
+#include "clueapi/modules/macros.hxx"
+
+#include "clueapi/shared/json_writer/json_writer.hxx"
+
+namespace clueapi::server::detail {
+    namespace {
+        /**
+         * @brief The identifier of the next access log, telling the thread caches apart.
+         */
+        std::atomic<std::uint64_t> g_next_id{1u};
+
+        /**
+         * @brief Gets the next number of a fast per-thread generator, for the sampling.
+         */
+        std::uint64_t next_random() noexcept {
+            thread_local std::uint64_t state{
+                std::hash<std::thread::id>{}(std::this_thread::get_id()) | 1u};
+
+            state ^= state << 13u;
+            state ^= state >> 7u;
+            state ^= state << 17u;
+
+            return state;
+        }
+
+        /**
+         * @brief Converts a sample rate to the bound of the random numbers that are sampled.
+         */
+        std::uint64_t threshold_of(double rate) noexcept {
+            if (rate >= 1.0)
+                return std::numeric_limits<std::uint64_t>::max();
+
+            if (rate <= 0.0)
+                return 0u;
+
+            return static_cast<std::uint64_t>(
+                rate * static_cast<double>(std::numeric_limits<std::uint64_t>::max()));
+        }
+
+        /**
+         * @brief Appends a time as ISO 8601 in UTC, with milliseconds.
+         */
+        void append_time(std::string& out, std::int64_t time) {
+            // Records come in bursts of the same second, its rendering is kept for the next ones
+            thread_local std::int64_t cached_seconds{-1};
+
+            thread_local std::array<char, 19u> cached{};
+
+            const auto seconds = time / 1'000'000'000;
+
+            if (seconds != cached_seconds) {
+                const auto time_t = static_cast<std::time_t>(seconds);
+
+                std::tm tm{};
+
+#if defined(_WIN32)
+                ::gmtime_s(&tm, &time_t);
+#else
+                ::gmtime_r(&time_t, &tm);
+#endif // _WIN32
+
+                fmt::format_to_n(cached.data(), cached.size(), "{:%Y-%m-%dT%H:%M:%S}", tm);
+
+                cached_seconds = seconds;
+            }
+
+            out.append(cached.data(), cached.size());
+
+            fmt::format_to(
+                std::back_inserter(out),
+                FMT_COMPILE(".{:03}Z"),
+                (time / 1'000'000) % 1000);
+        }
+    } // namespace
+
+    class c_access_log::c_impl {
+       public:
+        /**
+         * @struct shard_t
+         *
+         * @brief The records of a worker thread.
+         */
+        struct shard_t {
+            CLUEAPI_INLINE shard_t(std::thread::id owner, std::size_t size) : m_owner{owner} {
+                m_records.reserve(size);
+
+                m_spare.reserve(size);
+            }
+
+            std::thread::id m_owner;
+
+            /**
+             * @brief Guards `m_records`, only shared with the writer when it swaps the buffers.
+             */
+            std::mutex m_mutex;
+
+            std::vector<access_record_t> m_records;
+
+            /**
+             * @brief The buffer being written, only touched by the writer.
+             */
+            std::vector<access_record_t> m_spare;
+        };
+
+        /**
+         * @struct cache_t
+         *
+         * @brief The shard of the current thread, for the last access log it logged to.
+         */
+        struct cache_t {
+            std::uint64_t m_id{};
+
+            shard_t* m_shard{};
+        };
+
+       public:
+        explicit c_impl(cfg::cfg_t::access_log_t cfg)
+            : m_cfg{std::move(cfg)},
+              m_id{g_next_id.fetch_add(1u, std::memory_order_relaxed)},
+              m_threshold{threshold_of(m_cfg.m_sample_rate)},
+              m_client_error_threshold{threshold_of(m_cfg.m_client_error_sample_rate)} {
+            m_cfg.m_buffer_size = std::max<std::size_t>(m_cfg.m_buffer_size, 1u);
+        }
+
+        ~c_impl() noexcept {
+            stop();
+        }
+
+       public:
+        bool start() {
+            if (m_is_running.load(std::memory_order_acquire))
+                return true;
+
+#if defined(_WIN32)
+            CLUEAPI_LOG_WARNING("The access log isn't supported on this platform");
+
+            return false;
+#else
+            m_fd = ::open(m_cfg.m_path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+
+            if (m_fd < 0) {
+                CLUEAPI_LOG_ERROR(
+                    "Failed to open the access log '{}': {}", m_cfg.m_path, std::strerror(errno));
+
+                return false;
+            }
+
+            m_is_running.store(true, std::memory_order_release);
+
+            m_thread = std::thread{[this]() { run(); }};
+
+            return true;
+#endif // _WIN32
+        }
+
+        void stop() noexcept {
+            if (!m_is_running.exchange(false, std::memory_order_acq_rel))
+                return;
+
+            {
+                std::lock_guard lock{m_wake_mutex};
+            }
+
+            m_wake.notify_all();
+
+            if (m_thread.joinable())
+                m_thread.join();
+
+            try {
+                flush();
+            } catch (...) {
+                // ...
+            }
+
+#if !defined(_WIN32)
+            ::close(m_fd);
+#endif // _WIN32
+
+            m_fd = -1;
+        }
+
+        void log(
+            http::types::method_t::e_method method,
+            std::string_view target,
+            std::uint16_t status,
+            std::uint64_t bytes,
+            std::chrono::steady_clock::duration latency) noexcept {
+            if (status < 500u &&
+                next_random() > (status >= 400u ? m_client_error_threshold : m_threshold))
+                return;
+
+            auto* shard = shard_of();
+
+            if (!shard)
+                return;
+
+            bool should_wake{};
+
+            {
+                std::lock_guard lock{shard->m_mutex};
+
+                if (shard->m_records.size() >= m_cfg.m_buffer_size) {
+                    m_dropped.fetch_add(1u, std::memory_order_relaxed);
+
+                    return;
+                }
+
+                // Reserved for the whole buffer, never allocates
+                auto& record = shard->m_records.emplace_back();
+
+                record.m_time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                    std::chrono::system_clock::now().time_since_epoch())
+                                    .count();
+
+                record.m_bytes = bytes;
+
+                record.m_latency = static_cast<std::uint32_t>(std::min<std::int64_t>(
+                    std::chrono::duration_cast<std::chrono::microseconds>(latency).count(),
+                    std::numeric_limits<std::uint32_t>::max()));
+
+                record.m_status = status;
+
+                record.m_method = method;
+
+                const auto size = std::min(target.size(), access_record_t::k_max_target_size);
+
+                std::memcpy(record.m_target.data(), target.data(), size);
+
+                record.m_target_size = static_cast<std::uint8_t>(size);
+
+                should_wake = shard->m_records.size() == m_cfg.m_buffer_size / 2u;
+            }
+
+            if (should_wake)
+                m_wake.notify_one();
+        }
+
+        void flush() {
+            std::lock_guard flush_lock{m_flush_mutex};
+
+            if (m_fd < 0)
+                return;
+
+            {
+                std::lock_guard lock{m_shards_mutex};
+
+                m_flushing.clear();
+
+                for (const auto& shard : m_shards)
+                    m_flushing.push_back(shard.get());
+            }
+
+            std::size_t count{};
+
+            for (auto* shard : m_flushing) {
+                {
+                    std::lock_guard lock{shard->m_mutex};
+
+                    shard->m_records.swap(shard->m_spare);
+                }
+
+                count += shard->m_spare.size();
+            }
+
+            if (count == 0u)
+                return;
+
+            write(count);
+
+            for (auto* shard : m_flushing)
+                shard->m_spare.clear();
+
+            m_out.clear();
+        }
+
+        [[nodiscard]] std::uint64_t written() const noexcept {
+            return m_written.load(std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] std::uint64_t dropped() const noexcept {
+            return m_dropped.load(std::memory_order_relaxed);
+        }
+
+       private:
+        /**
+         * @brief Writes the records swapped out of the shards.
+         *
+         * @param count The number of records.
+         */
+        void write(std::size_t count) {
+#if !defined(_WIN32)
+            m_iovecs.clear();
+
+            if (m_cfg.m_format == cfg::cfg_t::access_log_t::e_format::binary) {
+                for (auto* shard : m_flushing) {
+                    if (shard->m_spare.empty())
+                        continue;
+
+                    m_iovecs.push_back(iovec{
+                        shard->m_spare.data(), shard->m_spare.size() * sizeof(access_record_t)});
+                }
+            } else {
+                for (auto* shard : m_flushing)
+                    for (const auto& record : shard->m_spare)
+                        format(m_out, record, m_cfg.m_format);
+
+                m_iovecs.push_back(iovec{m_out.data(), m_out.size()});
+            }
+
+            if (!write_all())
+                return;
+
+            m_written.fetch_add(count, std::memory_order_relaxed);
+#endif // _WIN32
+        }
+
+#if !defined(_WIN32)
+        /**
+         * @brief Writes the gathered buffers, resuming after partial writes.
+         *
+         * @return `true` if everything was written, `false` on an error.
+         */
+        bool write_all() {
+            std::size_t first{};
+
+            while (first < m_iovecs.size()) {
+                const auto num = static_cast<int>(std::min<std::size_t>(
+                    m_iovecs.size() - first, static_cast<std::size_t>(IOV_MAX)));
+
+                const auto written = ::writev(m_fd, m_iovecs.data() + first, num);
+
+                if (written < 0) {
+                    if (errno == EINTR)
+                        continue;
+
+                    CLUEAPI_LOG_ERROR(
+                        "Failed to write the access log '{}': {}",
+
+                        m_cfg.m_path,
+                        std::strerror(errno));
+
+                    return false;
+                }
+
+                auto left = static_cast<std::size_t>(written);
+
+                while (first < m_iovecs.size() && left >= m_iovecs[first].iov_len)
+                    left -= m_iovecs[first++].iov_len;
+
+                if (left != 0u) {
+                    m_iovecs[first].iov_base = static_cast<char*>(m_iovecs[first].iov_base) + left;
+
+                    m_iovecs[first].iov_len -= left;
+                }
+            }
+
+            return true;
+        }
+#endif // _WIN32
+
+        /**
+         * @brief Writes the records until the access log is stopped.
+         */
+        void run() {
+            while (m_is_running.load(std::memory_order_acquire)) {
+                {
+                    std::unique_lock lock{m_wake_mutex};
+
+                    if (m_is_running.load(std::memory_order_acquire))
+                        m_wake.wait_for(lock, m_cfg.m_flush_interval);
+                }
+
+                try {
+                    flush();
+                } catch (const std::exception& e) {
+                    CLUEAPI_LOG_ERROR("Failed to flush the access log: {}", e.what());
+                }
+            }
+        }
+
+        /**
+         * @brief Gets the shard of the current thread, creating it on first use.
+         */
+        [[nodiscard]] shard_t* shard_of() noexcept {
+            thread_local cache_t cache{};
+
+            if (cache.m_id == m_id)
+                return cache.m_shard;
+
+            try {
+                const auto owner = std::this_thread::get_id();
+
+                std::lock_guard lock{m_shards_mutex};
+
+                auto it = std::find_if(m_shards.begin(), m_shards.end(), [&](const auto& shard) {
+                    return shard->m_owner == owner;
+                });
+
+                if (it == m_shards.end())
+                    it = m_shards.insert(
+                        m_shards.end(), std::make_unique<shard_t>(owner, m_cfg.m_buffer_size));
+
+                cache = cache_t{m_id, it->get()};
+
+                return cache.m_shard;
+            } catch (...) {
+                // ...
+            }
+
+            return nullptr;
+        }
+
+       private:
+        cfg::cfg_t::access_log_t m_cfg;
+
+        std::uint64_t m_id;
+
+        std::uint64_t m_threshold;
+
+        std::uint64_t m_client_error_threshold;
+
+        std::atomic<bool> m_is_running{false};
+
+        std::thread m_thread;
+
+        std::mutex m_wake_mutex;
+
+        std::condition_variable m_wake;
+
+        std::mutex m_shards_mutex;
+
+        std::vector<std::unique_ptr<shard_t>> m_shards;
+
+        /**
+         * @brief Serializes the flushes of the writer and of `stop()`, and guards the buffers
+         * below.
+         */
+        std::mutex m_flush_mutex;
+
+        std::vector<shard_t*> m_flushing;
+
+        std::string m_out;
+
+#if !defined(_WIN32)
+        std::vector<iovec> m_iovecs;
+#endif // _WIN32
+
+        int m_fd{-1};
+
+        std::atomic<std::uint64_t> m_written{};
+
+        std::atomic<std::uint64_t> m_dropped{};
+    };
+
+    c_access_log::c_access_log(cfg::cfg_t::access_log_t cfg)
+        : m_impl{std::make_unique<c_impl>(std::move(cfg))} {
+    }
+
+    c_access_log::~c_access_log() noexcept = default;
+
+    bool c_access_log::start() {
+        return m_impl->start();
+    }
+
+    void c_access_log::stop() {
+        m_impl->stop();
+    }
+
+    void c_access_log::log(
+        http::types::method_t::e_method method,
+        std::string_view target,
+        std::uint16_t status,
+        std::uint64_t bytes,
+        std::chrono::steady_clock::duration latency) noexcept {
+        m_impl->log(method, target, status, bytes, latency);
+    }
+
+    void c_access_log::flush() {
+        m_impl->flush();
+    }
+
+    std::uint64_t c_access_log::written() const noexcept {
+        return m_impl->written();
+    }
+
+    std::uint64_t c_access_log::dropped() const noexcept {
+        return m_impl->dropped();
+    }
+
+    void c_access_log::format(
+        std::string& out,
+        const access_record_t& record,
+        cfg::cfg_t::access_log_t::e_format format) {
+        const auto method = http::types::method_t::to_str(record.m_method);
+
+        if (format == cfg::cfg_t::access_log_t::e_format::json) {
+            out.append(R"({"time":")");
+
+            append_time(out, record.m_time);
+
+            out.append(R"(","method":")").append(method).append(R"(","target":)");
+
+            shared::json_writer_t::write_string(out, record.target());
+
+            fmt::format_to(
+                std::back_inserter(out),
+                FMT_COMPILE(R"(,"status":{},"bytes":{},"latency_us":{}}})"
+                            "\n"),
+                record.m_status,
+                record.m_bytes,
+                record.m_latency);
+
+            return;
+        }
+
+        append_time(out, record.m_time);
+
+        fmt::format_to(
+            std::back_inserter(out),
+            FMT_COMPILE(" {} {} {} {} {}us\n"),
+            method,
+            record.target(),
+            record.m_status,
+            record.m_bytes,
+            record.m_latency);
+    }
+} // namespace clueapi::server::detail
@@ -0,0 +1,531 @@
+/**
+ * @file client_pool.hxx
+ *
+ * @brief Defines the per-worker sharded client pool.
+ */
+
+#ifndef CLUEAPI_SERVER_DETAIL_CLIENT_POOL_HXX
+#define CLUEAPI_SERVER_DETAIL_CLIENT_POOL_HXX
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "clueapi/shared/macros.hxx"
+
+/**
+ * @namespace clueapi::server::detail
+ *
+ * @brief Internal data definitions for the clueapi server.
+ *
+ * @internal
+ */
+namespace clueapi::server::detail {
+    /**
+     * @struct client_pool_t
+     *
+     * @brief A pool of clients sharded per worker `io_context`.
+     *
+     * @details Every shard owns its clients and a free list guarded by its own mutex, which is
+     * only ever contended when another shard steals from it. A client always returns to the shard
+     * that created it, so its buffers stay local to the worker that allocated them. Stealing only
+     * happens when the local shard has no free client.
+     *
+     * The pool can also be used elastically: `grow()` creates a client on demand up to a hard
+     * maximum and `trim()` destroys clients that stayed free for longer than an idle timeout.
+     *
+     * @tparam _client_t The type of the pooled client.
+     */
+    template <typename _client_t>
+    struct client_pool_t {
+        /**
+         * @struct slot_t
+         *
+         * @brief A pooled client together with the index of its home shard.
+         */
+        struct slot_t {
+            /**
+             * @brief The pooled client.
+             */
+            std::unique_ptr<_client_t> m_client;
+
+            /**
+             * @brief The index of the shard that owns the client.
+             */
+            std::size_t m_shard{};
+
+            /**
+             * @brief The time the client was last returned to the pool.
+             */
+            std::chrono::steady_clock::time_point m_idle_since{};
+        };
+
+        /**
+         * @struct stats_t
+         *
+         * @brief A snapshot of the counters of a single shard.
+         */
+        struct stats_t {
+            /**
+             * @brief The number of clients owned by the shard.
+             */
+            std::size_t m_capacity{};
+
+            /**
+             * @brief The number of free clients in the shard.
+             */
+            std::size_t m_available{};
+
+            /**
+             * @brief The number of clients acquired for connections placed on the shard.
+             */
+            std::size_t m_acquired{};
+
+            /**
+             * @brief The number of clients returned to the shard.
+             */
+            std::size_t m_released{};
+
+            /**
+             * @brief The number of clients the shard had to steal from other shards.
+             */
+            std::size_t m_stolen{};
+
+            /**
+             * @brief The number of acquisitions that found no free client in any shard.
+             */
+            std::size_t m_misses{};
+
+            /**
+             * @brief The number of clients created on demand by `grow()`.
+             */
+            std::size_t m_grown{};
+
+            /**
+             * @brief The number of idle clients destroyed by `trim()`.
+             */
+            std::size_t m_trimmed{};
+        };
+
+       public:
+        /**
+         * @brief (Re)initializes the pool with the given number of empty shards.
+         *
+         * @param num_shards The number of shards, normally the number of worker `io_context`
+         * instances.
+         */
+        CLUEAPI_INLINE void init(std::size_t num_shards) {
+            m_num_shards = num_shards == 0 ? 1 : num_shards;
+
+            m_shards = std::make_unique<shard_t[]>(m_num_shards);
+        }
+
+        /**
+         * @brief Adds a new client to the given shard.
+         *
+         * @param shard The index of the shard.
+         * @param client The client to add.
+         */
+        CLUEAPI_INLINE void add(std::size_t shard, std::unique_ptr<_client_t> client) {
+            shard %= m_num_shards;
+
+            auto slot = std::make_unique<slot_t>(
+                slot_t{std::move(client), shard, std::chrono::steady_clock::now()});
+
+            auto& target = m_shards[shard];
+
+            m_size.fetch_add(1, std::memory_order_relaxed);
+
+            std::lock_guard lock{target.m_mutex};
+
+            target.m_free.emplace_back(slot.get());
+
+            target.m_storage.emplace_back(std::move(slot));
+        }
+
+        /**
+         * @brief Creates a new client in the given shard and acquires it, unless the pool
+         * already holds `max_size` clients.
+         *
+         * @param shard The index of the shard.
+         * @param max_size The hard maximum number of clients in the pool.
+         * @param factory The function creating the client, returning a `std::unique_ptr`.
+         *
+         * @return A pointer to the slot of the acquired client, or `nullptr` if the pool is full.
+         */
+        template <typename _factory_t>
+        [[nodiscard]] CLUEAPI_INLINE slot_t* grow(
+            std::size_t shard, std::size_t max_size, _factory_t&& factory) {
+            if (!m_shards)
+                return nullptr;
+
+            auto size = m_size.load(std::memory_order_relaxed);
+
+            do {
+                if (size >= max_size)
+                    return nullptr;
+            } while (!m_size.compare_exchange_weak(size, size + 1, std::memory_order_relaxed));
+
+            shard %= m_num_shards;
+
+            std::unique_ptr<slot_t> slot{};
+
+            try {
+                slot = std::make_unique<slot_t>(slot_t{factory(), shard});
+            } catch (...) {
+                m_size.fetch_sub(1, std::memory_order_relaxed);
+
+                throw;
+            }
+
+            auto* ret = slot.get();
+
+            auto& target = m_shards[shard];
+
+            {
+                std::lock_guard lock{target.m_mutex};
+
+                target.m_storage.emplace_back(std::move(slot));
+            }
+
+            target.m_acquired.fetch_add(1, std::memory_order_relaxed);
+
+            target.m_grown.fetch_add(1, std::memory_order_relaxed);
+
+            return ret;
+        }
+
+        /**
+         * @brief Destroys free clients of the given shard that stayed idle for longer than
+         * `idle_timeout`, keeping at least `keep` clients in the shard.
+         *
+         * @param shard The index of the shard.
+         * @param keep The number of clients the shard keeps regardless of idleness.
+         * @param idle_timeout The idle time after which a free client is destroyed.
+         *
+         * @return The number of destroyed clients.
+         */
+        CLUEAPI_INLINE std::size_t trim(
+            std::size_t shard, std::size_t keep, std::chrono::steady_clock::duration idle_timeout) {
+            if (shard >= num_shards())
+                return 0;
+
+            auto& target = m_shards[shard];
+
+            const auto deadline = std::chrono::steady_clock::now() - idle_timeout;
+
+            std::vector<std::unique_ptr<slot_t>> expired{};
+
+            {
+                std::lock_guard lock{target.m_mutex};
+
+                // The free list is a LIFO stack, so the longest idle clients are at the front
+                std::size_t count{};
+
+                while (count < target.m_free.size() &&
+                       target.m_storage.size() - count > keep &&
+                       target.m_free[count]->m_idle_since < deadline)
+                    ++count;
+
+                if (count == 0)
+                    return 0;
+
+                for (std::size_t i{}; i < count; i++) {
+                    auto it = std::find_if(
+                        target.m_storage.begin(),
+                        target.m_storage.end(),
+
+                        [slot = target.m_free[i]](const auto& owned) {
+                            return owned.get() == slot;
+                        });
+
+                    if (it == target.m_storage.end())
+                        continue;
+
+                    expired.emplace_back(std::move(*it));
+
+                    *it = std::move(target.m_storage.back());
+
+                    target.m_storage.pop_back();
+                }
+
+                target.m_free.erase(
+                    target.m_free.begin(),
+                    target.m_free.begin() + static_cast<std::ptrdiff_t>(count));
+            }
+
+            m_size.fetch_sub(expired.size(), std::memory_order_relaxed);
+
+            target.m_trimmed.fetch_add(expired.size(), std::memory_order_relaxed);
+
+            // The clients are destroyed outside of the lock
+            return expired.size();
+        }
+
+        /**
+         * @brief Acquires a free client, preferring the given shard.
+         *
+         * @param shard The index of the preferred shard.
+         *
+         * @return A pointer to the slot of the acquired client, or `nullptr` if no client is free.
+         */
+        [[nodiscard]] CLUEAPI_INLINE slot_t* acquire(std::size_t shard) {
+            if (!m_shards)
+                return nullptr;
+
+            shard %= m_num_shards;
+
+            auto& local = m_shards[shard];
+
+            if (auto* slot = pop(local)) {
+                local.m_acquired.fetch_add(1, std::memory_order_relaxed);
+
+                return slot;
+            }
+
+            for (std::size_t i = 1; i < m_num_shards; i++) {
+                auto& victim = m_shards[(shard + i) % m_num_shards];
+
+                if (auto* slot = pop(victim)) {
+                    local.m_acquired.fetch_add(1, std::memory_order_relaxed);
+
+                    local.m_stolen.fetch_add(1, std::memory_order_relaxed);
+
+                    return slot;
+                }
+            }
+
+            local.m_misses.fetch_add(1, std::memory_order_relaxed);
+
+            return nullptr;
+        }
+
+        /**
+         * @brief Returns a client to its home shard.
+         *
+         * @param slot The slot of the client.
+         */
+        CLUEAPI_INLINE void release(slot_t* slot) {
+            if (!slot || !m_shards)
+                return;
+
+            auto& home = m_shards[slot->m_shard];
+
+            slot->m_idle_since = std::chrono::steady_clock::now();
+
+            {
+                std::lock_guard lock{home.m_mutex};
+
+                home.m_free.emplace_back(slot);
+            }
+
+            home.m_released.fetch_add(1, std::memory_order_relaxed);
+        }
+
+       public:
+        /**
+         * @brief Invokes the given function for every client in the pool, free or not.
+         *
+         * @param fn The function to invoke with a reference to each client.
+         */
+        template <typename _fn_t>
+        CLUEAPI_INLINE void for_each(_fn_t&& fn) {
+            for (std::size_t i{}; i < m_num_shards && m_shards; i++) {
+                auto& shard = m_shards[i];
+
+                std::lock_guard lock{shard.m_mutex};
+
+                for (auto& slot : shard.m_storage)
+                    fn(*slot->m_client);
+            }
+        }
+
+        /**
+         * @brief Destroys every client and shard.
+         */
+        CLUEAPI_INLINE void clear() {
+            m_shards.reset();
+
+            m_num_shards = 0;
+
+            m_size.store(0, std::memory_order_relaxed);
+        }
+
+       public:
+        /**
+         * @brief Gets the number of shards.
+         *
+         * @return The number of shards.
+         */
+        [[nodiscard]] CLUEAPI_INLINE std::size_t num_shards() const noexcept {
+            return m_shards ? m_num_shards : 0;
+        }
+
+        /**
+         * @brief Gets the total number of clients owned by the pool.
+         *
+         * @return The number of clients.
+         */
+        [[nodiscard]] CLUEAPI_INLINE std::size_t capacity() const noexcept {
+            return m_size.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Gets the total number of free clients in the pool.
+         *
+         * @return The number of free clients.
+         */
+        [[nodiscard]] CLUEAPI_INLINE std::size_t available() const {
+            std::size_t ret{};
+
+            for (std::size_t i{}; i < num_shards(); i++)
+                ret += stats(i).m_available;
+
+            return ret;
+        }
+
+        /**
+         * @brief Takes a snapshot of the counters of the given shard.
+         *
+         * @param shard The index of the shard.
+         *
+         * @return The shard snapshot.
+         */
+        [[nodiscard]] CLUEAPI_INLINE stats_t stats(std::size_t shard) const {
+            if (shard >= num_shards())
+                return {};
+
+            const auto& target = m_shards[shard];
+
+            stats_t ret{
+                .m_acquired = target.m_acquired.load(std::memory_order_relaxed),
+                .m_released = target.m_released.load(std::memory_order_relaxed),
+                .m_stolen = target.m_stolen.load(std::memory_order_relaxed),
+                .m_misses = target.m_misses.load(std::memory_order_relaxed),
+                .m_grown = target.m_grown.load(std::memory_order_relaxed),
+                .m_trimmed = target.m_trimmed.load(std::memory_order_relaxed)};
+
+            {
+                std::lock_guard lock{target.m_mutex};
+
+                ret.m_capacity = target.m_storage.size();
+
+                ret.m_available = target.m_free.size();
+            }
+
+            return ret;
+        }
+
+        /**
+         * @brief Takes a snapshot of the counters of every shard.
+         *
+         * @return The shard snapshots, in shard order.
+         */
+        [[nodiscard]] CLUEAPI_INLINE std::vector<stats_t> stats() const {
+            std::vector<stats_t> ret{};
+
+            ret.reserve(num_shards());
+
+            for (std::size_t i{}; i < num_shards(); i++)
+                ret.emplace_back(stats(i));
+
+            return ret;
+        }
+
+       private:
+        /**
+         * @struct shard_t
+         *
+         * @brief A single shard of the pool, padded to a cache line.
+         */
+        struct alignas(64) shard_t {
+            /**
+             * @brief Guards the storage and the free list.
+             */
+            mutable std::mutex m_mutex;
+
+            /**
+             * @brief The clients owned by the shard.
+             */
+            std::vector<std::unique_ptr<slot_t>> m_storage;
+
+            /**
+             * @brief The free clients of the shard, used as a LIFO stack to keep buffers warm.
+             */
+            std::vector<slot_t*> m_free;
+
+            /**
+             * @brief The number of acquisitions served for this shard.
+             */
+            std::atomic<std::size_t> m_acquired{0};
+
+            /**
+             * @brief The number of clients returned to this shard.
+             */
+            std::atomic<std::size_t> m_released{0};
+
+            /**
+             * @brief The number of clients stolen from other shards.
+             */
+            std::atomic<std::size_t> m_stolen{0};
+
+            /**
+             * @brief The number of failed acquisitions.
+             */
+            std::atomic<std::size_t> m_misses{0};
+
+            /**
+             * @brief The number of clients created on demand.
+             */
+            std::atomic<std::size_t> m_grown{0};
+
+            /**
+             * @brief The number of idle clients destroyed.
+             */
+            std::atomic<std::size_t> m_trimmed{0};
+        };
+
+        /**
+         * @brief Pops a free client from the given shard.
+         *
+         * @param shard The shard to pop from.
+         *
+         * @return A pointer to the slot, or `nullptr` if the shard has no free client.
+         */
+        [[nodiscard]] CLUEAPI_INLINE static slot_t* pop(shard_t& shard) {
+            std::lock_guard lock{shard.m_mutex};
+
+            if (shard.m_free.empty())
+                return nullptr;
+
+            auto* slot = shard.m_free.back();
+
+            shard.m_free.pop_back();
+
+            return slot;
+        }
+
+       private:
+        /**
+         * @brief The shards of the pool.
+         */
+        std::unique_ptr<shard_t[]> m_shards;
+
+        /**
+         * @brief The number of shards.
+         */
+        std::size_t m_num_shards{};
+
+        /**
+         * @brief The total number of clients owned by the pool.
+         */
+        std::atomic<std::size_t> m_size{0};
+    };
+} // namespace clueapi::server::detail
+
+#endif // CLUEAPI_SERVER_DETAIL_CLIENT_POOL_HXX
@@ -0,0 +1,632 @@
+/**
+ * @file supervisor.cxx
+ *
+ * @brief Implements the supervisor of the prefork mode.
+ */
+
+#ifndef _WIN32
+
+#include "clueapi/server/detail/supervisor/supervisor.hxx"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdlib>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/prctl.h>
+#endif // __linux__
+
+#include <fmt/format.h>
+
+#include "clueapi/exceptions/exceptions.hxx"
+
+#include "clueapi/modules/macros.hxx"
+
+namespace clueapi::server::detail {
+    namespace {
+        using steady_clock_t = std::chrono::steady_clock;
+
+        /**
+         * @brief The interval at which the supervisor thread checks its workers and signals.
+         */
+        inline constexpr std::chrono::milliseconds k_poll_interval{50};
+
+        /**
+         * @brief The signals that stop the supervisor.
+         */
+        inline constexpr std::array k_stop_signals{SIGINT, SIGTERM, SIGQUIT};
+
+        volatile std::sig_atomic_t g_stop_requested{0};
+
+        volatile std::sig_atomic_t g_reload_requested{0};
+
+        extern "C" void on_signal(int signo) {
+            if (signo == SIGHUP)
+                g_reload_requested = 1;
+            else
+                g_stop_requested = 1;
+        }
+
+        void install_handlers() noexcept {
+            struct sigaction action{};
+
+            action.sa_handler = on_signal;
+
+            sigemptyset(&action.sa_mask);
+
+            action.sa_flags = SA_RESTART;
+
+            for (const auto signo : k_stop_signals)
+                ::sigaction(signo, &action, nullptr);
+
+            ::sigaction(SIGHUP, &action, nullptr);
+        }
+
+        /**
+         * @brief Gives a forked worker the default signal handling, for it to install its own.
+         */
+        void restore_handlers() noexcept {
+            for (const auto signo : k_stop_signals)
+                ::signal(signo, SIG_DFL);
+
+            ::signal(SIGHUP, SIG_DFL);
+
+            sigset_t mask{};
+
+            sigemptyset(&mask);
+
+            ::pthread_sigmask(SIG_SETMASK, &mask, nullptr);
+        }
+
+        void set_cloexec(int fd) noexcept {
+            ::fcntl(fd, F_SETFD, ::fcntl(fd, F_GETFD) | FD_CLOEXEC);
+        }
+
+        /**
+         * @brief Describes how a worker ended, for the logs.
+         */
+        [[nodiscard]] std::string describe_status(int status) {
+            if (WIFEXITED(status))
+                return fmt::format("exited with status {}", WEXITSTATUS(status));
+
+            if (WIFSIGNALED(status))
+                return fmt::format("was killed by signal {}", WTERMSIG(status));
+
+            return "ended";
+        }
+    } // namespace
+
+    class c_supervisor::c_impl {
+       public:
+        c_impl(cfg::cfg_t::prefork_t cfg, worker_fn_t worker, std::function<void()> on_exit)
+            : m_cfg{std::move(cfg)}, m_worker{std::move(worker)}, m_on_exit{std::move(on_exit)} {
+            if (m_cfg.m_processes == 0u)
+                m_cfg.m_processes = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+
+        ~c_impl() noexcept {
+            stop();
+        }
+
+       public:
+        void start() {
+            g_stop_requested = 0;
+
+            g_reload_requested = 0;
+
+            install_handlers();
+
+            m_slots.assign(m_cfg.m_processes, slot_t{});
+
+            std::promise<std::size_t> started{};
+
+            auto ready = started.get_future();
+
+            m_is_running.store(true, std::memory_order_release);
+
+            // `PR_SET_PDEATHSIG` fires when the thread that forked a worker ends, so every worker
+            // is forked from the supervisor thread, which lives as long as the workers
+            m_thread = std::thread{[this, &started]() {
+                const auto count = spawn_all();
+
+                if (count == 0u) {
+                    shutdown();
+
+                    m_is_running.store(false, std::memory_order_release);
+                }
+
+                // `started` is gone once its value is taken
+                started.set_value(count);
+
+                if (count != 0u)
+                    run();
+            }};
+
+            const auto count = ready.get();
+
+            if (count == 0u) {
+                m_thread.join();
+
+                throw exceptions::exception_t{"No prefork worker became ready"};
+            }
+
+            CLUEAPI_LOG_INFO(
+                "Supervising {} of {} worker processes (pid: {})",
+
+                count,
+                m_slots.size(),
+                ::getpid());
+        }
+
+        void stop() noexcept {
+            m_is_running.store(false, std::memory_order_release);
+
+            m_wake.notify_all();
+
+            if (m_thread.joinable() && m_thread.get_id() != std::this_thread::get_id())
+                m_thread.join();
+        }
+
+        void reload() noexcept {
+            m_reload_requested.store(true, std::memory_order_release);
+
+            m_wake.notify_all();
+        }
+
+        [[nodiscard]] std::size_t workers() const noexcept {
+            return m_workers.load(std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] std::size_t restarts() const noexcept {
+            return m_restarts.load(std::memory_order_relaxed);
+        }
+
+       private:
+        /**
+         * @brief A worker process, its index fixed across the restarts.
+         */
+        struct slot_t {
+            pid_t m_pid{-1};
+
+            steady_clock_t::time_point m_restart_at{};
+        };
+
+        /**
+         * @brief A stopped worker, killed if it is still running at its deadline.
+         */
+        struct draining_t {
+            pid_t m_pid{-1};
+
+            steady_clock_t::time_point m_deadline{};
+
+            bool m_is_killed{};
+        };
+
+        /**
+         * @brief A forked worker and the pipe it reports ready on.
+         */
+        struct child_t {
+            pid_t m_pid{-1};
+
+            int m_ready_fd{-1};
+        };
+
+        /**
+         * @brief Forks every worker and waits for them to be ready.
+         *
+         * @return The number of ready workers.
+         */
+        std::size_t spawn_all() {
+            std::vector<std::optional<child_t>> children{};
+
+            children.reserve(m_slots.size());
+
+            // Every worker is forked before any is waited for, so they start in parallel
+            for (std::size_t i{}; i < m_slots.size(); i++)
+                children.emplace_back(spawn(i));
+
+            std::size_t ret{};
+
+            for (std::size_t i{}; i < m_slots.size(); i++) {
+                if (adopt(i, children[i]))
+                    ret++;
+            }
+
+            return ret;
+        }
+
+        void run() {
+            while (m_is_running.load(std::memory_order_acquire)) {
+                if (g_stop_requested) {
+                    CLUEAPI_LOG_INFO("Supervisor received a stop signal, stopping the workers");
+
+                    break;
+                }
+
+                if (g_reload_requested || m_reload_requested.exchange(false)) {
+                    g_reload_requested = 0;
+
+                    rolling_reload();
+                }
+
+                reap();
+
+                respawn();
+
+                kill_expired();
+
+                std::unique_lock lock{m_wake_mutex};
+
+                m_wake.wait_for(lock, k_poll_interval);
+            }
+
+            shutdown();
+
+            // A stop signal ends the supervisor on its own, `stop()` was not called
+            if (m_is_running.exchange(false, std::memory_order_acq_rel) && m_on_exit)
+                m_on_exit();
+        }
+
+        /**
+         * @brief Forks a worker.
+         *
+         * @return The worker, `std::nullopt` if it couldn't be forked.
+         */
+        [[nodiscard]] std::optional<child_t> spawn(std::size_t index) {
+            int fds[2]{-1, -1};
+
+            if (::pipe(fds) != 0) {
+                CLUEAPI_LOG_ERROR("Failed to create the pipe of worker {}: errno {}", index, errno);
+
+                return std::nullopt;
+            }
+
+            set_cloexec(fds[0]);
+
+            set_cloexec(fds[1]);
+
+            const auto parent = ::getpid();
+
+            const auto pid = ::fork();
+
+            if (pid < 0) {
+                CLUEAPI_LOG_ERROR("Failed to fork worker {}: errno {}", index, errno);
+
+                ::close(fds[0]);
+
+                ::close(fds[1]);
+
+                return std::nullopt;
+            }
+
+            if (pid == 0) {
+                ::close(fds[0]);
+
+                restore_handlers();
+
+#ifdef __linux__
+                // A worker doesn't outlive its supervisor
+                ::prctl(PR_SET_PDEATHSIG, SIGTERM);
+
+                if (::getppid() != parent)
+                    std::_Exit(EXIT_SUCCESS);
+#endif // __linux__
+
+                std::function<void()> ready = [fd = fds[1]]() mutable {
+                    if (fd < 0)
+                        return;
+
+                    const char byte{1};
+
+                    [[maybe_unused]] const auto written = ::write(fd, &byte, 1u);
+
+                    ::close(fd);
+
+                    fd = -1;
+                };
+
+                auto status = EXIT_FAILURE;
+
+                try {
+                    status = m_worker(index, ready);
+                } catch (...) {
+                    // ...
+                }
+
+                // The state inherited from the supervisor is not torn down
+                std::_Exit(status);
+            }
+
+            ::close(fds[1]);
+
+            return child_t{pid, fds[0]};
+        }
+
+        /**
+         * @brief Waits for a worker to report ready.
+         *
+         * @return `true` if it did before `prefork_t::m_ready_timeout`.
+         */
+        [[nodiscard]] bool await_ready(const child_t& child) const noexcept {
+            const auto deadline = steady_clock_t::now() + m_cfg.m_ready_timeout;
+
+            auto is_ready = false;
+
+            while (true) {
+                const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    deadline - steady_clock_t::now());
+
+                if (left.count() <= 0)
+                    break;
+
+                pollfd pfd{.fd = child.m_ready_fd, .events = POLLIN, .revents = 0};
+
+                const auto polled = ::poll(&pfd, 1u, static_cast<int>(left.count()));
+
+                if (polled < 0 && errno == EINTR)
+                    continue;
+
+                if (polled <= 0)
+                    break;
+
+                char byte{};
+
+                // A worker that fails before it's ready closes the pipe without writing to it
+                is_ready = ::read(child.m_ready_fd, &byte, 1u) == 1;
+
+                break;
+            }
+
+            ::close(child.m_ready_fd);
+
+            return is_ready;
+        }
+
+        /**
+         * @brief Makes a forked worker the worker of a slot once it is ready.
+         *
+         * @return `true` if the worker is ready, otherwise it is killed and the slot restarted
+         * later.
+         */
+        bool adopt(std::size_t index, const std::optional<child_t>& child) noexcept {
+            auto& slot = m_slots[index];
+
+            slot.m_pid = -1;
+
+            slot.m_restart_at = steady_clock_t::now() + m_cfg.m_restart_delay;
+
+            if (!child)
+                return false;
+
+            if (!await_ready(*child)) {
+                CLUEAPI_LOG_ERROR(
+                    "Worker {} (pid: {}) did not become ready, killing it", index, child->m_pid);
+
+                ::kill(child->m_pid, SIGKILL);
+
+                ::waitpid(child->m_pid, nullptr, 0);
+
+                return false;
+            }
+
+            slot.m_pid = child->m_pid;
+
+            m_workers.fetch_add(1u, std::memory_order_relaxed);
+
+            CLUEAPI_LOG_DEBUG("Worker {} is ready (pid: {})", index, child->m_pid);
+
+            return true;
+        }
+
+        /**
+         * @brief Collects the workers that exited, restarting the running ones later.
+         */
+        void reap() {
+            for (std::size_t i{}; i < m_slots.size(); i++) {
+                auto& slot = m_slots[i];
+
+                if (slot.m_pid <= 0)
+                    continue;
+
+                int status{};
+
+                if (::waitpid(slot.m_pid, &status, WNOHANG) != slot.m_pid)
+                    continue;
+
+                CLUEAPI_LOG_WARNING(
+                    "Worker {} (pid: {}) {}, restarting it in {}ms",
+
+                    i,
+                    slot.m_pid,
+                    describe_status(status),
+                    m_cfg.m_restart_delay.count());
+
+                slot.m_pid = -1;
+
+                slot.m_restart_at = steady_clock_t::now() + m_cfg.m_restart_delay;
+
+                m_workers.fetch_sub(1u, std::memory_order_relaxed);
+            }
+
+            std::erase_if(m_draining, [](const draining_t& draining) {
+                return ::waitpid(draining.m_pid, nullptr, WNOHANG) == draining.m_pid;
+            });
+        }
+
+        void respawn() {
+            const auto now = steady_clock_t::now();
+
+            for (std::size_t i{}; i < m_slots.size(); i++) {
+                const auto& slot = m_slots[i];
+
+                if (slot.m_pid > 0 || slot.m_restart_at > now)
+                    continue;
+
+                m_restarts.fetch_add(1u, std::memory_order_relaxed);
+
+                adopt(i, spawn(i));
+            }
+        }
+
+        void kill_expired() noexcept {
+            const auto now = steady_clock_t::now();
+
+            for (auto& draining : m_draining) {
+                if (draining.m_is_killed || draining.m_deadline > now)
+                    continue;
+
+                CLUEAPI_LOG_WARNING(
+                    "Stopped worker (pid: {}) is still running, killing it", draining.m_pid);
+
+                ::kill(draining.m_pid, SIGKILL);
+
+                draining.m_is_killed = true;
+            }
+        }
+
+        /**
+         * @brief Stops a worker, letting it finish its requests until its drain deadline.
+         */
+        void drain(pid_t pid) {
+            ::kill(pid, SIGTERM);
+
+            m_draining.push_back(draining_t{pid, steady_clock_t::now() + m_cfg.m_drain_timeout});
+        }
+
+        /**
+         * @brief Replaces the workers one by one, each stopped once its replacement is ready.
+         */
+        void rolling_reload() {
+            CLUEAPI_LOG_INFO("Reloading {} workers", m_slots.size());
+
+            for (std::size_t i{}; i < m_slots.size(); i++) {
+                auto& slot = m_slots[i];
+
+                // An exited worker is restarted with the new code anyway
+                if (slot.m_pid <= 0)
+                    continue;
+
+                const auto child = spawn(i);
+
+                if (!child || !await_ready(*child)) {
+                    if (child) {
+                        ::kill(child->m_pid, SIGKILL);
+
+                        ::waitpid(child->m_pid, nullptr, 0);
+                    }
+
+                    CLUEAPI_LOG_ERROR(
+                        "Replacement of worker {} did not become ready, reload aborted", i);
+
+                    return;
+                }
+
+                drain(std::exchange(slot.m_pid, child->m_pid));
+
+                CLUEAPI_LOG_DEBUG("Worker {} replaced (pid: {})", i, slot.m_pid);
+            }
+        }
+
+        /**
+         * @brief Stops every worker, killing those still running after the drain timeout.
+         */
+        void shutdown() noexcept {
+            try {
+                for (auto& slot : m_slots) {
+                    if (slot.m_pid > 0)
+                        drain(std::exchange(slot.m_pid, -1));
+                }
+            } catch (...) {
+                // ...
+            }
+
+            m_workers.store(0u, std::memory_order_relaxed);
+
+            while (!m_draining.empty()) {
+                std::erase_if(m_draining, [](const draining_t& draining) {
+                    return ::waitpid(draining.m_pid, nullptr, WNOHANG) == draining.m_pid;
+                });
+
+                kill_expired();
+
+                if (!m_draining.empty())
+                    std::this_thread::sleep_for(k_poll_interval);
+            }
+
+            CLUEAPI_LOG_DEBUG("Every worker process is stopped");
+        }
+
+       private:
+        cfg::cfg_t::prefork_t m_cfg;
+
+        worker_fn_t m_worker;
+
+        std::function<void()> m_on_exit;
+
+        std::vector<slot_t> m_slots;
+
+        std::vector<draining_t> m_draining;
+
+        std::atomic<bool> m_is_running{false};
+
+        std::atomic<bool> m_reload_requested{false};
+
+        std::atomic<std::size_t> m_workers{};
+
+        std::atomic<std::size_t> m_restarts{};
+
+        std::thread m_thread;
+
+        std::mutex m_wake_mutex;
+
+        std::condition_variable m_wake;
+    };
+
+    c_supervisor::c_supervisor(
+        cfg::cfg_t::prefork_t cfg, worker_fn_t worker, std::function<void()> on_exit)
+        : m_impl{std::make_unique<c_impl>(std::move(cfg), std::move(worker), std::move(on_exit))} {
+    }
+
+    c_supervisor::~c_supervisor() noexcept = default;
+
+    void c_supervisor::start() {
+        m_impl->start();
+    }
+
+    void c_supervisor::stop() noexcept {
+        m_impl->stop();
+    }
+
+    void c_supervisor::reload() noexcept {
+        m_impl->reload();
+    }
+
+    std::size_t c_supervisor::workers() const noexcept {
+        return m_impl->workers();
+    }
+
+    std::size_t c_supervisor::restarts() const noexcept {
+        return m_impl->restarts();
+    }
+} // namespace clueapi::server::detail
+
+#endif // _WIN32
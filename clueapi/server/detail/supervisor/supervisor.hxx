@@ -0,0 +1,124 @@
+/**
+ * @file supervisor.hxx
+ *
+ * @brief Defines the supervisor of the prefork mode, which forks the worker processes and keeps
+ * them running.
+ */
+
+#ifndef CLUEAPI_SERVER_DETAIL_SUPERVISOR_HXX
+#define CLUEAPI_SERVER_DETAIL_SUPERVISOR_HXX
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+#include "clueapi/cfg/cfg.hxx"
+
+#include "clueapi/shared/macros.hxx"
+
+namespace clueapi::server::detail {
+    /**
+     * @class c_supervisor
+     *
+     * @brief Forks the worker processes of the prefork mode and supervises them.
+     *
+     * @details Each worker runs `worker_fn_t` in a freshly forked child and exits with its
+     * result, never returning to the code that started the supervisor. A worker reports that it
+     * serves through the function it is given, so a reload only stops a worker once its
+     * replacement is listening. A background thread reaps the workers:
+     *
+     * - A worker that exits while the supervisor runs is restarted after
+     * `prefork_t::m_restart_delay`.
+     * - `reload()`, or `SIGHUP`, replaces the workers one by one, each stopped with `SIGTERM`
+     * once its replacement is ready.
+     * - `stop()`, or `SIGINT`, `SIGTERM` and `SIGQUIT`, stops every worker with `SIGTERM` and
+     * kills those still running after `prefork_t::m_drain_timeout`.
+     *
+     * The workers are forked from the supervisor thread, and on Linux they get `SIGTERM` once
+     * it ends (`PR_SET_PDEATHSIG`), so they never outlive their supervisor.
+     *
+     * @note POSIX only. A supervisor must be started before the process creates any other
+     * thread, and only one supervisor may run per process.
+     */
+    class c_supervisor {
+       public:
+        /**
+         * @brief The function a worker runs, with its index and the function that reports it
+         * ready. It returns the exit status of the worker.
+         */
+        using worker_fn_t = std::function<int(std::size_t, const std::function<void()>&)>;
+
+        /**
+         * @brief Constructs a supervisor, not forking until it is started.
+         *
+         * @param cfg The settings of the prefork mode.
+         * @param worker The function the workers run.
+         * @param on_exit Called on the supervisor thread once every worker is stopped after a
+         * stop signal.
+         */
+        c_supervisor(cfg::cfg_t::prefork_t cfg, worker_fn_t worker, std::function<void()> on_exit);
+
+        ~c_supervisor() noexcept;
+
+        // Copy constructor
+        CLUEAPI_INLINE c_supervisor(const c_supervisor&) = delete;
+
+        // Copy assignment operator
+        CLUEAPI_INLINE c_supervisor& operator=(const c_supervisor&) = delete;
+
+       public:
+        /**
+         * @brief Forks the workers, waits for them to be ready and starts the supervisor thread.
+         *
+         * @throws exceptions::exception_t If no worker became ready.
+         */
+        void start();
+
+        /**
+         * @brief Stops the workers and the supervisor thread.
+         *
+         * @details Blocks until every worker exited or was killed.
+         */
+        void stop() noexcept;
+
+        /**
+         * @brief Replaces the workers one by one with new ones.
+         *
+         * @note Returns at once, the supervisor thread carries it out.
+         */
+        void reload() noexcept;
+
+        /**
+         * @brief Gets the number of running workers.
+         *
+         * @return The number of workers, the stopping ones excluded.
+         */
+        [[nodiscard]] std::size_t workers() const noexcept;
+
+        /**
+         * @brief Gets the number of workers restarted after they exited unexpectedly.
+         *
+         * @return The number of restarts.
+         */
+        [[nodiscard]] std::size_t restarts() const noexcept;
+
+       private:
+        /**
+         * @class c_impl
+         *
+         * @brief The internal implementation of the `c_supervisor` class.
+         *
+         * @internal
+         */
+        class c_impl;
+
+        /**
+         * @brief The internal implementation of the `c_supervisor` class.
+         *
+         * @internal
+         */
+        std::unique_ptr<c_impl> m_impl;
+    };
+} // namespace clueapi::server::detail
+
+#endif // CLUEAPI_SERVER_DETAIL_SUPERVISOR_HXX
@@ -0,0 +1,1005 @@
+/**
+ * @file tls.cxx
+ *
+ * @brief Implements the TLS termination.
+ */
+
+#include "clueapi/server/detail/tls/tls.hxx"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/redirect_error.hpp>
+#include <boost/asio/ssl/context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/asio/write.hpp>
+
+#ifndef _WIN32
+#include <csignal>
+#include <ctime>
+
+#include <boost/asio/local/stream_protocol.hpp>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif // _WIN32
+
+#include <openssl/bio.h>
+#include <openssl/core_names.h>
+#include <openssl/crypto.h>
+#include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+#include <openssl/ssl.h>
+
+#include "clueapi/exceptions/exceptions.hxx"
+
+#include "clueapi/modules/macros.hxx"
+
+namespace clueapi::server::detail {
+    namespace {
+        /**
+         * @brief The size of the name of a ticket key, which tells the keys apart.
+         */
+        inline constexpr std::size_t k_key_name_size{16u};
+
+        /**
+         * @brief The size of the AES-256 and HMAC-SHA256 keys of a ticket key.
+         */
+        inline constexpr std::size_t k_key_size{32u};
+
+        /**
+         * @brief The keys a period encrypts and authenticates its tickets with.
+         */
+        struct ticket_key_t {
+            std::array<unsigned char, k_key_name_size> m_name{};
+
+            std::array<unsigned char, k_key_size> m_aes{};
+
+            std::array<unsigned char, k_key_size> m_hmac{};
+        };
+
+        /**
+         * @brief The size of the buffers of a session served in user space, the largest payload
+         * of a record.
+         */
+        inline constexpr std::size_t k_record_size{16384u};
+
+        struct ssl_deleter_t {
+            void operator()(SSL* ssl) const noexcept {
+                SSL_free(ssl);
+            }
+        };
+
+        using ssl_ptr_t = std::unique_ptr<SSL, ssl_deleter_t>;
+
+        [[nodiscard]] int to_openssl(cfg::cfg_t::tls_t::e_version version) noexcept {
+            return version == cfg::cfg_t::tls_t::e_version::tls13 ? TLS1_3_VERSION
+                                                                   : TLS1_2_VERSION;
+        }
+
+        /**
+         * @brief Gets the index of the `SSL_CTX` data that holds the implementation.
+         *
+         * @note The app data of the context is asio's own.
+         */
+        [[nodiscard]] int impl_index() noexcept {
+            static const auto index =
+                SSL_CTX_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+
+            return index;
+        }
+
+        /**
+         * @brief Gets the reason of the last OpenSSL error, clearing the queue.
+         */
+        [[nodiscard]] std::string last_error() {
+            std::array<char, 256> buf{};
+
+            const auto code = ERR_get_error();
+
+            ERR_clear_error();
+
+            if (!code)
+                return "unknown error";
+
+            ERR_error_string_n(code, buf.data(), buf.size());
+
+            return buf.data();
+        }
+
+        /**
+         * @brief Checks if the kernel can encrypt the records of a cipher.
+         */
+        [[nodiscard]] bool is_offloadable(const SSL_CIPHER* cipher) noexcept {
+            switch (SSL_CIPHER_get_cipher_nid(cipher)) {
+                case NID_aes_128_gcm:
+                case NID_aes_256_gcm:
+                case NID_aes_128_ccm:
+                case NID_chacha20_poly1305:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        /**
+         * @brief Checks if the kernel has the `tls` module, attaching it to a loopback
+         * connection.
+         *
+         * @note The module can only be attached to a connected socket.
+         */
+        [[nodiscard]] bool has_ktls() noexcept {
+#if defined(SSL_OP_ENABLE_KTLS) && defined(TCP_ULP)
+            const auto close_fd = [](int fd) {
+                if (fd >= 0)
+                    ::close(fd);
+            };
+
+            const auto listener = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+            const auto client = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+            sockaddr_in addr{};
+
+            addr.sin_family = AF_INET;
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+            auto addr_size = static_cast<socklen_t>(sizeof(addr));
+
+            auto* sockaddr_ptr = reinterpret_cast<sockaddr*>(&addr);
+
+            auto ret = false;
+
+            if (listener >= 0 && client >= 0 && ::bind(listener, sockaddr_ptr, addr_size) == 0 &&
+                ::listen(listener, 1) == 0 &&
+                ::getsockname(listener, sockaddr_ptr, &addr_size) == 0 &&
+                ::connect(client, sockaddr_ptr, addr_size) == 0) {
+                const auto peer = ::accept(listener, nullptr, nullptr);
+
+                ret = ::setsockopt(client, SOL_TCP, TCP_ULP, "tls", sizeof("tls")) == 0;
+
+                close_fd(peer);
+            }
+
+            close_fd(client);
+
+            close_fd(listener);
+
+            return ret;
+#else
+            return false;
+#endif // SSL_OP_ENABLE_KTLS && TCP_ULP
+        }
+
+#ifndef _WIN32
+        /**
+         * @brief Keeps the writes of OpenSSL to a closed socket from raising `SIGPIPE`.
+         *
+         * @details asio sends with `MSG_NOSIGNAL`, but OpenSSL writes with `write(2)`. The
+         * signal is blocked on the thread while the guard lives, and a `SIGPIPE` raised in the
+         * meantime is taken off the thread before it is unblocked.
+         */
+        struct sigpipe_guard_t {
+            sigpipe_guard_t() noexcept {
+                sigemptyset(&m_set);
+
+                sigaddset(&m_set, SIGPIPE);
+
+                sigset_t pending{};
+
+                sigpending(&pending);
+
+                m_was_pending = sigismember(&pending, SIGPIPE) == 1;
+
+                m_is_blocked = pthread_sigmask(SIG_BLOCK, &m_set, &m_old) == 0;
+            }
+
+            ~sigpipe_guard_t() noexcept {
+                if (!m_is_blocked)
+                    return;
+
+                sigset_t pending{};
+
+                sigpending(&pending);
+
+                if (!m_was_pending && sigismember(&pending, SIGPIPE) == 1) {
+                    const timespec no_wait{};
+
+                    sigtimedwait(&m_set, nullptr, &no_wait);
+                }
+
+                pthread_sigmask(SIG_SETMASK, &m_old, nullptr);
+            }
+
+            sigset_t m_set{};
+
+            sigset_t m_old{};
+
+            bool m_was_pending{};
+
+            bool m_is_blocked{};
+        };
+#endif // _WIN32
+
+        /**
+         * @brief The deadline of a handshake, which cancels the waits on its socket once it
+         * expires.
+         *
+         * @details Shared with the handler of the timer, which may run after the handshake is
+         * over and only touches the socket while it is set.
+         */
+        struct deadline_t {
+            explicit deadline_t(const boost::asio::any_io_executor& executor) : m_timer{executor} {
+            }
+
+            boost::asio::steady_timer m_timer;
+
+            boost::asio::ip::tcp::socket* m_socket{};
+
+            bool m_is_expired{};
+        };
+
+#ifndef _WIN32
+        /**
+         * @brief A session served in user space, between the peer and the end of the socket
+         * pair the connection doesn't hold.
+         *
+         * @details Shared by its two directions, it closes once both are over.
+         */
+        struct relay_t {
+            relay_t(
+                boost::asio::ip::tcp::socket&& socket,
+                boost::asio::local::stream_protocol::socket&& local,
+                ssl_ptr_t ssl) noexcept
+                : m_socket{std::move(socket)}, m_local{std::move(local)}, m_ssl{std::move(ssl)} {
+            }
+
+            /**
+             * @brief The socket of the peer, which OpenSSL reads and writes.
+             */
+            boost::asio::ip::tcp::socket m_socket;
+
+            /**
+             * @brief The end of the socket pair the plain bytes go through.
+             */
+            boost::asio::local::stream_protocol::socket m_local;
+
+            ssl_ptr_t m_ssl;
+
+            std::array<char, k_record_size> m_decrypted{};
+
+            std::array<char, k_record_size> m_plain{};
+        };
+
+        /**
+         * @brief Waits on the socket of the peer for what OpenSSL asked for.
+         *
+         * @return `false` if the session can't go on.
+         */
+        shared::awaitable_t<bool> wait_for(relay_t& relay, int rc) {
+            const auto error = SSL_get_error(relay.m_ssl.get(), rc);
+
+            if (error != SSL_ERROR_WANT_READ && error != SSL_ERROR_WANT_WRITE)
+                co_return false;
+
+            boost::system::error_code ec{};
+
+            co_await relay.m_socket.async_wait(
+                error == SSL_ERROR_WANT_READ ? boost::asio::ip::tcp::socket::wait_read
+                                             : boost::asio::ip::tcp::socket::wait_write,
+
+                boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+
+            co_return !ec;
+        }
+
+        /**
+         * @brief Decrypts the records of the peer to the connection, until the peer closes the
+         * session.
+         */
+        shared::awaitable_t<void> decrypt(std::shared_ptr<relay_t> relay) {
+            boost::system::error_code ec{};
+
+            while (true) {
+                ERR_clear_error();
+
+                std::size_t size{};
+
+                auto rc = 0;
+
+                {
+                    // A read may answer the peer, a `KeyUpdate` for one
+                    sigpipe_guard_t guard{};
+
+                    rc = SSL_read_ex(
+                        relay->m_ssl.get(),
+                        relay->m_decrypted.data(),
+                        relay->m_decrypted.size(),
+                        &size);
+                }
+
+                if (rc != 1) {
+                    if (!co_await wait_for(*relay, rc))
+                        break;
+
+                    continue;
+                }
+
+                co_await boost::asio::async_write(
+                    relay->m_local,
+                    boost::asio::buffer(relay->m_decrypted.data(), size),
+                    boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+
+                if (ec)
+                    break;
+            }
+
+            // The connection reads the end of its stream
+            relay->m_local.shutdown(boost::asio::local::stream_protocol::socket::shutdown_send, ec);
+        }
+
+        /**
+         * @brief Encrypts the bytes of the connection to the peer, until the connection closes
+         * its end.
+         */
+        shared::awaitable_t<void> encrypt(std::shared_ptr<relay_t> relay) {
+            boost::system::error_code ec{};
+
+            auto is_broken = false;
+
+            while (!is_broken) {
+                const auto size = co_await relay->m_local.async_read_some(
+                    boost::asio::buffer(relay->m_plain),
+                    boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+
+                if (ec)
+                    break;
+
+                std::size_t offset{};
+
+                // A write that would block is retried with the same bytes, as OpenSSL wants
+                while (offset < size) {
+                    ERR_clear_error();
+
+                    std::size_t written{};
+
+                    auto rc = 0;
+
+                    {
+                        sigpipe_guard_t guard{};
+
+                        rc = SSL_write_ex(
+                            relay->m_ssl.get(),
+                            relay->m_plain.data() + offset,
+                            size - offset,
+                            &written);
+                    }
+
+                    if (rc == 1)
+                        offset += written;
+                    else if (!co_await wait_for(*relay, rc)) {
+                        is_broken = true;
+
+                        break;
+                    }
+                }
+            }
+
+            // The connection is done with the session, which ends with a `close_notify`
+            if (!is_broken) {
+                sigpipe_guard_t guard{};
+
+                SSL_shutdown(relay->m_ssl.get());
+            }
+
+            relay->m_socket.shutdown(boost::asio::ip::tcp::socket::shutdown_send, ec);
+
+            // Cancels the decryption, whose peer may never close
+            relay->m_socket.close(ec);
+
+            relay->m_local.close(ec);
+        }
+#endif // _WIN32
+    } // namespace
+
+    class c_tls::c_impl {
+       public:
+        explicit c_impl(cfg::cfg_t::tls_t cfg)
+            : m_cfg{std::move(cfg)}, m_ctx{boost::asio::ssl::context::tls_server} {
+        }
+
+       public:
+        void start() {
+            auto* ctx = m_ctx.native_handle();
+
+            boost::system::error_code ec{};
+
+            m_ctx.use_certificate_chain_file(m_cfg.m_cert_file, ec);
+
+            if (ec)
+                throw exceptions::exception_t(
+                    "Failed to load the TLS certificate '{}': {}",
+
+                    m_cfg.m_cert_file,
+                    ec.message());
+
+            m_ctx.use_private_key_file(m_cfg.m_key_file, boost::asio::ssl::context::pem, ec);
+
+            if (ec)
+                throw exceptions::exception_t(
+                    "Failed to load the TLS key '{}': {}",
+
+                    m_cfg.m_key_file,
+                    ec.message());
+
+            if (SSL_CTX_check_private_key(ctx) != 1)
+                throw exceptions::exception_t(
+                    "The TLS key '{}' doesn't match the certificate", m_cfg.m_key_file);
+
+            if (SSL_CTX_set_min_proto_version(ctx, to_openssl(m_cfg.m_min_version)) != 1 ||
+                SSL_CTX_set_max_proto_version(ctx, to_openssl(m_cfg.m_max_version)) != 1)
+                throw exceptions::exception_t("Invalid TLS versions: {}", last_error());
+
+            if (!m_cfg.m_ciphers.empty() &&
+                SSL_CTX_set_cipher_list(ctx, m_cfg.m_ciphers.c_str()) != 1)
+                throw exceptions::exception_t("Invalid TLS 1.2 ciphers: {}", last_error());
+
+            if (!m_cfg.m_ciphersuites.empty() &&
+                SSL_CTX_set_ciphersuites(ctx, m_cfg.m_ciphersuites.c_str()) != 1)
+                throw exceptions::exception_t("Invalid TLS 1.3 cipher suites: {}", last_error());
+
+            init_ktls(ctx);
+
+            auto options = SSL_OP_CIPHER_SERVER_PREFERENCE | SSL_OP_NO_RENEGOTIATION;
+
+#ifdef SSL_OP_ENABLE_KTLS
+            options |= SSL_OP_ENABLE_KTLS;
+#endif // SSL_OP_ENABLE_KTLS
+
+            if (!m_cfg.m_session_tickets)
+                options |= SSL_OP_NO_TICKET;
+
+            SSL_CTX_set_options(ctx, options);
+
+            // Reading ahead would pull the first records of the session into OpenSSL's buffer,
+            // where the kernel can't decrypt them
+            SSL_CTX_set_read_ahead(ctx, 0);
+
+            SSL_CTX_set_ex_data(ctx, impl_index(), this);
+
+            init_alpn(ctx);
+
+            if (m_cfg.m_session_tickets)
+                init_tickets(ctx);
+        }
+
+        shared::awaitable_t<handshake_t> handshake(boost::asio::ip::tcp::socket& socket) {
+            const auto was_non_blocking = socket.native_non_blocking();
+
+            std::shared_ptr<deadline_t> deadline{};
+
+            if (m_cfg.m_handshake_timeout.count() > 0) {
+                deadline = std::make_shared<deadline_t>(socket.get_executor());
+
+                deadline->m_socket = &socket;
+
+                deadline->m_timer.expires_after(m_cfg.m_handshake_timeout);
+
+                deadline->m_timer.async_wait([deadline](const boost::system::error_code& ec) {
+                    if (ec || !deadline->m_socket)
+                        return;
+
+                    deadline->m_is_expired = true;
+
+                    boost::system::error_code ignored{};
+
+                    deadline->m_socket->cancel(ignored);
+                });
+            }
+
+            ssl_ptr_t ssl{};
+
+            auto ret = co_await run_handshake(socket, ssl);
+
+            if (deadline) {
+                deadline->m_socket = nullptr;
+
+                deadline->m_timer.cancel();
+
+                if (deadline->m_is_expired)
+                    ret = handshake_t{};
+            }
+
+            if (ret.m_status == e_status::not_offloaded && !m_cfg.m_require_ktls)
+                ret.m_status = serve_in_user_space(socket, std::move(ssl)) ? e_status::user_space
+                                                                            : e_status::failed;
+
+            // Only OpenSSL needed the socket in non-blocking mode, asio manages it on its own
+            if (ret.m_status != e_status::user_space) {
+                boost::system::error_code ec{};
+
+                socket.native_non_blocking(was_non_blocking, ec);
+            }
+
+            co_return count(std::move(ret));
+        }
+
+        [[nodiscard]] std::uint64_t handshakes() const noexcept {
+            return m_handshakes.load(std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] std::uint64_t resumed() const noexcept {
+            return m_resumed.load(std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] std::uint64_t failed() const noexcept {
+            return m_failed.load(std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] std::uint64_t not_offloaded() const noexcept {
+            return m_not_offloaded.load(std::memory_order_relaxed);
+        }
+
+       private:
+        /**
+         * @brief Counts the result of a handshake.
+         *
+         * @return The result.
+         */
+        handshake_t count(handshake_t ret) noexcept {
+            switch (ret.m_status) {
+                case e_status::offloaded:
+                    m_handshakes.fetch_add(1u, std::memory_order_relaxed);
+
+                    break;
+                case e_status::user_space:
+                case e_status::not_offloaded:
+                    m_handshakes.fetch_add(1u, std::memory_order_relaxed);
+
+                    m_not_offloaded.fetch_add(1u, std::memory_order_relaxed);
+
+                    break;
+                default:
+                    m_failed.fetch_add(1u, std::memory_order_relaxed);
+
+                    break;
+            }
+
+            if (ret.m_resumed)
+                m_resumed.fetch_add(1u, std::memory_order_relaxed);
+
+            return ret;
+        }
+
+        /**
+         * @brief Runs the handshake in OpenSSL, keeping the session in `ssl`.
+         */
+        shared::awaitable_t<handshake_t> run_handshake(
+            boost::asio::ip::tcp::socket& socket, ssl_ptr_t& ssl) {
+            handshake_t ret{};
+
+            boost::system::error_code ec{};
+
+            // OpenSSL reads and writes the socket itself and reports when it would block
+            socket.native_non_blocking(true, ec);
+
+            if (ec)
+                co_return ret;
+
+            ssl.reset(SSL_new(m_ctx.native_handle()));
+
+            if (!ssl || SSL_set_fd(ssl.get(), static_cast<int>(socket.native_handle())) != 1)
+                co_return ret;
+
+            SSL_set_accept_state(ssl.get());
+
+            while (true) {
+                ERR_clear_error();
+
+                auto rc = 0;
+
+                {
+#ifndef _WIN32
+                    sigpipe_guard_t guard{};
+#endif // _WIN32
+
+                    rc = SSL_do_handshake(ssl.get());
+                }
+
+                if (rc == 1)
+                    break;
+
+                const auto error = SSL_get_error(ssl.get(), rc);
+
+                if (error != SSL_ERROR_WANT_READ && error != SSL_ERROR_WANT_WRITE) {
+                    CLUEAPI_LOG_TRACE(
+                        "TLS handshake failed (id: {}): {}",
+
+                        socket.native_handle(),
+                        last_error());
+
+                    co_return ret;
+                }
+
+                co_await socket.async_wait(
+                    error == SSL_ERROR_WANT_READ ? boost::asio::ip::tcp::socket::wait_read
+                                                 : boost::asio::ip::tcp::socket::wait_write,
+
+                    boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+
+                if (ec)
+                    co_return ret;
+            }
+
+            ret.m_resumed = SSL_session_reused(ssl.get()) == 1;
+
+            const unsigned char* alpn{};
+
+            unsigned int alpn_size{};
+
+            SSL_get0_alpn_selected(ssl.get(), &alpn, &alpn_size);
+
+            if (alpn)
+                ret.m_alpn.assign(reinterpret_cast<const char*>(alpn), alpn_size);
+
+            // The socket is only usable as is if the kernel holds both directions and OpenSSL
+            // holds no decrypted byte of the session
+            const auto is_offloaded = BIO_get_ktls_send(SSL_get_wbio(ssl.get())) &&
+                                      BIO_get_ktls_recv(SSL_get_rbio(ssl.get())) &&
+                                      !SSL_has_pending(ssl.get());
+
+            ret.m_status = is_offloaded ? e_status::offloaded : e_status::not_offloaded;
+
+            // The socket BIO doesn't own the socket, freeing the session leaves it open
+            co_return ret;
+        }
+
+        /**
+         * @brief Gives the connection one end of a socket pair in place of its socket, and
+         * serves the session between the other end and the peer.
+         *
+         * @return `false` if the socket pair couldn't be set up, the socket is left as is.
+         */
+        [[nodiscard]] static bool serve_in_user_space(
+            boost::asio::ip::tcp::socket& socket, ssl_ptr_t ssl) {
+#ifndef _WIN32
+            std::array<int, 2> fds{};
+
+            if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds.data()) != 0)
+                return false;
+
+            const auto executor = socket.get_executor();
+
+            boost::asio::local::stream_protocol::socket local{executor};
+
+            boost::asio::ip::tcp::socket connection{executor};
+
+            boost::system::error_code ec{};
+
+            local.assign(boost::asio::local::stream_protocol{}, fds[0], ec);
+
+            if (ec) {
+                ::close(fds[0]);
+                ::close(fds[1]);
+
+                return false;
+            }
+
+            // The connection only reads, writes and shuts the socket down, which a socket pair
+            // does like a TCP socket, `sendfile(2)` included
+            connection.assign(boost::asio::ip::tcp::v4(), fds[1], ec);
+
+            if (ec) {
+                ::close(fds[1]);
+
+                return false;
+            }
+
+            auto relay =
+                std::make_shared<relay_t>(std::move(socket), std::move(local), std::move(ssl));
+
+            socket = std::move(connection);
+
+            boost::asio::co_spawn(executor, decrypt(relay), boost::asio::detached);
+
+            boost::asio::co_spawn(executor, encrypt(std::move(relay)), boost::asio::detached);
+
+            return true;
+#else
+            return false;
+#endif // _WIN32
+        }
+
+        /**
+         * @brief Checks that the sessions can be offloaded, failing when they have to be.
+         */
+        void init_ktls(SSL_CTX* ctx) const {
+            if (!has_ktls()) {
+                if (m_cfg.m_require_ktls)
+                    throw exceptions::exception_t(
+                        "kTLS is required, but OpenSSL or the kernel can't offload sessions. "
+                        "Is the `tls` module of Linux loaded?");
+
+                CLUEAPI_LOG_WARNING(
+                    "kTLS isn't available, the TLS sessions are served in user space");
+
+                return;
+            }
+
+            if (!m_cfg.m_require_ktls)
+                return;
+
+            const auto* ciphers = SSL_CTX_get_ciphers(ctx);
+
+            for (auto i = 0; i < sk_SSL_CIPHER_num(ciphers); i++) {
+                const auto* cipher = sk_SSL_CIPHER_value(ciphers, i);
+
+                if (!is_offloadable(cipher))
+                    throw exceptions::exception_t(
+                        "kTLS is required, but the TLS cipher '{}' can't be offloaded",
+                        SSL_CIPHER_get_name(cipher));
+            }
+        }
+
+        void init_alpn(SSL_CTX* ctx) {
+            m_alpn.clear();
+
+            for (const auto& protocol : m_cfg.m_alpn) {
+                if (protocol.empty() || protocol.size() > 255u)
+                    throw exceptions::exception_t("Invalid ALPN protocol '{}'", protocol);
+
+                m_alpn.push_back(static_cast<unsigned char>(protocol.size()));
+
+                m_alpn.insert(m_alpn.end(), protocol.begin(), protocol.end());
+            }
+
+            if (m_alpn.empty())
+                return;
+
+            SSL_CTX_set_alpn_select_cb(ctx, &c_impl::on_alpn, this);
+        }
+
+        void init_tickets(SSL_CTX* ctx) {
+            if (m_cfg.m_ticket_secret.empty())
+                m_cfg.m_ticket_secret = c_tls::make_ticket_secret();
+
+            if (m_cfg.m_ticket_rotation.count() <= 0)
+                m_cfg.m_ticket_rotation = std::chrono::hours{1};
+
+            if (SSL_CTX_set_tlsext_ticket_key_evp_cb(ctx, &c_impl::on_ticket_key) != 1)
+                throw exceptions::exception_t("Failed to set the ticket key callback");
+        }
+
+        /**
+         * @brief Derives the ticket key of a period from the secret.
+         */
+        [[nodiscard]] bool derive_key(std::int64_t period, ticket_key_t& key) const noexcept {
+            const auto derive = [&](std::string_view label, unsigned char* out, std::size_t size) {
+                std::array<unsigned char, 64> data{};
+
+                std::memcpy(data.data(), label.data(), label.size());
+
+                // The period in big-endian, so that every platform derives the same keys
+                for (std::size_t i{}; i < sizeof(period); i++)
+                    data[label.size() + i] = static_cast<unsigned char>(
+                        static_cast<std::uint64_t>(period) >> (8u * (sizeof(period) - 1u - i)));
+
+                std::array<unsigned char, EVP_MAX_MD_SIZE> digest{};
+
+                std::size_t digest_size{};
+
+                if (!EVP_Q_mac(
+                        nullptr,
+                        "HMAC",
+                        nullptr,
+                        "SHA256",
+                        nullptr,
+                        m_cfg.m_ticket_secret.data(),
+                        m_cfg.m_ticket_secret.size(),
+                        data.data(),
+                        label.size() + sizeof(period),
+                        digest.data(),
+                        digest.size(),
+                        &digest_size) ||
+                    digest_size < size)
+                    return false;
+
+                std::memcpy(out, digest.data(), size);
+
+                OPENSSL_cleanse(digest.data(), digest.size());
+
+                return true;
+            };
+
+            return derive("clueapi ticket name", key.m_name.data(), key.m_name.size()) &&
+                   derive("clueapi ticket aes", key.m_aes.data(), key.m_aes.size()) &&
+                   derive("clueapi ticket hmac", key.m_hmac.data(), key.m_hmac.size());
+        }
+
+        /**
+         * @brief Gets the period of the rotation the wall clock is in.
+         *
+         * @note The wall clock, unlike a steady one, agrees across processes and servers.
+         */
+        [[nodiscard]] std::int64_t current_period() const noexcept {
+            const auto now = std::chrono::duration_cast<std::chrono::seconds>(
+                std::chrono::system_clock::now().time_since_epoch());
+
+            return now.count() / m_cfg.m_ticket_rotation.count();
+        }
+
+        /**
+         * @brief Sets the keys of a ticket, see `SSL_CTX_set_tlsext_ticket_key_evp_cb`.
+         *
+         * @return 1 if the ticket is valid, 2 if it is valid but should be renewed, 0 if its
+         * key is unknown and -1 on errors.
+         */
+        static int on_ticket_key(
+            SSL* ssl,
+            unsigned char* key_name,
+            unsigned char* iv,
+            EVP_CIPHER_CTX* cipher_ctx,
+            EVP_MAC_CTX* mac_ctx,
+            int enc) {
+            const auto* self = static_cast<const c_impl*>(
+                SSL_CTX_get_ex_data(SSL_get_SSL_CTX(ssl), impl_index()));
+
+            if (!self)
+                return -1;
+
+            const auto period = self->current_period();
+
+            ticket_key_t key{};
+
+            auto ret = 1;
+
+            if (enc) {
+                if (!self->derive_key(period, key) || RAND_bytes(iv, EVP_MAX_IV_LENGTH) != 1)
+                    return -1;
+
+                std::memcpy(key_name, key.m_name.data(), key.m_name.size());
+
+                if (EVP_EncryptInit_ex(
+                        cipher_ctx, EVP_aes_256_cbc(), nullptr, key.m_aes.data(), iv) != 1)
+                    return -1;
+            } else {
+                // A ticket of the previous period is still accepted, and one of the next in case
+                // the clock of the server that issued it is ahead
+                const std::array<std::int64_t, 3> periods{period, period - 1, period + 1};
+
+                const auto it = std::find_if(periods.begin(), periods.end(), [&](auto candidate) {
+                    return self->derive_key(candidate, key) &&
+                           std::memcmp(key_name, key.m_name.data(), key.m_name.size()) == 0;
+                });
+
+                if (it == periods.end())
+                    return 0;
+
+                if (*it != period)
+                    ret = 2;
+
+                if (EVP_DecryptInit_ex(
+                        cipher_ctx, EVP_aes_256_cbc(), nullptr, key.m_aes.data(), iv) != 1)
+                    return -1;
+            }
+
+            std::array<OSSL_PARAM, 3> params{
+                OSSL_PARAM_construct_octet_string(
+                    OSSL_MAC_PARAM_KEY, key.m_hmac.data(), key.m_hmac.size()),
+                OSSL_PARAM_construct_utf8_string(
+                    OSSL_MAC_PARAM_DIGEST, const_cast<char*>("SHA256"), 0u),
+                OSSL_PARAM_construct_end()};
+
+            const auto is_set = EVP_MAC_CTX_set_params(mac_ctx, params.data()) == 1;
+
+            OPENSSL_cleanse(&key, sizeof(key));
+
+            return is_set ? ret : -1;
+        }
+
+        /**
+         * @brief Selects the protocol of a connection among the ones the client offers.
+         */
+        static int on_alpn(
+            SSL*,
+            const unsigned char** out,
+            unsigned char* out_size,
+            const unsigned char* in,
+            unsigned int in_size,
+            void* arg) {
+            const auto* self = static_cast<const c_impl*>(arg);
+
+            auto* selected = const_cast<unsigned char*>(in);
+
+            // The server list goes first, so that its preference wins
+            const auto rc = SSL_select_next_proto(
+                &selected,
+                out_size,
+                self->m_alpn.data(),
+                static_cast<unsigned int>(self->m_alpn.size()),
+                in,
+                in_size);
+
+            if (rc != OPENSSL_NPN_NEGOTIATED)
+                return SSL_TLSEXT_ERR_NOACK;
+
+            *out = selected;
+
+            return SSL_TLSEXT_ERR_OK;
+        }
+
+       private:
+        cfg::cfg_t::tls_t m_cfg;
+
+        boost::asio::ssl::context m_ctx;
+
+        /**
+         * @brief The ALPN protocols of the server, in wire format.
+         */
+        std::vector<unsigned char> m_alpn;
+
+        std::atomic<std::uint64_t> m_handshakes{};
+
+        std::atomic<std::uint64_t> m_resumed{};
+
+        std::atomic<std::uint64_t> m_failed{};
+
+        std::atomic<std::uint64_t> m_not_offloaded{};
+    };
+
+    c_tls::c_tls(cfg::cfg_t::tls_t cfg) : m_impl{std::make_unique<c_impl>(std::move(cfg))} {
+    }
+
+    c_tls::~c_tls() noexcept = default;
+
+    void c_tls::start() {
+        m_impl->start();
+    }
+
+    shared::awaitable_t<c_tls::handshake_t> c_tls::handshake(
+        boost::asio::ip::tcp::socket& socket) {
+        return m_impl->handshake(socket);
+    }
+
+    std::string c_tls::make_ticket_secret() {
+        std::string ret(32u, '\0');
+
+        auto* data = reinterpret_cast<unsigned char*>(ret.data());
+
+        if (RAND_bytes(data, static_cast<int>(ret.size())) != 1)
+            throw exceptions::exception_t("Failed to generate the ticket secret");
+
+        return ret;
+    }
+
+    std::uint64_t c_tls::handshakes() const noexcept {
+        return m_impl->handshakes();
+    }
+
+    std::uint64_t c_tls::resumed() const noexcept {
+        return m_impl->resumed();
+    }
+
+    std::uint64_t c_tls::failed() const noexcept {
+        return m_impl->failed();
+    }
+
+    std::uint64_t c_tls::not_offloaded() const noexcept {
+        return m_impl->not_offloaded();
+    }
+} // namespace clueapi::server::detail
@@ -0,0 +1,182 @@
+/**
+ * @file tls.hxx
+ *
+ * @brief Defines the TLS termination, which runs the handshakes of the connections and hands
+ * their sessions to the kernel.
+ */
+
+#ifndef CLUEAPI_SERVER_DETAIL_TLS_HXX
+#define CLUEAPI_SERVER_DETAIL_TLS_HXX
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <boost/asio/ip/tcp.hpp>
+
+#include "clueapi/cfg/cfg.hxx"
+
+#include "clueapi/shared/macros.hxx"
+#include "clueapi/shared/shared.hxx"
+
+namespace clueapi::server::detail {
+    /**
+     * @class c_tls
+     *
+     * @brief Runs the TLS handshakes of the accepted connections.
+     *
+     * @details The handshake runs in OpenSSL straight on the socket, which kTLS needs, and the
+     * socket is only waited on through asio. Once it succeeds the kernel holds the keys of the
+     * session, and the connection goes on with the plain socket: the reads, the vectored writes
+     * and `sendfile(2)` are encrypted by the kernel.
+     *
+     * A session the kernel doesn't take in both directions is, unless `tls_t::m_require_ktls`
+     * is set, served by OpenSSL in user space: the connection is given one end of a socket pair
+     * in place of its socket, and the records are encrypted and decrypted between the other end
+     * and the peer. A direction the kernel did take stays in the kernel.
+     *
+     * A record the kernel receives that isn't application data, a `close_notify` alert or a TLS
+     * 1.3 `KeyUpdate`, fails the reads of an offloaded socket with `EIO`, which closes the
+     * connection. The peer is done with it after a `close_notify`; a client that updates its
+     * keys has to reconnect. The sessions served in user space handle both.
+     *
+     * The keys of the session tickets are derived from `tls_t::m_ticket_secret` and the period
+     * of `tls_t::m_ticket_rotation` the clock is in. Every instance given the same secret, in
+     * any worker or process, resumes the sessions of the others.
+     *
+     * @note `handshake()` is thread-safe.
+     */
+    class c_tls {
+       public:
+        /**
+         * @enum e_status
+         *
+         * @brief The outcome of a handshake.
+         */
+        enum struct e_status : std::uint8_t {
+            /**
+             * @brief The session is secured and the kernel encrypts and decrypts its records.
+             */
+            offloaded,
+
+            /**
+             * @brief The session is secured, but the kernel didn't take it in both directions.
+             * The socket was replaced by one end of a socket pair and the session is served in
+             * user space.
+             */
+            user_space,
+
+            /**
+             * @brief The session is secured, but the kernel didn't take it in both directions
+             * and `tls_t::m_require_ktls` is set. The socket can't be used as is.
+             */
+            not_offloaded,
+
+            /**
+             * @brief The handshake failed or timed out.
+             */
+            failed
+        };
+
+        /**
+         * @struct handshake_t
+         *
+         * @brief The result of a handshake.
+         */
+        struct handshake_t {
+            e_status m_status{e_status::failed};
+
+            /**
+             * @brief If true, the session was resumed from a ticket.
+             */
+            bool m_resumed{false};
+
+            /**
+             * @brief The protocol selected by ALPN, empty if the client offered none of ours.
+             */
+            std::string m_alpn{};
+        };
+
+        /**
+         * @brief Constructs the TLS termination, not loading anything until it is started.
+         *
+         * @param cfg The settings of the TLS termination.
+         */
+        explicit c_tls(cfg::cfg_t::tls_t cfg);
+
+        ~c_tls() noexcept;
+
+        // Copy constructor
+        CLUEAPI_INLINE c_tls(const c_tls&) = delete;
+
+        // Copy assignment operator
+        CLUEAPI_INLINE c_tls& operator=(const c_tls&) = delete;
+
+       public:
+        /**
+         * @brief Loads the certificate and the key and sets up the context.
+         *
+         * @throws exceptions::exception_t If the certificate, the key or the ciphers are
+         * invalid, or if `tls_t::m_require_ktls` is set and kTLS isn't available or a cipher
+         * can't be offloaded.
+         */
+        void start();
+
+        /**
+         * @brief Runs the handshake of a connection.
+         *
+         * @param socket The accepted socket, replaced when the session is served in user space.
+         *
+         * @return An awaitable that resolves to the result of the handshake.
+         */
+        shared::awaitable_t<handshake_t> handshake(boost::asio::ip::tcp::socket& socket);
+
+        /**
+         * @brief Makes a random secret for the session tickets.
+         *
+         * @return The secret.
+         */
+        [[nodiscard]] static std::string make_ticket_secret();
+
+       public:
+        /**
+         * @brief Gets the number of handshakes that secured a session.
+         */
+        [[nodiscard]] std::uint64_t handshakes() const noexcept;
+
+        /**
+         * @brief Gets the number of sessions resumed from a ticket.
+         */
+        [[nodiscard]] std::uint64_t resumed() const noexcept;
+
+        /**
+         * @brief Gets the number of handshakes that failed or timed out.
+         */
+        [[nodiscard]] std::uint64_t failed() const noexcept;
+
+        /**
+         * @brief Gets the number of sessions the kernel didn't take, served in user space or
+         * not.
+         */
+        [[nodiscard]] std::uint64_t not_offloaded() const noexcept;
+
+       private:
+        /**
+         * @class c_impl
+         *
+         * @brief The internal implementation of the `c_tls` class.
+         *
+         * @internal
+         */
+        class c_impl;
+
+        /**
+         * @brief The internal implementation of the `c_tls` class.
+         *
+         * @internal
+         */
+        std::unique_ptr<c_impl> m_impl;
+    };
+} // namespace clueapi::server::detail
+
+#endif // CLUEAPI_SERVER_DETAIL_TLS_HXX
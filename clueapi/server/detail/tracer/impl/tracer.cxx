@@ -0,0 +1,342 @@
+/**
+ * @file tracer.cxx
+ *
+ * @brief Implements the tracer.
+ */
+
+#include "clueapi/server/detail/tracer/tracer.hxx"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "clueapi/modules/macros.hxx"
+
+namespace clueapi::server::detail {
+    namespace {
+        /**
+         * @brief Gets the next number of a fast per-thread generator, for the sampling.
+         */
+        std::uint64_t next_random() noexcept {
+            thread_local std::uint64_t state{
+                std::hash<std::thread::id>{}(std::this_thread::get_id()) | 1u};
+
+            state ^= state << 13u;
+            state ^= state >> 7u;
+            state ^= state << 17u;
+
+            return state;
+        }
+
+        /**
+         * @brief Converts a sample rate to the bound of the random numbers that are sampled.
+         */
+        std::uint64_t threshold_of(double rate) noexcept {
+            if (rate >= 1.0)
+                return std::numeric_limits<std::uint64_t>::max();
+
+            if (rate <= 0.0)
+                return 0u;
+
+            return static_cast<std::uint64_t>(
+                rate * static_cast<double>(std::numeric_limits<std::uint64_t>::max()));
+        }
+    } // namespace
+
+    class c_tracer::c_impl {
+       public:
+        explicit c_impl(cfg::cfg_t::tracing_t cfg)
+            : m_cfg{std::move(cfg)},
+              m_threshold{threshold_of(m_cfg.m_sample_rate)},
+              m_slow_threshold{static_cast<std::uint64_t>(
+                  std::chrono::duration_cast<std::chrono::nanoseconds>(m_cfg.m_slow_threshold)
+                      .count())} {
+            m_cfg.m_batch_size = std::max<std::size_t>(m_cfg.m_batch_size, 1u);
+
+            m_cfg.m_max_queued = std::max(m_cfg.m_max_queued, m_cfg.m_batch_size);
+
+            shared::trace_clock_t::calibrate();
+        }
+
+        ~c_impl() noexcept {
+            stop();
+        }
+
+       public:
+        bool start() {
+            if (m_is_running.load(std::memory_order_acquire))
+                return true;
+
+            if (!m_cfg.m_sink)
+                return false;
+
+            m_is_running.store(true, std::memory_order_release);
+
+            m_thread = std::thread{[this]() { run(); }};
+
+            return true;
+        }
+
+        void stop() noexcept {
+            if (!m_is_running.exchange(false, std::memory_order_acq_rel))
+                return;
+
+            {
+                std::lock_guard lock{m_wake_mutex};
+            }
+
+            m_wake.notify_all();
+
+            if (m_thread.joinable())
+                m_thread.join();
+
+            try {
+                flush();
+            } catch (...) {
+                // ...
+            }
+        }
+
+        void begin(shared::trace_t& trace, std::optional<std::string_view> traceparent) noexcept {
+            auto& context = trace.m_context;
+
+            bool is_sampled = m_threshold != 0u && next_random() <= m_threshold;
+
+            std::optional<shared::trace_context_t> parent{};
+
+            if (traceparent.has_value())
+                parent = shared::trace_context_t::parse(traceparent.value());
+
+            if (parent.has_value()) {
+                context.m_trace_id = parent->m_trace_id;
+
+                trace.m_parent_span_id = parent->m_span_id;
+
+                is_sampled = is_sampled || (m_cfg.m_follow_parent && parent->is_sampled());
+            } else
+                context.m_trace_id = shared::trace_context_t::make_trace_id();
+
+            context.m_span_id = shared::trace_context_t::make_span_id();
+
+            context.m_flags = is_sampled ? shared::trace_context_t::k_sampled : 0u;
+        }
+
+        bool end(
+            shared::trace_t& trace,
+            std::string_view method,
+            std::string_view target,
+            std::uint16_t status) noexcept {
+            trace.m_end = shared::trace_clock_t::now();
+
+            const auto duration = shared::trace_clock_t::to_ns(trace.m_end - trace.m_start);
+
+            if (!trace.m_context.is_sampled() &&
+                (m_slow_threshold == 0u || duration < m_slow_threshold))
+                return false;
+
+            bool should_wake{};
+
+            try {
+                auto record = make_record(trace, method, target, status);
+
+                std::lock_guard lock{m_queue_mutex};
+
+                if (m_queue.size() >= m_cfg.m_max_queued) {
+                    m_dropped.fetch_add(1u, std::memory_order_relaxed);
+
+                    return false;
+                }
+
+                m_queue.push_back(std::move(record));
+
+                should_wake = m_queue.size() == m_cfg.m_batch_size;
+            } catch (...) {
+                m_dropped.fetch_add(1u, std::memory_order_relaxed);
+
+                return false;
+            }
+
+            if (should_wake)
+                m_wake.notify_one();
+
+            return true;
+        }
+
+        void flush() {
+            std::lock_guard flush_lock{m_flush_mutex};
+
+            {
+                std::lock_guard lock{m_queue_mutex};
+
+                m_queue.swap(m_exporting);
+            }
+
+            if (m_exporting.empty())
+                return;
+
+            const std::span<const shared::trace_record_t> records{m_exporting};
+
+            for (std::size_t i{}; i < records.size(); i += m_cfg.m_batch_size) {
+                const auto batch =
+                    records.subspan(i, std::min(m_cfg.m_batch_size, records.size() - i));
+
+                try {
+                    m_cfg.m_sink->write(batch);
+
+                    m_exported.fetch_add(batch.size(), std::memory_order_relaxed);
+                } catch (const std::exception& e) {
+                    CLUEAPI_LOG_ERROR("Failed to export {} traces: {}", batch.size(), e.what());
+                } catch (...) {
+                    CLUEAPI_LOG_ERROR("Failed to export {} traces", batch.size());
+                }
+            }
+
+            m_exporting.clear();
+        }
+
+        [[nodiscard]] std::uint64_t exported() const noexcept {
+            return m_exported.load(std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] std::uint64_t dropped() const noexcept {
+            return m_dropped.load(std::memory_order_relaxed);
+        }
+
+       private:
+        /**
+         * @brief Converts a trace to its exported form, the spans that didn't end ending with
+         * the response.
+         */
+        [[nodiscard]] static shared::trace_record_t make_record(
+            const shared::trace_t& trace,
+            std::string_view method,
+            std::string_view target,
+            std::uint16_t status) {
+            shared::trace_record_t ret{
+                .m_context = trace.m_context,
+                .m_parent_span_id = trace.m_parent_span_id,
+                .m_method = std::string{method},
+                .m_target = std::string{target},
+                .m_status = status,
+                .m_start = shared::trace_clock_t::to_unix_ns(trace.m_start),
+                .m_end = shared::trace_clock_t::to_unix_ns(trace.m_end)};
+
+            const auto spans = trace.spans();
+
+            ret.m_spans.reserve(spans.size());
+
+            for (const auto& span : spans) {
+                ret.m_spans.push_back(shared::trace_record_t::span_t{
+                    .m_phase = span.m_phase,
+                    .m_index = span.m_index,
+                    .m_span_id = shared::trace_context_t::make_span_id(),
+                    .m_start = shared::trace_clock_t::to_unix_ns(span.m_start),
+                    .m_end = shared::trace_clock_t::to_unix_ns(
+                        span.m_end != 0u ? span.m_end : trace.m_end)});
+            }
+
+            return ret;
+        }
+
+        /**
+         * @brief Exports the traces until the tracer is stopped.
+         */
+        void run() {
+            while (m_is_running.load(std::memory_order_acquire)) {
+                {
+                    std::unique_lock lock{m_wake_mutex};
+
+                    if (m_is_running.load(std::memory_order_acquire))
+                        m_wake.wait_for(lock, m_cfg.m_flush_interval);
+                }
+
+                try {
+                    flush();
+                } catch (const std::exception& e) {
+                    CLUEAPI_LOG_ERROR("Failed to flush the traces: {}", e.what());
+                }
+            }
+        }
+
+       private:
+        cfg::cfg_t::tracing_t m_cfg;
+
+        std::uint64_t m_threshold;
+
+        /**
+         * @brief The slow threshold in nanoseconds, `0` if disabled.
+         */
+        std::uint64_t m_slow_threshold;
+
+        std::atomic<bool> m_is_running{false};
+
+        std::thread m_thread;
+
+        std::mutex m_wake_mutex;
+
+        std::condition_variable m_wake;
+
+        std::mutex m_queue_mutex;
+
+        std::vector<shared::trace_record_t> m_queue;
+
+        /**
+         * @brief Serializes the flushes of the exporter and of `stop()`, and guards the traces
+         * below.
+         */
+        std::mutex m_flush_mutex;
+
+        std::vector<shared::trace_record_t> m_exporting;
+
+        std::atomic<std::uint64_t> m_exported{};
+
+        std::atomic<std::uint64_t> m_dropped{};
+    };
+
+    c_tracer::c_tracer(cfg::cfg_t::tracing_t cfg)
+        : m_impl{std::make_unique<c_impl>(std::move(cfg))} {
+    }
+
+    c_tracer::~c_tracer() noexcept = default;
+
+    bool c_tracer::start() {
+        return m_impl->start();
+    }
+
+    void c_tracer::stop() {
+        m_impl->stop();
+    }
+
+    void c_tracer::begin(
+        shared::trace_t& trace, std::optional<std::string_view> traceparent) noexcept {
+        m_impl->begin(trace, traceparent);
+    }
+
+    bool c_tracer::end(
+        shared::trace_t& trace,
+        std::string_view method,
+        std::string_view target,
+        std::uint16_t status) noexcept {
+        return m_impl->end(trace, method, target, status);
+    }
+
+    void c_tracer::flush() {
+        m_impl->flush();
+    }
+
+    std::uint64_t c_tracer::exported() const noexcept {
+        return m_impl->exported();
+    }
+
+    std::uint64_t c_tracer::dropped() const noexcept {
+        return m_impl->dropped();
+    }
+} // namespace clueapi::server::detail
@@ -0,0 +1,124 @@
+/**
+ * @file tracer.hxx
+ *
+ * @brief Defines the tracer, which samples the traces of the requests and exports them in
+ * batches.
+ */
+
+#ifndef CLUEAPI_SERVER_DETAIL_TRACER_HXX
+#define CLUEAPI_SERVER_DETAIL_TRACER_HXX
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+
+#include "clueapi/cfg/cfg.hxx"
+
+#include "clueapi/shared/macros.hxx"
+#include "clueapi/shared/tracing/tracing.hxx"
+
+namespace clueapi::server::detail {
+    /**
+     * @class c_tracer
+     *
+     * @brief Starts the traces of the requests and exports the sampled ones.
+     *
+     * @details A trace is kept if its context is sampled, which `begin()` decides from the
+     * `traceparent` of the request and `tracing_t::m_sample_rate`, or if the request took at
+     * least `tracing_t::m_slow_threshold`. The kept traces are queued under a lock taken once
+     * per kept trace, and handed to the sink in batches by a background thread.
+     *
+     * @note `begin()` and `end()` are thread-safe and never block on the sink.
+     */
+    class c_tracer {
+       public:
+        /**
+         * @brief Constructs a tracer, not exporting until it is started.
+         *
+         * @param cfg The settings of the tracing.
+         */
+        explicit c_tracer(cfg::cfg_t::tracing_t cfg);
+
+        ~c_tracer() noexcept;
+
+        // Copy constructor
+        CLUEAPI_INLINE c_tracer(const c_tracer&) = delete;
+
+        // Copy assignment operator
+        CLUEAPI_INLINE c_tracer& operator=(const c_tracer&) = delete;
+
+       public:
+        /**
+         * @brief Starts the exporter thread.
+         *
+         * @return `true` if the tracer is running, `false` if it has no sink.
+         */
+        bool start();
+
+        /**
+         * @brief Exports the queued traces and stops the exporter thread.
+         */
+        void stop();
+
+        /**
+         * @brief Gives a request its context once its headers are read.
+         *
+         * @param trace The trace of the request, started by `trace_t::reset()`.
+         * @param traceparent The `traceparent` header of the request, if any.
+         */
+        void begin(shared::trace_t& trace, std::optional<std::string_view> traceparent) noexcept;
+
+        /**
+         * @brief Ends the trace of a request once its response is sent, and queues it if it is
+         * kept.
+         *
+         * @param trace The trace of the request.
+         * @param method The method of the request.
+         * @param target The request target.
+         * @param status The status of the response.
+         *
+         * @return `true` if the trace is kept, `false` otherwise.
+         */
+        bool end(
+            shared::trace_t& trace,
+            std::string_view method,
+            std::string_view target,
+            std::uint16_t status) noexcept;
+
+        /**
+         * @brief Exports the queued traces now.
+         */
+        void flush();
+
+       public:
+        /**
+         * @brief Gets the number of traces handed to the sink.
+         */
+        [[nodiscard]] std::uint64_t exported() const noexcept;
+
+        /**
+         * @brief Gets the number of kept traces dropped because the queue was full.
+         */
+        [[nodiscard]] std::uint64_t dropped() const noexcept;
+
+       private:
+        /**
+         * @class c_impl
+         *
+         * @brief The internal implementation of the `c_tracer` class.
+         *
+         * @internal
+         */
+        class c_impl;
+
+        /**
+         * @brief The internal implementation of the `c_tracer` class.
+         *
+         * @internal
+         */
+        std::unique_ptr<c_impl> m_impl;
+    };
+} // namespace clueapi::server::detail
+
+#endif // CLUEAPI_SERVER_DETAIL_TRACER_HXX
@@ -0,0 +1,133 @@
+/**
+ * @file http2.hxx
+ *
+ * @brief Defines the HTTP/2 connection, serving many concurrent streams over one socket.
+ */
+
+#ifndef CLUEAPI_SERVER_HTTP2_HXX
+#define CLUEAPI_SERVER_HTTP2_HXX
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <string_view>
+
+#include <boost/asio/ip/tcp.hpp>
+
+#include "clueapi/http/types/request/request.hxx"
+#include "clueapi/http/types/response/response.hxx"
+
+#include "clueapi/shared/buffer_pool/buffer_pool.hxx"
+#include "clueapi/shared/macros.hxx"
+#include "clueapi/shared/shared.hxx"
+
+// Forward declarations
+namespace clueapi::cfg {
+    struct cfg_t;
+} // namespace clueapi::cfg
+
+/**
+ * @namespace clueapi::server::http2
+ *
+ * @brief The HTTP/2 transport of the server.
+ *
+ * @internal
+ */
+namespace clueapi::server::http2 {
+    /**
+     * @brief The connection preface of an HTTP/2 client.
+     */
+    inline constexpr std::string_view k_preface{"PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n"};
+
+    /**
+     * @brief Type alias for the function that produces the response to a request, e.g. the
+     * middleware chain.
+     */
+    using dispatch_t = std::function<shared::awaitable_t<http::types::response_t>(
+        const http::types::request_t&)>;
+
+    /**
+     * @class c_connection
+     *
+     * @brief Serves an HTTP/2 connection.
+     *
+     * @details The framing, HPACK and flow control are done by nghttp2. Each request is
+     * dispatched in its own coroutine on the executor of the socket as soon as it is complete,
+     * so a slow handler doesn't hold the other streams back. A single writer gathers the frames
+     * of all streams into one write.
+     *
+     * The body of a response is sent as it is, from memory, from a file with its range and
+     * preconditions applied, or from a stream function whose `chunk_writer_t` writes DATA frames.
+     * A stream function writing faster than the client reads waits once
+     * `cfg_t::http2_t::m_max_buffered_bytes` are buffered for its stream.
+     *
+     * @note Request bodies are buffered up to `cfg_t::http_t::m_max_request_size`, also for
+     * streamed routes.
+     */
+    class c_connection {
+       public:
+        /**
+         * @brief Constructs a connection.
+         *
+         * @param socket The socket of the connection.
+         * @param buffer The read buffer, holding the bytes already received.
+         * @param cfg The configuration settings.
+         * @param dispatch The function that produces the response to a request.
+         */
+        c_connection(
+            boost::asio::ip::tcp::socket& socket,
+            shared::pooled_buffer_t& buffer,
+            const cfg::cfg_t& cfg,
+            dispatch_t dispatch);
+
+        ~c_connection() noexcept;
+
+        // Copy constructor
+        CLUEAPI_INLINE c_connection(const c_connection&) = delete;
+
+        // Copy assignment operator
+        CLUEAPI_INLINE c_connection& operator=(const c_connection&) = delete;
+
+       public:
+        /**
+         * @brief Serves the connection until it is closed or idle for
+         * `cfg_t::http_t::m_keep_alive_timeout`.
+         *
+         * @return An awaitable that completes once every stream of the connection is done.
+         */
+        shared::awaitable_t<void> run();
+
+       public:
+        /**
+         * @brief Checks if received bytes can start with the connection preface.
+         *
+         * @param data The received bytes.
+         *
+         * @return `true` if the bytes are a prefix of the preface, or start with it.
+         */
+        [[nodiscard]] static CLUEAPI_INLINE bool is_preface(std::string_view data) noexcept {
+            const auto size = std::min(data.size(), k_preface.size());
+
+            return data.substr(0, size) == k_preface.substr(0, size);
+        }
+
+       private:
+        /**
+         * @class c_impl
+         *
+         * @brief The internal implementation of the `c_connection` class.
+         *
+         * @internal
+         */
+        class c_impl;
+
+        /**
+         * @brief The internal implementation of the `c_connection` class.
+         *
+         * @internal
+         */
+        std::unique_ptr<c_impl> m_impl;
+    };
+} // namespace clueapi::server::http2
+
+#endif // CLUEAPI_SERVER_HTTP2_HXX
@@ -0,0 +1,1027 @@
+/**
+ * @file http2.cxx
+ *
+ * @brief Implements the HTTP/2 connection.
+ */
+
+#include "clueapi/server/http2/http2.hxx"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/experimental/awaitable_operators.hpp>
+#include <boost/asio/redirect_error.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/beast/core/string.hpp>
+
+#include <fmt/format.h>
+
+#include <nghttp2/nghttp2.h>
+
+#include "clueapi/cfg/cfg.hxx"
+
+#include "clueapi/exceptions/exceptions.hxx"
+
+#include "clueapi/http/chunks/chunks.hxx"
+#include "clueapi/http/range/range.hxx"
+#include "clueapi/http/types/status/status.hxx"
+
+#include "clueapi/modules/macros.hxx"
+
+#include "clueapi/shared/date_cache/date_cache.hxx"
+#include "clueapi/shared/json_writer/json_writer.hxx"
+
+namespace clueapi::server::http2 {
+    namespace {
+        /**
+         * @brief The number of bytes asked for by a read from the socket.
+         */
+        constexpr std::size_t k_read_size = 16u * 1024u;
+
+        /**
+         * @brief The number of bytes of frames gathered before they are written.
+         */
+        constexpr std::size_t k_write_size = 64u * 1024u;
+
+        /**
+         * @brief The JSON body of an error response.
+         */
+        struct error_body_t {
+            std::string_view m_error;
+
+            std::string_view m_detail;
+
+            static constexpr auto k_json_fields = shared::json_fields(
+                shared::json_field("error", &error_body_t::m_error),
+                shared::json_field("detail", &error_body_t::m_detail));
+        };
+
+        /**
+         * @brief Checks if a header of a response only applies to an HTTP/1.1 connection, or is
+         * written by the server itself.
+         */
+        bool is_reserved_field(std::string_view name) noexcept {
+            return boost::beast::iequals(name, "Content-Length") ||
+                   boost::beast::iequals(name, "Connection") ||
+                   boost::beast::iequals(name, "Keep-Alive") ||
+                   boost::beast::iequals(name, "Transfer-Encoding") ||
+                   boost::beast::iequals(name, "Upgrade") ||
+                   boost::beast::iequals(name, "Proxy-Connection");
+        }
+
+        /**
+         * @brief Checks if a status is sent without a body (1xx, 204 and 304).
+         */
+        constexpr bool is_bodiless(std::uint32_t status) noexcept {
+            return (status >= 100u && status < 200u) || status == 204u || status == 304u;
+        }
+
+        /**
+         * @brief Wraps a string as a header of nghttp2, which copies it when submitted.
+         */
+        nghttp2_nv make_nv(std::string_view name, std::string_view value) noexcept {
+            return nghttp2_nv{
+                .name = reinterpret_cast<std::uint8_t*>(const_cast<char*>(name.data())),
+                .value = reinterpret_cast<std::uint8_t*>(const_cast<char*>(value.data())),
+                .namelen = name.size(),
+                .valuelen = value.size(),
+                .flags = NGHTTP2_NV_FLAG_NONE};
+        }
+    } // namespace
+
+    class c_connection::c_impl {
+       public:
+        /**
+         * @struct stream_t
+         *
+         * @brief A request and its response.
+         */
+        struct stream_t final : http::chunks::sink_t {
+            /**
+             * @brief Where the body of the response is read from.
+             */
+            enum struct e_source : std::uint8_t {
+                memory,
+                file,
+                stream
+            };
+
+            CLUEAPI_INLINE stream_t(c_impl& owner, std::int32_t id)
+                : m_owner{owner},
+                  m_id{id},
+                  m_request{std::make_shared<http::types::request_t>()},
+                  m_writable{owner.m_socket.get_executor()} {
+            }
+
+            CLUEAPI_INLINE ~stream_t() noexcept override {
+#if defined(__linux__)
+                if (m_fd >= 0)
+                    ::close(m_fd);
+#endif
+            }
+
+           public:
+            exceptions::expected_awaitable_t<> write(std::string_view data) override {
+                if (is_closed())
+                    co_return exceptions::make_unexpected("Stream closed");
+
+                if (m_offset == m_buffered.size()) {
+                    m_buffered.clear();
+
+                    m_offset = 0;
+                }
+
+                m_buffered.append(data);
+
+                m_owner.resume(*this);
+
+                // Flow control: the writer waits until the client took enough of the body
+                while (m_buffered.size() - m_offset >= m_owner.m_cfg.m_http2.m_max_buffered_bytes &&
+                       !is_closed()) {
+                    boost::system::error_code ec{};
+
+                    m_writable.expires_at(boost::asio::steady_timer::time_point::max());
+
+                    co_await m_writable.async_wait(
+                        boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+                }
+
+                if (is_closed())
+                    co_return exceptions::make_unexpected("Stream closed");
+
+                co_return exceptions::expected_t<>{};
+            }
+
+            exceptions::expected_awaitable_t<> finish() override {
+                m_is_eof = true;
+
+                m_owner.resume(*this);
+
+                co_return exceptions::expected_t<>{};
+            }
+
+            [[nodiscard]] bool is_closed() const noexcept override {
+                return m_is_closed || m_owner.m_is_closed;
+            }
+
+           public:
+            c_impl& m_owner;
+
+            std::int32_t m_id;
+
+            std::shared_ptr<http::types::request_t> m_request;
+
+            /**
+             * @brief The preconditions of the response, taken before the handler may move from
+             * the request.
+             */
+            http::range::preconditions_t m_preconditions;
+
+            /**
+             * @brief The size of the received headers.
+             */
+            std::size_t m_header_bytes{};
+
+            bool m_has_host{};
+
+            bool m_is_dispatched{};
+
+            bool m_is_too_large{};
+
+            bool m_is_closed{};
+
+            http::types::response_t m_response{};
+
+            e_source m_source{e_source::memory};
+
+            /**
+             * @brief The body from memory, or the bytes buffered by a stream function.
+             */
+            std::string_view m_view{};
+
+            std::string m_buffered{};
+
+            std::size_t m_offset{};
+
+            bool m_is_eof{};
+
+            bool m_is_deferred{};
+
+            int m_fd{-1};
+
+            std::uint64_t m_file_offset{};
+
+            std::uint64_t m_file_remaining{};
+
+            /**
+             * @brief Wakes the stream function once the client took enough of the body.
+             */
+            boost::asio::steady_timer m_writable;
+        };
+
+       public:
+        c_impl(
+            boost::asio::ip::tcp::socket& socket,
+            shared::pooled_buffer_t& buffer,
+            const cfg::cfg_t& cfg,
+            dispatch_t dispatch)
+            : m_socket{socket},
+              m_buffer{buffer},
+              m_cfg{cfg},
+              m_dispatch{std::move(dispatch)},
+              m_write_signal{socket.get_executor()},
+              m_idle{socket.get_executor()},
+              m_done{socket.get_executor()} {
+            nghttp2_session_callbacks* callbacks{};
+
+            nghttp2_session_callbacks_new(&callbacks);
+
+            nghttp2_session_callbacks_set_on_begin_headers_callback(callbacks, on_begin_headers);
+
+            nghttp2_session_callbacks_set_on_header_callback(callbacks, on_header);
+
+            nghttp2_session_callbacks_set_on_data_chunk_recv_callback(
+                callbacks, on_data_chunk_recv);
+
+            nghttp2_session_callbacks_set_on_frame_recv_callback(callbacks, on_frame_recv);
+
+            nghttp2_session_callbacks_set_on_frame_send_callback(callbacks, on_frame_send);
+
+            nghttp2_session_callbacks_set_on_stream_close_callback(callbacks, on_stream_close);
+
+            nghttp2_session_server_new(&m_session, callbacks, this);
+
+            nghttp2_session_callbacks_del(callbacks);
+        }
+
+        ~c_impl() noexcept {
+            m_streams.clear();
+
+            nghttp2_session_del(m_session);
+        }
+
+       public:
+        shared::awaitable_t<void> run() {
+            using namespace boost::asio::experimental::awaitable_operators;
+
+            const std::array<nghttp2_settings_entry, 3> settings{
+                nghttp2_settings_entry{
+                    NGHTTP2_SETTINGS_MAX_CONCURRENT_STREAMS,
+                    m_cfg.m_http2.m_max_concurrent_streams},
+                nghttp2_settings_entry{
+                    NGHTTP2_SETTINGS_INITIAL_WINDOW_SIZE, m_cfg.m_http2.m_initial_window_size},
+                nghttp2_settings_entry{
+                    NGHTTP2_SETTINGS_MAX_HEADER_LIST_SIZE,
+                    m_cfg.m_http2.m_max_header_list_size}};
+
+            nghttp2_submit_settings(m_session, NGHTTP2_FLAG_NONE, settings.data(), settings.size());
+
+            nghttp2_session_set_local_window_size(
+                m_session,
+                NGHTTP2_FLAG_NONE,
+                0,
+                static_cast<std::int32_t>(m_cfg.m_http2.m_connection_window_size));
+
+            const auto native_handle = m_socket.native_handle();
+
+            CLUEAPI_LOG_TRACE("Serving HTTP/2 connection (id: {})", native_handle);
+
+            m_is_writing = true;
+
+            boost::asio::co_spawn(m_socket.get_executor(), write_loop(), boost::asio::detached);
+
+            const auto idle_timeout = m_cfg.m_http.m_keep_alive_timeout;
+
+            // The preface and what came with it were read along with the detection
+            while (!m_is_closed) {
+                if (m_buffer.size() != 0u) {
+                    const auto data = m_buffer.cdata();
+
+                    const auto consumed = nghttp2_session_mem_recv(
+                        m_session, static_cast<const std::uint8_t*>(data.data()), data.size());
+
+                    m_buffer.consume(m_buffer.size());
+
+                    if (consumed < 0) {
+                        CLUEAPI_LOG_TRACE(
+                            "HTTP/2 protocol error (id: {}): {}",
+
+                            native_handle,
+                            nghttp2_strerror(static_cast<int>(consumed)));
+
+                        break;
+                    }
+
+                    schedule_write();
+                }
+
+                if (!nghttp2_session_want_read(m_session))
+                    break;
+
+                if (m_active == 0u && idle_timeout.count() > 0)
+                    m_idle.expires_after(idle_timeout);
+                else
+                    m_idle.expires_at(boost::asio::steady_timer::time_point::max());
+
+                boost::system::error_code ec{};
+
+                boost::system::error_code idle_ec{};
+
+                auto result = co_await (
+                    m_socket.async_read_some(
+                        m_buffer.prepare(k_read_size),
+                        boost::asio::redirect_error(boost::asio::use_awaitable, ec)) ||
+                    m_idle.async_wait(
+                        boost::asio::redirect_error(boost::asio::use_awaitable, idle_ec)));
+
+                if (result.index() == 1) {
+                    // Re-armed because the last stream finished
+                    if (idle_ec == boost::asio::error::operation_aborted)
+                        continue;
+
+                    CLUEAPI_LOG_TRACE("HTTP/2 connection idle, closing (id: {})", native_handle);
+
+                    nghttp2_session_terminate_session(m_session, NGHTTP2_NO_ERROR);
+
+                    break;
+                }
+
+                m_buffer.commit(std::get<0>(result));
+
+                if (ec) {
+                    CLUEAPI_LOG_TRACE(
+                        "HTTP/2 connection closed (id: {}): {}", native_handle, ec.message());
+
+                    m_is_closed = true;
+                }
+            }
+
+            // What is still queued, e.g. the GOAWAY, goes out before the connection is closed
+            schedule_write();
+
+            co_await wait_until([this] { return !m_is_writing; });
+
+            m_is_closed = true;
+
+            for (auto& [id, stream] : m_streams)
+                stream->m_writable.cancel();
+
+            co_await wait_until([this] { return m_active == 0u; });
+
+            CLUEAPI_LOG_TRACE("HTTP/2 connection completed (id: {})", native_handle);
+        }
+
+       private:
+        /**
+         * @brief Waits until a condition holds, re-checked whenever `m_done` is cancelled.
+         */
+        template <typename _fn_t>
+        shared::awaitable_t<void> wait_until(_fn_t fn) {
+            while (!fn()) {
+                boost::system::error_code ec{};
+
+                m_done.expires_after(std::chrono::seconds{1});
+
+                co_await m_done.async_wait(
+                    boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+            }
+        }
+
+        /**
+         * @brief Wakes the writer, if it waits for frames.
+         */
+        CLUEAPI_INLINE void schedule_write() noexcept {
+            m_write_signal.cancel();
+        }
+
+        /**
+         * @brief Resumes the body of a stream after more of it was buffered.
+         */
+        void resume(stream_t& stream) {
+            if (stream.m_is_deferred) {
+                stream.m_is_deferred = false;
+
+                nghttp2_session_resume_data(m_session, stream.m_id);
+            }
+
+            schedule_write();
+        }
+
+        /**
+         * @brief Writes the frames of all streams until the session has nothing left to send.
+         */
+        shared::awaitable_t<void> write_loop() {
+            std::string output{};
+
+            while (true) {
+                output.clear();
+
+                while (output.size() < k_write_size) {
+                    const std::uint8_t* data{};
+
+                    const auto size = nghttp2_session_mem_send(m_session, &data);
+
+                    if (size <= 0)
+                        break;
+
+                    output.append(
+                        reinterpret_cast<const char*>(data), static_cast<std::size_t>(size));
+                }
+
+                if (!output.empty()) {
+                    boost::system::error_code ec{};
+
+                    co_await boost::asio::async_write(
+                        m_socket,
+                        boost::asio::buffer(output),
+                        boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+
+                    if (ec) {
+                        m_is_closed = true;
+
+                        // The read is pending, it ends once the socket is cancelled
+                        m_socket.cancel(ec);
+
+                        break;
+                    }
+
+                    continue;
+                }
+
+                if (m_is_closed ||
+                    (!nghttp2_session_want_read(m_session) &&
+                     !nghttp2_session_want_write(m_session)))
+                    break;
+
+                boost::system::error_code ec{};
+
+                m_write_signal.expires_at(boost::asio::steady_timer::time_point::max());
+
+                co_await m_write_signal.async_wait(
+                    boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+            }
+
+            m_is_writing = false;
+
+            m_done.cancel();
+        }
+
+        /**
+         * @brief Produces and submits the response of a stream.
+         */
+        shared::awaitable_t<void> serve(std::shared_ptr<stream_t> stream) {
+            auto& response = stream->m_response;
+
+            // The handler may move from the request, the response only reads these afterwards
+            stream->m_preconditions.assign(*stream->m_request);
+
+            if (stream->m_is_too_large) {
+                error_response(response, http::types::status_t::payload_too_large);
+            } else {
+                try {
+                    response = co_await m_dispatch(*stream->m_request);
+                } catch (const std::exception& e) {
+                    CLUEAPI_LOG_ERROR("Exception in HTTP/2 stream {}: {}", stream->m_id, e.what());
+
+                    response.reset();
+                }
+
+                if (response.status() == http::types::status_t::unknown)
+                    error_response(response, http::types::status_t::internal_server_error);
+            }
+
+            if (!stream->is_closed()) {
+                const auto is_stream = response.is_stream() && response.stream_fn();
+
+                submit(*stream);
+
+                if (is_stream && !stream->is_closed()) {
+                    http::chunks::chunk_writer_t writer{*stream};
+
+                    auto streamed = co_await response.stream_fn()(writer);
+
+                    if (!streamed.has_value())
+                        CLUEAPI_LOG_ERROR(
+                            "Error in response callback (stream: {}): message={}",
+
+                            stream->m_id,
+                            streamed.error());
+
+                    if (!writer.final_chunk_written())
+                        co_await writer.write_final_chunk();
+                }
+            }
+
+            if (--m_active == 0u) {
+                // The idle timeout starts over
+                m_idle.cancel();
+
+                m_done.cancel();
+            }
+        }
+
+        /**
+         * @brief Fills an error response, shaped as on HTTP/1.1.
+         */
+        void error_response(
+            http::types::response_t& response, http::types::status_t::e_status status) {
+            response.reset();
+
+            response.status() = status;
+
+            if (m_cfg.m_http.m_def_response_class == http::types::e_response_class::plain) {
+                response.body() = http::types::status_t::to_str(status);
+
+                response.headers().insert_or_assign("Content-Type", "text/plain");
+            } else {
+                response.body() = shared::json_writer_t::to_string(error_body_t{
+                    http::types::status_t::to_str(status), http::types::status_t::to_str(status)});
+
+                response.headers().insert_or_assign("Content-Type", "application/json");
+            }
+        }
+
+        /**
+         * @brief Submits the headers of a response, and how its body is read.
+         */
+        void submit(stream_t& stream) {
+            auto& response = stream.m_response;
+
+            auto status = static_cast<std::uint32_t>(response.status());
+
+            const auto is_head = stream.m_preconditions.m_method == http::types::method_t::head;
+
+            // Submitted again with an error response if the file can't be opened
+            stream.m_source = stream_t::e_source::memory;
+
+            stream.m_file_remaining = 0u;
+
+            std::vector<std::string> storage{};
+
+            std::vector<nghttp2_nv> headers{};
+
+            storage.reserve(response.headers().size() + 4u);
+
+            headers.reserve(response.headers().size() + response.cookies().size() + 6u);
+
+            // The status is set once the body is known, a range may change it
+            headers.emplace_back();
+
+            for (const auto& [key, value] : response.headers()) {
+                if (is_reserved_field(key))
+                    continue;
+
+                // Header names are lowercase in HTTP/2
+                auto& name = storage.emplace_back(key);
+
+                std::ranges::transform(name, name.begin(), [](unsigned char c) {
+                    return static_cast<char>(std::tolower(c));
+                });
+
+                headers.push_back(make_nv(name, value));
+            }
+
+            for (const auto& cookie : response.cookies())
+                headers.push_back(make_nv("set-cookie", cookie));
+
+            if (!response.headers().contains("Date"))
+                headers.push_back(make_nv("date", shared::date_cache_t::now()));
+
+            if (!m_cfg.m_http.m_server_name.empty() && !response.headers().contains("Server"))
+                headers.push_back(make_nv("server", m_cfg.m_http.m_server_name));
+
+            std::uint64_t length{};
+
+            bool has_length{true};
+
+            if (response.file().has_value()) {
+                const auto& file = *response.file();
+
+                http::range::selection_t selection{
+                    .m_range = {0, file.m_size > 0 ? file.m_size - 1 : 0}, .m_length = file.m_size};
+
+                if (response.status() == http::types::status_t::ok) {
+                    std::string_view etag{};
+
+                    if (auto it = response.headers().find("ETag"); it != response.headers().end())
+                        etag = it->second;
+
+                    selection =
+                        http::range::range_t::select(stream.m_preconditions, etag, file.m_size);
+
+                    status = selection.m_status;
+                }
+
+                headers.push_back(make_nv("accept-ranges", "bytes"));
+
+                if (status == 206u)
+                    headers.push_back(make_nv(
+                        "content-range",
+                        storage.emplace_back(fmt::format(
+                            "bytes {}-{}/{}",
+                            selection.m_range.m_first,
+                            selection.m_range.m_last,
+                            file.m_size))));
+                else if (status == 416u)
+                    headers.push_back(make_nv(
+                        "content-range",
+                        storage.emplace_back(fmt::format("bytes */{}", file.m_size))));
+
+                length = selection.m_length;
+
+                has_length = status != 304u;
+
+                stream.m_source = stream_t::e_source::file;
+
+                stream.m_file_offset = selection.m_range.m_first;
+
+                stream.m_file_remaining = is_head ? 0u : length;
+
+#if defined(__linux__)
+                if (stream.m_file_remaining != 0u) {
+                    stream.m_fd = ::open(file.m_path.c_str(), O_RDONLY | O_CLOEXEC);
+
+                    if (stream.m_fd < 0) {
+                        CLUEAPI_LOG_ERROR(
+                            "Error opening file (stream: {}): {}",
+
+                            stream.m_id,
+                            std::strerror(errno));
+
+                        error_response(response, http::types::status_t::internal_server_error);
+
+                        submit(stream);
+
+                        return;
+                    }
+                }
+#endif
+            } else if (response.is_stream() && response.stream_fn()) {
+                has_length = false;
+
+                stream.m_source = stream_t::e_source::stream;
+            } else {
+                stream.m_view = response.shared_body() ? response.shared_body().m_data
+                                                       : std::string_view{response.body()};
+
+                length = stream.m_view.size();
+
+                if (is_head)
+                    stream.m_view = {};
+            }
+
+            if (is_bodiless(status)) {
+                has_length = false;
+
+                stream.m_view = {};
+
+                stream.m_file_remaining = 0u;
+            }
+
+            const auto status_value = fmt::format("{}", status);
+
+            headers.front() = make_nv(":status", status_value);
+
+            const auto length_value = fmt::format("{}", length);
+
+            if (has_length)
+                headers.push_back(make_nv("content-length", length_value));
+
+            const auto has_body = stream.m_source == stream_t::e_source::stream
+                                      ? !is_head && !is_bodiless(status)
+                                      : !stream.m_view.empty() || stream.m_file_remaining != 0u;
+
+            nghttp2_data_provider provider{};
+
+            provider.source.ptr = &stream;
+
+            provider.read_callback = read_body;
+
+            nghttp2_submit_response(
+                m_session,
+                stream.m_id,
+                headers.data(),
+                headers.size(),
+                has_body ? &provider : nullptr);
+
+            // A stream function that ends up writing nothing still sends its END_STREAM
+            if (!has_body && stream.m_source == stream_t::e_source::stream)
+                stream.m_is_eof = true;
+
+            schedule_write();
+        }
+
+        /**
+         * @brief Starts serving a stream whose request is complete.
+         */
+        void dispatch(stream_t& stream) {
+            if (stream.m_is_dispatched)
+                return;
+
+            stream.m_is_dispatched = true;
+
+            m_active++;
+
+            boost::asio::co_spawn(
+                m_socket.get_executor(), serve(m_streams.at(stream.m_id)), boost::asio::detached);
+        }
+
+       private:
+        [[nodiscard]] static stream_t* stream_of(
+            nghttp2_session* session, std::int32_t id) noexcept {
+            return static_cast<stream_t*>(nghttp2_session_get_stream_user_data(session, id));
+        }
+
+        static int on_begin_headers(
+            nghttp2_session* session, const nghttp2_frame* frame, void* user_data) {
+            if (frame->hd.type != NGHTTP2_HEADERS || frame->headers.cat != NGHTTP2_HCAT_REQUEST)
+                return 0;
+
+            auto& self = *static_cast<c_impl*>(user_data);
+
+            auto stream = std::make_shared<stream_t>(self, frame->hd.stream_id);
+
+            nghttp2_session_set_stream_user_data(session, frame->hd.stream_id, stream.get());
+
+            self.m_streams.insert_or_assign(frame->hd.stream_id, std::move(stream));
+
+            return 0;
+        }
+
+        static int on_header(
+            nghttp2_session* session,
+            const nghttp2_frame* frame,
+            const std::uint8_t* name,
+            std::size_t namelen,
+            const std::uint8_t* value,
+            std::size_t valuelen,
+            std::uint8_t,
+            void* user_data) {
+            // Trailers are not passed on
+            if (frame->hd.type != NGHTTP2_HEADERS || frame->headers.cat != NGHTTP2_HCAT_REQUEST)
+                return 0;
+
+            auto* stream = stream_of(session, frame->hd.stream_id);
+
+            if (!stream)
+                return 0;
+
+            auto& self = *static_cast<c_impl*>(user_data);
+
+            stream->m_header_bytes += namelen + valuelen;
+
+            if (stream->m_header_bytes > self.m_cfg.m_http2.m_max_header_list_size)
+                return NGHTTP2_ERR_TEMPORAL_CALLBACK_FAILURE;
+
+            const std::string_view key{reinterpret_cast<const char*>(name), namelen};
+
+            const std::string_view val{reinterpret_cast<const char*>(value), valuelen};
+
+            auto& request = *stream->m_request;
+
+            if (key == ":method")
+                request.method() = http::types::method_t::from_str(val);
+            else if (key == ":path")
+                request.uri() = val;
+            else if (key == ":authority") {
+                if (!stream->m_has_host)
+                    request.add_header("host", val);
+
+                stream->m_has_host = true;
+            } else if (!key.starts_with(':')) {
+                if (key == "host") {
+                    if (stream->m_has_host)
+                        return 0;
+
+                    stream->m_has_host = true;
+                }
+
+                request.add_header(key, val);
+            }
+
+            return 0;
+        }
+
+        static int on_data_chunk_recv(
+            nghttp2_session* session,
+            std::uint8_t,
+            std::int32_t stream_id,
+            const std::uint8_t* data,
+            std::size_t len,
+            void* user_data) {
+            auto* stream = stream_of(session, stream_id);
+
+            if (!stream || stream->m_is_too_large)
+                return 0;
+
+            auto& self = *static_cast<c_impl*>(user_data);
+
+            auto& body = stream->m_request->body();
+
+            // Answered before the rest of the body is received
+            if (body.size() + len > self.m_cfg.m_http.m_max_request_size) {
+                stream->m_is_too_large = true;
+
+                body.clear();
+
+                self.dispatch(*stream);
+
+                return 0;
+            }
+
+            body.append(reinterpret_cast<const char*>(data), len);
+
+            return 0;
+        }
+
+        static int on_frame_recv(
+            nghttp2_session* session, const nghttp2_frame* frame, void* user_data) {
+            if (frame->hd.type != NGHTTP2_HEADERS && frame->hd.type != NGHTTP2_DATA)
+                return 0;
+
+            if (!(frame->hd.flags & NGHTTP2_FLAG_END_STREAM))
+                return 0;
+
+            if (auto* stream = stream_of(session, frame->hd.stream_id))
+                static_cast<c_impl*>(user_data)->dispatch(*stream);
+
+            return 0;
+        }
+
+        static int on_frame_send(
+            nghttp2_session* session, const nghttp2_frame* frame, void*) {
+            if (frame->hd.type != NGHTTP2_HEADERS && frame->hd.type != NGHTTP2_DATA)
+                return 0;
+
+            if (!(frame->hd.flags & NGHTTP2_FLAG_END_STREAM))
+                return 0;
+
+            // The client may stop sending the body that was refused
+            if (auto* stream = stream_of(session, frame->hd.stream_id);
+                stream && stream->m_is_too_large)
+                nghttp2_submit_rst_stream(
+                    session, NGHTTP2_FLAG_NONE, frame->hd.stream_id, NGHTTP2_NO_ERROR);
+
+            return 0;
+        }
+
+        static int on_stream_close(
+            nghttp2_session* session, std::int32_t stream_id, std::uint32_t, void* user_data) {
+            auto* stream = stream_of(session, stream_id);
+
+            if (!stream)
+                return 0;
+
+            stream->m_is_closed = true;
+
+            stream->m_writable.cancel();
+
+            // A stream still being served is kept alive by its coroutine
+            static_cast<c_impl*>(user_data)->m_streams.erase(stream_id);
+
+            return 0;
+        }
+
+        static ssize_t read_body(
+            nghttp2_session*,
+            std::int32_t,
+            std::uint8_t* buf,
+            std::size_t length,
+            std::uint32_t* data_flags,
+            nghttp2_data_source* source,
+            void*) {
+            auto& stream = *static_cast<stream_t*>(source->ptr);
+
+            switch (stream.m_source) {
+                case stream_t::e_source::memory: {
+                    const auto size = std::min(length, stream.m_view.size() - stream.m_offset);
+
+                    std::memcpy(buf, stream.m_view.data() + stream.m_offset, size);
+
+                    stream.m_offset += size;
+
+                    if (stream.m_offset == stream.m_view.size())
+                        *data_flags |= NGHTTP2_DATA_FLAG_EOF;
+
+                    return static_cast<ssize_t>(size);
+                }
+                case stream_t::e_source::file: {
+#if defined(__linux__)
+                    const auto size = static_cast<std::size_t>(
+                        std::min<std::uint64_t>(length, stream.m_file_remaining));
+
+                    const auto read = ::pread(
+                        stream.m_fd, buf, size, static_cast<off_t>(stream.m_file_offset));
+
+                    // The file was truncated while sending, the stream is reset
+                    if (read <= 0)
+                        return NGHTTP2_ERR_TEMPORAL_CALLBACK_FAILURE;
+
+                    stream.m_file_offset += static_cast<std::uint64_t>(read);
+
+                    stream.m_file_remaining -= static_cast<std::uint64_t>(read);
+
+                    if (stream.m_file_remaining == 0u)
+                        *data_flags |= NGHTTP2_DATA_FLAG_EOF;
+
+                    return read;
+#else
+                    return NGHTTP2_ERR_TEMPORAL_CALLBACK_FAILURE;
+#endif
+                }
+                case stream_t::e_source::stream: {
+                    const auto buffered = stream.m_buffered.size() - stream.m_offset;
+
+                    if (buffered == 0u) {
+                        if (stream.m_is_eof) {
+                            *data_flags |= NGHTTP2_DATA_FLAG_EOF;
+
+                            return 0;
+                        }
+
+                        stream.m_is_deferred = true;
+
+                        return NGHTTP2_ERR_DEFERRED;
+                    }
+
+                    const auto size = std::min(length, buffered);
+
+                    std::memcpy(buf, stream.m_buffered.data() + stream.m_offset, size);
+
+                    stream.m_offset += size;
+
+                    if (stream.m_offset == stream.m_buffered.size() && stream.m_is_eof)
+                        *data_flags |= NGHTTP2_DATA_FLAG_EOF;
+
+                    if (buffered - size < stream.m_owner.m_cfg.m_http2.m_max_buffered_bytes)
+                        stream.m_writable.cancel();
+
+                    return static_cast<ssize_t>(size);
+                }
+            }
+
+            return NGHTTP2_ERR_TEMPORAL_CALLBACK_FAILURE;
+        }
+
+       private:
+        boost::asio::ip::tcp::socket& m_socket;
+
+        shared::pooled_buffer_t& m_buffer;
+
+        const cfg::cfg_t& m_cfg;
+
+        dispatch_t m_dispatch;
+
+        nghttp2_session* m_session{};
+
+        /**
+         * @brief The streams, by identifier, until they are closed.
+         */
+        std::unordered_map<std::int32_t, std::shared_ptr<stream_t>> m_streams;
+
+        /**
+         * @brief The number of streams being served.
+         */
+        std::size_t m_active{};
+
+        bool m_is_closed{};
+
+        bool m_is_writing{};
+
+        boost::asio::steady_timer m_write_signal;
+
+        boost::asio::steady_timer m_idle;
+
+        boost::asio::steady_timer m_done;
+    };
+
+    c_connection::c_connection(
+        boost::asio::ip::tcp::socket& socket,
+        shared::pooled_buffer_t& buffer,
+        const cfg::cfg_t& cfg,
+        dispatch_t dispatch)
+        : m_impl{std::make_unique<c_impl>(socket, buffer, cfg, std::move(dispatch))} {
+    }
+
+    c_connection::~c_connection() noexcept = default;
+
+    shared::awaitable_t<void> c_connection::run() {
+        co_await m_impl->run();
+    }
+} // namespace clueapi::server::http2
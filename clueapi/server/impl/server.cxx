@@ -6,30 +6,80 @@
 
 #include "clueapi/server/server.hxx"
 
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <deque>
+#include <future>
+#include <limits>
 #include <mutex>
+#include <set>
 #include <thread>
+#include <vector>
 
+#include <boost/asio/buffer.hpp>
 #include <boost/asio/co_spawn.hpp>
 #include <boost/asio/detached.hpp>
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/redirect_error.hpp>
 #include <boost/asio/signal_set.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include <boost/asio/use_awaitable.hpp>
 #include <boost/system/error_code.hpp>
-#include <boost/lockfree/queue.hpp>
+
+#if defined(__linux__)
+#include <linux/filter.h>
+#include <sys/socket.h>
+#endif // __linux__
 
 #include "clueapi/modules/macros.hxx"
 
 #include "clueapi/server/client/client.hxx"
+#include "clueapi/server/detail/client_pool/client_pool.hxx"
 
 #include "clueapi/exceptions/exceptions.hxx"
 
+#include "clueapi/shared/buffer_pool/buffer_pool.hxx"
+#include "clueapi/shared/timer_wheel/timer_wheel.hxx"
+
 namespace clueapi::server {
     class c_server::c_impl {
        public:
+        /**
+         * @brief The per-worker sharded pool of clients.
+         *
+         * @internal
+         */
+        using client_pool_t = detail::client_pool_t<client::client_t>;
+
+        /**
+         * @brief The periodic task that trims idle clients of an elastic pool shard.
+         *
+         * @internal
+         */
+        struct trim_task_t {
+            explicit trim_task_t(boost::asio::io_context& io_ctx) : m_timer{io_ctx} {
+            }
+
+            boost::asio::steady_timer m_timer;
+
+            bool m_active{true};
+        };
+
+        /**
+         * @brief A connection waiting in the admission queue for a free client, or a paused
+         * accept loop waiting for the active connections to drop to the resume watermark.
+         *
+         * @internal
+         */
+        struct waiter_t {
+            explicit waiter_t(const boost::asio::any_io_executor& executor) : m_timer{executor} {
+            }
+
+            boost::asio::steady_timer m_timer;
+        };
+
         /**
          * @brief The state of the server instance.
          *
@@ -138,8 +188,6 @@ namespace clueapi::server {
               m_io_ctx_pool{io_ctx_pool},
               m_cfg{std::move(cfg)},
               m_state{state_t::stopped},
-              m_clients{cfg.m_server.m_acceptor.m_max_connections},
-              m_clients_storage{cfg.m_server.m_acceptor.m_max_connections},
               m_active_connections{0},
               m_total_connections{0} {
         }
@@ -165,6 +213,8 @@ namespace clueapi::server {
             }
 
             {
+                m_self->set_server_name(m_cfg.m_http.m_server_name);
+
                 m_self->set_keep_alive_timeout(fmt::format(
                     "timeout={}",
 
@@ -176,6 +226,20 @@ namespace clueapi::server {
             try {
                 init_clients();
 
+                init_access_log();
+
+                init_tracer();
+
+                init_tls();
+
+                start_timer_wheels();
+
+                init_buffer_pools();
+
+                init_admission();
+
+                start_trim_tasks();
+
                 setup_acceptor();
 
                 start_accept_loops();
@@ -190,6 +254,16 @@ namespace clueapi::server {
 
                 destroy_acceptor();
 
+                stop_trim_tasks();
+
+                stop_timer_wheels();
+
+                if (m_self->m_access_log)
+                    m_self->m_access_log->stop();
+
+                if (m_self->m_tracer)
+                    m_self->m_tracer->stop();
+
                 m_state.update(state_t::stopped);
 
                 throw;
@@ -218,7 +292,16 @@ namespace clueapi::server {
             {
                 destroy_acceptor();
 
+                notify_paused_loops();
+
                 destroy_clients();
+
+                // Kept alive, a client that outlived the shutdown deadline may still log into it
+                if (m_self->m_access_log)
+                    m_self->m_access_log->stop();
+
+                if (m_self->m_tracer)
+                    m_self->m_tracer->stop();
             }
 
             m_state.update(state_t::stopped);
@@ -236,20 +319,42 @@ namespace clueapi::server {
             return m_active_connections.load(std::memory_order_relaxed);
         }
 
+        [[nodiscard]] std::vector<client_pool_t::stats_t> client_pool_stats() const {
+            return m_clients.stats();
+        }
+
        private:
         void start_accept_loops() {
-            if (!m_acceptor)
+            if (m_acceptors.empty())
                 throw exceptions::exception_t(
                     "Cannot start accept loops: acceptor not initialized");
 
+            // Set the state to running before starting the accept loops
+            m_state.update(state_t::running);
+
+            if (m_acceptors.size() > 1) {
+                CLUEAPI_LOG_DEBUG(
+                    "Starting {} sharded accept loops, one per worker thread",
+
+                    m_acceptors.size());
+
+                for (std::size_t i{}; i < m_acceptors.size(); i++) {
+                    auto& acceptor = *m_acceptors[i];
+
+                    boost::asio::co_spawn(
+                        acceptor.get_executor(), accept_loop(i, acceptor), boost::asio::detached);
+                }
+
+                return;
+            }
+
+            auto& acceptor = *m_acceptors.front();
+
             auto* io_ctx = m_io_ctx_pool.io_ctx();
 
             if (!io_ctx)
                 throw exceptions::exception_t("No I/O context available for acceptor");
 
-            // Set the state to running before starting the accept loops
-            m_state.update(state_t::running);
-
             if (m_cfg.m_server.m_acceptor.m_reuse_port) {
 #ifdef SO_REUSEPORT
                 const auto acceptor_count =
@@ -262,7 +367,8 @@ namespace clueapi::server {
                     m_cfg.m_workers);
 
                 for (std::size_t i{}; i < acceptor_count; i++) {
-                    boost::asio::co_spawn(*io_ctx, accept_loop(i), boost::asio::detached);
+                    boost::asio::co_spawn(
+                        *io_ctx, accept_loop(i, acceptor), boost::asio::detached);
 
                     io_ctx = m_io_ctx_pool.io_ctx();
 
@@ -270,29 +376,40 @@ namespace clueapi::server {
                         throw exceptions::exception_t("No I/O context available for acceptor");
                 }
 #else
-                boost::asio::co_spawn(*io_ctx, accept_loop(0), boost::asio::detached);
+                boost::asio::co_spawn(*io_ctx, accept_loop(0, acceptor), boost::asio::detached);
 #endif
             } else
-                boost::asio::co_spawn(*io_ctx, accept_loop(0), boost::asio::detached);
+                boost::asio::co_spawn(*io_ctx, accept_loop(0, acceptor), boost::asio::detached);
         }
 
-        shared::awaitable_t<void> accept_loop(std::size_t loop_id) {
+        shared::awaitable_t<void> accept_loop(
+            std::size_t loop_id, boost::asio::ip::tcp::acceptor& acceptor) {
+            // In shard-per-core mode the connection stays on the worker that accepted it
+            const auto sharded = m_acceptors.size() > 1;
+
             while (is_running(std::memory_order_relaxed)) {
                 try {
+                    if (m_cfg.m_server.m_admission.m_enabled) {
+                        co_await wait_for_admission(loop_id, acceptor.get_executor());
+
+                        if (!is_running(std::memory_order_relaxed))
+                            break;
+                    }
+
                     boost::system::error_code ec;
 
-                    auto* io_ctx = m_io_ctx_pool.io_ctx();
+                    const auto ctx_idx = sharded ? loop_id : m_io_ctx_pool.next_idx();
 
-                    if (!io_ctx) {
-                        io_ctx = m_io_ctx_pool.io_ctx();
+                    auto* io_ctx = sharded ? nullptr : m_io_ctx_pool.io_ctx(ctx_idx);
 
-                        if (!io_ctx)
-                            throw exceptions::exception_t("No I/O context available for acceptor");
-                    }
+                    if (!sharded && !io_ctx)
+                        throw exceptions::exception_t("No I/O context available for acceptor");
 
-                    boost::asio::ip::tcp::socket socket(*io_ctx);
+                    boost::asio::ip::tcp::socket socket =
+                        sharded ? boost::asio::ip::tcp::socket{acceptor.get_executor()}
+                                : boost::asio::ip::tcp::socket{*io_ctx};
 
-                    co_await m_acceptor->async_accept(
+                    co_await acceptor.async_accept(
                         socket,
 
                         boost::asio::redirect_error(boost::asio::use_awaitable, ec));
@@ -313,10 +430,21 @@ namespace clueapi::server {
 
                     log_new_connection(socket, loop_id);
 
+                    auto executor = socket.get_executor();
+
+                    // Accounted before spawning so that load-aware selection and admission
+                    // control see it immediately
+                    m_active_connections.fetch_add(1, std::memory_order_relaxed);
+
+                    m_io_ctx_pool.add_connection(ctx_idx);
+
+                    m_io_ctx_pool.load(ctx_idx).m_queued_handlers.fetch_add(
+                        1, std::memory_order_relaxed);
+
                     boost::asio::co_spawn(
-                        *io_ctx,
+                        executor,
 
-                        handle_client_connection(std::move(socket)),
+                        handle_client_connection(std::move(socket), ctx_idx),
 
                         boost::asio::detached);
 
@@ -338,16 +466,24 @@ namespace clueapi::server {
             co_return;
         }
 
-        shared::awaitable_t<void> handle_client_connection(boost::asio::ip::tcp::socket socket) {
+        shared::awaitable_t<void> handle_client_connection(
+            boost::asio::ip::tcp::socket socket, std::size_t ctx_idx) {
+            m_io_ctx_pool.load(ctx_idx).m_queued_handlers.fetch_sub(1, std::memory_order_relaxed);
+
             std::int32_t socket_handle{};
 
-            client::client_t* client{};
+            client_pool_t::slot_t* slot{};
 
             try {
                 if (socket.is_open())
                     socket_handle = socket.native_handle();
 
-                client = acquire_client();
+                slot = acquire_client(ctx_idx);
+
+                if (!slot && has_wait_queue())
+                    slot = co_await wait_for_client(ctx_idx, socket.get_executor());
+
+                auto* client = slot ? slot->m_client.get() : nullptr;
 
                 if (!client) {
                     CLUEAPI_LOG_WARNING(
@@ -355,27 +491,27 @@ namespace clueapi::server {
 
                         socket_handle);
 
-                    close_socket_gracefully(socket);
+                    reject_connection(socket);
+                } else {
+                    update_socket_settings(socket);
 
-                    co_return;
-                }
+                    auto is_secured = true;
 
-                update_socket_settings(socket);
+                    if (m_self->m_tls)
+                        is_secured = co_await secure_connection(socket, socket_handle);
 
-                if (!client->prepare_for_connection(std::move(socket))) {
-                    CLUEAPI_LOG_ERROR(
-                        "Failed to prepare client for connection (id: {})", socket_handle);
-
-                    release_client(client);
+                    if (!is_secured)
+                        close_socket_gracefully(socket);
+                    else if (client->prepare_for_connection(
+                            std::move(socket), timer_wheel(ctx_idx), buffer_pool(ctx_idx))) {
+                        CLUEAPI_LOG_TRACE(
+                            "Client prepared for connection (id: {})", socket_handle);
 
-                    co_return;
+                        co_await client->start();
+                    } else
+                        CLUEAPI_LOG_ERROR(
+                            "Failed to prepare client for connection (id: {})", socket_handle);
                 }
-
-                CLUEAPI_LOG_TRACE("Client prepared for connection (id: {})", socket_handle);
-
-                m_active_connections.fetch_add(1, std::memory_order_relaxed);
-
-                co_await client->start();
             } catch (const std::exception& e) {
                 CLUEAPI_LOG_ERROR(
                     "Exception in client connection handler (id: {}): {}", socket_handle, e.what());
@@ -384,16 +520,334 @@ namespace clueapi::server {
                     "Unknown exception in client connection handler (id: {})", socket_handle);
             }
 
-            if (client)
-                release_client(client);
+            if (slot)
+                release_client(slot);
 
-            m_active_connections.fetch_sub(1, std::memory_order_relaxed);
+            const auto active_connections =
+                m_active_connections.fetch_sub(1, std::memory_order_relaxed) - 1;
+
+            if (m_accept_paused.load(std::memory_order_relaxed) &&
+                active_connections <= m_resume_watermark)
+                notify_paused_loops();
+
+            m_io_ctx_pool.remove_connection(ctx_idx);
 
             CLUEAPI_LOG_TRACE("Client connection handler completed (id: {})", socket_handle);
 
             co_return;
         }
 
+        /**
+         * @brief Runs the TLS handshake of a connection.
+         *
+         * @return `true` if the session is secured and the connection can be served, by the
+         * kernel or in user space.
+         */
+        shared::awaitable_t<bool> secure_connection(
+            boost::asio::ip::tcp::socket& socket, std::int32_t socket_handle) {
+            const auto result = co_await m_self->m_tls->handshake(socket);
+
+            switch (result.m_status) {
+                case detail::c_tls::e_status::offloaded:
+                    CLUEAPI_LOG_TRACE(
+                        "TLS session secured (id: {}, alpn: '{}', resumed: {})",
+
+                        socket_handle,
+                        result.m_alpn,
+                        result.m_resumed);
+
+                    co_return true;
+                case detail::c_tls::e_status::user_space:
+                    CLUEAPI_LOG_TRACE(
+                        "TLS session secured in user space (id: {}, alpn: '{}', resumed: {})",
+
+                        socket_handle,
+                        result.m_alpn,
+                        result.m_resumed);
+
+                    co_return true;
+                case detail::c_tls::e_status::not_offloaded:
+                    // Said once, every connection would say the same
+                    if (!m_ktls_warned.exchange(true, std::memory_order_relaxed))
+                        CLUEAPI_LOG_WARNING(
+                            "The kernel didn't take the TLS session of a connection, closing it. "
+                            "kTLS is required, are the version and the cipher offloadable?");
+
+                    co_return false;
+                default:
+                    CLUEAPI_LOG_TRACE("TLS handshake failed (id: {})", socket_handle);
+
+                    co_return false;
+            }
+        }
+
+        void init_access_log() {
+            if (!m_cfg.m_access_log.m_enabled)
+                return;
+
+            if (!m_self->m_access_log)
+                m_self->m_access_log = std::make_unique<detail::c_access_log>(m_cfg.m_access_log);
+
+            if (!m_self->m_access_log->start())
+                throw exceptions::exception_t(
+                    "Failed to open the access log '{}'", m_cfg.m_access_log.m_path);
+
+            CLUEAPI_LOG_DEBUG("Access log enabled: {}", m_cfg.m_access_log.m_path);
+        }
+
+        void init_tracer() {
+            if (!m_cfg.m_tracing.m_enabled)
+                return;
+
+            if (!m_self->m_tracer)
+                m_self->m_tracer = std::make_unique<detail::c_tracer>(m_cfg.m_tracing);
+
+            if (!m_self->m_tracer->start())
+                throw exceptions::exception_t("Tracing is enabled without a sink");
+
+            CLUEAPI_LOG_DEBUG("Tracing enabled");
+        }
+
+        void init_tls() {
+            if (!m_cfg.m_tls.m_enabled)
+                return;
+
+            auto tls_cfg = m_cfg.m_tls;
+
+            if (tls_cfg.m_alpn.empty()) {
+#ifdef CLUEAPI_USE_HTTP2
+                if (m_cfg.m_http2.m_enabled)
+                    tls_cfg.m_alpn.emplace_back("h2");
+#endif // CLUEAPI_USE_HTTP2
+
+                tls_cfg.m_alpn.emplace_back("http/1.1");
+            }
+
+            m_self->m_tls = std::make_unique<detail::c_tls>(std::move(tls_cfg));
+
+            m_self->m_tls->start();
+
+            CLUEAPI_LOG_DEBUG("TLS enabled: {}", m_cfg.m_tls.m_cert_file);
+        }
+
+        void init_admission() {
+            const auto& admission_cfg = m_cfg.m_server.m_admission;
+
+            if (!admission_cfg.m_enabled)
+                return;
+
+            const auto capacity = static_cast<float>(max_clients());
+
+            m_pause_watermark = std::max<std::size_t>(
+                static_cast<std::size_t>(capacity * std::max(admission_cfg.m_pause_ratio, 0.0f)),
+                1u);
+
+            m_resume_watermark = std::min<std::size_t>(
+                static_cast<std::size_t>(capacity * std::max(admission_cfg.m_resume_ratio, 0.0f)),
+                m_pause_watermark - 1);
+
+            m_overload_response = fmt::format(
+                "HTTP/1.1 503 Service Unavailable\r\n"
+                "Content-Length: 0\r\n"
+                "Retry-After: {}\r\n"
+                "Connection: close\r\n\r\n",
+
+                admission_cfg.m_retry_after.count());
+
+            CLUEAPI_LOG_DEBUG(
+                "Admission control enabled: pause at {}, resume at {}, wait queue {}",
+
+                m_pause_watermark,
+                m_resume_watermark,
+                admission_cfg.m_wait_queue_size);
+        }
+
+        shared::awaitable_t<void> wait_for_admission(
+            std::size_t loop_id, const boost::asio::any_io_executor& executor) {
+            if (!m_accept_paused.load(std::memory_order_relaxed)) {
+                if (m_active_connections.load(std::memory_order_relaxed) < m_pause_watermark)
+                    co_return;
+
+                if (!m_accept_paused.exchange(true, std::memory_order_relaxed)) {
+                    CLUEAPI_LOG_WARNING(
+                        "Pausing accept loops: {} active connections",
+
+                        m_active_connections.load(std::memory_order_relaxed));
+                }
+            }
+
+            auto waiter = std::make_shared<waiter_t>(executor);
+
+            // Not accepting leaves new connections in the kernel backlog instead of spending
+            // CPU on accepting and resetting them
+            while (is_running(std::memory_order_relaxed) &&
+                   m_accept_paused.load(std::memory_order_relaxed)) {
+                if (m_active_connections.load(std::memory_order_relaxed) <= m_resume_watermark) {
+                    if (m_accept_paused.exchange(false, std::memory_order_relaxed)) {
+                        CLUEAPI_LOG_INFO(
+                            "Resuming accept loops: {} active connections",
+
+                            m_active_connections.load(std::memory_order_relaxed));
+                    }
+
+                    break;
+                }
+
+                waiter->m_timer.expires_at(boost::asio::steady_timer::time_point::max());
+
+                {
+                    std::lock_guard lock{m_paused_loops_mutex};
+
+                    m_paused_loops.emplace_back(waiter);
+                }
+
+                // Re-checked after registration so that a release in between is not lost
+                if (is_running(std::memory_order_relaxed) &&
+                    m_active_connections.load(std::memory_order_relaxed) > m_resume_watermark) {
+                    boost::system::error_code ec{};
+
+                    co_await waiter->m_timer.async_wait(
+                        boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+                }
+
+                {
+                    std::lock_guard lock{m_paused_loops_mutex};
+
+                    std::erase(m_paused_loops, waiter);
+                }
+            }
+
+            CLUEAPI_LOG_TRACE("Accept loop {} admitted", loop_id);
+
+            co_return;
+        }
+
+        [[nodiscard]] bool has_wait_queue() const noexcept {
+            const auto& admission_cfg = m_cfg.m_server.m_admission;
+
+            return admission_cfg.m_enabled && admission_cfg.m_wait_queue_size > 0;
+        }
+
+        shared::awaitable_t<client_pool_t::slot_t*> wait_for_client(
+            std::size_t shard, boost::asio::any_io_executor executor) {
+            const auto& admission_cfg = m_cfg.m_server.m_admission;
+
+            if (m_num_waiters.fetch_add(1, std::memory_order_relaxed) >=
+                admission_cfg.m_wait_queue_size) {
+                m_num_waiters.fetch_sub(1, std::memory_order_relaxed);
+
+                co_return nullptr;
+            }
+
+            const auto deadline = std::chrono::steady_clock::now() + admission_cfg.m_wait_deadline;
+
+            client_pool_t::slot_t* slot{};
+
+            while (!slot && is_running(std::memory_order_relaxed) &&
+                   std::chrono::steady_clock::now() < deadline) {
+                auto waiter = std::make_shared<waiter_t>(executor);
+
+                waiter->m_timer.expires_at(deadline);
+
+                {
+                    std::lock_guard lock{m_waiters_mutex};
+
+                    m_waiters.emplace_back(waiter);
+                }
+
+                // Re-checked after registration so that a release in between is not lost
+                slot = acquire_client(shard);
+
+                if (!slot) {
+                    boost::system::error_code ec{};
+
+                    co_await waiter->m_timer.async_wait(
+                        boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+                }
+
+                {
+                    std::lock_guard lock{m_waiters_mutex};
+
+                    std::erase(m_waiters, waiter);
+                }
+
+                if (!slot)
+                    slot = acquire_client(shard);
+            }
+
+            m_num_waiters.fetch_sub(1, std::memory_order_relaxed);
+
+            co_return slot;
+        }
+
+        void notify_paused_loops() {
+            std::vector<std::shared_ptr<waiter_t>> paused_loops{};
+
+            {
+                std::lock_guard lock{m_paused_loops_mutex};
+
+                paused_loops.swap(m_paused_loops);
+            }
+
+            // Timers are not thread-safe, so each loop is woken up on its own executor
+            for (auto& waiter : paused_loops) {
+                auto executor = waiter->m_timer.get_executor();
+
+                boost::asio::post(
+                    executor, [waiter = std::move(waiter)] { waiter->m_timer.cancel(); });
+            }
+        }
+
+        void notify_waiter() {
+            if (m_num_waiters.load(std::memory_order_relaxed) == 0)
+                return;
+
+            std::shared_ptr<waiter_t> waiter{};
+
+            {
+                std::lock_guard lock{m_waiters_mutex};
+
+                if (m_waiters.empty())
+                    return;
+
+                waiter = std::move(m_waiters.front());
+
+                m_waiters.pop_front();
+            }
+
+            // Timers are not thread-safe, so the waiter is woken up on its own executor
+            auto executor = waiter->m_timer.get_executor();
+
+            boost::asio::post(executor, [waiter = std::move(waiter)] { waiter->m_timer.cancel(); });
+        }
+
+        void reject_connection(boost::asio::ip::tcp::socket& socket) {
+            const auto& admission_cfg = m_cfg.m_server.m_admission;
+
+            if (admission_cfg.m_enabled && admission_cfg.m_reject_with_503 &&
+                !m_overload_response.empty() && socket.is_open()) {
+                boost::system::error_code ec{};
+
+                // A single best-effort non-blocking write, the connection is closed right after
+                socket.non_blocking(true, ec);
+
+                if (!ec)
+                    socket.write_some(boost::asio::buffer(m_overload_response), ec);
+
+                if (!ec) {
+                    socket.shutdown(boost::asio::ip::tcp::socket::shutdown_send, ec);
+
+                    // Drains what the client already sent so that closing does not turn into a
+                    // reset that discards the response
+                    std::array<char, 4096> drain{};
+
+                    socket.read_some(boost::asio::buffer(drain), ec);
+                }
+            }
+
+            close_socket_gracefully(socket);
+        }
+
         void update_socket_settings(boost::asio::ip::tcp::socket& socket) const {
             boost::system::error_code ec;
 
@@ -517,7 +971,7 @@ namespace clueapi::server {
         void setup_acceptor() {
             CLUEAPI_LOG_TRACE("Setting up acceptor...");
 
-            if (m_acceptor) {
+            if (!m_acceptors.empty()) {
                 CLUEAPI_LOG_WARNING("Server already has an acceptor");
 
                 return;
@@ -545,26 +999,123 @@ namespace clueapi::server {
 
             CLUEAPI_LOG_TRACE("Creating TCP acceptor on {}:{}", addr.to_string(), port);
 
-            auto* io_ctx = m_io_ctx_pool.io_ctx();
+            const auto sharded = is_shard_per_core();
 
-            if (!io_ctx)
-                throw exceptions::exception_t("No I/O context available for acceptor");
+            const auto num_acceptors = sharded ? m_io_ctx_pool.size() : 1u;
+
+            m_acceptors.reserve(num_acceptors);
+
+            for (std::size_t i{}; i < num_acceptors; i++) {
+                auto* io_ctx = sharded ? m_io_ctx_pool.io_ctx(i) : m_io_ctx_pool.io_ctx();
 
-            m_acceptor = std::make_unique<boost::asio::ip::tcp::acceptor>(*io_ctx);
+                if (!io_ctx)
+                    throw exceptions::exception_t("No I/O context available for acceptor");
 
-            configure_acceptor(endpoint);
+                auto& acceptor = m_acceptors.emplace_back(
+                    std::make_unique<boost::asio::ip::tcp::acceptor>(*io_ctx));
+
+                configure_acceptor(*acceptor, endpoint);
+            }
+
+            if (sharded && m_cfg.m_server.m_acceptor.m_reuse_port_cbpf)
+                attach_reuse_port_cbpf(*m_acceptors.front(), m_acceptors.size());
+        }
+
+        [[nodiscard]] bool is_shard_per_core() const noexcept {
+#ifdef SO_REUSEPORT
+            const auto& acceptor_cfg = m_cfg.m_server.m_acceptor;
+
+            return acceptor_cfg.m_shard_per_core && acceptor_cfg.m_reuse_port &&
+                   m_io_ctx_pool.size() > 1;
+#else
+            return false;
+#endif
         }
 
-        void configure_acceptor(boost::asio::ip::tcp::endpoint& endpoint) {
-            if (!m_acceptor) {
-                CLUEAPI_LOG_WARNING("Server does not have an acceptor");
+        void attach_reuse_port_cbpf(
+            boost::asio::ip::tcp::acceptor& acceptor, std::size_t num_acceptors) {
+#if defined(__linux__) && defined(SO_ATTACH_REUSEPORT_CBPF)
+            const auto& placement = m_io_ctx_pool.placement();
+
+            // Steering only works if every acceptor runs on a CPU of its own, whatever the
+            // placement policy chose
+            std::set<std::int32_t> cpus{};
+
+            for (std::size_t i{}; i < num_acceptors; i++) {
+                const auto is_own_cpu = i < placement.size() && placement[i] >= 0 &&
+                                        cpus.insert(placement[i]).second;
+
+                if (!is_own_cpu) {
+                    CLUEAPI_LOG_WARNING(
+                        "Not attaching the reuseport CPU steering: worker {} isn't pinned to a "
+                        "CPU of its own",
+
+                        i);
+
+                    return;
+                }
+            }
+
+            // The index of a socket in the reuseport group is the index of its acceptor. A jump
+            // table maps the receiving CPU to the acceptor pinned to it, and a connection received
+            // on a CPU without a worker falls back to the CPU modulo the number of acceptors
+            std::vector<sock_filter> code{};
+
+            code.reserve(num_acceptors * 2u + 3u);
+
+            code.push_back(
+                {BPF_LD | BPF_W | BPF_ABS,
+                 0,
+                 0,
+                 static_cast<std::uint32_t>(SKF_AD_OFF + SKF_AD_CPU)});
+
+            for (std::size_t i{}; i < num_acceptors; i++) {
+                code.push_back(
+                    {BPF_JMP | BPF_JEQ | BPF_K, 0, 1, static_cast<std::uint32_t>(placement[i])});
+
+                code.push_back({BPF_RET | BPF_K, 0, 0, static_cast<std::uint32_t>(i)});
+            }
+
+            code.push_back(
+                {BPF_ALU | BPF_MOD | BPF_K, 0, 0, static_cast<std::uint32_t>(num_acceptors)});
+
+            code.push_back({BPF_RET | BPF_A, 0, 0, 0});
+
+            if (code.size() > BPF_MAXINSNS) {
+                CLUEAPI_LOG_WARNING("Not attaching the reuseport CPU steering: too many acceptors");
+
+                return;
+            }
+
+            sock_fprog prog{.len = static_cast<std::uint16_t>(code.size()), .filter = code.data()};
+
+            auto res = setsockopt(
+                acceptor.native_handle(),
+                SOL_SOCKET,
+                SO_ATTACH_REUSEPORT_CBPF,
+                &prog,
+                sizeof(prog));
+
+            if (res != 0) {
+                CLUEAPI_LOG_WARNING("Failed to attach SO_ATTACH_REUSEPORT_CBPF program");
 
                 return;
             }
 
+            CLUEAPI_LOG_DEBUG("Attached reuseport CPU steering for {} acceptors", num_acceptors);
+#else
+            (void)acceptor;
+            (void)num_acceptors;
+
+            CLUEAPI_LOG_WARNING("SO_ATTACH_REUSEPORT_CBPF is not supported on this platform");
+#endif
+        }
+
+        void configure_acceptor(
+            boost::asio::ip::tcp::acceptor& acceptor, boost::asio::ip::tcp::endpoint& endpoint) {
             boost::system::error_code ec;
 
-            m_acceptor->open(endpoint.protocol(), ec);
+            acceptor.open(endpoint.protocol(), ec);
 
             if (ec)
                 throw exceptions::exception_t("Failed to open acceptor: {}", ec.message());
@@ -572,7 +1123,7 @@ namespace clueapi::server {
             const auto& acceptor_cfg = m_cfg.m_server.m_acceptor;
 
             if (acceptor_cfg.m_reuse_address) {
-                m_acceptor->set_option(boost::asio::socket_base::reuse_address(true), ec);
+                acceptor.set_option(boost::asio::socket_base::reuse_address(true), ec);
 
                 if (ec)
                     CLUEAPI_LOG_WARNING("Failed to set SO_REUSEADDR: {}", ec.message());
@@ -583,7 +1134,7 @@ namespace clueapi::server {
                 auto socket_opt =
                     boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>(true);
 
-                m_acceptor->set_option(socket_opt, ec);
+                acceptor.set_option(socket_opt, ec);
 
                 if (ec)
                     CLUEAPI_LOG_WARNING("Failed to set SO_REUSEPORT: {}", ec.message());
@@ -595,7 +1146,7 @@ namespace clueapi::server {
                 auto socket_opt =
                     boost::asio::detail::socket_option::boolean<SOL_TCP, TCP_FASTOPEN>(true);
 
-                m_acceptor->set_option(socket_opt, ec);
+                acceptor.set_option(socket_opt, ec);
 
                 if (ec)
                     CLUEAPI_LOG_WARNING("Failed to set TCP_FASTOPEN: {}", ec.message());
@@ -603,25 +1154,27 @@ namespace clueapi::server {
             }
 
             if (acceptor_cfg.m_nonblocking) {
-                m_acceptor->non_blocking(true, ec);
+                acceptor.non_blocking(true, ec);
 
                 if (ec)
                     CLUEAPI_LOG_WARNING("Failed to set non-blocking mode: {}", ec.message());
             } else {
-                m_acceptor->non_blocking(false, ec);
+                acceptor.non_blocking(false, ec);
 
                 if (ec)
                     CLUEAPI_LOG_WARNING("Failed to set blocking mode: {}", ec.message());
             }
 
-            m_acceptor->bind(endpoint, ec);
+            acceptor.bind(endpoint, ec);
 
             if (ec)
                 throw exceptions::exception_t(
                     "Failed to bind to {}: {}", endpoint.address().to_string(), ec.message());
 
-            m_acceptor->listen(
-                static_cast<std::int32_t>(m_cfg.m_server.m_acceptor.m_max_connections), ec);
+            const auto backlog = acceptor_cfg.m_backlog ? acceptor_cfg.m_backlog
+                                                         : acceptor_cfg.m_max_connections;
+
+            acceptor.listen(static_cast<std::int32_t>(backlog), ec);
 
             if (ec)
                 throw exceptions::exception_t("Failed to listen: {}", ec.message());
@@ -633,22 +1186,93 @@ namespace clueapi::server {
                 endpoint.port());
         }
 
-        void init_clients() {
-            const auto num_clients = m_cfg.m_server.m_acceptor.m_max_connections;
+        [[nodiscard]] bool is_elastic_pool() const noexcept {
+            return m_cfg.m_server.m_client.m_elastic_pool;
+        }
+
+        [[nodiscard]] std::size_t max_clients() const noexcept {
+            const auto max_connections = m_cfg.m_server.m_acceptor.m_max_connections;
+
+            if (!is_elastic_pool() || m_cfg.m_server.m_client.m_max_clients == 0)
+                return max_connections;
+
+            return m_cfg.m_server.m_client.m_max_clients;
+        }
+
+        template <typename _fn_t>
+        auto post_to_shard(std::size_t shard, _fn_t&& fn) -> std::future<decltype(fn())> {
+            auto task =
+                std::make_shared<std::packaged_task<decltype(fn())()>>(std::forward<_fn_t>(fn));
+
+            auto result = task->get_future();
+
+            auto* io_ctx = m_io_ctx_pool.io_ctx(shard);
 
-            CLUEAPI_LOG_TRACE("Initializing client pool with {} clients", num_clients);
+            // Runs inline when waiting for the worker would never complete
+            if (!io_ctx || io_ctx->stopped() || io_ctx->get_executor().running_in_this_thread())
+                (*task)();
+            else
+                m_io_ctx_pool.post(shard, [task] { (*task)(); });
 
-            if (num_clients == 0)
+            return result;
+        }
+
+        void init_clients() {
+            if (m_cfg.m_server.m_acceptor.m_max_connections == 0)
                 throw exceptions::exception_t(
                     "Invalid max_connections configuration: cannot be zero");
 
-            m_clients_storage.clear();
+            const auto num_clients = is_elastic_pool()
+                                         ? std::min(m_cfg.m_server.m_client.m_warm_clients,
+                                                    max_clients())
+                                         : max_clients();
 
-            m_clients_storage.reserve(num_clients);
+            CLUEAPI_LOG_TRACE(
+                "Initializing {} client pool with {} clients",
 
+                is_elastic_pool() ? "elastic" : "fixed",
+                num_clients);
+
+            const auto num_shards = std::max<std::size_t>(m_io_ctx_pool.size(), 1u);
+
+            m_clients.init(num_shards);
+
+            // Every shard is filled on its own worker so that client buffers are first touched
+            // (and thus allocated) on the worker's NUMA node
+            std::vector<std::future<std::size_t>> created_per_shard{};
+
+            created_per_shard.reserve(num_shards);
+
+            for (std::size_t shard{}; shard < num_shards; shard++) {
+                const auto count =
+                    num_clients / num_shards + (shard < num_clients % num_shards ? 1u : 0u);
+
+                created_per_shard.emplace_back(post_to_shard(
+                    shard,
+
+                    [this, shard, count] { return fill_shard(shard, count); }));
+            }
+
+            std::size_t created_clients{};
+
+            for (auto& created : created_per_shard)
+                created_clients += created.get();
+
+            if (created_clients == 0 && num_clients != 0)
+                throw exceptions::exception_t("Failed to create any clients for the pool");
+
+            CLUEAPI_LOG_DEBUG(
+                "Client pool initialized with {}/{} clients in {} shards",
+
+                created_clients,
+                num_clients,
+                num_shards);
+        }
+
+        std::size_t fill_shard(std::size_t shard, std::size_t count) {
             std::size_t created_clients{};
 
-            for (std::size_t i{}; i < num_clients; i++) {
+            for (std::size_t i{}; i < count; i++) {
                 try {
                     auto client = std::make_unique<client::client_t>(*m_self, m_cfg);
 
@@ -658,15 +1282,7 @@ namespace clueapi::server {
                         continue;
                     }
 
-                    m_clients_storage.emplace_back(std::move(client));
-
-                    if (!m_clients.push(m_clients_storage.back().get())) {
-                        CLUEAPI_LOG_ERROR("Failed to add client {} to pool", i);
-
-                        m_clients_storage.pop_back();
-
-                        break;
-                    }
+                    m_clients.add(shard, std::move(client));
 
                     ++created_clients;
                 } catch (const std::exception& e) {
@@ -676,28 +1292,23 @@ namespace clueapi::server {
                 }
             }
 
-            if (created_clients == 0)
-                throw exceptions::exception_t("Failed to create any clients for the pool");
-
-            CLUEAPI_LOG_DEBUG(
-                "Client pool initialized with {}/{} clients", created_clients, num_clients);
+            return created_clients;
         }
 
-        client::client_t* acquire_client() {
-            client::client_t* client{};
-
+        client_pool_t::slot_t* acquire_client(std::size_t shard) {
             std::size_t attempts{};
 
             constexpr std::size_t k_max_attempts = 3;
 
-            while (attempts < k_max_attempts && m_clients.pop(client)) {
-                ++attempts;
+            while (attempts < k_max_attempts) {
+                auto* slot = m_clients.acquire(shard);
 
-                if (!client) {
-                    CLUEAPI_LOG_WARNING("Retrieved null client from pool (attempt {})", attempts);
+                if (!slot)
+                    break;
 
-                    continue;
-                }
+                ++attempts;
+
+                auto* client = slot->m_client.get();
 
                 if (!client->is_ready_for_reuse()) {
                     CLUEAPI_LOG_WARNING(
@@ -707,17 +1318,31 @@ namespace clueapi::server {
 
                     client->return_to_pool();
 
-                    if (client->is_ready_for_reuse()) {
-                        if (!m_clients.push(client))
-                            CLUEAPI_LOG_WARNING("Failed to return cleaned client to pool");
-                    }
+                    if (client->is_ready_for_reuse())
+                        m_clients.release(slot);
 
                     continue;
                 }
 
                 CLUEAPI_LOG_TRACE("Successfully acquired client from pool");
 
-                return client;
+                return slot;
+            }
+
+            if (is_elastic_pool()) {
+                try {
+                    auto* slot = m_clients.grow(shard, max_clients(), [this] {
+                        return std::make_unique<client::client_t>(*m_self, m_cfg);
+                    });
+
+                    if (slot) {
+                        CLUEAPI_LOG_TRACE("Grew client pool to {} clients", m_clients.capacity());
+
+                        return slot;
+                    }
+                } catch (const std::exception& e) {
+                    CLUEAPI_LOG_ERROR("Failed to grow client pool: {}", e.what());
+                }
             }
 
             CLUEAPI_LOG_TRACE("Failed to acquire client from pool after {} attempts", attempts);
@@ -725,28 +1350,29 @@ namespace clueapi::server {
             return nullptr;
         }
 
-        void release_client(client::client_t* client) {
-            if (!client) {
+        void release_client(client_pool_t::slot_t* slot) {
+            if (!slot || !slot->m_client) {
                 CLUEAPI_LOG_WARNING("Attempting to release null client");
 
                 return;
             }
 
             try {
-                client->return_to_pool();
+                slot->m_client->return_to_pool();
 
-                if (!client->is_ready_for_reuse()) {
+                if (!slot->m_client->is_ready_for_reuse()) {
                     CLUEAPI_LOG_ERROR(
                         "Client failed to return to idle state - not returning to pool");
 
                     return;
                 }
 
-                if (!m_clients.push(client)) {
-                    CLUEAPI_LOG_WARNING("Failed to return client to pool - pool may be full");
+                if (is_elastic_pool())
+                    slot->m_client->release_buffers();
 
-                    return;
-                }
+                m_clients.release(slot);
+
+                notify_waiter();
 
                 CLUEAPI_LOG_TRACE("Successfully returned client to pool");
             } catch (const std::exception& e) {
@@ -756,16 +1382,179 @@ namespace clueapi::server {
             }
         }
 
-        void destroy_clients() {
-            CLUEAPI_LOG_TRACE("Destroying client pool");
+        void start_trim_tasks() {
+            if (!is_elastic_pool())
+                return;
+
+            const auto idle_timeout = m_cfg.m_server.m_client.m_idle_timeout;
+
+            if (idle_timeout.count() <= 0)
+                return;
+
+            const auto num_shards = m_clients.num_shards();
+
+            for (std::size_t shard{}; shard < num_shards; shard++) {
+                auto* io_ctx = m_io_ctx_pool.io_ctx(shard);
+
+                if (!io_ctx)
+                    continue;
 
-            for (const auto& client : m_clients_storage) {
-                if (!client || client->is_ready_for_reuse())
+                auto task = std::make_shared<trim_task_t>(*io_ctx);
+
+                m_trim_tasks.emplace_back(task);
+
+                arm_trim_task(std::move(task), shard);
+            }
+
+            CLUEAPI_LOG_DEBUG("Started {} client pool trim tasks", m_trim_tasks.size());
+        }
+
+        void arm_trim_task(std::shared_ptr<trim_task_t> task, std::size_t shard) {
+            const auto idle_timeout = m_cfg.m_server.m_client.m_idle_timeout;
+
+            auto& timer = task->m_timer;
+
+            timer.expires_after(
+                std::max<std::chrono::seconds>(idle_timeout / 2, std::chrono::seconds{1}));
+
+            timer.async_wait([this, task = std::move(task), shard, idle_timeout](
+                                 const boost::system::error_code& ec) mutable {
+                // Only touched on the shard's own worker, so no synchronization is required
+                if (ec || !task->m_active)
+                    return;
+
+                const auto num_shards = std::max<std::size_t>(m_clients.num_shards(), 1u);
+
+                const auto warm_clients = m_cfg.m_server.m_client.m_warm_clients;
+
+                const auto keep = (warm_clients + num_shards - 1) / num_shards;
+
+                if (auto trimmed = m_clients.trim(shard, keep, idle_timeout); trimmed > 0) {
+                    CLUEAPI_LOG_TRACE(
+                        "Trimmed {} idle client(s) from shard {}, {} left in pool",
+
+                        trimmed,
+                        shard,
+                        m_clients.capacity());
+                }
+
+                arm_trim_task(std::move(task), shard);
+            });
+        }
+
+        void stop_trim_tasks() {
+            for (std::size_t shard{}; shard < m_trim_tasks.size(); shard++) {
+                auto& task = m_trim_tasks[shard];
+
+                post_to_shard(shard, [&task] {
+                    task->m_active = false;
+
+                    task->m_timer.cancel();
+                }).get();
+            }
+
+            m_trim_tasks.clear();
+        }
+
+        void start_timer_wheels() {
+            const auto tick = m_cfg.m_server.m_timer_wheel_tick;
+
+            if (tick.count() <= 0)
+                return;
+
+            const auto num_workers = m_io_ctx_pool.size();
+
+            m_timer_wheels.reserve(num_workers);
+
+            for (std::size_t i{}; i < num_workers; i++) {
+                auto* io_ctx = m_io_ctx_pool.io_ctx(i);
+
+                if (!io_ctx) {
+                    m_timer_wheels.emplace_back();
+
+                    continue;
+                }
+
+                auto wheel = std::make_shared<shared::timer_wheel_t>(*io_ctx, tick);
+
+                post_to_shard(i, [&wheel] { wheel->start(); }).get();
+
+                m_timer_wheels.emplace_back(std::move(wheel));
+            }
+
+            CLUEAPI_LOG_DEBUG(
+                "Started {} connection timer wheel(s) with a {}ms tick",
+
+                m_timer_wheels.size(),
+                tick.count());
+        }
+
+        void stop_timer_wheels() {
+            for (std::size_t i{}; i < m_timer_wheels.size(); i++) {
+                auto& wheel = m_timer_wheels[i];
+
+                if (!wheel)
                     continue;
 
-                client->return_to_pool();
+                post_to_shard(i, [&wheel] { wheel->stop(); }).get();
             }
 
+            m_timer_wheels.clear();
+        }
+
+        [[nodiscard]] shared::timer_wheel_t* timer_wheel(std::size_t ctx_idx) const noexcept {
+            if (ctx_idx >= m_timer_wheels.size())
+                return nullptr;
+
+            return m_timer_wheels[ctx_idx].get();
+        }
+
+        void init_buffer_pools() {
+            const auto& client_cfg = m_cfg.m_server.m_client;
+
+            if (!client_cfg.m_buffer_pool.m_enabled)
+                return;
+
+            // Kept across restarts, the buffers of the clients still refer to them
+            if (!m_buffer_pools.empty())
+                return;
+
+            const auto num_workers = m_io_ctx_pool.size();
+
+            m_buffer_pools.reserve(num_workers);
+
+            for (std::size_t i{}; i < num_workers; i++)
+                m_buffer_pools.emplace_back(std::make_shared<shared::buffer_pool_t>(
+                    client_cfg.m_buffer_pool, client_cfg.m_buffer_capacity));
+
+            CLUEAPI_LOG_DEBUG(
+                "Created {} buffer pool(s) with {} and {} byte chunks",
+
+                m_buffer_pools.size(),
+                client_cfg.m_buffer_pool.m_chunk_size,
+                client_cfg.m_buffer_capacity);
+        }
+
+        [[nodiscard]] std::shared_ptr<shared::buffer_pool_t> buffer_pool(
+            std::size_t ctx_idx) const noexcept {
+            if (ctx_idx >= m_buffer_pools.size())
+                return nullptr;
+
+            return m_buffer_pools[ctx_idx];
+        }
+
+        void destroy_clients() {
+            CLUEAPI_LOG_TRACE("Destroying client pool");
+
+            stop_trim_tasks();
+
+            m_clients.for_each([](client::client_t& client) {
+                if (client.is_ready_for_reuse())
+                    return;
+
+                client.return_to_pool();
+            });
+
             if (m_active_connections.load(std::memory_order_acquire) > 0) {
                 CLUEAPI_LOG_TRACE(
                     "Waiting for {} active client(s) to finish", m_active_connections.load());
@@ -787,51 +1576,58 @@ namespace clueapi::server {
                 }
             }
 
-            std::size_t clients_in_pool{};
+            const auto stats = m_clients.stats();
 
-            {
-                client::client_t* client{};
+            for (std::size_t i{}; i < stats.size(); i++) {
+                CLUEAPI_LOG_DEBUG(
+                    "Client pool shard {}: {} clients, {} acquired, {} stolen, {} misses",
 
-                while (m_clients.pop(client))
-                    clients_in_pool++;
+                    i,
+                    stats[i].m_capacity,
+                    stats[i].m_acquired,
+                    stats[i].m_stolen,
+                    stats[i].m_misses);
             }
 
-            if (clients_in_pool == m_clients_storage.size()) {
+            // Entries are disarmed on the workers before the clients that own them are destroyed
+            stop_timer_wheels();
+
+            if (m_clients.available() == m_clients.capacity()) {
                 CLUEAPI_LOG_TRACE("All clients successfully destroyed");
             } else
                 CLUEAPI_LOG_WARNING("Client pool is not empty after destroying clients");
 
-            m_clients_storage.clear();
+            m_clients.clear();
         }
 
         void destroy_acceptor() {
-            if (!m_acceptor) {
+            if (m_acceptors.empty()) {
                 CLUEAPI_LOG_TRACE("Acceptor is already destroyed or not initialized");
 
                 return;
             }
 
-            if (!m_acceptor->is_open()) {
-                CLUEAPI_LOG_TRACE("Acceptor is already closed");
+            for (auto& acceptor : m_acceptors) {
+                if (!acceptor || !acceptor->is_open()) {
+                    CLUEAPI_LOG_TRACE("Acceptor is already closed");
 
-                m_acceptor.reset();
-
-                return;
-            }
+                    continue;
+                }
 
-            boost::system::error_code ec;
+                boost::system::error_code ec;
 
-            m_acceptor->cancel(ec);
+                acceptor->cancel(ec);
 
-            if (ec)
-                CLUEAPI_LOG_WARNING("Failed to cancel acceptor: {}", ec.message());
+                if (ec)
+                    CLUEAPI_LOG_WARNING("Failed to cancel acceptor: {}", ec.message());
 
-            m_acceptor->close(ec);
+                acceptor->close(ec);
 
-            if (ec)
-                CLUEAPI_LOG_WARNING("Failed to close acceptor: {}", ec.message());
+                if (ec)
+                    CLUEAPI_LOG_WARNING("Failed to close acceptor: {}", ec.message());
+            }
 
-            m_acceptor.reset();
+            m_acceptors.clear();
 
             CLUEAPI_LOG_DEBUG("Acceptor successfully destroyed");
         }
@@ -863,6 +1659,19 @@ namespace clueapi::server {
             if (ec)
                 return false;
 
+#ifdef SO_REUSEPORT
+            // A listener of the same reuseport group, e.g. another prefork worker, doesn't make
+            // the port unavailable
+            if (m_cfg.m_server.m_acceptor.m_reuse_port) {
+                test_acceptor.set_option(
+                    boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>(true),
+                    ec);
+
+                if (ec)
+                    return false;
+            }
+#endif // SO_REUSEPORT
+
             test_acceptor.bind(endpoint, ec);
 
             if (ec)
@@ -880,16 +1689,43 @@ namespace clueapi::server {
 
         shared::io_ctx_pool_t& m_io_ctx_pool;
 
-        boost::lockfree::queue<client::client_t*> m_clients;
+        client_pool_t m_clients;
+
+        std::vector<std::shared_ptr<trim_task_t>> m_trim_tasks;
+
+        std::vector<std::shared_ptr<shared::timer_wheel_t>> m_timer_wheels;
+
+        std::vector<std::shared_ptr<shared::buffer_pool_t>> m_buffer_pools;
+
+        std::mutex m_waiters_mutex;
+
+        std::deque<std::shared_ptr<waiter_t>> m_waiters;
+
+        std::atomic<std::size_t> m_num_waiters{0};
 
-        std::vector<std::unique_ptr<client::client_t>> m_clients_storage;
+        std::mutex m_paused_loops_mutex;
 
-        std::unique_ptr<boost::asio::ip::tcp::acceptor> m_acceptor;
+        std::vector<std::shared_ptr<waiter_t>> m_paused_loops;
+
+        std::atomic<bool> m_accept_paused{false};
+
+        std::size_t m_pause_watermark{std::numeric_limits<std::size_t>::max()};
+
+        std::size_t m_resume_watermark{0};
+
+        std::string m_overload_response;
+
+        std::vector<std::unique_ptr<boost::asio::ip::tcp::acceptor>> m_acceptors;
 
         std::atomic<std::size_t> m_active_connections;
 
         std::atomic<std::size_t> m_total_connections;
 
+        /**
+         * @brief Set once the connections the kernel couldn't secure were warned about.
+         */
+        std::atomic<bool> m_ktls_warned{false};
+
         state_t m_state;
 
         cfg::cfg_t m_cfg;
@@ -898,7 +1734,7 @@ namespace clueapi::server {
     c_server::c_server(
         c_clueapi& clueapi,
         shared::io_ctx_pool_t& io_ctx_pool,
-        middleware::next_t& middleware_chain,
+        middleware::middleware_chain_t& middleware_chain,
         cfg::cfg_t cfg)
         : m_impl{std::make_unique<c_impl>(this, clueapi, io_ctx_pool, std::move(cfg))},
           m_clueapi(clueapi),
@@ -918,4 +1754,16 @@ namespace clueapi::server {
     bool c_server::is_running(std::memory_order m) const noexcept {
         return m_impl->is_running(m);
     }
+
+    std::size_t c_server::get_total_connections() const noexcept {
+        return m_impl->get_total_connections();
+    }
+
+    std::size_t c_server::get_active_connections() const noexcept {
+        return m_impl->get_active_connections();
+    }
+
+    std::vector<c_server::client_pool_stats_t> c_server::client_pool_stats() const {
+        return m_impl->client_pool_stats();
+    }
 } // namespace clueapi::server
\ No newline at end of file
@@ -11,11 +11,17 @@
 #include <cstddef>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "clueapi/cfg/cfg.hxx"
 
 #include "clueapi/middleware/middleware.hxx"
 
+#include "clueapi/server/detail/access_log/access_log.hxx"
+#include "clueapi/server/detail/tls/tls.hxx"
+#include "clueapi/server/detail/tracer/tracer.hxx"
+#include "clueapi/server/detail/client_pool/client_pool.hxx"
+
 #include "clueapi/shared/io_ctx_pool/io_ctx_pool.hxx"
 #include "clueapi/shared/macros.hxx"
 
@@ -27,7 +33,13 @@ namespace clueapi {
         struct client_t;
 
         namespace detail {
+            struct req_handler_t;
+
             struct response_handler_t;
+
+            struct websocket_handler_t;
+
+            struct http2_handler_t;
         }
     } // namespace server::client
 } // namespace clueapi
@@ -51,6 +63,12 @@ namespace clueapi::server {
      * @internal
      */
     class c_server {
+       public:
+        /**
+         * @brief Type alias for a snapshot of a single client pool shard.
+         */
+        using client_pool_stats_t = detail::client_pool_t<client::client_t>::stats_t;
+
        public:
         /**
          * @brief Constructs a new server instance.
@@ -63,7 +81,7 @@ namespace clueapi::server {
         c_server(
             c_clueapi& clueapi,
             shared::io_ctx_pool_t& io_ctx_pool,
-            middleware::next_t& middleware_chain,
+            middleware::middleware_chain_t& middleware_chain,
             cfg::cfg_t cfg);
 
         ~c_server();
@@ -90,6 +108,23 @@ namespace clueapi::server {
         [[nodiscard]] bool is_running(
             std::memory_order m = std::memory_order_acquire) const noexcept;
 
+        /**
+         * @brief Gets the number of connections accepted since the server started.
+         */
+        [[nodiscard]] std::size_t get_total_connections() const noexcept;
+
+        /**
+         * @brief Gets the number of connections being served.
+         */
+        [[nodiscard]] std::size_t get_active_connections() const noexcept;
+
+        /**
+         * @brief Takes a snapshot of the client pool counters, one entry per worker shard.
+         *
+         * @return The shard snapshots, in worker order.
+         */
+        [[nodiscard]] std::vector<client_pool_stats_t> client_pool_stats() const;
+
        public:
         /**
          * @brief Gets the formatted Keep-Alive timeout string for use in HTTP headers.
@@ -107,13 +142,71 @@ namespace clueapi::server {
          */
         CLUEAPI_INLINE void set_keep_alive_timeout(const std::string_view& timeout) noexcept {
             m_keep_alive_timeout_str = timeout;
+
+            build_header_blocks();
+        }
+
+        /**
+         * @brief Sets the value of the `Server` header, empty to leave it out.
+         *
+         * @param name The name of the server.
+         */
+        CLUEAPI_INLINE void set_server_name(const std::string_view& name) noexcept {
+            m_server_name = name;
+
+            build_header_blocks();
+        }
+
+        /**
+         * @brief Gets the serialized header lines of a response on a persistent connection.
+         *
+         * @return The `Server`, `Connection` and `Keep-Alive` lines, each ending with CRLF.
+         */
+        [[nodiscard]] CLUEAPI_INLINE std::string_view keep_alive_block() const noexcept {
+            return m_keep_alive_block;
+        }
+
+        /**
+         * @brief Gets the serialized header lines of a response that closes the connection.
+         *
+         * @return The `Server` and `Connection` lines, each ending with CRLF.
+         */
+        [[nodiscard]] CLUEAPI_INLINE std::string_view close_block() const noexcept {
+            return m_close_block;
+        }
+
+       private:
+        /**
+         * @brief Rebuilds the header blocks shared by every response.
+         */
+        CLUEAPI_INLINE void build_header_blocks() {
+            std::string server_line{};
+
+            if (!m_server_name.empty())
+                server_line.append("Server: ").append(m_server_name).append("\r\n");
+
+            m_keep_alive_block = server_line;
+
+            m_keep_alive_block.append("Connection: keep-alive\r\nKeep-Alive: ")
+                .append(m_keep_alive_timeout_str)
+                .append("\r\n");
+
+            m_close_block = std::move(server_line);
+
+            m_close_block.append("Connection: close\r\n");
         }
 
        private:
         friend struct client::client_t;
 
+        friend struct client::detail::req_handler_t;
+
         friend struct client::detail::response_handler_t;
 
+        friend struct client::detail::websocket_handler_t;
+
+        friend struct client::detail::http2_handler_t;
+
         [[nodiscard]] CLUEAPI_INLINE c_clueapi& clueapi() const noexcept {
             return m_clueapi;
         }
@@ -123,6 +216,27 @@ namespace clueapi::server {
             return m_middleware_chain;
         }
 
+        /**
+         * @brief Gets the access log, `nullptr` while it is disabled.
+         */
+        [[nodiscard]] CLUEAPI_INLINE detail::c_access_log* access_log() const noexcept {
+            return m_access_log.get();
+        }
+
+        /**
+         * @brief Gets the tracer, `nullptr` while tracing is disabled.
+         */
+        [[nodiscard]] CLUEAPI_INLINE detail::c_tracer* tracer() const noexcept {
+            return m_tracer.get();
+        }
+
+        /**
+         * @brief Gets the TLS termination, `nullptr` while TLS is disabled.
+         */
+        [[nodiscard]] CLUEAPI_INLINE detail::c_tls* tls() const noexcept {
+            return m_tls.get();
+        }
+
        private:
         /**
          * @brief A reference to the main clueapi application instance.
@@ -139,6 +253,36 @@ namespace clueapi::server {
          */
         std::string m_keep_alive_timeout_str;
 
+        /**
+         * @brief The value of the `Server` header.
+         */
+        std::string m_server_name;
+
+        /**
+         * @brief The header lines of a response on a persistent connection.
+         */
+        std::string m_keep_alive_block;
+
+        /**
+         * @brief The header lines of a response that closes the connection.
+         */
+        std::string m_close_block;
+
+        /**
+         * @brief The access log, created by `start()` when it is enabled.
+         */
+        std::unique_ptr<detail::c_access_log> m_access_log;
+
+        /**
+         * @brief The tracer, created by `start()` when tracing is enabled.
+         */
+        std::unique_ptr<detail::c_tracer> m_tracer;
+
+        /**
+         * @brief The TLS termination, created by `start()` when TLS is enabled.
+         */
+        std::unique_ptr<detail::c_tls> m_tls;
+
        private:
         /**
          * @class c_impl
@@ -0,0 +1,236 @@
+/**
+ * @file arena.hxx
+ *
+ * @brief This file includes the `arena_t` struct, a monotonic memory resource that is reset
+ * between the requests of a connection.
+ */
+
+#ifndef CLUEAPI_SHARED_ARENA_HXX
+#define CLUEAPI_SHARED_ARENA_HXX
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+#include "clueapi/shared/macros.hxx"
+
+namespace clueapi::shared {
+    /**
+     * @struct arena_t
+     *
+     * @brief A monotonic `std::pmr::memory_resource` whose blocks are kept across resets.
+     *
+     * @details Allocations bump a pointer in the current block and deallocations are no-ops.
+     * `reset()` rewinds to the first block instead of returning the blocks upstream, so once a
+     * connection has seen its largest request, later requests are served without touching the
+     * global heap. Blocks grow geometrically from `k_def_block_size` and an allocation larger
+     * than a block gets a block of its own.
+     *
+     * @note The arena is not synchronized. Everything allocated from it must be destroyed, or at
+     * least never touched again, before `reset()` is called.
+     */
+    struct arena_t final : std::pmr::memory_resource {
+        /**
+         * @brief The default size of the first block.
+         */
+        static constexpr std::size_t k_def_block_size{4096};
+
+        /**
+         * @brief The maximum size of a block allocated when the arena grows.
+         */
+        static constexpr std::size_t k_max_block_size{1024 * 1024};
+
+        /**
+         * @brief Type alias for the allocator of containers placed in the arena.
+         */
+        using allocator_t = std::pmr::polymorphic_allocator<char>;
+
+       public:
+        /**
+         * @brief Constructs an arena.
+         *
+         * @param block_size The size of the first block, allocated on the first allocation.
+         * @param upstream The resource the blocks are allocated from.
+         */
+        explicit arena_t(
+            std::size_t block_size = k_def_block_size,
+            std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()) noexcept;
+
+        ~arena_t() noexcept override;
+
+        // Copy constructor
+        CLUEAPI_INLINE arena_t(const arena_t&) = delete;
+
+        // Copy assignment operator
+        CLUEAPI_INLINE arena_t& operator=(const arena_t&) = delete;
+
+        // Move constructor
+        CLUEAPI_INLINE arena_t(arena_t&&) = delete;
+
+        // Move assignment operator
+        CLUEAPI_INLINE arena_t& operator=(arena_t&&) = delete;
+
+       public:
+        /**
+         * @brief Rewinds the arena, keeping its blocks for the next allocations.
+         */
+        void reset() noexcept;
+
+        /**
+         * @brief Returns all the blocks to the upstream resource.
+         */
+        void release() noexcept;
+
+        /**
+         * @brief Gets an allocator that places objects in the arena.
+         *
+         * @return The allocator.
+         */
+        [[nodiscard]] CLUEAPI_INLINE allocator_t allocator() noexcept {
+            return allocator_t{this};
+        }
+
+        /**
+         * @brief Gets the number of bytes allocated since the last reset.
+         *
+         * @return The number of bytes.
+         */
+        [[nodiscard]] CLUEAPI_INLINE std::size_t bytes_used() const noexcept {
+            return m_bytes_used;
+        }
+
+        /**
+         * @brief Gets the total size of the blocks owned by the arena.
+         *
+         * @return The number of bytes.
+         */
+        [[nodiscard]] CLUEAPI_INLINE std::size_t capacity() const noexcept {
+            return m_capacity;
+        }
+
+        /**
+         * @brief Gets the number of blocks allocated from the upstream resource.
+         *
+         * @return The number of blocks, which stops growing once the arena has warmed up.
+         */
+        [[nodiscard]] CLUEAPI_INLINE std::size_t upstream_allocations() const noexcept {
+            return m_upstream_allocations;
+        }
+
+        /**
+         * @brief Gets the number of allocations served since the last reset.
+         *
+         * @return The number of allocations.
+         *
+         * @note Only counted in debug builds, always `0` in release builds.
+         */
+        [[nodiscard]] CLUEAPI_INLINE std::size_t allocations() const noexcept {
+            return m_allocations;
+        }
+
+       private:
+        /**
+         * @brief Allocates memory from the arena.
+         */
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+
+        /**
+         * @brief Does nothing, the memory is reclaimed by `reset()`.
+         */
+        CLUEAPI_INLINE void do_deallocate(void*, std::size_t, std::size_t) noexcept override {
+        }
+
+        /**
+         * @brief Checks if another resource is this arena.
+         */
+        [[nodiscard]] CLUEAPI_INLINE bool do_is_equal(
+            const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+
+        /**
+         * @brief Moves to the next block that fits an allocation, allocating it if needed.
+         */
+        void next_block(std::size_t bytes, std::size_t alignment);
+
+       private:
+        /**
+         * @struct block_t
+         *
+         * @brief A block of memory owned by the arena.
+         */
+        struct block_t {
+            /**
+             * @brief The beginning of the block.
+             */
+            std::byte* m_data{};
+
+            /**
+             * @brief The size of the block.
+             */
+            std::size_t m_size{};
+
+            /**
+             * @brief The alignment the block was allocated with.
+             */
+            std::size_t m_alignment{};
+        };
+
+        /**
+         * @brief The resource the blocks are allocated from.
+         */
+        std::pmr::memory_resource* m_upstream;
+
+        /**
+         * @brief The blocks of the arena, in allocation order.
+         */
+        std::vector<block_t> m_blocks;
+
+        /**
+         * @brief The index of the current block.
+         */
+        std::size_t m_current{};
+
+        /**
+         * @brief The next free byte of the current block.
+         */
+        std::byte* m_ptr{};
+
+        /**
+         * @brief The end of the current block.
+         */
+        std::byte* m_end{};
+
+        /**
+         * @brief The size of the first block.
+         */
+        std::size_t m_block_size;
+
+        /**
+         * @brief The size of the next block allocated from the upstream resource.
+         */
+        std::size_t m_next_block_size;
+
+        /**
+         * @brief The number of bytes allocated since the last reset.
+         */
+        std::size_t m_bytes_used{};
+
+        /**
+         * @brief The total size of the blocks.
+         */
+        std::size_t m_capacity{};
+
+        /**
+         * @brief The number of blocks allocated from the upstream resource.
+         */
+        std::size_t m_upstream_allocations{};
+
+        /**
+         * @brief The number of allocations served since the last reset, in debug builds.
+         */
+        std::size_t m_allocations{};
+    };
+} // namespace clueapi::shared
+
+#endif // CLUEAPI_SHARED_ARENA_HXX
@@ -0,0 +1,128 @@
+/**
+ * @file arena.cxx
+ *
+ * @brief This file implements the `arena_t` struct.
+ */
+
+#include "clueapi/shared/arena/arena.hxx"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace clueapi::shared {
+    namespace {
+        /**
+         * @brief Rounds a pointer up to an alignment.
+         */
+        [[nodiscard]] std::byte* align_up(std::byte* ptr, std::size_t alignment) noexcept {
+            const auto value = reinterpret_cast<std::uintptr_t>(ptr);
+
+            const auto aligned = (value + alignment - 1) & ~(std::uintptr_t{alignment} - 1);
+
+            return ptr + (aligned - value);
+        }
+    } // namespace
+
+    arena_t::arena_t(std::size_t block_size, std::pmr::memory_resource* upstream) noexcept
+        : m_upstream{upstream},
+          m_block_size{std::max<std::size_t>(block_size, 64u)},
+          m_next_block_size{m_block_size} {
+    }
+
+    arena_t::~arena_t() noexcept {
+        release();
+    }
+
+    void arena_t::reset() noexcept {
+        m_current = 0;
+
+        m_bytes_used = 0;
+
+        m_allocations = 0;
+
+        if (m_blocks.empty()) {
+            m_ptr = m_end = nullptr;
+
+            return;
+        }
+
+        m_ptr = m_blocks.front().m_data;
+
+        m_end = m_ptr + m_blocks.front().m_size;
+    }
+
+    void arena_t::release() noexcept {
+        for (const auto& block : m_blocks)
+            m_upstream->deallocate(block.m_data, block.m_size, block.m_alignment);
+
+        m_blocks.clear();
+
+        m_capacity = 0;
+
+        m_next_block_size = m_block_size;
+
+        reset();
+    }
+
+    void* arena_t::do_allocate(std::size_t bytes, std::size_t alignment) {
+        bytes = std::max<std::size_t>(bytes, 1u);
+
+        auto* ptr = m_ptr ? align_up(m_ptr, alignment) : nullptr;
+
+        if (!ptr || ptr > m_end || static_cast<std::size_t>(m_end - ptr) < bytes) {
+            next_block(bytes, alignment);
+
+            ptr = align_up(m_ptr, alignment);
+        }
+
+        m_ptr = ptr + bytes;
+
+        m_bytes_used += bytes;
+
+#ifndef NDEBUG
+        m_allocations++;
+#endif
+
+        return ptr;
+    }
+
+    void arena_t::next_block(std::size_t bytes, std::size_t alignment) {
+        // The padding needed to align the allocation in the worst case
+        const auto needed = bytes + (alignment > alignof(std::max_align_t) ? alignment : 0);
+
+        const auto first = m_ptr ? m_current + 1 : m_current;
+
+        for (auto i = first; i < m_blocks.size(); i++) {
+            if (m_blocks[i].m_size < needed)
+                continue;
+
+            m_current = i;
+
+            m_ptr = m_blocks[i].m_data;
+
+            m_end = m_ptr + m_blocks[i].m_size;
+
+            return;
+        }
+
+        const auto size = std::max(m_next_block_size, needed);
+
+        const auto block_alignment = std::max(alignment, alignof(std::max_align_t));
+
+        auto* data = static_cast<std::byte*>(m_upstream->allocate(size, block_alignment));
+
+        m_blocks.push_back(block_t{data, size, block_alignment});
+
+        m_current = m_blocks.size() - 1;
+
+        m_ptr = data;
+
+        m_end = data + size;
+
+        m_capacity += size;
+
+        m_upstream_allocations++;
+
+        m_next_block_size = std::min(m_next_block_size * 2, k_max_block_size);
+    }
+} // namespace clueapi::shared
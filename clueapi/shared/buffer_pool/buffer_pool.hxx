@@ -0,0 +1,255 @@
+/**
+ * @file buffer_pool.hxx
+ *
+ * @brief This file includes the `buffer_pool_t` struct, a per-worker pool of fixed-size chunks
+ * the connection buffers are borrowed from.
+ */
+
+#ifndef CLUEAPI_SHARED_BUFFER_POOL_HXX
+#define CLUEAPI_SHARED_BUFFER_POOL_HXX
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include <boost/beast/core/flat_buffer.hpp>
+
+#include "clueapi/shared/buffer_pool/detail/cfg/cfg.hxx"
+#include "clueapi/shared/macros.hxx"
+
+namespace clueapi::shared {
+    /**
+     * @struct buffer_pool_t
+     *
+     * @brief Hands out memory in chunks of two fixed sizes and keeps the freed ones for reuse.
+     *
+     * @details An allocation up to the chunk size gets a chunk of the small tier, one up to the
+     * large chunk size a chunk of the large tier, and a larger one goes to `operator new`. A freed
+     * chunk is kept on the free list of its tier, up to its maximum, so the buffers of the
+     * requests in progress reuse the same memory while the idle connections hold none.
+     *
+     * @note The pool is not synchronized: it must only be used on the thread of its worker.
+     */
+    struct buffer_pool_t {
+        /**
+         * @brief Type alias for the pool configuration.
+         */
+        using cfg_t = detail::buffer_pool_cfg_t;
+
+        /**
+         * @struct stats_t
+         *
+         * @brief A snapshot of the counters of the pool.
+         */
+        struct stats_t {
+            /**
+             * @brief The number of chunks handed out and not freed yet.
+             */
+            std::size_t m_borrowed{};
+
+            /**
+             * @brief The number of chunks kept for reuse.
+             */
+            std::size_t m_free{};
+
+            /**
+             * @brief The number of chunks allocated from `operator new`.
+             */
+            std::size_t m_allocated{};
+        };
+
+        /**
+         * @brief Constructs a pool.
+         *
+         * @param cfg The settings of the pool.
+         * @param large_chunk_size The size of the chunks of the large tier.
+         */
+        buffer_pool_t(const cfg_t& cfg, std::size_t large_chunk_size);
+
+        ~buffer_pool_t() noexcept;
+
+        // Copy constructor
+        CLUEAPI_INLINE buffer_pool_t(const buffer_pool_t&) = delete;
+
+        // Copy assignment operator
+        CLUEAPI_INLINE buffer_pool_t& operator=(const buffer_pool_t&) = delete;
+
+       public:
+        /**
+         * @brief Allocates memory.
+         *
+         * @param size The number of bytes.
+         *
+         * @return The memory, a chunk of the tier `size` fits in.
+         */
+        [[nodiscard]] void* allocate(std::size_t size);
+
+        /**
+         * @brief Frees memory.
+         *
+         * @param ptr The memory, from `allocate()`.
+         * @param size The number of bytes it was allocated for.
+         */
+        void deallocate(void* ptr, std::size_t size) noexcept;
+
+        /**
+         * @brief Frees the chunks kept for reuse.
+         */
+        void trim() noexcept;
+
+        /**
+         * @brief Gets the counters of the pool.
+         *
+         * @return The counters, summed over both tiers.
+         */
+        [[nodiscard]] stats_t stats() const noexcept;
+
+        /**
+         * @brief Gets the size of the chunks of the small tier.
+         *
+         * @return The size in bytes.
+         */
+        [[nodiscard]] CLUEAPI_INLINE std::size_t chunk_size() const noexcept {
+            return m_tiers[0].m_size;
+        }
+
+        /**
+         * @brief Gets the size of the chunks of the large tier.
+         *
+         * @return The size in bytes.
+         */
+        [[nodiscard]] CLUEAPI_INLINE std::size_t large_chunk_size() const noexcept {
+            return m_tiers[1].m_size;
+        }
+
+       private:
+        /**
+         * @struct tier_t
+         *
+         * @brief The chunks of one size.
+         */
+        struct tier_t {
+            /**
+             * @brief The size of the chunks.
+             */
+            std::size_t m_size{};
+
+            /**
+             * @brief The maximum number of free chunks kept.
+             */
+            std::size_t m_max_free{};
+
+            /**
+             * @brief The free chunks.
+             */
+            std::vector<void*> m_free{};
+
+            /**
+             * @brief The number of chunks handed out.
+             */
+            std::size_t m_borrowed{};
+
+            /**
+             * @brief The number of chunks allocated from `operator new`.
+             */
+            std::size_t m_allocated{};
+        };
+
+        /**
+         * @brief Gets the tier of an allocation.
+         *
+         * @param size The number of bytes.
+         *
+         * @return The tier, `nullptr` if `size` is larger than the large chunks.
+         */
+        [[nodiscard]] CLUEAPI_INLINE tier_t* tier_of(std::size_t size) noexcept {
+            for (auto& tier : m_tiers) {
+                if (size <= tier.m_size)
+                    return &tier;
+            }
+
+            return nullptr;
+        }
+
+       private:
+        /**
+         * @brief The small and the large tier.
+         */
+        tier_t m_tiers[2];
+    };
+
+    /**
+     * @struct buffer_allocator_t
+     *
+     * @brief An allocator that takes its memory from a `buffer_pool_t`.
+     *
+     * @details An allocator without a pool uses `std::allocator`. The allocator propagates with
+     * the buffer it belongs to, so a moved buffer keeps returning its memory to its pool.
+     *
+     * @tparam _type_t The type of the allocated objects.
+     */
+    template <typename _type_t>
+    struct buffer_allocator_t {
+        using value_type = _type_t;
+
+        using propagate_on_container_copy_assignment = std::true_type;
+
+        using propagate_on_container_move_assignment = std::true_type;
+
+        using propagate_on_container_swap = std::true_type;
+
+        using is_always_equal = std::false_type;
+
+        CLUEAPI_INLINE buffer_allocator_t() noexcept = default;
+
+        /**
+         * @brief Constructs an allocator.
+         *
+         * @param pool The pool of the allocator, `nullptr` to use `std::allocator`.
+         */
+        CLUEAPI_INLINE explicit buffer_allocator_t(std::shared_ptr<buffer_pool_t> pool) noexcept
+            : m_pool{std::move(pool)} {
+        }
+
+        template <typename _other_t>
+        CLUEAPI_INLINE buffer_allocator_t(const buffer_allocator_t<_other_t>& other) noexcept
+            : m_pool{other.m_pool} {
+        }
+
+        [[nodiscard]] CLUEAPI_INLINE _type_t* allocate(std::size_t n) {
+            if (!m_pool)
+                return std::allocator<_type_t>{}.allocate(n);
+
+            return static_cast<_type_t*>(m_pool->allocate(n * sizeof(_type_t)));
+        }
+
+        CLUEAPI_INLINE void deallocate(_type_t* ptr, std::size_t n) noexcept {
+            if (!m_pool) {
+                std::allocator<_type_t>{}.deallocate(ptr, n);
+
+                return;
+            }
+
+            m_pool->deallocate(ptr, n * sizeof(_type_t));
+        }
+
+        template <typename _other_t>
+        [[nodiscard]] CLUEAPI_INLINE bool operator==(
+            const buffer_allocator_t<_other_t>& other) const noexcept {
+            return m_pool == other.m_pool;
+        }
+
+        /**
+         * @brief The pool of the allocator.
+         */
+        std::shared_ptr<buffer_pool_t> m_pool{};
+    };
+
+    /**
+     * @brief Type alias for a read buffer whose memory may be borrowed from a `buffer_pool_t`.
+     */
+    using pooled_buffer_t = boost::beast::basic_flat_buffer<buffer_allocator_t<char>>;
+} // namespace clueapi::shared
+
+#endif // CLUEAPI_SHARED_BUFFER_POOL_HXX
@@ -0,0 +1,49 @@
+/**
+ * @file cfg.hxx
+ *
+ * @brief Defines the configuration struct for the pools the connection buffers are borrowed from.
+ */
+
+#ifndef CLUEAPI_SHARED_BUFFER_POOL_DETAIL_CFG_HXX
+#define CLUEAPI_SHARED_BUFFER_POOL_DETAIL_CFG_HXX
+
+#include <cstddef>
+
+namespace clueapi::shared::detail {
+    /**
+     * @struct buffer_pool_cfg_t
+     *
+     * @brief Configuration settings for the per-worker buffer pools.
+     */
+    struct buffer_pool_cfg_t {
+        /**
+         * @brief If true, a keep-alive connection holds no buffer while it waits for its next
+         * request: it waits for the socket to be readable, then borrows a buffer from the pool of
+         * its worker and gives it back once the request is done.
+         *
+         * @note If false, every connection keeps its buffer for its whole lifetime.
+         */
+        bool m_enabled{true};
+
+        /**
+         * @brief The size of the chunks a buffer is borrowed as, enough for most requests.
+         *
+         * @note A buffer that outgrows it is moved to a chunk of the large tier, whose size is
+         * `client_t::m_buffer_capacity`.
+         */
+        std::size_t m_chunk_size{16ull * 1024u};
+
+        /**
+         * @brief The maximum number of free chunks a worker keeps, the others are freed.
+         */
+        std::size_t m_max_free_chunks{1024u};
+
+        /**
+         * @brief The maximum number of free chunks of the large tier a worker keeps, the others
+         * are freed.
+         */
+        std::size_t m_max_free_large_chunks{64u};
+    };
+} // namespace clueapi::shared::detail
+
+#endif // CLUEAPI_SHARED_BUFFER_POOL_DETAIL_CFG_HXX
@@ -0,0 +1,110 @@
+/**
+ * @file buffer_pool.cxx
+ *
+ * @brief Implements the `buffer_pool_t` struct.
+ */
+
+#include "clueapi/shared/buffer_pool/buffer_pool.hxx"
+
+#include <algorithm>
+#include <new>
+
+namespace clueapi::shared {
+    buffer_pool_t::buffer_pool_t(const cfg_t& cfg, std::size_t large_chunk_size) {
+        auto& small = m_tiers[0];
+
+        small.m_size = std::max<std::size_t>(cfg.m_chunk_size, 1u);
+
+        small.m_max_free = cfg.m_max_free_chunks;
+
+        auto& large = m_tiers[1];
+
+        // The large tier is only used if its chunks are larger than the small ones
+        large.m_size = std::max(large_chunk_size, small.m_size);
+
+        large.m_max_free = cfg.m_max_free_large_chunks;
+    }
+
+    buffer_pool_t::~buffer_pool_t() noexcept {
+        trim();
+    }
+
+    void* buffer_pool_t::allocate(std::size_t size) {
+        auto* tier = tier_of(size);
+
+        if (!tier)
+            return ::operator new(size);
+
+        void* ptr{};
+
+        if (!tier->m_free.empty()) {
+            ptr = tier->m_free.back();
+
+            tier->m_free.pop_back();
+        } else {
+            ptr = ::operator new(tier->m_size);
+
+            tier->m_allocated++;
+        }
+
+        tier->m_borrowed++;
+
+        return ptr;
+    }
+
+    void buffer_pool_t::deallocate(void* ptr, std::size_t size) noexcept {
+        if (!ptr)
+            return;
+
+        auto* tier = tier_of(size);
+
+        if (!tier) {
+            ::operator delete(ptr);
+
+            return;
+        }
+
+        tier->m_borrowed--;
+
+        if (tier->m_free.size() < tier->m_max_free) {
+            try {
+                tier->m_free.push_back(ptr);
+
+                return;
+            } catch (...) {
+                // ...
+            }
+        }
+
+        ::operator delete(ptr);
+
+        tier->m_allocated--;
+    }
+
+    void buffer_pool_t::trim() noexcept {
+        for (auto& tier : m_tiers) {
+            for (auto* ptr : tier.m_free)
+                ::operator delete(ptr);
+
+            tier.m_allocated -= tier.m_free.size();
+
+            tier.m_free.clear();
+
+            tier.m_free.shrink_to_fit();
+        }
+    }
+
+    buffer_pool_t::stats_t buffer_pool_t::stats() const noexcept {
+        stats_t ret{};
+
+        for (const auto& tier : m_tiers) {
+            ret.m_borrowed += tier.m_borrowed;
+
+            ret.m_free += tier.m_free.size();
+
+            ret.m_allocated += tier.m_allocated;
+        }
+
+        return ret;
+    }
+} // namespace clueapi::shared
@@ -0,0 +1,58 @@
+/**
+ * @file date_cache.hxx
+ *
+ * @brief This file includes the `date_cache_t` struct, the value of the `Date` header formatted
+ * once per second and per worker thread.
+ */
+
+#ifndef CLUEAPI_SHARED_DATE_CACHE_HXX
+#define CLUEAPI_SHARED_DATE_CACHE_HXX
+
+#include <array>
+#include <cstddef>
+#include <ctime>
+#include <string_view>
+
+#include "clueapi/shared/macros.hxx"
+
+namespace clueapi::shared {
+    /**
+     * @struct date_cache_t
+     *
+     * @brief The current time as an HTTP date (IMF-fixdate), e.g. `Sun, 06 Nov 1994 08:49:37 GMT`.
+     *
+     * @details Every thread keeps its own copy, so the workers never share or lock it. A response
+     * only reads the clock, the date is formatted again when the second changes.
+     */
+    struct date_cache_t {
+        /**
+         * @brief The length of an IMF-fixdate.
+         */
+        static constexpr std::size_t k_size{29};
+
+        /**
+         * @brief Type alias for the storage of a formatted date.
+         */
+        using buffer_t = std::array<char, k_size>;
+
+       public:
+        /**
+         * @brief Gets the current date of the calling thread.
+         *
+         * @return A view of the date, valid on this thread until the next call.
+         */
+        [[nodiscard]] static std::string_view now() noexcept;
+
+        /**
+         * @brief Formats a point in time as an HTTP date.
+         *
+         * @param time The time since the epoch, in seconds.
+         * @param buffer The storage of the date.
+         *
+         * @return A view of the date in `buffer`.
+         */
+        static std::string_view format(std::time_t time, buffer_t& buffer) noexcept;
+    };
+} // namespace clueapi::shared
+
+#endif // CLUEAPI_SHARED_DATE_CACHE_HXX
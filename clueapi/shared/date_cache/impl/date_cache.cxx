@@ -0,0 +1,90 @@
+/**
+ * @file date_cache.cxx
+ *
+ * @brief This file implements the `date_cache_t` struct.
+ */
+
+#include "clueapi/shared/date_cache/date_cache.hxx"
+
+#include <algorithm>
+
+#include <fmt/compile.h>
+#include <fmt/format.h>
+
+namespace clueapi::shared {
+    namespace {
+        /**
+         * @brief The names of the days, starting on Sunday as `std::tm::tm_wday` does.
+         */
+        constexpr std::array<std::string_view, 7> k_days{
+            "Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+
+        /**
+         * @brief The names of the months.
+         */
+        constexpr std::array<std::string_view, 12> k_months{
+            "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+
+        /**
+         * @struct cached_date_t
+         *
+         * @brief The date of a thread and the second it was formatted for.
+         */
+        struct cached_date_t {
+            /**
+             * @brief The second of the date, `-1` before the first call.
+             */
+            std::time_t m_time{-1};
+
+            /**
+             * @brief The formatted date.
+             */
+            date_cache_t::buffer_t m_buffer{};
+
+            /**
+             * @brief The view of `m_buffer`.
+             */
+            std::string_view m_date{};
+        };
+    } // namespace
+
+    std::string_view date_cache_t::now() noexcept {
+        thread_local cached_date_t cached{};
+
+        const auto time = std::time(nullptr);
+
+        if (time != cached.m_time) {
+            cached.m_date = format(time, cached.m_buffer);
+
+            cached.m_time = time;
+        }
+
+        return cached.m_date;
+    }
+
+    std::string_view date_cache_t::format(std::time_t time, buffer_t& buffer) noexcept {
+        std::tm tm{};
+
+#ifdef _WIN32
+        gmtime_s(&tm, &time);
+#else
+        gmtime_r(&time, &tm);
+#endif // _WIN32
+
+        const auto result = fmt::format_to_n(
+            buffer.data(),
+            buffer.size(),
+
+            FMT_COMPILE("{}, {:02} {} {} {:02}:{:02}:{:02} GMT"),
+
+            k_days[static_cast<std::size_t>(tm.tm_wday)],
+            tm.tm_mday,
+            k_months[static_cast<std::size_t>(tm.tm_mon)],
+            tm.tm_year + 1900,
+            tm.tm_hour,
+            tm.tm_min,
+            tm.tm_sec);
+
+        return std::string_view{buffer.data(), std::min(result.size, buffer.size())};
+    }
+} // namespace clueapi::shared
@@ -0,0 +1,101 @@
+/**
+ * @file cfg.hxx
+ *
+ * @brief Defines the configuration struct for the I/O context pool.
+ */
+
+#ifndef CLUEAPI_SHARED_IO_CTX_POOL_DETAIL_CFG_HXX
+#define CLUEAPI_SHARED_IO_CTX_POOL_DETAIL_CFG_HXX
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace clueapi::shared::detail {
+    /**
+     * @enum e_select_policy
+     *
+     * @brief Defines how the pool picks an `io_context` for new work (e.g., accepted sockets).
+     */
+    enum struct e_select_policy : std::uint8_t {
+        /**
+         * @brief Cycles through the contexts in order.
+         */
+        round_robin,
+
+        /**
+         * @brief Picks the context with the fewest active connections.
+         */
+        least_connections,
+
+        /**
+         * @brief Samples two random contexts and picks the less loaded one.
+         */
+        power_of_two
+    };
+
+    /**
+     * @enum e_placement_policy
+     *
+     * @brief Defines how worker threads are pinned to the CPUs the process may run on.
+     *
+     * @note The CPUs are always taken from the affinity mask of the process (`sched_getaffinity`),
+     * so cgroup cpusets, `isolcpus` and `taskset` are respected.
+     */
+    enum struct e_placement_policy : std::uint8_t {
+        /**
+         * @brief Pins worker `i` to the `i`-th allowed CPU, wrapping around.
+         */
+        sequential,
+
+        /**
+         * @brief Pins workers to distinct physical cores first, SMT siblings only once every core
+         * has a worker.
+         */
+        physical_cores,
+
+        /**
+         * @brief Spreads workers round-robin across NUMA nodes, physical cores first within a node.
+         */
+        numa_nodes,
+
+        /**
+         * @brief Does not pin the workers.
+         */
+        none
+    };
+
+    /**
+     * @struct io_ctx_pool_cfg_t
+     *
+     * @brief Configuration settings for the I/O context pool.
+     */
+    struct io_ctx_pool_cfg_t {
+        /**
+         * @brief The policy used to select an `io_context` when placing new work.
+         */
+        e_select_policy m_select_policy{e_select_policy::round_robin};
+
+        /**
+         * @brief The interval of the loop lag probe posted to every worker.
+         *
+         * @note A value of 0 disables the probe and the loop lag EWMA stays at zero.
+         */
+        std::chrono::milliseconds m_lag_probe_interval{0};
+
+        /**
+         * @brief The policy used to pin the worker threads to CPUs.
+         */
+        e_placement_policy m_placement{e_placement_policy::sequential};
+
+        /**
+         * @brief An explicit list of CPUs for the workers, in order (e.g., "0-3,8,10-11").
+         *
+         * @note Overrides `m_placement` when set. CPUs outside the affinity mask of the process
+         * are skipped. The default `io_context` takes the CPU after the last worker.
+         */
+        std::string m_cpu_list{};
+    };
+} // namespace clueapi::shared::detail
+
+#endif // CLUEAPI_SHARED_IO_CTX_POOL_DETAIL_CFG_HXX
@@ -0,0 +1,261 @@
+/**
+ * @file topology.cxx
+ *
+ * @brief Implements the CPU topology helpers used to place the I/O context pool's threads.
+ */
+
+#include "clueapi/shared/io_ctx_pool/detail/topology/topology.hxx"
+
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+#include <fmt/format.h>
+
+#ifdef __linux__
+#include <sched.h>
+#endif // __linux__
+
+namespace clueapi::shared::detail {
+    namespace {
+        /**
+         * @brief Reads the first integer of a sysfs file.
+         */
+        [[nodiscard]] std::int32_t read_sysfs_int(
+            const std::filesystem::path& path, std::int32_t def) {
+            std::ifstream file{path};
+
+            std::int32_t ret{};
+
+            if (!(file >> ret))
+                return def;
+
+            return ret;
+        }
+
+        /**
+         * @brief Orders CPUs so that every physical core gets one before any SMT sibling.
+         */
+        [[nodiscard]] std::vector<std::int32_t> order_by_cores(std::vector<cpu_t> cpus) {
+            std::unordered_map<std::int32_t, std::size_t> siblings_seen{};
+
+            std::vector<std::pair<std::size_t, std::int32_t>> ranked{};
+
+            ranked.reserve(cpus.size());
+
+            std::sort(cpus.begin(), cpus.end(), [](const cpu_t& lhs, const cpu_t& rhs) {
+                return lhs.m_id < rhs.m_id;
+            });
+
+            for (const auto& cpu : cpus)
+                ranked.emplace_back(siblings_seen[cpu.m_core]++, cpu.m_id);
+
+            std::sort(ranked.begin(), ranked.end());
+
+            std::vector<std::int32_t> ret{};
+
+            ret.reserve(ranked.size());
+
+            for (const auto& [rank, id] : ranked)
+                ret.emplace_back(id);
+
+            return ret;
+        }
+
+        /**
+         * @brief Places threads round-robin across NUMA nodes.
+         */
+        [[nodiscard]] std::vector<std::int32_t> order_by_nodes(const std::vector<cpu_t>& cpus) {
+            std::map<std::int32_t, std::vector<cpu_t>> nodes{};
+
+            for (const auto& cpu : cpus)
+                nodes[cpu.m_node].emplace_back(cpu);
+
+            std::vector<std::vector<std::int32_t>> per_node{};
+
+            per_node.reserve(nodes.size());
+
+            for (auto& [node, node_cpus] : nodes)
+                per_node.emplace_back(order_by_cores(std::move(node_cpus)));
+
+            std::vector<std::int32_t> ret{};
+
+            ret.reserve(cpus.size());
+
+            for (std::size_t i{}; ret.size() < cpus.size(); i++) {
+                for (const auto& node_cpus : per_node) {
+                    if (i < node_cpus.size())
+                        ret.emplace_back(node_cpus[i]);
+                }
+            }
+
+            return ret;
+        }
+    } // namespace
+
+    std::vector<std::int32_t> parse_cpu_list(std::string_view list) {
+        std::vector<std::int32_t> ret{};
+
+        const auto parse_int = [](std::string_view str, std::int32_t& value) {
+            while (!str.empty() && str.front() == ' ')
+                str.remove_prefix(1);
+
+            while (!str.empty() && (str.back() == ' ' || str.back() == '\n'))
+                str.remove_suffix(1);
+
+            const auto* end = str.data() + str.size();
+
+            auto [ptr, ec] = std::from_chars(str.data(), end, value);
+
+            return !str.empty() && ec == std::errc{} && ptr == end && value >= 0;
+        };
+
+        while (!list.empty()) {
+            const auto comma = list.find(',');
+
+            const auto token = list.substr(0, comma);
+
+            list = comma == std::string_view::npos ? std::string_view{} : list.substr(comma + 1);
+
+            if (token.find_first_not_of(" \n") == std::string_view::npos)
+                continue;
+
+            std::int32_t first{};
+            std::int32_t last{};
+
+            if (const auto dash = token.find('-'); dash != std::string_view::npos) {
+                if (!parse_int(token.substr(0, dash), first) ||
+                    !parse_int(token.substr(dash + 1), last) || last < first)
+                    return {};
+            } else {
+                if (!parse_int(token, first))
+                    return {};
+
+                last = first;
+            }
+
+            for (auto cpu = first; cpu <= last; cpu++)
+                ret.emplace_back(cpu);
+        }
+
+        return ret;
+    }
+
+    std::vector<cpu_t> allowed_cpus() {
+        std::vector<cpu_t> ret{};
+
+#ifdef __linux__
+        cpu_set_t cpuset;
+
+        CPU_ZERO(&cpuset);
+
+        if (sched_getaffinity(0, sizeof(cpu_set_t), &cpuset) == 0) {
+            for (std::int32_t cpu{}; cpu < CPU_SETSIZE; cpu++) {
+                if (CPU_ISSET(cpu, &cpuset))
+                    ret.emplace_back(cpu_t{.m_id = cpu, .m_core = cpu, .m_node = 0});
+            }
+        }
+
+        if (ret.empty()) {
+            const auto hw = std::max(std::thread::hardware_concurrency(), 1u);
+
+            for (std::int32_t cpu{}; cpu < static_cast<std::int32_t>(hw); cpu++)
+                ret.emplace_back(cpu_t{.m_id = cpu, .m_core = cpu, .m_node = 0});
+        }
+
+        const std::filesystem::path cpu_root{"/sys/devices/system/cpu"};
+
+        for (auto& cpu : ret) {
+            const auto topology = cpu_root / fmt::format("cpu{}", cpu.m_id) / "topology";
+
+            const auto core_id = read_sysfs_int(topology / "core_id", -1);
+            const auto package_id = read_sysfs_int(topology / "physical_package_id", 0);
+
+            // Core ids are only unique within a package
+            if (core_id >= 0)
+                cpu.m_core = package_id * 65536 + core_id;
+        }
+
+        std::error_code ec{};
+
+        for (const auto& entry :
+             std::filesystem::directory_iterator{"/sys/devices/system/node", ec}) {
+            const auto name = entry.path().filename().string();
+
+            std::int32_t node{};
+
+            if (!name.starts_with("node") ||
+                std::from_chars(name.data() + 4, name.data() + name.size(), node).ec !=
+                    std::errc{})
+                continue;
+
+            std::ifstream file{entry.path() / "cpulist"};
+
+            std::string list{};
+
+            std::getline(file, list);
+
+            for (const auto id : parse_cpu_list(list)) {
+                auto it = std::find_if(
+                    ret.begin(), ret.end(), [id](const cpu_t& cpu) { return cpu.m_id == id; });
+
+                if (it != ret.end())
+                    it->m_node = node;
+            }
+        }
+#endif // __linux__
+
+        return ret;
+    }
+
+    std::vector<std::int32_t> place_threads(
+        const std::vector<cpu_t>& cpus, const io_ctx_pool_cfg_t& cfg, std::size_t num_threads) {
+        std::vector<std::int32_t> ret(num_threads, -1);
+
+        if (cpus.empty())
+            return ret;
+
+        std::vector<std::int32_t> order{};
+
+        if (!cfg.m_cpu_list.empty()) {
+            for (const auto id : parse_cpu_list(cfg.m_cpu_list)) {
+                const auto allowed = std::any_of(
+                    cpus.begin(), cpus.end(), [id](const cpu_t& cpu) { return cpu.m_id == id; });
+
+                if (allowed)
+                    order.emplace_back(id);
+            }
+        }
+
+        if (order.empty()) {
+            switch (cfg.m_placement) {
+                case e_placement_policy::none:
+                    return ret;
+                case e_placement_policy::physical_cores:
+                    order = order_by_cores(cpus);
+
+                    break;
+                case e_placement_policy::numa_nodes:
+                    order = order_by_nodes(cpus);
+
+                    break;
+                default:
+                    for (const auto& cpu : cpus)
+                        order.emplace_back(cpu.m_id);
+
+                    break;
+            }
+        }
+
+        for (std::size_t i{}; i < num_threads; i++)
+            ret[i] = order[i % order.size()];
+
+        return ret;
+    }
+} // namespace clueapi::shared::detail
@@ -0,0 +1,71 @@
+/**
+ * @file topology.hxx
+ *
+ * @brief Defines the CPU topology helpers used to place the I/O context pool's threads.
+ */
+
+#ifndef CLUEAPI_SHARED_IO_CTX_POOL_DETAIL_TOPOLOGY_HXX
+#define CLUEAPI_SHARED_IO_CTX_POOL_DETAIL_TOPOLOGY_HXX
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "clueapi/shared/io_ctx_pool/detail/cfg/cfg.hxx"
+
+namespace clueapi::shared::detail {
+    /**
+     * @struct cpu_t
+     *
+     * @brief A logical CPU the process is allowed to run on.
+     */
+    struct cpu_t {
+        /**
+         * @brief The id of the logical CPU.
+         */
+        std::int32_t m_id{};
+
+        /**
+         * @brief The id of the physical core, unique across packages. Equal for SMT siblings.
+         */
+        std::int32_t m_core{};
+
+        /**
+         * @brief The NUMA node of the CPU.
+         */
+        std::int32_t m_node{};
+    };
+
+    /**
+     * @brief Parses a Linux style list of CPUs (e.g., "0-3,8,10-11").
+     *
+     * @param list The list to parse.
+     *
+     * @return The CPUs of the list, in order. Empty if the list is malformed.
+     */
+    [[nodiscard]] std::vector<std::int32_t> parse_cpu_list(std::string_view list);
+
+    /**
+     * @brief Discovers the CPUs the process is allowed to run on, with their core and NUMA node.
+     *
+     * @return The allowed CPUs, ordered by id. Empty if the topology is not available.
+     *
+     * @note Linux only: combines `sched_getaffinity` with `/sys/devices/system`.
+     */
+    [[nodiscard]] std::vector<cpu_t> allowed_cpus();
+
+    /**
+     * @brief Computes the CPU of every thread of the pool.
+     *
+     * @param cpus The allowed CPUs.
+     * @param cfg The pool configuration.
+     * @param num_threads The number of threads to place.
+     *
+     * @return One CPU id per thread, `-1` for threads that are not pinned.
+     */
+    [[nodiscard]] std::vector<std::int32_t> place_threads(
+        const std::vector<cpu_t>& cpus, const io_ctx_pool_cfg_t& cfg, std::size_t num_threads);
+} // namespace clueapi::shared::detail
+
+#endif // CLUEAPI_SHARED_IO_CTX_POOL_DETAIL_TOPOLOGY_HXX
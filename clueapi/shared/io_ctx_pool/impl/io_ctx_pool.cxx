@@ -7,51 +7,86 @@
 
 #include "clueapi/shared/io_ctx_pool/io_ctx_pool.hxx"
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <latch>
+#include <limits>
+#include <memory>
+
+#include <boost/system/error_code.hpp>
+
 #include "clueapi/modules/macros.hxx"
 
+#include "clueapi/shared/io_ctx_pool/detail/topology/topology.hxx"
+
 #ifdef __linux__
 #include <pthread.h>
 #endif // __linux__
 
 namespace clueapi::shared {
-    void io_ctx_pool_t::start(std::size_t num_threads) {
+    void io_ctx_pool_t::start(std::size_t num_threads, cfg_t cfg) {
         if (m_running.exchange(true) || num_threads == 0)
             return;
 
+        m_cfg = std::move(cfg);
+
+        // The workers first, then the default context
+        m_placement = detail::place_threads(detail::allowed_cpus(), m_cfg, num_threads + 1);
+
         {
             m_def_io_ctx = std::make_unique<io_ctx_t>();
 
             m_def_work_guard =
                 std::make_unique<work_guard_t>(boost::asio::make_work_guard(*m_def_io_ctx));
 
-            for (std::size_t i{}; i < num_threads; i++) {
-                m_io_ctxs.emplace_back(std::make_unique<io_ctx_t>());
+            m_loads = std::make_unique<load_t[]>(num_threads);
 
-                m_work_guards.emplace_back(boost::asio::make_work_guard(*m_io_ctxs.back()));
-            }
+            m_io_ctxs.resize(num_threads);
         }
 
+        // Each worker pins itself and then constructs its own context, so that the memory of the
+        // context is first touched, and therefore allocated, on the worker's NUMA node
+        auto ctxs_ready = std::make_shared<std::latch>(static_cast<std::ptrdiff_t>(num_threads));
+        auto guards_ready = std::make_shared<std::latch>(1);
+
+        // Set by a worker that couldn't construct its context, the others then exit unrun
+        auto has_failed = std::make_shared<std::atomic_bool>(false);
+
         m_threads.reserve(num_threads + 1);
 
-        {
-            m_threads.emplace_back([this, num_threads] {
+        for (std::size_t i{}; i < num_threads; i++) {
+            m_threads.emplace_back([this, i, ctxs_ready, guards_ready, has_failed] {
 #ifdef __linux__
-                cpu_set_t cpuset;
+                auto current_thread = pthread_self();
 
-                CPU_ZERO(&cpuset);
+                if (!pin_current_thread(m_placement[i]))
+                    CLUEAPI_LOG_WARNING("Could not set CPU affinity for worker {}", i);
 
-                CPU_SET(num_threads % std::thread::hardware_concurrency(), &cpuset);
+                pthread_setname_np(current_thread, fmt::format("io_worker_{}", i).c_str());
+#endif // __linux__
 
-                auto current_thread = pthread_self();
+                // Thrown out of the thread function, an error (e.g., `epoll_create` failing
+                // when out of descriptors) would terminate the process
+                try {
+                    m_io_ctxs[i] = std::make_unique<io_ctx_t>();
+                } catch (const std::exception& e) {
+                    CLUEAPI_LOG_ERROR(
+                        "Failed to create the I/O context of worker {}: {}", i, e.what());
 
-                if (pthread_setaffinity_np(current_thread, sizeof(cpu_set_t), &cpuset) != 0) {
-                    CLUEAPI_LOG_WARNING("Could not set CPU affinity for worker {}", num_threads);
+                    has_failed->store(true, std::memory_order_relaxed);
                 }
 
-                pthread_setname_np(current_thread, "def_io_ctx");
+                ctxs_ready->count_down();
+
+                guards_ready->wait();
 
+                if (has_failed->load(std::memory_order_relaxed))
+                    return;
+
+#ifdef __linux__
                 {
-                    auto* ctx_ptr = m_def_io_ctx.get();
+                    auto* ctx_ptr = m_io_ctxs[i].get();
 
                     {
                         __builtin_prefetch(ctx_ptr, 0, 3);
@@ -60,11 +95,15 @@ namespace clueapi::shared {
 
                         __builtin_prefetch(reinterpret_cast<char*>(ctx_ptr) + 128, 0, 3);
 
-                        __builtin_prefetch(m_def_work_guard.get(), 0, 3);
+                        __builtin_prefetch(&m_work_guards[i], 0, 3);
                     }
+                }
 
+                {
                     volatile char cache_warmer{};
 
+                    auto* ctx_ptr = m_io_ctxs[i].get();
+
                     constexpr std::size_t k_cache_line_size = 64;
                     constexpr std::size_t k_max_warm_size = 512;
 
@@ -73,75 +112,97 @@ namespace clueapi::shared {
                     for (std::size_t offset{}; offset < warm_size; offset += k_cache_line_size)
                         cache_warmer += reinterpret_cast<volatile char*>(ctx_ptr)[offset];
 
+                    auto* guard_ptr = reinterpret_cast<volatile char*>(&m_work_guards[i]);
+
+                    for (std::size_t offset{}; offset < sizeof(m_work_guards[i]);
+                         offset += k_cache_line_size) {
+                        cache_warmer += guard_ptr[offset];
+                    }
+
                     (void)cache_warmer;
                 }
 #endif // __linux__
 
-                m_def_io_ctx->run();
+                m_io_ctxs[i]->run();
             });
+        }
 
-            for (std::size_t i{}; i < num_threads; i++) {
-                m_threads.emplace_back([this, i] {
-#ifdef __linux__
-                    cpu_set_t cpuset;
+        ctxs_ready->wait();
+
+        // The latch orders the workers' stores before this load
+        if (has_failed->load(std::memory_order_relaxed)) {
+            guards_ready->count_down();
 
-                    CPU_ZERO(&cpuset);
+            // Joins the workers and leaves the pool stopped, as `is_running()` reports
+            stop();
 
-                    CPU_SET(i % std::thread::hardware_concurrency(), &cpuset);
+            return;
+        }
 
-                    auto current_thread = pthread_self();
+        m_work_guards.reserve(num_threads);
 
-                    if (pthread_setaffinity_np(current_thread, sizeof(cpu_set_t), &cpuset) != 0)
-                        CLUEAPI_LOG_WARNING("Could not set CPU affinity for worker {}", i);
+        for (std::size_t i{}; i < num_threads; i++)
+            m_work_guards.emplace_back(boost::asio::make_work_guard(*m_io_ctxs[i]));
 
-                    pthread_setname_np(current_thread, fmt::format("io_worker_{}", i).c_str());
+        guards_ready->count_down();
 
-                    {
-                        auto* ctx_ptr = m_io_ctxs[i].get();
+        if (m_cfg.m_lag_probe_interval.count() > 0) {
+            m_lag_probes.reserve(num_threads);
 
-                        {
-                            __builtin_prefetch(ctx_ptr, 0, 3);
+            for (std::size_t i{}; i < num_threads; i++) {
+                m_lag_probes.emplace_back(
+                    std::make_unique<boost::asio::steady_timer>(*m_io_ctxs[i]));
 
-                            __builtin_prefetch(reinterpret_cast<char*>(ctx_ptr) + 64, 0, 3);
+                arm_lag_probe(i);
+            }
+        }
 
-                            __builtin_prefetch(reinterpret_cast<char*>(ctx_ptr) + 128, 0, 3);
+        m_threads.emplace_back([this, num_threads] {
+#ifdef __linux__
+            auto current_thread = pthread_self();
 
-                            __builtin_prefetch(&m_work_guards[i], 0, 3);
-                        }
-                    }
+            if (!pin_current_thread(m_placement[num_threads]))
+                CLUEAPI_LOG_WARNING("Could not set CPU affinity for worker {}", num_threads);
 
-                    {
-                        volatile char cache_warmer{};
+            pthread_setname_np(current_thread, "def_io_ctx");
 
-                        auto* ctx_ptr = m_io_ctxs[i].get();
+            {
+                auto* ctx_ptr = m_def_io_ctx.get();
 
-                        constexpr std::size_t k_cache_line_size = 64;
-                        constexpr std::size_t k_max_warm_size = 512;
+                {
+                    __builtin_prefetch(ctx_ptr, 0, 3);
 
-                        const auto warm_size = std::min(sizeof(*ctx_ptr), k_max_warm_size);
+                    __builtin_prefetch(reinterpret_cast<char*>(ctx_ptr) + 64, 0, 3);
 
-                        for (std::size_t offset{}; offset < warm_size;
-                             offset += k_cache_line_size) {
-                            cache_warmer += reinterpret_cast<volatile char*>(ctx_ptr)[offset];
-                        }
+                    __builtin_prefetch(reinterpret_cast<char*>(ctx_ptr) + 128, 0, 3);
 
-                        auto* guard_ptr = reinterpret_cast<volatile char*>(&m_work_guards[i]);
+                    __builtin_prefetch(m_def_work_guard.get(), 0, 3);
+                }
 
-                        for (std::size_t offset{}; offset < sizeof(m_work_guards[i]);
-                             offset += k_cache_line_size) {
-                            cache_warmer += guard_ptr[offset];
-                        }
+                volatile char cache_warmer{};
 
-                        (void)cache_warmer;
-                    }
-#endif // __linux__
+                constexpr std::size_t k_cache_line_size = 64;
+                constexpr std::size_t k_max_warm_size = 512;
+
+                const auto warm_size = std::min(sizeof(*ctx_ptr), k_max_warm_size);
+
+                for (std::size_t offset{}; offset < warm_size; offset += k_cache_line_size)
+                    cache_warmer += reinterpret_cast<volatile char*>(ctx_ptr)[offset];
 
-                    m_io_ctxs[i]->run();
-                });
+                (void)cache_warmer;
             }
+#endif // __linux__
+
+            m_def_io_ctx->run();
+        });
+
+        for (std::size_t i{}; i < m_placement.size(); i++) {
+            if (m_placement[i] >= 0)
+                CLUEAPI_LOG_TRACE("I/O context pool thread {} pinned to CPU {}", i, m_placement[i]);
         }
 
-        CLUEAPI_LOG_DEBUG("I/O context pool started with {} threads", num_threads + 1);
+        CLUEAPI_LOG_DEBUG(
+            "I/O context pool started with {} threads ({})", num_threads + 1, k_backend);
     }
 
     void io_ctx_pool_t::stop() {
@@ -185,10 +246,137 @@ namespace clueapi::shared {
 
         m_threads.clear();
 
+        m_lag_probes.clear();
+
         m_io_ctxs.clear();
 
+        m_placement.clear();
+
+        m_loads.reset();
+
         m_def_io_ctx.reset();
 
         CLUEAPI_LOG_DEBUG("I/O context pool stopped");
     }
+
+    bool io_ctx_pool_t::pin_current_thread(std::int32_t cpu) noexcept {
+#ifdef __linux__
+        if (cpu < 0)
+            return true;
+
+        cpu_set_t cpuset;
+
+        CPU_ZERO(&cpuset);
+
+        CPU_SET(cpu, &cpuset);
+
+        return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset) == 0;
+#else
+        (void)cpu;
+
+        return true;
+#endif // __linux__
+    }
+
+    std::size_t io_ctx_pool_t::next_idx() const noexcept {
+        const auto size = m_io_ctxs.size();
+
+        switch (m_cfg.m_select_policy) {
+            case e_select_policy::least_connections: {
+                // Rotate the starting point so that ties do not always land on the first context
+                const auto start = m_next_ctx.fetch_add(1, std::memory_order_relaxed) % size;
+
+                auto best = start;
+
+                auto best_score = std::numeric_limits<std::size_t>::max();
+
+                for (std::size_t i{}; i < size; i++) {
+                    const auto idx = (start + i) % size;
+
+                    const auto score =
+                        m_loads[idx].m_active_connections.load(std::memory_order_relaxed);
+
+                    if (score < best_score) {
+                        best = idx;
+
+                        best_score = score;
+                    }
+                }
+
+                return best;
+            }
+            case e_select_policy::power_of_two: {
+                if (size < 2)
+                    return 0;
+
+                // xorshift64, one state per thread
+                thread_local std::uint64_t state =
+                    std::hash<std::thread::id>{}(std::this_thread::get_id()) | 1u;
+
+                state ^= state << 13u;
+                state ^= state >> 7u;
+                state ^= state << 17u;
+
+                const auto first = static_cast<std::size_t>(state % size);
+
+                auto second = static_cast<std::size_t>((state >> 32u) % (size - 1));
+
+                if (second >= first)
+                    ++second;
+
+                return load_score(first) <= load_score(second) ? first : second;
+            }
+            default:
+                return m_next_ctx.fetch_add(1, std::memory_order_relaxed) % size;
+        }
+    }
+
+    io_ctx_pool_t::stats_t io_ctx_pool_t::stats(std::size_t idx) const noexcept {
+        if (idx >= m_io_ctxs.size())
+            return {};
+
+        const auto& load = m_loads[idx];
+
+        return stats_t{
+            .m_active_connections = load.m_active_connections.load(std::memory_order_relaxed),
+            .m_queued_handlers = load.m_queued_handlers.load(std::memory_order_relaxed),
+            .m_loop_lag = std::chrono::nanoseconds{static_cast<std::int64_t>(
+                load.m_loop_lag_ns.load(std::memory_order_relaxed))}};
+    }
+
+    std::vector<io_ctx_pool_t::stats_t> io_ctx_pool_t::stats() const {
+        std::vector<stats_t> ret{};
+
+        ret.reserve(m_io_ctxs.size());
+
+        for (std::size_t i{}; i < m_io_ctxs.size(); i++)
+            ret.emplace_back(stats(i));
+
+        return ret;
+    }
+
+    void io_ctx_pool_t::arm_lag_probe(std::size_t idx) {
+        auto& timer = *m_lag_probes[idx];
+
+        timer.expires_after(m_cfg.m_lag_probe_interval);
+
+        timer.async_wait([this, idx](const boost::system::error_code& ec) {
+            if (ec || !m_running.load(std::memory_order_relaxed))
+                return;
+
+            const auto lag = std::chrono::steady_clock::now() - m_lag_probes[idx]->expiry();
+
+            const auto lag_ns = static_cast<std::uint64_t>(std::max<std::int64_t>(
+                0, std::chrono::duration_cast<std::chrono::nanoseconds>(lag).count()));
+
+            // EWMA with alpha = 1/8, only ever written from the owning worker thread
+            auto& ewma = m_loads[idx].m_loop_lag_ns;
+
+            const auto prev = ewma.load(std::memory_order_relaxed);
+
+            ewma.store(prev - prev / 8u + lag_ns / 8u, std::memory_order_relaxed);
+
+            arm_lag_probe(idx);
+        });
+    }
 } // namespace clueapi::shared
\ No newline at end of file
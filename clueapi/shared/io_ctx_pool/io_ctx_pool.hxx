@@ -9,13 +9,20 @@
 #define CLUEAPI_SHARED_IO_CTX_POOL_HXX
 
 #include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <memory>
+#include <string_view>
 #include <thread>
+#include <utility>
 #include <vector>
 
 #include <boost/asio/executor_work_guard.hpp>
 #include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
 
+#include "clueapi/shared/io_ctx_pool/detail/cfg/cfg.hxx"
 #include "clueapi/shared/macros.hxx"
 
 namespace clueapi::shared {
@@ -30,8 +37,9 @@ namespace clueapi::shared {
      * applications by parallelizing I/O operations. The pool also includes a "default" `io_context`
      * that can be used for specific, non-intensive tasks like accepting new connections.
      *
-     * The pool uses a round-robin strategy to distribute work across the available contexts,
-     * ensuring an even load distribution.
+     * The pool keeps per-context load counters (active connections, queued handlers and an
+     * optional EWMA of loop lag) and selects contexts for new work according to
+     * `cfg_t::m_select_policy` (round-robin by default).
      */
     struct io_ctx_pool_t {
         /**
@@ -49,6 +57,77 @@ namespace clueapi::shared {
          */
         using work_guard_t = boost::asio::executor_work_guard<io_ctx_t::executor_type>;
 
+        /**
+         * @brief Type alias for the pool configuration.
+         */
+        using cfg_t = detail::io_ctx_pool_cfg_t;
+
+        /**
+         * @brief Type alias for the selection policy.
+         */
+        using e_select_policy = detail::e_select_policy;
+
+        /**
+         * @brief The name of the I/O backend the contexts run on.
+         *
+         * @note `CLUEAPI_USE_IO_URING` disables the epoll reactor, so sockets, timers and files
+         * all go through io_uring. Otherwise io_uring, when available, only backs file I/O.
+         */
+#if defined(BOOST_ASIO_HAS_IO_URING) && defined(BOOST_ASIO_DISABLE_EPOLL)
+        static constexpr std::string_view k_backend{"io_uring"};
+#elif defined(BOOST_ASIO_HAS_IO_URING)
+        static constexpr std::string_view k_backend{"epoll + io_uring files"};
+#else
+        static constexpr std::string_view k_backend{"default reactor"};
+#endif
+
+        /**
+         * @struct load_t
+         *
+         * @brief Live load counters of a single worker `io_context`.
+         *
+         * @details Padded to a cache line so that workers updating their own counters do not
+         * share cache lines with each other.
+         */
+        struct alignas(64) load_t {
+            /**
+             * @brief The number of connections placed on the context and not yet finished.
+             */
+            std::atomic<std::size_t> m_active_connections{0};
+
+            /**
+             * @brief The number of handlers posted to the context and not yet started.
+             */
+            std::atomic<std::size_t> m_queued_handlers{0};
+
+            /**
+             * @brief The EWMA of the loop lag in nanoseconds, updated by the lag probe.
+             */
+            std::atomic<std::uint64_t> m_loop_lag_ns{0};
+        };
+
+        /**
+         * @struct stats_t
+         *
+         * @brief A snapshot of the load counters of a single worker `io_context`.
+         */
+        struct stats_t {
+            /**
+             * @brief The number of active connections.
+             */
+            std::size_t m_active_connections{};
+
+            /**
+             * @brief The number of queued handlers.
+             */
+            std::size_t m_queued_handlers{};
+
+            /**
+             * @brief The EWMA of the loop lag.
+             */
+            std::chrono::nanoseconds m_loop_lag{};
+        };
+
        public:
         /**
          * @brief Constructs an `io_ctx_pool_t` in a default, unstarted state.
@@ -62,8 +141,12 @@ namespace clueapi::shared {
          *
          * @param num_threads The number of worker threads to create for the pool. This does not
          * include the thread for the default `io_context`.
+         * @param cfg The pool configuration.
+         *
+         * @note If a worker fails to construct its context, the threads already started are
+         * joined and the pool is left stopped, which `is_running()` reports.
          */
-        void start(std::size_t num_threads = 1);
+        void start(std::size_t num_threads = 1, cfg_t cfg = {});
 
         /**
          * @brief Stops all I/O contexts and joins the worker threads.
@@ -88,16 +171,167 @@ namespace clueapi::shared {
         }
 
         /**
-         * @brief Retrieves the next `io_context` from the pool using a round-robin strategy.
+         * @brief Retrieves the next `io_context` from the pool using the configured selection
+         * policy.
          *
          * @return A raw pointer to a `io_ctx_t` from the pool.
          */
         CLUEAPI_INLINE io_ctx_t* io_ctx() const noexcept {
-            const auto idx = m_next_ctx.fetch_add(1, std::memory_order_relaxed) % m_io_ctxs.size();
+            return m_io_ctxs[next_idx()].get();
+        }
+
+        /**
+         * @brief Selects the index of the next `io_context` using the configured selection
+         * policy.
+         *
+         * @return The index of the selected worker `io_context`.
+         */
+        [[nodiscard]] std::size_t next_idx() const noexcept;
+
+        /**
+         * @brief Retrieves the `io_context` at the given position in the pool.
+         *
+         * @param idx The index of the worker `io_context`.
+         *
+         * @return A raw pointer to the `io_ctx_t`, or `nullptr` if the index is out of range.
+         */
+        CLUEAPI_INLINE io_ctx_t* io_ctx(std::size_t idx) const noexcept {
+            if (idx >= m_io_ctxs.size())
+                return nullptr;
 
             return m_io_ctxs[idx].get();
         }
 
+        /**
+         * @brief Gets the number of worker `io_context` instances in the pool.
+         *
+         * @return The number of worker contexts, not including the default one.
+         */
+        CLUEAPI_INLINE std::size_t size() const noexcept {
+            return m_io_ctxs.size();
+        }
+
+        /**
+         * @brief Gets the CPU each thread of the pool is pinned to.
+         *
+         * @return One CPU id per worker, followed by the one of the default context. `-1` for
+         * threads that are not pinned.
+         */
+        [[nodiscard]] CLUEAPI_INLINE const std::vector<std::int32_t>& placement() const noexcept {
+            return m_placement;
+        }
+
+        /**
+         * @brief Gets the configured selection policy.
+         *
+         * @return The selection policy.
+         */
+        [[nodiscard]] CLUEAPI_INLINE e_select_policy select_policy() const noexcept {
+            return m_cfg.m_select_policy;
+        }
+
+       public:
+        /**
+         * @brief Retrieves the live load counters of the `io_context` at the given index.
+         *
+         * @param idx The index of the worker `io_context`.
+         *
+         * @return A reference to the load counters.
+         *
+         * @warning The index must be less than `size()`.
+         */
+        [[nodiscard]] CLUEAPI_INLINE load_t& load(std::size_t idx) const noexcept {
+            return m_loads[idx];
+        }
+
+        /**
+         * @brief Accounts a new connection on the `io_context` at the given index.
+         *
+         * @param idx The index of the worker `io_context`.
+         */
+        CLUEAPI_INLINE void add_connection(std::size_t idx) const noexcept {
+            m_loads[idx].m_active_connections.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Accounts a finished connection on the `io_context` at the given index.
+         *
+         * @param idx The index of the worker `io_context`.
+         */
+        CLUEAPI_INLINE void remove_connection(std::size_t idx) const noexcept {
+            m_loads[idx].m_active_connections.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Posts a handler to the `io_context` at the given index and accounts it as
+         * queued until it starts running.
+         *
+         * @param idx The index of the worker `io_context`.
+         * @param handler The handler to post.
+         */
+        template <typename _handler_t>
+        CLUEAPI_INLINE void post(std::size_t idx, _handler_t&& handler) const {
+            auto& load = m_loads[idx];
+
+            load.m_queued_handlers.fetch_add(1, std::memory_order_relaxed);
+
+            boost::asio::post(
+                *m_io_ctxs[idx],
+
+                [&load, handler = std::forward<_handler_t>(handler)]() mutable {
+                    load.m_queued_handlers.fetch_sub(1, std::memory_order_relaxed);
+
+                    handler();
+                });
+        }
+
+        /**
+         * @brief Takes a snapshot of the load counters of the `io_context` at the given index.
+         *
+         * @param idx The index of the worker `io_context`.
+         *
+         * @return The load snapshot.
+         */
+        [[nodiscard]] stats_t stats(std::size_t idx) const noexcept;
+
+        /**
+         * @brief Takes a snapshot of the load counters of every worker `io_context`.
+         *
+         * @return The load snapshots, in worker order.
+         */
+        [[nodiscard]] std::vector<stats_t> stats() const;
+
+       private:
+        /**
+         * @brief Computes the load score used by the load-aware selection policies.
+         *
+         * @param idx The index of the worker `io_context`.
+         *
+         * @return The load score.
+         */
+        [[nodiscard]] CLUEAPI_INLINE std::size_t load_score(std::size_t idx) const noexcept {
+            const auto& load = m_loads[idx];
+
+            return load.m_active_connections.load(std::memory_order_relaxed) +
+                   load.m_queued_handlers.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Pins the calling thread to a CPU.
+         *
+         * @param cpu The CPU id, `-1` to leave the thread unpinned.
+         *
+         * @return `true` on success, `false` otherwise.
+         */
+        static bool pin_current_thread(std::int32_t cpu) noexcept;
+
+        /**
+         * @brief Arms the loop lag probe of the `io_context` at the given index.
+         *
+         * @param idx The index of the worker `io_context`.
+         */
+        void arm_lag_probe(std::size_t idx);
+
        private:
         /**
          * @brief The default I/O context, often used for some operations.
@@ -124,6 +358,26 @@ namespace clueapi::shared {
          */
         std::vector<work_guard_t> m_work_guards;
 
+        /**
+         * @brief The load counters, one per `io_context` in the pool.
+         */
+        std::unique_ptr<load_t[]> m_loads;
+
+        /**
+         * @brief The loop lag probe timers, one per `io_context` in the pool.
+         */
+        std::vector<std::unique_ptr<boost::asio::steady_timer>> m_lag_probes;
+
+        /**
+         * @brief The pool configuration.
+         */
+        cfg_t m_cfg;
+
+        /**
+         * @brief The CPU of every thread, the workers first and then the default context.
+         */
+        std::vector<std::int32_t> m_placement;
+
         /**
          * @brief An atomic flag indicating if the pool is running.
          */
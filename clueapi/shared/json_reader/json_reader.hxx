@@ -0,0 +1,269 @@
+/**
+ * @file json_reader.hxx
+ *
+ * @brief Defines a JSON parser that reads documents straight into values with simdjson.
+ *
+ * @details The values are the ones `json_writer_t` writes, structures included, so a type
+ * described once with `k_json_fields` is both read from request bodies and written to
+ * responses. Available with `CLUEAPI_USE_SIMDJSON`.
+ */
+
+#ifndef CLUEAPI_SHARED_JSON_READER_HXX
+#define CLUEAPI_SHARED_JSON_READER_HXX
+
+#if defined(CLUEAPI_USE_SIMDJSON)
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <simdjson.h>
+
+#include "clueapi/exceptions/exceptions.hxx"
+#include "clueapi/exceptions/wrap/wrap.hxx"
+
+#include "clueapi/shared/json_writer/json_writer.hxx"
+#include "clueapi/shared/macros.hxx"
+
+namespace clueapi::shared {
+    /**
+     * @struct json_reader_t
+     *
+     * @brief Parses JSON documents into values without building a DOM.
+     *
+     * @details Uses the on-demand API of simdjson with a parser per thread. Members of a
+     * structure missing from the document keep their value, unknown ones are skipped.
+     */
+    struct json_reader_t {
+        /**
+         * @brief Parses a JSON document.
+         *
+         * @tparam _type_t The type of the value.
+         *
+         * @param json The JSON text, e.g. the body of a request.
+         *
+         * @return The value, or the reason the document doesn't fit it.
+         *
+         * @note The text is copied to a padded buffer of the thread first, as simdjson reads past
+         * the end of its input.
+         */
+        template <typename _type_t>
+        [[nodiscard]] static exceptions::expected_t<_type_t> read(std::string_view json) {
+            _type_t value{};
+
+            if (const auto error = read(json, value); error != simdjson::SUCCESS)
+                return exceptions::make_unexpected(
+                    exceptions::exception_t::make(
+                        "Failed to read JSON: {}", simdjson::error_message(error)));
+
+            return value;
+        }
+
+        /**
+         * @brief Parses a JSON document into an existing value.
+         *
+         * @param json The JSON text.
+         * @param value The value read into.
+         *
+         * @return `simdjson::SUCCESS`, or the error.
+         */
+        template <typename _type_t>
+        [[nodiscard]] static simdjson::error_code read(std::string_view json, _type_t& value) {
+            thread_local simdjson::ondemand::parser parser{};
+
+            thread_local std::string buffer{};
+
+            buffer.reserve(json.size() + simdjson::SIMDJSON_PADDING);
+
+            buffer.assign(json);
+
+            simdjson::ondemand::document document{};
+
+            if (const auto error =
+                    parser.iterate(buffer.data(), buffer.size(), buffer.capacity()).get(document))
+                return error;
+
+            if (const auto error = read_value(document, value))
+                return error;
+
+            // Trailing content after the value is an error
+            return document.at_end() ? simdjson::SUCCESS : simdjson::TRAILING_CONTENT;
+        }
+
+       private:
+        /**
+         * @brief Reads a document or a value of a document into a value.
+         */
+        template <typename _source_t, typename _type_t>
+        static simdjson::error_code read_value(_source_t&& source, _type_t& value);
+
+        /**
+         * @brief Reads an integer, checking that it fits.
+         */
+        template <typename _source_t, typename _type_t>
+        static simdjson::error_code read_integer(_source_t&& source, _type_t& value);
+    };
+
+    template <typename _source_t, typename _type_t>
+    simdjson::error_code json_reader_t::read_integer(_source_t&& source, _type_t& value) {
+        if constexpr (std::is_signed_v<_type_t>) {
+            std::int64_t number{};
+
+            if (const auto error = source.get_int64().get(number))
+                return error;
+
+            if (number < std::numeric_limits<_type_t>::min() ||
+                number > std::numeric_limits<_type_t>::max())
+                return simdjson::NUMBER_OUT_OF_RANGE;
+
+            value = static_cast<_type_t>(number);
+        } else {
+            std::uint64_t number{};
+
+            if (const auto error = source.get_uint64().get(number))
+                return error;
+
+            if (number > std::numeric_limits<_type_t>::max())
+                return simdjson::NUMBER_OUT_OF_RANGE;
+
+            value = static_cast<_type_t>(number);
+        }
+
+        return simdjson::SUCCESS;
+    }
+
+    template <typename _source_t, typename _type_t>
+    simdjson::error_code json_reader_t::read_value(_source_t&& source, _type_t& value) {
+        using type_t = std::remove_cvref_t<_type_t>;
+
+        if constexpr (std::is_same_v<type_t, bool>)
+            return source.get_bool().get(value);
+        else if constexpr (std::is_integral_v<type_t>)
+            return read_integer(source, value);
+        else if constexpr (std::is_enum_v<type_t>) {
+            std::underlying_type_t<type_t> underlying{};
+
+            if (const auto error = read_integer(source, underlying))
+                return error;
+
+            value = static_cast<type_t>(underlying);
+
+            return simdjson::SUCCESS;
+        } else if constexpr (std::is_floating_point_v<type_t>) {
+            double number{};
+
+            if (const auto error = source.get_double().get(number))
+                return error;
+
+            value = static_cast<type_t>(number);
+
+            return simdjson::SUCCESS;
+        } else if constexpr (std::is_same_v<type_t, std::string>) {
+            std::string_view str{};
+
+            if (const auto error = source.get_string().get(str))
+                return error;
+
+            value.assign(str);
+
+            return simdjson::SUCCESS;
+        } else if constexpr (requires {
+                                 typename type_t::value_type;
+                                 value.reset();
+                                 value.emplace();
+                             }) {
+            bool is_null{};
+
+            if (const auto error = source.is_null().get(is_null))
+                return error;
+
+            if (is_null) {
+                value.reset();
+
+                return simdjson::SUCCESS;
+            }
+
+            return read_value(source, value.emplace());
+        } else if constexpr (json_reflectable_c<type_t>) {
+            simdjson::ondemand::object object{};
+
+            if (const auto error = source.get_object().get(object))
+                return error;
+
+            for (auto field : object) {
+                std::string_view key{};
+
+                if (const auto error = field.unescaped_key().get(key))
+                    return error;
+
+                auto error = simdjson::SUCCESS;
+
+                // The value of an unknown key is skipped by the iteration
+                std::apply(
+                    [&](const auto&... fields) {
+                        static_cast<void>(
+                            ((key == fields.m_name &&
+                              (error = read_value(field.value(), value.*(fields.m_member)),
+                               true)) ||
+                             ...));
+                    },
+                    json_meta_t<type_t>::k_fields);
+
+                if (error)
+                    return error;
+            }
+
+            return simdjson::SUCCESS;
+        } else if constexpr (json_map_c<type_t>) {
+            simdjson::ondemand::object object{};
+
+            if (const auto error = source.get_object().get(object))
+                return error;
+
+            for (auto field : object) {
+                std::string_view key{};
+
+                if (const auto error = field.unescaped_key().get(key))
+                    return error;
+
+                typename type_t::mapped_type item{};
+
+                if (const auto error = read_value(field.value(), item))
+                    return error;
+
+                value.insert_or_assign(typename type_t::key_type{key}, std::move(item));
+            }
+
+            return simdjson::SUCCESS;
+        } else if constexpr (requires { value.emplace_back(); }) {
+            simdjson::ondemand::array array{};
+
+            if (const auto error = source.get_array().get(array))
+                return error;
+
+            value.clear();
+
+            for (auto element : array) {
+                simdjson::ondemand::value item{};
+
+                if (const auto error = element.get(item))
+                    return error;
+
+                if (const auto error = read_value(item, value.emplace_back()))
+                    return error;
+            }
+
+            return simdjson::SUCCESS;
+        } else
+            static_assert(
+                !sizeof(type_t),
+                "The type can't be read from JSON, describe it with k_json_fields or json_meta_t");
+    }
+} // namespace clueapi::shared
+#endif // CLUEAPI_USE_SIMDJSON
+
+#endif // CLUEAPI_SHARED_JSON_READER_HXX
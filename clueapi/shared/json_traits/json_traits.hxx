@@ -6,6 +6,10 @@
  * @details This file provides a generic `json_traits_t` struct that can be specialized
  * for different JSON libraries (e.g., nlohmann/json). It is used to encapsulate
  * serialization and deserialization operations.
+ *
+ * With `CLUEAPI_USE_CUSTOM_JSON`, the header named by `CLUEAPI_CUSTOM_JSON_TRAITS` (e.g.,
+ * `-DCLUEAPI_CUSTOM_JSON_TRAITS="<my/json_traits.hxx>"`) defines `clueapi::shared::json_traits_t`
+ * with the same members: `raw_json_t`, `json_obj_t`, `serialize`, `deserialize` and `at`.
  */
 
 #ifndef CLUEAPI_SHARED_JSON_TRAITS_HXX
@@ -105,9 +109,11 @@ namespace clueapi::shared {
             return obj.at(key).get<_type_t>();
         }
     };
+} // namespace clueapi::shared
+#elif defined(CLUEAPI_CUSTOM_JSON_TRAITS)
+#include CLUEAPI_CUSTOM_JSON_TRAITS
 #else
-    // ...
+#error "A JSON backend is required: CLUEAPI_USE_NLOHMANN_JSON, or CLUEAPI_CUSTOM_JSON_TRAITS"
 #endif // CLUEAPI_USE_NLOHMANN_JSON && !CLUEAPI_USE_CUSTOM_JSON
-} // namespace clueapi::shared
 
 #endif // CLUEAPI_SHARED_JSON_TRAITS_HXX
\ No newline at end of file
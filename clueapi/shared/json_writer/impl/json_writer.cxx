@@ -0,0 +1,95 @@
+/**
+ * @file json_writer.cxx
+ *
+ * @brief Implements the scalar parts of the JSON serializer.
+ */
+
+#include "clueapi/shared/json_writer/json_writer.hxx"
+
+#include <array>
+#include <charconv>
+#include <cmath>
+
+namespace clueapi::shared {
+    namespace {
+        /**
+         * @brief The escape of every byte below 0x20, and of the quote and the backslash.
+         *
+         * @details An empty entry is copied as is.
+         */
+        constexpr auto k_escapes = [] {
+            std::array<std::string_view, 256> ret{};
+
+            constexpr std::array<std::string_view, 32> k_controls{
+                "\\u0000", "\\u0001", "\\u0002", "\\u0003", "\\u0004", "\\u0005", "\\u0006",
+                "\\u0007", "\\b",     "\\t",     "\\n",     "\\u000b", "\\f",     "\\r",
+                "\\u000e", "\\u000f", "\\u0010", "\\u0011", "\\u0012", "\\u0013", "\\u0014",
+                "\\u0015", "\\u0016", "\\u0017", "\\u0018", "\\u0019", "\\u001a", "\\u001b",
+                "\\u001c", "\\u001d", "\\u001e", "\\u001f"};
+
+            for (std::size_t i{}; i < k_controls.size(); i++)
+                ret[i] = k_controls[i];
+
+            ret['"'] = "\\\"";
+            ret['\\'] = "\\\\";
+
+            return ret;
+        }();
+    } // namespace
+
+    void json_writer_t::write_string(std::string& out, std::string_view str) {
+        out.reserve(out.size() + str.size() + 2u);
+
+        out.push_back('"');
+
+        // Runs of bytes that need no escape are appended at once
+        std::size_t begin{};
+
+        for (std::size_t i{}; i < str.size(); i++) {
+            const auto& escape = k_escapes[static_cast<unsigned char>(str[i])];
+
+            if (escape.empty())
+                continue;
+
+            out.append(str.data() + begin, i - begin);
+
+            out.append(escape);
+
+            begin = i + 1u;
+        }
+
+        out.append(str.data() + begin, str.size() - begin);
+
+        out.push_back('"');
+    }
+
+    void json_writer_t::write_integer(std::string& out, long long value) {
+        std::array<char, 24> buffer{};
+
+        const auto [end, _] = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+
+        out.append(buffer.data(), end);
+    }
+
+    void json_writer_t::write_unsigned(std::string& out, unsigned long long value) {
+        std::array<char, 24> buffer{};
+
+        const auto [end, _] = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+
+        out.append(buffer.data(), end);
+    }
+
+    void json_writer_t::write_double(std::string& out, double value) {
+        if (!std::isfinite(value)) {
+            out.append("null");
+
+            return;
+        }
+
+        std::array<char, 32> buffer{};
+
+        const auto [end, _] = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+
+        out.append(buffer.data(), end);
+    }
+} // namespace clueapi::shared
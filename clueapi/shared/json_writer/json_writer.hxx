@@ -0,0 +1,305 @@
+/**
+ * @file json_writer.hxx
+ *
+ * @brief Defines a JSON serializer that writes values straight into a string, without a DOM.
+ *
+ * @details Structures are described once by a list of fields, in the style of a reflection
+ * library:
+ *
+ * @code
+ * struct user_t {
+ *     std::uint64_t m_id;
+ *     std::string m_name;
+ *
+ *     static constexpr auto k_json_fields = shared::json_fields(
+ *         shared::json_field("id", &user_t::m_id), shared::json_field("name", &user_t::m_name));
+ * };
+ * @endcode
+ *
+ * Types that can't be changed are described by specializing `json_meta_t` instead.
+ */
+
+#ifndef CLUEAPI_SHARED_JSON_WRITER_HXX
+#define CLUEAPI_SHARED_JSON_WRITER_HXX
+
+#include <concepts>
+#include <cstddef>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "clueapi/shared/json_traits/json_traits.hxx"
+#include "clueapi/shared/macros.hxx"
+
+namespace clueapi::shared {
+    /**
+     * @struct json_field_t
+     *
+     * @brief A member of a structure and its JSON name.
+     *
+     * @tparam _owner_t The structure.
+     * @tparam _member_t The type of the member.
+     */
+    template <typename _owner_t, typename _member_t>
+    struct json_field_t {
+        /**
+         * @brief The type of the structure.
+         */
+        using owner_t = _owner_t;
+
+        /**
+         * @brief The type of the member.
+         */
+        using member_t = _member_t;
+
+        /**
+         * @brief The JSON name of the member, written as is (it must not need escaping).
+         */
+        std::string_view m_name;
+
+        /**
+         * @brief The member.
+         */
+        _member_t _owner_t::*m_member;
+    };
+
+    /**
+     * @brief Describes a member of a structure.
+     *
+     * @param name The JSON name of the member.
+     * @param member The member.
+     *
+     * @return The description of the member.
+     */
+    template <typename _owner_t, typename _member_t>
+    CLUEAPI_INLINE constexpr auto json_field(
+        std::string_view name, _member_t _owner_t::*member) noexcept {
+        return json_field_t<_owner_t, _member_t>{name, member};
+    }
+
+    /**
+     * @brief Describes the members of a structure, in the order they are written.
+     *
+     * @param fields The descriptions of the members.
+     *
+     * @return The descriptions, as a tuple.
+     */
+    template <typename... _fields_t>
+    CLUEAPI_INLINE constexpr auto json_fields(_fields_t... fields) noexcept {
+        return std::tuple<_fields_t...>{fields...};
+    }
+
+    /**
+     * @struct json_meta_t
+     *
+     * @brief The JSON description of a structure.
+     *
+     * @details Reads `_type_t::k_json_fields` by default. Specialize it with a `k_fields` member
+     * to describe a type without changing it.
+     */
+    template <typename _type_t>
+    struct json_meta_t {};
+
+    template <typename _type_t>
+        requires requires { _type_t::k_json_fields; }
+    struct json_meta_t<_type_t> {
+        static constexpr auto k_fields = _type_t::k_json_fields;
+    };
+
+    /**
+     * @brief A concept for structures with a JSON description.
+     */
+    template <typename _type_t>
+    concept json_reflectable_c = requires { json_meta_t<_type_t>::k_fields; };
+
+    /**
+     * @brief A concept for the types written as JSON strings.
+     */
+    template <typename _type_t>
+    concept json_string_c = std::is_convertible_v<const _type_t&, std::string_view>;
+
+    /**
+     * @brief A concept for maps with string keys, written as JSON objects.
+     */
+    template <typename _type_t>
+    concept json_map_c = requires {
+        typename _type_t::key_type;
+        typename _type_t::mapped_type;
+    } && json_string_c<typename _type_t::key_type>;
+
+    /**
+     * @struct json_writer_t
+     *
+     * @brief Serializes values to JSON by appending to a string.
+     *
+     * @details Supported values are booleans, numbers, strings, `std::optional` (`null` when
+     * empty), `std::nullptr_t`, maps with string keys, ranges, described structures and the JSON
+     * objects of the configured JSON library. Non-finite floating point numbers are written as
+     * `null`.
+     */
+    struct json_writer_t {
+        /**
+         * @brief Appends a value as JSON.
+         *
+         * @param out The string appended to, e.g. the body of a response.
+         * @param value The value.
+         */
+        template <typename _type_t>
+        static void write(std::string& out, const _type_t& value);
+
+        /**
+         * @brief Serializes a value as JSON.
+         *
+         * @param value The value.
+         * @param reserve The number of bytes reserved up front.
+         *
+         * @return The JSON text.
+         */
+        template <typename _type_t>
+        [[nodiscard]] CLUEAPI_INLINE static std::string to_string(
+            const _type_t& value, std::size_t reserve = 256u) {
+            std::string out{};
+
+            out.reserve(reserve);
+
+            write(out, value);
+
+            return out;
+        }
+
+        /**
+         * @brief Appends a string as a quoted and escaped JSON string.
+         *
+         * @param out The string appended to.
+         * @param str The string.
+         */
+        static void write_string(std::string& out, std::string_view str);
+
+        /**
+         * @brief Appends a signed integer.
+         */
+        static void write_integer(std::string& out, long long value);
+
+        /**
+         * @brief Appends an unsigned integer.
+         */
+        static void write_unsigned(std::string& out, unsigned long long value);
+
+        /**
+         * @brief Appends a floating point number, in its shortest exact form.
+         */
+        static void write_double(std::string& out, double value);
+
+       private:
+        /**
+         * @brief Appends the members of a described structure as a JSON object.
+         */
+        template <typename _type_t>
+        static void write_object(std::string& out, const _type_t& value);
+    };
+
+    template <typename _type_t>
+    void json_writer_t::write(std::string& out, const _type_t& value) {
+        using type_t = std::remove_cvref_t<_type_t>;
+
+        if constexpr (std::is_same_v<type_t, bool>)
+            out.append(value ? "true" : "false");
+        else if constexpr (std::is_same_v<type_t, std::nullptr_t>)
+            out.append("null");
+        else if constexpr (std::is_same_v<type_t, char>)
+            write_string(out, std::string_view{&value, 1u});
+        else if constexpr (std::is_integral_v<type_t> && std::is_signed_v<type_t>)
+            write_integer(out, static_cast<long long>(value));
+        else if constexpr (std::is_integral_v<type_t>)
+            write_unsigned(out, static_cast<unsigned long long>(value));
+        else if constexpr (std::is_enum_v<type_t>)
+            write(out, static_cast<std::underlying_type_t<type_t>>(value));
+        else if constexpr (std::is_floating_point_v<type_t>)
+            write_double(out, static_cast<double>(value));
+        else if constexpr (std::is_same_v<type_t, json_traits_t::json_obj_t>)
+            out.append(json_traits_t::serialize(value));
+        else if constexpr (json_string_c<type_t>)
+            write_string(out, std::string_view{value});
+        else if constexpr (json_reflectable_c<type_t>)
+            write_object(out, value);
+        else if constexpr (requires { typename type_t::value_type; value.has_value(); *value; }) {
+            if (value.has_value())
+                write(out, *value);
+            else
+                out.append("null");
+        } else if constexpr (json_map_c<type_t>) {
+            out.push_back('{');
+
+            bool first{true};
+
+            for (const auto& [key, item] : value) {
+                if (!first)
+                    out.push_back(',');
+
+                first = false;
+
+                write_string(out, std::string_view{key});
+
+                out.push_back(':');
+
+                write(out, item);
+            }
+
+            out.push_back('}');
+        } else if constexpr (std::ranges::input_range<const type_t>) {
+            out.push_back('[');
+
+            bool first{true};
+
+            for (const auto& item : value) {
+                if (!first)
+                    out.push_back(',');
+
+                first = false;
+
+                write(out, item);
+            }
+
+            out.push_back(']');
+        } else
+            static_assert(
+                !sizeof(type_t),
+                "The type can't be written as JSON, describe it with k_json_fields or json_meta_t");
+    }
+
+    template <typename _type_t>
+    void json_writer_t::write_object(std::string& out, const _type_t& value) {
+        out.push_back('{');
+
+        bool first{true};
+
+        std::apply(
+            [&](const auto&... fields) {
+                (
+                    [&] {
+                        if (!first)
+                            out.push_back(',');
+
+                        first = false;
+
+                        out.push_back('"');
+
+                        out.append(fields.m_name);
+
+                        out.append("\":");
+
+                        write(out, value.*(fields.m_member));
+                    }(),
+                    ...);
+            },
+            json_meta_t<_type_t>::k_fields);
+
+        out.push_back('}');
+    }
+} // namespace clueapi::shared
+
+#endif // CLUEAPI_SHARED_JSON_WRITER_HXX
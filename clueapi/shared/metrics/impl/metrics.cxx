@@ -0,0 +1,413 @@
+/**
+ * @file metrics.cxx
+ *
+ * @brief This file implements the `metrics_t` struct.
+ */
+
+#include "clueapi/shared/metrics/metrics.hxx"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+
+#include <fmt/format.h>
+
+namespace clueapi::shared {
+    namespace {
+        /**
+         * @brief Type alias for a counter, written by the thread of its shard only.
+         */
+        using counter_t = std::atomic<std::uint64_t>;
+
+        /**
+         * @brief Adds to a counter of the calling thread's shard.
+         */
+        CLUEAPI_INLINE void bump(counter_t& counter, std::uint64_t value) noexcept {
+            counter.store(
+                counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+
+        /**
+         * @struct route_shard_t
+         *
+         * @brief The histogram of a route in the shard of a thread.
+         */
+        struct route_shard_t {
+            std::array<counter_t, histogram_t::k_buckets> m_counts{};
+
+            counter_t m_sum{};
+
+            counter_t m_count{};
+        };
+
+        /**
+         * @struct shard_t
+         *
+         * @brief The counters of a thread.
+         */
+        struct alignas(64) shard_t {
+            CLUEAPI_INLINE shard_t()
+                : m_routes{std::make_unique<std::atomic<route_shard_t*>[]>(
+                      metrics_t::k_max_routes)} {
+            }
+
+            CLUEAPI_INLINE ~shard_t() noexcept {
+                for (std::uint32_t i{}; i < metrics_t::k_max_routes; i++)
+                    delete m_routes[i].load(std::memory_order_relaxed);
+            }
+
+            /**
+             * @brief Set while a thread records into the shard.
+             */
+            std::atomic_bool m_owned{true};
+
+            std::array<counter_t, 5> m_responses{};
+
+            counter_t m_request_bytes{};
+
+            counter_t m_response_bytes{};
+
+            counter_t m_timeouts{};
+
+            /**
+             * @brief The histograms of the routes, made on the first request to each.
+             */
+            std::unique_ptr<std::atomic<route_shard_t*>[]> m_routes;
+        };
+
+        /**
+         * @struct state_t
+         *
+         * @brief The shards and the routes of the process.
+         */
+        struct state_t {
+            std::mutex m_mutex;
+
+            std::vector<std::unique_ptr<shard_t>> m_shards;
+
+            std::vector<std::pair<std::string, std::string>> m_routes;
+
+            /**
+             * @brief Takes over the shard of an exited thread, or makes a new one.
+             */
+            shard_t* acquire() {
+                std::lock_guard lock{m_mutex};
+
+                for (const auto& shard : m_shards) {
+                    if (!shard->m_owned.exchange(true, std::memory_order_acq_rel))
+                        return shard.get();
+                }
+
+                return m_shards.emplace_back(std::make_unique<shard_t>()).get();
+            }
+        };
+
+        /**
+         * @brief Gets the state of the process.
+         *
+         * @details Never destroyed, threads that outlive `main()` may still record.
+         */
+        state_t& state() {
+            static auto* ret = new state_t{};
+
+            return *ret;
+        }
+
+        /**
+         * @struct owner_t
+         *
+         * @brief The shard of a thread, released when the thread exits.
+         */
+        struct owner_t {
+            CLUEAPI_INLINE ~owner_t() noexcept {
+                if (m_shard)
+                    m_shard->m_owned.store(false, std::memory_order_release);
+            }
+
+            shard_t* m_shard{};
+        };
+
+        /**
+         * @brief Gets the shard of the calling thread.
+         *
+         * @return The shard, `nullptr` if it couldn't be made.
+         */
+        shard_t* shard_of() noexcept {
+            thread_local owner_t owner{};
+
+            if (!owner.m_shard) {
+                try {
+                    owner.m_shard = state().acquire();
+                } catch (...) {
+                    // ...
+                }
+            }
+
+            return owner.m_shard;
+        }
+
+        /**
+         * @brief Appends a label value, escaped for the Prometheus text format.
+         */
+        void append_label(std::string& out, std::string_view value) {
+            for (const auto c : value) {
+                if (c == '\\')
+                    out.append("\\\\");
+                else if (c == '"')
+                    out.append("\\\"");
+                else if (c == '\n')
+                    out.append("\\n");
+                else
+                    out.push_back(c);
+            }
+        }
+
+        /**
+         * @brief Appends the header of a metric.
+         */
+        void append_header(
+            std::string& out, std::string_view name, std::string_view type, std::string_view help) {
+            fmt::format_to(
+                std::back_inserter(out), "# HELP {} {}\n# TYPE {} {}\n", name, help, name, type);
+        }
+    } // namespace
+
+    std::uint64_t histogram_t::value_at(const counts_t& counts, double quantile) {
+        std::uint64_t total{};
+
+        for (const auto count : counts)
+            total += count;
+
+        if (total == 0u)
+            return 0u;
+
+        const auto rank = std::max<std::uint64_t>(
+            static_cast<std::uint64_t>(
+                std::ceil(std::clamp(quantile, 0.0, 1.0) * static_cast<double>(total))),
+            1u);
+
+        std::uint64_t seen{};
+
+        for (std::size_t i{}; i < k_buckets; i++) {
+            seen += counts[i];
+
+            if (seen >= rank)
+                return upper_bound(i) - 1u;
+        }
+
+        return upper_bound(k_buckets - 1u) - 1u;
+    }
+
+    std::uint32_t metrics_t::add_route(std::string_view method, std::string_view path) {
+        auto& state = shared::state();
+
+        std::lock_guard lock{state.m_mutex};
+
+        if (state.m_routes.size() >= k_max_routes)
+            return k_untracked;
+
+        state.m_routes.emplace_back(std::string{method}, std::string{path});
+
+        return static_cast<std::uint32_t>(state.m_routes.size() - 1u);
+    }
+
+    void metrics_t::record_latency(
+        std::uint32_t route, std::chrono::steady_clock::duration latency) noexcept {
+        if (route >= k_max_routes)
+            return;
+
+        auto* shard = shard_of();
+
+        if (!shard)
+            return;
+
+        auto* route_shard = shard->m_routes[route].load(std::memory_order_relaxed);
+
+        if (!route_shard) {
+            route_shard = new (std::nothrow) route_shard_t{};
+
+            if (!route_shard)
+                return;
+
+            // Published for the scrapes, the counts are zero until then
+            shard->m_routes[route].store(route_shard, std::memory_order_release);
+        }
+
+        const auto value = static_cast<std::uint64_t>(std::max<std::int64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(latency).count(), 0));
+
+        bump(route_shard->m_counts[histogram_t::bucket_of(value)], 1u);
+
+        bump(route_shard->m_sum, value);
+
+        bump(route_shard->m_count, 1u);
+    }
+
+    void metrics_t::record_response(
+        std::uint32_t status, std::uint64_t request_bytes, std::uint64_t response_bytes) noexcept {
+        auto* shard = shard_of();
+
+        if (!shard)
+            return;
+
+        const auto status_class = std::clamp<std::uint32_t>(status / 100u, 1u, 5u) - 1u;
+
+        bump(shard->m_responses[status_class], 1u);
+
+        bump(shard->m_request_bytes, request_bytes);
+
+        bump(shard->m_response_bytes, response_bytes);
+    }
+
+    void metrics_t::record_timeout() noexcept {
+        if (auto* shard = shard_of())
+            bump(shard->m_timeouts, 1u);
+    }
+
+    metrics_t::snapshot_t metrics_t::snapshot() {
+        auto& state = shared::state();
+
+        std::lock_guard lock{state.m_mutex};
+
+        snapshot_t ret{};
+
+        ret.m_workers.reserve(state.m_shards.size());
+
+        ret.m_routes.resize(state.m_routes.size());
+
+        for (std::size_t i{}; i < state.m_routes.size(); i++) {
+            ret.m_routes[i].m_method = state.m_routes[i].first;
+
+            ret.m_routes[i].m_path = state.m_routes[i].second;
+        }
+
+        for (const auto& shard : state.m_shards) {
+            auto& worker = ret.m_workers.emplace_back();
+
+            for (std::size_t i{}; i < worker.m_responses.size(); i++)
+                worker.m_responses[i] = shard->m_responses[i].load(std::memory_order_relaxed);
+
+            worker.m_request_bytes = shard->m_request_bytes.load(std::memory_order_relaxed);
+
+            worker.m_response_bytes = shard->m_response_bytes.load(std::memory_order_relaxed);
+
+            worker.m_timeouts = shard->m_timeouts.load(std::memory_order_relaxed);
+
+            for (std::size_t i{}; i < ret.m_routes.size(); i++) {
+                const auto* route_shard = shard->m_routes[i].load(std::memory_order_acquire);
+
+                if (!route_shard)
+                    continue;
+
+                auto& route = ret.m_routes[i];
+
+                for (std::size_t j{}; j < histogram_t::k_buckets; j++)
+                    route.m_counts[j] += route_shard->m_counts[j].load(std::memory_order_relaxed);
+
+                route.m_sum += route_shard->m_sum.load(std::memory_order_relaxed);
+
+                route.m_count += route_shard->m_count.load(std::memory_order_relaxed);
+            }
+        }
+
+        return ret;
+    }
+
+    void metrics_t::write_prometheus(std::string& out, const snapshot_t& snapshot) {
+        constexpr std::array<std::string_view, 5> k_classes{"1xx", "2xx", "3xx", "4xx", "5xx"};
+
+        const auto append = std::back_inserter(out);
+
+        append_header(
+            out, "clueapi_responses_total", "counter", "Responses sent, by worker and status.");
+
+        for (std::size_t i{}; i < snapshot.m_workers.size(); i++) {
+            for (std::size_t j{}; j < k_classes.size(); j++)
+                fmt::format_to(
+                    append,
+                    "clueapi_responses_total{{worker=\"{}\",status=\"{}\"}} {}\n",
+                    i,
+                    k_classes[j],
+                    snapshot.m_workers[i].m_responses[j]);
+        }
+
+        const auto append_counter = [&](std::string_view name,
+                                        std::string_view help,
+                                        std::uint64_t metrics_t::worker_t::*counter) {
+            append_header(out, name, "counter", help);
+
+            for (std::size_t i{}; i < snapshot.m_workers.size(); i++)
+                fmt::format_to(
+                    append, "{}{{worker=\"{}\"}} {}\n", name, i, snapshot.m_workers[i].*counter);
+        };
+
+        append_counter(
+            "clueapi_request_bytes_total",
+            "Body bytes of the requests read.",
+            &metrics_t::worker_t::m_request_bytes);
+
+        append_counter(
+            "clueapi_response_bytes_total",
+            "Body bytes of the responses sent.",
+            &metrics_t::worker_t::m_response_bytes);
+
+        append_counter(
+            "clueapi_timeouts_total",
+            "I/O operations that timed out.",
+            &metrics_t::worker_t::m_timeouts);
+
+        append_header(
+            out,
+            "clueapi_route_latency_seconds",
+            "histogram",
+            "Latency of the route handlers.");
+
+        for (const auto& route : snapshot.m_routes) {
+            std::string labels{"method=\""};
+
+            append_label(labels, route.m_method);
+
+            labels.append("\",route=\"");
+
+            append_label(labels, route.m_path);
+
+            labels.push_back('"');
+
+            std::uint64_t cumulative{};
+
+            // Only the powers of two are exposed, the bucket boundaries that fall on them
+            for (std::size_t i{}; i < histogram_t::k_buckets; i++) {
+                cumulative += route.m_counts[i];
+
+                const auto bound = histogram_t::upper_bound(i);
+
+                if (!std::has_single_bit(bound))
+                    continue;
+
+                fmt::format_to(
+                    append,
+                    "clueapi_route_latency_seconds_bucket{{{},le=\"{}\"}} {}\n",
+                    labels,
+                    static_cast<double>(bound) / 1e6,
+                    cumulative);
+            }
+
+            fmt::format_to(
+                append,
+                "clueapi_route_latency_seconds_bucket{{{},le=\"+Inf\"}} {}\n"
+                "clueapi_route_latency_seconds_sum{{{}}} {}\n"
+                "clueapi_route_latency_seconds_count{{{}}} {}\n",
+                labels,
+                route.m_count,
+                labels,
+                static_cast<double>(route.m_sum) / 1e6,
+                labels,
+                route.m_count);
+        }
+    }
+} // namespace clueapi::shared
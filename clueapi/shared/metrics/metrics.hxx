@@ -0,0 +1,264 @@
+/**
+ * @file metrics.hxx
+ *
+ * @brief This file includes the `metrics_t` struct, the process-wide counters and latency
+ * histograms of the server, kept per worker thread and aggregated on scrape.
+ */
+
+#ifndef CLUEAPI_SHARED_METRICS_HXX
+#define CLUEAPI_SHARED_METRICS_HXX
+
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "clueapi/shared/macros.hxx"
+
+namespace clueapi::shared {
+    /**
+     * @struct histogram_t
+     *
+     * @brief The bucket layout of a latency histogram, in microseconds.
+     *
+     * @details Log-linear as in HDR histograms: the values below 16 get a bucket each, every
+     * power of two above is split into 8 buckets. A bucket is at most 12.5% wide, and the bucket
+     * of a value is found with a few shifts, without a search.
+     */
+    struct histogram_t {
+        /**
+         * @brief The number of bits of a value below its leading one that select its bucket.
+         */
+        static constexpr std::uint32_t k_sub_bits{3u};
+
+        /**
+         * @brief The number of values counted in a bucket each, `2^(k_sub_bits + 1)`.
+         */
+        static constexpr std::uint64_t k_linear{std::uint64_t{1} << (k_sub_bits + 1u)};
+
+        /**
+         * @brief The number of buckets, up to `2^32` microseconds (~71 minutes).
+         */
+        static constexpr std::size_t k_buckets{
+            k_linear + (32u - (k_sub_bits + 1u)) * (std::size_t{1} << k_sub_bits)};
+
+        /**
+         * @brief Type alias for the counts of a histogram.
+         */
+        using counts_t = std::array<std::uint64_t, k_buckets>;
+
+       public:
+        /**
+         * @brief Gets the bucket of a value.
+         *
+         * @param value The value, in microseconds. Larger ones count in the last bucket.
+         */
+        [[nodiscard]] static CLUEAPI_INLINE constexpr std::size_t bucket_of(
+            std::uint64_t value) noexcept {
+            if (value < k_linear)
+                return static_cast<std::size_t>(value);
+
+            if (value > 0xffffffffu)
+                return k_buckets - 1u;
+
+            const auto exponent = static_cast<std::uint32_t>(std::bit_width(value)) - 1u;
+
+            const auto sub = (value >> (exponent - k_sub_bits)) & ((1u << k_sub_bits) - 1u);
+
+            return static_cast<std::size_t>(
+                k_linear + (exponent - (k_sub_bits + 1u)) * (1u << k_sub_bits) + sub);
+        }
+
+        /**
+         * @brief Gets the end of a bucket, the first value past it.
+         *
+         * @param bucket The bucket.
+         */
+        [[nodiscard]] static CLUEAPI_INLINE constexpr std::uint64_t upper_bound(
+            std::size_t bucket) noexcept {
+            if (bucket < k_linear)
+                return bucket + 1u;
+
+            const auto exponent =
+                (k_sub_bits + 1u) + static_cast<std::uint32_t>((bucket - k_linear) >> k_sub_bits);
+
+            const auto sub = (bucket - k_linear) & ((std::size_t{1} << k_sub_bits) - 1u);
+
+            return ((std::uint64_t{1} << k_sub_bits) + sub + 1u) << (exponent - k_sub_bits);
+        }
+
+        /**
+         * @brief Gets the value below which a share of the counted values lies.
+         *
+         * @param counts The counts of the histogram.
+         * @param quantile The share, from `0.0` to `1.0`.
+         *
+         * @return The largest value of the bucket the quantile falls in, `0` for an empty
+         * histogram.
+         */
+        [[nodiscard]] static std::uint64_t value_at(const counts_t& counts, double quantile);
+    };
+
+    /**
+     * @struct metrics_t
+     *
+     * @brief The process-wide metrics of the server.
+     *
+     * @details Every thread records into its own shard, a cache-line aligned block of counters
+     * written by that thread alone, so recording is a plain load and store. A scrape sums the
+     * shards of all threads. The shard of a thread that exited is taken over by the next thread
+     * that starts recording, the totals never go backwards.
+     *
+     * The latency of a route is recorded under the id it got from `add_route()`, stored on the
+     * route in the routing tree, so no lookup by path happens per request.
+     *
+     * @note All functions are thread-safe.
+     */
+    struct metrics_t {
+        /**
+         * @brief The id of a route whose latency isn't recorded.
+         */
+        static constexpr std::uint32_t k_untracked{0xffffffffu};
+
+        /**
+         * @brief The maximum number of routes with a histogram.
+         */
+        static constexpr std::uint32_t k_max_routes{1024u};
+
+        /**
+         * @struct worker_t
+         *
+         * @brief The counters of a worker thread.
+         */
+        struct worker_t {
+            /**
+             * @brief The number of responses sent, by status class (1xx to 5xx).
+             */
+            std::array<std::uint64_t, 5> m_responses{};
+
+            /**
+             * @brief The number of body bytes of the requests read.
+             */
+            std::uint64_t m_request_bytes{};
+
+            /**
+             * @brief The number of body bytes of the responses sent.
+             */
+            std::uint64_t m_response_bytes{};
+
+            /**
+             * @brief The number of I/O operations that ran out of time.
+             */
+            std::uint64_t m_timeouts{};
+
+            /**
+             * @brief Gets the number of responses sent.
+             */
+            [[nodiscard]] CLUEAPI_INLINE std::uint64_t requests() const noexcept {
+                std::uint64_t ret{};
+
+                for (const auto count : m_responses)
+                    ret += count;
+
+                return ret;
+            }
+        };
+
+        /**
+         * @struct route_t
+         *
+         * @brief The latency histogram of a route.
+         */
+        struct route_t {
+            std::string m_method;
+
+            std::string m_path;
+
+            histogram_t::counts_t m_counts{};
+
+            /**
+             * @brief The sum of the latencies, in microseconds.
+             */
+            std::uint64_t m_sum{};
+
+            /**
+             * @brief The number of latencies recorded.
+             */
+            std::uint64_t m_count{};
+        };
+
+        /**
+         * @struct snapshot_t
+         *
+         * @brief The metrics at the time of a scrape.
+         */
+        struct snapshot_t {
+            /**
+             * @brief The counters of the threads, in the order they started recording.
+             */
+            std::vector<worker_t> m_workers;
+
+            /**
+             * @brief The routes, in the order they were added.
+             */
+            std::vector<route_t> m_routes;
+        };
+
+       public:
+        /**
+         * @brief Adds a route, giving it a latency histogram.
+         *
+         * @param method The method of the route.
+         * @param path The path of the route.
+         *
+         * @return The id of the route, `k_untracked` once `k_max_routes` are added.
+         */
+        static std::uint32_t add_route(std::string_view method, std::string_view path);
+
+        /**
+         * @brief Records the latency of a request to a route.
+         *
+         * @param route The id of the route.
+         * @param latency The time the handler of the route took.
+         */
+        static void record_latency(
+            std::uint32_t route, std::chrono::steady_clock::duration latency) noexcept;
+
+        /**
+         * @brief Records a response.
+         *
+         * @param status The status of the response.
+         * @param request_bytes The number of body bytes of the request.
+         * @param response_bytes The number of body bytes of the response.
+         */
+        static void record_response(
+            std::uint32_t status,
+            std::uint64_t request_bytes,
+            std::uint64_t response_bytes) noexcept;
+
+        /**
+         * @brief Records an I/O operation that ran out of time.
+         */
+        static void record_timeout() noexcept;
+
+       public:
+        /**
+         * @brief Sums the shards of all threads.
+         */
+        [[nodiscard]] static snapshot_t snapshot();
+
+        /**
+         * @brief Appends a snapshot in the Prometheus text format.
+         *
+         * @param out The string appended to.
+         * @param snapshot The snapshot.
+         */
+        static void write_prometheus(std::string& out, const snapshot_t& snapshot);
+    };
+} // namespace clueapi::shared
+
+#endif // CLUEAPI_SHARED_METRICS_HXX
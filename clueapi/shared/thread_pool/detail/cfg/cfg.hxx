@@ -0,0 +1,42 @@
+/**
+ * @file cfg.hxx
+ *
+ * @brief Defines the configuration struct for the thread pools that run the offloaded handlers.
+ */
+
+#ifndef CLUEAPI_SHARED_THREAD_POOL_DETAIL_CFG_HXX
+#define CLUEAPI_SHARED_THREAD_POOL_DETAIL_CFG_HXX
+
+#include <cstddef>
+
+namespace clueapi::shared::detail {
+    /**
+     * @struct thread_pool_cfg_t
+     *
+     * @brief Configuration settings for a thread pool.
+     */
+    struct thread_pool_cfg_t {
+        /**
+         * @brief If true, the pool is started even if no route runs on it, for the handlers that
+         * offload their own work to it.
+         *
+         * @note The pool is always started if a route runs on it.
+         */
+        bool m_enabled{false};
+
+        /**
+         * @brief The number of threads of the pool.
+         *
+         * @note A value of 0 uses the number of CPUs (`std::thread::hardware_concurrency()`).
+         */
+        std::size_t m_threads{0u};
+
+        /**
+         * @brief The maximum number of tasks waiting for a thread. A task past it is rejected,
+         * and its request answered `503 Service Unavailable`.
+         */
+        std::size_t m_max_queued{1024u};
+    };
+} // namespace clueapi::shared::detail
+
+#endif // CLUEAPI_SHARED_THREAD_POOL_DETAIL_CFG_HXX
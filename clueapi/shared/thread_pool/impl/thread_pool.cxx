@@ -0,0 +1,100 @@
+/**
+ * @file thread_pool.cxx
+ *
+ * @brief This file implements the `thread_pool_t` struct.
+ */
+
+#include "clueapi/shared/thread_pool/thread_pool.hxx"
+
+#include <algorithm>
+
+#include "clueapi/modules/macros.hxx"
+
+#ifdef __linux__
+#include <pthread.h>
+#endif // __linux__
+
+namespace clueapi::shared {
+    void thread_pool_t::start(std::string name, cfg_t cfg) {
+        if (m_running.exchange(true, std::memory_order_acq_rel))
+            return;
+
+        m_cfg = std::move(cfg);
+
+        if (m_cfg.m_threads == 0u)
+            m_cfg.m_threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+        // Kept across restarts, a coroutine racing the stop posts into a valid context
+        if (!m_io_ctx)
+            m_io_ctx = std::make_unique<boost::asio::io_context>();
+        else
+            m_io_ctx->restart();
+
+        m_work_guard = std::make_unique<
+            boost::asio::executor_work_guard<boost::asio::io_context::executor_type>>(
+            boost::asio::make_work_guard(*m_io_ctx));
+
+        m_threads.reserve(m_cfg.m_threads);
+
+        for (std::size_t i{}; i < m_cfg.m_threads; i++) {
+            m_threads.emplace_back([this, i, thread_name = fmt::format("{}_{}", name, i)] {
+#ifdef __linux__
+                // The name of a thread is limited to 15 characters
+                pthread_setname_np(pthread_self(), thread_name.substr(0u, 15u).c_str());
+#endif // __linux__
+
+                CLUEAPI_LOG_TRACE("Thread pool thread {} started", thread_name);
+
+                try {
+                    m_io_ctx->run();
+                } catch (const std::exception& e) {
+                    CLUEAPI_LOG_CRITICAL("Thread pool thread {} failed: {}", thread_name, e.what());
+                }
+            });
+        }
+
+        CLUEAPI_LOG_DEBUG(
+            "Thread pool '{}' started with {} threads (max queued: {})",
+
+            name,
+            m_cfg.m_threads,
+            m_cfg.m_max_queued);
+    }
+
+    void thread_pool_t::stop() noexcept {
+        if (!m_running.exchange(false, std::memory_order_acq_rel))
+            return;
+
+        // The threads return once the queued functions ran
+        m_work_guard.reset();
+
+        for (auto& thread : m_threads) {
+            if (thread.joinable())
+                thread.join();
+        }
+
+        m_threads.clear();
+    }
+
+    thread_pool_t::stats_t thread_pool_t::stats() const noexcept {
+        return stats_t{
+            .m_threads   = is_running() ? m_cfg.m_threads : 0u,
+            .m_queued    = m_queued.load(std::memory_order_relaxed),
+            .m_active    = m_active.load(std::memory_order_relaxed),
+            .m_completed = m_completed.load(std::memory_order_relaxed),
+            .m_rejected  = m_rejected.load(std::memory_order_relaxed)};
+    }
+
+    bool thread_pool_t::try_enqueue() noexcept {
+        const auto queued = m_queued.fetch_add(1u, std::memory_order_relaxed);
+
+        if (queued < m_cfg.m_max_queued && is_running())
+            return true;
+
+        m_queued.fetch_sub(1u, std::memory_order_relaxed);
+
+        m_rejected.fetch_add(1u, std::memory_order_relaxed);
+
+        return false;
+    }
+} // namespace clueapi::shared
@@ -0,0 +1,227 @@
+/**
+ * @file thread_pool.hxx
+ *
+ * @brief This file includes the `thread_pool_t` struct, a bounded pool of threads that runs
+ * blocking or CPU-heavy work off the I/O contexts.
+ */
+
+#ifndef CLUEAPI_SHARED_THREAD_POOL_HXX
+#define CLUEAPI_SHARED_THREAD_POOL_HXX
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/asio/async_result.hpp>
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/use_awaitable.hpp>
+
+#include "clueapi/shared/macros.hxx"
+#include "clueapi/shared/shared.hxx"
+#include "clueapi/shared/thread_pool/detail/cfg/cfg.hxx"
+
+namespace clueapi::shared {
+    /**
+     * @struct thread_pool_t
+     *
+     * @brief Runs functions on a fixed set of threads for the coroutines of the I/O contexts.
+     *
+     * @details `run()` queues a function and suspends the calling coroutine, which resumes on its
+     * own executor once the function returned, so a blocking call never stalls the other
+     * connections of its `io_context`. The number of functions waiting for a thread is bounded by
+     * `cfg_t::m_max_queued`, a function past it is rejected without running.
+     *
+     * @note All functions are thread-safe.
+     */
+    struct thread_pool_t {
+        /**
+         * @brief Type alias for the pool configuration.
+         */
+        using cfg_t = detail::thread_pool_cfg_t;
+
+        /**
+         * @struct stats_t
+         *
+         * @brief A snapshot of the counters of the pool.
+         */
+        struct stats_t {
+            /**
+             * @brief The number of threads.
+             */
+            std::size_t m_threads{};
+
+            /**
+             * @brief The number of functions waiting for a thread.
+             */
+            std::size_t m_queued{};
+
+            /**
+             * @brief The number of functions running.
+             */
+            std::size_t m_active{};
+
+            /**
+             * @brief The number of functions that returned or threw.
+             */
+            std::uint64_t m_completed{};
+
+            /**
+             * @brief The number of functions rejected by a full queue or a stopped pool.
+             */
+            std::uint64_t m_rejected{};
+        };
+
+       public:
+        CLUEAPI_INLINE thread_pool_t() noexcept = default;
+
+        CLUEAPI_INLINE ~thread_pool_t() noexcept {
+            stop();
+        }
+
+        // Copy constructor
+        CLUEAPI_INLINE thread_pool_t(const thread_pool_t&) = delete;
+
+        // Copy assignment operator
+        CLUEAPI_INLINE thread_pool_t& operator=(const thread_pool_t&) = delete;
+
+       public:
+        /**
+         * @brief Starts the threads of the pool.
+         *
+         * @param name The prefix of the names of the threads.
+         * @param cfg The pool configuration.
+         */
+        void start(std::string name, cfg_t cfg = {});
+
+        /**
+         * @brief Runs the queued functions to completion and joins the threads.
+         *
+         * @details Functions passed to `run()` from now on are rejected.
+         */
+        void stop() noexcept;
+
+        /**
+         * @brief Runs a function on a thread of the pool.
+         *
+         * @tparam _fn_t The type of the function, returning a value.
+         *
+         * @param fn The function. It is called once, on a thread of the pool, then destroyed by
+         * the calling coroutine.
+         *
+         * @return An awaitable that resolves to the result of the function once the coroutine is
+         * back on its executor, `std::nullopt` if the function was rejected. An exception thrown
+         * by the function is rethrown by the awaitable.
+         */
+        template <typename _fn_t>
+        shared::awaitable_t<std::optional<std::invoke_result_t<_fn_t&>>> run(_fn_t fn) {
+            using result_t = std::invoke_result_t<_fn_t&>;
+
+            static_assert(!std::is_void_v<result_t>, "The function must return a value");
+
+            if (!try_enqueue())
+                co_return std::nullopt;
+
+            std::optional<result_t> ret{};
+
+            std::exception_ptr error{};
+
+            co_await boost::asio::async_initiate<const boost::asio::use_awaitable_t<>&, void()>(
+                [this, &fn, &ret, &error](auto handler) {
+                    auto work = boost::asio::make_work_guard(
+                        boost::asio::get_associated_executor(handler));
+
+                    boost::asio::post(
+                        *m_io_ctx,
+
+                        [this,
+                         &fn,
+                         &ret,
+                         &error,
+                         handler = std::move(handler),
+                         work    = std::move(work)]() mutable {
+                            m_queued.fetch_sub(1u, std::memory_order_relaxed);
+
+                            m_active.fetch_add(1u, std::memory_order_relaxed);
+
+                            try {
+                                ret.emplace(fn());
+                            } catch (...) {
+                                error = std::current_exception();
+                            }
+
+                            m_active.fetch_sub(1u, std::memory_order_relaxed);
+
+                            m_completed.fetch_add(1u, std::memory_order_relaxed);
+
+                            auto executor = work.get_executor();
+
+                            work.reset();
+
+                            boost::asio::post(executor, std::move(handler));
+                        });
+                },
+
+                boost::asio::use_awaitable);
+
+            if (error)
+                std::rethrow_exception(error);
+
+            co_return ret;
+        }
+
+       public:
+        /**
+         * @brief Checks if the pool is running.
+         */
+        [[nodiscard]] CLUEAPI_INLINE bool is_running() const noexcept {
+            return m_running.load(std::memory_order_acquire);
+        }
+
+        /**
+         * @brief Takes a snapshot of the counters of the pool.
+         */
+        [[nodiscard]] stats_t stats() const noexcept;
+
+       private:
+        /**
+         * @brief Accounts a function in the queue.
+         *
+         * @return `true` if it fits, `false` if it is rejected.
+         */
+        [[nodiscard]] bool try_enqueue() noexcept;
+
+       private:
+        cfg_t m_cfg{};
+
+        std::atomic<bool> m_running{false};
+
+        /**
+         * @brief The context the threads run, its queue is the queue of the pool.
+         */
+        std::unique_ptr<boost::asio::io_context> m_io_ctx;
+
+        std::unique_ptr<boost::asio::executor_work_guard<boost::asio::io_context::executor_type>>
+            m_work_guard;
+
+        std::vector<std::thread> m_threads;
+
+        std::atomic<std::size_t> m_queued{0u};
+
+        std::atomic<std::size_t> m_active{0u};
+
+        std::atomic<std::uint64_t> m_completed{0u};
+
+        std::atomic<std::uint64_t> m_rejected{0u};
+    };
+} // namespace clueapi::shared
+
+#endif // CLUEAPI_SHARED_THREAD_POOL_HXX
@@ -0,0 +1,278 @@
+/**
+ * @file timer_wheel.cxx
+ *
+ * @brief This file implements the `timer_wheel_t` struct.
+ */
+
+#include "clueapi/shared/timer_wheel/timer_wheel.hxx"
+
+#include <algorithm>
+
+#include <boost/asio/error.hpp>
+#include <boost/system/error_code.hpp>
+
+namespace clueapi::shared {
+    namespace {
+        /**
+         * @brief Makes a node an empty list sentinel.
+         */
+        void reset(timer_wheel_t::node_t& head) noexcept {
+            head.m_prev = &head;
+
+            head.m_next = &head;
+        }
+
+        [[nodiscard]] bool is_empty(const timer_wheel_t::node_t& head) noexcept {
+            return head.m_next == &head;
+        }
+
+        /**
+         * @brief Appends a node to a list.
+         */
+        void link(timer_wheel_t::node_t& head, timer_wheel_t::node_t& node) noexcept {
+            node.m_prev = head.m_prev;
+            node.m_next = &head;
+
+            head.m_prev->m_next = &node;
+            head.m_prev = &node;
+        }
+
+        /**
+         * @brief Removes a node from the list it is linked into.
+         */
+        void unlink(timer_wheel_t::node_t& node) noexcept {
+            node.m_prev->m_next = node.m_next;
+            node.m_next->m_prev = node.m_prev;
+
+            node.m_prev = nullptr;
+            node.m_next = nullptr;
+        }
+
+        /**
+         * @brief Moves all nodes of a list to an empty one.
+         */
+        void splice(timer_wheel_t::node_t& from, timer_wheel_t::node_t& to) noexcept {
+            if (is_empty(from)) {
+                reset(to);
+
+                return;
+            }
+
+            to.m_next = from.m_next;
+            to.m_prev = from.m_prev;
+
+            to.m_next->m_prev = &to;
+            to.m_prev->m_next = &to;
+
+            reset(from);
+        }
+    } // namespace
+
+    timer_wheel_t::timer_wheel_t(boost::asio::io_context& io_ctx, std::chrono::milliseconds tick)
+        : m_timer{io_ctx},
+          m_tick{std::max(tick, std::chrono::milliseconds{1})},
+          m_epoch{clock_t::now()} {
+        for (auto& level : m_slots)
+            for (auto& slot : level)
+                reset(slot);
+    }
+
+    timer_wheel_t::~timer_wheel_t() {
+        disarm_all();
+    }
+
+    void timer_wheel_t::start() {
+        if (m_running)
+            return;
+
+        m_running = true;
+
+        m_current = to_tick(clock_t::now());
+
+        schedule();
+    }
+
+    void timer_wheel_t::stop() {
+        m_running = false;
+
+        m_timer.cancel();
+
+        disarm_all();
+    }
+
+    void timer_wheel_t::arm(entry_t& entry, clock_t::time_point deadline) {
+        cancel(entry);
+
+        entry.m_expired = false;
+
+        if (!m_running)
+            return;
+
+        // Nothing is linked, so an idle wheel can skip the ticks it slept through
+        if (m_size == 0)
+            m_current = std::max(m_current, to_tick(clock_t::now()));
+
+        const auto tick_ns =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(m_tick).count();
+
+        const auto elapsed_ns =
+            deadline > m_epoch
+                ? std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - m_epoch).count()
+                : 0;
+
+        // Rounded up so that an entry never expires before its deadline
+        const auto expiry_tick = static_cast<std::uint64_t>((elapsed_ns + tick_ns - 1) / tick_ns);
+
+        entry.m_expiry_tick = std::max(expiry_tick, m_current + 1);
+
+        entry.m_wheel = this;
+
+        place(entry);
+
+        m_size++;
+
+        schedule();
+    }
+
+    void timer_wheel_t::cancel(entry_t& entry) noexcept {
+        if (!entry.m_wheel)
+            return;
+
+        unlink(entry);
+
+        entry.m_wheel->m_size--;
+
+        entry.m_wheel = nullptr;
+    }
+
+    std::size_t timer_wheel_t::advance(clock_t::time_point now) {
+        const auto target = to_tick(now);
+
+        std::size_t expired{};
+
+        while (m_current < target) {
+            m_current++;
+
+            const auto idx = static_cast<std::size_t>(m_current & (k_slots - 1));
+
+            if (idx == 0)
+                cascade(static_cast<std::size_t>((m_current >> k_slot_bits) & (k_slots - 1)));
+
+            // Detached first so that callbacks can re-arm or cancel entries safely
+            node_t batch{};
+
+            splice(m_slots[0][idx], batch);
+
+            while (!is_empty(batch)) {
+                auto& entry = static_cast<entry_t&>(*batch.m_next);
+
+                unlink(entry);
+
+                if (entry.m_expiry_tick > m_current) {
+                    place(entry);
+
+                    continue;
+                }
+
+                entry.m_wheel = nullptr;
+
+                entry.m_expired = true;
+
+                m_size--;
+
+                expired++;
+
+                if (entry.m_on_expire)
+                    entry.m_on_expire();
+            }
+        }
+
+        return expired;
+    }
+
+    std::uint64_t timer_wheel_t::to_tick(clock_t::time_point tp) const noexcept {
+        if (tp <= m_epoch)
+            return 0;
+
+        return static_cast<std::uint64_t>((tp - m_epoch) / m_tick);
+    }
+
+    void timer_wheel_t::place(entry_t& entry) noexcept {
+        entry.m_expiry_tick = std::max(entry.m_expiry_tick, m_current);
+
+        const auto delta = entry.m_expiry_tick - m_current;
+
+        if (delta < k_slots) {
+            link(m_slots[0][entry.m_expiry_tick & (k_slots - 1)], entry);
+
+            return;
+        }
+
+        // Deadlines beyond the wheel are parked in its last slot and re-placed on cascade
+        const auto tick = std::min(entry.m_expiry_tick, m_current + k_slots * k_slots - 1);
+
+        link(m_slots[1][(tick >> k_slot_bits) & (k_slots - 1)], entry);
+    }
+
+    void timer_wheel_t::cascade(std::size_t slot) noexcept {
+        node_t batch{};
+
+        splice(m_slots[1][slot], batch);
+
+        while (!is_empty(batch)) {
+            auto& entry = static_cast<entry_t&>(*batch.m_next);
+
+            unlink(entry);
+
+            place(entry);
+        }
+    }
+
+    void timer_wheel_t::disarm_all() noexcept {
+        for (auto& level : m_slots) {
+            for (auto& slot : level) {
+                while (!is_empty(slot)) {
+                    auto& entry = static_cast<entry_t&>(*slot.m_next);
+
+                    unlink(entry);
+
+                    entry.m_wheel = nullptr;
+                }
+            }
+        }
+
+        m_size = 0;
+    }
+
+    void timer_wheel_t::schedule() {
+        if (!m_running || m_ticking || m_size == 0)
+            return;
+
+        auto self = weak_from_this();
+
+        // Not owned by a shared pointer, so the handler could outlive the wheel
+        if (self.expired())
+            return;
+
+        m_ticking = true;
+
+        m_timer.expires_at(m_epoch + m_tick * (m_current + 1));
+
+        m_timer.async_wait([self = std::move(self)](const boost::system::error_code& ec) {
+            if (auto wheel = self.lock())
+                wheel->on_tick(ec);
+        });
+    }
+
+    void timer_wheel_t::on_tick(const boost::system::error_code& ec) {
+        m_ticking = false;
+
+        if (!m_running)
+            return;
+
+        if (ec != boost::asio::error::operation_aborted)
+            advance(clock_t::now());
+
+        schedule();
+    }
+} // namespace clueapi::shared
@@ -0,0 +1,339 @@
+/**
+ * @file timer_wheel.hxx
+ *
+ * @brief This file includes the `timer_wheel_t` struct, a coarse hierarchical timer wheel bound
+ * to a single boost::asio::io_context.
+ */
+
+#ifndef CLUEAPI_SHARED_TIMER_WHEEL_HXX
+#define CLUEAPI_SHARED_TIMER_WHEEL_HXX
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include "clueapi/shared/macros.hxx"
+
+namespace clueapi::shared {
+    /**
+     * @struct timer_wheel_t
+     *
+     * @brief A coarse hierarchical timer wheel that expires intrusive entries in batches.
+     *
+     * @details Deadlines are rounded up to whole ticks and stored in two levels of 256 slots, so
+     * arming and cancelling an entry are O(1) list operations and no per-entry asio timer is
+     * needed. A single `steady_timer` drives the wheel while it has armed entries; each tick
+     * expires the whole slot and cascades the upper level once per revolution. Deadlines beyond
+     * the range of the wheel are parked in its last slot and re-placed when it cascades.
+     *
+     * @note The wheel is not synchronized: all of its methods, including the destructor of armed
+     * entries, must run on the thread of its `io_context`. It must be owned by a `std::shared_ptr`
+     * for the tick handler to run.
+     */
+    struct timer_wheel_t : std::enable_shared_from_this<timer_wheel_t> {
+        /**
+         * @brief Type alias for the clock used by the wheel.
+         */
+        using clock_t = std::chrono::steady_clock;
+
+        /**
+         * @brief Type alias for the callback invoked when an entry expires.
+         */
+        using on_expire_t = std::function<void()>;
+
+        /**
+         * @brief The number of bits of a tick used to index a slot of one level.
+         */
+        static constexpr std::size_t k_slot_bits{8};
+
+        /**
+         * @brief The number of slots of one level.
+         */
+        static constexpr std::size_t k_slots{1ull << k_slot_bits};
+
+        /**
+         * @brief The number of levels of the wheel.
+         */
+        static constexpr std::size_t k_levels{2};
+
+        /**
+         * @brief The default tick of the wheel.
+         */
+        static constexpr std::chrono::milliseconds k_def_tick{100};
+
+        /**
+         * @struct node_t
+         *
+         * @brief A node of the intrusive slot lists.
+         */
+        struct node_t {
+            /**
+             * @brief The previous node of the list.
+             */
+            node_t* m_prev{};
+
+            /**
+             * @brief The next node of the list.
+             */
+            node_t* m_next{};
+        };
+
+        /**
+         * @struct entry_t
+         *
+         * @brief A deadline that can be armed on a wheel.
+         *
+         * @details The owner embeds an entry, sets `m_on_expire` once and then only re-arms it.
+         * The entry unlinks itself on destruction.
+         */
+        struct entry_t : node_t {
+            CLUEAPI_INLINE entry_t() = default;
+
+            CLUEAPI_INLINE ~entry_t() {
+                if (m_wheel)
+                    m_wheel->cancel(*this);
+            }
+
+            // Copy constructor
+            CLUEAPI_INLINE entry_t(const entry_t&) = delete;
+
+            // Copy assignment operator
+            CLUEAPI_INLINE entry_t& operator=(const entry_t&) = delete;
+
+            // Move constructor
+            CLUEAPI_INLINE entry_t(entry_t&&) = delete;
+
+            // Move assignment operator
+            CLUEAPI_INLINE entry_t& operator=(entry_t&&) = delete;
+
+           public:
+            /**
+             * @brief Checks if the entry is currently armed on a wheel.
+             *
+             * @return `true` if the entry is armed, `false` otherwise.
+             */
+            [[nodiscard]] CLUEAPI_INLINE bool is_armed() const noexcept {
+                return m_wheel != nullptr;
+            }
+
+            /**
+             * @brief Checks if the entry expired since it was last armed.
+             *
+             * @return `true` if the entry expired, `false` otherwise.
+             */
+            [[nodiscard]] CLUEAPI_INLINE bool is_expired() const noexcept {
+                return m_expired;
+            }
+
+           public:
+            /**
+             * @brief The callback invoked on the wheel's thread when the entry expires.
+             */
+            on_expire_t m_on_expire;
+
+           private:
+            friend struct timer_wheel_t;
+
+            /**
+             * @brief The wheel the entry is armed on, `nullptr` if it is not armed.
+             */
+            timer_wheel_t* m_wheel{};
+
+            /**
+             * @brief The tick at which the entry expires.
+             */
+            std::uint64_t m_expiry_tick{};
+
+            /**
+             * @brief If true, the entry expired since it was last armed.
+             */
+            bool m_expired{false};
+        };
+
+       public:
+        /**
+         * @brief Constructs a stopped wheel bound to an `io_context`.
+         *
+         * @param io_ctx The `io_context` that drives the wheel.
+         * @param tick The resolution of the wheel.
+         */
+        explicit timer_wheel_t(
+            boost::asio::io_context& io_ctx, std::chrono::milliseconds tick = k_def_tick);
+
+        /**
+         * @brief Disarms all entries and destroys the wheel.
+         */
+        ~timer_wheel_t();
+
+        // Copy constructor
+        CLUEAPI_INLINE timer_wheel_t(const timer_wheel_t&) = delete;
+
+        // Copy assignment operator
+        CLUEAPI_INLINE timer_wheel_t& operator=(const timer_wheel_t&) = delete;
+
+        // Move constructor
+        CLUEAPI_INLINE timer_wheel_t(timer_wheel_t&&) = delete;
+
+        // Move assignment operator
+        CLUEAPI_INLINE timer_wheel_t& operator=(timer_wheel_t&&) = delete;
+
+       public:
+        /**
+         * @brief Starts the wheel. Entries can only be armed on a running wheel.
+         */
+        void start();
+
+        /**
+         * @brief Stops the wheel and disarms all entries without expiring them.
+         */
+        void stop();
+
+        /**
+         * @brief Arms an entry, or re-arms it if it is already armed.
+         *
+         * @param entry The entry to arm.
+         * @param deadline The deadline, rounded up to the next tick.
+         *
+         * @note Does nothing if the wheel is not running.
+         */
+        void arm(entry_t& entry, clock_t::time_point deadline);
+
+        /**
+         * @brief Arms an entry relative to the current time.
+         *
+         * @param entry The entry to arm.
+         * @param timeout The time after which the entry expires.
+         */
+        template <typename _rep_t, typename _period_t>
+        CLUEAPI_INLINE void arm_after(
+            entry_t& entry, std::chrono::duration<_rep_t, _period_t> timeout) {
+            arm(entry, clock_t::now() + timeout);
+        }
+
+        /**
+         * @brief Disarms an entry without expiring it.
+         *
+         * @param entry The entry to disarm.
+         */
+        void cancel(entry_t& entry) noexcept;
+
+        /**
+         * @brief Advances the wheel up to a point in time, expiring the due entries.
+         *
+         * @param now The point in time to advance to.
+         *
+         * @return The number of expired entries.
+         *
+         * @note Called by the tick handler; exposed for callers that drive the wheel manually.
+         */
+        std::size_t advance(clock_t::time_point now);
+
+       public:
+        /**
+         * @brief Gets the number of armed entries.
+         *
+         * @return The number of armed entries.
+         */
+        [[nodiscard]] CLUEAPI_INLINE std::size_t size() const noexcept {
+            return m_size;
+        }
+
+        /**
+         * @brief Gets the resolution of the wheel.
+         *
+         * @return The tick of the wheel.
+         */
+        [[nodiscard]] CLUEAPI_INLINE std::chrono::milliseconds tick() const noexcept {
+            return m_tick;
+        }
+
+        /**
+         * @brief Checks if the wheel is running.
+         *
+         * @return `true` if the wheel is running, `false` otherwise.
+         */
+        [[nodiscard]] CLUEAPI_INLINE bool is_running() const noexcept {
+            return m_running;
+        }
+
+       private:
+        /**
+         * @brief Converts a point in time to a tick, rounding down.
+         */
+        [[nodiscard]] std::uint64_t to_tick(clock_t::time_point tp) const noexcept;
+
+        /**
+         * @brief Links an entry into the slot matching its expiry tick.
+         */
+        void place(entry_t& entry) noexcept;
+
+        /**
+         * @brief Moves the entries of an upper level slot down the wheel.
+         */
+        void cascade(std::size_t slot) noexcept;
+
+        /**
+         * @brief Disarms all entries.
+         */
+        void disarm_all() noexcept;
+
+        /**
+         * @brief Arms the tick timer if the wheel has armed entries.
+         */
+        void schedule();
+
+        /**
+         * @brief Handles a tick of the timer.
+         */
+        void on_tick(const boost::system::error_code& ec);
+
+       private:
+        /**
+         * @brief The timer driving the wheel.
+         */
+        boost::asio::steady_timer m_timer;
+
+        /**
+         * @brief The resolution of the wheel.
+         */
+        std::chrono::milliseconds m_tick;
+
+        /**
+         * @brief The point in time of tick zero.
+         */
+        clock_t::time_point m_epoch;
+
+        /**
+         * @brief The last processed tick.
+         */
+        std::uint64_t m_current{0};
+
+        /**
+         * @brief The number of armed entries.
+         */
+        std::size_t m_size{0};
+
+        /**
+         * @brief If true, entries can be armed.
+         */
+        bool m_running{false};
+
+        /**
+         * @brief If true, the tick timer is armed.
+         */
+        bool m_ticking{false};
+
+        /**
+         * @brief The sentinels of the slot lists, per level.
+         */
+        std::array<std::array<node_t, k_slots>, k_levels> m_slots{};
+    };
+} // namespace clueapi::shared
+
+#endif // CLUEAPI_SHARED_TIMER_WHEEL_HXX
@@ -0,0 +1,259 @@
+/**
+ * @file tracing.cxx
+ *
+ * @brief This file implements the types of the request tracing.
+ */
+
+#include "clueapi/shared/tracing/tracing.hxx"
+
+#include <algorithm>
+#include <mutex>
+#include <random>
+#include <thread>
+
+namespace clueapi::shared {
+    namespace {
+        /**
+         * @struct calibration_t
+         *
+         * @brief The rate of the clock and a reading of it at a known time.
+         */
+        struct calibration_t {
+            double m_ns_per_tick{1.0};
+
+            std::uint64_t m_ticks{};
+
+            std::int64_t m_unix_ns{};
+        };
+
+        calibration_t g_calibration{};
+
+        std::once_flag g_calibrated{};
+
+        /**
+         * @brief Gets the time since the Unix epoch, in nanoseconds.
+         */
+        std::int64_t unix_now() noexcept {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::system_clock::now().time_since_epoch())
+                .count();
+        }
+
+        /**
+         * @brief Gets the next number of a per-thread generator, seeded at random.
+         */
+        std::uint64_t next_random() noexcept {
+            thread_local std::uint64_t state = []() noexcept {
+                std::uint64_t seed{};
+
+                try {
+                    std::random_device device{};
+
+                    seed = (static_cast<std::uint64_t>(device()) << 32u) ^ device();
+                } catch (...) {
+                    // ...
+                }
+
+                return seed ^ std::hash<std::thread::id>{}(std::this_thread::get_id()) ^
+                       trace_clock_t::now();
+            }();
+
+            // splitmix64, every state gives a number
+            auto ret = (state += 0x9e3779b97f4a7c15u);
+
+            ret = (ret ^ (ret >> 30u)) * 0xbf58476d1ce4e5b9u;
+            ret = (ret ^ (ret >> 27u)) * 0x94d049bb133111ebu;
+
+            return ret ^ (ret >> 31u);
+        }
+
+        /**
+         * @brief Fills an id with random bytes, never all zero.
+         */
+        template <std::size_t _size>
+        void fill_random(std::array<std::uint8_t, _size>& id) noexcept {
+            for (std::size_t i{}; i < _size; i += 8u) {
+                const auto value = next_random();
+
+                for (std::size_t j{}; j < 8u && i + j < _size; j++)
+                    id[i + j] = static_cast<std::uint8_t>(value >> (j * 8u));
+            }
+
+            if (std::all_of(id.begin(), id.end(), [](auto byte) { return byte == 0u; }))
+                id[_size - 1u] = 1u;
+        }
+
+        /**
+         * @brief Gets the value of a lowercase hex digit.
+         *
+         * @return The value, `-1` for another character.
+         */
+        int hex_value(char c) noexcept {
+            if (c >= '0' && c <= '9')
+                return c - '0';
+
+            if (c >= 'a' && c <= 'f')
+                return c - 'a' + 10;
+
+            return -1;
+        }
+
+        /**
+         * @brief Parses lowercase hex digits into bytes.
+         *
+         * @return `true` if every character is a digit, `false` otherwise.
+         */
+        template <std::size_t _size>
+        bool parse_hex(std::string_view hex, std::array<std::uint8_t, _size>& out) noexcept {
+            for (std::size_t i{}; i < _size; i++) {
+                const auto high = hex_value(hex[i * 2u]);
+
+                const auto low = hex_value(hex[i * 2u + 1u]);
+
+                if (high < 0 || low < 0)
+                    return false;
+
+                out[i] = static_cast<std::uint8_t>((high << 4) | low);
+            }
+
+            return true;
+        }
+
+        /**
+         * @brief Appends bytes as lowercase hex digits.
+         */
+        template <std::size_t _size>
+        void append_hex(std::string& out, const std::array<std::uint8_t, _size>& bytes) {
+            constexpr std::string_view k_digits{"0123456789abcdef"};
+
+            for (const auto byte : bytes) {
+                out.push_back(k_digits[byte >> 4u]);
+
+                out.push_back(k_digits[byte & 0x0fu]);
+            }
+        }
+    } // namespace
+
+    void trace_clock_t::calibrate() {
+        std::call_once(g_calibrated, []() {
+#ifdef CLUEAPI_TRACE_CLOCK_TSC
+            const auto steady_start = std::chrono::steady_clock::now();
+
+            const auto ticks_start = now();
+
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+
+            const auto steady_end = std::chrono::steady_clock::now();
+
+            const auto ticks_end = now();
+
+            const auto elapsed_ns =
+                std::chrono::duration_cast<std::chrono::nanoseconds>(steady_end - steady_start)
+                    .count();
+
+            if (ticks_end > ticks_start && elapsed_ns > 0)
+                g_calibration.m_ns_per_tick =
+                    static_cast<double>(elapsed_ns) / static_cast<double>(ticks_end - ticks_start);
+#endif // CLUEAPI_TRACE_CLOCK_TSC
+
+            g_calibration.m_unix_ns = unix_now();
+
+            g_calibration.m_ticks = now();
+        });
+    }
+
+    std::uint64_t trace_clock_t::to_ns(std::uint64_t ticks) noexcept {
+        return static_cast<std::uint64_t>(
+            static_cast<double>(ticks) * g_calibration.m_ns_per_tick);
+    }
+
+    std::int64_t trace_clock_t::to_unix_ns(std::uint64_t ticks) noexcept {
+        const auto delta = static_cast<double>(static_cast<std::int64_t>(
+                               ticks - g_calibration.m_ticks)) *
+                           g_calibration.m_ns_per_tick;
+
+        return g_calibration.m_unix_ns + static_cast<std::int64_t>(delta);
+    }
+
+    std::optional<trace_context_t> trace_context_t::parse(std::string_view value) noexcept {
+        while (!value.empty() && (value.front() == ' ' || value.front() == '\t'))
+            value.remove_prefix(1u);
+
+        while (!value.empty() && (value.back() == ' ' || value.back() == '\t'))
+            value.remove_suffix(1u);
+
+        if (value.size() < k_traceparent_size)
+            return std::nullopt;
+
+        std::array<std::uint8_t, 1> version{};
+
+        if (!parse_hex(value.substr(0u, 2u), version) || version[0] == 0xffu)
+            return std::nullopt;
+
+        if (version[0] == 0u && value.size() != k_traceparent_size)
+            return std::nullopt;
+
+        // A later version may only append fields, after a dash
+        if (value.size() > k_traceparent_size && value[k_traceparent_size] != '-')
+            return std::nullopt;
+
+        if (value[2] != '-' || value[35] != '-' || value[52] != '-')
+            return std::nullopt;
+
+        trace_context_t ret{};
+
+        std::array<std::uint8_t, 1> flags{};
+
+        if (!parse_hex(value.substr(3u, 32u), ret.m_trace_id) ||
+            !parse_hex(value.substr(36u, 16u), ret.m_span_id) ||
+            !parse_hex(value.substr(53u, 2u), flags))
+            return std::nullopt;
+
+        const auto is_zero = [](const auto& id) {
+            return std::all_of(id.begin(), id.end(), [](auto byte) { return byte == 0u; });
+        };
+
+        if (is_zero(ret.m_trace_id) || is_zero(ret.m_span_id))
+            return std::nullopt;
+
+        ret.m_flags = flags[0];
+
+        return ret;
+    }
+
+    trace_context_t::trace_id_t trace_context_t::make_trace_id() noexcept {
+        trace_id_t ret{};
+
+        fill_random(ret);
+
+        return ret;
+    }
+
+    trace_context_t::span_id_t trace_context_t::make_span_id() noexcept {
+        span_id_t ret{};
+
+        fill_random(ret);
+
+        return ret;
+    }
+
+    std::string trace_context_t::traceparent() const {
+        std::string ret{};
+
+        ret.reserve(k_traceparent_size);
+
+        ret.append("00-");
+
+        append_hex(ret, m_trace_id);
+
+        ret.push_back('-');
+
+        append_hex(ret, m_span_id);
+
+        ret.push_back('-');
+
+        append_hex(ret, std::array<std::uint8_t, 1>{m_flags});
+
+        return ret;
+    }
+} // namespace clueapi::shared
@@ -0,0 +1,481 @@
+/**
+ * @file tracing.hxx
+ *
+ * @brief This file includes the types of the request tracing: the clock of the phases, the W3C
+ * trace context, the trace of a request and the sink the sampled traces are exported to.
+ */
+
+#ifndef CLUEAPI_SHARED_TRACING_HXX
+#define CLUEAPI_SHARED_TRACING_HXX
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(_M_X64)) && !defined(CLUEAPI_TRACE_CLOCK_STEADY)
+#define CLUEAPI_TRACE_CLOCK_TSC
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif // _MSC_VER
+#endif // __x86_64__ || _M_X64
+
+#include "clueapi/shared/macros.hxx"
+
+namespace clueapi::shared {
+    /**
+     * @struct trace_clock_t
+     *
+     * @brief The monotonic clock of the traces, read in a few cycles.
+     *
+     * @details On x86-64 the ticks are read from the time stamp counter, which is invariant on
+     * every CPU of the last decade, and converted to nanoseconds with the rate measured by
+     * `calibrate()`. Elsewhere, or with `CLUEAPI_TRACE_CLOCK_STEADY`, the ticks are the
+     * nanoseconds of `std::chrono::steady_clock`.
+     */
+    struct trace_clock_t {
+        /**
+         * @brief Reads the clock.
+         *
+         * @return The ticks, only meaningful relative to each other.
+         */
+        [[nodiscard]] static CLUEAPI_INLINE std::uint64_t now() noexcept {
+#ifdef CLUEAPI_TRACE_CLOCK_TSC
+            return __rdtsc();
+#else
+            return static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch())
+                    .count());
+#endif // CLUEAPI_TRACE_CLOCK_TSC
+        }
+
+        /**
+         * @brief Measures the rate of the ticks and anchors them to the system clock.
+         *
+         * @details Takes about a millisecond, once per process, later calls return at once.
+         */
+        static void calibrate();
+
+        /**
+         * @brief Converts a number of ticks to nanoseconds.
+         *
+         * @param ticks The ticks between two readings.
+         */
+        [[nodiscard]] static std::uint64_t to_ns(std::uint64_t ticks) noexcept;
+
+        /**
+         * @brief Converts a reading to the time since the Unix epoch.
+         *
+         * @param ticks The reading.
+         *
+         * @return The time in nanoseconds, as of the calibration.
+         */
+        [[nodiscard]] static std::int64_t to_unix_ns(std::uint64_t ticks) noexcept;
+    };
+
+    /**
+     * @struct trace_context_t
+     *
+     * @brief The trace context of the W3C Trace Context `traceparent` header.
+     */
+    struct trace_context_t {
+        /**
+         * @brief The size of a `traceparent` value of version `00`.
+         */
+        static constexpr std::size_t k_traceparent_size{55u};
+
+        /**
+         * @brief The flag of a trace chosen to be recorded.
+         */
+        static constexpr std::uint8_t k_sampled{0x01u};
+
+        /**
+         * @brief Type alias for a trace id.
+         */
+        using trace_id_t = std::array<std::uint8_t, 16>;
+
+        /**
+         * @brief Type alias for a span id.
+         */
+        using span_id_t = std::array<std::uint8_t, 8>;
+
+       public:
+        /**
+         * @brief Parses a `traceparent` header.
+         *
+         * @param value The value of the header.
+         *
+         * @return The context, `std::nullopt` if the value is malformed or its ids are zero.
+         *
+         * @details A version above `00` is accepted as long as it starts like version `00`, as
+         * the specification asks.
+         */
+        [[nodiscard]] static std::optional<trace_context_t> parse(std::string_view value) noexcept;
+
+        /**
+         * @brief Makes a random trace id.
+         */
+        [[nodiscard]] static trace_id_t make_trace_id() noexcept;
+
+        /**
+         * @brief Makes a random span id.
+         */
+        [[nodiscard]] static span_id_t make_span_id() noexcept;
+
+        /**
+         * @brief Formats the context as a `traceparent` value of version `00`.
+         */
+        [[nodiscard]] std::string traceparent() const;
+
+        /**
+         * @brief Checks if the trace is chosen to be recorded.
+         */
+        [[nodiscard]] CLUEAPI_INLINE bool is_sampled() const noexcept {
+            return (m_flags & k_sampled) != 0u;
+        }
+
+       public:
+        trace_id_t m_trace_id{};
+
+        /**
+         * @brief The id of the span, for a received header the one of the caller.
+         */
+        span_id_t m_span_id{};
+
+        std::uint8_t m_flags{};
+    };
+
+    /**
+     * @struct trace_phase_t
+     *
+     * @brief The phases of a request that are timed.
+     */
+    struct trace_phase_t {
+        /**
+         * @enum e_phase
+         *
+         * @brief A scoped enumeration of the timed phases.
+         */
+        enum e_phase : std::uint8_t {
+            /**
+             * @brief Reading the request line and the headers, from their first byte.
+             */
+            read_header,
+
+            /**
+             * @brief Reading a buffered body.
+             */
+            read_body,
+
+            /**
+             * @brief Parsing a multipart body, read meanwhile if it is streamed.
+             */
+            parse,
+
+            /**
+             * @brief A middleware, the next ones and the handler included.
+             */
+            middleware,
+
+            /**
+             * @brief The route handler.
+             */
+            handler,
+
+            /**
+             * @brief Writing the response, or queueing it behind the pipelined ones.
+             */
+            write,
+
+            count
+        };
+
+        /**
+         * @brief Converts an `e_phase` enum value to its name, e.g. `"read_header"`.
+         *
+         * @param phase The enum value to convert.
+         *
+         * @return The name, `"unknown"` if the phase is not recognized.
+         */
+        CLUEAPI_INLINE static constexpr std::string_view to_str(e_phase phase) noexcept {
+            return phase < k_phase_names.size() ? k_phase_names[phase] : "unknown";
+        }
+
+       private:
+        /**
+         * @brief The names of the phases, in the order of `e_phase`.
+         */
+        static constexpr std::array<std::string_view, count> k_phase_names{
+            "read_header", "read_body", "parse", "middleware", "handler", "write"};
+    };
+
+    /**
+     * @struct trace_t
+     *
+     * @brief The trace of a request while it is served.
+     *
+     * @details Kept by the connection and reused for each of its requests, so recording never
+     * allocates. A phase is a pair of clock readings, spans past `k_max_spans` aren't recorded.
+     *
+     * @note Only touched by the thread of the connection.
+     */
+    struct trace_t {
+        /**
+         * @brief The maximum number of spans recorded for a request.
+         */
+        static constexpr std::size_t k_max_spans{32u};
+
+        /**
+         * @brief The slot of a span that wasn't recorded.
+         */
+        static constexpr std::size_t k_no_span{k_max_spans};
+
+        /**
+         * @struct span_t
+         *
+         * @brief The timing of a phase, in clock ticks.
+         */
+        struct span_t {
+            trace_phase_t::e_phase m_phase{};
+
+            /**
+             * @brief The position of the middleware in the chain, `0` for the other phases.
+             */
+            std::uint16_t m_index{};
+
+            std::uint64_t m_start{};
+
+            /**
+             * @brief The end of the phase, `0` while it runs.
+             */
+            std::uint64_t m_end{};
+        };
+
+        /**
+         * @struct scope_t
+         *
+         * @brief Times a phase for as long as it lives.
+         */
+        struct scope_t {
+            /**
+             * @brief Starts a phase.
+             *
+             * @param trace The trace, `nullptr` to time nothing.
+             * @param phase The phase.
+             * @param index The position of the middleware in the chain.
+             */
+            CLUEAPI_INLINE scope_t(
+                trace_t* trace, trace_phase_t::e_phase phase, std::size_t index = 0u) noexcept
+                : m_trace{trace} {
+                if (m_trace)
+                    m_slot = m_trace->open(phase, index);
+            }
+
+            CLUEAPI_INLINE ~scope_t() noexcept {
+                if (m_trace)
+                    m_trace->close(m_slot);
+            }
+
+            // Copy constructor
+            CLUEAPI_INLINE scope_t(const scope_t&) = delete;
+
+            // Copy assignment operator
+            CLUEAPI_INLINE scope_t& operator=(const scope_t&) = delete;
+
+           private:
+            trace_t* m_trace;
+
+            std::size_t m_slot{k_no_span};
+        };
+
+       public:
+        /**
+         * @brief Starts the trace of a new request.
+         *
+         * @param start The reading of the clock the request starts at.
+         */
+        CLUEAPI_INLINE void reset(std::uint64_t start) noexcept {
+            m_context = trace_context_t{};
+
+            m_parent_span_id = trace_context_t::span_id_t{};
+
+            m_start = start;
+
+            m_end = 0u;
+
+            m_size = 0u;
+        }
+
+        /**
+         * @brief Starts a phase.
+         *
+         * @param phase The phase.
+         * @param index The position of the middleware in the chain.
+         *
+         * @return The slot of the span, `k_no_span` once `k_max_spans` are recorded.
+         */
+        CLUEAPI_INLINE std::size_t open(
+            trace_phase_t::e_phase phase, std::size_t index = 0u) noexcept {
+            if (m_size == k_max_spans)
+                return k_no_span;
+
+            m_spans[m_size] = span_t{
+                .m_phase = phase,
+                .m_index = static_cast<std::uint16_t>(index),
+                .m_start = trace_clock_t::now()};
+
+            return m_size++;
+        }
+
+        /**
+         * @brief Ends a phase.
+         *
+         * @param slot The slot `open()` returned.
+         */
+        CLUEAPI_INLINE void close(std::size_t slot) noexcept {
+            if (slot < m_size)
+                m_spans[slot].m_end = trace_clock_t::now();
+        }
+
+        /**
+         * @brief Gets the recorded spans, in the order they started.
+         */
+        [[nodiscard]] CLUEAPI_INLINE std::span<const span_t> spans() const noexcept {
+            return {m_spans.data(), m_size};
+        }
+
+        /**
+         * @brief Gets the context of the span of the server.
+         *
+         * @details Its trace id is the caller's if the request had a valid `traceparent`, so a
+         * handler propagates it to its own calls with `context().traceparent()`.
+         */
+        [[nodiscard]] CLUEAPI_INLINE const trace_context_t& context() const noexcept {
+            return m_context;
+        }
+
+       public:
+        /**
+         * @brief The context of the span of the server.
+         */
+        trace_context_t m_context{};
+
+        /**
+         * @brief The span id of the caller, zero without a `traceparent`.
+         */
+        trace_context_t::span_id_t m_parent_span_id{};
+
+        /**
+         * @brief The reading of the clock the request started at.
+         */
+        std::uint64_t m_start{};
+
+        /**
+         * @brief The reading of the clock the response was sent at.
+         */
+        std::uint64_t m_end{};
+
+       private:
+        std::array<span_t, k_max_spans> m_spans{};
+
+        std::size_t m_size{};
+    };
+
+    /**
+     * @struct trace_record_t
+     *
+     * @brief The trace of a served request, as exported.
+     *
+     * @details The spans of the phases are children of the span of the server. They nest in
+     * time: a middleware contains the next ones, the parse and the handler.
+     */
+    struct trace_record_t {
+        /**
+         * @struct span_t
+         *
+         * @brief The span of a phase.
+         */
+        struct span_t {
+            trace_phase_t::e_phase m_phase{};
+
+            /**
+             * @brief The position of the middleware in the chain, `0` for the other phases.
+             */
+            std::uint16_t m_index{};
+
+            /**
+             * @brief A random span id, for the sinks that need one per span.
+             */
+            trace_context_t::span_id_t m_span_id{};
+
+            /**
+             * @brief The start of the phase, in nanoseconds since the Unix epoch.
+             */
+            std::int64_t m_start{};
+
+            /**
+             * @brief The end of the phase, in nanoseconds since the Unix epoch.
+             */
+            std::int64_t m_end{};
+        };
+
+        /**
+         * @brief The context of the span of the server.
+         */
+        trace_context_t m_context{};
+
+        /**
+         * @brief The span id of the caller, zero without a `traceparent`.
+         */
+        trace_context_t::span_id_t m_parent_span_id{};
+
+        std::string m_method;
+
+        std::string m_target;
+
+        std::uint16_t m_status{};
+
+        /**
+         * @brief The start of the request, in nanoseconds since the Unix epoch.
+         */
+        std::int64_t m_start{};
+
+        /**
+         * @brief The end of the response, in nanoseconds since the Unix epoch.
+         */
+        std::int64_t m_end{};
+
+        std::vector<span_t> m_spans;
+    };
+
+    /**
+     * @struct trace_sink_t
+     *
+     * @brief Receives the sampled traces, e.g. to send them to an OpenTelemetry collector.
+     */
+    struct trace_sink_t {
+        CLUEAPI_INLINE virtual ~trace_sink_t() noexcept = default;
+
+       public:
+        /**
+         * @brief Exports a batch of traces.
+         *
+         * @param records The traces, valid for the duration of the call.
+         *
+         * @note Called from the thread of the tracer only, never from a worker. An exception is
+         * logged and the batch is dropped.
+         */
+        virtual void write(std::span<const trace_record_t> records) = 0;
+    };
+} // namespace clueapi::shared
+
+#endif // CLUEAPI_SHARED_TRACING_HXX
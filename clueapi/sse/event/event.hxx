@@ -0,0 +1,90 @@
+/**
+ * @file event.hxx
+ *
+ * @brief Defines the encoding of Server-Sent Events (the `text/event-stream` format).
+ */
+
+#ifndef CLUEAPI_SSE_EVENT_HXX
+#define CLUEAPI_SSE_EVENT_HXX
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "clueapi/shared/macros.hxx"
+
+namespace clueapi::sse {
+    /**
+     * @brief Type alias for an encoded event, shared as is by every stream it is sent to.
+     */
+    using shared_event_t = std::shared_ptr<const std::string>;
+
+    /**
+     * @struct event_t
+     *
+     * @brief An event sent on a stream.
+     */
+    struct event_t {
+        /**
+         * @brief The data of the event, split into a `data:` field per line.
+         */
+        std::string_view m_data{};
+
+        /**
+         * @brief The type of the event, empty for the default `message`.
+         */
+        std::string_view m_event{};
+
+        /**
+         * @brief The identifier of the event, that a reconnecting client sends back as
+         * `Last-Event-ID`.
+         */
+        std::optional<std::uint64_t> m_id{};
+
+        /**
+         * @brief The reconnection delay the client is told to use, zero to leave it out.
+         */
+        std::chrono::milliseconds m_retry{};
+    };
+
+    /**
+     * @brief A comment that keeps an idle stream (and the proxies in between) from timing out.
+     */
+    inline constexpr std::string_view k_heartbeat{":\n\n"};
+
+    /**
+     * @brief Encodes an event.
+     *
+     * @param event The event.
+     *
+     * @return The event, its fields and the blank line that ends it.
+     *
+     * @note A line break in the type is dropped, as it would end the field early.
+     */
+    [[nodiscard]] std::string encode(const event_t& event);
+
+    /**
+     * @brief Encodes an event into a buffer shared by every stream it is sent to.
+     *
+     * @param event The event.
+     *
+     * @return The encoded event.
+     */
+    [[nodiscard]] CLUEAPI_INLINE shared_event_t make_event(const event_t& event) {
+        return std::make_shared<const std::string>(encode(event));
+    }
+
+    /**
+     * @brief Parses the value of a `Last-Event-ID` header.
+     *
+     * @param value The value of the header.
+     *
+     * @return The identifier, or `std::nullopt` if it isn't one set by the server.
+     */
+    [[nodiscard]] std::optional<std::uint64_t> parse_last_event_id(std::string_view value) noexcept;
+} // namespace clueapi::sse
+
+#endif // CLUEAPI_SSE_EVENT_HXX
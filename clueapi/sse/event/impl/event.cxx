@@ -0,0 +1,67 @@
+/**
+ * @file event.cxx
+ *
+ * @brief Implements the encoding of Server-Sent Events.
+ */
+
+#include "clueapi/sse/event/event.hxx"
+
+#include <charconv>
+
+#include <fmt/format.h>
+
+namespace clueapi::sse {
+    std::string encode(const event_t& event) {
+        std::string ret{};
+
+        ret.reserve(event.m_data.size() + event.m_event.size() + 48u);
+
+        if (event.m_id.has_value())
+            fmt::format_to(std::back_inserter(ret), "id: {}\n", *event.m_id);
+
+        if (!event.m_event.empty()) {
+            ret.append("event: ");
+
+            for (const auto c : event.m_event)
+                if (c != '\n' && c != '\r')
+                    ret.push_back(c);
+
+            ret.push_back('\n');
+        }
+
+        if (event.m_retry.count() > 0)
+            fmt::format_to(std::back_inserter(ret), "retry: {}\n", event.m_retry.count());
+
+        // A line of the data ends at LF, CR or CRLF, each one becomes a field
+        auto data = event.m_data;
+
+        do {
+            const auto end = data.find_first_of("\r\n");
+
+            ret.append("data: ").append(data.substr(0, end)).push_back('\n');
+
+            if (end == std::string_view::npos)
+                break;
+
+            const auto is_crlf =
+                data[end] == '\r' && end + 1 < data.size() && data[end + 1] == '\n';
+
+            data.remove_prefix(end + (is_crlf ? 2u : 1u));
+        } while (true);
+
+        ret.push_back('\n');
+
+        return ret;
+    }
+
+    std::optional<std::uint64_t> parse_last_event_id(std::string_view value) noexcept {
+        std::uint64_t ret{};
+
+        const auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), ret);
+
+        if (ec != std::errc{} || ptr != value.data() + value.size() || value.empty())
+            return std::nullopt;
+
+        return ret;
+    }
+} // namespace clueapi::sse
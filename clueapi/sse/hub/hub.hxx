@@ -0,0 +1,177 @@
+/**
+ * @file hub.hxx
+ *
+ * @brief Defines a hub that fans events out to the Server-Sent Events streams of a topic.
+ */
+
+#ifndef CLUEAPI_SSE_HUB_HXX
+#define CLUEAPI_SSE_HUB_HXX
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "clueapi/http/types/request/request.hxx"
+#include "clueapi/http/types/response/response.hxx"
+
+#include "clueapi/shared/json_writer/json_writer.hxx"
+#include "clueapi/shared/macros.hxx"
+
+#include "clueapi/sse/event/event.hxx"
+
+namespace clueapi::sse {
+    /**
+     * @struct hub_cfg_t
+     *
+     * @brief The settings of a hub.
+     */
+    struct hub_cfg_t {
+        /**
+         * @brief The number of the last events of a topic kept to replay to a client that
+         * reconnects with `Last-Event-ID`. Zero disables the replay.
+         */
+        std::size_t m_replay_size{256u};
+
+        /**
+         * @brief The maximum number of events queued for a stream.
+         *
+         * @details A stream that doesn't write fast enough to stay below the limit is ended
+         * instead of buffering without bound. Its client reconnects, and catches up from the
+         * replay buffer.
+         */
+        std::size_t m_max_queued_events{64u};
+
+        /**
+         * @brief The interval of the heartbeat comment sent to the idle streams. Zero disables
+         * the heartbeat.
+         */
+        std::chrono::milliseconds m_heartbeat_interval{std::chrono::seconds{15}};
+
+        /**
+         * @brief The reconnection delay sent at the start of a stream, zero to leave it to the
+         * client.
+         */
+        std::chrono::milliseconds m_retry{};
+    };
+
+    /**
+     * @class c_hub
+     *
+     * @brief Publishes events to the streams subscribed to a topic.
+     *
+     * @details An event is encoded once per publish, into a buffer that is shared by every
+     * subscriber: one task is posted to each I/O context that has subscribers, and queues the
+     * event to its streams without any lock or copy. Each stream then sends it as a single chunk.
+     * The streams of an I/O context are only touched on it, and share one heartbeat timer.
+     *
+     * Every event gets an increasing identifier. The last `hub_cfg_t::m_replay_size` events of a
+     * topic are kept, so a client that reconnects with `Last-Event-ID` first receives the events
+     * it missed.
+     *
+     * @note The hub must outlive the streams it serves. `publish()` is thread-safe.
+     */
+    class c_hub {
+       public:
+        /**
+         * @brief Constructs a hub.
+         *
+         * @param cfg The settings of the hub.
+         */
+        explicit c_hub(hub_cfg_t cfg = {});
+
+        ~c_hub() noexcept;
+
+        // Copy constructor
+        CLUEAPI_INLINE c_hub(const c_hub&) = delete;
+
+        // Copy assignment operator
+        CLUEAPI_INLINE c_hub& operator=(const c_hub&) = delete;
+
+       public:
+        /**
+         * @brief Makes the response that streams the events of a topic.
+         *
+         * @param topic The topic.
+         * @param last_event_id The identifier of the last event the client received, if any.
+         *
+         * @return A `text/event-stream` response, that subscribes once it starts streaming.
+         */
+        [[nodiscard]] http::types::response_t subscribe(
+            std::string_view topic, std::optional<std::uint64_t> last_event_id = std::nullopt);
+
+        /**
+         * @brief Makes the response that streams the events of a topic, resuming after the
+         * `Last-Event-ID` of the request.
+         *
+         * @param topic The topic.
+         * @param request The request of the client.
+         *
+         * @return A `text/event-stream` response, that subscribes once it starts streaming.
+         */
+        [[nodiscard]] CLUEAPI_INLINE http::types::response_t subscribe(
+            std::string_view topic, const http::types::request_t& request) {
+            const auto last_event_id = request.header("Last-Event-ID");
+
+            return subscribe(
+                topic,
+                last_event_id.has_value() ? parse_last_event_id(*last_event_id) : std::nullopt);
+        }
+
+        /**
+         * @brief Publishes an event to the subscribers of a topic.
+         *
+         * @param topic The topic.
+         * @param data The data of the event.
+         * @param event The type of the event, empty for the default `message`.
+         *
+         * @return The identifier of the event.
+         */
+        std::uint64_t publish(
+            std::string_view topic, std::string_view data, std::string_view event = {});
+
+        /**
+         * @brief Publishes a value as the JSON data of an event.
+         *
+         * @param topic The topic.
+         * @param value The value, serialized by `shared::json_writer_t`.
+         * @param event The type of the event, empty for the default `message`.
+         *
+         * @return The identifier of the event.
+         */
+        template <typename _type_t>
+        CLUEAPI_INLINE std::uint64_t publish_json(
+            std::string_view topic, const _type_t& value, std::string_view event = {}) {
+            return publish(topic, shared::json_writer_t::to_string(value), event);
+        }
+
+        /**
+         * @brief Gets the number of subscriptions, across all topics and I/O contexts.
+         *
+         * @return The number of streams subscribed.
+         */
+        [[nodiscard]] std::size_t subscriptions() const noexcept;
+
+       private:
+        /**
+         * @class c_impl
+         *
+         * @brief The internal implementation of the `c_hub` class.
+         *
+         * @internal
+         */
+        class c_impl;
+
+        /**
+         * @brief The internal implementation of the `c_hub` class.
+         *
+         * @internal
+         */
+        std::unique_ptr<c_impl> m_impl;
+    };
+} // namespace clueapi::sse
+
+#endif // CLUEAPI_SSE_HUB_HXX
@@ -0,0 +1,443 @@
+/**
+ * @file hub.cxx
+ *
+ * @brief Implements the Server-Sent Events hub.
+ */
+
+#include "clueapi/sse/hub/hub.hxx"
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <utility>
+#include <vector>
+
+#include <boost/asio/any_io_executor.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/redirect_error.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/this_coro.hpp>
+#include <boost/asio/use_awaitable.hpp>
+
+#include <fmt/format.h>
+
+#include "clueapi/http/chunks/chunks.hxx"
+#include "clueapi/http/detail/sv_hash/sv_hash.hxx"
+
+#include "clueapi/modules/macros.hxx"
+
+#include "clueapi/shared/shared.hxx"
+
+namespace clueapi::sse {
+    class c_hub::c_impl {
+       public:
+        /**
+         * @struct queued_t
+         *
+         * @brief An event queued for a stream, or kept for the replay.
+         */
+        struct queued_t {
+            std::uint64_t m_id{};
+
+            shared_event_t m_event;
+        };
+
+        /**
+         * @struct subscriber_t
+         *
+         * @brief A stream subscribed to a topic, only touched on its I/O context.
+         */
+        struct subscriber_t {
+            CLUEAPI_INLINE explicit subscriber_t(const boost::asio::any_io_executor& executor)
+                : m_signal{executor} {
+            }
+
+            /**
+             * @brief Wakes the stream, if it waits for events.
+             */
+            CLUEAPI_INLINE void wake() noexcept {
+                m_signal.cancel();
+            }
+
+            std::deque<queued_t> m_queue;
+
+            /**
+             * @brief The last identifier covered by the replay, live events up to it are skipped.
+             */
+            std::uint64_t m_replayed_until{};
+
+            /**
+             * @brief If an event was sent since the last heartbeat.
+             */
+            bool m_is_active{};
+
+            bool m_is_dropped{};
+
+            boost::asio::steady_timer m_signal;
+        };
+
+        /**
+         * @struct shard_t
+         *
+         * @brief The subscribers of an I/O context, only touched on it.
+         */
+        struct shard_t {
+            CLUEAPI_INLINE explicit shard_t(boost::asio::any_io_executor executor)
+                : m_executor{std::move(executor)}, m_heartbeat{m_executor} {
+            }
+
+            boost::asio::any_io_executor m_executor;
+
+            shared::unordered_map_t<
+                std::string,
+                std::vector<std::shared_ptr<subscriber_t>>,
+                http::detail::sv_hash_t,
+                http::detail::sv_eq_t>
+                m_topics;
+
+            std::atomic<std::size_t> m_subscriptions{};
+
+            /**
+             * @brief The heartbeat timer shared by the streams of the I/O context.
+             */
+            boost::asio::steady_timer m_heartbeat;
+
+            bool m_is_beating{};
+        };
+
+        /**
+         * @struct topic_t
+         *
+         * @brief The last events of a topic, kept for the replay.
+         */
+        struct topic_t {
+            std::deque<queued_t> m_replay;
+        };
+
+       public:
+        explicit c_impl(hub_cfg_t cfg)
+            : m_cfg{cfg}, m_heartbeat{std::make_shared<const std::string>(k_heartbeat)} {
+        }
+
+        exceptions::expected_awaitable_t<void> stream(
+            http::chunks::chunk_writer_t& writer,
+            std::string topic,
+            std::optional<std::uint64_t> last_event_id) {
+            auto executor = co_await boost::asio::this_coro::executor;
+
+            auto shard = shard_of(executor);
+
+            auto subscriber = std::make_shared<subscriber_t>(executor);
+
+            // Subscribed before the replay is read, so no event falls between the two
+            add(*shard, topic, subscriber);
+
+            if (last_event_id.has_value())
+                replay(topic, *last_event_id, *subscriber);
+
+            if (m_cfg.m_retry.count() > 0)
+                co_await writer.write_chunk(fmt::format("retry: {}\n\n", m_cfg.m_retry.count()));
+
+            while (!subscriber->m_is_dropped && !writer.writer_closed()) {
+                if (subscriber->m_queue.empty()) {
+                    boost::system::error_code ec{};
+
+                    subscriber->m_signal.expires_at(boost::asio::steady_timer::time_point::max());
+
+                    co_await subscriber->m_signal.async_wait(
+                        boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+
+                    continue;
+                }
+
+                auto queued = std::move(subscriber->m_queue.front());
+
+                subscriber->m_queue.pop_front();
+
+                if (!(co_await writer.write_chunk(*queued.m_event)).has_value())
+                    break;
+            }
+
+            if (subscriber->m_is_dropped)
+                CLUEAPI_LOG_DEBUG("SSE stream dropped, too many queued events (topic: {})", topic);
+
+            remove(*shard, topic, subscriber);
+
+            // A client going away is how a stream ends, it isn't an error
+            co_return exceptions::expected_t<void>{};
+        }
+
+        std::uint64_t publish(
+            std::string_view topic, std::string_view data, std::string_view event) {
+            queued_t queued{};
+
+            {
+                std::lock_guard lock{m_topics_mutex};
+
+                queued.m_id = ++m_last_id;
+
+                queued.m_event =
+                    make_event(event_t{.m_data = data, .m_event = event, .m_id = queued.m_id});
+
+                if (m_cfg.m_replay_size != 0u) {
+                    auto it = m_topics.find(topic);
+
+                    if (it == m_topics.end())
+                        it = m_topics.emplace(std::string{topic}, topic_t{}).first;
+
+                    auto& replay = it->second.m_replay;
+
+                    replay.push_back(queued);
+
+                    if (replay.size() > m_cfg.m_replay_size)
+                        replay.pop_front();
+                }
+            }
+
+            std::vector<std::shared_ptr<shard_t>> shards{};
+
+            {
+                std::shared_lock lock{m_mutex};
+
+                shards.reserve(m_shards.size());
+
+                for (const auto& shard : m_shards)
+                    if (shard->m_subscriptions.load(std::memory_order_relaxed) != 0u)
+                        shards.push_back(shard);
+            }
+
+            for (auto& shard : shards) {
+                auto executor = shard->m_executor;
+
+                boost::asio::post(
+                    executor,
+
+                    [this, shard = std::move(shard), topic = std::string{topic}, queued]() {
+                        deliver(*shard, topic, queued);
+                    });
+            }
+
+            return queued.m_id;
+        }
+
+        [[nodiscard]] std::size_t subscriptions() const noexcept {
+            std::shared_lock lock{m_mutex};
+
+            std::size_t ret{};
+
+            for (const auto& shard : m_shards)
+                ret += shard->m_subscriptions.load(std::memory_order_relaxed);
+
+            return ret;
+        }
+
+       private:
+        /**
+         * @brief Adds a subscriber to a topic, and starts the heartbeat of its I/O context.
+         */
+        void add(
+            shard_t& shard, std::string_view topic, std::shared_ptr<subscriber_t> subscriber) {
+            auto it = shard.m_topics.find(topic);
+
+            if (it == shard.m_topics.end())
+                it = shard.m_topics
+                         .emplace(std::string{topic}, std::vector<std::shared_ptr<subscriber_t>>{})
+                         .first;
+
+            it->second.push_back(std::move(subscriber));
+
+            shard.m_subscriptions.fetch_add(1u, std::memory_order_relaxed);
+
+            if (!shard.m_is_beating && m_cfg.m_heartbeat_interval.count() > 0) {
+                shard.m_is_beating = true;
+
+                beat(shard);
+            }
+        }
+
+        /**
+         * @brief Removes a subscriber from a topic, swapping the last one in its place.
+         */
+        static void remove(
+            shard_t& shard,
+            std::string_view topic,
+            const std::shared_ptr<subscriber_t>& subscriber) {
+            auto it = shard.m_topics.find(topic);
+
+            if (it == shard.m_topics.end())
+                return;
+
+            auto& subscribers = it->second;
+
+            for (std::size_t i{}; i < subscribers.size(); i++) {
+                if (subscribers[i] != subscriber)
+                    continue;
+
+                subscribers[i] = std::move(subscribers.back());
+
+                subscribers.pop_back();
+
+                shard.m_subscriptions.fetch_sub(1u, std::memory_order_relaxed);
+
+                break;
+            }
+
+            if (subscribers.empty())
+                shard.m_topics.erase(it);
+        }
+
+        /**
+         * @brief Queues the kept events a client missed.
+         */
+        void replay(
+            std::string_view topic, std::uint64_t last_event_id, subscriber_t& subscriber) {
+            std::lock_guard lock{m_topics_mutex};
+
+            // Events up to here are either kept, or were evicted before the client came back
+            subscriber.m_replayed_until = m_last_id;
+
+            auto it = m_topics.find(topic);
+
+            if (it == m_topics.end())
+                return;
+
+            for (const auto& queued : it->second.m_replay)
+                if (queued.m_id > last_event_id)
+                    subscriber.m_queue.push_back(queued);
+        }
+
+        /**
+         * @brief Queues a published event to the subscribers of a topic on their I/O context.
+         */
+        void deliver(shard_t& shard, std::string_view topic, const queued_t& queued) {
+            auto it = shard.m_topics.find(topic);
+
+            if (it == shard.m_topics.end())
+                return;
+
+            for (const auto& subscriber : it->second) {
+                if (subscriber->m_is_dropped || queued.m_id <= subscriber->m_replayed_until)
+                    continue;
+
+                // The stream ends, its client catches up from the replay when it reconnects
+                if (subscriber->m_queue.size() >= m_cfg.m_max_queued_events)
+                    subscriber->m_is_dropped = true;
+                else {
+                    subscriber->m_queue.push_back(queued);
+
+                    subscriber->m_is_active = true;
+                }
+
+                subscriber->wake();
+            }
+        }
+
+        /**
+         * @brief Arms the heartbeat of an I/O context, that stops once it has no subscribers.
+         */
+        void beat(shard_t& shard) {
+            shard.m_heartbeat.expires_after(m_cfg.m_heartbeat_interval);
+
+            shard.m_heartbeat.async_wait([this, &shard](const boost::system::error_code& ec) {
+                if (ec)
+                    return;
+
+                if (shard.m_subscriptions.load(std::memory_order_relaxed) == 0u) {
+                    shard.m_is_beating = false;
+
+                    return;
+                }
+
+                // Only the streams that stayed idle for the whole interval are woken
+                for (auto& [topic, subscribers] : shard.m_topics) {
+                    for (const auto& subscriber : subscribers) {
+                        if (!subscriber->m_is_active && subscriber->m_queue.empty()) {
+                            subscriber->m_queue.push_back(queued_t{.m_event = m_heartbeat});
+
+                            subscriber->wake();
+                        }
+
+                        subscriber->m_is_active = false;
+                    }
+                }
+
+                beat(shard);
+            });
+        }
+
+        /**
+         * @brief Gets the shard of an I/O context, creating it on first use.
+         */
+        [[nodiscard]] std::shared_ptr<shard_t> shard_of(
+            const boost::asio::any_io_executor& executor) {
+            {
+                std::shared_lock lock{m_mutex};
+
+                for (const auto& shard : m_shards)
+                    if (shard->m_executor == executor)
+                        return shard;
+            }
+
+            std::unique_lock lock{m_mutex};
+
+            for (const auto& shard : m_shards)
+                if (shard->m_executor == executor)
+                    return shard;
+
+            return m_shards.emplace_back(std::make_shared<shard_t>(executor));
+        }
+
+       private:
+        hub_cfg_t m_cfg;
+
+        /**
+         * @brief The heartbeat comment, shared by every stream.
+         */
+        shared_event_t m_heartbeat;
+
+        mutable std::shared_mutex m_mutex;
+
+        std::vector<std::shared_ptr<shard_t>> m_shards;
+
+        std::mutex m_topics_mutex;
+
+        /**
+         * @brief The identifier of the last published event.
+         */
+        std::uint64_t m_last_id{};
+
+        shared::
+            unordered_map_t<std::string, topic_t, http::detail::sv_hash_t, http::detail::sv_eq_t>
+                m_topics;
+    };
+
+    c_hub::c_hub(hub_cfg_t cfg) : m_impl{std::make_unique<c_impl>(cfg)} {
+    }
+
+    c_hub::~c_hub() noexcept = default;
+
+    http::types::response_t c_hub::subscribe(
+        std::string_view topic, std::optional<std::uint64_t> last_event_id) {
+        http::types::stream_response_t response{
+            [impl = m_impl.get(), topic = std::string{topic}, last_event_id](
+                http::chunks::chunk_writer_t& writer) -> exceptions::expected_awaitable_t<void> {
+                co_return co_await impl->stream(writer, topic, last_event_id);
+            },
+            "text/event-stream"};
+
+        // Proxies would otherwise hold the events back
+        response.headers().insert_or_assign("X-Accel-Buffering", "no");
+
+        return response;
+    }
+
+    std::uint64_t c_hub::publish(
+        std::string_view topic, std::string_view data, std::string_view event) {
+        return m_impl->publish(topic, data, event);
+    }
+
+    std::size_t c_hub::subscriptions() const noexcept {
+        return m_impl->subscriptions();
+    }
+} // namespace clueapi::sse
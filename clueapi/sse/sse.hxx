@@ -0,0 +1,27 @@
+/**
+ * @file sse.hxx
+ *
+ * @brief The public header of the Server-Sent Events support.
+ *
+ * @details A route streams the events of a topic by returning the response of a `c_hub`, and
+ * anything may publish to the topic:
+ *
+ * @code
+ * api.add_method(
+ *     http::types::method_t::get,
+ *     "/events/{room}",
+ *     [&hub](http::ctx_t ctx) -> http::types::response_t {
+ *         return hub.subscribe(ctx.params().at("room"), ctx.request());
+ *     });
+ *
+ * hub.publish("lobby", R"({"user":"alice"})", "join");
+ * @endcode
+ */
+
+#ifndef CLUEAPI_SSE_HXX
+#define CLUEAPI_SSE_HXX
+
+#include "clueapi/sse/event/event.hxx"
+#include "clueapi/sse/hub/hub.hxx"
+
+#endif // CLUEAPI_SSE_HXX
@@ -0,0 +1,69 @@
+/**
+ * @file deflate.hxx
+ *
+ * @brief Defines the permessage-deflate extension of WebSocket (RFC 7692).
+ *
+ * @details The server always negotiates `server_no_context_takeover` and
+ * `client_no_context_takeover`: every message is compressed on its own. A connection then keeps
+ * no compression state between messages, the streams are per thread, and a frame compressed once
+ * is valid for every connection that accepted the extension, which is what lets a broadcast share
+ * it. The compression uses the zlib implementation of Beast, so no library is needed.
+ */
+
+#ifndef CLUEAPI_WEBSOCKET_DEFLATE_HXX
+#define CLUEAPI_WEBSOCKET_DEFLATE_HXX
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "clueapi/shared/macros.hxx"
+
+/**
+ * @namespace clueapi::websocket::deflate
+ *
+ * @brief The namespace of the permessage-deflate extension.
+ */
+namespace clueapi::websocket::deflate {
+    /**
+     * @brief The value of the `Sec-WebSocket-Extensions` header answering an accepted offer.
+     */
+    inline constexpr std::string_view k_response{
+        "permessage-deflate; server_no_context_takeover; client_no_context_takeover"};
+
+    /**
+     * @brief Checks if the offers of a client include one the server can accept.
+     *
+     * @param extensions The value of the `Sec-WebSocket-Extensions` header of the request.
+     *
+     * @return `true` if a permessage-deflate offer with known parameters was found, and a server
+     * window of 15 bits is allowed.
+     */
+    [[nodiscard]] bool accepts(std::string_view extensions) noexcept;
+
+    /**
+     * @brief Compresses a message.
+     *
+     * @param data The message.
+     * @param out The string the compressed bytes are appended to, without the empty block that
+     * ends them.
+     * @param level The compression level, from 1 to 9.
+     *
+     * @return `true` on success, `false` with `out` unchanged otherwise.
+     */
+    [[nodiscard]] bool compress(std::string_view data, std::string& out, std::int32_t level);
+
+    /**
+     * @brief Decompresses a message.
+     *
+     * @param data The compressed message, as received.
+     * @param out The string the message is written to, replacing its content.
+     * @param limit The maximum size of the message.
+     *
+     * @return `true` on success, `false` if the data is invalid or the message exceeds `limit`.
+     */
+    [[nodiscard]] bool decompress(std::string_view data, std::string& out, std::size_t limit);
+} // namespace clueapi::websocket::deflate
+
+#endif // CLUEAPI_WEBSOCKET_DEFLATE_HXX
@@ -0,0 +1,203 @@
+/**
+ * @file deflate.cxx
+ *
+ * @brief Implements the permessage-deflate extension of WebSocket.
+ */
+
+#include "clueapi/websocket/deflate/deflate.hxx"
+
+#include <algorithm>
+
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/beast/zlib/deflate_stream.hpp>
+#include <boost/beast/zlib/inflate_stream.hpp>
+
+namespace clueapi::websocket::deflate {
+    namespace {
+        /**
+         * @brief The size of the sliding window, in bits, of both directions.
+         */
+        constexpr int k_window_bits = 15;
+
+        /**
+         * @brief The memory level of the compression streams.
+         */
+        constexpr int k_mem_level = 8;
+
+        /**
+         * @brief The empty stored block that ends a compressed message on the wire.
+         */
+        constexpr std::string_view k_tail{"\x00\x00\xff\xff", 4u};
+
+        /**
+         * @brief Trims the spaces and tabs around a token of a header.
+         */
+        [[nodiscard]] std::string_view trim(std::string_view str) noexcept {
+            const auto begin = str.find_first_not_of(" \t");
+
+            if (begin == std::string_view::npos)
+                return {};
+
+            return str.substr(begin, str.find_last_not_of(" \t") - begin + 1u);
+        }
+
+        /**
+         * @brief Checks if a single offer can be accepted.
+         *
+         * @param offer The offer, e.g. "permessage-deflate; client_max_window_bits".
+         */
+        [[nodiscard]] bool accepts_offer(std::string_view offer) noexcept {
+            auto name = trim(offer.substr(0u, offer.find(';')));
+
+            if (!boost::algorithm::iequals(name, "permessage-deflate"))
+                return false;
+
+            while (offer.find(';') != std::string_view::npos) {
+                offer.remove_prefix(offer.find(';') + 1u);
+
+                const auto param = trim(offer.substr(0u, offer.find(';')));
+
+                const auto eq = param.find('=');
+
+                const auto key = trim(param.substr(0u, eq));
+
+                const auto value = eq == std::string_view::npos ? std::string_view{}
+                                                                : trim(param.substr(eq + 1u));
+
+                // Both are what the server answers anyway
+                if (boost::algorithm::iequals(key, "server_no_context_takeover") ||
+                    boost::algorithm::iequals(key, "client_no_context_takeover"))
+                    continue;
+
+                // The client uses a window up to its own value, which a 15 bits window inflates
+                if (boost::algorithm::iequals(key, "client_max_window_bits"))
+                    continue;
+
+                // A smaller server window would make the shared frames invalid for this client
+                if (boost::algorithm::iequals(key, "server_max_window_bits") &&
+                    (value == "15" || value == "\"15\""))
+                    continue;
+
+                return false;
+            }
+
+            return true;
+        }
+    } // namespace
+
+    bool accepts(std::string_view extensions) noexcept {
+        while (!extensions.empty()) {
+            const auto end = extensions.find(',');
+
+            if (accepts_offer(extensions.substr(0u, end)))
+                return true;
+
+            if (end == std::string_view::npos)
+                break;
+
+            extensions.remove_prefix(end + 1u);
+        }
+
+        return false;
+    }
+
+    bool compress(std::string_view data, std::string& out, std::int32_t level) {
+        thread_local boost::beast::zlib::deflate_stream stream{};
+
+        // No context takeover, so every message starts from an empty window
+        stream.reset(
+            std::clamp(level, 1, 9),
+            k_window_bits,
+            k_mem_level,
+            boost::beast::zlib::Strategy::normal);
+
+        const auto offset = out.size();
+
+        out.resize(offset + stream.upper_bound(data.size()) + k_tail.size() + 6u);
+
+        boost::beast::zlib::z_params params{};
+
+        params.next_in = data.data();
+        params.avail_in = data.size();
+        params.next_out = out.data() + offset;
+        params.avail_out = out.size() - offset;
+
+        boost::beast::error_code ec{};
+
+        // A sync flush ends the output with the empty block the extension leaves out
+        stream.write(params, boost::beast::zlib::Flush::sync, ec);
+
+        if (ec || params.avail_in != 0u || params.total_out < k_tail.size()) {
+            out.resize(offset);
+
+            return false;
+        }
+
+        out.resize(offset + params.total_out - k_tail.size());
+
+        return true;
+    }
+
+    bool decompress(std::string_view data, std::string& out, std::size_t limit) {
+        thread_local boost::beast::zlib::inflate_stream stream{};
+
+        stream.reset(k_window_bits);
+
+        out.resize(std::min<std::size_t>(std::max<std::size_t>(data.size() * 4u, 256u), limit));
+
+        std::size_t written{};
+
+        bool is_done{};
+
+        for (const auto input : {data, k_tail}) {
+            boost::beast::zlib::z_params params{};
+
+            params.next_in = input.data();
+            params.avail_in = input.size();
+
+            while (!is_done && params.avail_in != 0u) {
+                if (written == out.size()) {
+                    // One byte over the limit tells a message that fits from one that doesn't
+                    if (out.size() > limit)
+                        return false;
+
+                    out.resize(std::min<std::size_t>(
+                        std::max<std::size_t>(out.size() * 2u, 256u), limit + 1u));
+                }
+
+                params.next_out = out.data() + written;
+                params.avail_out = out.size() - written;
+
+                const auto avail_in = params.avail_in;
+
+                const auto avail_out = params.avail_out;
+
+                boost::beast::error_code ec{};
+
+                stream.write(params, boost::beast::zlib::Flush::sync, ec);
+
+                written = out.size() - params.avail_out;
+
+                // A message may end with a final block, the rest of the input is then ignored
+                if (ec == boost::beast::zlib::error::end_of_stream) {
+                    is_done = true;
+
+                    break;
+                }
+
+                if (ec && ec != boost::beast::zlib::error::need_buffers)
+                    return false;
+
+                if (params.avail_in == avail_in && params.avail_out == avail_out)
+                    return false;
+            }
+        }
+
+        if (written > limit)
+            return false;
+
+        out.resize(written);
+
+        return true;
+    }
+} // namespace clueapi::websocket::deflate
@@ -0,0 +1,190 @@
+/**
+ * @file frame.hxx
+ *
+ * @brief Defines the encoding and decoding of WebSocket frames (RFC 6455).
+ */
+
+#ifndef CLUEAPI_WEBSOCKET_FRAME_HXX
+#define CLUEAPI_WEBSOCKET_FRAME_HXX
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "clueapi/shared/macros.hxx"
+
+namespace clueapi::websocket {
+    /**
+     * @enum e_opcode
+     *
+     * @brief The opcodes of the WebSocket frames.
+     */
+    enum struct e_opcode : std::uint8_t {
+        continuation = 0x0,
+        text = 0x1,
+        binary = 0x2,
+        close = 0x8,
+        ping = 0x9,
+        pong = 0xa
+    };
+
+    /**
+     * @brief The status codes of a close frame used by the server.
+     */
+    namespace close_code {
+        inline constexpr std::uint16_t k_normal = 1000;
+
+        inline constexpr std::uint16_t k_going_away = 1001;
+
+        inline constexpr std::uint16_t k_protocol_error = 1002;
+
+        inline constexpr std::uint16_t k_invalid_payload = 1007;
+
+        inline constexpr std::uint16_t k_policy_violation = 1008;
+
+        inline constexpr std::uint16_t k_too_big = 1009;
+
+        inline constexpr std::uint16_t k_internal_error = 1011;
+    } // namespace close_code
+
+    /**
+     * @brief Type alias for an encoded frame, shared as is by every connection it is sent to.
+     */
+    using shared_frame_t = std::shared_ptr<const std::string>;
+
+    /**
+     * @struct frame_header_t
+     *
+     * @brief The header of a received frame.
+     */
+    struct frame_header_t {
+        /**
+         * @brief Checks if the frame is a control frame (close, ping or pong).
+         */
+        [[nodiscard]] CLUEAPI_INLINE bool is_control() const noexcept {
+            return static_cast<std::uint8_t>(m_opcode) >= 0x8;
+        }
+
+        /**
+         * @brief Checks the header against the rules of RFC 6455 for frames sent by a client.
+         *
+         * @param allow_rsv1 If true, the RSV1 bit (permessage-deflate) may be set on the first
+         * frame of a data message.
+         *
+         * @return `true` if the frame may be processed, `false` on a protocol error.
+         */
+        [[nodiscard]] bool is_valid(bool allow_rsv1) const noexcept;
+
+        /**
+         * @brief The opcode of the frame.
+         */
+        e_opcode m_opcode{};
+
+        /**
+         * @brief If true, the frame is the last of its message.
+         */
+        bool m_fin{};
+
+        /**
+         * @brief The RSV1, RSV2 and RSV3 bits, in place (0x40, 0x20 and 0x10).
+         */
+        std::uint8_t m_rsv{};
+
+        /**
+         * @brief If true, the payload is masked with `m_mask`.
+         */
+        bool m_masked{};
+
+        /**
+         * @brief The masking key, in the byte order of the wire.
+         */
+        std::uint32_t m_mask{};
+
+        /**
+         * @brief The length of the payload in bytes.
+         */
+        std::uint64_t m_length{};
+    };
+
+    /**
+     * @brief The largest size of a frame header in bytes.
+     */
+    inline constexpr std::size_t k_max_header_size = 14u;
+
+    /**
+     * @brief Parses the header of a frame.
+     *
+     * @param data The received bytes, starting at the frame.
+     * @param header The header, filled when enough bytes were received.
+     *
+     * @return The size of the header in bytes, 0 if more bytes are needed.
+     */
+    [[nodiscard]] std::size_t parse_header(std::string_view data, frame_header_t& header) noexcept;
+
+    /**
+     * @brief Appends the header of an unmasked frame, as sent by a server.
+     *
+     * @param out The string appended to.
+     * @param opcode The opcode of the frame.
+     * @param size The length of the payload in bytes.
+     * @param compressed If true, sets the RSV1 bit of a permessage-deflate message.
+     */
+    void write_header(std::string& out, e_opcode opcode, std::size_t size, bool compressed = false);
+
+    /**
+     * @brief Unmasks or masks a part of a payload in place.
+     *
+     * @param data The bytes of the part.
+     * @param size The size of the part.
+     * @param mask The masking key of the frame.
+     * @param offset The offset of the part in the payload of the frame.
+     */
+    void apply_mask(
+        char* data, std::size_t size, std::uint32_t mask, std::size_t offset = 0u) noexcept;
+
+    /**
+     * @brief Encodes a complete unmasked frame.
+     *
+     * @param opcode The opcode of the frame.
+     * @param payload The payload, already compressed if `compressed` is set.
+     * @param compressed If true, sets the RSV1 bit of a permessage-deflate message.
+     *
+     * @return The frame, header and payload in one buffer.
+     */
+    [[nodiscard]] shared_frame_t make_frame(
+        e_opcode opcode, std::string_view payload, bool compressed = false);
+
+    /**
+     * @brief Checks if a payload is valid UTF-8, as the one of a text message must be.
+     *
+     * @param data The payload.
+     *
+     * @return `false` on overlong encodings, surrogates, code points past U+10FFFF and truncated
+     * sequences.
+     */
+    [[nodiscard]] bool is_valid_utf8(std::string_view data) noexcept;
+
+    /**
+     * @brief Checks if a status code may be received in a close frame (RFC 6455, section 7.4).
+     *
+     * @param code The status code.
+     *
+     * @return `true` for the defined codes and those of libraries and applications (3000-4999),
+     * `false` for the reserved ones, e.g. 1005, 1006 and 1015, which are never sent.
+     */
+    [[nodiscard]] bool is_valid_close_code(std::uint16_t code) noexcept;
+
+    /**
+     * @brief Encodes a close frame.
+     *
+     * @param code The status code, e.g. `close_code::k_normal`.
+     * @param reason The reason, cut to fit a control frame.
+     *
+     * @return The frame.
+     */
+    [[nodiscard]] shared_frame_t make_close_frame(std::uint16_t code, std::string_view reason = {});
+} // namespace clueapi::websocket
+
+#endif // CLUEAPI_WEBSOCKET_FRAME_HXX
@@ -0,0 +1,253 @@
+/**
+ * @file frame.cxx
+ *
+ * @brief Implements the encoding and decoding of WebSocket frames.
+ */
+
+#include "clueapi/websocket/frame/frame.hxx"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+namespace clueapi::websocket {
+    bool frame_header_t::is_valid(bool allow_rsv1) const noexcept {
+        // Frames from a client are always masked
+        if (!m_masked)
+            return false;
+
+        if (m_rsv & 0x30u)
+            return false;
+
+        switch (m_opcode) {
+            case e_opcode::continuation:
+                // Only the first frame of a message carries the compression bit
+                return !(m_rsv & 0x40u);
+            case e_opcode::text:
+            case e_opcode::binary:
+                return !(m_rsv & 0x40u) || allow_rsv1;
+            case e_opcode::close:
+            case e_opcode::ping:
+            case e_opcode::pong:
+                return !m_rsv && m_fin && m_length <= 125u;
+            default:
+                return false;
+        }
+    }
+
+    std::size_t parse_header(std::string_view data, frame_header_t& header) noexcept {
+        if (data.size() < 2u)
+            return 0u;
+
+        const auto* bytes = reinterpret_cast<const unsigned char*>(data.data());
+
+        header.m_fin = (bytes[0] & 0x80u) != 0u;
+        header.m_rsv = static_cast<std::uint8_t>(bytes[0] & 0x70u);
+        header.m_opcode = static_cast<e_opcode>(bytes[0] & 0x0fu);
+        header.m_masked = (bytes[1] & 0x80u) != 0u;
+
+        std::size_t size{2u};
+
+        std::uint64_t length = bytes[1] & 0x7fu;
+
+        if (length == 126u) {
+            if (data.size() < size + 2u)
+                return 0u;
+
+            length = (std::uint64_t{bytes[2]} << 8u) | bytes[3];
+
+            size += 2u;
+        } else if (length == 127u) {
+            if (data.size() < size + 8u)
+                return 0u;
+
+            length = 0u;
+
+            for (std::size_t i{}; i < 8u; i++)
+                length = (length << 8u) | bytes[2u + i];
+
+            size += 8u;
+        }
+
+        header.m_length = length;
+
+        header.m_mask = 0u;
+
+        if (header.m_masked) {
+            if (data.size() < size + 4u)
+                return 0u;
+
+            std::memcpy(&header.m_mask, bytes + size, 4u);
+
+            size += 4u;
+        }
+
+        return size;
+    }
+
+    void write_header(std::string& out, e_opcode opcode, std::size_t size, bool compressed) {
+        std::array<char, k_max_header_size> header{};
+
+        std::size_t header_size{2u};
+
+        header[0] = static_cast<char>(0x80u | (compressed ? 0x40u : 0u) |
+                                      static_cast<std::uint8_t>(opcode));
+
+        if (size < 126u) {
+            header[1] = static_cast<char>(size);
+        } else if (size <= 0xffffu) {
+            header[1] = static_cast<char>(126u);
+            header[2] = static_cast<char>((size >> 8u) & 0xffu);
+            header[3] = static_cast<char>(size & 0xffu);
+
+            header_size += 2u;
+        } else {
+            header[1] = static_cast<char>(127u);
+
+            for (std::size_t i{}; i < 8u; i++)
+                header[2u + i] =
+                    static_cast<char>((static_cast<std::uint64_t>(size) >> (56u - i * 8u)) & 0xffu);
+
+            header_size += 8u;
+        }
+
+        out.append(header.data(), header_size);
+    }
+
+    void apply_mask(char* data, std::size_t size, std::uint32_t mask, std::size_t offset) noexcept {
+        std::array<char, 4> key{};
+
+        std::memcpy(key.data(), &mask, key.size());
+
+        // The key is rotated so that the part starts with the byte its offset is masked with
+        std::rotate(key.begin(), key.begin() + static_cast<std::ptrdiff_t>(offset % 4u), key.end());
+
+        std::array<char, 8> wide_key{};
+
+        std::memcpy(wide_key.data(), key.data(), key.size());
+        std::memcpy(wide_key.data() + key.size(), key.data(), key.size());
+
+        std::uint64_t wide{};
+
+        std::memcpy(&wide, wide_key.data(), wide_key.size());
+
+        std::size_t i{};
+
+        for (; i + sizeof(wide) <= size; i += sizeof(wide)) {
+            std::uint64_t word{};
+
+            std::memcpy(&word, data + i, sizeof(word));
+
+            word ^= wide;
+
+            std::memcpy(data + i, &word, sizeof(word));
+        }
+
+        for (; i < size; i++)
+            data[i] = static_cast<char>(data[i] ^ key[i % 4u]);
+    }
+
+    shared_frame_t make_frame(e_opcode opcode, std::string_view payload, bool compressed) {
+        auto frame = std::make_shared<std::string>();
+
+        frame->reserve(k_max_header_size + payload.size());
+
+        write_header(*frame, opcode, payload.size(), compressed);
+
+        frame->append(payload);
+
+        return frame;
+    }
+
+    bool is_valid_utf8(std::string_view data) noexcept {
+        const auto* it = reinterpret_cast<const unsigned char*>(data.data());
+
+        const auto* end = it + data.size();
+
+        while (it != end) {
+            // Text is mostly ASCII, checked a word at a time
+            if (static_cast<std::size_t>(end - it) >= sizeof(std::uint64_t)) {
+                std::uint64_t word{};
+
+                std::memcpy(&word, it, sizeof(word));
+
+                if ((word & 0x8080808080808080ull) == 0u) {
+                    it += sizeof(word);
+
+                    continue;
+                }
+            }
+
+            const auto lead = *it;
+
+            if (lead < 0x80u) {
+                it++;
+
+                continue;
+            }
+
+            std::size_t size{};
+
+            // The bounds of the second byte rule out overlong forms, surrogates and code points
+            // past U+10FFFF (RFC 3629, section 4)
+            unsigned char low{0x80u};
+            unsigned char high{0xbfu};
+
+            if (lead >= 0xc2u && lead <= 0xdfu)
+                size = 2u;
+            else if (lead >= 0xe0u && lead <= 0xefu) {
+                size = 3u;
+
+                if (lead == 0xe0u)
+                    low = 0xa0u;
+                else if (lead == 0xedu)
+                    high = 0x9fu;
+            } else if (lead >= 0xf0u && lead <= 0xf4u) {
+                size = 4u;
+
+                if (lead == 0xf0u)
+                    low = 0x90u;
+                else if (lead == 0xf4u)
+                    high = 0x8fu;
+            } else
+                return false;
+
+            if (static_cast<std::size_t>(end - it) < size || it[1] < low || it[1] > high)
+                return false;
+
+            for (std::size_t i{2u}; i < size; i++) {
+                if ((it[i] & 0xc0u) != 0x80u)
+                    return false;
+            }
+
+            it += size;
+        }
+
+        return true;
+    }
+
+    bool is_valid_close_code(std::uint16_t code) noexcept {
+        // 1004 is reserved, 1005 and 1006 stand for its absence and 1015 for a failed handshake
+        if (code >= 1000u && code <= 1014u)
+            return code != 1004u && code != 1005u && code != 1006u;
+
+        return code >= 3000u && code <= 4999u;
+    }
+
+    shared_frame_t make_close_frame(std::uint16_t code, std::string_view reason) {
+        // A control frame carries at most 125 bytes, two of which are the code
+        reason = reason.substr(0u, std::min<std::size_t>(reason.size(), 123u));
+
+        std::string payload{};
+
+        payload.reserve(2u + reason.size());
+
+        payload.push_back(static_cast<char>((code >> 8u) & 0xffu));
+        payload.push_back(static_cast<char>(code & 0xffu));
+
+        payload.append(reason);
+
+        return make_frame(e_opcode::close, payload);
+    }
+} // namespace clueapi::websocket
@@ -0,0 +1,143 @@
+/**
+ * @file hub.hxx
+ *
+ * @brief Defines a broadcast hub that fans messages out to the WebSocket sessions of a topic.
+ */
+
+#ifndef CLUEAPI_WEBSOCKET_HUB_HXX
+#define CLUEAPI_WEBSOCKET_HUB_HXX
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "clueapi/shared/json_writer/json_writer.hxx"
+#include "clueapi/shared/macros.hxx"
+
+#include "clueapi/websocket/frame/frame.hxx"
+
+namespace clueapi::websocket {
+    struct session_t;
+
+    /**
+     * @struct hub_cfg_t
+     *
+     * @brief The settings of a hub.
+     */
+    struct hub_cfg_t {
+        /**
+         * @brief If true, a compressed frame is also built for the sessions that negotiated
+         * permessage-deflate.
+         */
+        bool m_compress{true};
+
+        /**
+         * @brief The minimum size of a message for it to be compressed.
+         */
+        std::size_t m_compress_threshold{512u};
+
+        /**
+         * @brief The compression level, from 1 (fastest) to 9 (smallest).
+         */
+        std::int32_t m_compression_level{6};
+    };
+
+    /**
+     * @class c_hub
+     *
+     * @brief Publishes messages to the sessions subscribed to a topic.
+     *
+     * @details A message is framed, and compressed if enabled, once per publish. The immutable
+     * frame is then shared by every subscriber: one task is posted to each I/O context that has
+     * subscribers, and queues the frame to its sessions without any lock or copy. The
+     * subscribers of an I/O context are only touched on it. A session that can't keep up is
+     * dropped by its own queue limit, `cfg_t::websocket_t::m_max_queued_bytes`.
+     *
+     * @note `subscribe()` and `unsubscribe()` are called on the executor of the session, e.g. in
+     * its handler. `publish()` is thread-safe. A closed session leaves its topics by itself.
+     */
+    class c_hub {
+       public:
+        /**
+         * @brief Constructs a hub.
+         *
+         * @param cfg The settings of the hub.
+         */
+        explicit c_hub(hub_cfg_t cfg = {});
+
+        ~c_hub() noexcept;
+
+        // Copy constructor
+        CLUEAPI_INLINE c_hub(const c_hub&) = delete;
+
+        // Copy assignment operator
+        CLUEAPI_INLINE c_hub& operator=(const c_hub&) = delete;
+
+       public:
+        /**
+         * @brief Subscribes a session to a topic.
+         *
+         * @param topic The topic.
+         * @param session The session.
+         */
+        void subscribe(std::string_view topic, const std::shared_ptr<session_t>& session);
+
+        /**
+         * @brief Unsubscribes a session from a topic.
+         *
+         * @param topic The topic.
+         * @param session The session.
+         */
+        void unsubscribe(std::string_view topic, const std::shared_ptr<session_t>& session);
+
+        /**
+         * @brief Publishes a message to the subscribers of a topic.
+         *
+         * @param topic The topic.
+         * @param payload The payload of the message.
+         * @param opcode `e_opcode::text` or `e_opcode::binary`.
+         */
+        void publish(
+            std::string_view topic, std::string_view payload, e_opcode opcode = e_opcode::text);
+
+        /**
+         * @brief Publishes a value as a JSON text message.
+         *
+         * @param topic The topic.
+         * @param value The value, serialized by `shared::json_writer_t`.
+         */
+        template <typename _type_t>
+        CLUEAPI_INLINE void publish_json(std::string_view topic, const _type_t& value) {
+            publish(topic, shared::json_writer_t::to_string(value));
+        }
+
+        /**
+         * @brief Gets the number of subscriptions, across all topics and I/O contexts.
+         *
+         * @return The number of subscriptions, including those of sessions closed since their
+         * last publish.
+         */
+        [[nodiscard]] std::size_t subscriptions() const noexcept;
+
+       private:
+        /**
+         * @class c_impl
+         *
+         * @brief The internal implementation of the `c_hub` class.
+         *
+         * @internal
+         */
+        class c_impl;
+
+        /**
+         * @brief The internal implementation of the `c_hub` class.
+         *
+         * @internal
+         */
+        std::unique_ptr<c_impl> m_impl;
+    };
+} // namespace clueapi::websocket
+
+#endif // CLUEAPI_WEBSOCKET_HUB_HXX
@@ -0,0 +1,275 @@
+/**
+ * @file hub.cxx
+ *
+ * @brief Implements the WebSocket broadcast hub.
+ */
+
+#include "clueapi/websocket/hub/hub.hxx"
+
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <utility>
+#include <vector>
+
+#include <boost/asio/any_io_executor.hpp>
+#include <boost/asio/post.hpp>
+
+#include "clueapi/http/detail/sv_hash/sv_hash.hxx"
+
+#include "clueapi/shared/shared.hxx"
+
+#include "clueapi/websocket/deflate/deflate.hxx"
+#include "clueapi/websocket/session/session.hxx"
+
+namespace clueapi::websocket {
+    class c_hub::c_impl {
+       public:
+        /**
+         * @struct subscriber_t
+         *
+         * @brief A session subscribed to a topic.
+         */
+        struct subscriber_t {
+            std::weak_ptr<session_t> m_session;
+
+            bool m_uses_deflate{};
+        };
+
+        /**
+         * @struct shard_t
+         *
+         * @brief The subscribers of an I/O context, only touched on it.
+         */
+        struct shard_t {
+            CLUEAPI_INLINE explicit shard_t(boost::asio::any_io_executor executor)
+                : m_executor{std::move(executor)} {
+            }
+
+            /**
+             * @brief Removes a subscriber, swapping the last one in its place.
+             */
+            CLUEAPI_INLINE void remove(std::vector<subscriber_t>& subscribers, std::size_t i) {
+                m_subscriptions.fetch_sub(1u, std::memory_order_relaxed);
+
+                if (subscribers[i].m_uses_deflate)
+                    m_deflate_subscriptions.fetch_sub(1u, std::memory_order_relaxed);
+
+                subscribers[i] = std::move(subscribers.back());
+
+                subscribers.pop_back();
+            }
+
+            boost::asio::any_io_executor m_executor;
+
+            shared::unordered_map_t<
+                std::string,
+                std::vector<subscriber_t>,
+                http::detail::sv_hash_t,
+                http::detail::sv_eq_t>
+                m_topics;
+
+            std::atomic<std::size_t> m_subscriptions{};
+
+            std::atomic<std::size_t> m_deflate_subscriptions{};
+        };
+
+       public:
+        explicit c_impl(hub_cfg_t cfg) : m_cfg{cfg} {
+        }
+
+        void subscribe(std::string_view topic, const std::shared_ptr<session_t>& session) {
+            if (!session || !session->is_open())
+                return;
+
+            auto shard = shard_of(session->executor());
+
+            auto it = shard->m_topics.find(topic);
+
+            if (it == shard->m_topics.end())
+                it = shard->m_topics.emplace(std::string{topic}, std::vector<subscriber_t>{}).first;
+
+            it->second.push_back(
+                subscriber_t{.m_session = session, .m_uses_deflate = session->uses_deflate()});
+
+            shard->m_subscriptions.fetch_add(1u, std::memory_order_relaxed);
+
+            if (session->uses_deflate())
+                shard->m_deflate_subscriptions.fetch_add(1u, std::memory_order_relaxed);
+        }
+
+        void unsubscribe(std::string_view topic, const std::shared_ptr<session_t>& session) {
+            if (!session)
+                return;
+
+            auto shard = shard_of(session->executor());
+
+            auto it = shard->m_topics.find(topic);
+
+            if (it == shard->m_topics.end())
+                return;
+
+            auto& subscribers = it->second;
+
+            for (std::size_t i{}; i < subscribers.size();) {
+                const auto current = subscribers[i].m_session.lock();
+
+                if (!current || current == session) {
+                    shard->remove(subscribers, i);
+
+                    continue;
+                }
+
+                i++;
+            }
+
+            if (subscribers.empty())
+                shard->m_topics.erase(it);
+        }
+
+        void publish(std::string_view topic, std::string_view payload, e_opcode opcode) {
+            std::vector<std::shared_ptr<shard_t>> shards{};
+
+            bool has_deflate{};
+
+            {
+                std::shared_lock lock{m_mutex};
+
+                shards.reserve(m_shards.size());
+
+                for (const auto& shard : m_shards) {
+                    if (shard->m_subscriptions.load(std::memory_order_relaxed) == 0u)
+                        continue;
+
+                    has_deflate |=
+                        shard->m_deflate_subscriptions.load(std::memory_order_relaxed) != 0u;
+
+                    shards.push_back(shard);
+                }
+            }
+
+            if (shards.empty())
+                return;
+
+            // Framed once, and compressed once, for every subscriber
+            auto plain = make_frame(opcode, payload);
+
+            shared_frame_t deflated{};
+
+            if (has_deflate && m_cfg.m_compress && payload.size() >= m_cfg.m_compress_threshold) {
+                std::string compressed{};
+
+                if (deflate::compress(payload, compressed, m_cfg.m_compression_level))
+                    deflated = make_frame(opcode, compressed, true);
+            }
+
+            for (auto& shard : shards) {
+                auto executor = shard->m_executor;
+
+                boost::asio::post(
+                    executor,
+
+                    [shard = std::move(shard),
+                     topic = std::string{topic},
+                     plain,
+                     deflated]() { deliver(*shard, topic, plain, deflated); });
+            }
+        }
+
+        [[nodiscard]] std::size_t subscriptions() const noexcept {
+            std::shared_lock lock{m_mutex};
+
+            std::size_t ret{};
+
+            for (const auto& shard : m_shards)
+                ret += shard->m_subscriptions.load(std::memory_order_relaxed);
+
+            return ret;
+        }
+
+       private:
+        /**
+         * @brief Queues a published frame to the subscribers of a topic on their I/O context.
+         */
+        static void deliver(
+            shard_t& shard,
+            std::string_view topic,
+            const shared_frame_t& plain,
+            const shared_frame_t& deflated) {
+            auto it = shard.m_topics.find(topic);
+
+            if (it == shard.m_topics.end())
+                return;
+
+            auto& subscribers = it->second;
+
+            for (std::size_t i{}; i < subscribers.size();) {
+                const auto session = subscribers[i].m_session.lock();
+
+                // A dropped session is removed here, closed ones leave on the next publish
+                if (!session ||
+                    !session->send_frame(
+                        deflated && subscribers[i].m_uses_deflate ? deflated : plain)) {
+                    shard.remove(subscribers, i);
+
+                    continue;
+                }
+
+                i++;
+            }
+
+            if (subscribers.empty())
+                shard.m_topics.erase(it);
+        }
+
+        /**
+         * @brief Gets the shard of an I/O context, creating it on first use.
+         */
+        [[nodiscard]] std::shared_ptr<shard_t> shard_of(
+            const boost::asio::any_io_executor& executor) {
+            {
+                std::shared_lock lock{m_mutex};
+
+                for (const auto& shard : m_shards)
+                    if (shard->m_executor == executor)
+                        return shard;
+            }
+
+            std::unique_lock lock{m_mutex};
+
+            for (const auto& shard : m_shards)
+                if (shard->m_executor == executor)
+                    return shard;
+
+            return m_shards.emplace_back(std::make_shared<shard_t>(executor));
+        }
+
+       private:
+        hub_cfg_t m_cfg;
+
+        mutable std::shared_mutex m_mutex;
+
+        std::vector<std::shared_ptr<shard_t>> m_shards;
+    };
+
+    c_hub::c_hub(hub_cfg_t cfg) : m_impl{std::make_unique<c_impl>(cfg)} {
+    }
+
+    c_hub::~c_hub() noexcept = default;
+
+    void c_hub::subscribe(std::string_view topic, const std::shared_ptr<session_t>& session) {
+        m_impl->subscribe(topic, session);
+    }
+
+    void c_hub::unsubscribe(std::string_view topic, const std::shared_ptr<session_t>& session) {
+        m_impl->unsubscribe(topic, session);
+    }
+
+    void c_hub::publish(std::string_view topic, std::string_view payload, e_opcode opcode) {
+        m_impl->publish(topic, payload, opcode);
+    }
+
+    std::size_t c_hub::subscriptions() const noexcept {
+        return m_impl->subscriptions();
+    }
+} // namespace clueapi::websocket
@@ -0,0 +1,380 @@
+/**
+ * @file session.cxx
+ *
+ * @brief Implements the WebSocket connection.
+ */
+
+#include "clueapi/websocket/session/session.hxx"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <utility>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/redirect_error.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/asio/write.hpp>
+
+#include "clueapi/modules/macros.hxx"
+
+#include "clueapi/websocket/deflate/deflate.hxx"
+
+namespace clueapi::websocket {
+    namespace {
+        /**
+         * @brief The number of bytes asked for by a read into the buffer of the connection.
+         */
+        constexpr std::size_t k_read_size = 16u * 1024u;
+    } // namespace
+
+    session_t::session_t(
+        boost::asio::ip::tcp::socket& socket,
+        shared::pooled_buffer_t& buffer,
+        const cfg::cfg_t::websocket_t& cfg,
+        bool uses_deflate)
+        : m_socket{socket},
+          m_buffer{buffer},
+          m_cfg{cfg},
+          m_executor{socket.get_executor()},
+          m_drained{m_executor},
+          m_uses_deflate{uses_deflate} {
+    }
+
+    session_t::~session_t() noexcept = default;
+
+    exceptions::expected_awaitable_t<message_t> session_t::read() {
+        while (true) {
+            if (m_state == e_state::closed || m_is_read_done)
+                co_return exceptions::make_unexpected("Connection closed");
+
+            frame_header_t header{};
+
+            std::size_t header_size{};
+
+            while (true) {
+                const auto data = m_buffer.cdata();
+
+                header_size = parse_header(
+                    std::string_view{static_cast<const char*>(data.data()), data.size()}, header);
+
+                if (header_size != 0u)
+                    break;
+
+                if (auto filled = co_await fill(m_buffer.size() + 1u); !filled.has_value())
+                    co_return exceptions::make_unexpected(std::move(filled.error()));
+            }
+
+            m_buffer.consume(header_size);
+
+            if (!header.is_valid(m_uses_deflate)) {
+                fail(close_code::k_protocol_error);
+
+                co_return exceptions::make_unexpected("Protocol error");
+            }
+
+            if (header.is_control()) {
+                m_control.clear();
+
+                if (auto payload = co_await read_payload(m_control, header); !payload.has_value())
+                    co_return exceptions::make_unexpected(std::move(payload.error()));
+
+                if (header.m_opcode == e_opcode::ping) {
+                    if (m_state == e_state::open)
+                        send_frame(make_frame(e_opcode::pong, m_control));
+
+                    continue;
+                }
+
+                if (header.m_opcode == e_opcode::pong)
+                    continue;
+
+                // The close frame of the client is echoed, unless the server closed first
+                if (m_state == e_state::open) {
+                    auto code = close_code::k_normal;
+
+                    // A code takes two bytes, a lone byte is malformed
+                    if (m_control.size() == 1u)
+                        code = close_code::k_protocol_error;
+                    else if (m_control.size() >= 2u) {
+                        code = static_cast<std::uint16_t>(
+                            (static_cast<unsigned char>(m_control[0]) << 8u) |
+                            static_cast<unsigned char>(m_control[1]));
+
+                        // Reserved codes are never sent, and the reason that follows is text
+                        if (!is_valid_close_code(code) ||
+                            !is_valid_utf8(std::string_view{m_control}.substr(2u)))
+                            code = close_code::k_protocol_error;
+                    }
+
+                    close(code);
+                }
+
+                m_is_read_done = true;
+
+                co_return exceptions::make_unexpected("Connection closed by the client");
+            }
+
+            if (header.m_opcode == e_opcode::continuation) {
+                if (!m_is_fragmented) {
+                    fail(close_code::k_protocol_error);
+
+                    co_return exceptions::make_unexpected("Unexpected continuation frame");
+                }
+            } else {
+                if (m_is_fragmented) {
+                    fail(close_code::k_protocol_error);
+
+                    co_return exceptions::make_unexpected("Expected a continuation frame");
+                }
+
+                m_message.clear();
+
+                m_opcode = header.m_opcode;
+
+                m_is_compressed = (header.m_rsv & 0x40u) != 0u;
+            }
+
+            if (header.m_length > m_cfg.m_max_message_size - m_message.size()) {
+                fail(close_code::k_too_big);
+
+                co_return exceptions::make_unexpected("Message too big");
+            }
+
+            if (auto payload = co_await read_payload(m_message, header); !payload.has_value())
+                co_return exceptions::make_unexpected(std::move(payload.error()));
+
+            m_is_fragmented = !header.m_fin;
+
+            if (m_is_fragmented)
+                continue;
+
+            if (m_is_compressed &&
+                !deflate::decompress(m_message, m_inflated, m_cfg.m_max_message_size)) {
+                fail(close_code::k_invalid_payload);
+
+                co_return exceptions::make_unexpected("Invalid compressed message");
+            }
+
+            const std::string_view data{m_is_compressed ? m_inflated : m_message};
+
+            // Only a whole message is checked, a fragment may end within a code point
+            if (m_opcode == e_opcode::text && !is_valid_utf8(data)) {
+                fail(close_code::k_invalid_payload);
+
+                co_return exceptions::make_unexpected("Invalid UTF-8 in a text message");
+            }
+
+            co_return message_t{.m_opcode = m_opcode, .m_data = data};
+        }
+    }
+
+    bool session_t::send(std::string_view data, e_opcode opcode) {
+        if (m_state != e_state::open)
+            return false;
+
+        if (m_uses_deflate && data.size() >= m_cfg.m_compress_threshold) {
+            thread_local std::string compressed{};
+
+            compressed.clear();
+
+            if (deflate::compress(data, compressed, m_cfg.m_compression_level))
+                return send_frame(make_frame(opcode, compressed, true));
+        }
+
+        return send_frame(make_frame(opcode, data));
+    }
+
+    bool session_t::send_frame(shared_frame_t frame) {
+        if (m_state != e_state::open || !frame)
+            return false;
+
+        if (m_queued_bytes + frame->size() > m_cfg.m_max_queued_bytes) {
+            CLUEAPI_LOG_DEBUG(
+                "Dropping WebSocket connection (id: {}): {} bytes queued",
+
+                m_socket.native_handle(),
+                m_queued_bytes);
+
+            drop();
+
+            return false;
+        }
+
+        enqueue(std::move(frame));
+
+        return true;
+    }
+
+    void session_t::close(std::uint16_t code, std::string_view reason) {
+        if (m_state != e_state::open)
+            return;
+
+        // Not subject to the limit, the handshake must go out
+        enqueue(make_close_frame(code, reason));
+
+        m_state = e_state::closing;
+    }
+
+    shared::awaitable_t<void> session_t::finish() {
+        close();
+
+        boost::system::error_code ec{};
+
+        if (m_is_writing) {
+            m_drained.expires_after(m_cfg.m_close_timeout);
+
+            co_await m_drained.async_wait(
+                boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+        }
+
+        // The client doesn't read, the write is cancelled and awaited before the detach
+        if (m_is_writing) {
+            m_socket.cancel(ec);
+
+            while (m_is_writing) {
+                m_drained.expires_after(std::chrono::seconds{1});
+
+                co_await m_drained.async_wait(
+                    boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+            }
+        }
+
+        m_state = e_state::closed;
+
+        m_is_read_done = true;
+    }
+
+    void session_t::enqueue(shared_frame_t frame) {
+        m_queued_bytes += frame->size();
+
+        m_queue.push_back(std::move(frame));
+
+        if (m_is_writing)
+            return;
+
+        m_is_writing = true;
+
+        boost::asio::co_spawn(m_executor, write_loop(shared_from_this()), boost::asio::detached);
+    }
+
+    void session_t::drop() {
+        m_state = e_state::closed;
+
+        for (const auto& frame : m_queue)
+            m_queued_bytes -= frame->size();
+
+        m_queue.clear();
+
+        // The pending read and write complete with an error, which ends the handler
+        boost::system::error_code ec{};
+
+        m_socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+
+        m_socket.cancel(ec);
+    }
+
+    shared::awaitable_t<void> session_t::write_loop(std::shared_ptr<session_t> self) {
+        while (!m_queue.empty()) {
+            std::swap(m_queue, m_in_flight);
+
+            m_buffers.clear();
+
+            for (const auto& frame : m_in_flight)
+                m_buffers.emplace_back(frame->data(), frame->size());
+
+            boost::system::error_code ec{};
+
+            co_await boost::asio::async_write(
+                m_socket, m_buffers, boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+
+            for (const auto& frame : m_in_flight)
+                m_queued_bytes -= frame->size();
+
+            m_in_flight.clear();
+
+            if (ec) {
+                CLUEAPI_LOG_TRACE("Failed to write WebSocket frames: {}", ec.message());
+
+                drop();
+
+                break;
+            }
+        }
+
+        m_is_writing = false;
+
+        m_drained.cancel();
+    }
+
+    exceptions::expected_awaitable_t<void> session_t::fill(std::size_t size) {
+        while (m_buffer.size() < size) {
+            boost::system::error_code ec{};
+
+            const auto capacity = std::min(k_read_size, m_buffer.max_size() - m_buffer.size());
+
+            const auto bytes_read = co_await m_socket.async_read_some(
+                m_buffer.prepare(capacity),
+                boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+
+            m_buffer.commit(bytes_read);
+
+            if (ec) {
+                m_state = e_state::closed;
+
+                m_is_read_done = true;
+
+                co_return exceptions::make_unexpected(ec.message());
+            }
+        }
+
+        co_return exceptions::expected_t<void>{};
+    }
+
+    exceptions::expected_awaitable_t<void> session_t::read_payload(
+        std::string& out, const frame_header_t& header) {
+        const auto length = static_cast<std::size_t>(header.m_length);
+
+        const auto offset = out.size();
+
+        out.resize(offset + length);
+
+        // What the buffer already holds is copied, the rest is read in place
+        const auto buffered = std::min(m_buffer.size(), length);
+
+        if (buffered != 0u) {
+            std::memcpy(out.data() + offset, m_buffer.cdata().data(), buffered);
+
+            m_buffer.consume(buffered);
+        }
+
+        if (buffered < length) {
+            boost::system::error_code ec{};
+
+            co_await boost::asio::async_read(
+                m_socket,
+                boost::asio::buffer(out.data() + offset + buffered, length - buffered),
+                boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+
+            if (ec) {
+                m_state = e_state::closed;
+
+                m_is_read_done = true;
+
+                co_return exceptions::make_unexpected(ec.message());
+            }
+        }
+
+        apply_mask(out.data() + offset, length, header.m_mask);
+
+        co_return exceptions::expected_t<void>{};
+    }
+
+    void session_t::fail(std::uint16_t code) {
+        close(code);
+
+        m_is_read_done = true;
+    }
+} // namespace clueapi::websocket
@@ -0,0 +1,358 @@
+/**
+ * @file session.hxx
+ *
+ * @brief Defines a WebSocket connection, as handed to the handler of a WebSocket route.
+ */
+
+#ifndef CLUEAPI_WEBSOCKET_SESSION_HXX
+#define CLUEAPI_WEBSOCKET_SESSION_HXX
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <boost/asio/any_io_executor.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include "clueapi/cfg/cfg.hxx"
+
+#include "clueapi/exceptions/wrap/wrap.hxx"
+
+#include "clueapi/http/ctx/ctx.hxx"
+
+#include "clueapi/shared/buffer_pool/buffer_pool.hxx"
+#include "clueapi/shared/macros.hxx"
+#include "clueapi/shared/shared.hxx"
+
+#include "clueapi/websocket/frame/frame.hxx"
+
+/**
+ * @namespace clueapi::websocket
+ *
+ * @brief The main namespace for the clueapi WebSocket support.
+ */
+namespace clueapi::websocket {
+    /**
+     * @struct message_t
+     *
+     * @brief A data message received from a client.
+     */
+    struct message_t {
+        /**
+         * @brief Checks if the message is text.
+         */
+        [[nodiscard]] CLUEAPI_INLINE bool is_text() const noexcept {
+            return m_opcode == e_opcode::text;
+        }
+
+        /**
+         * @brief `e_opcode::text` or `e_opcode::binary`.
+         */
+        e_opcode m_opcode{e_opcode::text};
+
+        /**
+         * @brief The payload, unmasked and decompressed. Valid until the next read.
+         *
+         * @note The UTF-8 of a text message is not validated.
+         */
+        std::string_view m_data;
+    };
+
+    /**
+     * @struct session_t
+     *
+     * @brief An upgraded connection.
+     *
+     * @details Reads are made by the handler, one at a time. Sends are queued and written by a
+     * single writer, several queued frames in one gathered write, so a handler may send while it
+     * waits for a message. Control frames are answered as they are read. When the queued bytes
+     * would exceed `cfg_t::websocket_t::m_max_queued_bytes`, the connection is dropped, so a
+     * slow consumer never buffers without bound.
+     *
+     * @note Not thread-safe: the members are called on `executor()`, which is what
+     * `c_hub` does. Post to it from other threads.
+     */
+    struct session_t : public std::enable_shared_from_this<session_t> {
+        /**
+         * @brief Constructs a session on a connection whose handshake is done.
+         *
+         * @param socket The socket of the connection.
+         * @param buffer The read buffer of the connection, holding any byte already received.
+         * @param cfg The WebSocket settings.
+         * @param uses_deflate If true, permessage-deflate was negotiated.
+         *
+         * @internal
+         */
+        session_t(
+            boost::asio::ip::tcp::socket& socket,
+            shared::pooled_buffer_t& buffer,
+            const cfg::cfg_t::websocket_t& cfg,
+            bool uses_deflate);
+
+        ~session_t() noexcept;
+
+        // Copy constructor
+        CLUEAPI_INLINE session_t(const session_t&) = delete;
+
+        // Copy assignment operator
+        CLUEAPI_INLINE session_t& operator=(const session_t&) = delete;
+
+       public:
+        /**
+         * @brief Reads the next data message.
+         *
+         * @return The message, or an unexpected once the connection is closed (by the client, a
+         * protocol error or a drop).
+         *
+         * @note A text message that isn't valid UTF-8 closes the connection with
+         * `close_code::k_invalid_payload`.
+         */
+        exceptions::expected_awaitable_t<message_t> read();
+
+        /**
+         * @brief Queues a message.
+         *
+         * @param data The payload.
+         * @param opcode `e_opcode::text` or `e_opcode::binary`.
+         *
+         * @return `true` if queued, `false` if the connection is closing or was dropped.
+         *
+         * @note The message is compressed if permessage-deflate was negotiated and it is at least
+         * `cfg_t::websocket_t::m_compress_threshold` bytes.
+         */
+        bool send(std::string_view data, e_opcode opcode = e_opcode::text);
+
+        /**
+         * @brief Queues an encoded frame without copying it.
+         *
+         * @param frame The frame, e.g. from `make_frame()`.
+         *
+         * @return `true` if queued, `false` if the connection is closing or was dropped.
+         */
+        bool send_frame(shared_frame_t frame);
+
+        /**
+         * @brief Starts the closing handshake.
+         *
+         * @param code The status code of the close frame.
+         * @param reason The reason of the close frame.
+         *
+         * @note The messages queued before are still sent. Has no effect once closing.
+         */
+        void close(std::uint16_t code = close_code::k_normal, std::string_view reason = {});
+
+        /**
+         * @brief Ends the session once its handler returned.
+         *
+         * @details Closes the session if the handler didn't, waits at most
+         * `cfg_t::websocket_t::m_close_timeout` for the queued frames to be written, and detaches
+         * the session from the connection, which any later call then ignores.
+         *
+         * @internal
+         */
+        shared::awaitable_t<void> finish();
+
+       public:
+        /**
+         * @brief Checks if messages can still be sent.
+         */
+        [[nodiscard]] CLUEAPI_INLINE bool is_open() const noexcept {
+            return m_state == e_state::open;
+        }
+
+        /**
+         * @brief Checks if permessage-deflate was negotiated.
+         */
+        [[nodiscard]] CLUEAPI_INLINE bool uses_deflate() const noexcept {
+            return m_uses_deflate;
+        }
+
+        /**
+         * @brief Gets the number of bytes queued or being written.
+         */
+        [[nodiscard]] CLUEAPI_INLINE std::size_t queued_bytes() const noexcept {
+            return m_queued_bytes;
+        }
+
+        /**
+         * @brief Gets the executor the session runs on.
+         */
+        [[nodiscard]] CLUEAPI_INLINE const boost::asio::any_io_executor& executor()
+            const noexcept {
+            return m_executor;
+        }
+
+       private:
+        /**
+         * @enum e_state
+         *
+         * @brief The state of a session.
+         */
+        enum struct e_state : std::uint8_t {
+            /**
+             * @brief Messages are sent and read.
+             */
+            open,
+
+            /**
+             * @brief A close frame was queued, nothing else is sent.
+             */
+            closing,
+
+            /**
+             * @brief The connection failed, was dropped, or the session was detached from it.
+             */
+            closed
+        };
+
+        /**
+         * @brief Queues a frame, starting the writer if it is idle.
+         */
+        void enqueue(shared_frame_t frame);
+
+        /**
+         * @brief Drops the connection, e.g. for a slow consumer.
+         */
+        void drop();
+
+        /**
+         * @brief Writes the queued frames until the queue is empty.
+         */
+        shared::awaitable_t<void> write_loop(std::shared_ptr<session_t> self);
+
+        /**
+         * @brief Reads until the buffer holds at least a number of bytes.
+         */
+        exceptions::expected_awaitable_t<void> fill(std::size_t size);
+
+        /**
+         * @brief Appends the unmasked payload of a frame to a string.
+         */
+        exceptions::expected_awaitable_t<void> read_payload(
+            std::string& out, const frame_header_t& header);
+
+        /**
+         * @brief Closes the session after an error of the client.
+         *
+         * @param code The status code of the close frame.
+         */
+        void fail(std::uint16_t code);
+
+       private:
+        /**
+         * @brief The socket of the connection.
+         */
+        boost::asio::ip::tcp::socket& m_socket;
+
+        /**
+         * @brief The read buffer of the connection.
+         */
+        shared::pooled_buffer_t& m_buffer;
+
+        /**
+         * @brief The WebSocket settings.
+         */
+        cfg::cfg_t::websocket_t m_cfg;
+
+        /**
+         * @brief The executor of the socket.
+         */
+        boost::asio::any_io_executor m_executor;
+
+        /**
+         * @brief Woken when the writer stops, and armed with the close timeout.
+         */
+        boost::asio::steady_timer m_drained;
+
+        /**
+         * @brief If true, permessage-deflate was negotiated.
+         */
+        bool m_uses_deflate{};
+
+        /**
+         * @brief The state of the session.
+         */
+        e_state m_state{e_state::open};
+
+        /**
+         * @brief If true, the writer is running.
+         */
+        bool m_is_writing{};
+
+        /**
+         * @brief If true, no frame is read anymore: the client closed or broke the protocol.
+         */
+        bool m_is_read_done{};
+
+        /**
+         * @brief If true, the message being read continues in the next frames.
+         */
+        bool m_is_fragmented{};
+
+        /**
+         * @brief If true, the message being read is compressed.
+         */
+        bool m_is_compressed{};
+
+        /**
+         * @brief The opcode of the message being read.
+         */
+        e_opcode m_opcode{e_opcode::text};
+
+        /**
+         * @brief The frames waiting for the writer.
+         */
+        std::vector<shared_frame_t> m_queue;
+
+        /**
+         * @brief The frames being written.
+         */
+        std::vector<shared_frame_t> m_in_flight;
+
+        /**
+         * @brief The buffers of the gathered write.
+         */
+        std::vector<boost::asio::const_buffer> m_buffers;
+
+        /**
+         * @brief The size of the frames queued or being written.
+         */
+        std::size_t m_queued_bytes{};
+
+        /**
+         * @brief The payload of the message being read.
+         */
+        std::string m_message;
+
+        /**
+         * @brief The decompressed payload of the last compressed message.
+         */
+        std::string m_inflated;
+
+        /**
+         * @brief The payload of the last control frame.
+         */
+        std::string m_control;
+    };
+
+    /**
+     * @brief Type alias for a shared session.
+     */
+    using session_ptr_t = std::shared_ptr<session_t>;
+
+    /**
+     * @brief Type alias for the handler of a WebSocket route.
+     *
+     * @details Called once the handshake is done, with the context of the upgrade request and
+     * the session. The connection is closed when the handler returns.
+     */
+    using handler_t = std::function<shared::awaitable_t<void>(http::ctx_t, session_ptr_t)>;
+} // namespace clueapi::websocket
+
+#endif // CLUEAPI_WEBSOCKET_SESSION_HXX
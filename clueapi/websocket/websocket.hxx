@@ -0,0 +1,31 @@
+/**
+ * @file websocket.hxx
+ *
+ * @brief The public header of the WebSocket support.
+ *
+ * @details A WebSocket route is added with `c_clueapi::add_websocket()`. The server answers the
+ * upgrade request, and its handler then runs with the connection as a `session_t`:
+ *
+ * @code
+ * api.add_websocket(
+ *     "/chat/{room}",
+ *     [&hub](http::ctx_t ctx, websocket::session_ptr_t session) -> shared::awaitable_t<void> {
+ *         const std::string room{ctx.params().at("room")};
+ *
+ *         hub.subscribe(room, session);
+ *
+ *         while (auto message = co_await session->read())
+ *             hub.publish(room, message->m_data);
+ *     });
+ * @endcode
+ */
+
+#ifndef CLUEAPI_WEBSOCKET_HXX
+#define CLUEAPI_WEBSOCKET_HXX
+
+#include "clueapi/websocket/deflate/deflate.hxx"
+#include "clueapi/websocket/frame/frame.hxx"
+#include "clueapi/websocket/hub/hub.hxx"
+#include "clueapi/websocket/session/session.hxx"
+
+#endif // CLUEAPI_WEBSOCKET_HXX
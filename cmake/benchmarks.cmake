@@ -0,0 +1,38 @@
+if(NOT CLUEAPI_BUILD_BENCHMARKS)
+    return()
+endif()
+
+FetchContent_Declare(
+    benchmark
+    URL https://github.com/google/benchmark/archive/refs/tags/v1.9.1.zip
+    DOWNLOAD_EXTRACT_TIMESTAMP TRUE
+)
+
+set(BENCHMARK_ENABLE_TESTING OFF CACHE BOOL "" FORCE)
+set(BENCHMARK_ENABLE_GTEST_TESTS OFF CACHE BOOL "" FORCE)
+set(BENCHMARK_ENABLE_INSTALL OFF CACHE BOOL "" FORCE)
+
+FetchContent_MakeAvailable(benchmark)
+
+set(
+    CLUEAPI_BENCHMARK_SOURCES
+    benchmarks/route/route.cxx
+    benchmarks/http/multipart/multipart.cxx
+    benchmarks/http/types/cookie.cxx
+    benchmarks/http/chunks/chunks.cxx
+    benchmarks/http/mime/mime.cxx
+    benchmarks/shared/json_traits/json_traits.cxx
+    benchmarks/e2e/e2e.cxx
+)
+
+add_executable(clueapi_benchmarks ${CLUEAPI_BENCHMARK_SOURCES})
+
+configure_target(clueapi_benchmarks
+    ENABLE_IO_URING ON
+)
+
+target_link_libraries(clueapi_benchmarks
+    PRIVATE
+    clueapi
+    benchmark::benchmark_main
+)
@@ -21,6 +21,7 @@ install(DIRECTORY ${PROJECT_SOURCE_DIR}/clueapi/
     PATTERN "modules/logging/*" EXCLUDE
     PATTERN "modules/dotenv/*" EXCLUDE
     PATTERN "modules/redis/*" EXCLUDE
+    PATTERN "modules/compression/*" EXCLUDE
     PATTERN "shared/thirdparty/nlohmann_json/*" EXCLUDE
 )
 
@@ -62,6 +63,13 @@ if(CLUEAPI_USE_REDIS_MODULE)
     )
 endif()
 
+if(CLUEAPI_USE_COMPRESSION_MODULE)
+    install(DIRECTORY ${PROJECT_SOURCE_DIR}/clueapi/modules/compression/
+        DESTINATION ${CLUEAPI_INSTALL_INCLUDEDIR}/modules/compression
+        FILES_MATCHING PATTERN "*.h" PATTERN "*.hxx" PATTERN "*.hpp"
+    )
+endif()
+
 install(EXPORT clueapi-targets
     FILE clueapi-targets.cmake
     NAMESPACE clueapi::
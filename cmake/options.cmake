@@ -26,6 +26,14 @@ if(NOT DEFINED CLUEAPI_USE_CUSTOM_JSON)
     option(CLUEAPI_USE_CUSTOM_JSON "Enable custom json support" OFF)
 endif()
 
+if(NOT DEFINED CLUEAPI_CUSTOM_JSON_TRAITS)
+    set(CLUEAPI_CUSTOM_JSON_TRAITS "" CACHE STRING "Header defining clueapi::shared::json_traits_t, used with CLUEAPI_USE_CUSTOM_JSON")
+endif()
+
+if(NOT DEFINED CLUEAPI_USE_SIMDJSON)
+    option(CLUEAPI_USE_SIMDJSON "Enable the simdjson reader for request bodies" OFF)
+endif()
+
 if(NOT DEFINED CLUEAPI_USE_LOGGING_MODULE)
     option(CLUEAPI_USE_LOGGING_MODULE "Enable logging module support" ON)
 endif()
@@ -38,10 +46,26 @@ if(NOT DEFINED CLUEAPI_USE_REDIS_MODULE)
     option(CLUEAPI_USE_REDIS_MODULE "Enable redis module support" ON)
 endif()
 
+if(NOT DEFINED CLUEAPI_USE_COMPRESSION_MODULE)
+    option(CLUEAPI_USE_COMPRESSION_MODULE "Enable compression module support (zlib, optional brotli and zstd)" OFF)
+endif()
+
+if(NOT DEFINED CLUEAPI_USE_HTTP2)
+    option(CLUEAPI_USE_HTTP2 "Enable HTTP/2 (h2c with prior knowledge) through nghttp2" OFF)
+endif()
+
+if(NOT DEFINED CLUEAPI_USE_IO_URING)
+    option(CLUEAPI_USE_IO_URING "Use io_uring as the I/O backend for sockets and files (Linux only)" OFF)
+endif()
+
 if(NOT DEFINED CLUEAPI_BUILD_TESTS)
     option(CLUEAPI_BUILD_TESTS "Build tests" OFF)
 endif()
 
+if(NOT DEFINED CLUEAPI_BUILD_BENCHMARKS)
+    option(CLUEAPI_BUILD_BENCHMARKS "Build benchmarks" OFF)
+endif()
+
 if(NOT DEFINED CLUEAPI_OPTIMIZED_LOG_LEVEL)
     set(CLUEAPI_OPTIMIZED_LOG_LEVEL INFO CACHE STRING "Optimized log level")
 endif()
@@ -71,8 +95,13 @@ endif()
 message(STATUS "CLUEAPI configuration summary:")
 message(STATUS "  CLUEAPI_USE_NLOHMANN_JSON = ${CLUEAPI_USE_NLOHMANN_JSON}")
 message(STATUS "  CLUEAPI_USE_CUSTOM_JSON = ${CLUEAPI_USE_CUSTOM_JSON}")
+message(STATUS "  CLUEAPI_USE_SIMDJSON = ${CLUEAPI_USE_SIMDJSON}")
 message(STATUS "  CLUEAPI_USE_LOGGING_MODULE = ${CLUEAPI_USE_LOGGING_MODULE}")
 message(STATUS "  CLUEAPI_USE_DOTENV_MODULE = ${CLUEAPI_USE_DOTENV_MODULE}")
 message(STATUS "  CLUEAPI_USE_REDIS_MODULE = ${CLUEAPI_USE_REDIS_MODULE}")
+message(STATUS "  CLUEAPI_USE_COMPRESSION_MODULE = ${CLUEAPI_USE_COMPRESSION_MODULE}")
+message(STATUS "  CLUEAPI_USE_HTTP2 = ${CLUEAPI_USE_HTTP2}")
+message(STATUS "  CLUEAPI_USE_IO_URING = ${CLUEAPI_USE_IO_URING}")
 message(STATUS "  CLUEAPI_BUILD_TESTS = ${CLUEAPI_BUILD_TESTS}")
+message(STATUS "  CLUEAPI_BUILD_BENCHMARKS = ${CLUEAPI_BUILD_BENCHMARKS}")
 message(STATUS "  CLUEAPI_OPTIMIZED_LOG_LEVEL = ${CLUEAPI_OPTIMIZED_LOG_LEVEL} (${CLUEAPI_LOG_LEVEL_NUM})")
\ No newline at end of file
@@ -20,4 +20,38 @@ if(NOT TARGET Threads::Threads)
     if(NOT Threads_FOUND)
         message(FATAL_ERROR "Threads not found")
     endif()
-endif()
\ No newline at end of file
+endif()
+
+if(CLUEAPI_USE_SIMDJSON)
+    if(NOT TARGET simdjson::simdjson)
+        find_package(simdjson REQUIRED)
+
+        if(NOT simdjson_FOUND)
+            message(FATAL_ERROR "simdjson not found")
+        endif()
+    endif()
+endif()
+
+if(CLUEAPI_USE_COMPRESSION_MODULE)
+    if(NOT TARGET ZLIB::ZLIB)
+        find_package(ZLIB REQUIRED)
+
+        if(NOT ZLIB_FOUND)
+            message(FATAL_ERROR "ZLIB not found")
+        endif()
+    endif()
+
+    find_package(PkgConfig QUIET)
+
+    if(PKG_CONFIG_FOUND)
+        pkg_check_modules(BROTLIENC IMPORTED_TARGET libbrotlienc QUIET)
+
+        pkg_check_modules(ZSTD IMPORTED_TARGET libzstd QUIET)
+    endif()
+endif()
+
+if(CLUEAPI_USE_HTTP2)
+    find_package(PkgConfig REQUIRED)
+
+    pkg_check_modules(NGHTTP2 IMPORTED_TARGET libnghttp2 REQUIRED)
+endif()
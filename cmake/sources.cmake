@@ -14,4 +14,14 @@ endif()
 
 if(NOT CLUEAPI_USE_REDIS_MODULE)
     list(FILTER CLUEAPI_SOURCES EXCLUDE REGEX "/modules/redis/")
+endif()
+
+if(NOT CLUEAPI_USE_COMPRESSION_MODULE)
+    list(FILTER CLUEAPI_SOURCES EXCLUDE REGEX "/modules/compression/")
+endif()
+
+if(NOT CLUEAPI_USE_HTTP2)
+    list(FILTER CLUEAPI_SOURCES EXCLUDE REGEX "/server/http2/")
+
+    list(FILTER CLUEAPI_SOURCES EXCLUDE REGEX "/http2_handler/")
 endif()
\ No newline at end of file
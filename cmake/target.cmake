@@ -14,6 +14,23 @@ if(CLUEAPI_USE_NLOHMANN_JSON)
     target_compile_definitions(clueapi PUBLIC CLUEAPI_USE_NLOHMANN_JSON)
 endif()
 
+if(CLUEAPI_USE_CUSTOM_JSON)
+    if(NOT CLUEAPI_CUSTOM_JSON_TRAITS)
+        message(FATAL_ERROR "CLUEAPI_USE_CUSTOM_JSON requires CLUEAPI_CUSTOM_JSON_TRAITS")
+    endif()
+
+    target_compile_definitions(clueapi PUBLIC
+        CLUEAPI_USE_CUSTOM_JSON
+        "CLUEAPI_CUSTOM_JSON_TRAITS=${CLUEAPI_CUSTOM_JSON_TRAITS}"
+    )
+endif()
+
+if(CLUEAPI_USE_SIMDJSON)
+    target_compile_definitions(clueapi PUBLIC CLUEAPI_USE_SIMDJSON)
+
+    target_link_libraries(clueapi PUBLIC simdjson::simdjson)
+endif()
+
 if(NOT TARGET fmt::fmt)
     target_compile_definitions(clueapi PUBLIC FMT_HEADER_ONLY=1)
     
@@ -60,4 +77,32 @@ if(CLUEAPI_USE_REDIS_MODULE)
     target_compile_definitions(clueapi PUBLIC CLUEAPI_USE_REDIS_MODULE)
 endif()
 
+if(CLUEAPI_USE_COMPRESSION_MODULE)
+    target_compile_definitions(clueapi PUBLIC CLUEAPI_USE_COMPRESSION_MODULE)
+
+    target_link_libraries(clueapi PUBLIC ZLIB::ZLIB)
+
+    if(BROTLIENC_FOUND)
+        target_compile_definitions(clueapi PUBLIC CLUEAPI_HAS_BROTLI)
+
+        target_link_libraries(clueapi PUBLIC PkgConfig::BROTLIENC)
+    endif()
+
+    if(ZSTD_FOUND)
+        target_compile_definitions(clueapi PUBLIC CLUEAPI_HAS_ZSTD)
+
+        target_link_libraries(clueapi PUBLIC PkgConfig::ZSTD)
+    endif()
+
+    if(CLUEAPI_IS_TOP_LEVEL)
+        message(STATUS "Compression module: gzip, brotli=${BROTLIENC_FOUND}, zstd=${ZSTD_FOUND}")
+    endif()
+endif()
+
+if(CLUEAPI_USE_HTTP2)
+    target_compile_definitions(clueapi PUBLIC CLUEAPI_USE_HTTP2)
+
+    target_link_libraries(clueapi PUBLIC PkgConfig::NGHTTP2)
+endif()
+
 configure_target(clueapi ENABLE_IO_URING ON)
\ No newline at end of file
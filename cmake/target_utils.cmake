@@ -4,6 +4,25 @@ function(configure_target_encoding TARGET_NAME)
     )
 endfunction()
 
+function(configure_target_io_uring_backend TARGET_NAME)
+    if(NOT CLUEAPI_USE_IO_URING)
+        return()
+    endif()
+
+    # Without the epoll reactor asio runs sockets and timers on io_uring as well
+    target_compile_definitions(${TARGET_NAME} PUBLIC BOOST_ASIO_DISABLE_EPOLL=1)
+
+    if(CLUEAPI_IS_TOP_LEVEL)
+        message(STATUS "io_uring backend enabled for target: ${TARGET_NAME}")
+    endif()
+endfunction()
+
+function(configure_target_io_uring_missing TARGET_NAME)
+    if(CLUEAPI_USE_IO_URING)
+        message(FATAL_ERROR "CLUEAPI_USE_IO_URING requires liburing for target: ${TARGET_NAME}")
+    endif()
+endfunction()
+
 function(configure_target_io_uring TARGET_NAME)
     if(UNIX AND NOT APPLE)
         find_package(PkgConfig QUIET)
@@ -20,6 +39,8 @@ function(configure_target_io_uring TARGET_NAME)
                 target_link_libraries(${TARGET_NAME} PRIVATE ${URING_LIBRARIES})
 
                 target_compile_definitions(${TARGET_NAME} PUBLIC BOOST_ASIO_HAS_IO_URING=1)
+
+                configure_target_io_uring_backend(${TARGET_NAME})
             else()
                 if(CLUEAPI_IS_TOP_LEVEL)
                     message(STATUS "Liburing not found via pkg-config, trying direct link for target: ${TARGET_NAME}")
@@ -35,21 +56,29 @@ function(configure_target_io_uring TARGET_NAME)
                     if(CLUEAPI_IS_TOP_LEVEL)
                         message(STATUS "io_uring support enabled via direct link for target: ${TARGET_NAME}")
                     endif()
+
+                    configure_target_io_uring_backend(${TARGET_NAME})
                 else()
                     if(CLUEAPI_IS_TOP_LEVEL)
                         message(STATUS "io_uring not available for target: ${TARGET_NAME}")
                     endif()
+
+                    configure_target_io_uring_missing(${TARGET_NAME})
                 endif()
             endif()
         else()
             if(CLUEAPI_IS_TOP_LEVEL)
                 message(STATUS "PkgConfig not found, io_uring support disabled for target: ${TARGET_NAME}")
             endif()
+
+            configure_target_io_uring_missing(${TARGET_NAME})
         endif()
     else()
         if(CLUEAPI_IS_TOP_LEVEL)
             message(STATUS "io_uring not available on this platform for target: ${TARGET_NAME}")
         endif()
+
+        configure_target_io_uring_missing(${TARGET_NAME})
     endif()
 endfunction()
 
@@ -25,11 +25,15 @@ set(
     tests/main.cxx
     tests/exceptions/exceptions.cxx
     tests/route/route.cxx
+    tests/route/route_template.cxx
     tests/middleware/middleware.cxx
+    tests/middleware/static_files.cxx
+    tests/middleware/response_cache.cxx
     tests/http/comparators/comparators.cxx
     tests/http/sv_hash/sv_hash.cxx
     tests/http/mime/mime.cxx
     tests/http/chunks/chunks.cxx
+    tests/http/range/range.cxx
     tests/http/multipart/multipart.cxx
     tests/http/ctx/ctx.cxx
     tests/http/types/file.cxx
@@ -38,12 +42,38 @@ set(
     tests/http/types/status.cxx
     tests/http/types/request.cxx
     tests/http/types/response.cxx
+    tests/http/types/params.cxx
     tests/shared/json_traits/json_traits.cxx
+    tests/shared/json_writer/json_writer.cxx
     tests/shared/io_ctx_pool/io_ctx_pool.cxx
+    tests/shared/timer_wheel/timer_wheel.cxx
+    tests/shared/arena/arena.cxx
+    tests/shared/date_cache/date_cache.cxx
+    tests/shared/metrics/metrics.cxx
+    tests/shared/thread_pool/thread_pool.cxx
+    tests/shared/buffer_pool/buffer_pool.cxx
+    tests/shared/tracing/tracing.cxx
+    tests/server/client_pool/client_pool.cxx
+    tests/server/access_log/access_log.cxx
+    tests/server/tracer/tracer.cxx
+    tests/server/tls/tls.cxx
+    tests/websocket/frame.cxx
+    tests/websocket/session.cxx
+    tests/sse/event.cxx
+    tests/sse/hub.cxx
 )
 
+if(NOT WIN32)
+    list(APPEND CLUEAPI_TEST_SOURCES tests/server/supervisor/supervisor.cxx)
+endif()
+
+if(CLUEAPI_USE_SIMDJSON)
+    list(APPEND CLUEAPI_TEST_SOURCES tests/shared/json_reader/json_reader.cxx)
+endif()
+
 if(CLUEAPI_USE_LOGGING_MODULE)
     list(APPEND CLUEAPI_TEST_SOURCES tests/modules/logging/logging.cxx)
+    list(APPEND CLUEAPI_TEST_SOURCES tests/modules/logging/buffer.cxx)
     list(APPEND CLUEAPI_TEST_SOURCES tests/modules/logging/file_logger.cxx)
 endif()
 
@@ -54,6 +84,16 @@ endif()
 if(CLUEAPI_USE_REDIS_MODULE)
     list(APPEND CLUEAPI_TEST_SOURCES tests/modules/redis/redis.cxx)
     list(APPEND CLUEAPI_TEST_SOURCES tests/modules/redis/connection/connection.cxx)
+    list(APPEND CLUEAPI_TEST_SOURCES tests/modules/redis/near_cache/near_cache.cxx)
+    list(APPEND CLUEAPI_TEST_SOURCES tests/modules/redis/pool/pool.cxx)
+endif()
+
+if(CLUEAPI_USE_COMPRESSION_MODULE)
+    list(APPEND CLUEAPI_TEST_SOURCES tests/modules/compression/compression.cxx)
+endif()
+
+if(CLUEAPI_USE_HTTP2)
+    list(APPEND CLUEAPI_TEST_SOURCES tests/server/http2/http2.cxx)
 endif()
 
 add_executable(clueapi_tests ${CLUEAPI_TEST_SOURCES})
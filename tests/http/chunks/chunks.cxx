@@ -8,10 +8,12 @@
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/ip/address_v4.hpp>
 #include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read.hpp>
 #include <boost/asio/use_awaitable.hpp>
 #include <boost/system/error_code.hpp>
 #include <memory>
 #include <string>
+#include <string_view>
 
 #include "clueapi/exceptions/wrap/wrap.hxx"
 #include "clueapi/http/chunks/chunks.hxx"
@@ -85,6 +87,22 @@ class chunk_writer_tests : public ::testing::Test {
         co_return std::string(buffer.data(), bytes_read);
     }
 
+    boost::asio::awaitable<std::string> read_exactly_from_socket(std::size_t size) {
+        std::string buffer(size, '\0');
+
+        const auto bytes_read = co_await boost::asio::async_read(
+            *server_socket,
+
+            boost::asio::buffer(buffer),
+
+            boost::asio::use_awaitable
+        );
+
+        buffer.resize(bytes_read);
+
+        co_return buffer;
+    }
+
     boost::asio::io_context io_context;
 
     std::unique_ptr<boost::asio::ip::tcp::acceptor> acceptor;
@@ -362,4 +380,97 @@ TEST_F(chunk_writer_tests, writer_closed_reflects_socket_state) {
     client_socket->close();
 
     EXPECT_TRUE(writer.writer_closed());
-}
\ No newline at end of file
+}
+
+TEST_F(chunk_writer_tests, coalesce_small_chunks) {
+    using clueapi::http::chunks::chunk_writer_t;
+    using clueapi::http::chunks::coalesce_t;
+
+    boost::asio::co_spawn(
+        io_context,
+
+        [&]() -> boost::asio::awaitable<void> {
+            chunk_writer_t writer(*client_socket, coalesce_t{1024, std::chrono::hours{1}});
+
+            EXPECT_EXPECTED(co_await writer.write_chunk("data: 1\n\n"));
+
+            EXPECT_EXPECTED(co_await writer.write_chunk("data: 2\n\n"));
+
+            EXPECT_EQ(writer.pending_bytes(), 28);
+
+            EXPECT_EXPECTED(co_await writer.flush());
+
+            EXPECT_EQ(writer.pending_bytes(), 0);
+
+            co_return;
+        },
+
+        boost::asio::detached
+    );
+
+    boost::asio::co_spawn(
+        io_context,
+
+        [&]() -> boost::asio::awaitable<void> {
+            constexpr std::string_view expected{"9\r\ndata: 1\n\n\r\n9\r\ndata: 2\n\n\r\n"};
+
+            EXPECT_EQ(co_await read_exactly_from_socket(expected.size()), expected);
+
+            co_return;
+        },
+
+        boost::asio::detached
+    );
+
+    io_context.run();
+}
+
+TEST_F(chunk_writer_tests, coalesce_writes_pending_chunks_with_a_large_one) {
+    using clueapi::http::chunks::chunk_writer_t;
+    using clueapi::http::chunks::coalesce_t;
+
+    boost::asio::co_spawn(
+        io_context,
+
+        [&]() -> boost::asio::awaitable<void> {
+            chunk_writer_t writer(*client_socket);
+
+            writer.coalesce(coalesce_t{16, std::chrono::hours{1}});
+
+            EXPECT_EXPECTED(co_await writer.write_chunk("0123456789"));
+
+            EXPECT_EQ(writer.pending_bytes(), 15);
+
+            EXPECT_EXPECTED(co_await writer.write_chunk("abcdef"));
+
+            EXPECT_EQ(writer.pending_bytes(), 0);
+
+            EXPECT_EXPECTED(co_await writer.write_chunk("x"));
+
+            EXPECT_EXPECTED(co_await writer.write_final_chunk());
+
+            co_return;
+        },
+
+        boost::asio::detached
+    );
+
+    boost::asio::co_spawn(
+        io_context,
+
+        [&]() -> boost::asio::awaitable<void> {
+            // The writes may arrive merged or split, only the stream is checked
+            constexpr std::string_view expected{
+                "A\r\n0123456789\r\n6\r\nabcdef\r\n"
+                "1\r\nx\r\n0\r\n\r\n"};
+
+            EXPECT_EQ(co_await read_exactly_from_socket(expected.size()), expected);
+
+            co_return;
+        },
+
+        boost::asio::detached
+    );
+
+    io_context.run();
+}
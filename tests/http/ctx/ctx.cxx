@@ -11,6 +11,7 @@
 #include <fstream>
 #include <ios>
 #include <map>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <utility>
@@ -208,4 +209,21 @@ TEST_F(http_ctx_tests, malformed_body_handled_gracefully) {
         EXPECT_TRUE(ctx.fields().empty());
         EXPECT_TRUE(ctx.files().empty());
     });
-}
\ No newline at end of file
+}
+TEST_F(http_ctx_tests, shared_request_is_not_copied) {
+    using namespace clueapi::http;
+
+    run_test([]() -> boost::asio::awaitable<void> {
+        auto req = std::make_shared<types::request_t>();
+
+        req->body() = "large body";
+
+        const auto* body_data = req->body().data();
+
+        auto ctx = co_await ctx_t::make_awaitable(req, {}, {});
+
+        EXPECT_EQ(&ctx.request(), req.get());
+        EXPECT_EQ(ctx.request().body().data(), body_data);
+        EXPECT_EQ(ctx.request().weak_from_this().lock(), req);
+    });
+}
@@ -43,4 +43,16 @@ TEST_F(mime_tests, get_mime_type_from_path) {
     EXPECT_EQ(mime_t::mime_type(boost::filesystem::path("")), "application/octet-stream");
 
     EXPECT_EQ(mime_t::mime_type(boost::filesystem::path(".config")), "application/octet-stream");
-}
\ No newline at end of file
+}
+TEST_F(mime_tests, get_mime_type_from_extension) {
+    using clueapi::http::mime::mime_t;
+
+    EXPECT_EQ(mime_t::from_extension(".CSS"), "text/css");
+    EXPECT_EQ(mime_t::from_extension(".json"), "application/json");
+
+    EXPECT_EQ(mime_t::from_extension("."), "application/octet-stream");
+    EXPECT_EQ(mime_t::from_extension(".averyveryverylongextension"), "application/octet-stream");
+
+    EXPECT_EQ(mime_t::mime_type(boost::filesystem::path("/srv/v1.2/app.min.JS")), "application/javascript");
+    EXPECT_EQ(mime_t::mime_type(boost::filesystem::path("/srv/v1.2/README")), "application/octet-stream");
+}
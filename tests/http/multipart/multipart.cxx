@@ -6,17 +6,22 @@
 #include <boost/asio/io_context.hpp>
 #include <boost/filesystem/operations.hpp>
 #include <boost/filesystem/path.hpp>
+#include <algorithm>
+#include <cstddef>
 #include <functional>
 #include <fstream>
 #include <ios>
 #include <iostream>
 #include <map>
+#include <random>
 #include <sstream>
+#include <string_view>
 #include <string>
 #include <utility>
 
 #include "clueapi/exceptions/wrap/wrap.hxx"
 #include "clueapi/http/multipart/multipart.hxx"
+#include "clueapi/http/types/body_stream/body_stream.hxx"
 #include "clueapi/http/types/file/file.hxx"
 
 using namespace clueapi::http;
@@ -415,4 +420,101 @@ TEST_F(multipart_parser_tests, parse_file_fails_on_unexpected_eof) {
 
         EXPECT_NE(result.error().find("Field boundary not found. EOF reached"), std::string::npos);
     });
-}
\ No newline at end of file
+}
+TEST_F(multipart_parser_tests, parse_stream_in_small_chunks) {
+    struct chunked_stream_t final : body_stream_t {
+        explicit chunked_stream_t(std::string body, std::size_t chunk_size)
+            : m_body(std::move(body)), m_chunk_size(chunk_size) {}
+
+        clueapi::exceptions::expected_awaitable_t<std::string_view> read_chunk() override {
+            const auto size = std::min(m_chunk_size, m_body.size() - m_offset);
+
+            std::string_view chunk{m_body.data() + m_offset, size};
+
+            m_offset += size;
+
+            co_return chunk;
+        }
+
+        bool is_done() const noexcept override { return m_offset == m_body.size(); }
+
+        std::size_t bytes_read() const noexcept override { return m_offset; }
+
+        std::string m_body;
+
+        std::size_t m_chunk_size;
+
+        std::size_t m_offset{};
+    };
+
+    run_test([this]() -> boost::asio::awaitable<void> {
+        const std::string file_content(300, 'F');
+
+        chunked_stream_t stream{
+            create_multipart_body(
+                boundary_, {{"field", "value"}}, {{"file", {"stream.bin", file_content}}}
+            ),
+            7};
+
+        parser_t::cfg_t cfg{.m_boundary = boundary_, .m_chunk_size = 16};
+
+        parser_t parser(cfg);
+
+        auto result = co_await parser.parse_stream(stream);
+
+        EXPECT_TRUE(result.has_value()) << result.error();
+
+        auto value = std::move(result).value();
+
+        EXPECT_TRUE(stream.is_done());
+
+        EXPECT_EQ(value.m_fields.at("field"), "value");
+
+        EXPECT_EQ(value.m_files.at("file").name(), "stream.bin");
+
+        EXPECT_EQ(value.m_files.at("file").size(), file_content.size());
+    });
+}
+
+TEST(boundary_searcher, matches_string_view_find) {
+    const std::string boundary{"\r\n--boundary-7f3a"};
+
+    const multipart::detail::boundary_searcher_t searcher{boundary};
+
+    std::mt19937 rng{42};
+
+    // A small alphabet makes partial matches of the boundary frequent
+    const std::string_view alphabet{"\r\n-b7"};
+
+    for (std::size_t size : {0u, 1u, 16u, 17u, 31u, 33u, 64u, 257u, 1024u}) {
+        std::string haystack(size, '\0');
+
+        for (auto& c : haystack)
+            c = alphabet[rng() % alphabet.size()];
+
+        if (size >= boundary.size() * 2)
+            haystack.replace(rng() % (size - boundary.size()), boundary.size(), boundary);
+
+        for (std::size_t from = 0; from <= size; from += 1 + size / 8) {
+            EXPECT_EQ(
+                searcher.find(haystack, from), std::string_view{haystack}.find(boundary, from))
+                << "size " << size << ", from " << from;
+        }
+    }
+}
+
+TEST(boundary_searcher, resumes_across_appended_data) {
+    const multipart::detail::boundary_searcher_t searcher{"\r\n--abc"};
+
+    std::string buffer{"xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx\r\n-"};
+
+    EXPECT_EQ(searcher.find(buffer), std::string_view::npos);
+
+    const auto resume = searcher.resume_from(buffer.size());
+
+    const auto expected = buffer.size() - 3;
+
+    buffer.append("-abc--");
+
+    EXPECT_EQ(searcher.find(buffer, resume), expected);
+}
@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+
+#include "clueapi/http/range/range.hxx"
+#include "clueapi/http/types/request/request.hxx"
+
+class range_tests : public ::testing::Test {};
+
+TEST_F(range_tests, parse_single_ranges) {
+    using clueapi::http::range::e_range_status;
+    using clueapi::http::range::range_t;
+
+    {
+        const auto [status, range] = range_t::parse("bytes=0-99", 1000);
+
+        EXPECT_EQ(status, e_range_status::satisfiable);
+        EXPECT_EQ(range.m_first, 0);
+        EXPECT_EQ(range.m_last, 99);
+        EXPECT_EQ(range.length(), 100);
+    }
+
+    {
+        const auto [status, range] = range_t::parse("bytes=900-", 1000);
+
+        EXPECT_EQ(status, e_range_status::satisfiable);
+        EXPECT_EQ(range.m_first, 900);
+        EXPECT_EQ(range.m_last, 999);
+    }
+
+    {
+        const auto [status, range] = range_t::parse("bytes=-300", 1000);
+
+        EXPECT_EQ(status, e_range_status::satisfiable);
+        EXPECT_EQ(range.m_first, 700);
+        EXPECT_EQ(range.m_last, 999);
+    }
+
+    {
+        const auto [status, range] = range_t::parse("bytes=500-5000", 1000);
+
+        EXPECT_EQ(status, e_range_status::satisfiable);
+        EXPECT_EQ(range.m_last, 999);
+    }
+
+    {
+        const auto [status, range] = range_t::parse("bytes=-5000", 1000);
+
+        EXPECT_EQ(status, e_range_status::satisfiable);
+        EXPECT_EQ(range.m_first, 0);
+        EXPECT_EQ(range.m_last, 999);
+    }
+}
+
+TEST_F(range_tests, parse_unusable_ranges) {
+    using clueapi::http::range::e_range_status;
+    using clueapi::http::range::range_t;
+
+    EXPECT_EQ(range_t::parse("bytes=1000-", 1000).first, e_range_status::unsatisfiable);
+    EXPECT_EQ(range_t::parse("bytes=-0", 1000).first, e_range_status::unsatisfiable);
+    EXPECT_EQ(range_t::parse("bytes=0-0", 0).first, e_range_status::unsatisfiable);
+
+    EXPECT_EQ(range_t::parse("bytes=0-1,5-9", 1000).first, e_range_status::none);
+    EXPECT_EQ(range_t::parse("bytes=9-5", 1000).first, e_range_status::none);
+    EXPECT_EQ(range_t::parse("items=0-5", 1000).first, e_range_status::none);
+    EXPECT_EQ(range_t::parse("bytes=abc", 1000).first, e_range_status::none);
+    EXPECT_EQ(range_t::parse("", 1000).first, e_range_status::none);
+}
+
+TEST_F(range_tests, entity_tag_preconditions) {
+    using clueapi::http::range::range_t;
+
+    EXPECT_TRUE(range_t::none_match("\"abc\"", "\"abc\""));
+    EXPECT_TRUE(range_t::none_match("W/\"abc\"", "\"abc\""));
+    EXPECT_TRUE(range_t::none_match("\"x\", \"abc\"", "\"abc\""));
+    EXPECT_TRUE(range_t::none_match("*", "\"abc\""));
+    EXPECT_FALSE(range_t::none_match("\"abd\"", "\"abc\""));
+    EXPECT_FALSE(range_t::none_match("\"abc\"", ""));
+
+    EXPECT_TRUE(range_t::if_range("\"abc\"", "\"abc\""));
+    EXPECT_FALSE(range_t::if_range("W/\"abc\"", "\"abc\""));
+    EXPECT_FALSE(range_t::if_range("\"abd\"", "\"abc\""));
+    EXPECT_FALSE(range_t::if_range("Wed, 21 Oct 2015 07:28:00 GMT", "\"abc\""));
+}
+
+TEST_F(range_tests, select_file_responses) {
+    using clueapi::http::range::range_t;
+    using clueapi::http::types::method_t;
+    using clueapi::http::types::request_t;
+
+    const auto make_request = [](method_t::e_method method, std::string_view name, std::string_view value) {
+        request_t request{};
+
+        request.method() = method;
+
+        if (!name.empty())
+            request.add_header(name, value);
+
+        return request;
+    };
+
+    {
+        const auto selection = range_t::select(make_request(method_t::get, "", ""), "\"abc\"", 1000);
+
+        EXPECT_EQ(selection.m_status, 200u);
+        EXPECT_EQ(selection.m_length, 1000u);
+    }
+
+    {
+        const auto selection = range_t::select(make_request(method_t::head, "If-None-Match", "\"abc\""), "\"abc\"", 1000);
+
+        EXPECT_EQ(selection.m_status, 304u);
+        EXPECT_EQ(selection.m_length, 0u);
+    }
+
+    {
+        const auto selection = range_t::select(make_request(method_t::get, "Range", "bytes=10-19"), "\"abc\"", 1000);
+
+        EXPECT_EQ(selection.m_status, 206u);
+        EXPECT_EQ(selection.m_range.m_first, 10u);
+        EXPECT_EQ(selection.m_length, 10u);
+    }
+
+    EXPECT_EQ(range_t::select(make_request(method_t::head, "Range", "bytes=10-19"), "", 1000).m_status, 200u);
+    EXPECT_EQ(range_t::select(make_request(method_t::get, "Range", "bytes=2000-"), "", 1000).m_status, 416u);
+    EXPECT_EQ(range_t::select(make_request(method_t::post, "If-None-Match", "*"), "\"abc\"", 1000).m_status, 200u);
+}
+
+TEST_F(range_tests, select_with_preconditions_taken_before_the_handler) {
+    using clueapi::http::range::preconditions_t;
+    using clueapi::http::range::range_t;
+    using clueapi::http::types::method_t;
+    using clueapi::http::types::request_t;
+
+    preconditions_t preconditions{};
+
+    {
+        request_t request{};
+
+        request.method() = method_t::get;
+
+        request.add_header("Range", "bytes=10-19");
+        request.add_header("If-Range", "\"abc\"");
+
+        preconditions.assign(request);
+
+        // A handler may move from the request once the preconditions are taken
+        [[maybe_unused]] auto moved = std::move(request);
+    }
+
+    const auto selection = range_t::select(preconditions, "\"abc\"", 1000);
+
+    EXPECT_EQ(selection.m_status, 206u);
+    EXPECT_EQ(selection.m_range.m_first, 10u);
+    EXPECT_EQ(selection.m_length, 10u);
+
+    request_t request{};
+
+    request.method() = method_t::head;
+
+    preconditions.assign(request);
+
+    EXPECT_FALSE(preconditions.m_range.has_value());
+    EXPECT_EQ(range_t::select(preconditions, "\"abc\"", 1000).m_status, 200u);
+}
@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <string_view>
+
+#include "clueapi/exceptions/exceptions.hxx"
+#include "clueapi/http/types/params/params.hxx"
+
+class params_tests : public ::testing::Test {};
+
+TEST_F(params_tests, lookup_is_case_insensitive) {
+    using clueapi::http::types::params_t;
+
+    const std::string uri{"/users/42/posts/abc"};
+
+    params_t params{};
+
+    ASSERT_TRUE(params.emplace("userId", std::string_view{uri}.substr(7, 2)));
+    ASSERT_TRUE(params.emplace("postId", std::string_view{uri}.substr(16, 3)));
+
+    EXPECT_EQ(params.size(), 2u);
+    EXPECT_EQ(params.at("userid"), "42");
+    EXPECT_EQ(params["POSTID"], "abc");
+    EXPECT_TRUE(params.contains("UserId"));
+    EXPECT_FALSE(params.contains("user"));
+    EXPECT_EQ(params["missing"], "");
+
+    // The values are views into the URI, nothing is copied
+    EXPECT_EQ(params.at("userId").data(), uri.data() + 7);
+
+    EXPECT_THROW(static_cast<void>(params.at("missing")), clueapi::exceptions::exception_t);
+}
+
+TEST_F(params_tests, to_owned_copies_the_parameters) {
+    using clueapi::http::types::params_t;
+
+    params_t::owned_t owned{};
+
+    {
+        std::string uri{"/files/report"};
+
+        params_t params{};
+
+        params.emplace("name", std::string_view{uri}.substr(7));
+
+        owned = params.to_owned();
+    }
+
+    ASSERT_EQ(owned.size(), 1u);
+    EXPECT_EQ(owned.at("NAME"), "report");
+}
+
+TEST_F(params_tests, emplace_stops_at_capacity) {
+    using clueapi::http::types::params_t;
+
+    params_t params{};
+
+    for (std::size_t i{}; i < params_t::k_capacity; i++)
+        EXPECT_TRUE(params.emplace("p", "v"));
+
+    EXPECT_FALSE(params.emplace("p", "v"));
+    EXPECT_EQ(params.size(), params_t::k_capacity);
+
+    params.clear();
+
+    EXPECT_TRUE(params.empty());
+    EXPECT_EQ(params.begin(), params.end());
+}
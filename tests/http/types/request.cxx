@@ -170,4 +170,54 @@ TEST_F(request_tests, accessors) {
     req.parse_path() = "/usr/local/bin";
 
     EXPECT_EQ(req.parse_path(), "/usr/local/bin");
-}
\ No newline at end of file
+}
+TEST_F(request_tests, flat_header_retrieval) {
+    using clueapi::http::types::e_header;
+
+    req.add_header("Content-Type", "text/plain", e_header::content_type);
+    req.add_header("X-Trace", "abc");
+    req.add_header("connection", "close");
+    req.add_header("X-Trace", "def");
+
+    EXPECT_EQ(req.header(e_header::content_type), "text/plain");
+    EXPECT_EQ(req.header(e_header::connection), "close");
+    EXPECT_FALSE(req.header(e_header::cookie).has_value());
+
+    EXPECT_EQ(req.header("x-trace"), "abc");
+    EXPECT_EQ(req.flat_headers().size(), 4u);
+
+    EXPECT_FALSE(req.keep_alive());
+}
+
+TEST_F(request_tests, flat_headers_materialize_on_demand) {
+    using clueapi::http::types::e_header;
+
+    req.add_header("Cookie", "user=johndoe", e_header::cookie);
+    req.add_header("Host", "example.com");
+
+    EXPECT_EQ(req.cookie("user"), "johndoe");
+
+    auto& hdrs = req.headers();
+
+    ASSERT_EQ(hdrs.size(), 2u);
+    EXPECT_EQ(hdrs.at("host"), "example.com");
+
+    // The owning map is authoritative once it has been built
+    hdrs["Host"] = "other.com";
+
+    EXPECT_EQ(req.header(e_header::host), "other.com");
+    EXPECT_EQ(req.header("HOST"), "other.com");
+
+    auto copy = req;
+
+    EXPECT_EQ(copy.header(e_header::host), "other.com");
+
+    req.reset();
+
+    EXPECT_TRUE(req.headers().empty());
+    EXPECT_TRUE(req.flat_headers().empty());
+
+    req.add_header("Host", "again.com");
+
+    EXPECT_EQ(req.header(e_header::host), "again.com");
+}
@@ -218,6 +218,10 @@ TEST_F(file_response_tests, for_existing_file) {
     EXPECT_TRUE(res.body().empty());
     EXPECT_TRUE(res.stream_fn());
 
+    ASSERT_TRUE(res.file().has_value());
+    EXPECT_EQ(res.file()->m_path, test_file);
+    EXPECT_EQ(res.file()->m_size, expected_size);
+
     EXPECT_EQ(res.headers().at("Content-Type"), "text/plain");
     EXPECT_EQ(res.headers().at("Content-Length"), std::to_string(expected_size));
     EXPECT_EQ(res.headers().at("ETag"), expected_etag);
@@ -230,6 +234,7 @@ TEST_F(file_response_tests, for_non_existent_file) {
 
     EXPECT_FALSE(res.is_stream());
     EXPECT_FALSE(res.stream_fn());
+    EXPECT_FALSE(res.file().has_value());
 
     EXPECT_TRUE(res.headers().empty());
 }
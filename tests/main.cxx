@@ -1,7 +1,14 @@
 #include <gtest/gtest.h>
 
+#include <boost/asio/error.hpp>
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/redirect_error.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/this_coro.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/asio/write.hpp>
 #include <boost/beast/core/flat_buffer.hpp>
 #include <boost/beast/core/tcp_stream.hpp>
 #include <boost/beast/http/field.hpp>
@@ -12,12 +19,16 @@
 #include <boost/beast/http/verb.hpp>
 #include <boost/beast/http/write.hpp>
 #include <boost/system/error_code.hpp>
+#include <atomic>
 #include <chrono>
 #include <exception>
+#include <functional>
 #include <memory>
+#include <sstream>
 #include <string>
 #include <thread>
 #include <utility>
+#include <vector>
 
 #include "clueapi/clueapi.hxx"
 #include "clueapi/exceptions/wrap/wrap.hxx"
@@ -318,6 +329,235 @@ TEST_F(clueapi_valid_tests, handles_chunked_response) {
     ASSERT_EQ(res.body(), "chunk1-part2-final");
 }
 
+class clueapi_pipelining_tests : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        clueapi::cfg_t cfg{};
+
+        {
+            cfg.m_host = "127.0.0.1";
+            cfg.m_port = "8081";
+
+            cfg.m_workers = 1;
+
+            cfg.m_server.m_acceptor.m_reuse_port = true;
+            cfg.m_server.m_acceptor.m_reuse_address = true;
+
+            // A request larger than the buffer grows it, and the buffer is cut between requests
+            cfg.m_server.m_client.m_buffer_capacity = 4096u;
+            cfg.m_server.m_client.m_buffer_pool.m_enabled = false;
+
+            cfg.m_http.m_keep_alive_enabled = true;
+
+            cfg.m_socket.m_timeout = std::chrono::seconds{5};
+
+#ifdef CLUEAPI_USE_LOGGING_MODULE
+            cfg.m_logging_cfg.m_default_level = clueapi::modules::logging::e_log_level::off;
+#endif // CLUEAPI_USE_LOGGING_MODULE
+        }
+
+        {
+            api.add_method(
+                clueapi::http::types::method_t::get,
+                "/n/{n}",
+                [](clueapi::http::ctx_t ctx) -> clueapi::http::types::response_t {
+                    return {std::string{ctx.params().at("n")}, clueapi::http::types::status_t::ok};
+                });
+
+            api.add_method(
+                clueapi::http::types::method_t::post,
+                "/echo",
+                [](clueapi::http::ctx_t ctx) -> clueapi::http::types::response_t {
+                    return {ctx.request().body(), clueapi::http::types::status_t::ok};
+                });
+
+            api.add_method(
+                clueapi::http::types::method_t::get,
+                "/slow",
+                [this](clueapi::http::ctx_t)
+                    -> clueapi::shared::awaitable_t<clueapi::http::types::response_t> {
+                    // Runs until the test releases it, the deadline only keeps a failure finite
+                    asio::steady_timer timer{
+                        co_await asio::this_coro::executor, std::chrono::seconds{10}};
+
+                    m_slow_timer.store(&timer);
+
+                    beast::error_code ec;
+
+                    co_await timer.async_wait(asio::redirect_error(asio::use_awaitable, ec));
+
+                    m_slow_timer.store(nullptr);
+
+                    m_is_slow_released = ec == asio::error::operation_aborted;
+
+                    co_return clueapi::http::types::response_t{
+                        "slow", clueapi::http::types::status_t::ok};
+                });
+        }
+
+        try {
+            api.start(cfg);
+
+            std::size_t attempts{};
+
+            while (!api.is_running()) {
+                attempts++;
+
+                if (attempts >= 5)
+                    FAIL() << "Failed to start API";
+
+                std::this_thread::sleep_for(std::chrono::milliseconds{25});
+            }
+        } catch (const std::exception& e) {
+            GTEST_SKIP() << "Failed to start API: " << e.what();
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    }
+
+    void TearDown() override {
+        try {
+            api.stop();
+
+            std::size_t attempts{};
+
+            while (!api.is_stopped()) {
+                attempts++;
+
+                if (attempts >= 5)
+                    FAIL() << "Failed to stop API";
+
+                std::this_thread::sleep_for(std::chrono::milliseconds{50});
+            }
+        } catch (const std::exception& e) {
+            GTEST_SKIP() << "Failed to stop API: " << e.what();
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    }
+
+    struct reply_t {
+        http::response<http::string_body> m_response;
+    };
+
+    // Lets the `/slow` handler return, from the thread of the test
+    void release_slow() {
+        if (auto* timer = m_slow_timer.load())
+            asio::post(timer->get_executor(), [this] {
+                if (auto* timer = m_slow_timer.load())
+                    timer->cancel();
+            });
+    }
+
+    // Writes the requests in a single write and reads their responses, calling `on_reply` with
+    // the index of each one read
+    std::vector<reply_t> pipeline(
+        const std::vector<http::request<http::string_body>>& requests,
+        const std::function<void(std::size_t)>& on_reply = {}) {
+        std::vector<reply_t> ret{};
+
+        try {
+            asio::io_context ioc;
+
+            tcp::socket socket{ioc};
+
+            socket.connect({asio::ip::make_address("127.0.0.1"), 8081});
+
+            std::string wire{};
+
+            for (auto request : requests) {
+                request.set(http::field::host, "127.0.0.1");
+
+                request.prepare_payload();
+
+                std::ostringstream out{};
+
+                out << request;
+
+                wire += out.str();
+            }
+
+            asio::write(socket, asio::buffer(wire));
+
+            beast::flat_buffer buffer;
+
+            for (std::size_t i{}; i < requests.size(); i++) {
+                reply_t reply{};
+
+                http::read(socket, buffer, reply.m_response);
+
+                ret.emplace_back(std::move(reply));
+
+                if (on_reply)
+                    on_reply(i);
+            }
+
+            beast::error_code ec;
+
+            socket.shutdown(tcp::socket::shutdown_both, ec);
+
+            socket.close(ec);
+        } catch (const std::exception& e) {
+            ADD_FAILURE() << "Pipelined requests failed: " << e.what();
+        }
+
+        return ret;
+    }
+
+    clueapi::c_clueapi api{};
+
+    // The timer the `/slow` handler waits on while it runs
+    std::atomic<asio::steady_timer*> m_slow_timer{};
+
+    // Whether the `/slow` handler was released by the test rather than its deadline
+    std::atomic<bool> m_is_slow_released{};
+};
+
+TEST_F(clueapi_pipelining_tests, answers_pipelined_requests_in_order) {
+    std::vector<http::request<http::string_body>> requests{};
+
+    // Larger than the buffer, which then holds the requests behind it when it is cut
+    requests.emplace_back(http::verb::post, "/echo", 11, std::string(32u * 1024u, 'x'));
+
+    for (std::size_t i{}; i < 8u; i++)
+        requests.emplace_back(http::verb::get, fmt::format("/n/{}", i), 11);
+
+    const auto replies = pipeline(requests);
+
+    ASSERT_EQ(replies.size(), requests.size());
+
+    EXPECT_EQ(replies[0].m_response.body(), std::string(32u * 1024u, 'x'));
+
+    for (std::size_t i{}; i < 8u; i++) {
+        EXPECT_EQ(replies[i + 1u].m_response.result(), http::status::ok);
+
+        EXPECT_EQ(replies[i + 1u].m_response.body(), fmt::format("{}", i));
+    }
+}
+
+TEST_F(clueapi_pipelining_tests, slow_handler_does_not_hold_earlier_responses) {
+    std::vector<http::request<http::string_body>> requests{};
+
+    requests.emplace_back(http::verb::get, "/n/1", 11);
+    requests.emplace_back(http::verb::get, "/slow", 11);
+    requests.emplace_back(http::verb::get, "/n/2", 11);
+
+    // The slow handler only returns once the first response is read
+    const auto replies = pipeline(requests, [this](std::size_t i) {
+        if (i == 0u)
+            release_slow();
+    });
+
+    ASSERT_EQ(replies.size(), requests.size());
+
+    EXPECT_EQ(replies[0].m_response.body(), "1");
+    EXPECT_EQ(replies[1].m_response.body(), "slow");
+    EXPECT_EQ(replies[2].m_response.body(), "2");
+
+    // The first response was written while the slow handler ran, not with its response
+    EXPECT_TRUE(m_is_slow_released);
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
 
@@ -13,6 +13,7 @@
 #include "clueapi/http/types/request/request.hxx"
 #include "clueapi/http/types/response/response.hxx"
 #include "clueapi/http/types/status/status.hxx"
+#include "clueapi/middleware/composed/composed.hxx"
 #include "clueapi/middleware/middleware.hxx"
 #include "clueapi/shared/shared.hxx"
 
@@ -72,6 +73,21 @@ class call_tracker_middleware : public c_base_middleware {
     int& counter_;
 };
 
+struct static_header_middleware {
+    template <typename _next_t>
+    shared::awaitable_t<types::response_t> handle(const types::request_t& request, _next_t next) {
+        auto response = co_await next(request);
+
+        response.headers()[header] = response.headers().contains("X-Order") ? "second" : "first";
+
+        response.headers()["X-Order"] += header;
+
+        co_return response;
+    }
+
+    std::string header;
+};
+
 class middleware_tests : public ::testing::Test {
    protected:
     boost::asio::io_context io_context;
@@ -84,20 +100,9 @@ class middleware_tests : public ::testing::Test {
         co_return res;
     }
 
-    next_t compose(
-        const std::vector<std::shared_ptr<c_base_middleware>>& middlewares, next_t final_h) {
-        auto chain = final_h;
-
-        for (auto it = middlewares.rbegin(); it != middlewares.rend(); ++it) {
-            auto& mw = *it;
-
-            chain = [mw, next_link = std::move(chain)](
-                        const types::request_t& req) -> shared::awaitable_t<types::response_t> {
-                co_return co_await mw->handle(req, next_link);
-            };
-        }
-
-        return chain;
+    pipeline_t compose(
+        const std::vector<std::shared_ptr<c_base_middleware>>& middlewares, handler_t final_h) {
+        return pipeline_t{middlewares, std::move(final_h)};
     }
 
     void run_awaitable(std::function<boost::asio::awaitable<void>()> test_func) {
@@ -239,4 +244,32 @@ TEST_F(middleware_tests, middleware_chain_proceeds_when_not_short_circuiting) {
         EXPECT_NE(hdrs.find("X-Header-A"), hdrs.end());
         EXPECT_EQ(hdrs.at("X-Header-A"), "Value-A");
     });
-}
\ No newline at end of file
+}
+TEST_F(middleware_tests, composed_middleware_runs_its_stack_in_order) {
+    run_awaitable([this]() -> boost::asio::awaitable<void> {
+        int tracker_called_count = 0;
+
+        std::vector<std::shared_ptr<c_base_middleware>> middlewares = {
+            std::make_shared<c_composed_middleware<static_header_middleware, static_header_middleware>>(
+                static_header_middleware{"X-Outer"}, static_header_middleware{"X-Inner"}),
+            std::make_shared<call_tracker_middleware>(tracker_called_count)};
+
+        auto chain = compose(
+            middlewares, [this](const types::request_t& req) { return final_handler(req); });
+
+        EXPECT_EQ(chain.size(), 2u);
+
+        types::request_t req;
+
+        auto response = co_await chain(req);
+
+        auto& hdrs = response.headers();
+
+        EXPECT_EQ(hdrs.at("X-Body"), "final handler response");
+        EXPECT_EQ(hdrs.at("X-Inner"), "first");
+        EXPECT_EQ(hdrs.at("X-Outer"), "second");
+        EXPECT_EQ(hdrs.at("X-Order"), "X-InnerX-Outer");
+
+        EXPECT_EQ(tracker_called_count, 1);
+    });
+}
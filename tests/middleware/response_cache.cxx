@@ -0,0 +1,364 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/use_awaitable.hpp>
+
+#include <fmt/format.h>
+
+#include "clueapi/http/types/request/request.hxx"
+#include "clueapi/http/types/response/response.hxx"
+#include "clueapi/middleware/middleware.hxx"
+#include "clueapi/middleware/response_cache/response_cache.hxx"
+
+using namespace clueapi;
+
+class response_cache_tests : public ::testing::Test {
+   protected:
+    using headers_t = std::vector<std::pair<std::string, std::string>>;
+
+    static http::types::request_t make_request(
+        std::string uri,
+        headers_t headers = {},
+        http::types::method_t::e_method method = http::types::method_t::get) {
+        http::types::request_t request{};
+
+        request.method() = method;
+        request.uri() = http::types::uri_t{uri};
+
+        for (const auto& [key, value] : headers)
+            request.add_header(key, value);
+
+        return request;
+    }
+
+    middleware::pipeline_t make_pipeline(const std::shared_ptr<middleware::c_response_cache>& cache) {
+        return middleware::pipeline_t{
+            {cache},
+
+            [this](const http::types::request_t& request)
+                -> shared::awaitable_t<http::types::response_t> {
+                m_calls++;
+
+                if (m_delay.count() > 0) {
+                    boost::asio::steady_timer timer{m_io_context, m_delay};
+
+                    co_await timer.async_wait(boost::asio::use_awaitable);
+                }
+
+                http::types::response_t response{
+                    fmt::format("{}#{}", request.uri(), m_calls), m_status};
+
+                for (const auto& [key, value] : m_headers)
+                    response.headers().insert_or_assign(key, value);
+
+                co_return response;
+            }};
+    }
+
+    http::types::response_t run(
+        const std::shared_ptr<middleware::c_response_cache>& cache,
+        std::string uri,
+        headers_t headers = {},
+        http::types::method_t::e_method method = http::types::method_t::get) {
+        auto pipeline = make_pipeline(cache);
+
+        auto request = make_request(std::move(uri), std::move(headers), method);
+
+        http::types::response_t ret{};
+
+        boost::asio::co_spawn(
+            m_io_context,
+
+            [&]() -> boost::asio::awaitable<void> { ret = co_await pipeline(request); },
+
+            boost::asio::detached);
+
+        m_io_context.run();
+
+        m_io_context.restart();
+
+        return ret;
+    }
+
+    // The cache measures the expiry with the time of the test, advanced instead of waited for
+    std::function<std::chrono::steady_clock::time_point()> clock() {
+        return [this] { return m_now; };
+    }
+
+    static std::string_view body(const http::types::response_t& response) {
+        if (response.shared_body())
+            return response.shared_body().m_data;
+
+        return response.body();
+    }
+
+    boost::asio::io_context m_io_context;
+
+    std::size_t m_calls{};
+
+    std::chrono::milliseconds m_delay{};
+
+    http::types::status_t::e_status m_status{http::types::status_t::ok};
+
+    headers_t m_headers{};
+
+    std::chrono::steady_clock::time_point m_now{};
+};
+
+TEST_F(response_cache_tests, serves_hits_and_revalidates) {
+    auto cache = std::make_shared<middleware::c_response_cache>();
+
+    auto first = run(cache, "/items?page=1");
+
+    EXPECT_EQ(first.status(), http::types::status_t::ok);
+    EXPECT_EQ(body(first), "/items?page=1#1");
+
+    const auto etag = first.headers().at("ETag");
+
+    auto second = run(cache, "/items?page=1");
+
+    EXPECT_EQ(body(second), "/items?page=1#1");
+    EXPECT_EQ(second.headers().at("ETag"), etag);
+    EXPECT_EQ(second.headers().at("Content-Type"), "text/plain");
+
+    EXPECT_EQ(body(run(cache, "/items?page=2")), "/items?page=2#2");
+
+    auto not_modified = run(cache, "/items?page=1", {{"If-None-Match", etag}});
+
+    EXPECT_EQ(not_modified.status(), http::types::status_t::not_modified);
+    EXPECT_EQ(not_modified.headers().at("ETag"), etag);
+    EXPECT_TRUE(body(not_modified).empty());
+
+    EXPECT_EQ(m_calls, 2u);
+    EXPECT_EQ(cache->hits(), 2u);
+    EXPECT_EQ(cache->misses(), 2u);
+    EXPECT_EQ(cache->cached_entries(), 2u);
+    EXPECT_GT(cache->cached_bytes(), 0u);
+
+    cache->clear();
+
+    EXPECT_EQ(cache->cached_entries(), 0u);
+    EXPECT_EQ(cache->cached_bytes(), 0u);
+
+    EXPECT_EQ(body(run(cache, "/items?page=1")), "/items?page=1#3");
+}
+
+TEST_F(response_cache_tests, expires_entries) {
+    auto cache = std::make_shared<middleware::c_response_cache>(
+        middleware::response_cache_cfg_t{.m_ttl = std::chrono::milliseconds{20}, .m_clock = clock()});
+
+    EXPECT_EQ(body(run(cache, "/a")), "/a#1");
+
+    m_now += std::chrono::milliseconds{19};
+
+    EXPECT_EQ(body(run(cache, "/a")), "/a#1");
+
+    m_now += std::chrono::milliseconds{1};
+
+    EXPECT_EQ(body(run(cache, "/a")), "/a#2");
+}
+
+TEST_F(response_cache_tests, keys_by_prefix_and_vary) {
+    auto cache = std::make_shared<middleware::c_response_cache>(middleware::response_cache_cfg_t{
+        .m_prefixes = {"/api/"}, .m_vary = {"Accept-Encoding"}});
+
+    EXPECT_EQ(body(run(cache, "/other")), "/other#1");
+    EXPECT_EQ(body(run(cache, "/other")), "/other#2");
+
+    EXPECT_EQ(body(run(cache, "/api/x", {{"Accept-Encoding", "gzip"}})), "/api/x#3");
+    EXPECT_EQ(body(run(cache, "/api/x", {{"accept-encoding", "gzip"}})), "/api/x#3");
+    EXPECT_EQ(body(run(cache, "/api/x", {{"Accept-Encoding", "br"}})), "/api/x#4");
+    EXPECT_EQ(body(run(cache, "/api/x")), "/api/x#5");
+
+    m_headers = {{"Vary", "Accept-Language"}};
+
+    EXPECT_EQ(body(run(cache, "/api/y")), "/api/y#6");
+    EXPECT_EQ(body(run(cache, "/api/y")), "/api/y#7");
+}
+
+TEST_F(response_cache_tests, skips_uncacheable_responses) {
+    auto cache = std::make_shared<middleware::c_response_cache>();
+
+    m_headers = {{"Cache-Control", "private, max-age=60"}};
+
+    run(cache, "/a");
+    run(cache, "/a");
+
+    m_headers = {{"Set-Cookie", "id=1"}};
+
+    run(cache, "/b");
+    run(cache, "/b");
+
+    m_headers = {};
+    m_status = http::types::status_t::not_found;
+
+    run(cache, "/c");
+    run(cache, "/c");
+
+    EXPECT_EQ(m_calls, 6u);
+    EXPECT_EQ(cache->cached_entries(), 0u);
+
+    m_status = http::types::status_t::ok;
+
+    run(cache, "/d", {}, http::types::method_t::post);
+    run(cache, "/d", {}, http::types::method_t::post);
+
+    EXPECT_EQ(m_calls, 8u);
+    EXPECT_EQ(cache->misses(), 6u);
+}
+
+TEST_F(response_cache_tests, honors_response_cache_control) {
+    auto cache = std::make_shared<middleware::c_response_cache>(
+        middleware::response_cache_cfg_t{.m_ttl = std::chrono::seconds{60}, .m_clock = clock()});
+
+    m_headers = {{"Cache-Control", "no-cache"}};
+
+    EXPECT_EQ(body(run(cache, "/a")), "/a#1");
+    EXPECT_EQ(body(run(cache, "/a")), "/a#2");
+
+    m_headers = {{"Cache-Control", "public, max-age=0"}};
+
+    EXPECT_EQ(body(run(cache, "/b")), "/b#3");
+    EXPECT_EQ(body(run(cache, "/b")), "/b#4");
+
+    EXPECT_EQ(cache->cached_entries(), 0u);
+
+    // The shared lifetime wins over the private one, and shortens the one of the cache
+    m_headers = {{"Cache-Control", "max-age=3600, s-maxage=1"}};
+
+    EXPECT_EQ(body(run(cache, "/c")), "/c#5");
+    EXPECT_EQ(body(run(cache, "/c")), "/c#5");
+
+    m_headers = {{"Cache-Control", "max-age=3600"}};
+
+    EXPECT_EQ(body(run(cache, "/d")), "/d#6");
+
+    m_now += std::chrono::seconds{1};
+
+    EXPECT_EQ(body(run(cache, "/c")), "/c#7");
+    EXPECT_EQ(body(run(cache, "/d")), "/d#6");
+}
+
+TEST_F(response_cache_tests, passes_requests_with_credentials_on) {
+    auto cache = std::make_shared<middleware::c_response_cache>();
+
+    EXPECT_EQ(body(run(cache, "/me", {{"Authorization", "Bearer a"}})), "/me#1");
+    EXPECT_EQ(body(run(cache, "/me", {{"Authorization", "Bearer b"}})), "/me#2");
+    EXPECT_EQ(body(run(cache, "/me", {{"Cookie", "id=1"}})), "/me#3");
+
+    // Not served the entry of an anonymous request either
+    EXPECT_EQ(body(run(cache, "/me")), "/me#4");
+    EXPECT_EQ(body(run(cache, "/me", {{"Cookie", "id=1"}})), "/me#5");
+
+    EXPECT_EQ(cache->cached_entries(), 1u);
+
+    auto opted_in = std::make_shared<middleware::c_response_cache>(middleware::response_cache_cfg_t{
+        .m_vary = {"Authorization"}, .m_cache_credentials = true});
+
+    EXPECT_EQ(body(run(opted_in, "/me", {{"Authorization", "Bearer a"}})), "/me#6");
+    EXPECT_EQ(body(run(opted_in, "/me", {{"Authorization", "Bearer a"}})), "/me#6");
+    EXPECT_EQ(body(run(opted_in, "/me", {{"Authorization", "Bearer b"}})), "/me#7");
+}
+
+TEST_F(response_cache_tests, serves_head_from_get_entries) {
+    auto cache = std::make_shared<middleware::c_response_cache>();
+
+    run(cache, "/a", {}, http::types::method_t::head);
+
+    EXPECT_EQ(cache->cached_entries(), 0u);
+
+    run(cache, "/a");
+
+    auto head = run(cache, "/a", {}, http::types::method_t::head);
+
+    EXPECT_EQ(head.status(), http::types::status_t::ok);
+    EXPECT_TRUE(head.headers().contains("ETag"));
+    EXPECT_EQ(m_calls, 2u);
+}
+
+TEST_F(response_cache_tests, evicts_least_recently_used) {
+    auto cache = std::make_shared<middleware::c_response_cache>(
+        middleware::response_cache_cfg_t{.m_max_entries = 2u, .m_shards = 1u});
+
+    run(cache, "/a");
+    run(cache, "/b");
+    run(cache, "/a");
+    run(cache, "/c");
+
+    EXPECT_EQ(cache->cached_entries(), 2u);
+
+    EXPECT_EQ(body(run(cache, "/a")), "/a#1");
+    EXPECT_EQ(body(run(cache, "/b")), "/b#4");
+}
+
+TEST_F(response_cache_tests, collapses_concurrent_misses) {
+    auto cache = std::make_shared<middleware::c_response_cache>();
+
+    auto pipeline = make_pipeline(cache);
+
+    m_delay = std::chrono::milliseconds{10};
+
+    auto request = make_request("/slow");
+
+    std::vector<http::types::response_t> responses(4u);
+
+    for (auto& response : responses)
+        boost::asio::co_spawn(
+            m_io_context,
+
+            [&]() -> boost::asio::awaitable<void> { response = co_await pipeline(request); },
+
+            boost::asio::detached);
+
+    m_io_context.run();
+
+    EXPECT_EQ(m_calls, 1u);
+
+    for (const auto& response : responses)
+        EXPECT_EQ(body(response), "/slow#1");
+
+    EXPECT_EQ(cache->misses(), 1u);
+    EXPECT_EQ(cache->collapsed(), 3u);
+    EXPECT_EQ(cache->hits(), 3u);
+}
+
+TEST_F(response_cache_tests, waiters_run_the_handler_if_not_cached) {
+    auto cache = std::make_shared<middleware::c_response_cache>();
+
+    auto pipeline = make_pipeline(cache);
+
+    m_delay = std::chrono::milliseconds{10};
+
+    m_headers = {{"Cache-Control", "no-store"}};
+
+    auto request = make_request("/slow");
+
+    std::vector<http::types::response_t> responses(3u);
+
+    for (auto& response : responses)
+        boost::asio::co_spawn(
+            m_io_context,
+
+            [&]() -> boost::asio::awaitable<void> { response = co_await pipeline(request); },
+
+            boost::asio::detached);
+
+    m_io_context.run();
+
+    EXPECT_EQ(m_calls, 3u);
+    EXPECT_EQ(cache->collapsed(), 2u);
+    EXPECT_EQ(cache->cached_entries(), 0u);
+
+    for (const auto& response : responses)
+        EXPECT_EQ(response.status(), http::types::status_t::ok);
+}
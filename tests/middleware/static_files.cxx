@@ -0,0 +1,213 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include "clueapi/http/types/request/request.hxx"
+#include "clueapi/http/types/response/response.hxx"
+#include "clueapi/middleware/middleware.hxx"
+#include "clueapi/middleware/static_files/static_files.hxx"
+
+using namespace clueapi;
+
+class static_files_tests : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        m_root = boost::filesystem::temp_directory_path() /
+                 boost::filesystem::unique_path("clueapi-static-%%%%-%%%%");
+
+        boost::filesystem::create_directories(m_root / "css");
+
+        write("index.html", "<h1>home</h1>");
+        write("css/app.css", "body{}");
+        write("large.bin", std::string(4096, 'x'));
+        write(".env", "SECRET=1");
+    }
+
+    void TearDown() override {
+        boost::filesystem::remove_all(m_root);
+    }
+
+    void write(const std::string& name, const std::string& content) {
+        std::ofstream file{(m_root / name).string(), std::ios::binary | std::ios::trunc};
+
+        file << content;
+    }
+
+    std::shared_ptr<middleware::c_static_files> mount(middleware::static_files_cfg_t cfg = {}) {
+        cfg.m_max_memory_file_size = 1024u;
+
+        return std::make_shared<middleware::c_static_files>("/assets/", m_root, std::move(cfg));
+    }
+
+    http::types::response_t run(
+        const std::shared_ptr<middleware::c_static_files>& files,
+        std::string uri,
+        std::vector<std::pair<std::string, std::string>> headers = {}) {
+        http::types::request_t request{};
+
+        request.method() = http::types::method_t::get;
+        request.uri() = http::types::uri_t{uri};
+
+        for (const auto& [key, value] : headers)
+            request.add_header(key, value);
+
+        middleware::pipeline_t pipeline{
+            {files},
+
+            [](const http::types::request_t&) -> shared::awaitable_t<http::types::response_t> {
+                co_return http::types::response_t{"next", http::types::status_t::not_found};
+            }};
+
+        http::types::response_t ret{};
+
+        boost::asio::co_spawn(
+            m_io_context,
+
+            [&]() -> boost::asio::awaitable<void> { ret = co_await pipeline(request); },
+
+            boost::asio::detached);
+
+        m_io_context.run();
+
+        m_io_context.restart();
+
+        return ret;
+    }
+
+    boost::filesystem::path m_root;
+
+    boost::asio::io_context m_io_context;
+};
+
+TEST_F(static_files_tests, serves_small_files_from_memory) {
+    auto files = mount();
+
+    auto response = run(files, "/assets/css/app.css?v=3");
+
+    EXPECT_EQ(response.status(), http::types::status_t::ok);
+    EXPECT_EQ(response.shared_body().m_data, "body{}");
+    EXPECT_EQ(response.headers().at("Content-Type"), "text/css");
+    EXPECT_EQ(response.headers().at("Cache-Control"), "public, max-age=3600");
+    EXPECT_TRUE(response.headers().contains("Last-Modified"));
+
+    const auto etag = response.headers().at("ETag");
+
+    EXPECT_EQ(files->cached_entries(), 1);
+    EXPECT_EQ(files->cached_bytes(), 6);
+
+    auto not_modified = run(files, "/assets/css/app.css", {{"If-None-Match", etag}});
+
+    EXPECT_EQ(not_modified.status(), http::types::status_t::not_modified);
+    EXPECT_FALSE(not_modified.shared_body());
+
+    auto index = run(files, "/assets/");
+
+    EXPECT_EQ(index.shared_body().m_data, "<h1>home</h1>");
+    EXPECT_EQ(index.headers().at("Content-Type"), "text/html");
+}
+
+TEST_F(static_files_tests, maps_files_when_asked) {
+    auto files = mount({.m_use_mmap = true});
+
+    EXPECT_EQ(run(files, "/assets/index.html").shared_body().m_data, "<h1>home</h1>");
+}
+
+TEST_F(static_files_tests, sends_large_files_and_ranges_from_disk) {
+    auto files = mount();
+
+    auto large = run(files, "/assets/large.bin");
+
+    ASSERT_TRUE(large.file().has_value());
+    EXPECT_EQ(large.file()->m_size, 4096);
+    EXPECT_EQ(large.headers().at("Content-Length"), "4096");
+
+    auto range = run(files, "/assets/css/app.css", {{"Range", "bytes=0-1"}});
+
+    ASSERT_TRUE(range.file().has_value());
+    EXPECT_EQ(range.file()->m_path, m_root / "css/app.css");
+}
+
+TEST_F(static_files_tests, passes_on_what_it_does_not_serve) {
+    auto files = mount();
+
+    for (const auto* uri :
+         {"/other/index.html",
+          "/assetsx/index.html",
+          "/assets/missing.js",
+          "/assets/../index.html",
+          "/assets/%2e%2e/index.html",
+          "/assets/.env"}) {
+        auto response = run(files, uri);
+
+        EXPECT_EQ(response.body(), "next") << uri;
+    }
+}
+
+TEST_F(static_files_tests, evicts_the_least_recently_used_entry) {
+    auto files = mount({.m_max_entries = 2u});
+
+    run(files, "/assets/index.html");
+    run(files, "/assets/css/app.css");
+
+    // Misses aren't cached, they push nothing out
+    for (const auto* uri : {"/assets/a.js", "/assets/b.js", "/assets/c.js"})
+        EXPECT_EQ(run(files, uri).body(), "next");
+
+    EXPECT_EQ(files->cached_entries(), 2);
+    EXPECT_EQ(files->cached_bytes(), 19);
+
+    // The index is used again, the stylesheet is dropped for the new file
+    run(files, "/assets/index.html");
+
+    write("new.txt", "new");
+
+    EXPECT_EQ(run(files, "/assets/new.txt").shared_body().m_data, "new");
+
+    EXPECT_EQ(files->cached_entries(), 2);
+    EXPECT_EQ(files->cached_bytes(), 16);
+}
+
+TEST_F(static_files_tests, revalidates_changed_files) {
+    auto files = mount({.m_watch = false, .m_revalidate = std::chrono::milliseconds{0}});
+
+    EXPECT_EQ(run(files, "/assets/css/app.css").shared_body().m_data, "body{}");
+
+    // The modification time has a one second resolution, the size tells the files apart
+    write("css/app.css", "body{color:red}");
+
+    EXPECT_EQ(run(files, "/assets/css/app.css").shared_body().m_data, "body{color:red}");
+
+    EXPECT_EQ(files->cached_bytes(), 15);
+
+    write("new.txt", "new");
+
+    EXPECT_EQ(run(files, "/assets/new.txt").shared_body().m_data, "new");
+}
+
+#if defined(__linux__)
+TEST_F(static_files_tests, drops_watched_entries_on_change) {
+    auto files = mount({.m_revalidate = std::chrono::milliseconds{0}});
+
+    EXPECT_EQ(run(files, "/assets/missing.js").body(), "next");
+
+    write("missing.js", "let a;");
+
+    EXPECT_EQ(run(files, "/assets/missing.js").shared_body().m_data, "let a;");
+
+    write("missing.js", "let a = 1;");
+
+    EXPECT_EQ(run(files, "/assets/missing.js").shared_body().m_data, "let a = 1;");
+}
+#endif
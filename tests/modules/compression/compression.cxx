@@ -0,0 +1,319 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <zlib.h>
+
+#include "clueapi/http/types/request/request.hxx"
+#include "clueapi/http/types/response/response.hxx"
+#include "clueapi/middleware/middleware.hxx"
+#include "clueapi/modules/compression/compression.hxx"
+
+#include "clueapi/shared/thread_pool/thread_pool.hxx"
+
+using namespace clueapi;
+using namespace clueapi::modules::compression;
+
+namespace {
+    std::string gunzip(std::string_view data) {
+        z_stream stream{};
+
+        // 32 added to the window bits accepts a gzip wrapper
+        inflateInit2(&stream, 15 + 32);
+
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+        stream.avail_in = static_cast<uInt>(data.size());
+
+        std::string ret{};
+
+        std::array<char, 4096> buffer{};
+
+        int status{Z_OK};
+
+        while (status == Z_OK) {
+            stream.next_out = reinterpret_cast<Bytef*>(buffer.data());
+            stream.avail_out = static_cast<uInt>(buffer.size());
+
+            status = inflate(&stream, Z_NO_FLUSH);
+
+            ret.append(buffer.data(), buffer.size() - stream.avail_out);
+
+            if (status == Z_BUF_ERROR && stream.avail_in == 0)
+                break;
+        }
+
+        inflateEnd(&stream);
+
+        return ret;
+    }
+
+    std::string make_json(std::size_t items) {
+        std::string ret{"["};
+
+        for (std::size_t i{}; i < items; i++)
+            ret += fmt::format("{}{{\"id\":{},\"name\":\"item\"}}", i ? "," : "", i);
+
+        return ret + "]";
+    }
+
+    http::types::response_t json_body(std::string body) {
+        return http::types::response_t{
+            std::move(body), http::types::status_t::ok, {{"Content-Type", "application/json"}}};
+    }
+} // namespace
+
+TEST(compression_tests, negotiate_accept_encoding) {
+    const std::vector<e_encoding> gzip_only{e_encoding::gzip};
+
+    EXPECT_EQ(codec_t::negotiate("gzip, deflate", gzip_only), e_encoding::gzip);
+    EXPECT_EQ(codec_t::negotiate("GZIP;q=0.5", gzip_only), e_encoding::gzip);
+    EXPECT_EQ(codec_t::negotiate("*", gzip_only), e_encoding::gzip);
+
+    EXPECT_EQ(codec_t::negotiate("gzip;q=0", gzip_only), e_encoding::identity);
+    EXPECT_EQ(codec_t::negotiate("*;q=0", gzip_only), e_encoding::identity);
+    EXPECT_EQ(codec_t::negotiate("identity", gzip_only), e_encoding::identity);
+    EXPECT_EQ(codec_t::negotiate("", gzip_only), e_encoding::identity);
+    EXPECT_EQ(codec_t::negotiate("gzip;q=0, *", gzip_only), e_encoding::identity);
+
+    if (codec_t::is_available(e_encoding::br)) {
+        const std::vector<e_encoding> all{e_encoding::br, e_encoding::gzip};
+
+        EXPECT_EQ(codec_t::negotiate("gzip, br", all), e_encoding::br);
+        EXPECT_EQ(codec_t::negotiate("gzip, br;q=0.8", all), e_encoding::gzip);
+    }
+}
+
+TEST(compression_tests, gzip_round_trip) {
+    const auto json = make_json(200);
+
+    auto compressed = codec_t::compress(e_encoding::gzip, 6, json);
+
+    ASSERT_TRUE(compressed.has_value());
+
+    EXPECT_LT(compressed->size(), json.size());
+
+    EXPECT_EQ(gunzip(*compressed), json);
+}
+
+TEST(compression_tests, encoder_flushes_every_chunk) {
+    auto encoder = codec_t::make_encoder(e_encoding::gzip, 6);
+
+    ASSERT_TRUE(encoder);
+
+    std::string out{};
+
+    ASSERT_TRUE(encoder->encode("data: first\n\n", out).has_value());
+
+    // A flushed chunk can be decoded before the stream ends
+    EXPECT_EQ(gunzip(out), "data: first\n\n");
+
+    ASSERT_TRUE(encoder->encode("data: second\n\n", out).has_value());
+    ASSERT_TRUE(encoder->finish(out).has_value());
+
+    EXPECT_EQ(gunzip(out), "data: first\n\ndata: second\n\n");
+}
+
+TEST(compression_tests, cache_evicts_least_recently_used) {
+    detail::cache_t cache{10};
+
+    cache.put("a", std::make_shared<const std::string>("1234"));
+    cache.put("b", std::make_shared<const std::string>("5678"));
+
+    // Makes "b" the least recently used
+    EXPECT_TRUE(cache.get("a"));
+
+    cache.put("c", std::make_shared<const std::string>("90"));
+
+    EXPECT_EQ(cache.bytes(), 10);
+
+    cache.put("d", std::make_shared<const std::string>("x"));
+
+    EXPECT_TRUE(cache.get("a"));
+    EXPECT_FALSE(cache.get("b"));
+    EXPECT_TRUE(cache.get("d"));
+
+    cache.put("e", std::make_shared<const std::string>("too large to cache"));
+
+    EXPECT_FALSE(cache.get("e"));
+}
+
+class compression_middleware_tests : public ::testing::Test {
+   protected:
+    http::types::response_t run(http::types::request_t& request, http::types::response_t response) {
+        std::vector<middleware::middleware_t> middlewares{
+            std::make_shared<c_compression_middleware>(cfg_t{.m_encodings = {e_encoding::gzip}})};
+
+        middleware::pipeline_t pipeline{
+            std::move(middlewares),
+
+            [response](const http::types::request_t&) -> shared::awaitable_t<http::types::response_t> {
+                co_return response;
+            }};
+
+        http::types::response_t ret{};
+
+        boost::asio::co_spawn(
+            io_context,
+
+            [&]() -> boost::asio::awaitable<void> { ret = co_await pipeline(request); },
+
+            boost::asio::detached);
+
+        io_context.run();
+
+        io_context.restart();
+
+        return ret;
+    }
+
+    boost::asio::io_context io_context;
+};
+
+TEST_F(compression_middleware_tests, compresses_allowed_bodies) {
+    const auto json = make_json(200);
+
+    http::types::request_t request{};
+
+    request.add_header("Accept-Encoding", "gzip, deflate");
+
+    auto response = run(request, json_body(json));
+
+    EXPECT_EQ(response.headers().at("Content-Encoding"), "gzip");
+    EXPECT_EQ(response.headers().at("Vary"), "Accept-Encoding");
+
+    EXPECT_EQ(gunzip(response.body()), json);
+}
+
+TEST_F(compression_middleware_tests, leaves_other_bodies_alone) {
+    const auto json = make_json(200);
+
+    {
+        http::types::request_t request{};
+
+        auto response = run(request, json_body(json));
+
+        EXPECT_FALSE(response.headers().contains("Content-Encoding"));
+        EXPECT_EQ(response.headers().at("Vary"), "Accept-Encoding");
+
+        EXPECT_EQ(response.body(), json);
+    }
+
+    {
+        http::types::request_t request{};
+
+        request.add_header("Accept-Encoding", "gzip");
+
+        auto response = run(request, json_body("[]"));
+
+        EXPECT_FALSE(response.headers().contains("Content-Encoding"));
+    }
+
+    {
+        http::types::request_t request{};
+
+        request.add_header("Accept-Encoding", "gzip");
+
+        auto response = run(
+            request,
+            http::types::response_t{
+                std::string(4096, 'x'),
+                http::types::status_t::ok,
+                {{"Content-Type", "image/png"}}});
+
+        EXPECT_FALSE(response.headers().contains("Content-Encoding"));
+        EXPECT_FALSE(response.headers().contains("Vary"));
+    }
+}
+
+TEST_F(compression_middleware_tests, compresses_files_once_on_the_pool) {
+    const auto json = make_json(200);
+
+    const auto path = boost::filesystem::temp_directory_path() /
+                      boost::filesystem::unique_path("clueapi-compression-%%%%-%%%%.json");
+
+    {
+        std::ofstream file{path.string(), std::ios::binary};
+
+        file << json;
+    }
+
+    const auto make_pipeline = [&](cfg_t cfg) {
+        return middleware::pipeline_t{
+            {std::make_shared<c_compression_middleware>(std::move(cfg))},
+
+            [&](const http::types::request_t&) -> shared::awaitable_t<http::types::response_t> {
+                co_return http::types::file_response_t{
+                    http::types::file_body_t{path, json.size()},
+                    http::types::status_t::ok,
+                    {{"ETag", "\"1-2\""}}};
+            }};
+    };
+
+    const auto run_all = [&](middleware::pipeline_t& pipeline, auto& responses) {
+        for (auto& response : responses)
+            boost::asio::co_spawn(
+                io_context,
+
+                [&]() -> boost::asio::awaitable<void> {
+                    http::types::request_t request{};
+
+                    request.add_header("Accept-Encoding", "gzip");
+
+                    response = co_await pipeline(request);
+                },
+
+                boost::asio::detached);
+
+        io_context.run();
+
+        io_context.restart();
+    };
+
+    cfg_t cfg{.m_encodings = {e_encoding::gzip}, .m_precompressed = false};
+
+    {
+        // Without a pool the I/O context doesn't compress the file
+        auto pipeline = make_pipeline(cfg);
+
+        std::array<http::types::response_t, 1> responses{};
+
+        run_all(pipeline, responses);
+
+        EXPECT_TRUE(responses[0].file().has_value());
+        EXPECT_FALSE(responses[0].headers().contains("Content-Encoding"));
+    }
+
+    shared::thread_pool_t pool{};
+
+    pool.start("compress", {.m_threads = 2u});
+
+    cfg.m_pool = &pool;
+
+    auto pipeline = make_pipeline(cfg);
+
+    // The misses for the same variant wait for a single compression
+    std::array<http::types::response_t, 3> responses{};
+
+    run_all(pipeline, responses);
+
+    for (const auto& response : responses) {
+        EXPECT_EQ(response.headers().at("Content-Encoding"), "gzip");
+        EXPECT_EQ(response.headers().at("ETag"), "\"1-2-gzip\"");
+
+        EXPECT_EQ(gunzip(response.shared_body().m_data), json);
+    }
+
+    EXPECT_EQ(pool.stats().m_completed, 1u);
+
+    boost::filesystem::remove(path);
+}
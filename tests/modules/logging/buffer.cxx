@@ -0,0 +1,190 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "clueapi/modules/logging/detail/buffer/buffer.hxx"
+
+namespace {
+    clueapi::modules::logging::detail::log_msg_t make_msg(std::size_t i) {
+        clueapi::modules::logging::detail::log_msg_t msg{};
+
+        msg.m_msg = std::to_string(i);
+
+        return msg;
+    }
+} // namespace
+
+TEST(logging_buffer_tests, exact_capacity) {
+    clueapi::modules::logging::detail::msg_buffer_t buffer{5};
+
+    for (std::size_t i{}; i < 5; i++)
+        EXPECT_TRUE(buffer.push(make_msg(i)).first);
+
+    auto push_pair = buffer.push(make_msg(5));
+
+    EXPECT_FALSE(push_pair.first);
+    EXPECT_EQ(push_pair.second.m_msg, "5");
+
+    EXPECT_EQ(buffer.capacity(), 5u);
+    EXPECT_EQ(buffer.size(), 5u);
+
+    clueapi::modules::logging::detail::log_msg_t msg{};
+
+    ASSERT_TRUE(buffer.pop(msg));
+    EXPECT_EQ(msg.m_msg, "0");
+
+    EXPECT_TRUE(buffer.push(make_msg(5)).first);
+    EXPECT_EQ(buffer.size(), 5u);
+}
+
+TEST(logging_buffer_tests, wraps_around) {
+    clueapi::modules::logging::detail::msg_buffer_t buffer{4};
+
+    clueapi::modules::logging::detail::log_msg_t msg{};
+
+    for (std::size_t i{}; i < 100; i++) {
+        ASSERT_TRUE(buffer.push(make_msg(i)).first);
+
+        ASSERT_TRUE(buffer.pop(msg));
+        EXPECT_EQ(msg.m_msg, std::to_string(i));
+    }
+
+    EXPECT_TRUE(buffer.empty());
+    EXPECT_FALSE(buffer.pop(msg));
+}
+
+TEST(logging_buffer_tests, get_batch) {
+    clueapi::modules::logging::detail::msg_buffer_t buffer{16};
+
+    for (std::size_t i{}; i < 10; i++)
+        buffer.push(make_msg(i));
+
+    auto batch = buffer.get_batch(4);
+
+    ASSERT_EQ(batch.size(), 4u);
+    EXPECT_EQ(batch.front().m_msg, "0");
+    EXPECT_EQ(batch.back().m_msg, "3");
+
+    batch = buffer.get_batch(100);
+
+    ASSERT_EQ(batch.size(), 6u);
+    EXPECT_EQ(batch.front().m_msg, "4");
+
+    EXPECT_TRUE(buffer.get_batch(100).empty());
+}
+
+TEST(logging_buffer_tests, push_evicting) {
+    clueapi::modules::logging::detail::msg_buffer_t buffer{3};
+
+    for (std::size_t i{}; i < 5; i++)
+        EXPECT_TRUE(buffer.push_evicting(make_msg(i)));
+
+    auto batch = buffer.get_batch(10);
+
+    ASSERT_EQ(batch.size(), 3u);
+    EXPECT_EQ(batch.front().m_msg, "2");
+    EXPECT_EQ(batch.back().m_msg, "4");
+
+    clueapi::modules::logging::detail::msg_buffer_t empty{0};
+
+    EXPECT_FALSE(empty.push_evicting(make_msg(0)));
+}
+
+TEST(logging_buffer_tests, set_capacity) {
+    clueapi::modules::logging::detail::msg_buffer_t buffer{2};
+
+    buffer.push(make_msg(0));
+    buffer.push(make_msg(1));
+
+    buffer.set_capacity(10);
+
+    EXPECT_EQ(buffer.capacity(), 10u);
+    EXPECT_EQ(buffer.size(), 2u);
+
+    for (std::size_t i{2}; i < 10; i++)
+        EXPECT_TRUE(buffer.push(make_msg(i)).first);
+
+    EXPECT_FALSE(buffer.push(make_msg(10)).first);
+
+    auto batch = buffer.get_batch(10);
+
+    ASSERT_EQ(batch.size(), 10u);
+    EXPECT_EQ(batch.front().m_msg, "0");
+    EXPECT_EQ(batch.back().m_msg, "9");
+
+    buffer.destroy();
+
+    EXPECT_FALSE(buffer.push(make_msg(0)).first);
+}
+
+TEST(logging_buffer_tests, concurrent_producers) {
+    constexpr std::size_t k_producers{4};
+    constexpr std::size_t k_per_producer{20000};
+
+    clueapi::modules::logging::detail::msg_buffer_t buffer{64};
+
+    std::atomic<std::size_t> done{};
+
+    std::vector<std::thread> producers{};
+
+    for (std::size_t p{}; p < k_producers; p++) {
+        producers.emplace_back([&buffer, &done, p]() {
+            for (std::size_t i{}; i < k_per_producer; i++) {
+                auto msg = make_msg(p * k_per_producer + i);
+
+                for (;;) {
+                    auto push_pair = buffer.push(std::move(msg));
+
+                    if (push_pair.first)
+                        break;
+
+                    msg = std::move(push_pair.second);
+
+                    std::this_thread::yield();
+                }
+            }
+
+            done.fetch_add(1u);
+        });
+    }
+
+    std::vector<bool> seen(k_producers * k_per_producer);
+
+    std::vector<std::size_t> last(k_producers);
+
+    std::size_t received{};
+
+    while (received < seen.size()) {
+        auto batch = buffer.get_batch(32);
+
+        for (const auto& msg : batch) {
+            const auto value = std::stoul(msg.m_msg);
+
+            ASSERT_FALSE(seen[value]);
+
+            seen[value] = true;
+
+            // The messages of a producer keep their order
+            const auto producer = value / k_per_producer;
+
+            EXPECT_GE(value + 1u, last[producer]);
+
+            last[producer] = value + 1u;
+
+            received++;
+        }
+
+        if (batch.empty())
+            std::this_thread::yield();
+    }
+
+    for (auto& producer : producers)
+        producer.join();
+
+    EXPECT_EQ(done.load(), k_producers);
+    EXPECT_TRUE(buffer.empty());
+}
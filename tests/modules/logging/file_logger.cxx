@@ -1,11 +1,14 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <chrono>
 #include <filesystem>
 #include <fstream>
+#include <iterator>
 #include <memory>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <thread>
 
 #include "clueapi/modules/logging/detail/hash/hash.hxx"
@@ -246,6 +249,8 @@ TEST_F(logging_file_async_tests, overflow_handling) {
 
     ASSERT_NE(file_logger, nullptr);
     EXPECT_EQ(file_logger->buffer().size(), 5u);
+    EXPECT_EQ(file_logger->dropped(), 0u);
+    EXPECT_EQ(m_logging.dropped(), 0u);
 
     CLUEAPI_LOG_IMPL(
         m_logging,
@@ -257,6 +262,9 @@ TEST_F(logging_file_async_tests, overflow_handling) {
         "Overflow message"
     );
 
+    EXPECT_EQ(file_logger->dropped(), 1u);
+    EXPECT_EQ(m_logging.dropped(), 1u);
+
     // TODO: Fix this test on Windows
 #ifndef _WIN32
     EXPECT_EQ(file_logger->buffer().size(), 5u);
@@ -274,4 +282,65 @@ TEST_F(logging_file_async_tests, overflow_handling) {
 
     EXPECT_NE(content.find("Overflow message"), std::string::npos);
 #endif // _WIN32
-}
\ No newline at end of file
+}
+#ifndef _WIN32
+TEST_F(logging_file_async_tests, deferred_format) {
+    auto logger = std::make_shared<clueapi::modules::logging::file_logger_t>(clueapi::modules::logging::logger_params_t{
+        .m_capacity = 16, .m_batch_size = 16, .m_async_mode = true, .m_deferred_format = true
+    });
+
+    logger->set_file_path(log_path_1);
+
+    m_logging.add_logger(LOGGER_NAME("Test file logger"), logger);
+
+    std::string name{"a name longer than the small string buffer"};
+
+    CLUEAPI_LOG_IMPL(
+        m_logging,
+
+        LOGGER_NAME("Test file logger"),
+
+        clueapi::modules::logging::e_log_level::error,
+
+        "Deferred {} {} {:.1f} {}", 42, name, 1.5, std::chrono::milliseconds{7}
+    );
+
+    // The caller's string may change once the record is made
+    name.assign(name.size(), 'x');
+
+    const char* c_str = "pointer";
+
+    CLUEAPI_LOG_IMPL(
+        m_logging,
+
+        LOGGER_NAME("Test file logger"),
+
+        clueapi::modules::logging::e_log_level::error,
+
+        "Formatted right away {}", c_str
+    );
+
+    // A character array that isn't a literal goes through the string view overload
+    char format[] = "Buffer format {}";
+
+    CLUEAPI_LOG_IMPL(
+        m_logging,
+
+        LOGGER_NAME("Test file logger"),
+
+        clueapi::modules::logging::e_log_level::error,
+
+        std::string_view{format}, 1
+    );
+
+    std::fill(std::begin(format), std::end(format) - 1, 'x');
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{30});
+
+    std::string content = read_file_content(log_path_1);
+
+    EXPECT_NE(content.find("Deferred 42 a name longer than the small string buffer 1.5 7ms"), std::string::npos);
+    EXPECT_NE(content.find("Formatted right away pointer"), std::string::npos);
+    EXPECT_NE(content.find("Buffer format 1"), std::string::npos);
+}
+#endif // _WIN32
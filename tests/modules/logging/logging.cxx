@@ -5,6 +5,7 @@
 #include <string>
 #include <utility>
 
+#include "clueapi/modules/logging/detail/detail.hxx"
 #include "clueapi/modules/logging/detail/hash/hash.hxx"
 #include "clueapi/modules/logging/loggers/console/console.hxx"
 #include "clueapi/modules/logging/logging.hxx"
@@ -371,4 +372,37 @@ TEST_F(logging_async_tests, test_log_macros) {
 
         "test message {} {}", 1, 2
     );
-}
\ No newline at end of file
+}
+TEST(logging_deferred_tests, make_deferred) {
+    clueapi::modules::logging::log_msg_t msg{};
+
+    std::string_view name{"clueapi"};
+
+    ASSERT_TRUE(clueapi::modules::logging::detail::make_deferred(msg.m_deferred, "{} {} {}", 1u, name, true));
+
+    EXPECT_TRUE(msg.m_msg.empty());
+
+    fmt::memory_buffer buffer{};
+
+    ASSERT_TRUE(clueapi::modules::logging::detail::text(msg, buffer));
+
+    EXPECT_EQ(std::string_view(buffer.data(), buffer.size()), "1 clueapi true");
+
+    const std::string too_long(clueapi::modules::logging::detail::k_deferred_args_size, 'x');
+
+    EXPECT_FALSE(clueapi::modules::logging::detail::make_deferred(msg.m_deferred, "{}", too_long));
+
+    const char* c_str = "pointer";
+
+    EXPECT_FALSE(clueapi::modules::logging::detail::make_deferred(msg.m_deferred, "{}", c_str));
+}
+
+TEST(logging_deferred_tests, bad_format) {
+    clueapi::modules::logging::log_msg_t msg{};
+
+    ASSERT_TRUE(clueapi::modules::logging::detail::make_deferred(msg.m_deferred, "{} {}", 1));
+
+    fmt::memory_buffer buffer{};
+
+    EXPECT_FALSE(clueapi::modules::logging::detail::text(msg, buffer));
+}
@@ -2,12 +2,24 @@
 
 #include <boost/asio/awaitable.hpp>
 #include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
 #include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include <boost/asio/use_future.hpp>
 #include <boost/redis/logger.hpp>
 #include <chrono>
+#include <cstdint>
 #include <memory>
+#include <optional>
+#include <set>
+#include <string>
 #include <thread>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
 
 #include "clueapi/modules/redis/redis.hxx"
 
@@ -285,4 +297,347 @@ TEST_F(redis_connection_tests, connect_sync_invalid_port) {
     EXPECT_EQ(connection_t::state_t::disconnected, state);
 
     io_ctx.stop();
-}
\ No newline at end of file
+}
+
+TEST_F(redis_connection_tests, batch_types) {
+    using batch_t = decltype(connection_t::batch()
+                                 .get<std::string>("key")
+                                 .hget("hash", "field")
+                                 .incr("counter")
+                                 .mget<std::string>({"a", "b"}));
+
+    static_assert(std::is_same_v<
+                  batch_t::results_t,
+                  std::tuple<
+                      std::optional<std::string>,
+                      std::optional<std::string>,
+                      std::int64_t,
+                      std::vector<std::optional<std::string>>>>);
+
+    EXPECT_EQ(batch_t::size(), 4u);
+}
+
+TEST_F(redis_connection_tests, async_batch) {
+    boost::asio::io_context io_ctx;
+
+    auto connection = make_connection(io_ctx);
+
+    auto fut = boost::asio::co_spawn(
+        io_ctx,
+
+        [&]() -> boost::asio::awaitable<void> {
+            EXPECT_TRUE(co_await connection->async_connect());
+
+            const std::unordered_map<std::string_view, std::string_view> mapping{
+                {"batch:a", "1"}, {"batch:b", "2"}};
+
+            EXPECT_TRUE(co_await connection->async_mset(mapping));
+
+            auto results = co_await connection->async_exec(connection_t::batch()
+                                                               .get<std::string>("batch:a")
+                                                               .get<std::string>("batch:missing")
+                                                               .incr("batch:b")
+                                                               .del("batch:a")
+                                                               .del("batch:b"));
+
+            EXPECT_TRUE(results.has_value());
+
+            if (results.has_value()) {
+                const auto& [a, missing, b, del_a, del_b] = *results;
+
+                EXPECT_EQ(a, "1");
+                EXPECT_EQ(missing, std::nullopt);
+                EXPECT_EQ(b, 3);
+                EXPECT_EQ(del_a + del_b, 2);
+            }
+
+            const std::vector<std::string_view> keys{"batch:a", "batch:b"};
+
+            auto values = co_await connection->async_mget<std::string>(keys);
+
+            EXPECT_EQ(values.size(), 2u);
+
+            for (const auto& value : values)
+                EXPECT_EQ(value, std::nullopt);
+
+            connection->disconnect();
+        },
+
+        boost::asio::use_future);
+
+    io_ctx.run();
+
+    fut.get();
+
+    io_ctx.stop();
+}
+
+TEST_F(redis_connection_tests, async_auto_pipeline) {
+    boost::asio::io_context io_ctx;
+
+    auto cfg = m_cfg;
+
+    cfg.m_auto_pipeline = true;
+
+    auto connection = make_connection(io_ctx, true, cfg);
+
+    auto fut = boost::asio::co_spawn(
+        io_ctx,
+
+        [&]() -> boost::asio::awaitable<void> {
+            EXPECT_TRUE(co_await connection->async_connect());
+
+            EXPECT_TRUE(co_await connection->async_set("pipeline:key", "value"));
+
+            constexpr std::size_t k_calls{16u};
+
+            std::size_t completed{};
+
+            // Issued within the same tick, so they share a single request
+            for (std::size_t i{}; i < k_calls; i++)
+                boost::asio::co_spawn(
+                    io_ctx,
+
+                    [&]() -> boost::asio::awaitable<void> {
+                        EXPECT_EQ(
+                            co_await connection->async_get<std::string>("pipeline:key"), "value");
+
+                        EXPECT_TRUE(co_await connection->async_exists("pipeline:key"));
+
+                        completed++;
+                    },
+
+                    boost::asio::detached);
+
+            EXPECT_EQ(co_await connection->async_get<std::string>("pipeline:missing"), std::nullopt);
+
+            while (completed != k_calls)
+                co_await boost::asio::post(io_ctx, boost::asio::use_awaitable);
+
+            EXPECT_TRUE(co_await connection->async_del("pipeline:key"));
+
+            connection->disconnect();
+        },
+
+        boost::asio::use_future);
+
+    io_ctx.run();
+
+    fut.get();
+
+    io_ctx.stop();
+}
+
+TEST_F(redis_connection_tests, async_auto_pipeline_isolates_errors) {
+    boost::asio::io_context io_ctx;
+
+    auto cfg = m_cfg;
+
+    cfg.m_auto_pipeline = true;
+
+    auto connection = make_connection(io_ctx, true, cfg);
+
+    auto fut = boost::asio::co_spawn(
+        io_ctx,
+
+        [&]() -> boost::asio::awaitable<void> {
+            EXPECT_TRUE(co_await connection->async_connect());
+
+            EXPECT_TRUE(co_await connection->async_set("pipeline:string", "value"));
+
+            co_await connection->async_del("pipeline:counter");
+
+            std::size_t completed{};
+
+            // A WRONGTYPE error shares the request with the commands around it
+            boost::asio::co_spawn(
+                io_ctx,
+
+                [&]() -> boost::asio::awaitable<void> {
+                    EXPECT_EQ(co_await connection->async_hget("pipeline:string", "field"), std::nullopt);
+
+                    completed++;
+                },
+
+                boost::asio::detached);
+
+            boost::asio::co_spawn(
+                io_ctx,
+
+                [&]() -> boost::asio::awaitable<void> {
+                    EXPECT_EQ(co_await connection->async_incr("pipeline:counter"), 1);
+
+                    completed++;
+                },
+
+                boost::asio::detached);
+
+            EXPECT_EQ(co_await connection->async_get<std::string>("pipeline:string"), "value");
+
+            while (completed != 2u)
+                co_await boost::asio::post(io_ctx, boost::asio::use_awaitable);
+
+            EXPECT_TRUE(co_await connection->async_del("pipeline:string"));
+            EXPECT_TRUE(co_await connection->async_del("pipeline:counter"));
+
+            connection->disconnect();
+        },
+
+        boost::asio::use_future);
+
+    io_ctx.run();
+
+    fut.get();
+
+    io_ctx.stop();
+}
+
+TEST_F(redis_connection_tests, async_near_cache) {
+    boost::asio::io_context io_ctx;
+
+    auto cfg = m_cfg;
+
+    cfg.m_near_cache_size = 16u;
+
+    auto connection = make_connection(io_ctx, true, cfg);
+
+    auto writer = make_connection(io_ctx);
+
+    auto fut = boost::asio::co_spawn(
+        io_ctx,
+
+        [&]() -> boost::asio::awaitable<void> {
+            EXPECT_TRUE(co_await connection->async_connect());
+            EXPECT_TRUE(co_await writer->async_connect());
+
+            EXPECT_TRUE(co_await writer->async_set("near_cache:key", "1"));
+
+            EXPECT_EQ(co_await connection->async_get<std::string>("near_cache:key"), "1");
+            EXPECT_EQ(co_await connection->async_get<std::string>("near_cache:key"), "1");
+
+            auto stats = connection->near_cache_stats();
+
+            EXPECT_TRUE(stats.has_value());
+
+            if (stats.has_value()) {
+                EXPECT_EQ(stats->m_hits, 1u);
+                EXPECT_EQ(stats->m_misses, 1u);
+            }
+
+            // Written through another connection, so only the tracking tells about it
+            EXPECT_TRUE(co_await writer->async_set("near_cache:key", "2"));
+
+            boost::asio::steady_timer timer{io_ctx};
+
+            for (std::size_t i{}; i < 100u && connection->near_cache_stats()->m_size != 0u; i++) {
+                timer.expires_after(std::chrono::milliseconds{10});
+
+                co_await timer.async_wait(boost::asio::use_awaitable);
+            }
+
+            EXPECT_EQ(co_await connection->async_get<std::string>("near_cache:key"), "2");
+
+            EXPECT_TRUE(co_await writer->async_del("near_cache:key"));
+
+            connection->disconnect();
+            writer->disconnect();
+        },
+
+        boost::asio::use_future);
+
+    io_ctx.run();
+
+    fut.get();
+
+    io_ctx.stop();
+}
+
+TEST_F(redis_connection_tests, async_cursors) {
+    boost::asio::io_context io_ctx;
+
+    auto connection = make_connection(io_ctx);
+
+    auto fut = boost::asio::co_spawn(
+        io_ctx,
+
+        [&]() -> boost::asio::awaitable<void> {
+            EXPECT_TRUE(co_await connection->async_connect());
+
+            constexpr std::size_t k_elements{250u};
+
+            std::vector<std::string> names{};
+
+            for (std::size_t i{}; i < k_elements; i++)
+                names.push_back("field:" + std::to_string(i));
+
+            std::unordered_map<std::string_view, std::string_view> mapping{};
+
+            for (const auto& name : names)
+                mapping.emplace(name, "value");
+
+            EXPECT_EQ(co_await connection->async_hset("cursor:hash", mapping), k_elements);
+
+            for (const auto& name : names)
+                co_await connection->async_lpush("cursor:list", name);
+
+            // HSCAN may yield a field more than once, hence the set
+            std::set<std::string> fields{};
+
+            auto hscan = connection->hscan("cursor:hash", {.m_count = 50u});
+
+            while (!hscan.is_done()) {
+                std::size_t index{};
+
+                EXPECT_TRUE(co_await hscan.async_next([&](std::string_view element) {
+                    if (index++ % 2u == 0u)
+                        fields.emplace(element);
+                    else
+                        EXPECT_EQ(element, "value");
+                }));
+            }
+
+            EXPECT_FALSE(hscan.has_failed());
+            EXPECT_EQ(fields.size(), k_elements);
+
+            std::vector<std::size_t> pages{};
+
+            auto lrange = connection->lrange_pages("cursor:list", 100u);
+
+            while (!lrange.is_done()) {
+                auto page = co_await lrange.async_next();
+
+                EXPECT_TRUE(page.has_value());
+
+                if (page.has_value())
+                    pages.push_back(page->size());
+            }
+
+            EXPECT_EQ(pages, (std::vector<std::size_t>{100u, 100u, 50u}));
+
+            std::set<std::string> keys{};
+
+            auto scan = connection->scan({.m_match = "cursor:*", .m_count = 10u});
+
+            while (!scan.is_done()) {
+                auto page = co_await scan.async_next();
+
+                if (page.has_value())
+                    keys.insert(page->begin(), page->end());
+            }
+
+            EXPECT_EQ(keys, (std::set<std::string>{"cursor:hash", "cursor:list"}));
+
+            EXPECT_TRUE(co_await connection->async_del("cursor:hash"));
+            EXPECT_TRUE(co_await connection->async_del("cursor:list"));
+
+            connection->disconnect();
+        },
+
+        boost::asio::use_future);
+
+    io_ctx.run();
+
+    fut.get();
+
+    io_ctx.stop();
+}
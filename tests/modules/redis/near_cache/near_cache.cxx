@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+
+#include <boost/redis/resp3/node.hpp>
+#include <boost/redis/resp3/type.hpp>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "clueapi/modules/redis/redis.hxx"
+
+using namespace clueapi::modules::redis;
+
+namespace {
+    boost::redis::resp3::node make_node(
+        boost::redis::resp3::type type, std::size_t depth, std::string value = {}) {
+        boost::redis::resp3::node node{};
+
+        node.data_type = type;
+        node.depth = depth;
+        node.value = std::move(value);
+
+        return node;
+    }
+} // namespace
+
+TEST(redis_near_cache_tests, hit_and_miss) {
+    near_cache_t cache{8u, std::chrono::seconds{60}};
+
+    cache.set_enabled(true);
+
+    EXPECT_EQ(cache.find<near_cache_t::string_t>("key"), nullptr);
+
+    cache.insert("key", near_cache_t::string_t{"value"}, cache.generation());
+    cache.insert("missing", near_cache_t::string_t{}, cache.generation());
+
+    const auto* value = cache.find<near_cache_t::string_t>("key");
+
+    ASSERT_NE(value, nullptr);
+
+    EXPECT_EQ(*value, "value");
+
+    const auto* missing = cache.find<near_cache_t::string_t>("missing");
+
+    ASSERT_NE(missing, nullptr);
+
+    EXPECT_EQ(*missing, std::nullopt);
+
+    // Cached as a string, so not a hash
+    EXPECT_EQ(cache.find<near_cache_t::hash_t>("key"), nullptr);
+
+    const auto stats = cache.stats();
+
+    EXPECT_EQ(stats.m_hits, 2u);
+    EXPECT_EQ(stats.m_misses, 2u);
+    EXPECT_EQ(stats.m_size, 2u);
+}
+
+TEST(redis_near_cache_tests, evicts_least_recently_used) {
+    near_cache_t cache{2u, std::chrono::seconds{60}};
+
+    cache.set_enabled(true);
+
+    cache.insert("a", near_cache_t::string_t{"1"}, cache.generation());
+    cache.insert("b", near_cache_t::string_t{"2"}, cache.generation());
+
+    EXPECT_NE(cache.find<near_cache_t::string_t>("a"), nullptr);
+
+    cache.insert("c", near_cache_t::string_t{"3"}, cache.generation());
+
+    EXPECT_NE(cache.find<near_cache_t::string_t>("a"), nullptr);
+    EXPECT_EQ(cache.find<near_cache_t::string_t>("b"), nullptr);
+    EXPECT_NE(cache.find<near_cache_t::string_t>("c"), nullptr);
+
+    EXPECT_EQ(cache.stats().m_evictions, 1u);
+}
+
+TEST(redis_near_cache_tests, expires) {
+    near_cache_t cache{8u, std::chrono::seconds{0}};
+
+    cache.set_enabled(true);
+
+    cache.insert("key", near_cache_t::string_t{"value"}, cache.generation());
+
+    EXPECT_EQ(cache.find<near_cache_t::string_t>("key"), nullptr);
+    EXPECT_EQ(cache.stats().m_size, 0u);
+}
+
+TEST(redis_near_cache_tests, skips_reads_older_than_an_invalidation) {
+    near_cache_t cache{8u, std::chrono::seconds{60}};
+
+    cache.set_enabled(true);
+
+    const auto generation = cache.generation();
+
+    cache.invalidate("key");
+
+    cache.insert("key", near_cache_t::string_t{"stale"}, generation);
+
+    EXPECT_EQ(cache.find<near_cache_t::string_t>("key"), nullptr);
+
+    cache.set_enabled(false);
+
+    cache.insert("key", near_cache_t::string_t{"value"}, cache.generation());
+
+    EXPECT_EQ(cache.stats().m_size, 0u);
+}
+
+TEST(redis_near_cache_tests, invalidate_push) {
+    using boost::redis::resp3::type;
+
+    near_cache_t cache{8u, std::chrono::seconds{60}};
+
+    cache.set_enabled(true);
+
+    for (const auto* key : {"a", "b", "c"})
+        cache.insert(key, near_cache_t::string_t{"value"}, cache.generation());
+
+    // >2 invalidate [a, b]
+    const std::vector<boost::redis::resp3::node> nodes{
+        make_node(type::push, 0u),
+        make_node(type::blob_string, 1u, "invalidate"),
+        make_node(type::array, 1u),
+        make_node(type::blob_string, 2u, "a"),
+        make_node(type::blob_string, 2u, "b")};
+
+    EXPECT_TRUE(cache.on_push(nodes));
+
+    EXPECT_EQ(cache.find<near_cache_t::string_t>("a"), nullptr);
+    EXPECT_EQ(cache.find<near_cache_t::string_t>("b"), nullptr);
+    EXPECT_NE(cache.find<near_cache_t::string_t>("c"), nullptr);
+
+    EXPECT_EQ(cache.stats().m_invalidations, 2u);
+
+    // Sent on FLUSHALL
+    const std::vector<boost::redis::resp3::node> flush{
+        make_node(type::push, 0u),
+        make_node(type::blob_string, 1u, "invalidate"),
+        make_node(type::null, 1u)};
+
+    EXPECT_TRUE(cache.on_push(flush));
+
+    EXPECT_EQ(cache.stats().m_size, 0u);
+
+    const std::vector<boost::redis::resp3::node> message{
+        make_node(type::push, 0u),
+        make_node(type::blob_string, 1u, "message"),
+        make_node(type::blob_string, 1u, "channel"),
+        make_node(type::blob_string, 1u, "payload")};
+
+    EXPECT_FALSE(cache.on_push(message));
+}
@@ -0,0 +1,212 @@
+#include <gtest/gtest.h>
+
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/use_future.hpp>
+#include <boost/redis/logger.hpp>
+#include <chrono>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "clueapi/modules/redis/redis.hxx"
+
+using namespace clueapi::modules::redis;
+
+TEST(redis_shard_map_tests, hash_slot) {
+    // The slots listed by the Redis Cluster specification
+    EXPECT_EQ(shard_map_t::slot_of("123456789"), 0x31c3u);
+    EXPECT_EQ(shard_map_t::slot_of("foo"), 12182u);
+    EXPECT_EQ(shard_map_t::slot_of("bar"), 5061u);
+
+    EXPECT_EQ(shard_map_t::hash_tag("{user:1}:name"), "user:1");
+    EXPECT_EQ(shard_map_t::hash_tag("foo{}{bar}"), "foo{}{bar}");
+    EXPECT_EQ(shard_map_t::hash_tag("foo{bar"), "foo{bar");
+
+    EXPECT_EQ(shard_map_t::slot_of("{user:1}:name"), shard_map_t::slot_of("user:1"));
+}
+
+TEST(redis_shard_map_tests, ring) {
+    auto shard_map = shard_map_t::make_ring({"a:6379/0", "b:6379/0", "c:6379/0"});
+
+    EXPECT_EQ(shard_map.nodes(), 3u);
+    EXPECT_FALSE(shard_map.is_slotted());
+
+    std::vector<std::size_t> counts(3u);
+
+    for (std::size_t i{}; i < 3000u; i++) {
+        const auto key = "key:" + std::to_string(i);
+
+        const auto node = shard_map.node_of(key);
+
+        ASSERT_TRUE(node.has_value());
+
+        counts[*node]++;
+
+        EXPECT_EQ(shard_map.node_of("{" + key + "}:other"), node);
+    }
+
+    for (const auto count : counts) {
+        EXPECT_GT(count, 700u);
+        EXPECT_LT(count, 1300u);
+    }
+
+    // Only the keys of a node that goes away move, to the other nodes
+    for (std::size_t i{}; i < 3000u; i++) {
+        const auto key = "key:" + std::to_string(i);
+
+        const auto node = shard_map.node_of(key);
+
+        const auto failover =
+            shard_map.node_of(key, [](std::size_t node) { return node != 1u; });
+
+        ASSERT_TRUE(failover.has_value());
+
+        if (*node != 1u)
+            EXPECT_EQ(*failover, *node);
+        else
+            EXPECT_NE(*failover, 1u);
+    }
+
+    EXPECT_FALSE(shard_map.node_of("key", [](std::size_t) { return false; }).has_value());
+}
+
+TEST(redis_shard_map_tests, slots) {
+    const auto ranges = shard_map_t::split_slots(3u);
+
+    ASSERT_EQ(ranges.size(), 3u);
+
+    EXPECT_EQ(ranges[0].front().first, 0u);
+    EXPECT_EQ(ranges[2].back().second, shard_map_t::k_slots - 1u);
+
+    auto shard_map = shard_map_t::make_slots(ranges);
+
+    ASSERT_TRUE(shard_map.has_value());
+
+    EXPECT_TRUE(shard_map->is_slotted());
+
+    EXPECT_EQ(shard_map->node_of("foo"), 2u);
+    EXPECT_EQ(shard_map->node_of("bar"), 0u);
+
+    // A slot is only served by its owner
+    EXPECT_FALSE(shard_map->node_of("foo", [](std::size_t node) { return node != 2u; }));
+
+    EXPECT_FALSE(shard_map_t::make_slots({{{0u, 100u}}}).has_value());
+    EXPECT_FALSE(shard_map_t::make_slots({{{0u, shard_map_t::k_slots}}}).has_value());
+}
+
+class redis_pool_tests : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        m_conn_cfg.m_host = "127.0.0.1";
+        m_conn_cfg.m_port = "6379";
+
+        m_conn_cfg.m_uuid = "test-uuid";
+
+        m_conn_cfg.m_client_name = "clueapi-tests";
+
+        m_conn_cfg.m_log_level = boost::redis::logger::level::err;
+
+        m_conn_cfg.m_connect_timeout = std::chrono::seconds{3};
+
+        m_conn_cfg.m_health_check_interval = std::chrono::seconds{0};
+        m_conn_cfg.m_reconnect_wait_interval = std::chrono::seconds{0};
+    }
+
+    connection_t::cfg_t m_conn_cfg;
+};
+
+TEST_F(redis_pool_tests, invalid_cfg) {
+    boost::asio::io_context io_ctx;
+
+    EXPECT_FALSE(pool_t(pool_t::cfg_t{}, {&io_ctx}).is_valid());
+
+    EXPECT_FALSE(pool_t(pool_t::cfg_t{.m_nodes = {m_conn_cfg}}, {}).is_valid());
+
+    EXPECT_FALSE(pool_t(
+                     pool_t::cfg_t{
+                         .m_nodes = {m_conn_cfg},
+                         .m_sharding = pool_t::slots,
+                         .m_slots = {{{0u, 100u}}}},
+                     {&io_ctx})
+                     .is_valid());
+}
+
+TEST_F(redis_pool_tests, core_local_connections) {
+    constexpr std::size_t k_io_ctxs{2u};
+
+    std::vector<std::unique_ptr<boost::asio::io_context>> io_ctxs{};
+
+    std::vector<boost::asio::io_context*> raw_io_ctxs{};
+
+    for (std::size_t i{}; i < k_io_ctxs; i++)
+        raw_io_ctxs.push_back(
+            io_ctxs.emplace_back(std::make_unique<boost::asio::io_context>()).get());
+
+    std::vector<std::jthread> threads{};
+
+    std::vector<boost::asio::executor_work_guard<boost::asio::io_context::executor_type>>
+        guards{};
+
+    for (auto* io_ctx : raw_io_ctxs) {
+        guards.emplace_back(io_ctx->get_executor());
+
+        threads.emplace_back([io_ctx]() { io_ctx->run(); });
+    }
+
+    {
+        pool_t pool{
+            pool_t::cfg_t{.m_nodes = {m_conn_cfg}, .m_health_check_interval = std::chrono::seconds{1}},
+            raw_io_ctxs};
+
+        ASSERT_TRUE(pool.is_valid());
+
+        EXPECT_EQ(pool.connection("key"), nullptr);
+
+        auto is_connected =
+            boost::asio::co_spawn(*raw_io_ctxs[0], pool.async_connect(), boost::asio::use_future);
+
+        ASSERT_TRUE(is_connected.get());
+
+        EXPECT_EQ(pool.healthy(), k_io_ctxs);
+
+        std::set<connection_t*> connections{};
+
+        for (auto* io_ctx : raw_io_ctxs) {
+            auto fut = boost::asio::co_spawn(
+                *io_ctx,
+
+                [&]() -> boost::asio::awaitable<void> {
+                    auto connection = pool.connection("pool:key");
+
+                    EXPECT_NE(connection, nullptr);
+
+                    // The connection runs on the I/O context of the caller
+                    EXPECT_EQ(pool.connection("pool:key"), connection);
+
+                    connections.insert(connection.get());
+
+                    EXPECT_TRUE(co_await connection->async_set("pool:key", "value"));
+
+                    EXPECT_EQ(co_await connection->async_get<std::string>("pool:key"), "value");
+
+                    EXPECT_TRUE(co_await connection->async_del("pool:key"));
+                },
+
+                boost::asio::use_future);
+
+            fut.get();
+        }
+
+        EXPECT_EQ(connections.size(), k_io_ctxs);
+
+        pool.shutdown();
+    }
+
+    guards.clear();
+
+    threads.clear();
+}
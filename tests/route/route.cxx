@@ -144,6 +144,45 @@ TEST_F(route_handler_test, async_route) {
     io_context.run();
 }
 
+TEST_F(route_handler_test, body_mode) {
+    auto handler = [](http::ctx_t ctx) -> types::base_response_t {
+        return types::text_response_t(ctx.body_stream() ? "streamed" : "buffered");
+    };
+
+    route_t buffered_route(types::method_t::post, "/buffered", decltype(handler){handler});
+
+    route_t streamed_route(
+        types::method_t::post, "/streamed", decltype(handler){handler}, e_body_mode::streamed
+    );
+
+    EXPECT_EQ(buffered_route.body_mode(), e_body_mode::buffered);
+    EXPECT_EQ(streamed_route.body_mode(), e_body_mode::streamed);
+
+    EXPECT_EQ(streamed_route.handle({}).body(), "buffered");
+}
+
+TEST_F(route_handler_test, executor) {
+    auto handler = [](http::ctx_t ctx) -> types::base_response_t {
+        return types::text_response_t("ok");
+    };
+
+    route_t io_route(types::method_t::get, "/io", decltype(handler){handler});
+
+    route_t blocking_route(
+        types::method_t::get,
+        "/blocking",
+        decltype(handler){handler},
+        e_body_mode::buffered,
+        e_executor::blocking
+    );
+
+    EXPECT_EQ(io_route.executor(), e_executor::io);
+    EXPECT_EQ(blocking_route.executor(), e_executor::blocking);
+
+    // The executor only tells the application where to call the handler
+    EXPECT_EQ(blocking_route.handle({}).body(), "ok");
+}
+
 TEST_F(route_handler_test, move_semantics) {
     auto sync_handler = [](http::ctx_t ctx) -> types::base_response_t {
         return types::text_response_t("sync response");
@@ -234,7 +273,7 @@ TEST_F(radix_tree_tests, node_splitting) {
 
 TEST_F(radix_tree_tests, InsertAndFindDynamicRoute) {
     tree.insert(types::method_t::get, "/users/{id}", [](ctx_t ctx) {
-        return types::text_response_t("user " + ctx.params().at("id"));
+        return types::text_response_t(fmt::format("user {}", ctx.params().at("id")));
     });
 
     auto result = tree.find(types::method_t::get, "/users/123");
@@ -257,7 +296,7 @@ TEST_F(radix_tree_tests, prioritize_static_route) {
         return types::text_response_t("profile");
     });
     tree.insert(types::method_t::get, "/users/{id}", [](ctx_t ctx) {
-        return types::text_response_t("user " + ctx.params().at("id"));
+        return types::text_response_t(fmt::format("user {}", ctx.params().at("id")));
     });
 
     auto res_dynamic = tree.find(types::method_t::get, "/users/abc");
@@ -310,7 +349,7 @@ TEST_F(radix_tree_tests, duplicate_route_throws_exception) {
 
 TEST_F(radix_tree_tests, multiple_dynamic_parameters) {
     tree.insert(types::method_t::get, "/users/{userId}/posts/{postId}", [](ctx_t ctx) {
-        return types::text_response_t("user " + ctx.params().at("userId") + " post " + ctx.params().at("postId"));
+        return types::text_response_t(fmt::format("user {} post {}", ctx.params().at("userId"), ctx.params().at("postId")));
     });
 
     auto result = tree.find(types::method_t::get, "/users/123/posts/abc");
@@ -350,4 +389,114 @@ TEST_F(radix_tree_tests, ambiguous_dynamic_routes_throw_exception) {
 
         exceptions::exception_t
     );
-}
\ No newline at end of file
+}
+TEST_F(radix_tree_tests, frozen_tree_finds_the_same_routes) {
+    tree.insert(types::method_t::get, "/", [](ctx_t) { return types::text_response_t("root"); });
+    tree.insert(types::method_t::get, "/team", [](ctx_t) { return types::text_response_t("team"); });
+    tree.insert(types::method_t::get, "/teams", [](ctx_t) { return types::text_response_t("teams"); });
+    tree.insert(types::method_t::post, "/teams", [](ctx_t) { return types::text_response_t("new team"); });
+    tree.insert(types::method_t::get, "/users/profile", [](ctx_t) {
+        return types::text_response_t("profile");
+    });
+    tree.insert(types::method_t::get, "/users/{userId}/posts/{postId}", [](ctx_t ctx) {
+        return types::text_response_t(fmt::format("{}/{}", ctx.params().at("userId"), ctx.params().at("postId")));
+    });
+
+    // More children than fit in one vector of keys
+    for (char c = 'a'; c <= 'z'; c++) {
+        tree.insert(types::method_t::get, std::string{"/letters/"} + c, [c](ctx_t) {
+            return types::text_response_t(std::string{c});
+        });
+    }
+
+    tree.freeze();
+
+    ASSERT_TRUE(tree.is_frozen());
+
+    const auto body_of = [this](types::method_t::e_method method, std::string_view path) {
+        types::params_t params{};
+
+        const auto* handler = tree.find(method, path, params);
+
+        return handler ? (*handler)(make_ctx(std::move(params))).body() : std::string{"<none>"};
+    };
+
+    EXPECT_EQ(body_of(types::method_t::get, "/"), "root");
+    EXPECT_EQ(body_of(types::method_t::get, "/team"), "team");
+    EXPECT_EQ(body_of(types::method_t::get, "/teams/"), "teams");
+    EXPECT_EQ(body_of(types::method_t::post, "/teams"), "new team");
+    EXPECT_EQ(body_of(types::method_t::put, "/teams"), "<none>");
+    EXPECT_EQ(body_of(types::method_t::get, "/users/profile"), "profile");
+    EXPECT_EQ(body_of(types::method_t::get, "/users/123/posts/abc"), "123/abc");
+    EXPECT_EQ(body_of(types::method_t::get, "/users/123/posts"), "<none>");
+    EXPECT_EQ(body_of(types::method_t::get, "/letters/a"), "a");
+    EXPECT_EQ(body_of(types::method_t::get, "/letters/z"), "z");
+    EXPECT_EQ(body_of(types::method_t::get, "/letters/0"), "<none>");
+    EXPECT_EQ(body_of(types::method_t::get, "/missing"), "<none>");
+}
+
+TEST_F(radix_tree_tests, insert_after_freeze_throws_exception) {
+    tree.insert(types::method_t::get, "/before", [](ctx_t) { return types::text_response_t("before"); });
+
+    tree.freeze();
+
+    EXPECT_THROW(
+        tree.insert(
+            types::method_t::get, "/after", [](ctx_t) { return types::text_response_t("after"); }
+        ),
+
+        exceptions::exception_t
+    );
+
+    EXPECT_TRUE(tree.find(types::method_t::get, "/before").has_value());
+}
+
+TEST_F(radix_tree_tests, too_many_dynamic_segments_throw_exception) {
+    EXPECT_THROW(
+        tree.insert(
+            types::method_t::get, "/{a}/{b}/{c}/{d}/{e}/{f}/{g}/{h}/{i}", [](ctx_t) { return types::text_response_t("nine"); }
+        ),
+
+        exceptions::exception_t
+    );
+
+    EXPECT_NO_THROW(
+        tree.insert(
+            types::method_t::get, "/{a}/{b}/{c}/{d}/{e}/{f}/{g}/{h}", [](ctx_t) { return types::text_response_t("eight"); }
+        )
+    );
+}
+
+TEST_F(radix_tree_tests, frozen_static_routes_take_the_fast_path) {
+    tree.insert(types::method_t::get, "/users/{id}", [](ctx_t ctx) {
+        return types::text_response_t(fmt::format("user {}", ctx.params().at("id")));
+    });
+
+    tree.insert(types::method_t::get, "/users/me", [](ctx_t) { return types::text_response_t("me"); });
+    tree.insert(types::method_t::post, "/users/me/", [](ctx_t) { return types::text_response_t("update me"); });
+
+    tree.freeze();
+
+    types::params_t params{};
+
+    const auto* handler = tree.find(types::method_t::get, "/users/me/", params);
+
+    ASSERT_NE(handler, nullptr);
+    EXPECT_TRUE(params.empty());
+    EXPECT_EQ((*handler)(make_ctx()).body(), "me");
+
+    handler = tree.find(types::method_t::post, "/users/me", params);
+
+    ASSERT_NE(handler, nullptr);
+    EXPECT_EQ((*handler)(make_ctx()).body(), "update me");
+
+    // A static path without a handler for the method falls back to the dynamic routes
+    EXPECT_FALSE(tree.find(types::method_t::put, "/users/me").has_value());
+
+    auto found = tree.find(types::method_t::get, "/users/42");
+
+    ASSERT_TRUE(found.has_value());
+    EXPECT_EQ(found->first(make_ctx(found->second)).body(), "user 42");
+    EXPECT_EQ(radix_tree_t<handler_t>::norm_view(""), "/");
+    EXPECT_EQ(radix_tree_t<handler_t>::norm_view("/users/"), "/users");
+}
@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/io_context.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <fmt/format.h>
+
+#include "clueapi/http/ctx/ctx.hxx"
+#include "clueapi/http/types/method/method.hxx"
+#include "clueapi/http/types/response/response.hxx"
+#include "clueapi/route/detail/detail.hxx"
+#include "clueapi/route/route.hxx"
+#include "clueapi/route/route_template/route_template.hxx"
+#include "clueapi/shared/shared.hxx"
+
+using namespace clueapi;
+using namespace clueapi::http;
+using namespace clueapi::route;
+
+namespace {
+    using post_template_t = route_template_t<"/users/{id:u64}/posts/{slug}">;
+
+    static_assert(post_template_t::k_path == "/users/{id}/posts/{slug}");
+    static_assert(post_template_t::k_param_count == 2);
+    static_assert(std::is_same_v<post_template_t::param_t<0>, std::uint64_t>);
+    static_assert(std::is_same_v<post_template_t::param_t<1>, std::string_view>);
+    static_assert(std::is_same_v<route_template_t<"/offset/{delta:i64}">::param_t<0>, std::int64_t>);
+    static_assert(route_template_t<"/health/">::k_path == "/health/");
+
+    static_assert(post_template_t::k_is_invocable<types::response_t (*)(ctx_t, std::uint64_t, std::string_view)>);
+    static_assert(!post_template_t::k_is_invocable<types::response_t (*)(ctx_t, std::string_view, std::uint64_t)>);
+    static_assert(!post_template_t::k_is_invocable<types::response_t (*)(ctx_t, std::uint64_t)>);
+
+    // Matches the path against the frozen router the way the server does
+    types::params_t match(std::string_view uri) {
+        route::detail::radix_tree_t<std::shared_ptr<base_route_t>> tree{};
+
+        tree.insert(types::method_t::get, types::path_t{post_template_t::k_path}, nullptr);
+
+        tree.freeze();
+
+        types::params_t params{};
+
+        EXPECT_NE(tree.find(types::method_t::get, uri, params), nullptr);
+
+        return params;
+    }
+} // namespace
+
+class route_template_tests : public ::testing::Test {};
+
+TEST_F(route_template_tests, parse_converts_the_parameters) {
+    const auto values = post_template_t::parse(match("/users/42/posts/hello-world"));
+
+    ASSERT_TRUE(values.has_value());
+    EXPECT_EQ(std::get<0>(*values), 42u);
+    EXPECT_EQ(std::get<1>(*values), "hello-world");
+
+    EXPECT_FALSE(post_template_t::parse(match("/users/4x2/posts/hello")).has_value());
+    EXPECT_FALSE(post_template_t::parse(match("/users/-1/posts/hello")).has_value());
+    EXPECT_FALSE(post_template_t::parse(match("/users/99999999999999999999/posts/hello")).has_value());
+    EXPECT_FALSE(post_template_t::parse(types::params_t{}).has_value());
+}
+
+TEST_F(route_template_tests, typed_route_calls_the_handler_with_typed_parameters) {
+    const std::string uri{"/users/7/posts/intro"};
+
+    auto handler = [](ctx_t, std::uint64_t id, std::string_view slug) -> types::response_t {
+        return types::text_response_t(fmt::format("{}:{}", id * 2, slug));
+    };
+
+    typed_route_t<post_template_t, decltype(handler)> route{handler};
+
+    EXPECT_FALSE(route.is_awaitable());
+
+    auto params = match(uri);
+
+    EXPECT_TRUE(route.accepts(params));
+    EXPECT_FALSE(route.accepts(match("/users/seven/posts/intro")));
+
+    EXPECT_EQ(route.handle(ctx_t{types::request_t{}, params}).body(), "14:intro");
+}
+
+TEST_F(route_template_tests, typed_route_awaits_a_coroutine_handler) {
+    auto handler = [](ctx_t, std::uint64_t id, std::string_view slug) -> shared::awaitable_t<types::response_t> {
+        co_return types::text_response_t(fmt::format("{}/{}", id, slug));
+    };
+
+    typed_route_t<post_template_t, decltype(handler)> route{handler};
+
+    EXPECT_TRUE(route.is_awaitable());
+
+    boost::asio::io_context io_context;
+
+    std::string body{};
+
+    boost::asio::co_spawn(
+        io_context,
+
+        [&]() -> boost::asio::awaitable<void> {
+            auto response = co_await route.handle_awaitable(ctx_t{types::request_t{}, match("/users/3/posts/news")});
+
+            body = response.body();
+        },
+
+        boost::asio::detached
+    );
+
+    io_context.run();
+
+    EXPECT_EQ(body, "3/news");
+}
@@ -0,0 +1,196 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "clueapi/server/detail/access_log/access_log.hxx"
+
+#ifndef _WIN32
+class access_log_tests : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        m_path = (std::filesystem::temp_directory_path() / "clueapi_access_log_test.log").string();
+
+        std::filesystem::remove(m_path);
+    }
+
+    void TearDown() override { std::filesystem::remove(m_path); }
+
+    [[nodiscard]] clueapi::cfg::cfg_t::access_log_t make_cfg() const {
+        clueapi::cfg::cfg_t::access_log_t cfg{};
+
+        cfg.m_enabled = true;
+        cfg.m_path    = m_path;
+
+        return cfg;
+    }
+
+    [[nodiscard]] std::string read() const {
+        std::ifstream file{m_path, std::ios::binary};
+
+        std::stringstream buffer{};
+
+        buffer << file.rdbuf();
+
+        return buffer.str();
+    }
+
+    std::string m_path;
+};
+
+TEST_F(access_log_tests, text_format) {
+    clueapi::server::detail::access_record_t record{};
+
+    // 2026-10-15T12:30:45.678Z
+    record.m_time    = 1792067445678000000;
+    record.m_bytes   = 512;
+    record.m_latency = 250;
+    record.m_status  = 200;
+    record.m_method  = clueapi::http::types::method_t::get;
+
+    const std::string_view target{"/users/1?x=\"y\""};
+
+    target.copy(record.m_target.data(), target.size());
+
+    record.m_target_size = static_cast<std::uint8_t>(target.size());
+
+    std::string out{};
+
+    clueapi::server::detail::c_access_log::format(out, record, clueapi::cfg::cfg_t::access_log_t::e_format::text);
+
+    EXPECT_EQ(out, "2026-10-15T12:30:45.678Z GET /users/1?x=\"y\" 200 512 250us\n");
+
+    out.clear();
+
+    clueapi::server::detail::c_access_log::format(out, record, clueapi::cfg::cfg_t::access_log_t::e_format::json);
+
+    EXPECT_EQ(
+        out,
+        R"({"time":"2026-10-15T12:30:45.678Z","method":"GET","target":"/users/1?x=\"y\"","status":200,"bytes":512,"latency_us":250})"
+        "\n");
+}
+
+TEST_F(access_log_tests, writes_on_stop) {
+    clueapi::server::detail::c_access_log access_log{make_cfg()};
+
+    ASSERT_TRUE(access_log.start());
+
+    access_log.log(clueapi::http::types::method_t::post, "/a", 201, 10, std::chrono::microseconds{5});
+    access_log.log(clueapi::http::types::method_t::get, std::string(300, 'x'), 404, 0, std::chrono::microseconds{1});
+
+    access_log.stop();
+
+    EXPECT_EQ(access_log.written(), 2u);
+
+    const auto content = read();
+
+    EXPECT_NE(content.find(" POST /a 201 10 5us\n"), std::string::npos);
+    EXPECT_NE(content.find(" GET " + std::string(clueapi::server::detail::access_record_t::k_max_target_size, 'x') + " 404 0 1us\n"), std::string::npos);
+}
+
+TEST_F(access_log_tests, sampling) {
+    auto cfg = make_cfg();
+
+    cfg.m_sample_rate              = 0.0;
+    cfg.m_client_error_sample_rate = 0.0;
+
+    clueapi::server::detail::c_access_log access_log{cfg};
+
+    ASSERT_TRUE(access_log.start());
+
+    for (int i = 0; i < 100; ++i) {
+        access_log.log(clueapi::http::types::method_t::get, "/ok", 200, 0, {});
+        access_log.log(clueapi::http::types::method_t::get, "/missing", 404, 0, {});
+    }
+
+    access_log.log(clueapi::http::types::method_t::get, "/error", 503, 0, {});
+
+    access_log.stop();
+
+    EXPECT_EQ(access_log.written(), 1u);
+    EXPECT_NE(read().find("/error 503"), std::string::npos);
+}
+
+TEST_F(access_log_tests, binary_records) {
+    auto cfg = make_cfg();
+
+    cfg.m_format = clueapi::cfg::cfg_t::access_log_t::e_format::binary;
+
+    clueapi::server::detail::c_access_log access_log{cfg};
+
+    ASSERT_TRUE(access_log.start());
+
+    constexpr int k_threads{4};
+    constexpr int k_per_thread{1000};
+
+    std::vector<std::thread> threads{};
+
+    for (int t = 0; t < k_threads; ++t) {
+        threads.emplace_back([&access_log, t]() {
+            for (int i = 0; i < k_per_thread; ++i)
+                access_log.log(clueapi::http::types::method_t::get, "/t" + std::to_string(t), 200, static_cast<std::uint64_t>(i), {});
+        });
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    access_log.stop();
+
+    const auto content = read();
+
+    ASSERT_EQ(content.size(), k_threads * k_per_thread * sizeof(clueapi::server::detail::access_record_t));
+
+    std::vector<int> counts(k_threads);
+
+    for (std::size_t offset{}; offset < content.size(); offset += sizeof(clueapi::server::detail::access_record_t)) {
+        clueapi::server::detail::access_record_t record{};
+
+        std::memcpy(&record, content.data() + offset, sizeof(record));
+
+        ASSERT_EQ(record.m_status, 200u);
+
+        counts[record.target()[2] - '0']++;
+    }
+
+    for (const auto count : counts)
+        EXPECT_EQ(count, k_per_thread);
+
+    EXPECT_EQ(access_log.dropped(), 0u);
+}
+
+TEST_F(access_log_tests, drops_when_full) {
+    auto cfg = make_cfg();
+
+    cfg.m_buffer_size    = 4;
+    cfg.m_flush_interval = std::chrono::hours{1};
+
+    clueapi::server::detail::c_access_log access_log{cfg};
+
+    ASSERT_TRUE(access_log.start());
+
+    for (int i = 0; i < 10; ++i)
+        access_log.log(clueapi::http::types::method_t::get, "/", 200, 0, {});
+
+    access_log.stop();
+
+    EXPECT_EQ(access_log.written() + access_log.dropped(), 10u);
+    EXPECT_GE(access_log.dropped(), 1u);
+}
+
+TEST_F(access_log_tests, fails_to_open) {
+    auto cfg = make_cfg();
+
+    cfg.m_path = "/nonexistent-directory/access.log";
+
+    clueapi::server::detail::c_access_log access_log{cfg};
+
+    EXPECT_FALSE(access_log.start());
+}
+#endif // _WIN32
@@ -0,0 +1,185 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "clueapi/server/detail/client_pool/client_pool.hxx"
+
+struct dummy_client_t {
+    explicit dummy_client_t(int id) : m_id{id} {}
+
+    int m_id;
+};
+
+class client_pool_tests : public ::testing::Test {
+  protected:
+    using pool_t = clueapi::server::detail::client_pool_t<dummy_client_t>;
+
+    void fill(std::size_t shards, std::size_t per_shard) {
+        pool.init(shards);
+
+        int id{};
+
+        for (std::size_t shard = 0; shard < shards; ++shard) {
+            for (std::size_t i = 0; i < per_shard; ++i)
+                pool.add(shard, std::make_unique<dummy_client_t>(id++));
+        }
+    }
+
+    pool_t pool;
+};
+
+TEST_F(client_pool_tests, acquire_prefers_local_shard) {
+    fill(3, 2);
+
+    EXPECT_EQ(pool.num_shards(), 3u);
+    EXPECT_EQ(pool.capacity(), 6u);
+    EXPECT_EQ(pool.available(), 6u);
+
+    auto* slot = pool.acquire(1);
+
+    ASSERT_NE(slot, nullptr);
+
+    EXPECT_EQ(slot->m_shard, 1u);
+
+    EXPECT_EQ(pool.stats(1).m_available, 1u);
+    EXPECT_EQ(pool.stats(1).m_stolen, 0u);
+
+    pool.release(slot);
+
+    EXPECT_EQ(pool.available(), 6u);
+}
+
+TEST_F(client_pool_tests, steals_only_when_local_shard_is_empty) {
+    fill(2, 1);
+
+    auto* local = pool.acquire(0);
+
+    ASSERT_NE(local, nullptr);
+
+    EXPECT_EQ(local->m_shard, 0u);
+
+    auto* stolen = pool.acquire(0);
+
+    ASSERT_NE(stolen, nullptr);
+
+    EXPECT_EQ(stolen->m_shard, 1u);
+
+    EXPECT_EQ(pool.stats(0).m_stolen, 1u);
+
+    EXPECT_EQ(pool.acquire(0), nullptr);
+
+    EXPECT_EQ(pool.stats(0).m_misses, 1u);
+
+    // A stolen client goes back to the shard that owns it
+    pool.release(stolen);
+
+    EXPECT_EQ(pool.stats(1).m_available, 1u);
+    EXPECT_EQ(pool.stats(0).m_available, 0u);
+
+    pool.release(local);
+
+    EXPECT_EQ(pool.stats(0).m_available, 1u);
+    EXPECT_EQ(pool.stats(0).m_released, 1u);
+}
+
+TEST_F(client_pool_tests, concurrent_acquire_release) {
+    constexpr std::size_t k_shards = 4;
+
+    fill(k_shards, 8);
+
+    std::atomic<std::size_t> failures{0};
+
+    std::vector<std::thread> threads;
+
+    for (std::size_t t = 0; t < k_shards; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < 10000; ++i) {
+                auto* slot = pool.acquire(t);
+
+                if (!slot) {
+                    failures++;
+
+                    continue;
+                }
+
+                pool.release(slot);
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    EXPECT_EQ(failures, 0u);
+
+    EXPECT_EQ(pool.available(), pool.capacity());
+
+    std::set<int> ids;
+
+    pool.for_each([&](dummy_client_t& client) { ids.insert(client.m_id); });
+
+    EXPECT_EQ(ids.size(), 32u);
+}
+
+TEST_F(client_pool_tests, clear) {
+    fill(2, 2);
+
+    pool.clear();
+
+    EXPECT_EQ(pool.num_shards(), 0u);
+    EXPECT_EQ(pool.capacity(), 0u);
+    EXPECT_EQ(pool.acquire(0), nullptr);
+}
+
+TEST_F(client_pool_tests, grow_up_to_hard_maximum) {
+    pool.init(2);
+
+    int id{};
+
+    auto factory = [&] { return std::make_unique<dummy_client_t>(id++); };
+
+    auto* first = pool.grow(1, 2, factory);
+    auto* second = pool.grow(0, 2, factory);
+
+    ASSERT_NE(first, nullptr);
+    ASSERT_NE(second, nullptr);
+
+    EXPECT_EQ(first->m_shard, 1u);
+
+    EXPECT_EQ(pool.grow(0, 2, factory), nullptr);
+
+    EXPECT_EQ(pool.capacity(), 2u);
+    EXPECT_EQ(pool.available(), 0u);
+    EXPECT_EQ(pool.stats(1).m_grown, 1u);
+
+    pool.release(first);
+    pool.release(second);
+
+    EXPECT_EQ(pool.available(), 2u);
+}
+
+TEST_F(client_pool_tests, trim_idle_clients_above_warm_minimum) {
+    fill(1, 4);
+
+    // Nothing has been idle long enough yet
+    EXPECT_EQ(pool.trim(0, 1, std::chrono::hours{1}), 0u);
+
+    auto* busy = pool.acquire(0);
+
+    ASSERT_NE(busy, nullptr);
+
+    EXPECT_EQ(pool.trim(0, 2, std::chrono::nanoseconds{0}), 2u);
+
+    EXPECT_EQ(pool.capacity(), 2u);
+    EXPECT_EQ(pool.available(), 1u);
+    EXPECT_EQ(pool.stats(0).m_trimmed, 2u);
+
+    pool.release(busy);
+
+    EXPECT_EQ(pool.trim(0, 2, std::chrono::nanoseconds{0}), 0u);
+    EXPECT_EQ(pool.available(), 2u);
+}
@@ -0,0 +1,378 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/asio/write.hpp>
+
+#include <nghttp2/nghttp2.h>
+
+#include "clueapi/cfg/cfg.hxx"
+#include "clueapi/http/chunks/chunks.hxx"
+#include "clueapi/server/http2/http2.hxx"
+#include "clueapi/shared/buffer_pool/buffer_pool.hxx"
+
+namespace http2 = clueapi::server::http2;
+
+namespace types = clueapi::http::types;
+
+class http2_tests : public ::testing::Test {
+  protected:
+    using tcp = boost::asio::ip::tcp;
+
+    // A response received by the client
+    struct result_t {
+        std::string m_status;
+
+        std::map<std::string, std::string> m_headers;
+
+        std::string m_body;
+
+        bool m_is_closed{};
+
+        std::uint32_t m_error_code{};
+    };
+
+    // A blocking client on its own socket, driven by nghttp2
+    struct client_t {
+        explicit client_t(boost::asio::io_context& io_ctx) : m_socket{io_ctx} {
+            nghttp2_session_callbacks* callbacks{};
+
+            nghttp2_session_callbacks_new(&callbacks);
+
+            nghttp2_session_callbacks_set_on_header_callback(
+                callbacks,
+                [](nghttp2_session*, const nghttp2_frame* frame, const std::uint8_t* name, std::size_t namelen,
+                   const std::uint8_t* value, std::size_t valuelen, std::uint8_t, void* user_data) -> int {
+                    auto& result = static_cast<client_t*>(user_data)->m_results[frame->hd.stream_id];
+
+                    std::string key{reinterpret_cast<const char*>(name), namelen};
+                    std::string val{reinterpret_cast<const char*>(value), valuelen};
+
+                    if (key == ":status")
+                        result.m_status = val;
+                    else
+                        result.m_headers[key] = val;
+
+                    return 0;
+                });
+
+            nghttp2_session_callbacks_set_on_data_chunk_recv_callback(
+                callbacks,
+                [](nghttp2_session*, std::uint8_t, std::int32_t stream_id, const std::uint8_t* data, std::size_t len,
+                   void* user_data) -> int {
+                    static_cast<client_t*>(user_data)->m_results[stream_id].m_body.append(
+                        reinterpret_cast<const char*>(data), len);
+
+                    return 0;
+                });
+
+            nghttp2_session_callbacks_set_on_stream_close_callback(
+                callbacks, [](nghttp2_session*, std::int32_t stream_id, std::uint32_t error_code, void* user_data) -> int {
+                    auto& self = *static_cast<client_t*>(user_data);
+
+                    self.m_results[stream_id].m_is_closed = true;
+                    self.m_results[stream_id].m_error_code = error_code;
+
+                    self.m_close_order.push_back(stream_id);
+
+                    return 0;
+                });
+
+            nghttp2_session_client_new(&m_session, callbacks, this);
+
+            nghttp2_session_callbacks_del(callbacks);
+
+            nghttp2_submit_settings(m_session, NGHTTP2_FLAG_NONE, nullptr, 0);
+        }
+
+        ~client_t() {
+            nghttp2_session_del(m_session);
+        }
+
+        std::int32_t submit(std::string method, std::string path, const std::string* body = nullptr) {
+            std::vector<std::pair<std::string, std::string>> fields{
+                {":method", std::move(method)}, {":path", std::move(path)}, {":scheme", "http"}, {":authority", "localhost"}};
+
+            std::vector<nghttp2_nv> nva{};
+
+            for (auto& [name, value] : fields)
+                nva.push_back(nghttp2_nv{
+                    reinterpret_cast<std::uint8_t*>(name.data()), reinterpret_cast<std::uint8_t*>(value.data()), name.size(),
+                    value.size(), NGHTTP2_NV_FLAG_NONE});
+
+            nghttp2_data_provider provider{};
+
+            if (body) {
+                m_sources.push_back(std::make_unique<source_t>(source_t{*body, 0u}));
+
+                provider.source.ptr = m_sources.back().get();
+
+                provider.read_callback = [](nghttp2_session*, std::int32_t, std::uint8_t* buf, std::size_t length,
+                                            std::uint32_t* data_flags, nghttp2_data_source* source, void*) -> ssize_t {
+                    auto& src = *static_cast<source_t*>(source->ptr);
+
+                    const auto size = std::min(length, src.m_data.size() - src.m_offset);
+
+                    std::memcpy(buf, src.m_data.data() + src.m_offset, size);
+
+                    src.m_offset += size;
+
+                    if (src.m_offset == src.m_data.size())
+                        *data_flags |= NGHTTP2_DATA_FLAG_EOF;
+
+                    return static_cast<ssize_t>(size);
+                };
+            }
+
+            return nghttp2_submit_request(m_session, nullptr, nva.data(), nva.size(), body ? &provider : nullptr, nullptr);
+        }
+
+        // Sends and receives until the streams are closed
+        void run(const std::vector<std::int32_t>& ids) {
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{5};
+
+            auto is_done = [&] {
+                for (auto id : ids)
+                    if (!m_results[id].m_is_closed)
+                        return false;
+
+                return true;
+            };
+
+            while (!is_done() && std::chrono::steady_clock::now() < deadline) {
+                const std::uint8_t* data{};
+
+                for (ssize_t size{}; (size = nghttp2_session_mem_send(m_session, &data)) > 0;)
+                    boost::asio::write(m_socket, boost::asio::buffer(data, static_cast<std::size_t>(size)));
+
+                if (is_done())
+                    break;
+
+                std::array<std::uint8_t, 16384> buffer{};
+
+                boost::system::error_code ec{};
+
+                const auto read = m_socket.read_some(boost::asio::buffer(buffer), ec);
+
+                if (ec)
+                    break;
+
+                ASSERT_GE(nghttp2_session_mem_recv(m_session, buffer.data(), read), 0);
+            }
+        }
+
+        struct source_t {
+            std::string m_data;
+
+            std::size_t m_offset;
+        };
+
+        tcp::socket m_socket;
+
+        nghttp2_session* m_session{};
+
+        std::map<std::int32_t, result_t> m_results;
+
+        std::vector<std::int32_t> m_close_order;
+
+        std::vector<std::unique_ptr<source_t>> m_sources;
+    };
+
+    void SetUp() override {
+        m_thread = std::thread{[this] { m_io_ctx.run(); }};
+    }
+
+    void TearDown() override {
+        m_client.reset();
+
+        m_guard.reset();
+
+        m_thread.join();
+    }
+
+    // Serves a connection of the client with the dispatch function
+    void serve(http2::dispatch_t dispatch) {
+        tcp::acceptor acceptor{m_io_ctx, tcp::endpoint{boost::asio::ip::address_v4::loopback(), 0}};
+
+        m_client = std::make_unique<client_t>(m_io_ctx);
+
+        m_client->m_socket.connect(acceptor.local_endpoint());
+
+        auto server = std::make_shared<tcp::socket>(m_io_ctx);
+
+        acceptor.accept(*server);
+
+        boost::asio::co_spawn(
+            m_io_ctx,
+            [this, server, dispatch = std::move(dispatch)]() -> boost::asio::awaitable<void> {
+                clueapi::shared::pooled_buffer_t buffer{};
+
+                http2::c_connection connection{*server, buffer, m_cfg, dispatch};
+
+                co_await connection.run();
+            },
+            boost::asio::detached);
+    }
+
+    boost::asio::io_context m_io_ctx;
+
+    boost::asio::executor_work_guard<boost::asio::io_context::executor_type> m_guard{m_io_ctx.get_executor()};
+
+    std::thread m_thread;
+
+    clueapi::cfg::cfg_t m_cfg{};
+
+    std::unique_ptr<client_t> m_client;
+};
+
+TEST_F(http2_tests, detects_the_preface) {
+    EXPECT_TRUE(http2::c_connection::is_preface(""));
+    EXPECT_TRUE(http2::c_connection::is_preface("PRI * HT"));
+    EXPECT_TRUE(http2::c_connection::is_preface(std::string{http2::k_preface} + "\x00\x00"));
+
+    EXPECT_FALSE(http2::c_connection::is_preface("POST / HTTP/1.1\r\n"));
+    EXPECT_FALSE(http2::c_connection::is_preface("GET / HTTP/1.1\r\n"));
+}
+
+TEST_F(http2_tests, serves_concurrent_streams) {
+    serve([this](const types::request_t& request) -> clueapi::shared::awaitable_t<types::response_t> {
+        types::response_t response{};
+
+        response.status() = types::status_t::ok;
+
+        if (request.uri() == "/slow") {
+            boost::asio::steady_timer timer{m_io_ctx, std::chrono::milliseconds{100}};
+
+            co_await timer.async_wait(boost::asio::use_awaitable);
+        }
+
+        response.headers().insert_or_assign("X-Path", std::string{request.uri()});
+        response.headers().insert_or_assign("Connection", "keep-alive");
+
+        response.body() = request.method() == types::method_t::post ? request.body() : "hello";
+
+        co_return response;
+    });
+
+    const std::string body(100000u, 'b');
+
+    const auto slow = m_client->submit("GET", "/slow");
+    const auto fast = m_client->submit("GET", "/fast");
+    const auto echo = m_client->submit("POST", "/echo", &body);
+
+    m_client->run({slow, fast, echo});
+
+    auto& results = m_client->m_results;
+
+    EXPECT_EQ(results[slow].m_status, "200");
+    EXPECT_EQ(results[slow].m_body, "hello");
+    EXPECT_EQ(results[slow].m_headers["x-path"], "/slow");
+    EXPECT_EQ(results[slow].m_headers["content-length"], "5");
+    EXPECT_EQ(results[slow].m_headers.count("connection"), 0u);
+    EXPECT_EQ(results[slow].m_headers.count("date"), 1u);
+
+    EXPECT_EQ(results[echo].m_body, body);
+
+    // The slow handler doesn't hold the other streams back
+    ASSERT_EQ(m_client->m_close_order.size(), 3u);
+    EXPECT_EQ(m_client->m_close_order.back(), slow);
+}
+
+TEST_F(http2_tests, sends_no_body_for_head_and_no_content) {
+    serve([](const types::request_t& request) -> clueapi::shared::awaitable_t<types::response_t> {
+        types::response_t response{};
+
+        response.status() = request.uri() == "/empty" ? types::status_t::no_content : types::status_t::ok;
+
+        response.body() = "ignored";
+
+        co_return response;
+    });
+
+    const auto head = m_client->submit("HEAD", "/");
+    const auto empty = m_client->submit("GET", "/empty");
+
+    m_client->run({head, empty});
+
+    auto& results = m_client->m_results;
+
+    EXPECT_EQ(results[head].m_status, "200");
+    EXPECT_EQ(results[head].m_headers["content-length"], "7");
+    EXPECT_TRUE(results[head].m_body.empty());
+
+    EXPECT_EQ(results[empty].m_status, "204");
+    EXPECT_EQ(results[empty].m_headers.count("content-length"), 0u);
+    EXPECT_TRUE(results[empty].m_body.empty());
+}
+
+TEST_F(http2_tests, streams_response_bodies) {
+    m_cfg.m_http2.m_max_buffered_bytes = 4096u;
+
+    serve([](const types::request_t&) -> clueapi::shared::awaitable_t<types::response_t> {
+        types::response_t response{};
+
+        response.status() = types::status_t::ok;
+
+        response.is_stream() = true;
+
+        response.stream_fn() = [](clueapi::http::chunks::chunk_writer_t& writer) -> clueapi::exceptions::expected_awaitable_t<void> {
+            for (char c{'a'}; c <= 'z'; c++) {
+                if (auto written = co_await writer.write_chunk(std::string(8192u, c)); !written.has_value())
+                    co_return written;
+            }
+
+            co_return clueapi::exceptions::expected_t<void>{};
+        };
+
+        co_return response;
+    });
+
+    const auto id = m_client->submit("GET", "/events");
+
+    m_client->run({id});
+
+    auto& result = m_client->m_results[id];
+
+    EXPECT_EQ(result.m_status, "200");
+    EXPECT_EQ(result.m_headers.count("content-length"), 0u);
+    ASSERT_EQ(result.m_body.size(), 26u * 8192u);
+    EXPECT_EQ(result.m_body.front(), 'a');
+    EXPECT_EQ(result.m_body.back(), 'z');
+}
+
+TEST_F(http2_tests, refuses_too_large_bodies) {
+    m_cfg.m_http.m_max_request_size = 1024u;
+
+    bool is_dispatched{};
+
+    serve([&is_dispatched](const types::request_t&) -> clueapi::shared::awaitable_t<types::response_t> {
+        is_dispatched = true;
+
+        co_return types::response_t{};
+    });
+
+    const std::string body(4096u, 'x');
+
+    const auto id = m_client->submit("POST", "/upload", &body);
+
+    m_client->run({id});
+
+    EXPECT_EQ(m_client->m_results[id].m_status, "413");
+    EXPECT_FALSE(is_dispatched);
+}
@@ -0,0 +1,301 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <set>
+#include <string>
+#include <thread>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/http/read.hpp>
+#include <boost/beast/http/string_body.hpp>
+#include <boost/beast/http/write.hpp>
+
+#include <poll.h>
+#include <unistd.h>
+
+#include "clueapi/clueapi.hxx"
+
+#include "clueapi/exceptions/exceptions.hxx"
+
+#include "clueapi/server/detail/supervisor/supervisor.hxx"
+
+using clueapi::server::detail::c_supervisor;
+
+using namespace std::chrono_literals;
+
+namespace {
+    clueapi::cfg::cfg_t::prefork_t make_cfg(std::size_t processes) {
+        clueapi::cfg::cfg_t::prefork_t cfg{};
+
+        cfg.m_enabled = true;
+        cfg.m_processes = processes;
+        cfg.m_ready_timeout = 2000ms;
+        cfg.m_restart_delay = 10ms;
+        cfg.m_drain_timeout = 2000ms;
+
+        return cfg;
+    }
+
+    // Each worker reports its pid through the pipe, then waits for `SIGTERM`
+    struct pids_pipe_t {
+        pids_pipe_t() {
+            EXPECT_EQ(::pipe(m_fds), 0);
+        }
+
+        ~pids_pipe_t() {
+            ::close(m_fds[0]);
+            ::close(m_fds[1]);
+        }
+
+        c_supervisor::worker_fn_t worker() const {
+            return [fd = m_fds[1]](std::size_t, const std::function<void()>& ready) {
+                const auto pid = ::getpid();
+
+                [[maybe_unused]] const auto written = ::write(fd, &pid, sizeof(pid));
+
+                ready();
+
+                while (true)
+                    ::pause();
+
+                return EXIT_SUCCESS;
+            };
+        }
+
+        std::set<pid_t> read(std::size_t count) const {
+            std::set<pid_t> ret{};
+
+            while (ret.size() < count) {
+                pollfd pfd{m_fds[0], POLLIN, 0};
+
+                if (::poll(&pfd, 1, 5000) <= 0)
+                    break;
+
+                pid_t pid{};
+
+                if (::read(m_fds[0], &pid, sizeof(pid)) != sizeof(pid))
+                    break;
+
+                ret.insert(pid);
+            }
+
+            return ret;
+        }
+
+        int m_fds[2]{-1, -1};
+    };
+
+    bool is_alive(pid_t pid) {
+        return ::kill(pid, 0) == 0;
+    }
+
+    // Asks the server which worker process serves a new connection, 0 on failure
+    pid_t served_by(std::uint16_t port) {
+        namespace http = boost::beast::http;
+
+        try {
+            boost::asio::io_context io_ctx{};
+
+            boost::asio::ip::tcp::socket socket{io_ctx};
+
+            socket.connect({boost::asio::ip::address_v4::loopback(), port});
+
+            http::request<http::string_body> req{http::verb::get, "/pid", 11};
+
+            req.set(http::field::host, "127.0.0.1");
+            req.set(http::field::connection, "close");
+
+            http::write(socket, req);
+
+            boost::beast::flat_buffer buffer{};
+
+            http::response<http::string_body> res{};
+
+            http::read(socket, buffer, res);
+
+            return static_cast<pid_t>(std::stol(res.body()));
+        } catch (...) {
+            return 0;
+        }
+    }
+
+    std::uint16_t free_port() {
+        boost::asio::io_context io_ctx{};
+
+        boost::asio::ip::tcp::acceptor acceptor{
+            io_ctx, {boost::asio::ip::address_v4::loopback(), 0}};
+
+        return acceptor.local_endpoint().port();
+    }
+
+    template <typename Fn>
+    bool eventually(Fn&& fn) {
+        for (int i{}; i < 200; i++) {
+            if (fn())
+                return true;
+
+            std::this_thread::sleep_for(10ms);
+        }
+
+        return fn();
+    }
+} // namespace
+
+TEST(supervisor_tests, starts_and_stops_workers) {
+    pids_pipe_t pipe{};
+
+    c_supervisor supervisor{make_cfg(2u), pipe.worker(), {}};
+
+    supervisor.start();
+
+    EXPECT_EQ(supervisor.workers(), 2u);
+
+    const auto pids = pipe.read(2u);
+
+    ASSERT_EQ(pids.size(), 2u);
+
+    for (auto pid : pids)
+        EXPECT_TRUE(is_alive(pid));
+
+    supervisor.stop();
+
+    EXPECT_EQ(supervisor.workers(), 0u);
+
+    // The workers are reaped once stopped
+    for (auto pid : pids)
+        EXPECT_FALSE(is_alive(pid));
+}
+
+TEST(supervisor_tests, restarts_exited_workers) {
+    pids_pipe_t pipe{};
+
+    c_supervisor supervisor{make_cfg(1u), pipe.worker(), {}};
+
+    supervisor.start();
+
+    const auto first = pipe.read(1u);
+
+    ASSERT_EQ(first.size(), 1u);
+
+    ::kill(*first.begin(), SIGKILL);
+
+    const auto second = pipe.read(1u);
+
+    ASSERT_EQ(second.size(), 1u);
+
+    EXPECT_NE(*second.begin(), *first.begin());
+
+    EXPECT_TRUE(eventually([&]() { return supervisor.restarts() == 1u; }));
+
+    EXPECT_TRUE(eventually([&]() { return supervisor.workers() == 1u; }));
+
+    supervisor.stop();
+}
+
+TEST(supervisor_tests, reload_replaces_workers) {
+    pids_pipe_t pipe{};
+
+    c_supervisor supervisor{make_cfg(2u), pipe.worker(), {}};
+
+    supervisor.start();
+
+    const auto old_pids = pipe.read(2u);
+
+    ASSERT_EQ(old_pids.size(), 2u);
+
+    supervisor.reload();
+
+    const auto new_pids = pipe.read(2u);
+
+    ASSERT_EQ(new_pids.size(), 2u);
+
+    for (auto pid : new_pids)
+        EXPECT_EQ(old_pids.count(pid), 0u);
+
+    // The replaced workers are drained, and reloading doesn't count as restarting
+    for (auto pid : old_pids)
+        EXPECT_TRUE(eventually([&]() { return !is_alive(pid); }));
+
+    EXPECT_EQ(supervisor.restarts(), 0u);
+
+    EXPECT_EQ(supervisor.workers(), 2u);
+
+    supervisor.stop();
+}
+
+TEST(supervisor_tests, throws_if_no_worker_is_ready) {
+    c_supervisor supervisor{
+        make_cfg(2u), [](std::size_t, const std::function<void()>&) { return EXIT_FAILURE; }, {}};
+
+    EXPECT_THROW(supervisor.start(), clueapi::exceptions::exception_t);
+
+    EXPECT_EQ(supervisor.workers(), 0u);
+}
+
+TEST(supervisor_tests, prefork_workers_share_the_port_and_reload) {
+    const auto port = free_port();
+
+    clueapi::c_clueapi api{};
+
+    api.add_method(
+        clueapi::http::types::method_t::get,
+        "/pid",
+        [](clueapi::http::ctx_t) -> clueapi::http::types::response_t {
+            return {std::to_string(::getpid()), clueapi::http::types::status_t::ok};
+        });
+
+    clueapi::cfg_t cfg{};
+
+    cfg.m_host = "127.0.0.1";
+    cfg.m_port = std::to_string(port);
+    cfg.m_workers = 1;
+    cfg.m_http.m_keep_alive_enabled = false;
+
+    cfg.m_prefork = make_cfg(2u);
+
+#ifdef CLUEAPI_USE_LOGGING_MODULE
+    cfg.m_logging_cfg.m_default_level = clueapi::modules::logging::e_log_level::off;
+#endif // CLUEAPI_USE_LOGGING_MODULE
+
+    ASSERT_NO_THROW(api.start(cfg));
+
+    ASSERT_TRUE(api.is_running());
+
+    // Every worker binds its own listener to the port, and the kernel spreads the connections
+    std::set<pid_t> old_pids{};
+
+    EXPECT_TRUE(eventually([&]() {
+        if (const auto pid = served_by(port))
+            old_pids.insert(pid);
+
+        return old_pids.size() == 2u;
+    }));
+
+    api.reload();
+
+    // The replacements bind the port while the old workers still listen on it
+    std::set<pid_t> new_pids{};
+
+    EXPECT_TRUE(eventually([&]() {
+        const auto pid = served_by(port);
+
+        if (pid && !old_pids.count(pid))
+            new_pids.insert(pid);
+
+        return new_pids.size() == 2u;
+    }));
+
+    for (auto pid : old_pids)
+        EXPECT_TRUE(eventually([&]() { return !is_alive(pid); }));
+
+    api.stop();
+
+    EXPECT_TRUE(api.is_stopped());
+
+    for (auto pid : new_pids)
+        EXPECT_FALSE(is_alive(pid));
+}
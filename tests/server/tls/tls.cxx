@@ -0,0 +1,405 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/asio/write.hpp>
+
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <openssl/ssl.h>
+#include <openssl/x509.h>
+
+#include "clueapi/exceptions/exceptions.hxx"
+
+#include "clueapi/server/detail/tls/tls.hxx"
+
+using clueapi::server::detail::c_tls;
+
+using namespace std::chrono_literals;
+
+namespace {
+    // A self-signed certificate for localhost, written once for the whole suite
+    struct cert_files_t {
+        cert_files_t() {
+            m_dir = std::filesystem::temp_directory_path() / "clueapi_tls_tests";
+
+            std::filesystem::create_directories(m_dir);
+
+            m_cert = (m_dir / "cert.pem").string();
+            m_key = (m_dir / "key.pem").string();
+
+            auto* pkey = EVP_EC_gen("P-256");
+
+            auto* cert = X509_new();
+
+            X509_set_version(cert, 2);
+
+            ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+
+            X509_gmtime_adj(X509_getm_notBefore(cert), 0);
+            X509_gmtime_adj(X509_getm_notAfter(cert), 3600);
+
+            X509_set_pubkey(cert, pkey);
+
+            auto* name = X509_get_subject_name(cert);
+
+            X509_NAME_add_entry_by_txt(
+                name, "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char*>("localhost"), -1,
+                -1, 0);
+
+            X509_set_issuer_name(cert, name);
+
+            X509_sign(cert, pkey, EVP_sha256());
+
+            auto* cert_file = std::fopen(m_cert.c_str(), "w");
+
+            PEM_write_X509(cert_file, cert);
+
+            std::fclose(cert_file);
+
+            auto* key_file = std::fopen(m_key.c_str(), "w");
+
+            PEM_write_PrivateKey(key_file, pkey, nullptr, nullptr, 0, nullptr, nullptr);
+
+            std::fclose(key_file);
+
+            X509_free(cert);
+
+            EVP_PKEY_free(pkey);
+        }
+
+        ~cert_files_t() {
+            std::error_code ec{};
+
+            std::filesystem::remove_all(m_dir, ec);
+        }
+
+        std::filesystem::path m_dir;
+
+        std::string m_cert;
+
+        std::string m_key;
+    };
+
+    const cert_files_t& cert_files() {
+        static const cert_files_t files{};
+
+        return files;
+    }
+
+    clueapi::cfg::cfg_t::tls_t make_cfg(std::string secret = "shared secret") {
+        clueapi::cfg::cfg_t::tls_t cfg{};
+
+        cfg.m_enabled = true;
+        cfg.m_cert_file = cert_files().m_cert;
+        cfg.m_key_file = cert_files().m_key;
+        cfg.m_alpn = {"h2", "http/1.1"};
+        cfg.m_ticket_secret = std::move(secret);
+        cfg.m_handshake_timeout = 2000ms;
+
+        return cfg;
+    }
+
+    struct client_t {
+        int m_max_version{TLS1_3_VERSION};
+
+        std::string m_alpn{};
+
+        SSL_SESSION* m_session{};
+
+        // Set by the client once connected
+        bool m_is_connected{};
+
+        std::string m_selected_alpn{};
+    };
+
+    // Connects a blocking OpenSSL client to the port, keeping the session for resumption
+    void run_client(std::uint16_t port, client_t& client) {
+        boost::asio::io_context io_ctx{};
+
+        boost::asio::ip::tcp::socket socket{io_ctx};
+
+        socket.connect({boost::asio::ip::address_v4::loopback(), port});
+
+        auto* ctx = SSL_CTX_new(TLS_client_method());
+
+        SSL_CTX_set_max_proto_version(ctx, client.m_max_version);
+
+        auto* ssl = SSL_new(ctx);
+
+        SSL_set_fd(ssl, static_cast<int>(socket.native_handle()));
+
+        if (!client.m_alpn.empty()) {
+            std::string wire{};
+
+            wire.push_back(static_cast<char>(client.m_alpn.size()));
+
+            wire += client.m_alpn;
+
+            SSL_set_alpn_protos(
+                ssl, reinterpret_cast<const unsigned char*>(wire.data()),
+                static_cast<unsigned int>(wire.size()));
+        }
+
+        if (client.m_session)
+            SSL_set_session(ssl, client.m_session);
+
+        client.m_is_connected = SSL_connect(ssl) == 1;
+
+        if (client.m_is_connected) {
+            const unsigned char* alpn{};
+
+            unsigned int alpn_size{};
+
+            SSL_get0_alpn_selected(ssl, &alpn, &alpn_size);
+
+            if (alpn)
+                client.m_selected_alpn.assign(reinterpret_cast<const char*>(alpn), alpn_size);
+
+            if (client.m_session)
+                SSL_SESSION_free(client.m_session);
+
+            client.m_session = SSL_get1_session(ssl);
+
+            // Freed without a shutdown, OpenSSL would take the session for a broken one
+            SSL_set_shutdown(ssl, SSL_SENT_SHUTDOWN | SSL_RECEIVED_SHUTDOWN);
+        }
+
+        SSL_free(ssl);
+
+        SSL_CTX_free(ctx);
+    }
+
+    using serve_t =
+        std::function<clueapi::shared::awaitable_t<void>(boost::asio::ip::tcp::socket&)>;
+
+    // Accepts one connection and runs its handshake while `connect` runs on another thread, then
+    // serves the connection with `serve`
+    c_tls::handshake_t accept_one(
+        c_tls& tls, const std::function<void(std::uint16_t)>& connect, serve_t serve = {}) {
+        boost::asio::io_context io_ctx{};
+
+        boost::asio::ip::tcp::acceptor acceptor{
+            io_ctx, {boost::asio::ip::address_v4::loopback(), 0}};
+
+        c_tls::handshake_t ret{};
+
+        boost::asio::co_spawn(
+            io_ctx,
+            [&]() -> clueapi::shared::awaitable_t<void> {
+                auto socket = co_await acceptor.async_accept(boost::asio::use_awaitable);
+
+                ret = co_await tls.handshake(socket);
+
+                if (serve && ret.m_status != c_tls::e_status::failed)
+                    co_await serve(socket);
+            },
+            boost::asio::detached);
+
+        std::thread thread{[&]() { connect(acceptor.local_endpoint().port()); }};
+
+        io_ctx.run();
+
+        thread.join();
+
+        return ret;
+    }
+} // namespace
+
+TEST(tls_tests, start_throws_on_missing_files) {
+    auto cfg = make_cfg();
+
+    cfg.m_cert_file = "/nonexistent/cert.pem";
+
+    c_tls tls{cfg};
+
+    EXPECT_THROW(tls.start(), clueapi::exceptions::exception_t);
+}
+
+TEST(tls_tests, handshake_selects_alpn) {
+    c_tls tls{make_cfg()};
+
+    tls.start();
+
+    client_t client{.m_alpn = "http/1.1"};
+
+    const auto result = accept_one(tls, [&](std::uint16_t port) { run_client(port, client); });
+
+    EXPECT_TRUE(client.m_is_connected);
+
+    // Whether the kernel takes the session depends on its `tls` module
+    EXPECT_NE(result.m_status, c_tls::e_status::failed);
+
+    EXPECT_EQ(result.m_alpn, "http/1.1");
+    EXPECT_EQ(client.m_selected_alpn, "http/1.1");
+
+    EXPECT_EQ(tls.handshakes(), 1u);
+    EXPECT_EQ(tls.failed(), 0u);
+
+    if (result.m_status == c_tls::e_status::user_space)
+        EXPECT_EQ(tls.not_offloaded(), 1u);
+
+    SSL_SESSION_free(client.m_session);
+}
+
+TEST(tls_tests, serves_the_session_through_the_socket) {
+    c_tls tls{make_cfg()};
+
+    tls.start();
+
+    std::string received{};
+
+    std::string reply{};
+
+    auto is_closed = false;
+
+    const auto result = accept_one(
+        tls,
+        [&](std::uint16_t port) {
+            boost::asio::io_context io_ctx{};
+
+            boost::asio::ip::tcp::socket socket{io_ctx};
+
+            socket.connect({boost::asio::ip::address_v4::loopback(), port});
+
+            auto* ctx = SSL_CTX_new(TLS_client_method());
+
+            auto* ssl = SSL_new(ctx);
+
+            SSL_set_fd(ssl, static_cast<int>(socket.native_handle()));
+
+            if (SSL_connect(ssl) == 1) {
+                SSL_write(ssl, "ping", 4);
+
+                std::array<char, 16> buf{};
+
+                const auto size = SSL_read(ssl, buf.data(), static_cast<int>(buf.size()));
+
+                if (size > 0)
+                    reply.assign(buf.data(), static_cast<std::size_t>(size));
+
+                // The server closing the connection ends the session with a `close_notify`
+                is_closed = SSL_read(ssl, buf.data(), static_cast<int>(buf.size())) == 0 &&
+                            SSL_get_error(ssl, 0) == SSL_ERROR_ZERO_RETURN;
+            }
+
+            SSL_free(ssl);
+
+            SSL_CTX_free(ctx);
+        },
+        [&](boost::asio::ip::tcp::socket& socket) -> clueapi::shared::awaitable_t<void> {
+            // The plain bytes, whether the kernel or OpenSSL decrypts them
+            std::array<char, 16> buf{};
+
+            const auto size = co_await socket.async_read_some(
+                boost::asio::buffer(buf), boost::asio::use_awaitable);
+
+            received.assign(buf.data(), size);
+
+            co_await boost::asio::async_write(
+                socket, boost::asio::buffer(std::string_view{"pong"}), boost::asio::use_awaitable);
+
+            socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both);
+
+            socket.close();
+        });
+
+    ASSERT_NE(result.m_status, c_tls::e_status::failed);
+
+    EXPECT_EQ(received, "ping");
+    EXPECT_EQ(reply, "pong");
+
+    if (result.m_status == c_tls::e_status::user_space)
+        EXPECT_TRUE(is_closed);
+}
+
+TEST(tls_tests, start_throws_when_required_ktls_cant_be_used) {
+    auto cfg = make_cfg();
+
+    cfg.m_require_ktls = true;
+
+    // The kernel doesn't encrypt CBC records, whether it has the `tls` module or not
+    cfg.m_max_version = clueapi::cfg::cfg_t::tls_t::e_version::tls12;
+    cfg.m_ciphers = "ECDHE-ECDSA-AES128-SHA256";
+
+    c_tls tls{cfg};
+
+    EXPECT_THROW(tls.start(), clueapi::exceptions::exception_t);
+}
+
+TEST(tls_tests, resumes_tickets_across_instances) {
+    // Two workers, or processes, given the same secret
+    c_tls first{make_cfg()};
+    c_tls second{make_cfg()};
+
+    first.start();
+    second.start();
+
+    // TLS 1.2 sends the ticket within the handshake
+    client_t client{.m_max_version = TLS1_2_VERSION};
+
+    accept_one(first, [&](std::uint16_t port) { run_client(port, client); });
+
+    ASSERT_TRUE(client.m_is_connected);
+    ASSERT_NE(client.m_session, nullptr);
+
+    const auto result = accept_one(second, [&](std::uint16_t port) { run_client(port, client); });
+
+    EXPECT_TRUE(client.m_is_connected);
+
+    EXPECT_TRUE(result.m_resumed);
+
+    EXPECT_EQ(second.resumed(), 1u);
+
+    // Another secret doesn't know the ticket, the handshake is a full one
+    c_tls other{make_cfg("other secret")};
+
+    other.start();
+
+    const auto full = accept_one(other, [&](std::uint16_t port) { run_client(port, client); });
+
+    EXPECT_TRUE(client.m_is_connected);
+
+    EXPECT_NE(full.m_status, c_tls::e_status::failed);
+
+    EXPECT_FALSE(full.m_resumed);
+
+    SSL_SESSION_free(client.m_session);
+}
+
+TEST(tls_tests, handshake_times_out) {
+    auto cfg = make_cfg();
+
+    cfg.m_handshake_timeout = 100ms;
+
+    c_tls tls{cfg};
+
+    tls.start();
+
+    // A client that connects and never speaks
+    const auto result = accept_one(tls, [](std::uint16_t port) {
+        boost::asio::io_context io_ctx{};
+
+        boost::asio::ip::tcp::socket socket{io_ctx};
+
+        socket.connect({boost::asio::ip::address_v4::loopback(), port});
+
+        std::this_thread::sleep_for(300ms);
+    });
+
+    EXPECT_EQ(result.m_status, c_tls::e_status::failed);
+
+    EXPECT_EQ(tls.failed(), 1u);
+}
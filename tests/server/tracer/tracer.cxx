@@ -0,0 +1,211 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "clueapi/server/detail/tracer/tracer.hxx"
+
+using clueapi::shared::trace_clock_t;
+using clueapi::shared::trace_phase_t;
+using clueapi::shared::trace_t;
+
+namespace {
+    struct collecting_sink_t final : clueapi::shared::trace_sink_t {
+        void write(std::span<const clueapi::shared::trace_record_t> records) override {
+            std::lock_guard lock{m_mutex};
+
+            m_batches.push_back(records.size());
+
+            m_records.insert(m_records.end(), records.begin(), records.end());
+        }
+
+        std::mutex m_mutex;
+
+        std::vector<std::size_t> m_batches;
+
+        std::vector<clueapi::shared::trace_record_t> m_records;
+    };
+
+    constexpr std::string_view k_sampled_parent{
+        "00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01"};
+
+    constexpr std::string_view k_unsampled_parent{
+        "00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-00"};
+} // namespace
+
+class tracer_tests : public ::testing::Test {
+  protected:
+    [[nodiscard]] clueapi::cfg::cfg_t::tracing_t make_cfg() const {
+        clueapi::cfg::cfg_t::tracing_t cfg{};
+
+        cfg.m_enabled        = true;
+        cfg.m_sink           = m_sink;
+        cfg.m_slow_threshold = std::chrono::microseconds{0};
+        cfg.m_flush_interval = std::chrono::milliseconds{10};
+
+        return cfg;
+    }
+
+    // Runs a request through the tracer, with a span for every phase but the middlewares
+    static bool run(
+        clueapi::server::detail::c_tracer& tracer,
+        std::optional<std::string_view> traceparent = std::nullopt,
+        std::chrono::microseconds duration = std::chrono::microseconds{0}) {
+        trace_t trace{};
+
+        trace.reset(trace_clock_t::now());
+
+        tracer.begin(trace, traceparent);
+
+        {
+            const trace_t::scope_t scope{&trace, trace_phase_t::handler};
+
+            if (duration.count() > 0)
+                std::this_thread::sleep_for(duration);
+        }
+
+        // Still open when the response is sent, it ends with the trace
+        trace.open(trace_phase_t::write);
+
+        return tracer.end(trace, "GET", "/users/1", 200u);
+    }
+
+    std::shared_ptr<collecting_sink_t> m_sink{std::make_shared<collecting_sink_t>()};
+};
+
+TEST_F(tracer_tests, start_requires_sink) {
+    auto cfg = make_cfg();
+
+    cfg.m_sink.reset();
+
+    clueapi::server::detail::c_tracer tracer{cfg};
+
+    EXPECT_FALSE(tracer.start());
+}
+
+TEST_F(tracer_tests, samples_all) {
+    auto cfg = make_cfg();
+
+    cfg.m_sample_rate = 1.0;
+
+    clueapi::server::detail::c_tracer tracer{cfg};
+
+    ASSERT_TRUE(tracer.start());
+
+    EXPECT_TRUE(run(tracer));
+    EXPECT_TRUE(run(tracer, k_sampled_parent));
+
+    tracer.stop();
+
+    ASSERT_EQ(m_sink->m_records.size(), 2u);
+    EXPECT_EQ(tracer.exported(), 2u);
+
+    const auto& record = m_sink->m_records[0];
+
+    EXPECT_EQ(record.m_method, "GET");
+    EXPECT_EQ(record.m_target, "/users/1");
+    EXPECT_EQ(record.m_status, 200u);
+    EXPECT_TRUE(record.m_context.is_sampled());
+    EXPECT_LE(record.m_start, record.m_end);
+
+    ASSERT_EQ(record.m_spans.size(), 2u);
+
+    EXPECT_EQ(record.m_spans[0].m_phase, trace_phase_t::handler);
+    EXPECT_EQ(record.m_spans[1].m_phase, trace_phase_t::write);
+    EXPECT_EQ(record.m_spans[1].m_end, record.m_end);
+
+    for (const auto& span : record.m_spans) {
+        EXPECT_GE(span.m_start, record.m_start);
+        EXPECT_LE(span.m_end, record.m_end);
+    }
+
+    // The caller's trace continues, its span becomes the parent
+    const auto& child = m_sink->m_records[1];
+
+    EXPECT_EQ(child.m_context.traceparent().substr(0u, 36u), k_sampled_parent.substr(0u, 36u));
+    EXPECT_EQ(child.m_context.traceparent().substr(36u, 16u).size(), 16u);
+    EXPECT_NE(child.m_context.traceparent().substr(36u, 16u), k_sampled_parent.substr(36u, 16u));
+    EXPECT_EQ(child.m_parent_span_id[7], 0xb7u);
+}
+
+TEST_F(tracer_tests, follows_parent) {
+    auto cfg = make_cfg();
+
+    clueapi::server::detail::c_tracer tracer{cfg};
+
+    ASSERT_TRUE(tracer.start());
+
+    EXPECT_FALSE(run(tracer));
+    EXPECT_FALSE(run(tracer, k_unsampled_parent));
+    EXPECT_TRUE(run(tracer, k_sampled_parent));
+
+    tracer.stop();
+
+    EXPECT_EQ(m_sink->m_records.size(), 1u);
+
+    cfg.m_follow_parent = false;
+
+    clueapi::server::detail::c_tracer independent{cfg};
+
+    ASSERT_TRUE(independent.start());
+
+    EXPECT_FALSE(run(independent, k_sampled_parent));
+}
+
+TEST_F(tracer_tests, keeps_slow_requests) {
+    auto cfg = make_cfg();
+
+    cfg.m_slow_threshold = std::chrono::milliseconds{5};
+
+    clueapi::server::detail::c_tracer tracer{cfg};
+
+    ASSERT_TRUE(tracer.start());
+
+    EXPECT_FALSE(run(tracer));
+    EXPECT_TRUE(run(tracer, std::nullopt, std::chrono::milliseconds{10}));
+
+    tracer.stop();
+
+    ASSERT_EQ(m_sink->m_records.size(), 1u);
+
+    // Kept for its duration only, it is exported unsampled
+    EXPECT_FALSE(m_sink->m_records[0].m_context.is_sampled());
+}
+
+TEST_F(tracer_tests, exports_in_batches) {
+    auto cfg = make_cfg();
+
+    cfg.m_sample_rate    = 1.0;
+    cfg.m_batch_size     = 4u;
+    cfg.m_max_queued     = 16u;
+    cfg.m_flush_interval = std::chrono::hours{1};
+
+    clueapi::server::detail::c_tracer tracer{cfg};
+
+    ASSERT_TRUE(tracer.start());
+
+    for (std::size_t i{}; i < 10u; i++)
+        run(tracer);
+
+    tracer.flush();
+
+    EXPECT_EQ(tracer.exported(), 10u);
+
+    for (const auto size : m_sink->m_batches)
+        EXPECT_LE(size, 4u);
+
+    // Woken by full batches, the exporter may fall behind and drop, every trace is counted
+    for (std::size_t i{}; i < 20u; i++)
+        run(tracer);
+
+    tracer.stop();
+
+    EXPECT_EQ(tracer.exported() + tracer.dropped(), 30u);
+}
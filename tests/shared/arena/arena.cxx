@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+#include <boost/beast/http/fields.hpp>
+
+#include "clueapi/shared/arena/arena.hxx"
+
+using clueapi::shared::arena_t;
+
+namespace {
+    void fill_request_like(arena_t& arena) {
+        boost::beast::http::basic_fields<arena_t::allocator_t> fields{arena.allocator()};
+
+        fields.insert(boost::beast::http::field::host, "localhost");
+        fields.insert(boost::beast::http::field::user_agent, "clueapi-tests/1.0");
+        fields.insert("X-Custom-Header", std::string(200, 'x'));
+
+        std::pmr::vector<std::pmr::string> segments{&arena};
+
+        for (int i = 0; i < 16; i++)
+            segments.emplace_back("a segment long enough to defeat the small string optimization");
+    }
+} // namespace
+
+TEST(arena, reuses_blocks_after_reset) {
+    arena_t arena{1024};
+
+    fill_request_like(arena);
+
+    const auto warmed_up = arena.upstream_allocations();
+
+    EXPECT_GT(warmed_up, 0u);
+    EXPECT_GT(arena.bytes_used(), 0u);
+
+    for (int i = 0; i < 100; i++) {
+        arena.reset();
+
+        EXPECT_EQ(arena.bytes_used(), 0u);
+
+        fill_request_like(arena);
+    }
+
+    EXPECT_EQ(arena.upstream_allocations(), warmed_up);
+}
+
+TEST(arena, respects_alignment_and_large_allocations) {
+    arena_t arena{256};
+
+    auto* small = arena.allocate(3, 1);
+    auto* aligned = arena.allocate(64, 64);
+    auto* large = arena.allocate(10000, alignof(std::max_align_t));
+
+    EXPECT_NE(small, nullptr);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(aligned) % 64, 0u);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(large) % alignof(std::max_align_t), 0u);
+    EXPECT_GE(arena.capacity(), 10000u);
+
+    arena.release();
+
+    EXPECT_EQ(arena.capacity(), 0u);
+    EXPECT_EQ(arena.bytes_used(), 0u);
+}
+
+#ifndef NDEBUG
+TEST(arena, counts_allocations_in_debug_builds) {
+    arena_t arena{};
+
+    std::pmr::vector<int> values{&arena};
+
+    values.reserve(8);
+
+    EXPECT_EQ(arena.allocations(), 1u);
+
+    arena.reset();
+
+    EXPECT_EQ(arena.allocations(), 0u);
+}
+#endif
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <memory>
+
+#include "clueapi/shared/buffer_pool/buffer_pool.hxx"
+
+using clueapi::shared::buffer_allocator_t;
+using clueapi::shared::buffer_pool_t;
+using clueapi::shared::pooled_buffer_t;
+
+TEST(buffer_pool_tests, reuses_chunks_by_tier) {
+    buffer_pool_t pool{{.m_chunk_size = 1024u}, 4096u};
+
+    EXPECT_EQ(pool.chunk_size(), 1024u);
+    EXPECT_EQ(pool.large_chunk_size(), 4096u);
+
+    auto* small = pool.allocate(100u);
+    auto* large = pool.allocate(2048u);
+    auto* huge = pool.allocate(8192u);
+
+    EXPECT_EQ(pool.stats().m_borrowed, 2u);
+    EXPECT_EQ(pool.stats().m_allocated, 2u);
+
+    // A chunk holds the whole size of its tier
+    std::memset(small, 0, 1024u);
+    std::memset(large, 0, 4096u);
+
+    pool.deallocate(small, 100u);
+    pool.deallocate(large, 2048u);
+    pool.deallocate(huge, 8192u);
+
+    EXPECT_EQ(pool.stats().m_borrowed, 0u);
+    EXPECT_EQ(pool.stats().m_free, 2u);
+
+    EXPECT_EQ(pool.allocate(512u), small);
+    EXPECT_EQ(pool.allocate(4096u), large);
+
+    EXPECT_EQ(pool.stats().m_allocated, 2u);
+    EXPECT_EQ(pool.stats().m_free, 0u);
+
+    pool.deallocate(small, 512u);
+    pool.deallocate(large, 4096u);
+}
+
+TEST(buffer_pool_tests, frees_past_max_free) {
+    buffer_pool_t pool{{.m_chunk_size = 256u, .m_max_free_chunks = 1u}, 256u};
+
+    auto* first = pool.allocate(256u);
+    auto* second = pool.allocate(256u);
+
+    pool.deallocate(first, 256u);
+    pool.deallocate(second, 256u);
+
+    EXPECT_EQ(pool.stats().m_free, 1u);
+    EXPECT_EQ(pool.stats().m_allocated, 1u);
+
+    pool.trim();
+
+    EXPECT_EQ(pool.stats().m_free, 0u);
+    EXPECT_EQ(pool.stats().m_allocated, 0u);
+}
+
+TEST(buffer_pool_tests, buffer_borrows_and_returns_chunks) {
+    auto pool = std::make_shared<buffer_pool_t>(
+        buffer_pool_t::cfg_t{.m_chunk_size = 1024u}, 8192u);
+
+    pooled_buffer_t buffer{8192u, buffer_allocator_t<char>{pool}};
+
+    buffer.reserve(pool->chunk_size());
+
+    EXPECT_EQ(buffer.capacity(), 1024u);
+    EXPECT_EQ(pool->stats().m_borrowed, 1u);
+
+    // Outgrowing the chunk moves the bytes to a chunk of the large tier
+    buffer.commit(buffer.prepare(1000u).size());
+
+    buffer.commit(buffer.prepare(1000u).size());
+
+    EXPECT_EQ(buffer.size(), 2000u);
+    EXPECT_EQ(pool->stats().m_borrowed, 1u);
+    EXPECT_EQ(pool->stats().m_free, 1u);
+
+    buffer.consume(buffer.size());
+
+    buffer.shrink_to_fit();
+
+    EXPECT_EQ(buffer.capacity(), 0u);
+    EXPECT_EQ(pool->stats().m_borrowed, 0u);
+    EXPECT_EQ(pool->stats().m_free, 2u);
+
+    // A moved buffer keeps its pool
+    pooled_buffer_t moved{std::move(buffer)};
+
+    moved.reserve(pool->chunk_size());
+
+    EXPECT_EQ(pool->stats().m_borrowed, 1u);
+}
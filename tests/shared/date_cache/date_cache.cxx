@@ -0,0 +1,33 @@
+#include <gtest/gtest.h>
+
+#include <ctime>
+#include <string>
+#include <thread>
+
+#include "clueapi/shared/date_cache/date_cache.hxx"
+
+using clueapi::shared::date_cache_t;
+
+TEST(date_cache_tests, formats_imf_fixdate) {
+    date_cache_t::buffer_t buffer{};
+
+    EXPECT_EQ(date_cache_t::format(784111777, buffer), "Sun, 06 Nov 1994 08:49:37 GMT");
+
+    EXPECT_EQ(date_cache_t::format(0, buffer), "Thu, 01 Jan 1970 00:00:00 GMT");
+}
+
+TEST(date_cache_tests, now_is_cached_per_thread) {
+    const auto date = date_cache_t::now();
+
+    ASSERT_EQ(date.size(), date_cache_t::k_size);
+    EXPECT_TRUE(date.ends_with(" GMT"));
+
+    // Same thread, same storage
+    EXPECT_EQ(date_cache_t::now().data(), date.data());
+
+    const void* other{};
+
+    std::thread{[&other] { other = date_cache_t::now().data(); }}.join();
+
+    EXPECT_NE(other, static_cast<const void*>(date.data()));
+}
@@ -9,6 +9,7 @@
 #include <algorithm>
 
 #include "clueapi/shared/io_ctx_pool/io_ctx_pool.hxx"
+#include "clueapi/shared/io_ctx_pool/detail/topology/topology.hxx"
 
 class io_ctx_pool_tests : public ::testing::Test {
   protected:
@@ -147,4 +148,175 @@ TEST_F(io_ctx_pool_tests, restart_pool) {
     pool.stop();
 
     EXPECT_EQ(counter, 1);
-}
\ No newline at end of file
+}
+TEST_F(io_ctx_pool_tests, indexed_access) {
+    const int num_threads = 3;
+
+    pool.start(num_threads);
+
+    ASSERT_EQ(pool.size(), static_cast<std::size_t>(num_threads));
+
+    EXPECT_EQ(pool.io_ctx(num_threads), nullptr);
+
+    std::vector<std::promise<std::thread::id>> promises(num_threads);
+
+    std::vector<std::thread::id> thread_ids;
+
+    for (int i = 0; i < num_threads; ++i) {
+        auto io_ctx = pool.io_ctx(i);
+
+        ASSERT_NE(io_ctx, nullptr);
+
+        EXPECT_EQ(io_ctx, pool.io_ctx(i));
+
+        boost::asio::post(io_ctx->get_executor(), [&, i] { promises[i].set_value(std::this_thread::get_id()); });
+    }
+
+    for (auto& p : promises)
+        thread_ids.push_back(p.get_future().get());
+
+    pool.stop();
+
+    EXPECT_EQ(pool.size(), 0u);
+
+    std::sort(thread_ids.begin(), thread_ids.end());
+
+    EXPECT_EQ(std::distance(thread_ids.begin(), std::unique(thread_ids.begin(), thread_ids.end())), num_threads);
+}
+
+TEST_F(io_ctx_pool_tests, least_connections_policy) {
+    pool.start(3, {.m_select_policy = clueapi::shared::io_ctx_pool_t::e_select_policy::least_connections});
+
+    pool.add_connection(0);
+    pool.add_connection(0);
+    pool.add_connection(2);
+
+    for (int i = 0; i < 8; ++i)
+        EXPECT_EQ(pool.next_idx(), 1u);
+
+    pool.remove_connection(0);
+    pool.remove_connection(0);
+
+    EXPECT_NE(pool.next_idx(), 2u);
+
+    auto stats = pool.stats();
+
+    ASSERT_EQ(stats.size(), 3u);
+
+    EXPECT_EQ(stats[0].m_active_connections, 0u);
+    EXPECT_EQ(stats[2].m_active_connections, 1u);
+
+    pool.remove_connection(2);
+}
+
+TEST_F(io_ctx_pool_tests, power_of_two_policy) {
+    pool.start(4, {.m_select_policy = clueapi::shared::io_ctx_pool_t::e_select_policy::power_of_two});
+
+    for (std::size_t i = 0; i < 3; ++i) {
+        for (int j = 0; j < 100; ++j)
+            pool.add_connection(i);
+    }
+
+    std::size_t hits{};
+
+    // The idle context wins every pair it is sampled into
+    for (int i = 0; i < 256; ++i) {
+        auto idx = pool.next_idx();
+
+        ASSERT_LT(idx, pool.size());
+
+        hits += idx == 3u;
+    }
+
+    EXPECT_GT(hits, 64u);
+}
+
+TEST_F(io_ctx_pool_tests, queued_handlers_accounting) {
+    pool.start(1);
+
+    std::promise<void> release;
+
+    auto released = release.get_future().share();
+
+    std::promise<void> started;
+
+    pool.post(0, [&] {
+        started.set_value();
+
+        released.wait();
+    });
+
+    started.get_future().wait();
+
+    std::atomic<bool> done{false};
+
+    pool.post(0, [&] { done = true; });
+
+    EXPECT_EQ(pool.stats(0).m_queued_handlers, 1u);
+
+    release.set_value();
+
+    for (int i = 0; i < 100 && !done; ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    EXPECT_TRUE(done);
+
+    EXPECT_EQ(pool.stats(0).m_queued_handlers, 0u);
+}
+
+TEST_F(io_ctx_pool_tests, loop_lag_probe) {
+    pool.start(1, {.m_lag_probe_interval = std::chrono::milliseconds(1)});
+
+    std::promise<void> blocked;
+
+    pool.post(0, [&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+        blocked.set_value();
+    });
+
+    blocked.get_future().wait();
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+    EXPECT_GT(pool.stats(0).m_loop_lag.count(), 0);
+}
+
+TEST(io_ctx_pool_topology_tests, parse_cpu_list) {
+    using clueapi::shared::detail::parse_cpu_list;
+
+    EXPECT_EQ(parse_cpu_list("0-3,8, 10-11\n"), (std::vector<std::int32_t>{0, 1, 2, 3, 8, 10, 11}));
+
+    EXPECT_TRUE(parse_cpu_list("").empty());
+    EXPECT_TRUE(parse_cpu_list("3-1").empty());
+    EXPECT_TRUE(parse_cpu_list("a,2").empty());
+}
+
+TEST(io_ctx_pool_topology_tests, place_threads) {
+    using namespace clueapi::shared::detail;
+
+    // Two nodes with two cores each, every core with two SMT siblings
+    const std::vector<cpu_t> cpus{
+        {0, 0, 0}, {1, 1, 0}, {2, 2, 1}, {3, 3, 1}, {4, 0, 0}, {5, 1, 0}, {6, 2, 1}, {7, 3, 1}};
+
+    io_ctx_pool_cfg_t cfg{};
+
+    EXPECT_EQ(place_threads(cpus, cfg, 3), (std::vector<std::int32_t>{0, 1, 2}));
+
+    cfg.m_placement = e_placement_policy::physical_cores;
+
+    EXPECT_EQ(place_threads(cpus, cfg, 5), (std::vector<std::int32_t>{0, 1, 2, 3, 4}));
+
+    cfg.m_placement = e_placement_policy::numa_nodes;
+
+    EXPECT_EQ(place_threads(cpus, cfg, 4), (std::vector<std::int32_t>{0, 2, 1, 3}));
+
+    cfg.m_placement = e_placement_policy::none;
+
+    EXPECT_EQ(place_threads(cpus, cfg, 2), (std::vector<std::int32_t>{-1, -1}));
+
+    // CPUs outside the allowed set are skipped
+    cfg.m_cpu_list = "6-7,42";
+
+    EXPECT_EQ(place_threads(cpus, cfg, 3), (std::vector<std::int32_t>{6, 7, 6}));
+}
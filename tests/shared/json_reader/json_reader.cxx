@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "clueapi/shared/json_reader/json_reader.hxx"
+#include "clueapi/shared/json_writer/json_writer.hxx"
+
+using clueapi::shared::json_field;
+using clueapi::shared::json_fields;
+using clueapi::shared::json_reader_t;
+using clueapi::shared::json_writer_t;
+
+namespace {
+    struct order_t {
+        std::uint32_t m_id{};
+
+        std::string m_customer;
+
+        std::optional<std::string> m_note{"none"};
+
+        std::vector<double> m_amounts;
+
+        std::map<std::string, int> m_flags;
+
+        static constexpr auto k_json_fields = json_fields(
+            json_field("id", &order_t::m_id),
+            json_field("customer", &order_t::m_customer),
+            json_field("note", &order_t::m_note),
+            json_field("amounts", &order_t::m_amounts),
+            json_field("flags", &order_t::m_flags));
+    };
+} // namespace
+
+TEST(json_reader_tests, reads_structures) {
+    const auto order = json_reader_t::read<order_t>(
+        R"({"id":7,"customer":"Jérôme","unknown":{"a":[1,2]},"note":null,)"
+        R"("amounts":[1.5,2],"flags":{"gift":1}})");
+
+    ASSERT_TRUE(order.has_value()) << order.error();
+
+    EXPECT_EQ(order->m_id, 7);
+    EXPECT_EQ(order->m_customer, "J\xc3\xa9r\xc3\xb4me");
+    EXPECT_FALSE(order->m_note.has_value());
+    EXPECT_EQ(order->m_amounts, (std::vector<double>{1.5, 2}));
+    EXPECT_EQ(order->m_flags.at("gift"), 1);
+}
+
+TEST(json_reader_tests, round_trips_with_the_writer) {
+    order_t order{42, "ann", "leave at door", {9.75}, {{"rush", 1}}};
+
+    const auto read = json_reader_t::read<order_t>(json_writer_t::to_string(order));
+
+    ASSERT_TRUE(read.has_value()) << read.error();
+
+    EXPECT_EQ(json_writer_t::to_string(*read), json_writer_t::to_string(order));
+}
+
+TEST(json_reader_tests, reports_malformed_documents) {
+    EXPECT_FALSE(json_reader_t::read<order_t>(R"({"id":"seven"})").has_value());
+    EXPECT_FALSE(json_reader_t::read<order_t>(R"({"id":4294967296})").has_value());
+    EXPECT_FALSE(json_reader_t::read<order_t>(R"({"id":1)").has_value());
+    EXPECT_FALSE(json_reader_t::read<std::vector<int>>("[1,2] [3]").has_value());
+
+    const auto numbers = json_reader_t::read<std::vector<int>>("[1,-2,3]");
+
+    ASSERT_TRUE(numbers.has_value());
+    EXPECT_EQ(*numbers, (std::vector<int>{1, -2, 3}));
+}
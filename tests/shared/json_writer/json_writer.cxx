@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "clueapi/http/types/response/response.hxx"
+#include "clueapi/shared/json_writer/json_writer.hxx"
+
+using clueapi::shared::json_field;
+using clueapi::shared::json_fields;
+using clueapi::shared::json_writer_t;
+
+namespace {
+    struct tag_t {
+        std::string m_name;
+
+        static constexpr auto k_json_fields = json_fields(json_field("name", &tag_t::m_name));
+    };
+
+    struct item_t {
+        std::uint64_t m_id{};
+
+        std::string m_title;
+
+        double m_price{};
+
+        bool m_active{};
+
+        std::optional<std::int32_t> m_stock;
+
+        std::vector<tag_t> m_tags;
+
+        static constexpr auto k_json_fields = json_fields(
+            json_field("id", &item_t::m_id),
+            json_field("title", &item_t::m_title),
+            json_field("price", &item_t::m_price),
+            json_field("active", &item_t::m_active),
+            json_field("stock", &item_t::m_stock),
+            json_field("tags", &item_t::m_tags));
+    };
+
+    struct point_t {
+        int m_x{};
+
+        int m_y{};
+    };
+} // namespace
+
+template <>
+struct clueapi::shared::json_meta_t<point_t> {
+    static constexpr auto k_fields =
+        json_fields(json_field("x", &point_t::m_x), json_field("y", &point_t::m_y));
+};
+
+TEST(json_writer_tests, writes_scalars) {
+    EXPECT_EQ(json_writer_t::to_string(true), "true");
+    EXPECT_EQ(json_writer_t::to_string(-42), "-42");
+    EXPECT_EQ(json_writer_t::to_string(std::numeric_limits<std::uint64_t>::max()), "18446744073709551615");
+    EXPECT_EQ(json_writer_t::to_string(0.5), "0.5");
+    EXPECT_EQ(json_writer_t::to_string(std::numeric_limits<double>::infinity()), "null");
+    EXPECT_EQ(json_writer_t::to_string(nullptr), "null");
+    EXPECT_EQ(json_writer_t::to_string(std::optional<int>{}), "null");
+}
+
+TEST(json_writer_tests, escapes_strings) {
+    EXPECT_EQ(json_writer_t::to_string("plain"), R"("plain")");
+    EXPECT_EQ(json_writer_t::to_string(std::string{"a\"b\\c\n\x01"}), R"("a\"b\\c\n\u0001")");
+    EXPECT_EQ(json_writer_t::to_string(std::string_view{"h\xc3\xa9llo"}), "\"h\xc3\xa9llo\"");
+}
+
+TEST(json_writer_tests, writes_structures_ranges_and_maps) {
+    const std::vector<item_t> items{
+        {1, "pen", 1.25, true, 3, {{"office"}, {"blue"}}}, {2, "ink", 4, false, std::nullopt, {}}};
+
+    EXPECT_EQ(
+        json_writer_t::to_string(items),
+        R"([{"id":1,"title":"pen","price":1.25,"active":true,"stock":3,"tags":[{"name":"office"},{"name":"blue"}]},)"
+        R"({"id":2,"title":"ink","price":4,"active":false,"stock":null,"tags":[]}])");
+
+    EXPECT_EQ(json_writer_t::to_string(point_t{1, -2}), R"({"x":1,"y":-2})");
+
+    const std::map<std::string, std::vector<int>> map{{"a", {1, 2}}, {"b", {}}};
+
+    EXPECT_EQ(json_writer_t::to_string(map), R"({"a":[1,2],"b":[]})");
+}
+
+TEST(json_writer_tests, json_response_serializes_without_dom) {
+    clueapi::http::types::json_response_t response{point_t{3, 4}};
+
+    EXPECT_EQ(response.body(), R"({"x":3,"y":4})");
+    EXPECT_EQ(response.headers().at("Content-Type"), "application/json");
+
+    clueapi::http::types::json_response_t dom{clueapi::http::types::json_t::json_obj_t{{"k", 1}}};
+
+    EXPECT_EQ(dom.body(), R"({"k":1})");
+}
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "clueapi/shared/metrics/metrics.hxx"
+
+using clueapi::shared::histogram_t;
+using clueapi::shared::metrics_t;
+
+TEST(metrics_tests, histogram_buckets) {
+    for (std::uint64_t value{}; value < 16u; value++)
+        EXPECT_EQ(histogram_t::bucket_of(value), value);
+
+    EXPECT_EQ(histogram_t::bucket_of(16u), 16u);
+    EXPECT_EQ(histogram_t::bucket_of(17u), 16u);
+    EXPECT_EQ(histogram_t::bucket_of(18u), 17u);
+    EXPECT_EQ(histogram_t::bucket_of(0xffffffffu), histogram_t::k_buckets - 1u);
+    EXPECT_EQ(histogram_t::bucket_of(~std::uint64_t{}), histogram_t::k_buckets - 1u);
+
+    // Every value lies below the end of its bucket and at or past the end of the previous one
+    for (std::uint64_t value : {1u, 15u, 16u, 100u, 1000u, 65535u, 65536u, 1000000u, 123456789u}) {
+        const auto bucket = histogram_t::bucket_of(value);
+
+        EXPECT_LT(value, histogram_t::upper_bound(bucket));
+
+        if (bucket > 0u)
+            EXPECT_GE(value, histogram_t::upper_bound(bucket - 1u));
+
+        // At most 12.5% wide
+        EXPECT_LE(histogram_t::upper_bound(bucket) - value, value / 8u + 1u);
+    }
+}
+
+TEST(metrics_tests, histogram_quantiles) {
+    histogram_t::counts_t counts{};
+
+    EXPECT_EQ(histogram_t::value_at(counts, 0.5), 0u);
+
+    for (std::uint64_t value{1}; value <= 1000u; value++)
+        counts[histogram_t::bucket_of(value)]++;
+
+    const auto median = histogram_t::value_at(counts, 0.5);
+
+    EXPECT_GE(median, 500u);
+    EXPECT_LE(median, 500u + 500u / 8u);
+
+    const auto p99 = histogram_t::value_at(counts, 0.99);
+
+    EXPECT_GE(p99, 990u);
+    EXPECT_LE(p99, 990u + 990u / 8u);
+}
+
+TEST(metrics_tests, aggregates_threads) {
+    const auto route = metrics_t::add_route("GET", "/metrics/\"test\"");
+
+    ASSERT_NE(route, metrics_t::k_untracked);
+
+    const auto before = metrics_t::snapshot();
+
+    auto total = [](const metrics_t::snapshot_t& snapshot) {
+        metrics_t::worker_t ret{};
+
+        for (const auto& worker : snapshot.m_workers) {
+            for (std::size_t i{}; i < ret.m_responses.size(); i++)
+                ret.m_responses[i] += worker.m_responses[i];
+
+            ret.m_request_bytes += worker.m_request_bytes;
+            ret.m_response_bytes += worker.m_response_bytes;
+            ret.m_timeouts += worker.m_timeouts;
+        }
+
+        return ret;
+    };
+
+    constexpr int k_threads{4};
+    constexpr int k_requests{1000};
+
+    std::vector<std::thread> threads{};
+
+    for (int i = 0; i < k_threads; i++) {
+        threads.emplace_back([route] {
+            for (int j = 0; j < k_requests; j++) {
+                metrics_t::record_latency(route, std::chrono::microseconds{100});
+
+                metrics_t::record_response(j % 2 ? 200u : 503u, 10u, 20u);
+            }
+
+            metrics_t::record_timeout();
+        });
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    const auto after = metrics_t::snapshot();
+
+    const auto was = total(before);
+    const auto now = total(after);
+
+    EXPECT_EQ(now.m_responses[1] - was.m_responses[1], k_threads * k_requests / 2u);
+    EXPECT_EQ(now.m_responses[4] - was.m_responses[4], k_threads * k_requests / 2u);
+    EXPECT_EQ(now.m_request_bytes - was.m_request_bytes, k_threads * k_requests * 10u);
+    EXPECT_EQ(now.m_response_bytes - was.m_response_bytes, k_threads * k_requests * 20u);
+    EXPECT_EQ(now.m_timeouts - was.m_timeouts, static_cast<std::uint64_t>(k_threads));
+
+    // The shards of the exited threads are taken over, not added
+    std::thread{[] { metrics_t::record_timeout(); }}.join();
+
+    EXPECT_EQ(metrics_t::snapshot().m_workers.size(), after.m_workers.size());
+
+    ASSERT_GT(after.m_routes.size(), route);
+
+    const auto& histogram = after.m_routes[route];
+
+    EXPECT_EQ(histogram.m_method, "GET");
+    EXPECT_EQ(histogram.m_count, k_threads * k_requests);
+    EXPECT_EQ(histogram.m_sum, k_threads * k_requests * 100u);
+    EXPECT_EQ(histogram.m_counts[histogram_t::bucket_of(100u)], k_threads * k_requests);
+
+    std::string out{};
+
+    metrics_t::write_prometheus(out, after);
+
+    EXPECT_NE(out.find("# TYPE clueapi_responses_total counter\n"), std::string::npos);
+    EXPECT_NE(out.find("# TYPE clueapi_route_latency_seconds histogram\n"), std::string::npos);
+
+    const std::string labels{R"(method="GET",route="/metrics/\"test\"")"};
+
+    EXPECT_NE(out.find("clueapi_route_latency_seconds_bucket{" + labels + ",le=\"6.4e-05\"} 0\n"), std::string::npos);
+    EXPECT_NE(out.find("clueapi_route_latency_seconds_bucket{" + labels + ",le=\"0.000128\"} 4000\n"), std::string::npos);
+    EXPECT_NE(out.find("clueapi_route_latency_seconds_bucket{" + labels + ",le=\"+Inf\"} 4000\n"), std::string::npos);
+    EXPECT_NE(out.find("clueapi_route_latency_seconds_count{" + labels + "} 4000\n"), std::string::npos);
+    EXPECT_NE(out.find("clueapi_route_latency_seconds_sum{" + labels + "} 0.4\n"), std::string::npos);
+}
@@ -0,0 +1,203 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/use_future.hpp>
+
+#include "clueapi/shared/thread_pool/thread_pool.hxx"
+
+class thread_pool_tests : public ::testing::Test {
+  protected:
+    void TearDown() override { pool.stop(); }
+
+    clueapi::shared::thread_pool_t pool;
+};
+
+TEST_F(thread_pool_tests, resumes_on_caller_context) {
+    pool.start("test", {.m_threads = 2u});
+
+    ASSERT_TRUE(pool.is_running());
+
+    boost::asio::io_context io_ctx{};
+
+    std::thread::id ran_on{};
+
+    std::thread::id resumed_on{};
+
+    std::optional<int> result{};
+
+    boost::asio::co_spawn(
+        io_ctx,
+
+        [&]() -> clueapi::shared::awaitable_t<void> {
+            result = co_await pool.run([&]() {
+                ran_on = std::this_thread::get_id();
+
+                return 42;
+            });
+
+            resumed_on = std::this_thread::get_id();
+        },
+
+        boost::asio::detached);
+
+    io_ctx.run();
+
+    ASSERT_TRUE(result.has_value());
+
+    EXPECT_EQ(*result, 42);
+    EXPECT_NE(ran_on, std::this_thread::get_id());
+    EXPECT_EQ(resumed_on, std::this_thread::get_id());
+
+    const auto stats = pool.stats();
+
+    EXPECT_EQ(stats.m_threads, 2u);
+    EXPECT_EQ(stats.m_completed, 1u);
+    EXPECT_EQ(stats.m_queued, 0u);
+    EXPECT_EQ(stats.m_active, 0u);
+}
+
+TEST_F(thread_pool_tests, rethrows_exceptions) {
+    pool.start("test", {.m_threads = 1u});
+
+    boost::asio::io_context io_ctx{};
+
+    auto future = boost::asio::co_spawn(
+        io_ctx,
+
+        [&]() -> clueapi::shared::awaitable_t<std::optional<int>> {
+            co_return co_await pool.run([]() -> int { throw std::runtime_error{"failed"}; });
+        },
+
+        boost::asio::use_future);
+
+    io_ctx.run();
+
+    EXPECT_THROW(future.get(), std::runtime_error);
+
+    EXPECT_EQ(pool.stats().m_completed, 1u);
+}
+
+TEST_F(thread_pool_tests, rejects_when_full) {
+    pool.start("test", {.m_threads = 1u, .m_max_queued = 2u});
+
+    std::promise<void> release{};
+
+    auto released = release.get_future().share();
+
+    boost::asio::io_context io_ctx{};
+
+    std::vector<std::optional<int>> results(5u);
+
+    std::atomic<bool> is_blocked{false};
+
+    // The first function holds the only thread, two wait behind it and the others are rejected
+    for (std::size_t i{}; i < results.size(); i++) {
+        boost::asio::co_spawn(
+            io_ctx,
+
+            [&, i]() -> clueapi::shared::awaitable_t<void> {
+                results[i] = co_await pool.run([&, i]() {
+                    if (i == 0u) {
+                        is_blocked = true;
+
+                        released.wait();
+                    }
+
+                    return static_cast<int>(i);
+                });
+            },
+
+            boost::asio::detached);
+
+        if (i == 0u) {
+            io_ctx.poll();
+
+            while (!is_blocked)
+                std::this_thread::yield();
+        }
+    }
+
+    io_ctx.poll();
+
+    EXPECT_EQ(pool.stats().m_queued, 2u);
+    EXPECT_EQ(pool.stats().m_active, 1u);
+    EXPECT_EQ(pool.stats().m_rejected, 2u);
+
+    release.set_value();
+
+    io_ctx.run();
+
+    for (std::size_t i{}; i < 3u; i++) {
+        ASSERT_TRUE(results[i].has_value()) << i;
+
+        EXPECT_EQ(*results[i], static_cast<int>(i));
+    }
+
+    EXPECT_FALSE(results[3].has_value());
+    EXPECT_FALSE(results[4].has_value());
+}
+
+TEST_F(thread_pool_tests, rejects_when_stopped) {
+    boost::asio::io_context io_ctx{};
+
+    std::optional<int> result{1};
+
+    boost::asio::co_spawn(
+        io_ctx,
+
+        [&]() -> clueapi::shared::awaitable_t<void> {
+            result = co_await pool.run([]() { return 2; });
+        },
+
+        boost::asio::detached);
+
+    io_ctx.run();
+
+    EXPECT_FALSE(result.has_value());
+    EXPECT_EQ(pool.stats().m_rejected, 1u);
+    EXPECT_EQ(pool.stats().m_threads, 0u);
+}
+
+TEST_F(thread_pool_tests, stop_runs_queued) {
+    pool.start("test", {.m_threads = 1u});
+
+    std::atomic<int> counter{0};
+
+    boost::asio::io_context io_ctx{};
+
+    for (int i{}; i < 8; i++)
+        boost::asio::co_spawn(
+            io_ctx,
+
+            [&]() -> clueapi::shared::awaitable_t<void> {
+                co_await pool.run([&]() {
+                    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+
+                    return ++counter;
+                });
+            },
+
+            boost::asio::detached);
+
+    io_ctx.poll();
+
+    pool.stop();
+
+    EXPECT_EQ(counter, 8);
+
+    EXPECT_FALSE(pool.is_running());
+
+    io_ctx.run();
+
+    EXPECT_EQ(pool.stats().m_completed, 8u);
+}
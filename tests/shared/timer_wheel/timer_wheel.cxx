@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+
+#include <boost/asio/io_context.hpp>
+#include <chrono>
+#include <memory>
+
+#include "clueapi/shared/timer_wheel/timer_wheel.hxx"
+
+class timer_wheel_tests : public ::testing::Test {
+  protected:
+    using timer_wheel_t = clueapi::shared::timer_wheel_t;
+
+    void SetUp() override {
+        wheel = std::make_shared<timer_wheel_t>(io_ctx, std::chrono::milliseconds{10});
+
+        wheel->start();
+    }
+
+    void TearDown() override { wheel->stop(); }
+
+    boost::asio::io_context io_ctx;
+
+    std::shared_ptr<timer_wheel_t> wheel;
+};
+
+TEST_F(timer_wheel_tests, expires_entries_in_batches) {
+    timer_wheel_t::entry_t first, second, late;
+
+    int fired{};
+
+    first.m_on_expire = [&fired] { fired++; };
+    second.m_on_expire = [&fired] { fired++; };
+    late.m_on_expire = [&fired] { fired++; };
+
+    const auto now = timer_wheel_t::clock_t::now();
+
+    wheel->arm(first, now + std::chrono::milliseconds{25});
+    wheel->arm(second, now + std::chrono::milliseconds{25});
+    wheel->arm(late, now + std::chrono::milliseconds{200});
+
+    EXPECT_EQ(wheel->size(), 3u);
+
+    EXPECT_EQ(wheel->advance(now + std::chrono::milliseconds{20}), 0u);
+
+    EXPECT_EQ(wheel->advance(now + std::chrono::milliseconds{50}), 2u);
+
+    EXPECT_EQ(fired, 2);
+
+    EXPECT_TRUE(first.is_expired());
+    EXPECT_FALSE(first.is_armed());
+    EXPECT_FALSE(late.is_expired());
+    EXPECT_TRUE(late.is_armed());
+
+    EXPECT_EQ(wheel->size(), 1u);
+}
+
+TEST_F(timer_wheel_tests, cancel_and_rearm) {
+    timer_wheel_t::entry_t entry;
+
+    int fired{};
+
+    entry.m_on_expire = [&fired] { fired++; };
+
+    const auto now = timer_wheel_t::clock_t::now();
+
+    wheel->arm(entry, now + std::chrono::milliseconds{30});
+
+    wheel->cancel(entry);
+
+    EXPECT_FALSE(entry.is_armed());
+    EXPECT_EQ(wheel->size(), 0u);
+
+    wheel->advance(now + std::chrono::milliseconds{100});
+
+    EXPECT_EQ(fired, 0);
+
+    wheel->arm(entry, now + std::chrono::milliseconds{150});
+
+    wheel->arm(entry, now + std::chrono::milliseconds{300});
+
+    EXPECT_EQ(wheel->size(), 1u);
+
+    EXPECT_EQ(wheel->advance(now + std::chrono::milliseconds{200}), 0u);
+
+    EXPECT_EQ(wheel->advance(now + std::chrono::milliseconds{320}), 1u);
+
+    EXPECT_EQ(fired, 1);
+}
+
+TEST_F(timer_wheel_tests, cascades_long_deadlines) {
+    timer_wheel_t::entry_t entry;
+
+    const auto now = timer_wheel_t::clock_t::now();
+
+    // Beyond the first level (256 ticks) and beyond the range of the wheel (65536 ticks)
+    wheel->arm(entry, now + std::chrono::seconds{5});
+
+    EXPECT_EQ(wheel->advance(now + std::chrono::milliseconds{4980}), 0u);
+    EXPECT_EQ(wheel->advance(now + std::chrono::milliseconds{5020}), 1u);
+
+    wheel->arm(entry, now + std::chrono::seconds{1000});
+
+    EXPECT_EQ(wheel->advance(now + std::chrono::seconds{999}), 0u);
+    EXPECT_EQ(wheel->advance(now + std::chrono::seconds{1001}), 1u);
+}
+
+TEST_F(timer_wheel_tests, ticks_on_io_context) {
+    timer_wheel_t::entry_t entry;
+
+    bool fired{};
+
+    entry.m_on_expire = [&fired] { fired = true; };
+
+    wheel->arm_after(entry, std::chrono::milliseconds{30});
+
+    io_ctx.run_for(std::chrono::milliseconds{200});
+
+    EXPECT_TRUE(fired);
+    EXPECT_TRUE(entry.is_expired());
+
+    // The tick timer is released once the wheel is empty
+    EXPECT_TRUE(io_ctx.stopped());
+}
+
+TEST_F(timer_wheel_tests, stop_disarms_entries) {
+    timer_wheel_t::entry_t entry;
+
+    wheel->arm_after(entry, std::chrono::milliseconds{30});
+
+    wheel->stop();
+
+    EXPECT_FALSE(entry.is_armed());
+    EXPECT_FALSE(entry.is_expired());
+
+    wheel->arm_after(entry, std::chrono::milliseconds{30});
+
+    EXPECT_FALSE(entry.is_armed());
+}
@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "clueapi/shared/tracing/tracing.hxx"
+
+using clueapi::shared::trace_clock_t;
+using clueapi::shared::trace_context_t;
+using clueapi::shared::trace_phase_t;
+using clueapi::shared::trace_t;
+
+TEST(tracing_tests, parse_traceparent) {
+    const auto context =
+        trace_context_t::parse("00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01");
+
+    ASSERT_TRUE(context.has_value());
+
+    EXPECT_EQ(context->m_trace_id[0], 0x4bu);
+    EXPECT_EQ(context->m_trace_id[15], 0x36u);
+    EXPECT_EQ(context->m_span_id[0], 0x00u);
+    EXPECT_EQ(context->m_span_id[7], 0xb7u);
+    EXPECT_TRUE(context->is_sampled());
+
+    EXPECT_EQ(
+        context->traceparent(), "00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01");
+
+    const auto unsampled =
+        trace_context_t::parse(" 00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-00\t");
+
+    ASSERT_TRUE(unsampled.has_value());
+
+    EXPECT_FALSE(unsampled->is_sampled());
+
+    // A later version may append fields
+    EXPECT_TRUE(
+        trace_context_t::parse("01-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01-extra")
+            .has_value());
+}
+
+TEST(tracing_tests, parse_invalid_traceparent) {
+    for (const auto* value : {
+             "",
+             "00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7",
+             "00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01-extra",
+             "ff-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01",
+             "00-4BF92F3577B34DA6A3CE929D0E0E4736-00f067aa0ba902b7-01",
+             "00-00000000000000000000000000000000-00f067aa0ba902b7-01",
+             "00-4bf92f3577b34da6a3ce929d0e0e4736-0000000000000000-01",
+             "00_4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01",
+             "00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-0g",
+             "01-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01x",
+         })
+        EXPECT_FALSE(trace_context_t::parse(value).has_value()) << value;
+}
+
+TEST(tracing_tests, make_ids) {
+    trace_context_t context{};
+
+    context.m_trace_id = trace_context_t::make_trace_id();
+    context.m_span_id  = trace_context_t::make_span_id();
+
+    EXPECT_NE(context.m_trace_id, trace_context_t::make_trace_id());
+    EXPECT_NE(context.m_span_id, trace_context_t::make_span_id());
+
+    // A generated context survives a round trip
+    const auto parsed = trace_context_t::parse(context.traceparent());
+
+    ASSERT_TRUE(parsed.has_value());
+
+    EXPECT_EQ(parsed->m_trace_id, context.m_trace_id);
+    EXPECT_EQ(parsed->m_span_id, context.m_span_id);
+}
+
+TEST(tracing_tests, scopes_record_spans) {
+    trace_t trace{};
+
+    trace.reset(trace_clock_t::now());
+
+    {
+        const trace_t::scope_t outer{&trace, trace_phase_t::middleware, 3u};
+
+        const trace_t::scope_t inner{&trace, trace_phase_t::handler};
+    }
+
+    const auto spans = trace.spans();
+
+    ASSERT_EQ(spans.size(), 2u);
+
+    EXPECT_EQ(spans[0].m_phase, trace_phase_t::middleware);
+    EXPECT_EQ(spans[0].m_index, 3u);
+    EXPECT_EQ(spans[1].m_phase, trace_phase_t::handler);
+
+    for (const auto& span : spans) {
+        EXPECT_GE(span.m_start, trace.m_start);
+        EXPECT_GE(span.m_end, span.m_start);
+    }
+
+    // The inner span ends first
+    EXPECT_LE(spans[1].m_end, spans[0].m_end);
+
+    EXPECT_EQ(trace_phase_t::to_str(trace_phase_t::read_header), "read_header");
+
+    // A request that isn't traced records nothing
+    const trace_t::scope_t untraced{nullptr, trace_phase_t::parse};
+}
+
+TEST(tracing_tests, spans_are_capped) {
+    trace_t trace{};
+
+    trace.reset(trace_clock_t::now());
+
+    for (std::size_t i{}; i < trace_t::k_max_spans + 4u; i++)
+        trace.close(trace.open(trace_phase_t::middleware, i));
+
+    EXPECT_EQ(trace.spans().size(), trace_t::k_max_spans);
+
+    EXPECT_EQ(trace.open(trace_phase_t::handler), trace_t::k_no_span);
+
+    // A span that didn't fit is ignored when it is closed
+    trace.close(trace_t::k_no_span);
+
+    trace.reset(trace_clock_t::now());
+
+    EXPECT_TRUE(trace.spans().empty());
+}
+
+TEST(tracing_tests, clock) {
+    trace_clock_t::calibrate();
+
+    const auto start = trace_clock_t::now();
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{2});
+
+    const auto end = trace_clock_t::now();
+
+    ASSERT_GT(end, start);
+
+    const auto elapsed = trace_clock_t::to_ns(end - start);
+
+    EXPECT_GE(elapsed, 1'000'000u);
+    EXPECT_LT(elapsed, 1'000'000'000u);
+
+    const auto unix_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             std::chrono::system_clock::now().time_since_epoch())
+                             .count();
+
+    EXPECT_NEAR(
+        static_cast<double>(trace_clock_t::to_unix_ns(trace_clock_t::now())),
+        static_cast<double>(unix_ns),
+        50'000'000.0);
+}
@@ -0,0 +1,37 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+
+#include "clueapi/sse/event/event.hxx"
+
+namespace sse = clueapi::sse;
+
+TEST(sse_event_tests, encodes_fields) {
+    EXPECT_EQ(sse::encode({.m_data = "hello"}), "data: hello\n\n");
+
+    EXPECT_EQ(
+        sse::encode({.m_data = "{}", .m_event = "update", .m_id = 42u, .m_retry = std::chrono::milliseconds{1500}}),
+        "id: 42\nevent: update\nretry: 1500\ndata: {}\n\n");
+}
+
+TEST(sse_event_tests, splits_data_lines) {
+    EXPECT_EQ(sse::encode({.m_data = "a\nb\r\nc\rd"}), "data: a\ndata: b\ndata: c\ndata: d\n\n");
+
+    EXPECT_EQ(sse::encode({.m_data = "a\n"}), "data: a\ndata: \n\n");
+
+    EXPECT_EQ(sse::encode({.m_data = ""}), "data: \n\n");
+
+    // A line break can't end the type early
+    EXPECT_EQ(sse::encode({.m_data = "x", .m_event = "a\nb"}), "event: ab\ndata: x\n\n");
+}
+
+TEST(sse_event_tests, parses_last_event_ids) {
+    EXPECT_EQ(sse::parse_last_event_id("17"), 17u);
+    EXPECT_EQ(sse::parse_last_event_id("0"), 0u);
+
+    EXPECT_FALSE(sse::parse_last_event_id("").has_value());
+    EXPECT_FALSE(sse::parse_last_event_id("abc").has_value());
+    EXPECT_FALSE(sse::parse_last_event_id("12x").has_value());
+    EXPECT_FALSE(sse::parse_last_event_id("-1").has_value());
+}
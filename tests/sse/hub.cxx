@@ -0,0 +1,198 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/redirect_error.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/use_awaitable.hpp>
+
+#include "clueapi/http/chunks/chunks.hxx"
+#include "clueapi/sse/sse.hxx"
+
+namespace sse = clueapi::sse;
+
+namespace chunks = clueapi::http::chunks;
+
+class sse_hub_tests : public ::testing::Test {
+  protected:
+    // Collects what a stream writes, optionally holding every write until released
+    struct sink_t final : chunks::sink_t {
+        explicit sink_t(boost::asio::io_context& io_ctx) : m_gate{io_ctx} {}
+
+        clueapi::exceptions::expected_awaitable_t<> write(std::string_view data) override {
+            if (m_is_held) {
+                boost::system::error_code ec{};
+
+                m_gate.expires_at(boost::asio::steady_timer::time_point::max());
+
+                co_await m_gate.async_wait(boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+            }
+
+            m_writes.emplace_back(data);
+
+            co_return clueapi::exceptions::expected_t<>{};
+        }
+
+        clueapi::exceptions::expected_awaitable_t<> finish() override {
+            co_return clueapi::exceptions::expected_t<>{};
+        }
+
+        bool is_closed() const noexcept override {
+            return m_is_closed;
+        }
+
+        std::vector<std::string> m_writes;
+
+        bool m_is_held{};
+
+        bool m_is_closed{};
+
+        boost::asio::steady_timer m_gate;
+    };
+
+    // A streaming response and the sink it writes to
+    struct stream_t {
+        clueapi::http::types::response_t m_response;
+
+        std::unique_ptr<sink_t> m_sink;
+
+        std::unique_ptr<chunks::chunk_writer_t> m_writer;
+
+        bool m_is_done{};
+    };
+
+    std::unique_ptr<stream_t> start(clueapi::http::types::response_t response) {
+        auto stream = std::make_unique<stream_t>();
+
+        stream->m_response = std::move(response);
+        stream->m_sink = std::make_unique<sink_t>(io_ctx);
+        stream->m_writer = std::make_unique<chunks::chunk_writer_t>(*stream->m_sink);
+
+        boost::asio::co_spawn(
+            io_ctx,
+            [stream = stream.get()]() -> boost::asio::awaitable<void> {
+                co_await stream->m_response.stream_fn()(*stream->m_writer);
+
+                stream->m_is_done = true;
+            },
+            boost::asio::detached);
+
+        return stream;
+    }
+
+    void run(std::chrono::milliseconds duration = std::chrono::milliseconds{50}) {
+        io_ctx.restart();
+        io_ctx.run_for(duration);
+    }
+
+    boost::asio::io_context io_ctx;
+};
+
+TEST_F(sse_hub_tests, fans_events_out_to_a_topic) {
+    sse::c_hub hub{};
+
+    auto response = hub.subscribe("news");
+
+    EXPECT_TRUE(response.is_stream());
+    EXPECT_EQ(response.headers().at("Content-Type"), "text/event-stream");
+
+    auto first = start(std::move(response));
+    auto second = start(hub.subscribe("news"));
+    auto other = start(hub.subscribe("sports"));
+
+    run();
+
+    EXPECT_EQ(hub.subscriptions(), 3u);
+
+    const auto id = hub.publish("news", "hello", "greeting");
+
+    run();
+
+    const auto expected = sse::encode({.m_data = "hello", .m_event = "greeting", .m_id = id});
+
+    EXPECT_EQ(first->m_sink->m_writes, std::vector<std::string>{expected});
+    EXPECT_EQ(second->m_sink->m_writes, std::vector<std::string>{expected});
+    EXPECT_TRUE(other->m_sink->m_writes.empty());
+}
+
+TEST_F(sse_hub_tests, replays_missed_events_once) {
+    sse::c_hub hub{{.m_replay_size = 2u}};
+
+    const auto first = hub.publish("news", "1");
+
+    hub.publish("news", "2");
+    hub.publish("news", "3");
+    hub.publish("sports", "other");
+
+    auto stream = start(hub.subscribe("news", first));
+
+    run();
+
+    const auto live = hub.publish("news", "4");
+
+    run();
+
+    auto& writes = stream->m_sink->m_writes;
+
+    // The first event left the replay buffer
+    ASSERT_EQ(writes.size(), 3u);
+    EXPECT_NE(writes[0].find("data: 2\n"), std::string::npos);
+    EXPECT_NE(writes[1].find("data: 3\n"), std::string::npos);
+    EXPECT_EQ(writes[2], sse::encode({.m_data = "4", .m_id = live}));
+}
+
+TEST_F(sse_hub_tests, drops_slow_streams) {
+    sse::c_hub hub{{.m_max_queued_events = 2u}};
+
+    auto stream = start(hub.subscribe("news"));
+
+    stream->m_sink->m_is_held = true;
+
+    run();
+
+    // The stream is stuck writing the first event while the others pile up
+    hub.publish("news", "first");
+
+    run();
+
+    for (int i{}; i < 5; i++)
+        hub.publish("news", "event");
+
+    run();
+
+    EXPECT_FALSE(stream->m_is_done);
+
+    stream->m_sink->m_is_held = false;
+    stream->m_sink->m_gate.cancel();
+
+    run();
+
+    EXPECT_TRUE(stream->m_is_done);
+    EXPECT_EQ(stream->m_sink->m_writes.size(), 1u);
+    EXPECT_EQ(hub.subscriptions(), 0u);
+}
+
+TEST_F(sse_hub_tests, sends_heartbeats_to_idle_streams) {
+    sse::c_hub hub{{.m_heartbeat_interval = std::chrono::milliseconds{20}}};
+
+    auto stream = start(hub.subscribe("news"));
+
+    run(std::chrono::milliseconds{70});
+
+    ASSERT_FALSE(stream->m_sink->m_writes.empty());
+    EXPECT_EQ(stream->m_sink->m_writes.front(), sse::k_heartbeat);
+
+    // A closed stream leaves on its next write
+    stream->m_sink->m_is_closed = true;
+
+    run(std::chrono::milliseconds{50});
+
+    EXPECT_TRUE(stream->m_is_done);
+    EXPECT_EQ(hub.subscriptions(), 0u);
+}
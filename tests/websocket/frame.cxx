@@ -0,0 +1,231 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+
+#include "clueapi/websocket/deflate/deflate.hxx"
+#include "clueapi/websocket/frame/frame.hxx"
+
+namespace websocket = clueapi::websocket;
+
+namespace {
+    // A frame as sent by a client, masked
+    std::string client_frame(
+        websocket::e_opcode opcode, std::string payload, bool fin = true, std::uint32_t mask = 0x37fa213du) {
+        std::string out{};
+
+        out.push_back(static_cast<char>((fin ? 0x80u : 0x00u) | static_cast<std::uint8_t>(opcode)));
+
+        if (payload.size() < 126u)
+            out.push_back(static_cast<char>(0x80u | payload.size()));
+        else {
+            out.push_back(static_cast<char>(0x80u | 126u));
+            out.push_back(static_cast<char>(payload.size() >> 8u));
+            out.push_back(static_cast<char>(payload.size() & 0xffu));
+        }
+
+        out.append(reinterpret_cast<const char*>(&mask), 4u);
+
+        websocket::apply_mask(payload.data(), payload.size(), mask);
+
+        return out + payload;
+    }
+} // namespace
+
+TEST(websocket_frame_tests, parses_a_masked_client_frame) {
+    const auto frame = client_frame(websocket::e_opcode::text, "Hello");
+
+    websocket::frame_header_t header{};
+
+    ASSERT_EQ(websocket::parse_header(frame, header), 6u);
+
+    EXPECT_EQ(header.m_opcode, websocket::e_opcode::text);
+    EXPECT_TRUE(header.m_fin);
+    EXPECT_TRUE(header.m_masked);
+    EXPECT_EQ(header.m_length, 5u);
+    EXPECT_TRUE(header.is_valid(false));
+
+    std::string payload = frame.substr(6u);
+
+    websocket::apply_mask(payload.data(), payload.size(), header.m_mask);
+
+    EXPECT_EQ(payload, "Hello");
+}
+
+TEST(websocket_frame_tests, needs_the_whole_header) {
+    const auto frame = client_frame(websocket::e_opcode::binary, std::string(300u, 'x'));
+
+    websocket::frame_header_t header{};
+
+    for (std::size_t i{}; i < 8u; i++)
+        EXPECT_EQ(websocket::parse_header(std::string_view{frame}.substr(0u, i), header), 0u);
+
+    ASSERT_EQ(websocket::parse_header(frame, header), 8u);
+
+    EXPECT_EQ(header.m_length, 300u);
+}
+
+TEST(websocket_frame_tests, writes_server_frames) {
+    for (const std::size_t size : {0u, 5u, 125u, 126u, 65535u, 65536u}) {
+        const auto frame = websocket::make_frame(websocket::e_opcode::binary, std::string(size, 'a'));
+
+        websocket::frame_header_t header{};
+
+        const auto header_size = websocket::parse_header(*frame, header);
+
+        ASSERT_NE(header_size, 0u);
+
+        EXPECT_EQ(header.m_opcode, websocket::e_opcode::binary);
+        EXPECT_FALSE(header.m_masked);
+        EXPECT_EQ(header.m_rsv, 0u);
+        EXPECT_EQ(header.m_length, size);
+        EXPECT_EQ(frame->size(), header_size + size);
+    }
+
+    const auto compressed = websocket::make_frame(websocket::e_opcode::text, "abc", true);
+
+    websocket::frame_header_t header{};
+
+    ASSERT_EQ(websocket::parse_header(*compressed, header), 2u);
+
+    EXPECT_EQ(header.m_rsv, 0x40u);
+
+    // Unmasked, as only a client frame is valid input
+    EXPECT_FALSE(header.is_valid(true));
+}
+
+TEST(websocket_frame_tests, allows_rsv1_only_when_negotiated) {
+    auto frame = client_frame(websocket::e_opcode::text, "abc");
+
+    frame[0] = static_cast<char>(frame[0] | 0x40);
+
+    websocket::frame_header_t header{};
+
+    ASSERT_EQ(websocket::parse_header(frame, header), 6u);
+
+    EXPECT_TRUE(header.is_valid(true));
+    EXPECT_FALSE(header.is_valid(false));
+
+    frame = client_frame(websocket::e_opcode::continuation, "abc");
+
+    frame[0] = static_cast<char>(frame[0] | 0x40);
+
+    ASSERT_EQ(websocket::parse_header(frame, header), 6u);
+
+    EXPECT_FALSE(header.is_valid(true));
+}
+
+TEST(websocket_frame_tests, masks_parts_at_any_offset) {
+    const std::string payload{"The quick brown fox jumps over the lazy dog"};
+
+    std::string whole{payload};
+
+    websocket::apply_mask(whole.data(), whole.size(), 0x11223344u);
+
+    std::string parts{payload};
+
+    websocket::apply_mask(parts.data(), 3u, 0x11223344u);
+    websocket::apply_mask(parts.data() + 3u, 17u, 0x11223344u, 3u);
+    websocket::apply_mask(parts.data() + 20u, parts.size() - 20u, 0x11223344u, 20u);
+
+    EXPECT_EQ(parts, whole);
+
+    websocket::apply_mask(parts.data(), parts.size(), 0x11223344u);
+
+    EXPECT_EQ(parts, payload);
+}
+
+TEST(websocket_frame_tests, rejects_invalid_control_frames) {
+    websocket::frame_header_t header{};
+
+    ASSERT_NE(websocket::parse_header(client_frame(websocket::e_opcode::ping, "", false), header), 0u);
+
+    EXPECT_FALSE(header.is_valid(false));
+
+    ASSERT_NE(websocket::parse_header(client_frame(websocket::e_opcode::ping, std::string(126u, 'p')), header), 0u);
+
+    EXPECT_FALSE(header.is_valid(false));
+}
+
+TEST(websocket_frame_tests, validates_utf8) {
+    EXPECT_TRUE(websocket::is_valid_utf8(""));
+    EXPECT_TRUE(websocket::is_valid_utf8("plain ascii, longer than a word"));
+    EXPECT_TRUE(websocket::is_valid_utf8("caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80 \xf4\x8f\xbf\xbf"));
+
+    // Overlong forms
+    EXPECT_FALSE(websocket::is_valid_utf8("\xc0\xaf"));
+    EXPECT_FALSE(websocket::is_valid_utf8("\xe0\x80\xaf"));
+    EXPECT_FALSE(websocket::is_valid_utf8("\xf0\x80\x80\xaf"));
+
+    // A surrogate, and past U+10FFFF
+    EXPECT_FALSE(websocket::is_valid_utf8("\xed\xa0\x80"));
+    EXPECT_FALSE(websocket::is_valid_utf8("\xf4\x90\x80\x80"));
+
+    // Truncated after ASCII words, and a stray continuation byte
+    EXPECT_FALSE(websocket::is_valid_utf8("0123456789abcdef\xe2\x82"));
+    EXPECT_FALSE(websocket::is_valid_utf8("\x80"));
+    EXPECT_FALSE(websocket::is_valid_utf8("\xe2\x28\xa1"));
+}
+
+TEST(websocket_frame_tests, validates_close_codes) {
+    EXPECT_TRUE(websocket::is_valid_close_code(1000u));
+    EXPECT_TRUE(websocket::is_valid_close_code(1003u));
+    EXPECT_TRUE(websocket::is_valid_close_code(1007u));
+    EXPECT_TRUE(websocket::is_valid_close_code(1014u));
+    EXPECT_TRUE(websocket::is_valid_close_code(3000u));
+    EXPECT_TRUE(websocket::is_valid_close_code(4999u));
+
+    EXPECT_FALSE(websocket::is_valid_close_code(0u));
+    EXPECT_FALSE(websocket::is_valid_close_code(999u));
+    EXPECT_FALSE(websocket::is_valid_close_code(1004u));
+    EXPECT_FALSE(websocket::is_valid_close_code(1005u));
+    EXPECT_FALSE(websocket::is_valid_close_code(1006u));
+    EXPECT_FALSE(websocket::is_valid_close_code(1015u));
+    EXPECT_FALSE(websocket::is_valid_close_code(2999u));
+    EXPECT_FALSE(websocket::is_valid_close_code(5000u));
+}
+
+TEST(websocket_frame_tests, encodes_close_frames) {
+    const auto frame = websocket::make_close_frame(websocket::close_code::k_going_away, "bye");
+
+    websocket::frame_header_t header{};
+
+    ASSERT_EQ(websocket::parse_header(*frame, header), 2u);
+
+    EXPECT_EQ(header.m_opcode, websocket::e_opcode::close);
+    EXPECT_EQ(frame->substr(2u), std::string("\x03\xe9" "bye"));
+}
+
+TEST(websocket_deflate_tests, negotiates_offers) {
+    EXPECT_TRUE(websocket::deflate::accepts("permessage-deflate"));
+    EXPECT_TRUE(websocket::deflate::accepts("permessage-deflate; client_max_window_bits"));
+    EXPECT_TRUE(websocket::deflate::accepts("x-webkit-deflate-frame, permessage-deflate; server_no_context_takeover"));
+    EXPECT_TRUE(websocket::deflate::accepts("permessage-deflate; server_max_window_bits=15"));
+
+    EXPECT_FALSE(websocket::deflate::accepts(""));
+    EXPECT_FALSE(websocket::deflate::accepts("x-webkit-deflate-frame"));
+    EXPECT_FALSE(websocket::deflate::accepts("permessage-deflate; server_max_window_bits=10"));
+}
+
+TEST(websocket_deflate_tests, round_trips_messages) {
+    std::string message{};
+
+    for (int i{}; i < 200; i++)
+        message.append("{\"event\":\"tick\",\"seq\":").append(std::to_string(i)).append("}");
+
+    std::string compressed{};
+
+    ASSERT_TRUE(websocket::deflate::compress(message, compressed, 6));
+
+    EXPECT_LT(compressed.size(), message.size());
+
+    std::string inflated{};
+
+    ASSERT_TRUE(websocket::deflate::decompress(compressed, inflated, message.size()));
+
+    EXPECT_EQ(inflated, message);
+
+    EXPECT_FALSE(websocket::deflate::decompress(compressed, inflated, message.size() - 1u));
+
+    EXPECT_FALSE(websocket::deflate::decompress("not deflate data", inflated, 1024u));
+}
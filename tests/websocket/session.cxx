@@ -0,0 +1,407 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/connect.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/asio/write.hpp>
+
+#include "clueapi/shared/buffer_pool/buffer_pool.hxx"
+#include "clueapi/websocket/websocket.hxx"
+
+namespace websocket = clueapi::websocket;
+
+class websocket_session_tests : public ::testing::Test {
+  protected:
+    using tcp = boost::asio::ip::tcp;
+
+    // The two ends of a loopback connection
+    struct pair_t {
+        explicit pair_t(boost::asio::io_context& io_ctx) : m_server{io_ctx}, m_client{io_ctx} {}
+
+        tcp::socket m_server;
+
+        tcp::socket m_client;
+
+        clueapi::shared::pooled_buffer_t m_buffer{64u * 1024u};
+    };
+
+    // A received server frame
+    struct frame_t {
+        websocket::frame_header_t m_header;
+
+        std::string m_payload;
+    };
+
+    std::unique_ptr<pair_t> connect() {
+        auto pair = std::make_unique<pair_t>(io_ctx);
+
+        tcp::acceptor acceptor{io_ctx, tcp::endpoint{boost::asio::ip::address_v4::loopback(), 0}};
+
+        pair->m_client.connect(acceptor.local_endpoint());
+
+        acceptor.accept(pair->m_server);
+
+        return pair;
+    }
+
+    static std::string client_frame(websocket::e_opcode opcode, std::string payload, bool compressed = false) {
+        std::string out{};
+
+        out.push_back(static_cast<char>(0x80u | (compressed ? 0x40u : 0x00u) | static_cast<std::uint8_t>(opcode)));
+
+        if (payload.size() < 126u)
+            out.push_back(static_cast<char>(0x80u | payload.size()));
+        else {
+            out.push_back(static_cast<char>(0x80u | 126u));
+            out.push_back(static_cast<char>(payload.size() >> 8u));
+            out.push_back(static_cast<char>(payload.size() & 0xffu));
+        }
+
+        const std::uint32_t mask{0xa1b2c3d4u};
+
+        out.append(reinterpret_cast<const char*>(&mask), 4u);
+
+        websocket::apply_mask(payload.data(), payload.size(), mask);
+
+        return out + payload;
+    }
+
+    static frame_t read_frame(tcp::socket& socket) {
+        std::string data(2u, '\0');
+
+        boost::asio::read(socket, boost::asio::buffer(data));
+
+        frame_t frame{};
+
+        while (websocket::parse_header(data, frame.m_header) == 0u) {
+            data.push_back('\0');
+
+            boost::asio::read(socket, boost::asio::buffer(data.data() + data.size() - 1u, 1u));
+        }
+
+        frame.m_payload.resize(frame.m_header.m_length);
+
+        boost::asio::read(socket, boost::asio::buffer(frame.m_payload));
+
+        return frame;
+    }
+
+    static websocket::session_ptr_t make_session(pair_t& pair, clueapi::cfg::cfg_t::websocket_t cfg = {}, bool uses_deflate = false) {
+        return std::make_shared<websocket::session_t>(pair.m_server, pair.m_buffer, cfg, uses_deflate);
+    }
+
+    boost::asio::io_context io_ctx;
+};
+
+TEST_F(websocket_session_tests, echoes_messages_and_answers_control_frames) {
+    auto pair = connect();
+
+    auto session = make_session(*pair);
+
+    std::vector<std::string> received{};
+
+    boost::asio::co_spawn(
+        io_ctx,
+        [&]() -> boost::asio::awaitable<void> {
+            while (auto message = co_await session->read()) {
+                received.emplace_back(message->m_data);
+
+                session->send(message->m_data, message->m_opcode);
+            }
+
+            co_await session->finish();
+        },
+        boost::asio::detached);
+
+    std::string data{};
+
+    data.append(client_frame(websocket::e_opcode::text, "hello"));
+    data.append(client_frame(websocket::e_opcode::ping, "p"));
+    data.append(client_frame(websocket::e_opcode::binary, std::string(300u, 'b')));
+
+    boost::asio::write(pair->m_client, boost::asio::buffer(data));
+
+    io_ctx.run_for(std::chrono::milliseconds{100});
+
+    auto echo = read_frame(pair->m_client);
+
+    EXPECT_EQ(echo.m_header.m_opcode, websocket::e_opcode::text);
+    EXPECT_EQ(echo.m_payload, "hello");
+
+    auto pong = read_frame(pair->m_client);
+
+    EXPECT_EQ(pong.m_header.m_opcode, websocket::e_opcode::pong);
+    EXPECT_EQ(pong.m_payload, "p");
+
+    EXPECT_EQ(read_frame(pair->m_client).m_payload, std::string(300u, 'b'));
+
+    boost::asio::write(pair->m_client, boost::asio::buffer(client_frame(websocket::e_opcode::close, "\x03\xe8")));
+
+    io_ctx.restart();
+    io_ctx.run_for(std::chrono::milliseconds{100});
+
+    auto close = read_frame(pair->m_client);
+
+    EXPECT_EQ(close.m_header.m_opcode, websocket::e_opcode::close);
+    EXPECT_EQ(close.m_payload, "\x03\xe8");
+
+    EXPECT_EQ(received.size(), 2u);
+    EXPECT_FALSE(session->is_open());
+}
+
+TEST_F(websocket_session_tests, reassembles_fragments) {
+    auto pair = connect();
+
+    auto session = make_session(*pair);
+
+    std::string received{};
+
+    boost::asio::co_spawn(
+        io_ctx,
+        [&]() -> boost::asio::awaitable<void> {
+            if (auto message = co_await session->read())
+                received = message->m_data;
+        },
+        boost::asio::detached);
+
+    auto first = client_frame(websocket::e_opcode::text, "frag");
+
+    first[0] = static_cast<char>(first[0] & 0x7f);
+
+    auto last = client_frame(websocket::e_opcode::continuation, "mented");
+
+    boost::asio::write(pair->m_client, boost::asio::buffer(first + client_frame(websocket::e_opcode::ping, "") + last));
+
+    io_ctx.run_for(std::chrono::milliseconds{100});
+
+    EXPECT_EQ(received, "fragmented");
+}
+
+TEST_F(websocket_session_tests, closes_on_invalid_utf8_text) {
+    auto pair = connect();
+
+    auto session = make_session(*pair);
+
+    std::vector<std::string> received{};
+
+    bool has_failed{};
+
+    boost::asio::co_spawn(
+        io_ctx,
+        [&]() -> boost::asio::awaitable<void> {
+            while (true) {
+                auto message = co_await session->read();
+
+                if (!message.has_value()) {
+                    has_failed = true;
+
+                    break;
+                }
+
+                received.emplace_back(message->m_data);
+            }
+
+            co_await session->finish();
+        },
+        boost::asio::detached);
+
+    // A code point split between two fragments, and a binary message that isn't text
+    auto first = client_frame(websocket::e_opcode::text, "\xe2\x82");
+
+    first[0] = static_cast<char>(first[0] & 0x7f);
+
+    const auto wire = first + client_frame(websocket::e_opcode::continuation, "\xac") +
+                      client_frame(websocket::e_opcode::binary, "\xff\xfe") +
+                      client_frame(websocket::e_opcode::text, "\xc0\xaf");
+
+    boost::asio::write(pair->m_client, boost::asio::buffer(wire));
+
+    io_ctx.run_for(std::chrono::milliseconds{100});
+
+    ASSERT_EQ(received.size(), 2u);
+
+    EXPECT_EQ(received[0], "\xe2\x82\xac");
+    EXPECT_EQ(received[1], "\xff\xfe");
+
+    EXPECT_TRUE(has_failed);
+
+    auto close = read_frame(pair->m_client);
+
+    EXPECT_EQ(close.m_header.m_opcode, websocket::e_opcode::close);
+    EXPECT_EQ(close.m_payload.substr(0u, 2u), "\x03\xef");
+}
+
+TEST_F(websocket_session_tests, answers_invalid_close_frames_with_a_protocol_error) {
+    // A lone byte, a reserved code, a code that is never sent, and a reason that isn't text
+    for (const std::string payload : {"\x03", "\x03\xed", "\x07\xd0", "\x03\xe8\xc0\xaf"}) {
+        auto pair = connect();
+
+        auto session = make_session(*pair);
+
+        boost::asio::co_spawn(
+            io_ctx,
+            [&]() -> boost::asio::awaitable<void> {
+                while (co_await session->read()) {
+                }
+
+                co_await session->finish();
+            },
+            boost::asio::detached);
+
+        boost::asio::write(pair->m_client, boost::asio::buffer(client_frame(websocket::e_opcode::close, payload)));
+
+        io_ctx.restart();
+        io_ctx.run_for(std::chrono::milliseconds{100});
+
+        auto close = read_frame(pair->m_client);
+
+        EXPECT_EQ(close.m_header.m_opcode, websocket::e_opcode::close);
+        EXPECT_EQ(close.m_payload, "\x03\xea");
+    }
+}
+
+TEST_F(websocket_session_tests, closes_on_too_big_messages) {
+    auto pair = connect();
+
+    auto session = make_session(*pair, {.m_max_message_size = 16u});
+
+    bool has_failed{};
+
+    boost::asio::co_spawn(
+        io_ctx,
+        [&]() -> boost::asio::awaitable<void> {
+            has_failed = !(co_await session->read()).has_value();
+
+            co_await session->finish();
+        },
+        boost::asio::detached);
+
+    boost::asio::write(pair->m_client, boost::asio::buffer(client_frame(websocket::e_opcode::text, std::string(17u, 'x'))));
+
+    io_ctx.run_for(std::chrono::milliseconds{100});
+
+    EXPECT_TRUE(has_failed);
+
+    auto close = read_frame(pair->m_client);
+
+    EXPECT_EQ(close.m_header.m_opcode, websocket::e_opcode::close);
+    EXPECT_EQ(close.m_payload.substr(0u, 2u), "\x03\xf1");
+}
+
+TEST_F(websocket_session_tests, inflates_and_deflates_messages) {
+    auto pair = connect();
+
+    auto session = make_session(*pair, {.m_compress_threshold = 64u}, true);
+
+    const std::string message(1024u, 'z');
+
+    std::string received{};
+
+    boost::asio::co_spawn(
+        io_ctx,
+        [&]() -> boost::asio::awaitable<void> {
+            if (auto read = co_await session->read()) {
+                received = read->m_data;
+
+                session->send(read->m_data);
+            }
+        },
+        boost::asio::detached);
+
+    std::string compressed{};
+
+    ASSERT_TRUE(websocket::deflate::compress(message, compressed, 6));
+
+    boost::asio::write(pair->m_client, boost::asio::buffer(client_frame(websocket::e_opcode::text, compressed, true)));
+
+    io_ctx.run_for(std::chrono::milliseconds{100});
+
+    EXPECT_EQ(received, message);
+
+    auto echo = read_frame(pair->m_client);
+
+    EXPECT_EQ(echo.m_header.m_rsv, 0x40u);
+
+    std::string inflated{};
+
+    ASSERT_TRUE(websocket::deflate::decompress(echo.m_payload, inflated, message.size()));
+
+    EXPECT_EQ(inflated, message);
+}
+
+TEST_F(websocket_session_tests, drops_slow_consumers) {
+    auto pair = connect();
+
+    auto session = make_session(*pair, {.m_max_queued_bytes = 1024u});
+
+    EXPECT_TRUE(session->send(std::string(600u, 'a')));
+
+    EXPECT_EQ(session->queued_bytes(), 604u);
+
+    // The first frame is still queued, as the I/O context didn't run
+    EXPECT_FALSE(session->send(std::string(600u, 'b')));
+
+    EXPECT_FALSE(session->is_open());
+
+    io_ctx.run_for(std::chrono::milliseconds{50});
+}
+
+TEST_F(websocket_session_tests, hub_shares_frames_between_subscribers) {
+    auto first = connect();
+    auto second = connect();
+    auto other = connect();
+
+    auto first_session = make_session(*first, {}, true);
+    auto second_session = make_session(*second);
+    auto other_session = make_session(*other);
+
+    websocket::c_hub hub{{.m_compress_threshold = 64u}};
+
+    hub.subscribe("news", first_session);
+    hub.subscribe("news", second_session);
+    hub.subscribe("sports", other_session);
+
+    EXPECT_EQ(hub.subscriptions(), 3u);
+
+    const std::string message(256u, 'n');
+
+    hub.publish("news", message);
+
+    io_ctx.run_for(std::chrono::milliseconds{100});
+
+    auto compressed = read_frame(first->m_client);
+
+    std::string inflated{};
+
+    EXPECT_EQ(compressed.m_header.m_rsv, 0x40u);
+    ASSERT_TRUE(websocket::deflate::decompress(compressed.m_payload, inflated, message.size()));
+    EXPECT_EQ(inflated, message);
+
+    auto plain = read_frame(second->m_client);
+
+    EXPECT_EQ(plain.m_header.m_rsv, 0u);
+    EXPECT_EQ(plain.m_payload, message);
+
+    hub.unsubscribe("news", second_session);
+
+    EXPECT_EQ(hub.subscriptions(), 2u);
+
+    // A destroyed session leaves on the next publish
+    first_session.reset();
+
+    hub.publish("news", "gone");
+
+    io_ctx.restart();
+    io_ctx.run_for(std::chrono::milliseconds{50});
+
+    EXPECT_EQ(hub.subscriptions(), 1u);
+}